@@ -18,6 +18,10 @@ namespace Iris {
 		// When a dependency for the current asset is updated (e.g. Texture for a mesh updated -> Mesh should be updated)
 		virtual void OnDependencyUpdated(AssetHandle handle) { (void)handle; }
 
+		// Approximate memory kept alive by the asset, used by the asset manager to decide what to evict when over the memory budget
+		virtual uint64_t GetCPUMemoryUsage() const { return 0; }
+		virtual uint64_t GetGPUMemoryUsage() const { return 0; }
+
 		virtual bool operator==(const Asset& other) const
 		{
 			return Handle == other.Handle;
@@ -14,6 +14,17 @@ namespace Iris {
 		Invalid
 	};
 
+	// Higher priorities are picked up first by the asset workers
+	enum class AssetLoadPriority : uint8_t
+	{
+		Background = 0,
+		Normal,
+		NearCamera,
+		Visible,
+		Awaited, // Something is actively blocked on the asset
+		Count
+	};
+
 	struct AssetMetaData
 	{
 		AssetHandle Handle = 0;
@@ -33,6 +44,7 @@ namespace Iris {
 		AssetMetaData MetaData;
 		Ref<Asset> Asset;
 		bool Reloaded = false;
+		AssetLoadPriority Priority = AssetLoadPriority::Normal;
 	};
 
 	struct RuntimeAssetLoadRequest
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Asset.h"
+
+#include <coroutine>
+#include <exception>
+
+/*
+ * Coroutine support for loading assets, so that loads that depend on each other can be written linearly:
+ *
+ *	AssetTask LoadMesh(AssetHandle handle)
+ *	{
+ *		Ref<StaticMesh> staticMesh = co_await AssetManager::LoadAsync<StaticMesh>(handle);
+ *		if (!staticMesh)
+ *			co_return;
+ *
+ *		Ref<MeshSource> meshSource = co_await AssetManager::LoadAsync<MeshSource>(staticMesh->GetMeshSource());
+ *		...
+ *	}
+ *
+ * - AssetTask is fire and forget, it starts running right away and nothing owns it. The coroutine frame is freed once it finishes
+ * - Awaiting an asset that is not loaded yet queues it on the asset thread and suspends the coroutine. It is then resumed on the main thread
+ *   inside AssetManager::SyncWithAssetThread right after the asset got synced, so there is no per frame polling
+ * - The awaited result is nullptr if the asset is invalid or failed to load
+ * - Only the main thread can await assets
+ * - Coroutine parameters should be taken by value since the caller is long gone by the time the coroutine is resumed
+ */
+
+namespace Iris {
+
+	struct AssetTask
+	{
+		struct promise_type
+		{
+			AssetTask get_return_object() const noexcept { return {}; }
+			std::suspend_never initial_suspend() const noexcept { return {}; }
+			std::suspend_never final_suspend() const noexcept { return {}; }
+			void return_void() const noexcept {}
+			void unhandled_exception() const noexcept { std::terminate(); }
+		};
+	};
+
+	// Lives inside the frame of the suspended coroutine, the asset manager fills in the result before resuming it
+	struct AssetLoadWaiter
+	{
+		AssetHandle Handle = 0;
+		std::coroutine_handle<> Continuation;
+		Ref<Asset> Result;
+	};
+
+}
\ No newline at end of file
@@ -9,6 +9,43 @@
 
 namespace Iris {
 
+	// Returned by AssetManager::LoadAsync, see AssetTask.h
+	template<typename T>
+	class AssetLoadAwaiter
+	{
+	public:
+		AssetLoadAwaiter(AssetHandle handle, AssetLoadPriority priority)
+			: m_Priority(priority)
+		{
+			m_Waiter.Handle = handle;
+		}
+
+		bool await_ready()
+		{
+			AsyncAssetResult<Asset> result = Project::GetAssetManager()->GetAssetAsync(m_Waiter.Handle, m_Priority);
+			if (result.IsReady)
+			{
+				m_Waiter.Result = Project::GetAssetManager()->GetAsset(m_Waiter.Handle);
+				return true;
+			}
+
+			// Nothing got queued so there is nothing to wait for
+			return !Project::GetAssetManager()->IsAssetHandleValid(m_Waiter.Handle);
+		}
+
+		void await_suspend(std::coroutine_handle<> continuation)
+		{
+			m_Waiter.Continuation = continuation;
+			Project::GetAssetManager()->AddAssetLoadWaiter(&m_Waiter);
+		}
+
+		Ref<T> await_resume() const { return m_Waiter.Result.template As<T>(); }
+
+	private:
+		AssetLoadWaiter m_Waiter;
+		AssetLoadPriority m_Priority;
+	};
+
 	class AssetManager
 	{
 	public:
@@ -46,12 +83,23 @@ namespace Iris {
 		}
 
 		template<typename T>
-		static AsyncAssetResult<T> GetAssetAsync(AssetHandle handle)
+		static AsyncAssetResult<T> GetAssetAsync(AssetHandle handle, AssetLoadPriority priority = AssetLoadPriority::Normal)
 		{
-			AsyncAssetResult<Asset> result = Project::GetAssetManager()->GetAssetAsync(handle);
+			AsyncAssetResult<Asset> result = Project::GetAssetManager()->GetAssetAsync(handle, priority);
 			return AsyncAssetResult<T>(result);
 		}
 
+		// Use inside an AssetTask coroutine: co_await AssetManager::LoadAsync<T>(handle)
+		// Resumes on the main thread once the asset is loaded, the result is nullptr if the asset failed to load
+		template<typename T>
+		static AssetLoadAwaiter<T> LoadAsync(AssetHandle handle, AssetLoadPriority priority = AssetLoadPriority::Awaited)
+		{
+			return AssetLoadAwaiter<T>(handle, priority);
+		}
+
+		// Returns false if the asset is not queued for loading, other queued assets depend on it or a coroutine awaits it
+		static bool CancelAssetLoad(AssetHandle handle) { return Project::GetAssetManager()->CancelAssetLoad(handle); }
+
 		template<typename T>
 		static std::unordered_set<AssetHandle> GetAllAssetsWithType()
 		{
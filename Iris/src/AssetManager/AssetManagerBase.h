@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Asset/Asset.h"
+#include "Asset/AssetMetaData.h"
+#include "Asset/AssetTask.h"
 #include "Asset/AssetTypes.h"
 
 #include <unordered_set>
@@ -20,7 +22,9 @@ namespace Iris {
 
 		virtual AssetType GetAssetType(AssetHandle handle) const = 0;
 		virtual Ref<Asset> GetAsset(AssetHandle handle) = 0;
-		virtual AsyncAssetResult<Asset> GetAssetAsync(AssetHandle handle) = 0;
+		virtual AsyncAssetResult<Asset> GetAssetAsync(AssetHandle handle, AssetLoadPriority priority = AssetLoadPriority::Normal) = 0;
+		virtual bool CancelAssetLoad(AssetHandle handle) = 0; // Only drops the load request, nothing happens to already loaded assets
+		virtual void AddAssetLoadWaiter(AssetLoadWaiter* waiter) = 0; // The waiter is resumed once the asset it waits on is synced
 
 		virtual void AddMemoryOnlyAsset(Ref<Asset> asset) = 0;
 		virtual bool ReloadData(AssetHandle handle) = 0;
@@ -10,63 +10,143 @@ namespace Iris {
 #define ASSET_LOG(...)
 #endif
 
-	static std::mutex s_AssetRegistryMutex;
+	static const std::shared_ptr<const AssetRegistry::MetaDataMap> s_EmptyShardMap = std::make_shared<const AssetRegistry::MetaDataMap>();
 
-	bool AssetRegistry::Contains(const AssetHandle handle) const
+	std::size_t AssetRegistry::Snapshot::Size() const
+	{
+		std::size_t size = 0;
+		for (const auto& shard : m_Shards)
+			size += shard->size();
+
+		return size;
+	}
+
+	AssetRegistry::AssetRegistry()
 	{
-		std::scoped_lock<std::mutex> lock(s_AssetRegistryMutex);
+		for (Shard& shard : m_Shards)
+			shard.Map.store(s_EmptyShardMap, std::memory_order_relaxed);
+	}
 
+	bool AssetRegistry::Contains(const AssetHandle handle) const
+	{
 		ASSET_LOG("Contains handle {}", handle);
-		return m_AssetRegistry.contains(handle);
+
+		std::shared_ptr<const MetaDataMap> map = GetShard(handle).Map.load(std::memory_order_acquire);
+		return map->contains(handle);
 	}
 
-	std::size_t AssetRegistry::Remove(const AssetHandle handle)
+	bool AssetRegistry::TryGet(const AssetHandle handle, AssetMetaData& outMetaData) const
 	{
-		std::scoped_lock<std::mutex> lock(s_AssetRegistryMutex);
+		ASSET_LOG("Retrieving handle {}", handle);
+
+		std::shared_ptr<const MetaDataMap> map = GetShard(handle).Map.load(std::memory_order_acquire);
+		auto it = map->find(handle);
+		if (it == map->end())
+			return false;
 
-		ASSET_LOG("Removing handle", handle);
-		return m_AssetRegistry.erase(handle);
+		outMetaData = it->second;
+		return true;
 	}
 
-	void AssetRegistry::Clear()
+	AssetMetaData AssetRegistry::Get(const AssetHandle handle) const
 	{
-		std::scoped_lock<std::mutex> lock(s_AssetRegistryMutex);
+		AssetMetaData metaData;
+		TryGet(handle, metaData);
+		return metaData;
+	}
 
-		ASSET_LOG("Clearing registry");
-		m_AssetRegistry.clear();
+	void AssetRegistry::Set(const AssetHandle handle, const AssetMetaData& metaData)
+	{
+		ASSET_LOG("Setting handle {}", handle);
+
+		Shard& shard = GetShard(handle);
+		std::scoped_lock<std::mutex> lock(shard.WriteMutex);
+
+		std::shared_ptr<MetaDataMap> next = std::make_shared<MetaDataMap>(*shard.Map.load(std::memory_order_acquire));
+		auto [it, inserted] = next->insert_or_assign(handle, metaData);
+		shard.Map.store(std::move(next), std::memory_order_release);
+
+		if (inserted)
+			m_Size.fetch_add(1, std::memory_order_relaxed);
 	}
 
-	AssetMetaData& AssetRegistry::Get(const AssetHandle handle)
+	void AssetRegistry::WriteBatch::Set(const AssetHandle handle, const AssetMetaData& metaData)
 	{
-		std::scoped_lock<std::mutex> lock(s_AssetRegistryMutex);
+		m_Writes[GetShardIndex(handle)].emplace_back(handle, metaData);
+		m_Count++;
+	}
 
-		ASSET_LOG("Retrieving handle {}", handle);
-		return m_AssetRegistry[handle];
+	void AssetRegistry::Commit(WriteBatch& batch)
+	{
+		ASSET_LOG("Committing batch of {} writes", batch.Size());
+
+		for (uint32_t i = 0; i < ShardCount; i++)
+		{
+			auto& writes = batch.m_Writes[i];
+			if (writes.empty())
+				continue;
+
+			Shard& shard = m_Shards[i];
+			std::scoped_lock<std::mutex> lock(shard.WriteMutex);
+
+			std::shared_ptr<const MetaDataMap> current = shard.Map.load(std::memory_order_acquire);
+			std::shared_ptr<MetaDataMap> next = std::make_shared<MetaDataMap>();
+			next->reserve(current->size() + writes.size());
+			next->insert(current->begin(), current->end());
+
+			std::size_t inserted = 0;
+			for (auto& [handle, metaData] : writes)
+				inserted += next->insert_or_assign(handle, std::move(metaData)).second ? 1 : 0;
+
+			shard.Map.store(std::move(next), std::memory_order_release);
+			m_Size.fetch_add(inserted, std::memory_order_relaxed);
+
+			writes.clear();
+		}
+
+		batch.m_Count = 0;
 	}
 
-	const AssetMetaData& AssetRegistry::Get(const AssetHandle handle) const
+	std::size_t AssetRegistry::Remove(const AssetHandle handle)
 	{
-		std::scoped_lock<std::mutex> lock(s_AssetRegistryMutex);
+		ASSET_LOG("Removing handle {}", handle);
+
+		Shard& shard = GetShard(handle);
+		std::scoped_lock<std::mutex> lock(shard.WriteMutex);
+
+		std::shared_ptr<const MetaDataMap> current = shard.Map.load(std::memory_order_acquire);
+		if (!current->contains(handle))
+			return 0;
 
-		IR_ASSERT(m_AssetRegistry.contains(handle));
-		ASSET_LOG("Retrieving const handle {}", handle);
-		return m_AssetRegistry.at(handle);
+		std::shared_ptr<MetaDataMap> next = std::make_shared<MetaDataMap>(*current);
+		std::size_t removed = next->erase(handle);
+		shard.Map.store(std::move(next), std::memory_order_release);
+
+		m_Size.fetch_sub(removed, std::memory_order_relaxed);
+		return removed;
 	}
 
-	AssetMetaData& AssetRegistry::operator[](const AssetHandle handle)
+	void AssetRegistry::Clear()
 	{
-		std::scoped_lock<std::mutex> lock(s_AssetRegistryMutex);
+		ASSET_LOG("Clearing registry");
 
-		ASSET_LOG("Retrieving handle {}", handle);
-		return m_AssetRegistry[handle];
+		for (Shard& shard : m_Shards)
+		{
+			std::scoped_lock<std::mutex> lock(shard.WriteMutex);
+
+			std::size_t removed = shard.Map.load(std::memory_order_acquire)->size();
+			shard.Map.store(s_EmptyShardMap, std::memory_order_release);
+			m_Size.fetch_sub(removed, std::memory_order_relaxed);
+		}
 	}
 
-	const AssetMetaData& AssetRegistry::operator[](const AssetHandle handle) const
+	AssetRegistry::Snapshot AssetRegistry::GetSnapshot() const
 	{
-		std::scoped_lock<std::mutex> lock(s_AssetRegistryMutex);
+		Snapshot snapshot;
+		for (uint32_t i = 0; i < ShardCount; i++)
+			snapshot.m_Shards[i] = m_Shards[i].Map.load(std::memory_order_acquire);
 
-		ASSET_LOG("Retrieving handle {}", handle);
-		return m_AssetRegistry.at(handle);
+		return snapshot;
 	}
 
 }
\ No newline at end of file
@@ -2,30 +2,183 @@
 
 #include "Asset/AssetMetaData.h"
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
+/*
+ * The registry is read every frame by the render thread, the asset thread and the UI while mutations only happen on import, load status changes and removal.
+ * So it is split into shards where each shard publishes an immutable map (RCU style):
+ *	- Readers atomically grab the current map of the shard and never take a lock
+ *	- Writers (serialized per shard) copy the map, mutate the copy and then publish it
+ * A published map is never mutated again so all accessors return copies of the meta data and no reference escapes into memory that could change under the reader.
+ * Iterating the whole registry goes through a Snapshot which keeps the maps of all shards alive for as long as it lives.
+ * Bulk writes (project load, importing the asset directory) go through a WriteBatch so that every touched shard is only copied once per batch.
+ */
+
 namespace Iris {
 
 	class AssetRegistry
 	{
 	public:
-		std::size_t Size() const { return m_AssetRegistry.size(); }
+		using MetaDataMap = std::unordered_map<AssetHandle, AssetMetaData>;
+
+		static constexpr uint32_t ShardCount = 64;
+
+		class Snapshot
+		{
+		public:
+			class Iterator
+			{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = MetaDataMap::value_type;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const value_type*;
+				using reference = const value_type&;
+
+				Iterator(const Snapshot* snapshot, uint32_t shardIndex)
+					: m_Snapshot(snapshot), m_ShardIndex(shardIndex)
+				{
+					if (m_ShardIndex < ShardCount)
+					{
+						m_Iterator = m_Snapshot->m_Shards[m_ShardIndex]->cbegin();
+						SkipExhaustedShards();
+					}
+				}
+
+				reference operator*() const { return *m_Iterator; }
+				pointer operator->() const { return &(*m_Iterator); }
+
+				Iterator& operator++()
+				{
+					++m_Iterator;
+					SkipExhaustedShards();
+					return *this;
+				}
+
+				bool operator==(const Iterator& other) const
+				{
+					if (m_ShardIndex != other.m_ShardIndex)
+						return false;
+
+					return m_ShardIndex == ShardCount || m_Iterator == other.m_Iterator;
+				}
+
+				bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+			private:
+				void SkipExhaustedShards()
+				{
+					while (m_ShardIndex < ShardCount && m_Iterator == m_Snapshot->m_Shards[m_ShardIndex]->cend())
+					{
+						if (++m_ShardIndex < ShardCount)
+							m_Iterator = m_Snapshot->m_Shards[m_ShardIndex]->cbegin();
+					}
+				}
+
+			private:
+				const Snapshot* m_Snapshot = nullptr;
+				uint32_t m_ShardIndex = ShardCount;
+				MetaDataMap::const_iterator m_Iterator;
+			};
+
+		public:
+			std::size_t Size() const;
+
+			Iterator begin() const { return Iterator(this, 0); }
+			Iterator end() const { return Iterator(this, ShardCount); }
+
+		private:
+			std::array<std::shared_ptr<const MetaDataMap>, ShardCount> m_Shards;
+
+			friend class AssetRegistry;
+		};
+
+		// Writes collected here become visible all at once when the batch is committed
+		class WriteBatch
+		{
+		public:
+			void Set(const AssetHandle handle, const AssetMetaData& metaData);
+
+			std::size_t Size() const { return m_Count; }
+			bool Empty() const { return m_Count == 0; }
+
+		private:
+			std::array<std::vector<std::pair<AssetHandle, AssetMetaData>>, ShardCount> m_Writes;
+			std::size_t m_Count = 0;
+
+			friend class AssetRegistry;
+		};
+
+	public:
+		AssetRegistry();
+		~AssetRegistry() = default;
+
+		AssetRegistry(const AssetRegistry&) = delete;
+		AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+		std::size_t Size() const { return m_Size.load(std::memory_order_relaxed); }
 		bool Contains(const AssetHandle handle) const;
+
+		// Copies the meta data out of the registry, returns false (and leaves outMetaData untouched) if the handle is not registered
+		bool TryGet(const AssetHandle handle, AssetMetaData& outMetaData) const;
+		// Returns a default constructed (Handle = 0) meta data if the handle is not registered
+		AssetMetaData Get(const AssetHandle handle) const;
+
+		// Inserts or replaces the entry for handle
+		void Set(const AssetHandle handle, const AssetMetaData& metaData);
+		// Inserts or replaces every entry of the batch copying each touched shard once, the batch is empty afterwards
+		void Commit(WriteBatch& batch);
+
+		// Mutates the entry of an already registered handle in place of a Get/Set pair so that concurrent writers of the same shard do not lose updates
+		// Returns false if the handle is not registered
+		template<typename Func>
+		bool Update(const AssetHandle handle, Func&& func)
+		{
+			Shard& shard = GetShard(handle);
+			std::scoped_lock<std::mutex> lock(shard.WriteMutex);
+
+			std::shared_ptr<const MetaDataMap> current = shard.Map.load(std::memory_order_acquire);
+			if (!current->contains(handle))
+				return false;
+
+			std::shared_ptr<MetaDataMap> next = std::make_shared<MetaDataMap>(*current);
+			func(next->at(handle));
+			shard.Map.store(std::move(next), std::memory_order_release);
+
+			return true;
+		}
+
 		std::size_t Remove(const AssetHandle handle);
 		void Clear();
 
-		auto begin() { return m_AssetRegistry.begin(); }
-		auto end() { return m_AssetRegistry.end(); }
-		auto begin() const { return m_AssetRegistry.cbegin(); }
-		auto end() const { return m_AssetRegistry.cend(); }
+		// Consistent per shard view of the registry that is safe to iterate from any thread
+		Snapshot GetSnapshot() const;
+
+	private:
+		struct Shard
+		{
+			std::atomic<std::shared_ptr<const MetaDataMap>> Map;
+			std::mutex WriteMutex;
+		};
+
+		static uint32_t GetShardIndex(const AssetHandle handle)
+		{
+			// Handles are either random 64 bit UUIDs or 32 bit FNV hashes for named memory assets so fold the high bits in for the latter case
+			uint64_t value = static_cast<uint64_t>(handle);
+			value ^= value >> 32;
+			return static_cast<uint32_t>(value % ShardCount);
+		}
 
-		AssetMetaData& Get(const AssetHandle handle);
-		const AssetMetaData& Get(const AssetHandle handle) const;
-		AssetMetaData& operator[](const AssetHandle handle);
-		const AssetMetaData& operator[](const AssetHandle handle) const;
+		Shard& GetShard(const AssetHandle handle) { return m_Shards[GetShardIndex(handle)]; }
+		const Shard& GetShard(const AssetHandle handle) const { return m_Shards[GetShardIndex(handle)]; }
 
 	private:
-		std::unordered_map<AssetHandle, AssetMetaData> m_AssetRegistry;
+		std::array<Shard, ShardCount> m_Shards;
+		std::atomic<std::size_t> m_Size = 0;
 
 	};
 
@@ -0,0 +1,142 @@
+#include "IrisPCH.h"
+#include "AssetRegistryBenchmark.h"
+
+#include "AssetRegistry.h"
+#include "Core/Thread.h"
+
+#include <atomic>
+
+namespace Iris {
+
+	namespace Utils {
+
+		// Runs readerCount threads that each call read readsPerThread times while writer (if any) keeps running on another thread
+		template<typename ReadFunc, typename WriteFunc>
+		static float MeasureConcurrentReads(uint32_t readerCount, uint32_t readsPerThread, ReadFunc&& read, WriteFunc&& write, bool withWriter)
+		{
+			std::atomic<bool> readersDone = false;
+			std::atomic<uint64_t> found = 0;
+
+			Thread writer("Registry Benchmark Writer", 0);
+			if (withWriter)
+			{
+				writer.Dispatch([&]()
+				{
+					for (uint32_t i = 0; !readersDone.load(std::memory_order_relaxed); i++)
+						write(i);
+				});
+			}
+
+			std::vector<Thread> readers;
+			readers.reserve(readerCount);
+			for (uint32_t i = 0; i < readerCount; i++)
+				readers.emplace_back(fmt::format("Registry Benchmark Reader {}", i), 0);
+
+			Timer timer;
+			for (uint32_t i = 0; i < readerCount; i++)
+			{
+				readers[i].Dispatch([&, seed = i]()
+				{
+					uint64_t localFound = 0;
+					for (uint32_t j = 0; j < readsPerThread; j++)
+						localFound += read(seed * 7919u + j) ? 1 : 0;
+
+					found.fetch_add(localFound, std::memory_order_relaxed);
+				});
+			}
+
+			for (Thread& reader : readers)
+				reader.Join();
+			const float elapsed = timer.ElapsedMillis();
+
+			readersDone = true;
+			writer.Join();
+
+			// Keeps the reads from being optimized away
+			IR_CORE_TRACE_TAG("AssetManager", "[RegistryBenchmark]: {} lookups hit", found.load());
+			return elapsed;
+		}
+
+	}
+
+	AssetRegistryBenchmarkResults AssetRegistryBenchmark::Run(uint32_t entryCount, uint32_t readerThreads, uint32_t readsPerThread)
+	{
+		AssetRegistryBenchmarkResults results = {
+			.EntryCount = entryCount,
+			.ReaderThreads = readerThreads,
+			.ReadsPerThread = readsPerThread
+		};
+
+		std::vector<AssetMetaData> entries(entryCount);
+		for (uint32_t i = 0; i < entryCount; i++)
+		{
+			entries[i].Handle = AssetHandle();
+			entries[i].FilePath = fmt::format("Benchmark/Asset{}.ixmat", i);
+			entries[i].Type = AssetType::Material;
+		}
+
+		// Writes
+		{
+			AssetRegistry registry;
+			Timer timer;
+			for (const AssetMetaData& metaData : entries)
+				registry.Set(metaData.Handle, metaData);
+			results.SingleWrites = timer.ElapsedMillis();
+		}
+
+		AssetRegistry registry;
+		{
+			AssetRegistry::WriteBatch batch;
+			Timer timer;
+			for (const AssetMetaData& metaData : entries)
+				batch.Set(metaData.Handle, metaData);
+			registry.Commit(batch);
+			results.BatchedWrites = timer.ElapsedMillis();
+		}
+
+		// Reads
+		std::unordered_map<AssetHandle, AssetMetaData> mutexMap;
+		std::mutex mutexMapMutex;
+		for (const AssetMetaData& metaData : entries)
+			mutexMap[metaData.Handle] = metaData;
+
+		auto registryRead = [&](uint32_t i)
+		{
+			AssetMetaData metaData;
+			return registry.TryGet(entries[i % entryCount].Handle, metaData);
+		};
+		auto registryWrite = [&](uint32_t i)
+		{
+			registry.Update(entries[i % entryCount].Handle, [](AssetMetaData& entry) { entry.IsDataLoaded = !entry.IsDataLoaded; });
+		};
+
+		auto mutexMapRead = [&](uint32_t i)
+		{
+			std::scoped_lock<std::mutex> lock(mutexMapMutex);
+			auto it = mutexMap.find(entries[i % entryCount].Handle);
+			if (it == mutexMap.end())
+				return false;
+
+			AssetMetaData metaData = it->second;
+			return metaData.IsValid();
+		};
+		auto mutexMapWrite = [&](uint32_t i)
+		{
+			std::scoped_lock<std::mutex> lock(mutexMapMutex);
+			AssetMetaData& entry = mutexMap.at(entries[i % entryCount].Handle);
+			entry.IsDataLoaded = !entry.IsDataLoaded;
+		};
+
+		results.RegistryReads = Utils::MeasureConcurrentReads(readerThreads, readsPerThread, registryRead, registryWrite, false);
+		results.MutexMapReads = Utils::MeasureConcurrentReads(readerThreads, readsPerThread, mutexMapRead, mutexMapWrite, false);
+		results.RegistryReadsWhileWriting = Utils::MeasureConcurrentReads(readerThreads, readsPerThread, registryRead, registryWrite, true);
+		results.MutexMapReadsWhileWriting = Utils::MeasureConcurrentReads(readerThreads, readsPerThread, mutexMapRead, mutexMapWrite, true);
+
+		IR_CORE_INFO_TAG("AssetManager", "[RegistryBenchmark]: {} entries, writes: single {:.2f}ms, batched {:.2f}ms", entryCount, results.SingleWrites, results.BatchedWrites);
+		IR_CORE_INFO_TAG("AssetManager", "[RegistryBenchmark]: {} threads x {} reads: registry {:.2f}ms, mutex map {:.2f}ms, while writing: registry {:.2f}ms, mutex map {:.2f}ms",
+			readerThreads, readsPerThread, results.RegistryReads, results.MutexMapReads, results.RegistryReadsWhileWriting, results.MutexMapReadsWhileWriting);
+
+		return results;
+	}
+
+}
\ No newline at end of file
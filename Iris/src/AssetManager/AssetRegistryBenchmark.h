@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Micro-benchmark for the AssetRegistry, runnable from the Asset Manager panel
+ * - Writes: N single Set calls (one shard copy each) against one committed WriteBatch
+ * - Reads: concurrent lookups of the registry against a std::unordered_map behind one mutex (what the registry replaced), with and
+ *   without a thread writing at the same time
+ * Everything runs on a private registry so the project registry is never touched
+ */
+
+namespace Iris {
+
+	struct AssetRegistryBenchmarkResults
+	{
+		uint32_t EntryCount = 0;
+		uint32_t ReaderThreads = 0;
+		uint32_t ReadsPerThread = 0;
+
+		// Milliseconds
+		float SingleWrites = 0.0f;
+		float BatchedWrites = 0.0f;
+		float RegistryReads = 0.0f;
+		float MutexMapReads = 0.0f;
+		float RegistryReadsWhileWriting = 0.0f;
+		float MutexMapReadsWhileWriting = 0.0f;
+	};
+
+	class AssetRegistryBenchmark
+	{
+	public:
+		static AssetRegistryBenchmarkResults Run(uint32_t entryCount = 5000, uint32_t readerThreads = 8, uint32_t readsPerThread = 200000);
+	};
+
+}
\ No newline at end of file
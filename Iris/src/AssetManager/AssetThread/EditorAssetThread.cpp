@@ -3,7 +3,7 @@
 
 #include "AssetManager/Importers/AssetImporter.h"
 #include "Core/Application.h"
-#include "Core/Timer.h"
+#include "Core/WorkerPool.h"
 #include "ImGui/Themes.h"
 #include "Project/Project.h"
 #include "Renderer/Mesh/Mesh.h"
@@ -13,13 +13,7 @@
 
 namespace Iris {
 
-	struct AssetThreadData
-	{
-		CRITICAL_SECTION CriticalSection;
-		CONDITION_VARIABLE ConditionVariable;
-
-		ThreadState State = ThreadState::Idle;
-	};
+	static thread_local bool s_IsAssetWorkerThread = false;
 
 	Ref<EditorAssetThread> EditorAssetThread::Create()
 	{
@@ -27,42 +21,81 @@ namespace Iris {
 	}
 
 	EditorAssetThread::EditorAssetThread()
-		: m_Thread("Asset Thread")
 	{
-		s_AssetThreadID = m_Thread.GetID();
-
-		m_Data = new AssetThreadData();
-		InitializeCriticalSection(&m_Data->CriticalSection);
-		InitializeConditionVariable(&m_Data->ConditionVariable);
+		// Loading is mostly bound by file IO and the graphics queue so only half of the pool is used, importers fan out over the rest (WorkerPool::ParallelFor)
+		m_MaxWorkers = std::clamp(WorkerPool::GetWorkerCount() / 2, 1u, s_MaxAssetWorkers);
 	}
 
 	EditorAssetThread::~EditorAssetThread()
 	{
-		if (m_Data->State != ThreadState::Joined)
-			StopAndWait(true);
-
-		DeleteCriticalSection(&m_Data->CriticalSection);
-		s_AssetThreadID = std::thread::id();
+		StopAndWait();
 	}
 
 	bool EditorAssetThread::IsCurrentlyLoadingAssets() const
 	{
-		return m_Data->State == ThreadState::Busy;
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		return m_ActiveWorkers > 0 || !m_PendingLoads.empty();
 	}
 
 	void EditorAssetThread::QueueAssetLoad(const AssetLoadRequest& request)
 	{
-		std::scoped_lock<std::mutex> lock(m_AssetLoadingQueueMutex);
-		m_AssetLoadingQueue.push(request);
+		AssetHandle handle = request.MetaData.Handle;
+
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		auto it = m_PendingLoads.find(handle);
+		if (it != m_PendingLoads.end())
+		{
+			// Already queued or in flight so only the priority may change
+			// NOTE: A reload merged into a load that already read the file is lost, the watcher debounce makes that unlikely
+			it->second.Cancelled = false;
+			it->second.Request.Reloaded |= request.Reloaded;
+			RaisePriority(handle, request.Priority);
+			return;
+		}
+
+		PendingAssetLoad& pending = m_PendingLoads[handle];
+		pending.Request = request;
+		PushReadyAssetLoad(handle, request.Priority);
+	}
+
+	void EditorAssetThread::PrioritizeAssetLoad(AssetHandle handle, AssetLoadPriority priority)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		RaisePriority(handle, priority);
+	}
+
+	bool EditorAssetThread::CancelAssetLoad(AssetHandle handle)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		auto it = m_PendingLoads.find(handle);
+		if (it == m_PendingLoads.end())
+			return false;
+
+		PendingAssetLoad& pending = it->second;
+		if (!pending.Dependents.empty())
+			return false;
+
+		if (pending.State == PendingLoadState::InFlight)
+		{
+			pending.Cancelled = true;
+			return true;
+		}
+
+		// The handle could still be in a ready queue, it will be skipped when popped since it is not pending anymore
+		m_PendingLoads.erase(it);
+		m_WorkFinishedCondition.notify_all();
+		return true;
 	}
 
 	bool EditorAssetThread::RetrieveReadyAssets(std::vector<AssetLoadRequest>& outAssetList)
 	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
 		if (m_LoadedAssets.empty())
 			return false;
 
-		std::scoped_lock<std::mutex> lock(m_LoadedAssetsVectorMutex);
-		outAssetList = m_LoadedAssets;
+		outAssetList = std::move(m_LoadedAssets);
 		// Clear so that we do not have duplicates and leak memory
 		m_LoadedAssets.clear();
 		return true;
@@ -70,223 +103,324 @@ namespace Iris {
 
 	void EditorAssetThread::UpdateAssetManagerLoadedAssetList(const std::unordered_map<AssetHandle, Ref<Asset>>& loadedAssets)
 	{
-		std::scoped_lock<std::mutex> lock(m_AMLoadedAssetsMapMutex);
+		std::scoped_lock<std::mutex, std::mutex> lock(m_Mutex, m_AMLoadedAssetsMapMutex);
 		m_AMLoadedAssets = loadedAssets;
+
+		// The asset manager now owns these so we do not need to keep them around anymore
+		std::erase_if(m_CompletedAssets, [&loadedAssets](const auto& pair) { return loadedAssets.contains(pair.first); });
+	}
+
+	Ref<Asset> EditorAssetThread::GetAssetFromWorker(AssetHandle handle)
+	{
+		AssetMetaData metaData = Project::GetEditorAssetManager()->GetMetaData(handle);
+		if (!metaData.IsValid())
+			return nullptr;
+
+		bool reloaded = false;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+
+			// In case another worker is loading it we just wait for it instead of loading it twice
+			m_WorkFinishedCondition.wait(lock, [this, handle]()
+			{
+				auto it = m_PendingLoads.find(handle);
+				return it == m_PendingLoads.end() || it->second.State != PendingLoadState::InFlight;
+			});
+
+			// Claim the request if it is still queued so that no other worker picks it up
+			// NOTE: This is checked first since a queued reload has to win over the stale asset the asset manager still has
+			auto pendingIt = m_PendingLoads.find(handle);
+			if (pendingIt != m_PendingLoads.end())
+			{
+				pendingIt->second.State = PendingLoadState::InFlight;
+				metaData = pendingIt->second.Request.MetaData;
+				reloaded = pendingIt->second.Request.Reloaded;
+			}
+			else
+			{
+				auto completedIt = m_CompletedAssets.find(handle);
+				if (completedIt != m_CompletedAssets.end())
+					return completedIt->second;
+
+				{
+					std::scoped_lock<std::mutex> amLock(m_AMLoadedAssetsMapMutex);
+					auto loadedIt = m_AMLoadedAssets.find(handle);
+					if (loadedIt != m_AMLoadedAssets.end())
+						return loadedIt->second;
+				}
+
+				m_PendingLoads[handle].Request = { .MetaData = metaData, .Priority = AssetLoadPriority::Awaited };
+				m_PendingLoads[handle].State = PendingLoadState::InFlight;
+			}
+		}
+
+		IR_CORE_WARN_TAG("AssetManager", "[AssetThread]: Loading asset: {} (requested by another asset)", metaData.FilePath.string());
+
+		AssetLoadRequest result = { .MetaData = metaData, .Reloaded = reloaded };
+		if (!AssetImporter::TryLoadData(result.MetaData, result.Asset))
+		{
+			result.MetaData.Status = AssetStatus::Invalid;
+			IR_CORE_INFO_TAG("AssetManager", "[AssetThread]: Failed to load asset: {} ({})", metaData.FilePath.string(), metaData.Handle);
+		}
+
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		FinishAssetLoad(handle, result);
+		return result.Asset;
 	}
 
 	void EditorAssetThread::Run()
 	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
 		m_Running = true;
-		m_Thread.Dispatch([this]() { AssetThreadFunc(); });
+
+		// Anything queued before running
+		for (uint32_t i = 0; i < m_MaxWorkers; i++)
+			ScheduleWorker();
 	}
 
 	void EditorAssetThread::Stop()
 	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
 		m_Running = false;
 	}
 
-	void EditorAssetThread::StopAndWait(bool terminateThread)
+	void EditorAssetThread::StopAndWait()
 	{
 		Stop();
 
-		Set(ThreadState::Kick);
-		Wait(ThreadState::Idle);
-
-		if (terminateThread)
-		{
-			Set(ThreadState::Joined);
-			m_Thread.Join();
-
-			s_AssetThreadID = std::thread::id();
-		}
+		// NOTE: Workers finish the asset they are currently loading before exiting, anything still queued is dropped
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_WorkFinishedCondition.wait(lock, [this]() { return m_ScheduledWorkers == 0; });
 	}
 
-	void EditorAssetThread::AssetMonitorUpdate()
+	bool EditorAssetThread::IsAssetThread()
 	{
-		Timer timer;
-		// TODO:
-		// EnsureAllLoadedCurrent();
-		m_AssetUpdatePerf = timer.ElapsedMillis();
+		return s_IsAssetWorkerThread;
 	}
 
-	void EditorAssetThread::Wait(ThreadState stateToWait)
+	void EditorAssetThread::AssetWorkerJob()
 	{
-		// Nothing to wait for
-		if (m_Data->State == stateToWait)
-			return;
+		// Pool threads run other jobs as well so this is only set for as long as the worker job runs
+		s_IsAssetWorkerThread = true;
 
-		EnterCriticalSection(&m_Data->CriticalSection);
-		while (m_Data->State != stateToWait)
+		while (true)
 		{
-			SleepConditionVariableCS(&m_Data->ConditionVariable, &m_Data->CriticalSection, INFINITE);
+			AssetHandle handle;
+			{
+				std::scoped_lock<std::mutex> lock(m_Mutex);
+				if (!m_Running || !PopNextAssetLoad(handle))
+				{
+					m_ScheduledWorkers--;
+					m_WorkFinishedCondition.notify_all();
+					break;
+				}
+
+				if (m_ActiveWorkers++ == 0)
+					Application::Get().DispatchEvent<Events::TitleBarColorChangeEvent>(Colors::Theme::TitlebarRed);
+			}
+
+			ProcessAssetLoad(handle);
+
+			{
+				std::scoped_lock<std::mutex> lock(m_Mutex);
+				if (--m_ActiveWorkers == 0 && m_PendingLoads.empty())
+					Application::Get().DispatchEvent<Events::TitleBarColorChangeEvent>(Colors::Theme::TitlebarCyan);
+			}
 		}
-		LeaveCriticalSection(&m_Data->CriticalSection);
+
+		s_IsAssetWorkerThread = false;
 	}
 
-	void EditorAssetThread::Set(ThreadState stateToSet)
+	void EditorAssetThread::ProcessAssetLoad(AssetHandle handle)
 	{
-		// Already set
-		if (m_Data->State == stateToSet)
-			return;
+		AssetLoadRequest request;
+		bool dependenciesResolved = false;
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			const PendingAssetLoad& pending = m_PendingLoads.at(handle);
+			request = pending.Request;
+			dependenciesResolved = pending.DependenciesResolved;
+		}
 
-		EnterCriticalSection(&m_Data->CriticalSection);
-		m_Data->State = stateToSet;
-		WakeAllConditionVariable(&m_Data->ConditionVariable);
-		LeaveCriticalSection(&m_Data->CriticalSection);
-	}
+		if (!dependenciesResolved)
+		{
+			// Figuring out the dependencies may need to read the asset file so it is done outside the lock
+			std::vector<AssetHandle> dependencies;
+			AssetImporter::GetDependencies(request.MetaData, dependencies);
+
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			// The asset is parked untill its dependencies are loaded, the last dependency to finish puts it back in the ready queues
+			if (!QueueDependencies(handle, dependencies))
+				return;
+		}
 
-	void EditorAssetThread::WaitAndSet(ThreadState stateToWait, ThreadState stateToSet)
-	{
-		// Nothing to wait for
-		if (m_Data->State == stateToWait)
-			return;
+		IR_CORE_WARN_TAG("AssetManager", "[AssetThread]: Loading asset: {}", request.MetaData.FilePath.string());
 
-		EnterCriticalSection(&m_Data->CriticalSection);
-		while (m_Data->State != stateToWait)
+		bool success = AssetImporter::TryLoadData(request.MetaData, request.Asset);
+		if (success)
+		{
+			IR_CORE_INFO_TAG("AssetManager", "[AssetThread]: Finished loading asset: {}", request.MetaData.FilePath.string());
+		}
+		else
 		{
-			SleepConditionVariableCS(&m_Data->ConditionVariable, &m_Data->CriticalSection, INFINITE);
+			request.MetaData.Status = AssetStatus::Invalid;
+			IR_CORE_INFO_TAG("AssetManager", "[AssetThread]: Failed to load asset: {} ({})", request.MetaData.FilePath.string(), request.MetaData.Handle);
 		}
-		m_Data->State = stateToSet;
-		WakeAllConditionVariable(&m_Data->ConditionVariable);
-		LeaveCriticalSection(&m_Data->CriticalSection);
+
+		// NOTE: In case the asset failed we still want to know what its meta data is... so we set the status to invalid
+		// And if the loading failed then the asset flags will most probably say the asset is invalid/missing
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		FinishAssetLoad(handle, request);
 	}
 
-	void EditorAssetThread::AssetThreadFunc()
+	bool EditorAssetThread::PopNextAssetLoad(AssetHandle& outHandle)
 	{
-		while (m_Running)
+		for (int32_t priority = static_cast<int32_t>(AssetLoadPriority::Count) - 1; priority >= 0; priority--)
 		{
-			// Here we wait untill the Kick state is set, then we set state to Busy
+			std::deque<AssetHandle>& queue = m_ReadyQueues[priority];
+			while (!queue.empty())
 			{
-				Timer assetThreadWaitTimer;
+				AssetHandle handle = queue.front();
+				queue.pop_front();
 
-				WaitAndSet(ThreadState::Kick, ThreadState::Busy);
+				// Skip stale entries (cancelled, claimed by another worker or moved to a higher priority queue)
+				auto it = m_PendingLoads.find(handle);
+				if (it == m_PendingLoads.end() || it->second.State != PendingLoadState::Queued || static_cast<int32_t>(it->second.Request.Priority) != priority)
+					continue;
 
-				assetThreadWaitTimer.ElapsedMillis();
+				it->second.State = PendingLoadState::InFlight;
+				outHandle = handle;
+				return true;
 			}
+		}
 
-			AssetMonitorUpdate();
-
-			// Go through the asset loding request queue if we have any
-			// We use a while loop in case the user queues asset loads during an asset is being loaded
-			while (!m_AssetLoadingQueue.empty())
-			{
-				Application::Get().DispatchEvent<Events::TitleBarColorChangeEvent, true>(Colors::Theme::TitlebarRed);
-
-				m_AssetLoadingQueueMutex.lock();
-				// Copy the queue and clear the original one so that it does not stay locked through out the whole asset loading
-				std::queue<AssetLoadRequest> assetLoadQeuue = m_AssetLoadingQueue;
-				m_AssetLoadingQueue = {};
-				m_AssetLoadingQueueMutex.unlock();
+		return false;
+	}
 
-				std::vector<AssetLoadRequest> loadedAssetsCopy(assetLoadQeuue.size());
-				uint32_t index = 0;
-				while (!assetLoadQeuue.empty())
-				{
-					AssetLoadRequest& alr = assetLoadQeuue.front();
-
-					IR_CORE_WARN_TAG("AssetManager", "[AssetThread]: Loading asset: {}", alr.MetaData.FilePath.string());
-
-					bool success = AssetImporter::TryLoadData(alr.MetaData, alr.Asset);
-					if (success)
-					{
-						auto absolutePath = GetFileSystemPath(alr.MetaData);
-						IR_CORE_INFO_TAG("AssetManager", "[AssetThread]: Finished loading asset: {}", alr.MetaData.FilePath.string());
-					}
-					else
-					{
-						alr.MetaData.Status = AssetStatus::Invalid;
-						IR_CORE_INFO_TAG("AssetManager", "[AssetThread]: Failed to load asset: {} ({})", alr.MetaData.FilePath.string(), alr.MetaData.Handle);
-					}
-
-					// NOTE: In case the asset failed we still want to know what its meta data is... so we set the status to invalid
-					// And if the loading failed then the asset flags will most probably say the asset is invalid/missing
-					loadedAssetsCopy[index++] = alr;
-
-					assetLoadQeuue.pop();
-				}
+	void EditorAssetThread::ScheduleWorker()
+	{
+		if (!m_Running || m_ScheduledWorkers >= m_MaxWorkers)
+			return;
 
-				std::scoped_lock<std::mutex> lock(m_LoadedAssetsVectorMutex);
-				// Extend the vector to hold the extra assets
-				m_LoadedAssets.reserve(m_LoadedAssets.size() +  loadedAssetsCopy.size());
-				for (uint32_t i = 0; i < loadedAssetsCopy.size(); i++)
-				{
-					m_LoadedAssets.push_back(loadedAssetsCopy[i]);
-				}
+		m_ScheduledWorkers++;
 
-				Application::Get().DispatchEvent<Events::TitleBarColorChangeEvent, true>(Colors::Theme::TitlebarCyan);
-			}
+		// Keeps the asset thread alive untill the job exits
+		Ref<EditorAssetThread> instance = this;
+		WorkerPool::Submit([instance]() { instance->AssetWorkerJob(); });
+	}
 
-			// Return the thread state back to idle since we finished work
-			Set(ThreadState::Idle);
-		}
+	void EditorAssetThread::PushReadyAssetLoad(AssetHandle handle, AssetLoadPriority priority)
+	{
+		m_ReadyQueues[static_cast<std::size_t>(priority)].push_back(handle);
+		ScheduleWorker();
 	}
 
-	std::filesystem::path EditorAssetThread::GetFileSystemPath(const AssetMetaData& metaData)
+	void EditorAssetThread::RaisePriority(AssetHandle handle, AssetLoadPriority priority)
 	{
-		return Project::GetAssetDirectory() / metaData.FilePath;
+		auto it = m_PendingLoads.find(handle);
+		if (it == m_PendingLoads.end())
+			return;
+
+		PendingAssetLoad& pending = it->second;
+		if (priority <= pending.Request.Priority)
+			return;
+
+		pending.Request.Priority = priority;
+		if (pending.State == PendingLoadState::Queued)
+			PushReadyAssetLoad(handle, priority);
+
+		// Dependencies have to be loaded first so they need to be at least as urgent as the asset itself
+		for (AssetHandle dependency : pending.Dependencies)
+			RaisePriority(dependency, priority);
 	}
 
-	bool EditorAssetThread::ReloadData(AssetHandle handle)
+	bool EditorAssetThread::QueueDependencies(AssetHandle handle, const std::vector<AssetHandle>& dependencies)
 	{
-		bool result = false;
-		AssetMetaData& metaData = Project::GetEditorAssetManager()->GetMetaDataInternal(handle);
-		if (!metaData.IsValid())
+		AssetRegistry& assetRegistry = Project::GetEditorAssetManager()->GetAssetRegistry();
+
+		PendingAssetLoad& pending = m_PendingLoads.at(handle);
+		pending.DependenciesResolved = true;
+
+		for (AssetHandle dependency : dependencies)
 		{
-			IR_CORE_ERROR_TAG("AssetManager", "Trying to reload invalid asset!");
-			return result;
+			if (dependency == handle)
+				continue;
+
+			// Pending dependencies are always waited on, even if they are loaded already since that means they are being reloaded
+			auto it = m_PendingLoads.find(dependency);
+			if (it == m_PendingLoads.end())
+			{
+				if (m_CompletedAssets.contains(dependency))
+					continue;
+
+				// Memory assets, missing assets and assets that are already loaded do not need to be waited on
+				AssetMetaData dependencyMetaData = assetRegistry.Get(dependency);
+				if (!dependencyMetaData.IsValid() || dependencyMetaData.IsDataLoaded)
+					continue;
+
+				dependencyMetaData.Status = AssetStatus::Loading;
+				assetRegistry.Update(dependency, [](AssetMetaData& entry) { entry.Status = AssetStatus::Loading; });
+
+				it = m_PendingLoads.emplace(dependency, PendingAssetLoad{}).first;
+				it->second.Request = { .MetaData = dependencyMetaData, .Priority = pending.Request.Priority };
+				PushReadyAssetLoad(dependency, pending.Request.Priority);
+			}
+			else
+			{
+				it->second.Cancelled = false;
+				RaisePriority(dependency, pending.Request.Priority);
+			}
+
+			it->second.Dependents.push_back(handle);
+			pending.Dependencies.push_back(dependency);
+			pending.UnresolvedDependencies++;
 		}
 
-		IR_CORE_INFO_TAG("AssetManager", "[AssetThread]: RELOADING ASSET - {}", metaData.FilePath.string());
+		if (pending.UnresolvedDependencies == 0)
+			return true;
+
+		pending.State = PendingLoadState::WaitingOnDependencies;
+		return false;
+	}
 
-		Ref<Asset> asset;
-		if (metaData.IsDataLoaded)
-			asset = m_AMLoadedAssets.at(handle);
+	void EditorAssetThread::FinishAssetLoad(AssetHandle handle, const AssetLoadRequest& result)
+	{
+		auto it = m_PendingLoads.find(handle);
 
-		metaData.IsDataLoaded = AssetImporter::TryLoadData(metaData, asset);
-		if (metaData.IsDataLoaded)
+		bool cancelled = it != m_PendingLoads.end() && it->second.Cancelled;
+		if (!cancelled)
 		{
-			m_LoadedAssets.emplace_back(metaData, asset, true);
-			// TODO: Dispatch immediatly application event for asset reloaded
+			if (result.Asset)
+				m_CompletedAssets[handle] = result.Asset;
+
+			m_LoadedAssets.push_back(result);
 		}
-		result = metaData.IsDataLoaded;
 
-		if (result)
+		if (it != m_PendingLoads.end())
 		{
-			// If the asset is something that refers to a MeshSource then we should reload the mesh source... (ex. StaticMesh)
-			if (metaData.Type == AssetType::StaticMesh)
-			{
-				auto staticMesh = asset.As<StaticMesh>();
-				result |= ReloadData(staticMesh->GetMeshSource());
-			}
-			// If the asset is a MeshSource then we should recreate all the assets that refer to the mesh source since they have data that depends on the source mesh
-			else if (metaData.Type == AssetType::MeshSource)
+			// Even if the dependency failed to load, the dependents should still be loaded and they will handle the missing dependency
+			for (AssetHandle dependent : it->second.Dependents)
 			{
-				for (auto& [loadedHandle, loadedAsset] : m_AMLoadedAssets)
+				auto dependentIt = m_PendingLoads.find(dependent);
+				if (dependentIt == m_PendingLoads.end() || dependentIt->second.State != PendingLoadState::WaitingOnDependencies)
+					continue;
+
+				if (--dependentIt->second.UnresolvedDependencies == 0)
 				{
-					bool reloadAsset = false;
-					if (loadedAsset->GetAssetType() == AssetType::StaticMesh)
-					{
-						auto mesh = loadedAsset.As<StaticMesh>();
-						if (mesh->GetMeshSource() == handle)
-							reloadAsset = true;
-					}
-
-					if (reloadAsset)
-					{
-						auto& metaData2 = Project::GetEditorAssetManager()->GetMetaDataInternal(loadedHandle);
-						Ref<Asset> asset2;
-						metaData2.IsDataLoaded = AssetImporter::TryLoadData(metaData2, asset2);
-						if (metaData2.IsDataLoaded)
-						{
-							m_LoadedAssets.emplace_back(metaData2, asset2, true);
-							// TODO: Dispatch immediatly application event for asset reloaded
-						}
-					}
+					dependentIt->second.State = PendingLoadState::Queued;
+					PushReadyAssetLoad(dependent, dependentIt->second.Request.Priority);
 				}
 			}
+
+			m_PendingLoads.erase(it);
 		}
 
-		return result;
+		m_WorkFinishedCondition.notify_all();
+	}
+
+	std::filesystem::path EditorAssetThread::GetFileSystemPath(const AssetMetaData& metaData)
+	{
+		return Project::GetAssetDirectory() / metaData.FilePath;
 	}
 
 }
\ No newline at end of file
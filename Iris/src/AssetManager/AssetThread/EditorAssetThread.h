@@ -2,20 +2,22 @@
 
 #include "AssetManager/Asset/AssetMetaData.h"
 #include "Core/Base.h"
-#include "Core/Thread.h"
 
-#include <queue>
+#include <array>
+#include <condition_variable>
+#include <deque>
 
 /*
- * Asset thread waits a kick from the asset manager generally to load assets
- * TODO: When having ContentBrowserPanel, we may have to kick the asset thread from there to infom the thread of any asset changes in the current directory
- * so that we can trigger a reload
+ * The asset thread runs asset workers on the engine WorkerPool that pick up asset load requests queued by the asset manager, highest priority first
+ * - A worker job keeps loading untill the ready queues are empty, at most GetWorkerCount() of them run at once so the rest of the pool stays available
+ * - Requests for assets that are already queued or in flight are merged into the existing request and only raise its priority
+ * - Before an asset is loaded its dependencies are queued and the asset is parked untill they finish (MeshSource before StaticMesh, Texture2D before MaterialAsset)
+ * - Loaded assets are not visible to the engine untill the next sync between the AssetManager and the AssetThread
+ * - Reloads (queued by the asset manager when an asset file changes on disk) go through the same queues, the old asset stays in use untill the reloaded one is synced
  */
 
 namespace Iris {
 
-	struct AssetThreadData;
-
 	class EditorAssetThread : public RefCountedObject
 	{
 	public:
@@ -26,49 +28,84 @@ namespace Iris {
 
 		bool IsRunning() const { return m_Running; }
 		bool IsCurrentlyLoadingAssets() const;
+		uint32_t GetWorkerCount() const { return m_MaxWorkers; }
 
 		void QueueAssetLoad(const AssetLoadRequest& request);
+		void PrioritizeAssetLoad(AssetHandle handle, AssetLoadPriority priority);
+		// Returns false if the request can not be cancelled since other queued assets depend on it
+		// In case a worker already picked up the request, its result will be discarded
+		bool CancelAssetLoad(AssetHandle handle);
+
 		bool RetrieveReadyAssets(std::vector<AssetLoadRequest>& outAssetList);
 		void UpdateAssetManagerLoadedAssetList(const std::unordered_map<AssetHandle, Ref<Asset>>& loadedAssets);
 
+		// Used by the asset manager when an asset is requested from inside an asset worker (ex. StaticMesh getting its MeshSource)
+		// since the asset could be loaded but not yet synced with the asset manager
+		Ref<Asset> GetAssetFromWorker(AssetHandle handle);
+
 		void Run();
 		void Stop();
-		void StopAndWait(bool terminateThread = false);
-		void AssetMonitorUpdate();
+		void StopAndWait();
 
-		void Wait(ThreadState stateToWait);
-		void Set(ThreadState stateToSet);
-		void WaitAndSet(ThreadState stateToWait, ThreadState stateToSet);
+		// Returns true if called from one of the asset workers
+		static bool IsAssetThread();
 
 	private:
-		void AssetThreadFunc();
+		enum class PendingLoadState : uint8_t
+		{
+			Queued = 0,
+			WaitingOnDependencies,
+			InFlight
+		};
+
+		struct PendingAssetLoad
+		{
+			AssetLoadRequest Request;
+			PendingLoadState State = PendingLoadState::Queued;
+
+			bool DependenciesResolved = false;
+			uint32_t UnresolvedDependencies = 0;
+			std::vector<AssetHandle> Dependencies;
+			std::vector<AssetHandle> Dependents;
+
+			bool Cancelled = false;
+		};
+
+		void AssetWorkerJob();
+		void ProcessAssetLoad(AssetHandle handle);
+
+		// NOTE: All the functions below expect m_Mutex to be locked by the caller
+		// Submits another worker job to the WorkerPool unless there are enough of them already
+		void ScheduleWorker();
+		bool PopNextAssetLoad(AssetHandle& outHandle);
+		void PushReadyAssetLoad(AssetHandle handle, AssetLoadPriority priority);
+		void RaisePriority(AssetHandle handle, AssetLoadPriority priority);
+		bool QueueDependencies(AssetHandle handle, const std::vector<AssetHandle>& dependencies);
+		void FinishAssetLoad(AssetHandle handle, const AssetLoadRequest& result);
 
 		std::filesystem::path GetFileSystemPath(const AssetMetaData& metaData);
 
-		bool ReloadData(AssetHandle handle);
-
 	private:
-		Thread m_Thread;
-		AssetThreadData* m_Data;
+		uint32_t m_MaxWorkers = 1;
 
 		bool m_Running = false;
+		uint32_t m_ScheduledWorkers = 0; // Worker jobs submitted to the pool that did not exit yet
+		uint32_t m_ActiveWorkers = 0; // Worker jobs loading an asset right now
+
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_WorkFinishedCondition;
 
-		std::queue<AssetLoadRequest> m_AssetLoadingQueue;
-		std::mutex m_AssetLoadingQueueMutex;
+		std::unordered_map<AssetHandle, PendingAssetLoad> m_PendingLoads;
+		// Handles in a lower priority queue may be stale if the priority got raised, they are skipped when popped
+		std::array<std::deque<AssetHandle>, static_cast<std::size_t>(AssetLoadPriority::Count)> m_ReadyQueues;
 
 		std::vector<AssetLoadRequest> m_LoadedAssets; // These are local to the thread and are not yet visible to the engine untill the next sync between AssetManager and AssetThread is done.
-		std::mutex m_LoadedAssetsVectorMutex;
+		std::unordered_map<AssetHandle, Ref<Asset>> m_CompletedAssets; // Loaded assets that the asset manager does not know about yet, so that dependents can still find them
 
 		std::unordered_map<AssetHandle, Ref<Asset>> m_AMLoadedAssets;
 		std::mutex m_AMLoadedAssetsMapMutex;
 
-		// TODO: What the heck?
-		// Asset Monitoring
-		float m_AssetUpdateDelay = 0.2f;
-		float m_AssetUpdateTimer = 0.2f;
-		float m_AssetUpdatePerf = 0.0f;
-
-		inline static std::thread::id s_AssetThreadID;
+		inline static constexpr uint32_t s_MaxAssetWorkers = 8;
 
 	};
 
@@ -3,20 +3,22 @@
 
 #include "Asset/AssetExtensions.h"
 #include "AssetManager.h"
+#include "Core/Application.h"
+#include "Core/Events/AppEvents.h"
 #include "Importers/AssetImporter.h"
 #include "Project/Project.h"
 #include "Renderer/Mesh/Mesh.h"
+#include "Renderer/Renderer.h"
 #include "Renderer/StorageBufferSet.h"
 #include "Renderer/Texture.h"
 #include "Renderer/UniformBufferSet.h"
+#include "Scene/Scene.h"
 #include "Utils/StringUtils.h"
 
 #include <yaml-cpp/yaml.h>
 
 namespace Iris {
 
-	static AssetMetaData s_NullMetaData;
-
 	Ref<EditorAssetManager> EditorAssetManager::Create()
 	{
 		return CreateRef<EditorAssetManager>();
@@ -31,6 +33,9 @@ namespace Iris {
 
 		LoadAssetRegistry();
 		ReloadAssets();
+
+		m_AssetDirectoryWatcher = FileWatcher::Create(Project::GetAssetDirectory());
+		m_AssetDirectoryWatcher->Start();
 	}
 
 	EditorAssetManager::~EditorAssetManager()
@@ -41,7 +46,17 @@ namespace Iris {
 
 	void EditorAssetManager::Shutdown()
 	{
-		m_AssetThread->StopAndWait(true);
+		m_AssetDirectoryWatcher->Stop();
+		m_AssetThread->StopAndWait();
+
+		// The assets these are waiting on will never be synced, so free the suspended coroutines
+		for (auto& [handle, waiters] : m_AssetLoadWaiters)
+		{
+			for (AssetLoadWaiter* waiter : waiters)
+				waiter->Continuation.destroy();
+		}
+		m_AssetLoadWaiters.clear();
+
 		SerializeRegistry();
 	}
 
@@ -59,18 +74,23 @@ namespace Iris {
 		return asset && asset->IsValid() ? asset : nullptr;
 	}
 
-	AsyncAssetResult<Asset> EditorAssetManager::GetAssetAsync(AssetHandle handle)
+	AsyncAssetResult<Asset> EditorAssetManager::GetAssetAsync(AssetHandle handle, AssetLoadPriority priority)
 	{
-		if (IsMemoryAsset(handle))
-			return { m_MemoryAssets.at(handle), true };
+		{
+			std::scoped_lock<std::mutex> lock(m_MemoryAssetsMutex);
+			auto it = m_MemoryAssets.find(handle);
+			if (it != m_MemoryAssets.end())
+				return { it->second, true };
+		}
 
-		auto& metaData = GetMetaDataInternal(handle);
+		AssetMetaData metaData = GetMetaData(handle);
 		if (!metaData.IsValid())
 			return { nullptr, false }; // TODO: Return special error asset?
 
 		if (metaData.IsDataLoaded)
 		{
 			IR_VERIFY(m_LoadedAssets.contains(handle));
+			TouchAsset(handle);
 			return { m_LoadedAssets.at(handle), true };
 		}
 
@@ -79,8 +99,13 @@ namespace Iris {
 		if (metaData.Status != AssetStatus::Loading)
 		{
 			metaData.Status = AssetStatus::Loading;
-			m_AssetThread->QueueAssetLoad({ .MetaData = metaData });
-			m_AssetThread->Set(ThreadState::Kick);
+			m_AssetRegistry.Update(handle, [](AssetMetaData& entry) { entry.Status = AssetStatus::Loading; });
+			m_AssetThread->QueueAssetLoad({ .MetaData = metaData, .Priority = priority });
+		}
+		else
+		{
+			// Already queued, but the asset could have become more important since (ex. came into view)
+			m_AssetThread->PrioritizeAssetLoad(handle, priority);
 		}
 
 		return { AssetManager::GetPlaceHolderAsset(metaData.Type), false };
@@ -93,15 +118,41 @@ namespace Iris {
 		metaData.Type = asset->GetAssetType();
 		metaData.IsDataLoaded = true;
 		metaData.IsMemoryAsset = true;
-		m_AssetRegistry[metaData.Handle] = metaData;
+		m_AssetRegistry.Set(metaData.Handle, metaData);
 
+		std::scoped_lock<std::mutex> lock(m_MemoryAssetsMutex);
 		m_MemoryAssets[asset->Handle] = asset;
 	}
 
+	bool EditorAssetManager::CancelAssetLoad(AssetHandle handle)
+	{
+		// Cancelling would leave the waiting coroutines suspended forever
+		if (m_AssetLoadWaiters.contains(handle))
+			return false;
+
+		if (!m_AssetThread->CancelAssetLoad(handle))
+			return false;
+
+		// So that the next GetAssetAsync queues it again
+		m_AssetRegistry.Update(handle, [](AssetMetaData& entry)
+		{
+			if (entry.Status == AssetStatus::Loading)
+				entry.Status = AssetStatus::None;
+		});
+
+		return true;
+	}
+
+	void EditorAssetManager::AddAssetLoadWaiter(AssetLoadWaiter* waiter)
+	{
+		IR_ASSERT(!EditorAssetThread::IsAssetThread(), "Assets can only be awaited from the main thread");
+		m_AssetLoadWaiters[waiter->Handle].push_back(waiter);
+	}
+
 	bool EditorAssetManager::ReloadData(AssetHandle handle)
 	{
 		bool result = false;
-		AssetMetaData& metaData = GetMetaDataInternal(handle);
+		AssetMetaData metaData = GetMetaData(handle);
 		if (!metaData.IsValid())
 		{
 			IR_CORE_ERROR_TAG("AssetManager", "Trying to reload invalid asset!");
@@ -113,6 +164,7 @@ namespace Iris {
 			asset = m_LoadedAssets.at(handle);
 
 		metaData.IsDataLoaded = AssetImporter::TryLoadData(metaData, asset);
+		m_AssetRegistry.Update(handle, [isDataLoaded = metaData.IsDataLoaded](AssetMetaData& entry) { entry.IsDataLoaded = isDataLoaded; });
 		if (metaData.IsDataLoaded)
 		{
 			m_LoadedAssets[handle] = asset;
@@ -143,9 +195,10 @@ namespace Iris {
 
 					if (reloadAsset)
 					{
-						auto& metaData2 = GetMetaDataInternal(loadedHandle);
+						AssetMetaData metaData2 = GetMetaData(loadedHandle);
 						Ref<Asset> asset2;
 						metaData2.IsDataLoaded = AssetImporter::TryLoadData(metaData2, asset2);
+						m_AssetRegistry.Update(loadedHandle, [isDataLoaded = metaData2.IsDataLoaded](AssetMetaData& entry) { entry.IsDataLoaded = isDataLoaded; });
 						if (metaData2.IsDataLoaded)
 						{
 							m_LoadedAssets[loadedHandle] = asset2;
@@ -175,7 +228,7 @@ namespace Iris {
 		if (IsMemoryAsset(handle))
 			return false;
 
-		AssetMetaData& metaData = GetMetaDataInternal(handle);
+		AssetMetaData metaData = GetMetaData(handle);
 		return !FileSystem::Exists(Project::GetActive()->GetAssetDirectory() / metaData.FilePath);
 	}
 
@@ -184,26 +237,33 @@ namespace Iris {
 		if (m_LoadedAssets.contains(handle))
 			m_LoadedAssets.erase(handle);
 
-		if (m_MemoryAssets.contains(handle))
+		{
+			std::scoped_lock<std::mutex> lock(m_MemoryAssetsMutex);
 			m_MemoryAssets.erase(handle);
+		}
 
-		if (m_AssetRegistry.Contains(handle))
-			m_AssetRegistry.Remove(handle);
+		m_AssetRegistry.Remove(handle);
 	}
 
 	void EditorAssetManager::RegisterDependency(AssetHandle handle, AssetHandle dependency)
 	{
+		std::scoped_lock<std::mutex> lock(m_AssetDependenciesMutex);
 		m_AssetDependencies[handle].insert(dependency);
 	}
 
 	void EditorAssetManager::SyncWithAssetThread()
 	{
+		ProcessFileSystemChanges();
+
 		std::vector<AssetLoadRequest> freshAssets;
+		std::vector<AssetLoadWaiter*> readyWaiters;
 
 		m_AssetThread->RetrieveReadyAssets(freshAssets);
 		for (const AssetLoadRequest& alr : freshAssets)
 		{
-			m_LoadedAssets[alr.Asset->Handle] = alr.Asset;
+			// Failed loads may not have an asset at all
+			if (alr.Asset)
+				m_LoadedAssets[alr.MetaData.Handle] = alr.Asset;
 
 			AssetMetaData metaData = alr.MetaData;
 			if (metaData.Status != AssetStatus::Invalid)
@@ -214,41 +274,55 @@ namespace Iris {
 			else
 				metaData.IsDataLoaded = false;
 
-			m_AssetRegistry[alr.Asset->Handle] = metaData;
+			m_AssetRegistry.Set(alr.MetaData.Handle, metaData);
 
-			if (alr.Reloaded)
+			auto waitersIt = m_AssetLoadWaiters.find(alr.MetaData.Handle);
+			if (waitersIt != m_AssetLoadWaiters.end())
 			{
-				auto it = m_AssetDependencies.find(alr.Asset->Handle);
-				if (it != m_AssetDependencies.end())
+				Ref<Asset> result = metaData.IsDataLoaded && alr.Asset && alr.Asset->IsValid() ? alr.Asset : nullptr;
+				for (AssetLoadWaiter* waiter : waitersIt->second)
 				{
-					const auto& dependencies = it->second;
-					for (AssetHandle dependencyHandle : dependencies)
-					{
-						Ref<Asset> asset = GetAsset(dependencyHandle);
-						if (asset)
-							asset->OnDependencyUpdated(alr.Asset->Handle);
-					}
+					waiter->Result = result;
+					readyWaiters.push_back(waiter);
 				}
-			}
-		}
 
-		m_AssetThread->UpdateAssetManagerLoadedAssetList(m_LoadedAssets);
+				m_AssetLoadWaiters.erase(waitersIt);
+			}
 
-		for (auto it = m_PostSyncTasks.begin(); it != m_PostSyncTasks.end();)
-		{
-			if ((*it)() == true)
+			if (alr.Reloaded && alr.Asset)
 			{
-				it = m_PostSyncTasks.erase(it);
+				std::unordered_set<AssetHandle> dependencies;
+				{
+					std::scoped_lock<std::mutex> lock(m_AssetDependenciesMutex);
+					auto it = m_AssetDependencies.find(alr.Asset->Handle);
+					if (it != m_AssetDependencies.end())
+						dependencies = it->second;
+				}
+
+				for (AssetHandle dependencyHandle : dependencies)
+				{
+					Ref<Asset> asset = GetAsset(dependencyHandle);
+					if (asset)
+						asset->OnDependencyUpdated(alr.Asset->Handle);
+				}
 			}
-			else
-				++it;
 		}
+
+		// Before the asset thread gets the new list so that it drops its references to the evicted assets as well
+		UpdateAssetResidency();
+
+		m_AssetThread->UpdateAssetManagerLoadedAssetList(m_LoadedAssets);
+
+		// Resumed only after the whole batch is synced so that awaiting any of the fresh assets after resuming does not suspend again
+		// NOTE: Resuming may add new waiters
+		for (AssetLoadWaiter* waiter : readyWaiters)
+			waiter->Continuation.resume();
 	}
 
 	std::unordered_set<AssetHandle> EditorAssetManager::GetAllAssetsWithType(AssetType type) const
 	{
 		std::unordered_set<AssetHandle> result;
-		for (const auto& [handle, metaData] : m_AssetRegistry)
+		for (const auto& [handle, metaData] : m_AssetRegistry.GetSnapshot())
 		{
 			if (metaData.Type == type)
 				result.insert(handle);
@@ -257,36 +331,26 @@ namespace Iris {
 		return result;
 	}
 
-	const AssetMetaData& EditorAssetManager::GetMetaData(AssetHandle handle) const
+	AssetMetaData EditorAssetManager::GetMetaData(AssetHandle handle) const
 	{
-		if (m_AssetRegistry.Contains(handle))
-			return m_AssetRegistry[handle];
-
-		return s_NullMetaData;
+		// Returns a null meta data (Handle = 0) if the handle is not registered
+		return m_AssetRegistry.Get(handle);
 	}
 
-	AssetMetaData& EditorAssetManager::GetMetaData(AssetHandle handle)
-	{
-		if (m_AssetRegistry.Contains(handle))
-			return m_AssetRegistry[handle];
-
-		return s_NullMetaData;
-	}
-
-	const AssetMetaData& EditorAssetManager::GetMetaData(const std::filesystem::path& path) const
+	AssetMetaData EditorAssetManager::GetMetaData(const std::filesystem::path& path) const
 	{
 		const std::filesystem::path relativePath = GetRelativePath(path);
 
-		for (auto& [handle, metaData] : m_AssetRegistry)
+		for (const auto& [handle, metaData] : m_AssetRegistry.GetSnapshot())
 		{
 			if (relativePath == metaData.FilePath)
 				return metaData;
 		}
 
-		return s_NullMetaData;
+		return {};
 	}
 
-	const AssetMetaData& EditorAssetManager::GetMetaData(const Ref<Asset>& asset) const
+	AssetMetaData EditorAssetManager::GetMetaData(const Ref<Asset>& asset) const
 	{
 		return GetMetaData(asset->Handle);
 	}
@@ -295,7 +359,7 @@ namespace Iris {
 	{
 		std::filesystem::path relativePath = GetRelativePath(filePath);
 
-		const AssetMetaData& metaData = GetMetaData(relativePath);
+		AssetMetaData metaData = GetMetaData(relativePath);
 		if (metaData.IsValid())
 			return metaData.Handle;
 
@@ -307,7 +371,7 @@ namespace Iris {
 		metaData2.Handle = AssetHandle();
 		metaData2.FilePath = relativePath;
 		metaData2.Type = type;
-		m_AssetRegistry[metaData2.Handle] = metaData2;
+		m_AssetRegistry.Set(metaData2.Handle, metaData2);
 
 		return metaData2.Handle;
 	}
@@ -348,24 +412,36 @@ namespace Iris {
 
 	Ref<Asset> EditorAssetManager::GetAssetIncludingInvalid(AssetHandle handle)
 	{
+		{
+			std::scoped_lock<std::mutex> lock(m_MemoryAssetsMutex);
+			auto it = m_MemoryAssets.find(handle);
+			if (it != m_MemoryAssets.end())
+				return it->second;
+		}
+
+		// The asset workers must not touch m_LoadedAssets, they go through the asset thread which also knows about assets that are loaded but not synced yet
+		if (EditorAssetThread::IsAssetThread())
+			return m_AssetThread->GetAssetFromWorker(handle);
+
 		Ref<Asset> asset = nullptr;
 
-		if (IsMemoryAsset(handle))
-			asset = m_MemoryAssets.at(handle);
-		else
+		AssetMetaData metaData = GetMetaData(handle);
+		if (metaData.IsValid())
 		{
-			auto& metaData = GetMetaDataInternal(handle);
-			if (metaData.IsValid())
+			if (!metaData.IsDataLoaded)
 			{
-				if (!metaData.IsDataLoaded)
+				metaData.IsDataLoaded = AssetImporter::TryLoadData(metaData, asset);
+				if (metaData.IsDataLoaded)
 				{
-					metaData.IsDataLoaded = AssetImporter::TryLoadData(metaData, asset);
-					if (metaData.IsDataLoaded)
-						m_LoadedAssets[handle] = asset;
+					m_AssetRegistry.Update(handle, [](AssetMetaData& entry) { entry.IsDataLoaded = true; });
+					m_LoadedAssets[handle] = asset;
 				}
-				else
-					asset = m_LoadedAssets[handle];
 			}
+			else
+				asset = m_LoadedAssets[handle];
+
+			if (asset)
+				TouchAsset(handle);
 		}
 
 		return asset;
@@ -385,6 +461,7 @@ namespace Iris {
 		strStream << stream.rdbuf();
 
 		YAML::Node data = YAML::Load(strStream.str());
+		AssetRegistry::WriteBatch batch;
 		auto handles = data["Assets"];
 		if (!handles)
 		{
@@ -469,9 +546,11 @@ namespace Iris {
 				continue;
 			}
 
-			m_AssetRegistry[metaData.Handle] = metaData;
+			batch.Set(metaData.Handle, metaData);
 		}
 
+		m_AssetRegistry.Commit(batch);
+
 		IR_CORE_INFO_TAG("AssetManager", "Loaded {0} asset entries", m_AssetRegistry.Size());
 	}
 
@@ -484,7 +563,7 @@ namespace Iris {
 		};
 
 		std::map<UUID, AssetRegistryEntry> sortedMap;
-		for (auto& [handle, metaData] : m_AssetRegistry)
+		for (const auto& [handle, metaData] : m_AssetRegistry.GetSnapshot())
 		{
 			if (!FileSystem::Exists(GetFileSystemPath(metaData)))
 				continue;
@@ -524,48 +603,387 @@ namespace Iris {
 
 	void EditorAssetManager::ReloadAssets()
 	{
-		ProcessDirectory(Project::GetAssetDirectory().string());
+		ProcessDirectory(Project::GetAssetDirectory());
 		SerializeRegistry();
 	}
 
 	void EditorAssetManager::ProcessDirectory(const std::filesystem::path& path)
+	{
+		// Looking every file up by path in the registry would be quadratic so the known paths are gathered once
+		std::unordered_set<std::string> registeredPaths;
+		for (const auto& [handle, metaData] : m_AssetRegistry.GetSnapshot())
+			registeredPaths.insert(metaData.FilePath.generic_string());
+
+		AssetRegistry::WriteBatch batch;
+		ProcessDirectory(path, batch, registeredPaths);
+		m_AssetRegistry.Commit(batch);
+	}
+
+	void EditorAssetManager::ProcessDirectory(const std::filesystem::path& path, AssetRegistry::WriteBatch& batch, std::unordered_set<std::string>& registeredPaths)
 	{
 		for (auto entry : std::filesystem::directory_iterator{ path })
 		{
 			if (entry.is_directory())
-				ProcessDirectory(entry.path());
-			else
-				ImportAsset(entry.path());
+			{
+				ProcessDirectory(entry.path(), batch, registeredPaths);
+				continue;
+			}
+
+			std::filesystem::path relativePath = GetRelativePath(entry.path());
+			AssetType type = GetAssetTypeFromPath(relativePath);
+			if (type == AssetType::None || !registeredPaths.insert(relativePath.generic_string()).second)
+				continue;
+
+			AssetMetaData metaData;
+			metaData.Handle = AssetHandle();
+			metaData.FilePath = relativePath;
+			metaData.Type = type;
+			batch.Set(metaData.Handle, metaData);
 		}
 	}
 
-	AssetMetaData& EditorAssetManager::GetMetaDataInternal(AssetHandle handle)
+	void EditorAssetManager::ProcessFileSystemChanges()
 	{
-		if (m_AssetRegistry.Contains(handle))
-			return m_AssetRegistry[handle];
+		if (!m_AssetDirectoryWatcher->RetrieveChanges(m_FileSystemChanges))
+			return;
+
+		bool registryChanged = false;
+		for (const FileSystemChange& change : m_FileSystemChanges)
+		{
+			switch (change.Action)
+			{
+				case FileSystemAction::Added:
+				{
+					if (change.IsDirectory)
+						ProcessDirectory(change.FilePath);
+					else
+						ImportAsset(change.FilePath);
+
+					registryChanged = true;
+					break;
+				}
+				case FileSystemAction::Removed:
+				{
+					// We can not tell whether a removed path was a directory anymore
+					AssetMetaData metaData = GetMetaData(change.FilePath);
+					if (metaData.IsValid())
+						OnAssetDeleted(metaData.Handle);
+					else
+						OnDirectoryDeleted(change.FilePath);
+
+					registryChanged = true;
+					break;
+				}
+				case FileSystemAction::Modified:
+				{
+					// The watcher lost track of what changed so we only pick up new files
+					if (change.FilePath == m_AssetDirectoryWatcher->GetDirectory())
+					{
+						ProcessDirectory(Project::GetAssetDirectory());
+						registryChanged = true;
+						break;
+					}
+
+					AssetMetaData metaData = GetMetaData(change.FilePath);
+					if (!metaData.IsValid())
+					{
+						registryChanged |= ImportAsset(change.FilePath) != 0;
+						break;
+					}
+
+					if (metaData.IsDataLoaded)
+						QueueAssetReload(metaData);
+
+					break;
+				}
+				case FileSystemAction::Renamed:
+				{
+					if (change.IsDirectory)
+					{
+						OnDirectoryRenamed(change.OldFilePath, change.FilePath);
+					}
+					else
+					{
+						AssetMetaData metaData = GetMetaData(change.OldFilePath);
+						if (metaData.IsValid())
+							OnAssetRenamed(metaData.Handle, change.FilePath);
+						else
+							ImportAsset(change.FilePath);
+					}
+
+					registryChanged = true;
+					break;
+				}
+			}
+		}
+
+		if (registryChanged)
+			SerializeRegistry();
+
+		Application::Get().DispatchEvent<Events::FileSystemChangedEvent, true>(m_FileSystemChanges);
+	}
+
+	void EditorAssetManager::QueueAssetReload(const AssetMetaData& metaData)
+	{
+		// Iris assets (scenes, static meshes, materials) are written by the editor itself so the loaded asset is always ahead of the file,
+		// reloading them would throw away unsaved edits. Only assets authored outside of the editor are hot reloaded
+		if (metaData.Type == AssetType::Scene || metaData.Type == AssetType::StaticMesh || metaData.Type == AssetType::Material)
+			return;
+
+		IR_CORE_INFO_TAG("AssetManager", "Reloading asset: {}", metaData.FilePath.string());
+		m_AssetThread->QueueAssetLoad({ .MetaData = metaData, .Reloaded = true, .Priority = AssetLoadPriority::Normal });
+
+		// Static meshes have data that depends on the mesh source, they wait for the mesh source reload since it is one of their dependencies
+		if (metaData.Type == AssetType::MeshSource)
+		{
+			for (const auto& [handle, asset] : m_LoadedAssets)
+			{
+				if (asset->GetAssetType() != AssetType::StaticMesh || asset.As<StaticMesh>()->GetMeshSource() != metaData.Handle)
+					continue;
 
-		return s_NullMetaData; // Make sure you check return value before changing cause you will be editing a null metaData if it is not valid
+				m_AssetThread->QueueAssetLoad({ .MetaData = GetMetaData(handle), .Reloaded = true, .Priority = AssetLoadPriority::Normal });
+			}
+		}
 	}
 
 	void EditorAssetManager::OnAssetRenamed(AssetHandle handle, const std::filesystem::path& newFilePath)
 	{
-		AssetMetaData& metaData = m_AssetRegistry[handle];
-		if (!metaData.IsValid())
+		if (!GetMetaData(handle).IsValid())
 			return;
 
-		metaData.FilePath = GetRelativePath(newFilePath);
-		SerializeRegistry();
+		m_AssetRegistry.Update(handle, [relativePath = GetRelativePath(newFilePath)](AssetMetaData& entry) { entry.FilePath = relativePath; });
 	}
 
 	void EditorAssetManager::OnAssetDeleted(AssetHandle handle)
 	{
-		AssetMetaData& metaData = m_AssetRegistry[handle];
-		if (!metaData.IsValid())
+		if (!GetMetaData(handle).IsValid())
 			return;
 
 		m_AssetRegistry.Remove(handle);
 		m_LoadedAssets.erase(handle);
-		SerializeRegistry();
+	}
+
+	void EditorAssetManager::OnDirectoryRenamed(const std::filesystem::path& oldDirectoryPath, const std::filesystem::path& newDirectoryPath)
+	{
+		const std::filesystem::path oldRelativePath = GetRelativePath(oldDirectoryPath);
+		const std::filesystem::path newRelativePath = GetRelativePath(newDirectoryPath);
+
+		for (const auto& [handle, metaData] : m_AssetRegistry.GetSnapshot())
+		{
+			if (metaData.IsMemoryAsset)
+				continue;
+
+			std::filesystem::path pathInDirectory = metaData.FilePath.lexically_relative(oldRelativePath);
+			if (pathInDirectory.empty() || *pathInDirectory.begin() == "..")
+				continue;
+
+			m_AssetRegistry.Update(handle, [filePath = newRelativePath / pathInDirectory](AssetMetaData& entry) { entry.FilePath = filePath; });
+		}
+	}
+
+	void EditorAssetManager::OnDirectoryDeleted(const std::filesystem::path& directoryPath)
+	{
+		const std::filesystem::path relativePath = GetRelativePath(directoryPath);
+
+		for (const auto& [handle, metaData] : m_AssetRegistry.GetSnapshot())
+		{
+			if (metaData.IsMemoryAsset)
+				continue;
+
+			std::filesystem::path pathInDirectory = metaData.FilePath.lexically_relative(relativePath);
+			if (pathInDirectory.empty() || *pathInDirectory.begin() == "..")
+				continue;
+
+			OnAssetDeleted(handle);
+		}
+	}
+
+	void EditorAssetManager::UpdateAssetResidency()
+	{
+		if (++m_CurrentFrame % s_ResidencyUpdateInterval != 0)
+			return;
+
+		std::unordered_map<AssetHandle, uint32_t> usageCounts;
+		Scene::GetAssetUsageCounts(usageCounts);
+
+		// Whatever a loaded asset refers to by handle has to stay resident as long as it is loaded
+		for (const auto& [handle, asset] : m_LoadedAssets)
+		{
+			// Assets that were never used still get the grace period from when they were first seen
+			m_AssetResidency.try_emplace(handle, AssetResidency{ .LastUsedFrame = m_CurrentFrame });
+
+			if (asset->GetAssetType() == AssetType::StaticMesh)
+			{
+				Ref<StaticMesh> staticMesh = asset.As<StaticMesh>();
+				usageCounts[staticMesh->GetMeshSource()]++;
+				if (staticMesh->GetMaterials())
+				{
+					for (const auto& [index, materialHandle] : staticMesh->GetMaterials()->GetMaterials())
+						usageCounts[materialHandle]++;
+				}
+			}
+			else if (asset->GetAssetType() == AssetType::MeshSource)
+			{
+				Ref<MeshSource> meshSource = asset.As<MeshSource>();
+				for (AssetHandle materialHandle : meshSource->GetMaterials())
+					usageCounts[materialHandle]++;
+
+				// A different object means the mesh source got reloaded and the old memory assets are not used by it anymore
+				MeshSourceMemoryAssets& memoryAssets = m_MeshSourceMemoryAssets[handle];
+				if (memoryAssets.MeshSource == asset.Raw())
+					continue;
+
+				m_OrphanedMemoryAssets.insert(m_OrphanedMemoryAssets.end(), memoryAssets.Assets.begin(), memoryAssets.Assets.end());
+				memoryAssets.MeshSource = asset.Raw();
+				memoryAssets.Assets.clear();
+
+				std::scoped_lock<std::mutex> lock(m_MemoryAssetsMutex);
+				for (AssetHandle materialHandle : meshSource->GetMaterials())
+				{
+					auto it = m_MemoryAssets.find(materialHandle);
+					if (it == m_MemoryAssets.end())
+						continue;
+
+					memoryAssets.Assets.push_back(materialHandle);
+
+					Ref<MaterialAsset> material = it->second.As<MaterialAsset>();
+					for (const Ref<Texture2D>& map : { material->GetAlbedoMap(), material->GetNormalMap(), material->GetRoughnessMap(), material->GetMetalnessMap() })
+					{
+						if (map && m_MemoryAssets.contains(map->Handle))
+							memoryAssets.Assets.push_back(map->Handle);
+					}
+				}
+			}
+		}
+
+		std::erase_if(m_MeshSourceMemoryAssets, [this](const auto& pair)
+		{
+			if (m_LoadedAssets.contains(pair.first))
+				return false;
+
+			m_OrphanedMemoryAssets.insert(m_OrphanedMemoryAssets.end(), pair.second.Assets.begin(), pair.second.Assets.end());
+			return true;
+		});
+
+		std::erase_if(m_AssetResidency, [this](const auto& pair) { return !m_LoadedAssets.contains(pair.first); });
+		for (auto& [handle, residency] : m_AssetResidency)
+		{
+			auto it = usageCounts.find(handle);
+			residency.UsageCount = it != usageCounts.end() ? it->second : 0;
+			if (residency.UsageCount > 0)
+				residency.LastUsedFrame = m_CurrentFrame;
+		}
+
+		ReleaseOrphanedMemoryAssets(usageCounts);
+
+		// Only what eviction can actually give back is measured, render targets and memory only assets are not managed by the budget
+		uint64_t cpuUsage = 0;
+		uint64_t gpuUsage = 0;
+		for (const auto& [handle, asset] : m_LoadedAssets)
+		{
+			if (asset->GetAssetType() == AssetType::Scene)
+				continue;
+
+			cpuUsage += asset->GetCPUMemoryUsage();
+			gpuUsage += asset->GetGPUMemoryUsage();
+		}
+
+		uint64_t gpuBudget = m_MemoryBudget.GPUMemory ? m_MemoryBudget.GPUMemory : Renderer::GetGPUMemoryStats().TotalAvailable / 10 * 8;
+
+		if (cpuUsage <= m_MemoryBudget.CPUMemory && gpuUsage <= gpuBudget)
+		{
+			m_OverMemoryBudget = false;
+			return;
+		}
+
+		std::vector<std::pair<uint64_t, AssetHandle>> candidates;
+		for (const auto& [handle, asset] : m_LoadedAssets)
+		{
+			const AssetResidency& residency = m_AssetResidency.at(handle);
+			if (residency.UsageCount > 0 || m_CurrentFrame - residency.LastUsedFrame < s_EvictionGraceFrames)
+				continue;
+
+			// Scenes are owned by the editor and anything holding a reference (materials holding their textures, editor panels...) is still using the asset
+			if (asset->GetAssetType() == AssetType::Scene || asset->GetRefCount() > s_AssetManagerReferenceCount)
+				continue;
+
+			candidates.emplace_back(residency.LastUsedFrame, handle);
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+
+		uint32_t evictedCount = 0;
+		for (const auto& [lastUsedFrame, handle] : candidates)
+		{
+			if (cpuUsage <= m_MemoryBudget.CPUMemory && gpuUsage <= gpuBudget)
+				break;
+
+			const Ref<Asset>& asset = m_LoadedAssets.at(handle);
+			cpuUsage -= std::min(cpuUsage, asset->GetCPUMemoryUsage());
+			gpuUsage -= std::min(gpuUsage, asset->GetGPUMemoryUsage());
+
+			EvictAsset(handle);
+			evictedCount++;
+		}
+
+		if (evictedCount)
+		{
+			IR_CORE_INFO_TAG("AssetManager", "Evicted {} assets to stay within the memory budget (CPU: {} / {}, GPU: {} / {})", evictedCount,
+				Utils::BytesToString(cpuUsage), Utils::BytesToString(m_MemoryBudget.CPUMemory), Utils::BytesToString(gpuUsage), Utils::BytesToString(gpuBudget));
+		}
+		else if (!m_OverMemoryBudget)
+		{
+			// Only warn once, everything resident is still in use
+			IR_CORE_WARN_TAG("AssetManager", "Over the asset memory budget but nothing can be evicted (CPU: {} / {}, GPU: {} / {})",
+				Utils::BytesToString(cpuUsage), Utils::BytesToString(m_MemoryBudget.CPUMemory), Utils::BytesToString(gpuUsage), Utils::BytesToString(gpuBudget));
+		}
+
+		m_OverMemoryBudget = evictedCount == 0;
+	}
+
+	void EditorAssetManager::EvictAsset(AssetHandle handle)
+	{
+		AssetMetaData metaData = GetMetaData(handle);
+		IR_CORE_TRACE_TAG("AssetManager", "Evicting asset: {}", metaData.FilePath.string());
+
+		// The asset is destroyed (and its GPU resources queued for release) once the asset thread drops its reference in this sync
+		// Next time it is requested it is simply loaded again
+		m_LoadedAssets.erase(handle);
+		m_AssetResidency.erase(handle);
+		m_AssetRegistry.Update(handle, [](AssetMetaData& entry)
+		{
+			entry.IsDataLoaded = false;
+			entry.Status = AssetStatus::None;
+		});
+	}
+
+	void EditorAssetManager::ReleaseOrphanedMemoryAssets(const std::unordered_map<AssetHandle, uint32_t>& usageCounts)
+	{
+		if (m_OrphanedMemoryAssets.empty())
+			return;
+
+		// Materials go first since they hold on to their textures
+		std::stable_partition(m_OrphanedMemoryAssets.begin(), m_OrphanedMemoryAssets.end(), [this](AssetHandle handle) { return GetAssetType(handle) == AssetType::Material; });
+
+		// Whatever is still in use stays orphaned and is checked again next time
+		std::erase_if(m_OrphanedMemoryAssets, [this, &usageCounts](AssetHandle handle)
+		{
+			if (usageCounts.contains(handle))
+				return false;
+
+			{
+				std::scoped_lock<std::mutex> lock(m_MemoryAssetsMutex);
+				auto it = m_MemoryAssets.find(handle);
+				if (it == m_MemoryAssets.end())
+					return true;
+
+				if (it->second->GetRefCount() > 1)
+					return false;
+			}
+
+			RemoveAsset(handle);
+			return true;
+		});
 	}
 
 }
\ No newline at end of file
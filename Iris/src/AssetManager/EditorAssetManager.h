@@ -5,9 +5,18 @@
 #include "AssetThread/EditorAssetThread.h"
 #include "Core/Hash.h"
 #include "Importers/AssetImporter.h"
+#include "Utils/FileWatcher.h"
 
 namespace Iris {
 
+	// Once the loaded assets go over one of these, the least recently used assets that nothing references anymore are evicted
+	// They are loaded again the next time they are requested. Set from the project config (ProjectConfig::AssetMemoryBudget)
+	struct AssetMemoryBudget
+	{
+		uint64_t CPUMemory = 2ull * 1024 * 1024 * 1024;
+		uint64_t GPUMemory = 0; // 0 means 80% of the device memory budget reported by the allocator
+	};
+
 	class EditorAssetManager : public AssetManagerBase
 	{
 	public:
@@ -20,12 +29,14 @@ namespace Iris {
 
 		virtual AssetType GetAssetType(AssetHandle handle) const override;
 		virtual Ref<Asset> GetAsset(AssetHandle handle) override;
-		virtual AsyncAssetResult<Asset> GetAssetAsync(AssetHandle handle) override;
+		virtual AsyncAssetResult<Asset> GetAssetAsync(AssetHandle handle, AssetLoadPriority priority = AssetLoadPriority::Normal) override;
+		virtual bool CancelAssetLoad(AssetHandle handle) override;
+		virtual void AddAssetLoadWaiter(AssetLoadWaiter* waiter) override;
 
 		virtual void AddMemoryOnlyAsset(Ref<Asset> asset) override;
 		virtual bool ReloadData(AssetHandle handle) override;
 		virtual bool IsAssetHandleValid(AssetHandle handle) const override { return IsMemoryAsset(handle) || GetMetaData(handle).IsValid(); }
-		virtual bool IsMemoryAsset(AssetHandle handle) const override { return m_MemoryAssets.contains(handle); }
+		virtual bool IsMemoryAsset(AssetHandle handle) const override { std::scoped_lock<std::mutex> lock(m_MemoryAssetsMutex); return m_MemoryAssets.contains(handle); }
 		virtual bool IsAssetLoaded(AssetHandle handle) override { return m_LoadedAssets.contains(handle); }
 		virtual bool IsAssetValid(AssetHandle handle, bool loadAsync = false) override;
 		virtual bool IsAssetMissing(AssetHandle handle) override;
@@ -40,10 +51,10 @@ namespace Iris {
 		virtual const std::unordered_map<AssetHandle, Ref<Asset>>& GetLoadedAssets() const override { return m_LoadedAssets; }
 
 		// Editor only
-		const AssetMetaData& GetMetaData(AssetHandle handle) const;
-		AssetMetaData& GetMetaData(AssetHandle handle);
-		const AssetMetaData& GetMetaData(const std::filesystem::path& path) const;
-		const AssetMetaData& GetMetaData(const Ref<Asset>& asset) const;
+		// NOTE: These return copies since the registry can be mutated from other threads, use the AssetRegistry::Update for mutations
+		AssetMetaData GetMetaData(AssetHandle handle) const;
+		AssetMetaData GetMetaData(const std::filesystem::path& path) const;
+		AssetMetaData GetMetaData(const Ref<Asset>& asset) const;
 
 		AssetHandle ImportAsset(const std::filesystem::path& filePath);
 
@@ -60,6 +71,7 @@ namespace Iris {
 		bool FileExists(const AssetMetaData& metaData) const;
 
 		const AssetRegistry& GetAssetRegistry() const { return m_AssetRegistry; }
+		AssetRegistry& GetAssetRegistry() { return m_AssetRegistry; }
 
 		template<typename T, typename... Args>
 		Ref<T> CreateNewAsset(const std::string& filename, const std::filesystem::path& directorypath, Args&&... args)
@@ -75,7 +87,7 @@ namespace Iris {
 			metaData.IsDataLoaded = true;
 			metaData.Type = T::GetStaticType();
 
-			m_AssetRegistry[metaData.Handle] = metaData;
+			m_AssetRegistry.Set(metaData.Handle, metaData);
 
 			SerializeRegistry();
 
@@ -102,7 +114,9 @@ namespace Iris {
 			metadata.Type = T::GetStaticType();
 			metadata.IsMemoryAsset = true;
 
-			m_AssetRegistry[metadata.Handle] = metadata;
+			m_AssetRegistry.Set(metadata.Handle, metadata);
+
+			std::scoped_lock<std::mutex> lock(m_MemoryAssetsMutex);
 			m_MemoryAssets[asset->Handle] = asset;
 
 			return asset->Handle;
@@ -110,12 +124,8 @@ namespace Iris {
 
 		void ReplaceLoadedAsset(AssetHandle handle, Ref<Asset> asset) { m_LoadedAssets[handle] = asset; }
 
-		void AddPostSyncTask(const std::function<bool()>& fn, bool dispatchFirst = false)
-		{ 
-			if (dispatchFirst)
-				fn();
-			m_PostSyncTasks.push_back(fn);
-		}
+		const AssetMemoryBudget& GetMemoryBudget() const { return m_MemoryBudget; }
+		void SetMemoryBudget(const AssetMemoryBudget& budget) { m_MemoryBudget = budget; }
 
 	private:
 		Ref<Asset> GetAssetIncludingInvalid(AssetHandle handle);
@@ -123,23 +133,69 @@ namespace Iris {
 		void LoadAssetRegistry();
 		void SerializeRegistry();
 		void ReloadAssets();
+		// Registers every file under path that is not yet in the registry in one batch
 		void ProcessDirectory(const std::filesystem::path& path);
+		// Registers every file that is not yet in the registry into the batch, registeredPaths holds the relative paths that are known already
+		void ProcessDirectory(const std::filesystem::path& path, AssetRegistry::WriteBatch& batch, std::unordered_set<std::string>& registeredPaths);
 
-		AssetMetaData& GetMetaDataInternal(AssetHandle handle);
+		// Turns the changes picked up by the file watcher into imports, reloads, renames and deletions
+		void ProcessFileSystemChanges();
+		void QueueAssetReload(const AssetMetaData& metaData);
 
+		// NOTE: These do not serialize the registry, callers do that once they are done
 		void OnAssetRenamed(AssetHandle handle, const std::filesystem::path& newFilePath);
 		void OnAssetDeleted(AssetHandle handle);
+		void OnDirectoryRenamed(const std::filesystem::path& oldDirectoryPath, const std::filesystem::path& newDirectoryPath);
+		void OnDirectoryDeleted(const std::filesystem::path& directoryPath);
+
+		// Residency, main thread only
+		void TouchAsset(AssetHandle handle) { m_AssetResidency[handle].LastUsedFrame = m_CurrentFrame; }
+		void UpdateAssetResidency();
+		void EvictAsset(AssetHandle handle);
+		void ReleaseOrphanedMemoryAssets(const std::unordered_map<AssetHandle, uint32_t>& usageCounts);
 
 	private:
 		std::unordered_map<AssetHandle, Ref<Asset>> m_LoadedAssets;
+		// NOTE: Memory assets and dependencies are also created/registered by the asset workers while loading (ex. mesh materials) so they are guarded
 		std::unordered_map<AssetHandle, Ref<Asset>> m_MemoryAssets;
+		mutable std::mutex m_MemoryAssetsMutex;
 
 		std::unordered_map<AssetHandle, std::unordered_set<AssetHandle>> m_AssetDependencies;
+		std::mutex m_AssetDependenciesMutex;
 
 		Ref<EditorAssetThread> m_AssetThread;
 		AssetRegistry m_AssetRegistry;
 
-		std::vector<std::function<bool()>> m_PostSyncTasks;
+		Ref<FileWatcher> m_AssetDirectoryWatcher;
+		std::vector<FileSystemChange> m_FileSystemChanges;
+
+		struct AssetResidency
+		{
+			uint32_t UsageCount = 0; // References from live scenes and from other resident assets
+			uint64_t LastUsedFrame = 0;
+		};
+
+		// Memory only assets created when importing a mesh source (materials and their textures), they are released once the mesh source
+		// that created them is evicted or reloaded and nothing references them anymore
+		struct MeshSourceMemoryAssets
+		{
+			const Asset* MeshSource = nullptr;
+			std::vector<AssetHandle> Assets;
+		};
+
+		AssetMemoryBudget m_MemoryBudget;
+		uint64_t m_CurrentFrame = 0;
+		bool m_OverMemoryBudget = false;
+		std::unordered_map<AssetHandle, AssetResidency> m_AssetResidency;
+		std::unordered_map<AssetHandle, MeshSourceMemoryAssets> m_MeshSourceMemoryAssets;
+		std::vector<AssetHandle> m_OrphanedMemoryAssets;
+
+		inline static constexpr uint64_t s_ResidencyUpdateInterval = 30; // Frames
+		inline static constexpr uint64_t s_EvictionGraceFrames = 300; // Assets used more recently than this are never evicted
+		// An asset only held by m_LoadedAssets and the asset thread's copy of it is not referenced by anything else
+		inline static constexpr uint32_t s_AssetManagerReferenceCount = 2;
+
+		std::unordered_map<AssetHandle, std::vector<AssetLoadWaiter*>> m_AssetLoadWaiters; // Suspended AssetTask coroutines
 
 		friend class EditorAssetThread;
 
@@ -10,6 +10,8 @@
 namespace Iris {
 
 	std::unordered_map<AssetType, Scope<AssetSerializer>> AssetImporter::s_Serializers;
+	std::unordered_map<AssetHandle, AssetImporter::CachedDependencies> AssetImporter::s_DependencyCache;
+	std::mutex AssetImporter::s_DependencyCacheMutex;
 
 	void AssetImporter::Init()
 	{
@@ -32,6 +34,9 @@ namespace Iris {
 		}
 
 		s_Serializers[asset->GetAssetType()]->Serialize(metaData, asset);
+
+		std::scoped_lock<std::mutex> lock(s_DependencyCacheMutex);
+		s_DependencyCache.erase(metaData.Handle);
 	}
 
 	void AssetImporter::Serialize(const Ref<Asset>& asset)
@@ -51,4 +56,35 @@ namespace Iris {
 		return s_Serializers[metaData.Type]->TryLoadData(metaData, asset);
 	}
 
+	void AssetImporter::GetDependencies(const AssetMetaData& metaData, std::vector<AssetHandle>& outDependencies)
+	{
+		auto it = s_Serializers.find(metaData.Type);
+		if (it == s_Serializers.end())
+			return;
+
+		// Only a stat of the asset file, a changed write time means it was edited outside of the editor and has to be parsed again
+		std::error_code error;
+		std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(Project::GetEditorAssetManager()->GetFileSystemPath(metaData), error);
+
+		{
+			std::scoped_lock<std::mutex> lock(s_DependencyCacheMutex);
+			auto cached = s_DependencyCache.find(metaData.Handle);
+			if (!error && cached != s_DependencyCache.end() && cached->second.LastWriteTime == lastWriteTime)
+			{
+				outDependencies.insert(outDependencies.end(), cached->second.Dependencies.begin(), cached->second.Dependencies.end());
+				return;
+			}
+		}
+
+		std::vector<AssetHandle> dependencies;
+		it->second->GetDependencies(metaData, dependencies);
+		outDependencies.insert(outDependencies.end(), dependencies.begin(), dependencies.end());
+
+		if (error)
+			return;
+
+		std::scoped_lock<std::mutex> lock(s_DependencyCacheMutex);
+		s_DependencyCache[metaData.Handle] = { lastWriteTime, std::move(dependencies) };
+	}
+
 }
\ No newline at end of file
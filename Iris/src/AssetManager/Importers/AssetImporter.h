@@ -12,9 +12,21 @@ namespace Iris {
 		static void Serialize(const AssetMetaData& metadata, const Ref<Asset>& asset);
 		static void Serialize(const Ref<Asset>& asset);
 		static bool TryLoadData(const AssetMetaData& metadata, Ref<Asset>& asset);
+		static void GetDependencies(const AssetMetaData& metadata, std::vector<AssetHandle>& outDependencies);
+
+	private:
+		struct CachedDependencies
+		{
+			std::filesystem::file_time_type LastWriteTime;
+			std::vector<AssetHandle> Dependencies;
+		};
 
 	private:
 		static std::unordered_map<AssetType, Scope<AssetSerializer>> s_Serializers;
+
+		// Dependencies only change when the asset file does so they are parsed once per file version instead of on every load
+		static std::unordered_map<AssetHandle, CachedDependencies> s_DependencyCache;
+		static std::mutex s_DependencyCacheMutex;
 	};
 
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "AssetSerializer.h"
 
 #include "AssetManager/AssetManager.h"
+#include "AssetManager/AssetThread/EditorAssetThread.h"
 #include "Project/Project.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/StorageBufferSet.h"
@@ -22,7 +23,9 @@ namespace Iris {
 
 	bool TextureSerializer::TryLoadData(const AssetMetaData& metaData, Ref<Asset>& asset) const
 	{
-		asset = Texture2D::Create(TextureSpecification(), Project::GetEditorAssetManager()->GetFileSystemPathString(metaData));
+		TextureSpecification spec;
+		spec.Streaming = Renderer::GetConfig().TextureStreaming;
+		asset = Texture2D::Create(spec, Project::GetEditorAssetManager()->GetFileSystemPathString(metaData));
 		asset->Handle = metaData.Handle;
 
 		bool result = asset.As<Texture2D>()->Loaded();
@@ -70,6 +73,27 @@ namespace Iris {
 		return true;
 	}
 
+	void MaterialAssetSerializer::GetDependencies(const AssetMetaData& metaData, std::vector<AssetHandle>& outDependencies) const
+	{
+		std::ifstream stream(Project::GetEditorAssetManager()->GetFileSystemPath(metaData));
+		if (!stream.is_open())
+			return;
+
+		std::stringstream strStream;
+		strStream << stream.rdbuf();
+
+		YAML::Node materialNode = YAML::Load(strStream.str())["Material"];
+		if (!materialNode)
+			return;
+
+		for (const char* map : { "AlbedoMap", "NormalMap", "RoughnessMap", "MetalnessMap" })
+		{
+			AssetHandle mapHandle = materialNode[map].as<AssetHandle>(AssetHandle(0));
+			if (mapHandle)
+				outDependencies.push_back(mapHandle);
+		}
+	}
+
 	std::string MaterialAssetSerializer::SerializeToYAML(Ref<MaterialAsset> materialAsset) const
 	{
 		YAML::Emitter out;
@@ -182,6 +206,9 @@ namespace Iris {
 			targetAsset->SetTransparency(transparency);
 		}
 
+		// The asset workers load the maps before the material so they can be set right away, otherwise they are set once they are loaded
+		bool setImmediatly = EditorAssetThread::IsAssetThread();
+
 		AssetHandle albedoMap, normalMap, roughnessMap, metalnessMap;
 		albedoMap = materialNode["AlbedoMap"].as<AssetHandle>(AssetHandle(0));
 
@@ -195,25 +222,25 @@ namespace Iris {
 		if (albedoMap)
 		{
 			if (AssetManager::IsAssetHandleValid(albedoMap))
-				targetAsset->SetAlbedoMap(albedoMap);
+				targetAsset->SetAlbedoMap(albedoMap, setImmediatly);
 		}
 
 		if (normalMap)
 		{
 			if (AssetManager::IsAssetHandleValid(normalMap))
-				targetAsset->SetNormalMap(normalMap);
+				targetAsset->SetNormalMap(normalMap, setImmediatly);
 		}
 
 		if (roughnessMap)
 		{
 			if (AssetManager::IsAssetHandleValid(roughnessMap))
-				targetAsset->SetRoughnessMap(roughnessMap);
+				targetAsset->SetRoughnessMap(roughnessMap, setImmediatly);
 		}
 
 		if (metalnessMap)
 		{
 			if (AssetManager::IsAssetHandleValid(metalnessMap))
-				targetAsset->SetMetalnessMap(metalnessMap);
+				targetAsset->SetMetalnessMap(metalnessMap, setImmediatly);
 		}
 
 		uint32_t materialFlags = materialNode["MaterialFlags"].as<uint32_t>(0);
@@ -240,12 +267,12 @@ namespace Iris {
 
 	bool EnvironmentSerializer::TryLoadData(const AssetMetaData& metaData, Ref<Asset>& asset) const
 	{
-		auto [radiance, irradiance] = Renderer::CreateEnvironmentMap(Project::GetEditorAssetManager()->GetFileSystemPathString(metaData));
+		Ref<Environment> environment = Renderer::CreateEnvironmentMap(Project::GetEditorAssetManager()->GetFileSystemPathString(metaData));
 	
-		if (!radiance || !irradiance)
+		if (!environment || !environment->RadianceMap || !environment->IrradianceMap)
 			return false;
 	
-		asset = Environment::Create(radiance, irradiance);
+		asset = environment;
 		asset->Handle = metaData.Handle;
 		return true;
 	}
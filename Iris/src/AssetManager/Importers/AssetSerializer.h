@@ -11,6 +11,9 @@ namespace Iris {
 	{
 		virtual void Serialize(const AssetMetaData& metaData, const Ref<Asset>& asset) const = 0;
 		virtual bool TryLoadData(const AssetMetaData& metaData, Ref<Asset>& asset) const = 0;
+
+		// Assets that have to be loaded before this one can be loaded, used by the asset thread to order the asset loads
+		virtual void GetDependencies(const AssetMetaData& metaData, std::vector<AssetHandle>& outDependencies) const { (void)metaData, (void)outDependencies; }
 	};
 
 	struct TextureSerializer : public AssetSerializer
@@ -23,6 +26,7 @@ namespace Iris {
 	{
 		virtual void Serialize(const AssetMetaData& metaData, const Ref<Asset>& asset) const override;
 		virtual bool TryLoadData(const AssetMetaData& metaData, Ref<Asset>& asset) const override;
+		virtual void GetDependencies(const AssetMetaData& metaData, std::vector<AssetHandle>& outDependencies) const override;
 
 	private:
 		std::string SerializeToYAML(Ref<MaterialAsset> materialAsset) const;
@@ -2,6 +2,7 @@
 #include "MeshImporter.h"
 
 #include "AssetManager/AssetManager.h"
+#include "Core/WorkerPool.h"
 #include "ImGui/Themes.h"
 #include "Renderer/Mesh/Mesh.h"
 #include "Renderer/Renderer.h"
@@ -31,8 +32,59 @@ namespace Iris {
 			return result;
 		}
 
+		static void InvertImage(Buffer imageData, ImageFormat format)
+		{
+			if (format == ImageFormat::RGBA32F)
+			{
+				float* texels = reinterpret_cast<float*>(imageData.Data);
+				for (uint64_t i = 0; i < imageData.Size / sizeof(float); i += 4)
+				{
+					texels[i + 0] = 1.0f - texels[i + 0];
+					texels[i + 1] = 1.0f - texels[i + 1];
+					texels[i + 2] = 1.0f - texels[i + 2];
+				}
+			}
+			else
+			{
+				uint8_t* texels = imageData.Data;
+				for (uint64_t i = 0; i < imageData.Size; i += 4)
+				{
+					texels[i + 0] = 255 - texels[i + 0];
+					texels[i + 1] = 255 - texels[i + 1];
+					texels[i + 2] = 255 - texels[i + 2];
+				}
+			}
+		}
+
 	}
 
+	struct MeshTextureSource
+	{
+		std::filesystem::path Path; // Canonical path of the image file, empty for embedded textures
+		const aiTexture* EmbeddedTexture = nullptr;
+
+		TextureSpecification Specification;
+		bool Invert = false; // Shininess maps get inverted into roughness maps
+
+		Buffer EncodedData; // Owned only for image files, embedded textures point into the aiScene
+		uint64_t ContentHash = 0;
+		uint32_t SharedIndex = UINT32_MAX; // Source with the exact same content that the texture is shared with
+
+		Ref<Texture2D> Texture;
+		AssetHandle Handle = 0;
+
+		bool HasRawTexels() const { return EmbeddedTexture && EmbeddedTexture->mHeight != 0; }
+	};
+
+	// Indices into the texture sources for each map of a material
+	struct MeshMaterialTextures
+	{
+		uint32_t Albedo = UINT32_MAX;
+		uint32_t Normal = UINT32_MAX;
+		uint32_t Roughness = UINT32_MAX;
+		uint32_t Metalness = UINT32_MAX;
+	};
+
 	static const uint32_t s_MeshImporterFlags =
 		aiProcess_CalcTangentSpace      |  // Create tangent and binormal just in case they are not generated
 		aiProcess_Triangulate           |  // Make sure the format of vertices is triangles
@@ -187,6 +239,57 @@ namespace Iris {
 		{
 			IR_CORE_TRACE_TAG("Mesh", "----- Materials - {0} -----", m_AssetPath);
 
+			// All the textures referenced by the materials are gathered first so that each one is only decoded once and all of them are decoded
+			// in parallel, materials referencing the same image (by path or by content) then share the same Texture2D asset
+			std::vector<MeshTextureSource> textureSources;
+			std::unordered_map<std::string, uint32_t> textureSourceIndices;
+			std::vector<MeshMaterialTextures> materialTextures(scene->mNumMaterials);
+
+			auto addTextureSource = [&](const aiString& aiTexPath, ImageFormat format, bool invert, std::string_view mapName) -> uint32_t
+			{
+				MeshTextureSource source = {
+					.Specification = {
+						.DebugName = aiTexPath.C_Str(),
+						.Format = format,
+						.Streaming = Renderer::GetConfig().TextureStreaming
+					},
+					.Invert = invert
+				};
+
+				std::string key;
+				if (const aiTexture* aiTexEmbedded = scene->GetEmbeddedTexture(aiTexPath.C_Str()))
+				{
+					source.EmbeddedTexture = aiTexEmbedded;
+					key = fmt::format("*{0}", static_cast<const void*>(aiTexEmbedded));
+				}
+				else
+				{
+					auto parentPath = m_AssetPath.parent_path();
+					auto texturePath = parentPath / aiTexPath.C_Str();
+					if (!FileSystem::Exists(texturePath))
+					{
+						IR_CORE_WARN_TAG("Mesh", "\t   {0} map path: {1} --> NOT FOUND!", mapName, texturePath);
+						texturePath = parentPath / texturePath.filename();
+					}
+					IR_CORE_TRACE_TAG("Mesh", "\t   {0} map path: {1}{2}", mapName, texturePath, FileSystem::Exists(texturePath) ? "" : "--> NOT FOUND!");
+
+					std::error_code error;
+					source.Path = std::filesystem::weakly_canonical(texturePath, error);
+					if (error)
+						source.Path = texturePath;
+
+					key = source.Path.string();
+				}
+
+				key += fmt::format("|{0}|{1}", static_cast<int>(format), invert);
+
+				auto [it, inserted] = textureSourceIndices.try_emplace(key, static_cast<uint32_t>(textureSources.size()));
+				if (inserted)
+					textureSources.push_back(std::move(source));
+
+				return it->second;
+			};
+
 			meshSource->m_Materials.resize(scene->mNumMaterials);
 			for (uint32_t i = 0; i < scene->mNumMaterials; i++)
 			{
@@ -234,6 +337,8 @@ namespace Iris {
 				IR_CORE_TRACE_TAG("Mesh", "\t   ROUGHNESS = {0}", roughness);
 				IR_CORE_TRACE_TAG("Mesh", "\t   METALNESS = {0}", metalness);
 
+				MeshMaterialTextures& textures = materialTextures[i];
+
 				// Albedo maps
 				bool hasAlbedoMap = aiMaterial->GetTexture(AI_MATKEY_BASE_COLOR_TEXTURE, &aiTexPath) == AI_SUCCESS;
 				if (!hasAlbedoMap)
@@ -243,73 +348,11 @@ namespace Iris {
 				}
 
 				if (hasAlbedoMap)
-				{
-					AssetHandle textureHandle = 0;
-					TextureSpecification spec = {
-						.DebugName = aiTexPath.C_Str(),
-						.Format = ImageFormat::SRGBA
-					};
-
-					if (auto aiTexEmbedded = scene->GetEmbeddedTexture(aiTexPath.C_Str()))
-					{
-						spec.Width = aiTexEmbedded->mWidth;
-						spec.Height = aiTexEmbedded->mHeight;
-
-						textureHandle = AssetManager::CreateMemoryOnlyRendererAsset<Texture2D>(spec, Buffer(reinterpret_cast<uint8_t*>(aiTexEmbedded->pcData), 1));
-					}
-					else
-					{
-						auto parentPath = m_AssetPath.parent_path();
-						auto texturePath = parentPath / aiTexPath.C_Str();
-						if (!FileSystem::Exists(texturePath))
-						{
-							IR_CORE_WARN_TAG("Mesh", "\t   Albedo map path: {0} --> NOT FOUND!", texturePath);
-							texturePath = parentPath / texturePath.filename();
-						}
-						IR_CORE_TRACE_TAG("Mesh", "\t   Albedo map path: {0}{1}", texturePath, FileSystem::Exists(texturePath) ? "" : "--> NOT FOUND!");
-						
-						textureHandle = AssetManager::CreateMemoryOnlyRendererAsset<Texture2D>(spec, texturePath);
-					}
-
-					ma->SetAlbedoMap(textureHandle);
-					ma->SetAlbedoColor(glm::vec3{ 1.0f });
-				}
+					textures.Albedo = addTextureSource(aiTexPath, ImageFormat::SRGBA, false, "Albedo");
 
 				// Normal maps
-				bool hasNormalMap = aiMaterial->GetTexture(aiTextureType_NORMALS, 0, &aiTexPath) == AI_SUCCESS;
-				if (hasNormalMap)
-				{
-					AssetHandle textureHandle = 0;
-					TextureSpecification spec = {
-						.DebugName = aiTexPath.C_Str(),
-						.Format = ImageFormat::RGBA
-					};
-
-					if (auto aiTexEmbedded = scene->GetEmbeddedTexture(aiTexPath.C_Str()))
-					{
-						spec.Width = aiTexEmbedded->mWidth;
-						spec.Height = aiTexEmbedded->mHeight;
-
-						textureHandle = AssetManager::CreateMemoryOnlyRendererAsset<Texture2D>(spec, Buffer(reinterpret_cast<uint8_t*>(aiTexEmbedded->pcData), 1));
-					}
-					else
-					{
-						auto parentPath = m_AssetPath.parent_path();
-						auto texturePath = parentPath / aiTexPath.C_Str();
-						if (!FileSystem::Exists(texturePath))
-						{
-							IR_CORE_WARN_TAG("Mesh", "\t   Normal map path: {0} --> NOT FOUND!", texturePath);
-							texturePath = parentPath / texturePath.filename();
-						}
-						IR_CORE_TRACE_TAG("Mesh", "\t   Normal map path: {0}{1}", texturePath, FileSystem::Exists(texturePath) ? "" : "--> NOT FOUND!");
-
-						textureHandle = AssetManager::CreateMemoryOnlyRendererAsset<Texture2D>(spec, texturePath);
-					}
-
-					ma->SetNormalMap(textureHandle);
-					// NOTE: Needs to be false if we were not able to load the normal map?
-					ma->SetUseNormalMap(true);
-				}
+				if (aiMaterial->GetTexture(aiTextureType_NORMALS, 0, &aiTexPath) == AI_SUCCESS)
+					textures.Normal = addTextureSource(aiTexPath, ImageFormat::RGBA, false, "Normal");
 
 				// Roughness maps
 				bool hasRoughnessMap = aiMaterial->GetTexture(AI_MATKEY_ROUGHNESS_TEXTURE, &aiTexPath) == AI_SUCCESS;
@@ -322,102 +365,163 @@ namespace Iris {
 				}
 
 				if (hasRoughnessMap)
+					textures.Roughness = addTextureSource(aiTexPath, ImageFormat::RGBA, invertRoughness, "Roughness");
+
+				// Metalness maps
+				if (aiMaterial->GetTexture(AI_MATKEY_METALLIC_TEXTURE, &aiTexPath) == AI_SUCCESS)
+					textures.Metalness = addTextureSource(aiTexPath, ImageFormat::RGBA, false, "Metalness");
+			}
+
+			// Read and hash the encoded images, different paths can still point to the same image (ex. copies of a texture next to each other)
+			WorkerPool::ParallelFor(static_cast<uint32_t>(textureSources.size()), [&textureSources](uint32_t index)
+			{
+				MeshTextureSource& source = textureSources[index];
+				if (const aiTexture* aiTexEmbedded = source.EmbeddedTexture)
 				{
-					AssetHandle textureHandle = 0;
-					TextureSpecification spec = {
-						.DebugName = aiTexPath.C_Str(),
-						.Format = ImageFormat::RGBA
-					};
+					// mHeight == 0 means that the texture is compressed and mWidth is its size in bytes, otherwise pcData holds raw BGRA texels
+					const uint64_t size = aiTexEmbedded->mHeight == 0 ? aiTexEmbedded->mWidth : static_cast<uint64_t>(aiTexEmbedded->mWidth) * aiTexEmbedded->mHeight * sizeof(aiTexel);
+					source.EncodedData = Buffer(reinterpret_cast<uint8_t*>(aiTexEmbedded->pcData), size);
+				}
+				else if (FileSystem::Exists(source.Path))
+				{
+					source.EncodedData = FileSystem::ReadBytes(source.Path);
+				}
+
+				if (source.EncodedData)
+					source.ContentHash = std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(source.EncodedData.Data), source.EncodedData.Size));
+			});
 
-					if (auto aiTexEmbedded = scene->GetEmbeddedTexture(aiTexPath.C_Str()))
+			std::unordered_map<uint64_t, std::vector<uint32_t>> contentIndices;
+			std::vector<uint32_t> uniqueSources;
+			for (uint32_t i = 0; i < static_cast<uint32_t>(textureSources.size()); i++)
+			{
+				MeshTextureSource& source = textureSources[i];
+				if (source.EncodedData)
+				{
+					std::vector<uint32_t>& candidates = contentIndices[source.ContentHash];
+					for (uint32_t candidateIndex : candidates)
 					{
-						spec.Width = aiTexEmbedded->mWidth;
-						spec.Height = aiTexEmbedded->mHeight;
+						const MeshTextureSource& candidate = textureSources[candidateIndex];
+						if (candidate.HasRawTexels() != source.HasRawTexels())
+							continue;
 
-						aiTexel* texels = aiTexEmbedded->pcData;
-						if (invertRoughness)
+						if (candidate.Invert == source.Invert && candidate.Specification.Format == source.Specification.Format && candidate.EncodedData.Size == source.EncodedData.Size
+							&& std::memcmp(candidate.EncodedData.Data, source.EncodedData.Data, source.EncodedData.Size) == 0)
 						{
-							if (spec.Height == 0)
-							{
-								auto buffer = Utils::TextureImporter::LoadImageFromMemory(Buffer(reinterpret_cast<uint8_t*>(aiTexEmbedded->pcData), spec.Width), spec.Format, spec.Width, spec.Height);
-								texels = reinterpret_cast<aiTexel*>(buffer.Data);
-							}
-
-							for (uint32_t o = 0; i < spec.Width * spec.Height; o++)
-							{
-								aiTexel& texel = texels[o];
-								texel.r = 255 - texel.r;
-								texel.g = 255 - texel.g;
-								texel.b = 255 - texel.b;
-							}
+							source.SharedIndex = candidateIndex;
+							break;
 						}
-
-						textureHandle = AssetManager::CreateMemoryOnlyRendererAsset<Texture2D>(spec, Buffer(reinterpret_cast<uint8_t*>(texels), 1));
 					}
-					else
-					{
-						auto parentPath = m_AssetPath.parent_path();
-						auto texturePath = parentPath / aiTexPath.C_Str();
-						if (!FileSystem::Exists(texturePath))
-						{
-							IR_CORE_WARN_TAG("Mesh", "\t   Roughness map path: {0} --> NOT FOUND!", texturePath);
-							texturePath = parentPath / texturePath.filename();
-						}
-						IR_CORE_TRACE_TAG("Mesh", "\t   Roughness map path: {0}{1}", texturePath, FileSystem::Exists(texturePath) ? "" : "--> NOT FOUND!");
 
-						Buffer buffer = Utils::TextureImporter::LoadImageFromFile(texturePath.string(), spec.Format, spec.Width, spec.Height);
+					if (source.SharedIndex != UINT32_MAX)
+						continue;
 
-						aiTexel* texels = reinterpret_cast<aiTexel*>(buffer.Data);
-						if (invertRoughness)
-						{
-							for (uint32_t o = 0; i < spec.Width * spec.Height; o++)
-							{
-								aiTexel& texel = texels[o];
-								texel.r = 255 - texel.r;
-								texel.g = 255 - texel.g;
-								texel.b = 255 - texel.b;
-							}
-						}
+					candidates.push_back(i);
+				}
 
-						textureHandle = AssetManager::CreateMemoryOnlyRendererAsset<Texture2D>(spec, buffer);
-					}
+				uniqueSources.push_back(i);
+			}
 
-					ma->SetRoughnessMap(textureHandle);
-					ma->SetRoughness(1.0f);
-				}
+			// Decoding (and the CPU side mip chain of streaming textures) happens in the Texture2D constructors, the uploads are batched by the UploadManager
+			WorkerPool::ParallelFor(static_cast<uint32_t>(uniqueSources.size()), [&textureSources, &uniqueSources](uint32_t index)
+			{
+				MeshTextureSource& source = textureSources[uniqueSources[index]];
+				TextureSpecification& spec = source.Specification;
 
-				// Metalness maps
-				bool hasMetalnessMap = aiMaterial->GetTexture(AI_MATKEY_METALLIC_TEXTURE, &aiTexPath) == AI_SUCCESS;
-				if (hasMetalnessMap)
+				if (!source.EncodedData)
 				{
-					AssetHandle textureHandle = 0;
-					TextureSpecification spec = {
-						.DebugName = aiTexPath.C_Str(),
-						.Format = ImageFormat::RGBA
-					};
+					// Falls back to the missing texture image
+					source.Texture = Texture2D::Create(spec, source.Path);
+				}
+				else if (source.EmbeddedTexture && source.EmbeddedTexture->mHeight != 0)
+				{
+					spec.Width = source.EmbeddedTexture->mWidth;
+					spec.Height = source.EmbeddedTexture->mHeight;
 
-					if (auto aiTexEmbedded = scene->GetEmbeddedTexture(aiTexPath.C_Str()))
+					Buffer texels;
+					texels.Allocate(source.EncodedData.Size);
+					const aiTexel* srcTexels = source.EmbeddedTexture->pcData;
+					for (uint64_t t = 0; t < static_cast<uint64_t>(spec.Width) * spec.Height; t++)
 					{
-						spec.Width = aiTexEmbedded->mWidth;
-						spec.Height = aiTexEmbedded->mHeight;
+						const aiTexel& texel = srcTexels[t];
+						uint8_t* dst = texels.Data + t * 4;
+						dst[0] = source.Invert ? 255 - texel.r : texel.r;
+						dst[1] = source.Invert ? 255 - texel.g : texel.g;
+						dst[2] = source.Invert ? 255 - texel.b : texel.b;
+						dst[3] = texel.a;
+					}
 
-						textureHandle = AssetManager::CreateMemoryOnlyRendererAsset<Texture2D>(spec, Buffer(reinterpret_cast<uint8_t*>(aiTexEmbedded->pcData), 1));
+					source.Texture = Texture2D::Create(spec, texels);
+					texels.Release();
+				}
+				else if (source.Invert)
+				{
+					Buffer imageData = Utils::TextureImporter::LoadImageFromMemory(source.EncodedData, spec.Format, spec.Width, spec.Height);
+					if (imageData)
+					{
+						Utils::InvertImage(imageData, spec.Format);
+						source.Texture = Texture2D::Create(spec, imageData);
+						Utils::TextureImporter::FreeImageMemory(imageData.Data);
 					}
 					else
 					{
-						auto parentPath = m_AssetPath.parent_path();
-						auto texturePath = parentPath / aiTexPath.C_Str();
-						if (!FileSystem::Exists(texturePath))
-						{
-							IR_CORE_WARN_TAG("Mesh", "\t   Metalness map path: {0} --> NOT FOUND!", texturePath);
-							texturePath = parentPath / texturePath.filename();
-						}
-						IR_CORE_TRACE_TAG("Mesh", "\t   Metalness map path: {0}{1}", texturePath, FileSystem::Exists(texturePath) ? "" : "--> NOT FOUND!");
-
-						textureHandle = AssetManager::CreateMemoryOnlyRendererAsset<Texture2D>(spec, texturePath);
+						spec.Height = 0;
+						source.Texture = Texture2D::Create(spec, source.EncodedData);
 					}
+				}
+				else
+				{
+					// Height of 0 makes the texture decode the image data itself
+					spec.Width = 0;
+					spec.Height = 0;
+					source.Texture = Texture2D::Create(spec, source.EncodedData);
+				}
+			});
+
+			for (MeshTextureSource& source : textureSources)
+			{
+				if (source.Texture)
+					source.Handle = AssetManager::AddMemoryOnlyAsset(source.Texture);
 
-					ma->SetMetalnessMap(textureHandle);
+				if (!source.EmbeddedTexture)
+					source.EncodedData.Release();
+			}
+
+			for (MeshTextureSource& source : textureSources)
+			{
+				if (source.SharedIndex != UINT32_MAX)
+					source.Handle = textureSources[source.SharedIndex].Handle;
+			}
+
+			IR_CORE_TRACE_TAG("Mesh", "\t   {0} textures referenced by materials, {1} unique", textureSources.size(), uniqueSources.size());
+
+			for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+			{
+				Ref<MaterialAsset> ma = AssetManager::GetAsset<MaterialAsset>(meshSource->m_Materials[i]);
+				const MeshMaterialTextures& textures = materialTextures[i];
+
+				if (textures.Albedo != UINT32_MAX)
+				{
+					ma->SetAlbedoMap(textureSources[textures.Albedo].Handle);
+					ma->SetAlbedoColor(glm::vec3{ 1.0f });
+				}
+
+				if (textures.Normal != UINT32_MAX)
+				{
+					ma->SetNormalMap(textureSources[textures.Normal].Handle);
+					// NOTE: Needs to be false if we were not able to load the normal map?
+					ma->SetUseNormalMap(true);
+				}
+
+				if (textures.Roughness != UINT32_MAX)
+				{
+					ma->SetRoughnessMap(textureSources[textures.Roughness].Handle);
+					ma->SetRoughness(1.0f);
+				}
+
+				if (textures.Metalness != UINT32_MAX)
+				{
+					ma->SetMetalnessMap(textureSources[textures.Metalness].Handle);
 					ma->SetMetalness(1.0f);
 				}
 
@@ -437,11 +541,7 @@ namespace Iris {
 			}
 		}
 
-		if (meshSource->m_Vertices.size())
-			meshSource->m_VertexBuffer = VertexBuffer::Create(meshSource->m_Vertices.data(), static_cast<uint32_t>(meshSource->m_Vertices.size() * sizeof(MeshUtils::Vertex)));
-
-		if (meshSource->m_Indices.size())
-			meshSource->m_IndexBuffer = IndexBuffer::Create(meshSource->m_Indices.data(), static_cast<uint32_t>(meshSource->m_Indices.size() * sizeof(MeshUtils::Index)));
+		meshSource->AllocateGeometry();
 
 		return meshSource;
 	}
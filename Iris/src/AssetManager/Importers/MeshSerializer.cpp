@@ -111,6 +111,22 @@ namespace Iris {
 		return true;
 	}
 
+	void StaticMeshSerializer::GetDependencies(const AssetMetaData& metaData, std::vector<AssetHandle>& outDependencies) const
+	{
+		std::ifstream stream(Project::GetAssetDirectory() / metaData.FilePath);
+		if (!stream)
+			return;
+
+		std::stringstream strStream;
+		strStream << stream.rdbuf();
+
+		YAML::Node data = YAML::Load(strStream.str());
+		if (!data["StaticMesh"] || !data["StaticMesh"]["MeshSource"])
+			return;
+
+		outDependencies.push_back(data["StaticMesh"]["MeshSource"].as<uint64_t>(0));
+	}
+
 	std::string StaticMeshSerializer::SerializeToYAML(Ref<StaticMesh> staticMesh) const
 	{
 		YAML::Emitter out;
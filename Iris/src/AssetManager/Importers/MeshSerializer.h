@@ -15,6 +15,7 @@ namespace Iris {
 	{
 		virtual void Serialize(const AssetMetaData& metadata, const Ref<Asset>& asset) const override;
 		virtual bool TryLoadData(const AssetMetaData& metadata, Ref<Asset>& asset) const override;
+		virtual void GetDependencies(const AssetMetaData& metadata, std::vector<AssetHandle>& outDependencies) const override;
 
 	private:
 		std::string SerializeToYAML(Ref<StaticMesh> staticMesh) const;
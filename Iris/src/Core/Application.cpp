@@ -1,6 +1,7 @@
 #include "IrisPCH.h"
 #include "Application.h"
 
+#include "Core/WorkerPool.h"
 #include "Input/Input.h"
 #include "Project/Project.h"
 #include "Renderer/Renderer.h"
@@ -41,6 +42,8 @@ namespace Iris {
 
 		IR_VERIFY(NFD::Init() == NFD_OKAY);
 
+		WorkerPool::Init();
+
 		Renderer::SetConfig(spec.RendererConfig);
 		Renderer::Init();
 
@@ -87,6 +90,8 @@ namespace Iris {
 
 		Renderer::Shutdown();
 
+		WorkerPool::Shutdown();
+
 		// NOTE: We can't set the s_Instance to nullptr here since the application will still be used in other parts of the application to
 		// retrieve certain data to destroy other data...
 		// s_Instance = nullptr;
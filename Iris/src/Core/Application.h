@@ -83,6 +83,7 @@ namespace Iris {
 		const ApplicationSpecification& GetSpecification() const { return m_Specification; }
 
 		static const char* GetConfigurationName();
+		static bool IsMainThread() { return std::this_thread::get_id() == s_MainThreadID; }
 
 	private:
 		void ProcessEvents();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Events.h"
+#include "Utils/FileWatcher.h"
 
 namespace Iris::Events {
 
@@ -136,4 +137,27 @@ namespace Iris::Events {
 
 	};
 
+	// Dispatched by the asset manager after it processed changes in the asset directory
+	class FileSystemChangedEvent : public Event
+	{
+	public:
+		FileSystemChangedEvent(const std::vector<FileSystemChange>& changes)
+			: m_Changes(changes) {}
+
+		inline const std::vector<FileSystemChange>& GetChanges() const { return m_Changes; }
+
+		std::string toString() const override
+		{
+			std::stringstream ss;
+			ss << "File System Changed Event! Changes: " << m_Changes.size();
+			return ss.str();
+		}
+
+		IR_EVENT_CLASS_TYPE(FileSystemChanged)
+
+	private:
+		std::vector<FileSystemChange> m_Changes;
+
+	};
+
 }
\ No newline at end of file
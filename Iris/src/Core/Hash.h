@@ -26,6 +26,22 @@ namespace Iris {
 
 			return hash;
 		}
+
+		// 64 bit FNV-1a, for when there are too many inputs (ex. file contents) for 32 bits to stay collision free
+		static constexpr uint64_t GenerateFNVHash64(std::string_view str)
+		{
+			constexpr uint64_t FNV_PRIME = 1099511628211ull;
+			constexpr uint64_t OFFSET_BASIS = 14695981039346656037ull;
+
+			uint64_t hash = OFFSET_BASIS;
+			for (const char c : str)
+			{
+				hash ^= static_cast<uint8_t>(c);
+				hash *= FNV_PRIME;
+			}
+
+			return hash;
+		}
 	};
 
 }
\ No newline at end of file
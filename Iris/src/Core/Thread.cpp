@@ -7,8 +7,8 @@ namespace Iris {
 	 * Currently this only woks on windows since we use the win32 api to set the thread name
 	 */
 
-	Thread::Thread(const std::string& name)
-		: m_Name(name)
+	Thread::Thread(const std::string& name, uint64_t affinityMask)
+		: m_Name(name), m_AffinityMask(affinityMask)
 	{
 	}
 
@@ -24,12 +24,13 @@ namespace Iris {
 
 		std::wstring threadName(name.begin(), name.end());
 		SetThreadDescription(threadHandle, threadName.c_str());
-		SetThreadAffinityMask(threadHandle, 8);
+		if (m_AffinityMask)
+			SetThreadAffinityMask(threadHandle, m_AffinityMask);
 	}
 
 	std::thread::id Thread::GetID() const
 	{
-		return std::thread::id();
+		return m_Thread.get_id();
 	}
 
 }
\ No newline at end of file
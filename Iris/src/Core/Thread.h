@@ -15,7 +15,8 @@ namespace Iris {
 	class Thread
 	{
 	public:
-		Thread(const std::string& name);
+		// NOTE: The affinity mask pins the thread to a set of cores, passing 0 leaves the thread free to be scheduled anywhere by the OS
+		Thread(const std::string& name, uint64_t affinityMask = 8);
 
 		template<typename Fn, typename... Args>
 		void Dispatch(Fn&& fn, Args&&... args)
@@ -34,6 +35,7 @@ namespace Iris {
 	private:
 		std::thread m_Thread;
 		std::string m_Name;
+		uint64_t m_AffinityMask = 8;
 
 	};
 
@@ -0,0 +1,176 @@
+#include "IrisPCH.h"
+#include "WorkerPool.h"
+
+#include <deque>
+
+namespace Iris {
+
+	struct WorkerPoolData
+	{
+		std::vector<Thread> Workers;
+		bool Running = false;
+
+		std::mutex Mutex;
+		std::condition_variable WorkAvailableCondition;
+		std::deque<Ref<WorkerTask>> Queue;
+	};
+
+	static WorkerPoolData* s_Data = nullptr;
+	static thread_local bool s_IsWorkerThread = false;
+
+	bool WorkerTask::IsReady() const
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		return m_State == State::Done;
+	}
+
+	void WorkerTask::Wait()
+	{
+		// The task stays in the pool queue, the worker that pops it later just skips it
+		if (TryRun())
+			return;
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_DoneCondition.wait(lock, [this]() { return m_State == State::Done; });
+	}
+
+	bool WorkerTask::Cancel()
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		if (m_State != State::Queued)
+			return false;
+
+		m_Job = nullptr;
+		m_State = State::Done;
+		m_DoneCondition.notify_all();
+		return true;
+	}
+
+	bool WorkerTask::TryRun()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			if (m_State != State::Queued)
+				return false;
+
+			m_State = State::Running;
+		}
+
+		m_Job();
+		m_Job = nullptr;
+
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		m_State = State::Done;
+		m_DoneCondition.notify_all();
+		return true;
+	}
+
+	void WorkerPool::WorkerThreadFunc()
+	{
+		s_IsWorkerThread = true;
+
+		while (true)
+		{
+			Ref<WorkerTask> task;
+			{
+				std::unique_lock<std::mutex> lock(s_Data->Mutex);
+				s_Data->WorkAvailableCondition.wait(lock, []() { return !s_Data->Running || !s_Data->Queue.empty(); });
+
+				if (!s_Data->Running)
+					break;
+
+				task = s_Data->Queue.front();
+				s_Data->Queue.pop_front();
+			}
+
+			task->TryRun();
+		}
+	}
+
+	void WorkerPool::Init()
+	{
+		s_Data = new WorkerPoolData();
+
+		// The main and render threads already keep two hardware threads busy
+		const uint32_t workerCount = glm::max(std::thread::hardware_concurrency(), 3u) - 2;
+
+		s_Data->Running = true;
+		s_Data->Workers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			Thread& worker = s_Data->Workers.emplace_back(fmt::format("Worker {}", i), 0);
+			worker.Dispatch(&WorkerPool::WorkerThreadFunc);
+		}
+	}
+
+	void WorkerPool::Shutdown()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+			s_Data->Running = false;
+			s_Data->WorkAvailableCondition.notify_all();
+		}
+
+		for (Thread& worker : s_Data->Workers)
+			worker.Join();
+
+		// Nothing should be left at this point, but anyone still holding one of these tasks must not wait forever on it
+		for (Ref<WorkerTask>& task : s_Data->Queue)
+			task->TryRun();
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	Ref<WorkerTask> WorkerPool::Submit(std::function<void()> job)
+	{
+		Ref<WorkerTask> task = CreateRef<WorkerTask>(std::move(job));
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		s_Data->Queue.push_back(task);
+		s_Data->WorkAvailableCondition.notify_one();
+
+		return task;
+	}
+
+	void WorkerPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func)
+	{
+		const uint32_t threadCount = glm::min(count, GetWorkerCount() + 1);
+		if (threadCount <= 1)
+		{
+			for (uint32_t i = 0; i < count; i++)
+				func(i);
+
+			return;
+		}
+
+		// The tasks are all waited on before returning so they can reference the locals here
+		std::atomic<uint32_t> nextIndex = 0;
+		auto worker = [&]()
+		{
+			for (uint32_t index = nextIndex++; index < count; index = nextIndex++)
+				func(index);
+		};
+
+		std::vector<Ref<WorkerTask>> tasks;
+		tasks.reserve(threadCount - 1);
+		for (uint32_t i = 1; i < threadCount; i++)
+			tasks.push_back(Submit(worker));
+
+		worker();
+
+		for (Ref<WorkerTask>& task : tasks)
+			task->Wait();
+	}
+
+	uint32_t WorkerPool::GetWorkerCount()
+	{
+		return static_cast<uint32_t>(s_Data->Workers.size());
+	}
+
+	bool WorkerPool::IsWorkerThread()
+	{
+		return s_IsWorkerThread;
+	}
+
+}
\ No newline at end of file
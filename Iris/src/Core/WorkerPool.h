@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Core/Base.h"
+#include "Core/Thread.h"
+
+#include <condition_variable>
+
+/*
+ * Engine wide pool of worker threads, everything that fans work out to other threads goes through here instead of creating its own threads
+ * - Jobs are picked up in the order they were submitted, Submit returns a task that can be waited on
+ * - Waiting on a task that no worker picked up yet runs it on the waiting thread, so waiting from inside a job (ex. nested ParallelFor) can not deadlock
+ * - ParallelFor splits an index range over the workers and the calling thread, the caller always takes part so it makes progress even if
+ *   every worker is busy with long jobs (asset loads)
+ * - Created by the Application before the renderer and destroyed after everything that submits to it is shut down
+ */
+
+namespace Iris {
+
+	class WorkerTask : public RefCountedObject
+	{
+	public:
+		explicit WorkerTask(std::function<void()> job)
+			: m_Job(std::move(job)) {}
+
+		bool IsReady() const;
+		// Runs the job right here if no worker started it yet
+		void Wait();
+		// Drops the job if no thread started it yet, returns false if it is already running or done
+		bool Cancel();
+
+	private:
+		// Returns false if the job was already claimed by another thread
+		bool TryRun();
+
+	private:
+		enum class State : uint8_t
+		{
+			Queued = 0,
+			Running,
+			Done
+		};
+
+		std::function<void()> m_Job;
+		State m_State = State::Queued;
+
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_DoneCondition;
+
+		friend class WorkerPool;
+	};
+
+	class WorkerPool
+	{
+	public:
+		static void Init();
+		static void Shutdown();
+
+		static Ref<WorkerTask> Submit(std::function<void()> job);
+
+		// Runs func for every index in [0, count) on the workers and the calling thread, returns once all of them are done
+		static void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+		static uint32_t GetWorkerCount();
+		static bool IsWorkerThread();
+
+	private:
+		static void WorkerThreadFunc();
+	};
+
+}
\ No newline at end of file
@@ -1,11 +1,14 @@
 #include "IrisPCH.h"
 #include "AssetManagerPanel.h"
 
+#include "AssetManager/AssetRegistryBenchmark.h"
 #include "ImGui/ImGuiUtils.h"
 #include "Renderer/StorageBufferSet.h"
 #include "Renderer/Texture.h"
 #include "Renderer/UniformBufferSet.h"
 
+#include <optional>
+
 namespace Iris {
 
 	void AssetManagerPanel::OnImGuiRender(bool& open)
@@ -16,6 +19,29 @@ namespace Iris {
 			UI::ImGuiScopedStyle headerPaddingAndHeight(ImGuiStyleVar_FramePadding, ImVec2{ 6.0f, 6.0f });
 
 			ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_DefaultOpen;
+			if (ImGui::TreeNodeEx("Registry Benchmark", treeNodeFlags & ~ImGuiTreeNodeFlags_DefaultOpen))
+			{
+				static std::optional<AssetRegistryBenchmarkResults> s_BenchmarkResults;
+				if (ImGui::Button("Run"))
+					s_BenchmarkResults = AssetRegistryBenchmark::Run();
+
+				if (s_BenchmarkResults)
+				{
+					const AssetRegistryBenchmarkResults& results = *s_BenchmarkResults;
+
+					UI::BeginPropertyGrid();
+					UI::PropertyStringReadOnly("Entries", fmt::format("{}", results.EntryCount).c_str());
+					UI::PropertyStringReadOnly("Single Writes", fmt::format("{:.2f}ms", results.SingleWrites).c_str());
+					UI::PropertyStringReadOnly("Batched Writes", fmt::format("{:.2f}ms", results.BatchedWrites).c_str());
+					UI::PropertyStringReadOnly("Reads", fmt::format("{} threads x {}", results.ReaderThreads, results.ReadsPerThread).c_str());
+					UI::PropertyStringReadOnly("Registry Reads", fmt::format("{:.2f}ms ({:.2f}ms while writing)", results.RegistryReads, results.RegistryReadsWhileWriting).c_str());
+					UI::PropertyStringReadOnly("Mutex Map Reads", fmt::format("{:.2f}ms ({:.2f}ms while writing)", results.MutexMapReads, results.MutexMapReadsWhileWriting).c_str());
+					UI::EndPropertyGrid();
+				}
+
+				ImGui::TreePop();
+			}
+
 			if (ImGui::TreeNodeEx("Registry", treeNodeFlags))
 			{
 				constexpr float edgeOffset = 4.0f;
@@ -49,10 +75,10 @@ namespace Iris {
 					UI::BeginPropertyGrid();
 					ImGui::SetColumnWidth(0, ImGui::CalcTextSize("File Path").x * 2.0f);
 
-					const AssetRegistry& assetRegistry = Project::GetEditorAssetManager()->GetAssetRegistry();
+					AssetRegistry& assetRegistry = Project::GetEditorAssetManager()->GetAssetRegistry();
 
 					int id = 0;
-					for (const auto& [h, metaData] : assetRegistry)
+					for (const auto& [h, metaData] : assetRegistry.GetSnapshot())
 					{
 						if (assetTypeFilter != AssetType::None && assetTypeFilter != metaData.Type)
 							continue;
@@ -69,9 +95,10 @@ namespace Iris {
 
 						if (s_AllowEditing)
 						{
-							AssetHandle& displayHandle = const_cast<AssetHandle&>(metaData.Handle);
-							uint64_t& displayHandleUInt = reinterpret_cast<uint64_t&>(displayHandle);
-							UI::PropertyInputU64(" - Handle", displayHandleUInt);
+							// The snapshot is immutable so the edit goes back through the registry
+							uint64_t displayHandle = metaData.Handle;
+							if (UI::PropertyInputU64(" - Handle", displayHandle))
+								assetRegistry.Update(h, [displayHandle](AssetMetaData& entry) { entry.Handle = displayHandle; });
 						}
 						else
 							UI::PropertyStringReadOnly(" - Handle", fmt::format("{}", metaData.Handle).c_str());
@@ -16,6 +16,17 @@ namespace Iris {
 	 * This means that any modifications to the Roughness/Metalness values should be done in the authored texture
 	 */
 
+	// Waits for the dropped texture to be loaded before setting it on the material and serializing the material
+	static AssetTask SetMaterialMapWhenLoaded(Ref<MaterialAsset> materialAsset, AssetHandle textureHandle, std::function<void(MaterialAsset&)> setMap)
+	{
+		Ref<Texture2D> texture = co_await AssetManager::LoadAsync<Texture2D>(textureHandle);
+		if (!texture)
+			co_return;
+
+		setMap(*materialAsset);
+		AssetImporter::Serialize(materialAsset);
+	}
+
 	MaterialEditor::MaterialEditor()
 		: AssetEditor("Material Editor")
 	{
@@ -112,19 +123,10 @@ namespace Iris {
 				AssetHandle assetHandle = checkAndSetTexture();
 				if (assetHandle)
 				{
-					Project::GetEditorAssetManager()->AddPostSyncTask([materialAsset = m_MaterialAsset, assetHandle]() mutable -> bool
+					SetMaterialMapWhenLoaded(m_MaterialAsset, assetHandle, [assetHandle](MaterialAsset& material)
 					{
-						AsyncAssetResult<Texture2D> result = AssetManager::GetAssetAsync<Texture2D>(assetHandle);
-						if (result.IsReady)
-						{
-							materialAsset->SetAlbedoMap(result.Asset->Handle, true);
-							AssetImporter::Serialize(materialAsset);
-
-							return true;
-						}
-
-						return false;
-					}, true);
+						material.SetAlbedoMap(assetHandle, true);
+					});
 				}
 
 				ImGui::EndDragDropTarget();
@@ -212,20 +214,11 @@ namespace Iris {
 					AssetHandle assetHandle = checkAndSetTexture();
 					if (assetHandle)
 					{
-						Project::GetEditorAssetManager()->AddPostSyncTask([materialAsset = m_MaterialAsset, assetHandle]() mutable -> bool
+						SetMaterialMapWhenLoaded(m_MaterialAsset, assetHandle, [assetHandle](MaterialAsset& material)
 						{
-							AsyncAssetResult<Texture2D> result = AssetManager::GetAssetAsync<Texture2D>(assetHandle);
-							if (result.IsReady)
-							{
-								materialAsset->SetNormalMap(result.Asset->Handle, true);
-								materialAsset->SetUseNormalMap(true);
-								AssetImporter::Serialize(materialAsset);
-
-								return true;
-							}
-
-							return false;
-						}, true);
+							material.SetNormalMap(assetHandle, true);
+							material.SetUseNormalMap(true);
+						});
 					}
 
 					ImGui::EndDragDropTarget();
@@ -298,20 +291,11 @@ namespace Iris {
 					AssetHandle assetHandle = checkAndSetTexture();
 					if (assetHandle)
 					{
-						Project::GetEditorAssetManager()->AddPostSyncTask([materialAsset = m_MaterialAsset, assetHandle]() mutable -> bool
+						SetMaterialMapWhenLoaded(m_MaterialAsset, assetHandle, [assetHandle](MaterialAsset& material)
 						{
-							AsyncAssetResult<Texture2D> result = AssetManager::GetAssetAsync<Texture2D>(assetHandle);
-							if (result.IsReady)
-							{
-								materialAsset->SetRoughnessMap(result.Asset->Handle, true);
-								materialAsset->SetRoughness(1.0f);
-								AssetImporter::Serialize(materialAsset);
-
-								return true;
-							}
-
-							return false;
-						}, true);
+							material.SetRoughnessMap(assetHandle, true);
+							material.SetRoughness(1.0f);
+						});
 					}
 
 					ImGui::EndDragDropTarget();
@@ -384,20 +368,11 @@ namespace Iris {
 					AssetHandle assetHandle = checkAndSetTexture();
 					if (assetHandle)
 					{
-						Project::GetEditorAssetManager()->AddPostSyncTask([materialAsset = m_MaterialAsset, assetHandle]() mutable -> bool
+						SetMaterialMapWhenLoaded(m_MaterialAsset, assetHandle, [assetHandle](MaterialAsset& material)
 						{
-							AsyncAssetResult<Texture2D> result = AssetManager::GetAssetAsync<Texture2D>(assetHandle);
-							if (result.IsReady)
-							{
-								materialAsset->SetMetalnessMap(result.Asset->Handle, true);
-								materialAsset->SetMetalness(1.0f);
-								AssetImporter::Serialize(materialAsset);
-
-								return true;
-							}
-
-							return false;
-						}, true);
+							material.SetMetalnessMap(assetHandle, true);
+							material.SetMetalness(1.0f);
+						});
 					}
 
 					ImGui::EndDragDropTarget();
@@ -190,6 +190,22 @@ namespace Iris {
 				}
 			}
 
+			// Static meshes dropped from the content browser get instantiated with their whole entity hierarchy once they and their materials are loaded
+			const ImGuiPayload* assetPayload = ImGui::AcceptDragDropPayload("asset_payload");
+			if (assetPayload)
+			{
+				AssetHandle assetHandle = *(AssetHandle*)assetPayload->Data;
+				if (AssetManager::GetAssetType(assetHandle) == AssetType::StaticMesh)
+				{
+					m_Context->InstantiateStaticMeshAsync(assetHandle, [this, scene = m_Context](Entity rootEntity)
+					{
+						// The scene could have been switched while the mesh was loading
+						if (m_Context == scene)
+							SelectionManager::Select(s_ActiveSelectionContext, rootEntity.GetUUID());
+					});
+				}
+			}
+
 			ImGui::EndDragDropTarget();
 		}
 
@@ -1884,6 +1900,9 @@ namespace Iris {
 			if (!isInconsistentDynamicSky || !isMultiSelect)
 			{
 				bool changed = false;
+				// While one of the values is being dragged the sky is generated at a lower resolution and then once more at full resolution when it is let go
+				bool editing = false;
+				bool finishedEditing = false;
 
 				ImGui::PushItemFlag(ImGuiItemFlags_MixedValue, isMultiSelect && IsInconsistentPrimitive<float, SkyLightComponent>([](const SkyLightComponent& other) { return other.TurbidityAzimuthInclinationSunSize.w; }));
 				if (UI::Property("Sun Size", skylightComp.TurbidityAzimuthInclinationSunSize.w, 0.005f, 0.01f, 1.0f, "Defines how big the sun is"))
@@ -1896,6 +1915,8 @@ namespace Iris {
 
 					changed = true;
 				}
+				editing |= ImGui::IsItemActive();
+				finishedEditing |= ImGui::IsItemDeactivatedAfterEdit();
 				ImGui::PopItemFlag();
 
 				ImGui::PushItemFlag(ImGuiItemFlags_MixedValue, isMultiSelect && IsInconsistentPrimitive<float, SkyLightComponent>([](const SkyLightComponent& other) { return other.TurbidityAzimuthInclinationSunSize.x; }));
@@ -1909,6 +1930,8 @@ namespace Iris {
 
 					changed = true;
 				}
+				editing |= ImGui::IsItemActive();
+				finishedEditing |= ImGui::IsItemDeactivatedAfterEdit();
 				ImGui::PopItemFlag();
 
 				ImGui::PushItemFlag(ImGuiItemFlags_MixedValue, isMultiSelect && IsInconsistentPrimitive<float, SkyLightComponent>([](const SkyLightComponent& other) { return other.TurbidityAzimuthInclinationSunSize.y; }));
@@ -1924,6 +1947,8 @@ namespace Iris {
 
 					changed = true;
 				}
+				editing |= ImGui::IsItemActive();
+				finishedEditing |= ImGui::IsItemDeactivatedAfterEdit();
 				ImGui::PopItemFlag();
 
 				ImGui::PushItemFlag(ImGuiItemFlags_MixedValue, isMultiSelect && IsInconsistentPrimitive<float, SkyLightComponent>([](const SkyLightComponent& other) { return other.TurbidityAzimuthInclinationSunSize.z; }));
@@ -1939,6 +1964,8 @@ namespace Iris {
 
 					changed = true;
 				}
+				editing |= ImGui::IsItemActive();
+				finishedEditing |= ImGui::IsItemDeactivatedAfterEdit();
 				ImGui::PopItemFlag();
 
 				ImGui::PushItemFlag(ImGuiItemFlags_MixedValue, isMultiSelect && IsInconsistentPrimitive<UUID, SkyLightComponent>([](const SkyLightComponent& other) { return other.DirectionalLightEntityID; }));
@@ -1966,11 +1993,11 @@ namespace Iris {
 					ImGui::PopItemFlag();
 				}
 
-				if (changed)
+				if (changed || finishedEditing)
 				{
 					if (AssetManager::IsMemoryAsset(skylightComp.SceneEnvironment))
 					{
-						Ref<TextureCube> preethamEnv = Renderer::CreatePreethamSky(skylightComp.TurbidityAzimuthInclinationSunSize.x, skylightComp.TurbidityAzimuthInclinationSunSize.y, skylightComp.TurbidityAzimuthInclinationSunSize.z, skylightComp.TurbidityAzimuthInclinationSunSize.w);
+						Ref<TextureCube> preethamEnv = Renderer::CreatePreethamSky(skylightComp.TurbidityAzimuthInclinationSunSize.x, skylightComp.TurbidityAzimuthInclinationSunSize.y, skylightComp.TurbidityAzimuthInclinationSunSize.z, skylightComp.TurbidityAzimuthInclinationSunSize.w, editing);
 						Ref<Environment> env = AssetManager::GetAsset<Environment>(skylightComp.SceneEnvironment);
 						if (env)
 						{
@@ -1980,7 +2007,7 @@ namespace Iris {
 					}
 					else
 					{
-						Ref<TextureCube> preethamEnv = Renderer::CreatePreethamSky(skylightComp.TurbidityAzimuthInclinationSunSize.x, skylightComp.TurbidityAzimuthInclinationSunSize.y, skylightComp.TurbidityAzimuthInclinationSunSize.z, skylightComp.TurbidityAzimuthInclinationSunSize.w);
+						Ref<TextureCube> preethamEnv = Renderer::CreatePreethamSky(skylightComp.TurbidityAzimuthInclinationSunSize.x, skylightComp.TurbidityAzimuthInclinationSunSize.y, skylightComp.TurbidityAzimuthInclinationSunSize.z, skylightComp.TurbidityAzimuthInclinationSunSize.w, editing);
 						skylightComp.SceneEnvironment = AssetManager::CreateMemoryOnlyAsset<Environment>(preethamEnv, preethamEnv);
 					}
 				}
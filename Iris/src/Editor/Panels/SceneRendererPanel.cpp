@@ -6,7 +6,9 @@
 #include "Renderer/StorageBufferSet.h"
 #include "Renderer/Text/Font.h"
 #include "Renderer/Texture.h"
+#include "Renderer/TextureStreamer.h"
 #include "Renderer/UniformBufferSet.h"
+#include "Utils/StringUtils.h"
 
 namespace Iris {
 
@@ -14,6 +16,14 @@ namespace Iris {
 	{
 		if (ImGui::Begin("Scene Renderer", &isOpen, ImGuiWindowFlags_NoCollapse))
 		{
+			UI::BeginPropertyGrid(2, 210.0f);
+
+			bool gpuDrivenRendering = m_Context->GetSpecification().GPUDrivenRendering;
+			if (UI::Property("GPU Driven Rendering", gpuDrivenRendering, "Culls the static meshes on the GPU and draws them with indirect count draws. Selected meshes are still drawn by the CPU"))
+				m_Context->SetGPUDrivenRendering(gpuDrivenRendering);
+
+			UI::EndPropertyGrid();
+
 			const SceneRenderer::Statistics& statistics = m_Context->GetStatistics();
 
 			ImGui::PushStyleColor(ImGuiCol_Text, Colors::Theme::TextWarning);
@@ -27,6 +37,20 @@ namespace Iris {
 			UI::PropertyStringReadOnly("Total Draw Calls", fmt::format("{}", statistics.TotalDrawCalls).c_str());
 			UI::PropertyStringReadOnly("Color Pass Draw Calls", fmt::format("{}", statistics.ColorPassDrawCalls).c_str());
 			UI::PropertyStringReadOnly("Color Pass Saved Draw Calls", fmt::format("{}", statistics.ColorPassSavedDraws).c_str());
+			UI::PropertyStringReadOnly("Skipped Pipeline Binds", fmt::format("{}", statistics.SkippedBinds.Pipelines).c_str());
+			UI::PropertyStringReadOnly("Skipped Descriptor Set Binds", fmt::format("{}", statistics.SkippedBinds.DescriptorSets).c_str());
+			UI::PropertyStringReadOnly("Skipped Vertex/Index Buffer Binds", fmt::format("{} / {}", statistics.SkippedBinds.VertexBuffers, statistics.SkippedBinds.IndexBuffers).c_str());
+			UI::PropertyStringReadOnly("Skipped Push Constants", fmt::format("{}", statistics.SkippedBinds.PushConstants).c_str());
+
+			const TextureStreamingStats streamingStats = TextureStreamer::GetStats();
+			UI::PropertyStringReadOnly("Streamed Textures", fmt::format("{} ({} pending)", streamingStats.StreamedTextures, streamingStats.PendingUploads).c_str());
+			UI::PropertyStringReadOnly("Texture Streaming Memory", fmt::format("{} / {}", Utils::BytesToString(streamingStats.StreamedMemory), Utils::BytesToString(streamingStats.Budget)).c_str());
+
+			UI::PropertyStringReadOnly("PreDepth GPU Time", fmt::format("{:.3f}ms", statistics.GPUTime.PreDepth).c_str());
+			UI::PropertyStringReadOnly("Geometry GPU Time", fmt::format("{:.3f}ms", statistics.GPUTime.Geometry).c_str());
+			UI::PropertyStringReadOnly("JumpFlood GPU Time", fmt::format("{:.3f}ms", statistics.GPUTime.JumpFlood).c_str());
+			UI::PropertyStringReadOnly("Composite GPU Time", fmt::format("{:.3f}ms", statistics.GPUTime.Composite).c_str());
+			UI::PropertyStringReadOnly("Renderer2D GPU Time", fmt::format("{:.3f}ms", statistics.GPUTime.Renderer2D).c_str());
 
 			UI::EndPropertyGrid();
 
@@ -1780,7 +1780,7 @@ namespace Iris::UI {
 
 		bool modified = false;
 
-		const AssetRegistry& assetRegistry = Project::GetEditorAssetManager()->GetAssetRegistry();
+		const AssetRegistry::Snapshot assetRegistry = Project::GetEditorAssetManager()->GetAssetRegistry().GetSnapshot();
 		AssetHandle current = outHandle;
 
 		ImGui::SetNextWindowSize({ size.x, 0.0f });
@@ -1893,7 +1893,7 @@ namespace Iris::UI {
 
 		bool modified = false;
 
-		const AssetRegistry& assetRegistry = Project::GetEditorAssetManager()->GetAssetRegistry();
+		const AssetRegistry::Snapshot assetRegistry = Project::GetEditorAssetManager()->GetAssetRegistry().GetSnapshot();
 		AssetHandle current = outHandle;
 
 		ImGui::SetNextWindowSize({ size.x, 0.0f });
@@ -18,7 +18,6 @@
  *      - Make the clouds work in the preetham shader
  *      - Maybe Generate the BRDFLut Texture ourselves?
  *		- Add Tracy for profiling
- *		- Implement finally the note described in Device.h (line: 68) that talks about handling one time command buffers submission.
  *
  * TODO: Creative Ideas:
  * - Crashing when recreating preetham sky: When enabling validation layers we do not get the crash. But when they are disabled we do get it... Look into that
@@ -29,8 +28,8 @@
  * - Viewport camera orthographic views done:
  *		- Gizmo controls and orthographic camera movement collision
  *		- Fix mouse picking in orthographic view
- * - Once we request a Mesh Asset from the AssetManger we should submit a lambda into the asset manager to wait until the asset is ready then we call Scene::InstantiateStaticMesh
- *		for that mesh so that we the whole entity hierarchy. However one problem so far is the when we call Scene::InstantiateStaticMesh we get the correct entity hierarchy but we
+ * - Scene::InstantiateStaticMeshAsync waits (AssetTask coroutine) for the mesh to be loaded and then calls Scene::InstantiateStaticMesh
+ *		for that mesh so that we get the whole entity hierarchy. However one problem so far is the when we call Scene::InstantiateStaticMesh we get the correct entity hierarchy but we
  *		render the root node (All the mesh) for each entity in the hierarchy which is WRONG! Each entity in the hierarchy should correspond to its submesh index
  *
  * NEXT THING TO WORK ON:
@@ -81,6 +80,19 @@
  *		- The asset manager can submit to the AssetThread an asset load request via the GetAssetAsync function, the AssetThread will then go through the
  *		  the asset loading requests queue and start loading the assets one by one. At the start of the next frame we sync the asset manager with the
  *		  AssetThread and retrieve any new loaded assets and queue and dependcy changes...
+ *		- The AssetThread is a pool of asset workers. Requests are picked up by priority (Awaited > Visible > NearCamera > Normal > Background),
+ *		  requests for the same asset are merged and only raise the priority of the queued one
+ *		- Before loading an asset the worker asks its AssetSerializer for the dependencies (GetDependencies) and queues them, the asset is then parked
+ *		  untill they are loaded. So a StaticMesh is loaded after its MeshSource and a MaterialAsset after its textures
+ *		- If an asset is requested from inside a worker (AssetManager::GetAsset) it goes through the AssetThread instead of the asset manager's
+ *		  loaded assets since those are only touched by the main thread
+ *		- Instead of polling GetAssetAsync every frame, loads can be awaited from an AssetTask coroutine (co_await AssetManager::LoadAsync<T>(handle)),
+ *		  the coroutine is resumed on the main thread in SyncWithAssetThread once the asset is synced (see AssetTask.h)
+ *		- The asset directory is watched by a FileWatcher, at the start of SyncWithAssetThread the settled changes are turned into imports, renames,
+ *		  deletions and reloads (textures, mesh sources, environment maps and fonts only) and then sent out as a FileSystemChangedEvent
+ *		- Every few frames the asset manager counts the references from all live scenes and loaded assets. When over the AssetMemoryBudget it evicts
+ *		  the least recently used assets that nothing references, they are just loaded again next time they are requested. Memory only materials
+ *		  and textures created by a mesh import are released once their mesh source is gone
  *
  * Future Plans:
  *  - Change the way mesh materials are displayed:
@@ -112,12 +124,14 @@
  * 		- 2: https://mynameismjp.wordpress.com/2011/08/10/average-luminance-compute-shader/
  * 		- 3: https://www.google.com/url?sa=t&source=web&rct=j&opi=89978449&url=https://resources.mpi-inf.mpg.de/tmo/logmap/logmap.pdf&ved=2ahUKEwiIrqjRtv2FAxVih_0HHZVMBK84ChAWegQIBRAB&usg=AOvVaw2PQ0E5hUTrfiVHLXDvpYKR
  * 		- 4: https://github.com/SaschaWillems/Vulkan/tree/master?tab=readme-ov-file#Advanced
- *  - Frustum Culling:
+ *  - Frustum Culling: (Done on the GPU for the GPU driven path, the CPU path still draws everything)
  * 		- 1: https://vkguide.dev/docs/new_chapter_5/faster_draw/
  * 		- 2: https://vkguide.dev/docs/gpudriven/compute_culling/
  *  - Tesselation Shaders: (For having low poly meshes with high details using tesselation and LODs)
  *		- 1: https://github.com/SaschaWillems/Vulkan/tree/master?tab=readme-ov-file#tessellation-shader
- *  - Switch to using draw indexed INDIRECT instead of using normal draw indexed since that is faster and facilitates tasks like culling and what not
+ *  - Draw indexed INDIRECT with compute frustum and Hi-Z culling is in behind SceneRendererSpecification::GPUDrivenRendering (toggled from the Scene Renderer panel), selected meshes still go through the CPU path
+ *		- Verify it headless (lavapipe) against the CPU path: same scene rendered both ways, compare the color attachments and the drawn instance counts. Needs a
+ *		  test target and a way to run the SceneRenderer without a window first, neither exists yet
  *  - OIT? With Weighted Blended technique using info provided from learnopengl.com <https://learnopengl.com/Guest-Articles/2020/OIT/Weighted-Blended> <https://github.com/nvpro-samples/vk_order_independent_transparency>
  *	- Add meshoptimizer? <https://github.com/zeux/meshoptimizer/tree/master>
  *  - Maybe add something in some mini editor window that can edit submesh indices and split them into transparent and non transparent submeshes so that we get OIT when implemented
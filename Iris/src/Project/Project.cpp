@@ -1,6 +1,8 @@
 #include "IrisPCH.h"
 #include "Project.h"
 
+#include "Renderer/Core/PipelineCache.h"
+
 namespace Iris {
 
 	Ref<Project> Project::Create()
@@ -12,6 +14,8 @@ namespace Iris {
 	{
 		if (s_ActiveProject)
 		{
+			PipelineCache::Save();
+
 			s_AssetManager->Shutdown();
 			s_AssetManager = nullptr;
 		}
@@ -20,7 +24,20 @@ namespace Iris {
 		if (s_ActiveProject)
 		{
 			s_AssetManager = EditorAssetManager::Create();
+			ApplyAssetMemoryBudget();
+			PipelineCache::Load();
 		}
 	}
 
+	void Project::ApplyAssetMemoryBudget()
+	{
+		IR_ASSERT(s_ActiveProject);
+		const ProjectConfig& config = s_ActiveProject->GetConfig();
+
+		AssetMemoryBudget budget;
+		budget.CPUMemory = static_cast<uint64_t>(config.AssetCPUMemoryBudget) * 1024 * 1024;
+		budget.GPUMemory = static_cast<uint64_t>(config.AssetGPUMemoryBudget) * 1024 * 1024;
+		GetEditorAssetManager()->SetMemoryBudget(budget);
+	}
+
 }
\ No newline at end of file
@@ -20,6 +20,10 @@ namespace Iris {
 		bool EnableAutoSave = false;
 		uint32_t AutoSaveIntervalSeconds = 300; // 5 minutes
 
+		// In MB, see AssetMemoryBudget
+		uint32_t AssetCPUMemoryBudget = 2048;
+		uint32_t AssetGPUMemoryBudget = 0;
+
 		// Not serialized
 		std::string ProjectFileName;
 		std::string ProjectDirectory;
@@ -38,6 +42,9 @@ namespace Iris {
 		static Ref<Project> GetActive() { return s_ActiveProject; }
 		static void SetActive(Ref<Project> project);
 
+		// Pushes the budget from the config to the asset manager, called again whenever the budget in the config changes
+		static void ApplyAssetMemoryBudget();
+
 		inline static Ref<AssetManagerBase> GetAssetManager() { return s_AssetManager; }
 		inline static Ref<EditorAssetManager> GetEditorAssetManager() { return s_AssetManager.As<EditorAssetManager>(); }
 
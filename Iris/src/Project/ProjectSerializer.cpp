@@ -23,6 +23,8 @@ namespace Iris {
 			out << YAML::Key << "StartScene" << YAML::Value << project->m_Config.StartScene;
 			out << YAML::Key << "AutoSave" << YAML::Value << project->m_Config.EnableAutoSave;
 			out << YAML::Key << "AutoSaveInterval" << YAML::Value << project->m_Config.AutoSaveIntervalSeconds;
+			out << YAML::Key << "AssetCPUMemoryBudget" << YAML::Value << project->m_Config.AssetCPUMemoryBudget;
+			out << YAML::Key << "AssetGPUMemoryBudget" << YAML::Value << project->m_Config.AssetGPUMemoryBudget;
 
 			out << YAML::Key << "Log" << YAML::Value;
 			{
@@ -87,6 +89,8 @@ namespace Iris {
 
 		config.EnableAutoSave = rootNode["AutoSave"].as<bool>();
 		config.AutoSaveIntervalSeconds = rootNode["AutoSaveInterval"].as<int>();
+		config.AssetCPUMemoryBudget = rootNode["AssetCPUMemoryBudget"].as<uint32_t>(config.AssetCPUMemoryBudget);
+		config.AssetGPUMemoryBudget = rootNode["AssetGPUMemoryBudget"].as<uint32_t>(config.AssetGPUMemoryBudget);
 
 		YAML::Node logNode = rootNode["Log"];
 		if (logNode)
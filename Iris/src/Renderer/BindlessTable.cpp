@@ -0,0 +1,412 @@
+#include "IrisPCH.h"
+#include "BindlessTable.h"
+
+#include "DescriptorSetManager.h"
+#include "Renderer/Core/RendererContext.h"
+#include "Renderer/Core/Vulkan.h"
+#include "Renderer/Core/VulkanAllocator.h"
+#include "Renderer.h"
+#include "Texture.h"
+
+#include <bit>
+
+namespace Iris {
+
+	static constexpr uint32_t s_MaxBindlessTextures = 16384;
+	static constexpr uint32_t s_InitialMaterialCapacity = 256;
+
+	struct BindlessFrameData
+	{
+		VkDescriptorSet DescriptorSet = nullptr;
+
+		VkBuffer MaterialBuffer = nullptr;
+		VmaAllocation MaterialAllocation = nullptr;
+		uint32_t MaterialCapacity = 0;
+		uint64_t MaterialGeneration = 0; // Newest material change that is in the buffer, 0 uploads all of them
+
+		// What each slot of the set currently points at
+		std::vector<VkDescriptorImageInfo> WrittenTextures;
+		uint64_t TextureGeneration = ~0ull;
+		uint64_t ResourceGeneration = ~0ull;
+	};
+
+	struct ReleasedSlot
+	{
+		uint32_t Index;
+		uint64_t ReleasedFrame;
+	};
+
+	struct BindlessTableData
+	{
+		VkDescriptorSetLayout Layout = nullptr;
+		VkDescriptorPool Pool = nullptr;
+		uint32_t MaxTextures = 0;
+
+		std::vector<BindlessFrameData> Frames;
+		std::vector<VkWriteDescriptorSet> TextureWrites;
+
+		std::mutex Mutex;
+		uint64_t FrameNumber = 0;
+
+		// Slot 0 is the white texture (registered first by Renderer::Init), nullptr for free slots
+		std::vector<Texture2D*> Textures;
+		std::vector<uint32_t> FreeTextureSlots;
+		std::vector<ReleasedSlot> ReleasedTextureSlots;
+		uint64_t TextureGeneration = 0;
+
+		std::vector<BindlessMaterialData> Materials;
+		std::vector<uint64_t> MaterialGenerations; // Generation of the last change to each material
+		std::vector<uint32_t> FreeMaterialSlots;
+		std::vector<ReleasedSlot> ReleasedMaterialSlots;
+		uint64_t MaterialGeneration = 0;
+	};
+
+	static BindlessTableData* s_Data = nullptr;
+
+	namespace Utils {
+
+		static void CreateMaterialBuffer(BindlessFrameData& frame, uint32_t capacity)
+		{
+			VkBufferCreateInfo bufferCI = {
+				.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+				.size = capacity * sizeof(BindlessMaterialData),
+				.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				.sharingMode = VK_SHARING_MODE_EXCLUSIVE
+			};
+
+			VulkanAllocator allocator("BindlessTable");
+			frame.MaterialAllocation = allocator.AllocateBuffer(&bufferCI, VMA_MEMORY_USAGE_CPU_TO_GPU, &frame.MaterialBuffer);
+			frame.MaterialCapacity = capacity;
+			frame.MaterialGeneration = 0;
+
+			VkDescriptorBufferInfo bufferInfo = {
+				.buffer = frame.MaterialBuffer,
+				.offset = 0,
+				.range = VK_WHOLE_SIZE
+			};
+
+			VkWriteDescriptorSet writeDescriptor = {
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.dstSet = frame.DescriptorSet,
+				.dstBinding = BindlessTable::MaterialsBinding,
+				.descriptorCount = 1,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.pBufferInfo = &bufferInfo
+			};
+
+			VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+			vkUpdateDescriptorSets(device, 1, &writeDescriptor, 0, nullptr);
+		}
+
+		// Has to be called with the mutex locked
+		static void UpdateTextures(BindlessFrameData& frame)
+		{
+			const uint64_t resourceGeneration = DescriptorSetManager::GetResourceGeneration();
+			if (frame.TextureGeneration == s_Data->TextureGeneration && frame.ResourceGeneration == resourceGeneration)
+				return;
+
+			// Nothing can be written before the white texture is there to fill the empty slots with
+			Texture2D* whiteTexture = s_Data->Textures.empty() ? nullptr : s_Data->Textures[0];
+			if (!whiteTexture || !whiteTexture->GetDescriptorImageInfo().imageView)
+				return;
+
+			const VkDescriptorImageInfo& whiteInfo = whiteTexture->GetDescriptorImageInfo();
+
+			frame.WrittenTextures.resize(s_Data->Textures.size());
+			s_Data->TextureWrites.clear();
+			for (uint32_t i = 0; i < s_Data->Textures.size(); i++)
+			{
+				Texture2D* texture = s_Data->Textures[i];
+				const VkDescriptorImageInfo& info = texture && texture->GetDescriptorImageInfo().imageView ? texture->GetDescriptorImageInfo() : whiteInfo;
+
+				VkDescriptorImageInfo& written = frame.WrittenTextures[i];
+				if (written.imageView == info.imageView && written.sampler == info.sampler && written.imageLayout == info.imageLayout)
+					continue;
+
+				written = info;
+				s_Data->TextureWrites.push_back({
+					.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+					.dstSet = frame.DescriptorSet,
+					.dstBinding = BindlessTable::TexturesBinding,
+					.dstArrayElement = i,
+					.descriptorCount = 1,
+					.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+					.pImageInfo = &written
+				});
+			}
+
+			if (!s_Data->TextureWrites.empty())
+			{
+				VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+				vkUpdateDescriptorSets(device, static_cast<uint32_t>(s_Data->TextureWrites.size()), s_Data->TextureWrites.data(), 0, nullptr);
+			}
+
+			frame.TextureGeneration = s_Data->TextureGeneration;
+			frame.ResourceGeneration = resourceGeneration;
+		}
+
+		static void RetireReleasedSlots(std::vector<ReleasedSlot>& released, std::vector<uint32_t>& freeSlots)
+		{
+			// The render thread lags a frame behind and every frame in flight could still index the slot
+			const uint64_t framesInFlight = Renderer::GetConfig().FramesInFlight;
+			std::erase_if(released, [&](const ReleasedSlot& slot)
+			{
+				if (s_Data->FrameNumber - slot.ReleasedFrame <= framesInFlight)
+					return false;
+
+				freeSlots.push_back(slot.Index);
+				return true;
+			});
+		}
+
+	}
+
+	void BindlessTable::Init()
+	{
+		s_Data = new BindlessTableData();
+
+		Ref<VulkanPhysicalDevice> physicalDevice = RendererContext::GetCurrentDevice()->GetPhysicalDevice();
+		const VkPhysicalDeviceDescriptorIndexingProperties& indexingProperties = physicalDevice->GetDescriptorIndexingProperties();
+		s_Data->MaxTextures = std::min({
+			s_MaxBindlessTextures,
+			indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+			indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+			indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+			indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages
+		});
+
+		const VkDescriptorSetLayoutBinding layoutBindings[] = {
+			{
+				.binding = TexturesBinding,
+				.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+				.descriptorCount = s_Data->MaxTextures,
+				.stageFlags = VK_SHADER_STAGE_ALL
+			},
+			{
+				.binding = MaterialsBinding,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.descriptorCount = 1,
+				.stageFlags = VK_SHADER_STAGE_ALL
+			}
+		};
+
+		// Only the texture slots get written while a command buffer that has the set bound is still being recorded
+		const VkDescriptorBindingFlags bindingFlags[] = {
+			VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT,
+			0
+		};
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCI = {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+			.bindingCount = static_cast<uint32_t>(std::size(bindingFlags)),
+			.pBindingFlags = bindingFlags
+		};
+
+		VkDescriptorSetLayoutCreateInfo layoutCI = {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.pNext = &bindingFlagsCI,
+			.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+			.bindingCount = static_cast<uint32_t>(std::size(layoutBindings)),
+			.pBindings = layoutBindings
+		};
+
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &layoutCI, nullptr, &s_Data->Layout));
+
+		const uint32_t framesInFlight = Renderer::GetConfig().FramesInFlight;
+		const VkDescriptorPoolSize poolSizes[] = {
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, s_Data->MaxTextures * framesInFlight },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, framesInFlight }
+		};
+
+		VkDescriptorPoolCreateInfo poolCI = {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+			.maxSets = framesInFlight,
+			.poolSizeCount = static_cast<uint32_t>(std::size(poolSizes)),
+			.pPoolSizes = poolSizes
+		};
+		VK_CHECK_RESULT(vkCreateDescriptorPool(device, &poolCI, nullptr, &s_Data->Pool));
+
+		s_Data->Frames.resize(framesInFlight);
+		for (BindlessFrameData& frame : s_Data->Frames)
+		{
+			VkDescriptorSetAllocateInfo allocInfo = {
+				.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+				.descriptorPool = s_Data->Pool,
+				.descriptorSetCount = 1,
+				.pSetLayouts = &s_Data->Layout
+			};
+			VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &frame.DescriptorSet));
+
+			Utils::CreateMaterialBuffer(frame, s_InitialMaterialCapacity);
+		}
+
+		IR_CORE_INFO_TAG("Renderer", "Bindless table: {} texture slots", s_Data->MaxTextures);
+	}
+
+	void BindlessTable::Shutdown()
+	{
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		VulkanAllocator allocator("BindlessTable");
+		for (BindlessFrameData& frame : s_Data->Frames)
+			allocator.DestroyBuffer(frame.MaterialAllocation, frame.MaterialBuffer);
+
+		vkDestroyDescriptorPool(device, s_Data->Pool, nullptr);
+		vkDestroyDescriptorSetLayout(device, s_Data->Layout, nullptr);
+
+		// Textures that outlive the renderer release their slot through here
+		for (Texture2D* texture : s_Data->Textures)
+		{
+			if (texture)
+				texture->m_BindlessIndex = InvalidIndex;
+		}
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void BindlessTable::BeginFrame()
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		s_Data->FrameNumber++;
+		Utils::RetireReleasedSlots(s_Data->ReleasedTextureSlots, s_Data->FreeTextureSlots);
+		Utils::RetireReleasedSlots(s_Data->ReleasedMaterialSlots, s_Data->FreeMaterialSlots);
+	}
+
+	void BindlessTable::RT_BeginFrame()
+	{
+		BindlessFrameData& frame = s_Data->Frames[Renderer::RT_GetCurrentFrameIndex()];
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		// Nothing from this frame is in flight anymore, so the buffer can be swapped and written directly
+		const uint32_t materialCount = static_cast<uint32_t>(s_Data->Materials.size());
+		if (materialCount > frame.MaterialCapacity)
+		{
+			Renderer::SubmitReseourceFree([buffer = frame.MaterialBuffer, allocation = frame.MaterialAllocation]()
+			{
+				VulkanAllocator allocator("BindlessTable");
+				allocator.DestroyBuffer(allocation, buffer);
+			});
+
+			Utils::CreateMaterialBuffer(frame, std::bit_ceil(materialCount));
+		}
+
+		if (frame.MaterialGeneration != s_Data->MaterialGeneration)
+		{
+			VulkanAllocator allocator("BindlessTable");
+			BindlessMaterialData* materials = allocator.MapMemory<BindlessMaterialData>(frame.MaterialAllocation);
+			for (uint32_t i = 0; i < materialCount; i++)
+			{
+				if (s_Data->MaterialGenerations[i] > frame.MaterialGeneration)
+					materials[i] = s_Data->Materials[i];
+			}
+			allocator.UnmapMemory(frame.MaterialAllocation);
+
+			frame.MaterialGeneration = s_Data->MaterialGeneration;
+		}
+
+		Utils::UpdateTextures(frame);
+	}
+
+	uint32_t BindlessTable::RegisterTexture(Texture2D* texture)
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		if (texture->m_BindlessIndex != InvalidIndex)
+			return texture->m_BindlessIndex;
+
+		uint32_t index;
+		if (!s_Data->FreeTextureSlots.empty())
+		{
+			index = s_Data->FreeTextureSlots.back();
+			s_Data->FreeTextureSlots.pop_back();
+		}
+		else if (s_Data->Textures.size() < s_Data->MaxTextures)
+		{
+			index = static_cast<uint32_t>(s_Data->Textures.size());
+			s_Data->Textures.push_back(nullptr);
+		}
+		else
+		{
+			IR_CORE_ERROR_TAG("Renderer", "Bindless table is full ({} textures), '{}' will sample the white texture", s_Data->MaxTextures, texture->GetTextureSpecification().DebugName);
+			return 0;
+		}
+
+		s_Data->Textures[index] = texture;
+		s_Data->TextureGeneration++;
+		texture->m_BindlessIndex = index;
+		return index;
+	}
+
+	void BindlessTable::ReleaseTexture(Texture2D* texture)
+	{
+		if (!s_Data)
+			return;
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		if (texture->m_BindlessIndex == InvalidIndex)
+			return;
+
+		s_Data->Textures[texture->m_BindlessIndex] = nullptr;
+		s_Data->ReleasedTextureSlots.push_back({ texture->m_BindlessIndex, s_Data->FrameNumber });
+		s_Data->TextureGeneration++;
+		texture->m_BindlessIndex = InvalidIndex;
+	}
+
+	uint32_t BindlessTable::AllocateMaterial()
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		uint32_t index;
+		if (!s_Data->FreeMaterialSlots.empty())
+		{
+			index = s_Data->FreeMaterialSlots.back();
+			s_Data->FreeMaterialSlots.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(s_Data->Materials.size());
+			s_Data->Materials.emplace_back();
+			s_Data->MaterialGenerations.emplace_back();
+		}
+
+		s_Data->Materials[index] = {};
+		s_Data->MaterialGenerations[index] = ++s_Data->MaterialGeneration;
+		return index;
+	}
+
+	void BindlessTable::FreeMaterial(uint32_t index)
+	{
+		if (!s_Data || index == InvalidIndex)
+			return;
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		s_Data->ReleasedMaterialSlots.push_back({ index, s_Data->FrameNumber });
+	}
+
+	void BindlessTable::SetMaterialData(uint32_t index, const BindlessMaterialData& data)
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		s_Data->Materials[index] = data;
+		s_Data->MaterialGenerations[index] = ++s_Data->MaterialGeneration;
+	}
+
+	VkDescriptorSet BindlessTable::RT_GetDescriptorSet()
+	{
+		BindlessFrameData& frame = s_Data->Frames[Renderer::RT_GetCurrentFrameIndex()];
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		Utils::UpdateTextures(frame);
+		return frame.DescriptorSet;
+	}
+
+	VkDescriptorSetLayout BindlessTable::GetDescriptorSetLayout()
+	{
+		return s_Data->Layout;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+/*
+ * One global descriptor set (set 4) with every sampled texture in a single unbounded array and the data of every material in a storage buffer
+ * - Shaders index the table with the values returned by Texture2D::GetBindlessIndex and BindlessTable::AllocateMaterial so draws with different
+ *   materials no longer need a descriptor set or push constants of their own
+ * - There is one set and one material buffer per frame in flight, both only get written on the render thread for the frame that is being recorded
+ * - Empty, released or not yet loaded texture slots point at the white texture
+ * - Released texture and material slots are only handed out again once no frame in flight can still be reading them
+ * - Requires descriptor indexing (partially bound, update after bind and runtime arrays) which is core since Vulkan 1.2
+ */
+
+namespace Iris {
+
+	class Texture2D;
+
+	// Same layout as `MaterialData` in the shaders (std430), has to stay a multiple of 16 bytes
+	struct BindlessMaterialData
+	{
+		glm::vec3 AlbedoColor = { 0.8f, 0.8f, 0.8f };
+		float Roughness = 0.4f;
+		float Metalness = 0.0f;
+		float Emission = 0.0f;
+		float Tiling = 1.0f;
+		float Transparency = 1.0f;
+
+		uint32_t UseNormalMap = 0;
+		uint32_t Lit = 1;
+		uint32_t AlbedoTexture = 0;
+		uint32_t NormalTexture = 0;
+
+		uint32_t RoughnessTexture = 0;
+		uint32_t MetalnessTexture = 0;
+		float EnvMapRotation = 0.0f;
+		uint32_t Padding = 0;
+	};
+
+	static_assert(sizeof(BindlessMaterialData) % 16 == 0);
+
+	class BindlessTable
+	{
+	public:
+		static constexpr uint32_t DescriptorSet = 4;
+		static constexpr uint32_t TexturesBinding = 0;
+		static constexpr uint32_t MaterialsBinding = 1;
+		static constexpr uint32_t InvalidIndex = ~0u;
+
+		static void Init();
+		static void Shutdown();
+
+		// Main thread, once per frame. Retires released slots that are no longer in flight
+		static void BeginFrame();
+		// Render thread, uploads the materials that changed and writes the texture slots that changed into the set of the frame
+		static void RT_BeginFrame();
+
+		// Called through Texture2D::GetBindlessIndex, returns the slot the texture already has if it is registered
+		static uint32_t RegisterTexture(Texture2D* texture);
+		// Called when the texture gets destroyed
+		static void ReleaseTexture(Texture2D* texture);
+
+		static uint32_t AllocateMaterial();
+		static void FreeMaterial(uint32_t index);
+		static void SetMaterialData(uint32_t index, const BindlessMaterialData& data);
+
+		// Also picks up the textures that were registered or recreated since the frame began
+		static VkDescriptorSet RT_GetDescriptorSet();
+		static VkDescriptorSetLayout GetDescriptorSetLayout();
+	};
+
+}
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "IrisPCH.h"
 #include "ComputePipeline.h"
 
+#include "Core/PipelineCache.h"
+#include "Core/UploadManager.h"
 #include "Renderer.h"
 
 namespace Iris {
@@ -79,6 +81,8 @@ namespace Iris {
 				.commandBufferCount = 1,
 				.pCommandBuffers = &m_ActiveComputeCommandBuffer
 			};
+
+			UploadManager::Flush();
 			VK_CHECK_RESULT(vkQueueSubmit(graphicsQueue, 1, &submitInfo, m_ComputeFence));
 
 			// Wait for compute shader execution for safety reasons...
@@ -155,7 +159,9 @@ namespace Iris {
 			.stage = pipelineShaderStages[0],
 			.layout = m_PipelineLayout
 		};
-		VK_CHECK_RESULT(vkCreateComputePipelines(device, nullptr, 1, &pipelineCI, nullptr, &m_Pipeline));
+		Timer timer;
+		VK_CHECK_RESULT(vkCreateComputePipelines(device, PipelineCache::Get(), 1, &pipelineCI, nullptr, &m_Pipeline));
+		PipelineCache::AddPipelineCreationTime(timer.ElapsedMillis());
 		VKUtils::SetDebugUtilsObjectName(device, VK_OBJECT_TYPE_PIPELINE, std::string(m_Shader->GetName()), m_Pipeline);
 
 		VkFenceCreateInfo fenceCI = {
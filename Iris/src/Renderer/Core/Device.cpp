@@ -2,6 +2,7 @@
 #include "Device.h"
 
 #include "Renderer/Core/RendererContext.h"
+#include "Renderer/Core/UploadManager.h"
 #include "Renderer/Core/Vulkan.h"
 #include "Renderer/Renderer.h"
 
@@ -55,11 +56,26 @@ namespace Iris {
 		IR_VERIFY(selectedDevice, "Could find any physical devices!");
 		m_PhysicalDevice = selectedDevice;
 
+		m_Vulkan12Features = {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+			.pNext = nullptr
+		};
+
 		m_Features = {
 			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
-			.pNext = nullptr
+			.pNext = &m_Vulkan12Features
 		};
 		vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &m_Features);
+		m_Features.pNext = nullptr;
+
+		// Queried again for the selected device since the loop above only looks at the core properties
+		m_DescriptorIndexingProperties = {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+			.pNext = nullptr
+		};
+		m_Properties.pNext = &m_DescriptorIndexingProperties;
+		vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &m_Properties);
+		m_Properties.pNext = nullptr;
 
 		m_MemoryProperties = {
 			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
@@ -157,6 +173,14 @@ namespace Iris {
 		return m_SupportedExtensions.find(extensionName) != m_SupportedExtensions.end();
 	}
 
+	bool VulkanPhysicalDevice::IsFormatFeatureSupported(VkFormat format, VkFormatFeatureFlags features) const
+	{
+		VkFormatProperties props;
+		vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &props);
+
+		return (props.optimalTilingFeatures & features) == features;
+	}
+
 	VulkanPhysicalDevice::QueueFamilyIndices VulkanPhysicalDevice::GetQueueFamilyIndices(int requestedIndices)
 	{
 		QueueFamilyIndices result;
@@ -285,9 +309,28 @@ namespace Iris {
 
 		// TODO: Some more extensions to check and add Aftermath maybe..??
 
+		// Descriptor indexing is core since 1.2, the bindless table (Renderer/BindlessTable.h) can not work without these
+		const VkPhysicalDeviceVulkan12Features& supported12Features = physicalDevice->GetPhysicalDeviceVulkan12Features();
+		IR_VERIFY(supported12Features.runtimeDescriptorArray && supported12Features.shaderSampledImageArrayNonUniformIndexing
+			&& supported12Features.descriptorBindingPartiallyBound && supported12Features.descriptorBindingSampledImageUpdateAfterBind,
+			"The device does not support the descriptor indexing features needed for bindless textures!");
+
+		VkPhysicalDeviceVulkan12Features vulkan12Features = {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+			.pNext = nullptr,
+			.shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+			.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+			.descriptorBindingUpdateUnusedWhilePending = supported12Features.descriptorBindingUpdateUnusedWhilePending,
+			.descriptorBindingPartiallyBound = VK_TRUE,
+			.runtimeDescriptorArray = VK_TRUE,
+			.drawIndirectCount = supported12Features.drawIndirectCount
+		};
+
+		m_IndirectDrawCountSupported = enabledFeatures.multiDrawIndirect && enabledFeatures.drawIndirectFirstInstance && supported12Features.drawIndirectCount;
+
 		VkPhysicalDeviceSynchronization2Features synchronization2Feature = {
 			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES,
-			.pNext = nullptr,
+			.pNext = &vulkan12Features,
 			.synchronization2 = VK_TRUE
 		};
 
@@ -320,6 +363,16 @@ namespace Iris {
 		VKUtils::SetDebugUtilsObjectName(m_LogicalDevice, VK_OBJECT_TYPE_QUEUE, "GraphicsQueue", m_GraphicsQueue);
 		vkGetDeviceQueue(m_LogicalDevice, m_PhysicalDevice->GetQueueFamilyIndices().Compute, 0, &m_ComputeQueue);
 		VKUtils::SetDebugUtilsObjectName(m_LogicalDevice, VK_OBJECT_TYPE_QUEUE, "ComputeQueue", m_ComputeQueue);
+
+		// A queue for the transfer family is only created if it is dedicated (see VulkanPhysicalDevice), otherwise transfers go through the graphics queue
+		const VulkanPhysicalDevice::QueueFamilyIndices& queueFamilyIndices = m_PhysicalDevice->GetQueueFamilyIndices();
+		if (queueFamilyIndices.Transfer != queueFamilyIndices.Graphics && queueFamilyIndices.Transfer != queueFamilyIndices.Compute)
+		{
+			vkGetDeviceQueue(m_LogicalDevice, queueFamilyIndices.Transfer, 0, &m_TransferQueue);
+			VKUtils::SetDebugUtilsObjectName(m_LogicalDevice, VK_OBJECT_TYPE_QUEUE, "TransferQueue", m_TransferQueue);
+		}
+		else
+			m_TransferQueue = m_GraphicsQueue;
 	}
 
 	VulkanDevice::~VulkanDevice()
@@ -369,6 +422,8 @@ namespace Iris {
 	Ref<VulkanCommandPool> VulkanDevice::GetThreadLocalCommandPool()
 	{
 		std::thread::id threadID = std::this_thread::get_id();
+
+		std::scoped_lock<std::mutex> lock(m_CommandPoolsMutex);
 		IR_ASSERT(m_CommandPools.contains(threadID), "Not found!");
 
 		return m_CommandPools.at(threadID);
@@ -377,6 +432,8 @@ namespace Iris {
 	Ref<VulkanCommandPool> VulkanDevice::GetOrCreateThreadLocalCommandPool()
 	{
 		std::thread::id threadID = std::this_thread::get_id();
+
+		std::scoped_lock<std::mutex> lock(m_CommandPoolsMutex);
 		auto it = m_CommandPools.find(threadID);
 		if (it != m_CommandPools.end())
 			return it->second;
@@ -492,6 +549,9 @@ namespace Iris {
 		VkFence fence;
 		VK_CHECK_RESULT(vkCreateFence(vulkanDevice, &fenceInfo, nullptr, &fence));
 
+		// The command buffer could be using resources that were just uploaded
+		UploadManager::Flush(queue != device->GetGraphicsQueue());
+
 		// Not more than one thread can submit to the SAME queue at the same time since that is UB
 		{
 			device->LockQueue();
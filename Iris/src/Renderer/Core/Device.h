@@ -33,8 +33,12 @@ namespace Iris {
 		const VkPhysicalDeviceMemoryProperties& GetPhysicalDeviceMemoryProps() const { return m_MemoryProperties.memoryProperties; }
 		const VkPhysicalDeviceLimits& GetPhysicalDeviceLimits() const { return m_Properties.properties.limits; }
 		const VkPhysicalDeviceFeatures& GetPhysicalDeviceFeatures() const { return m_Features.features; }
+		const VkPhysicalDeviceVulkan12Features& GetPhysicalDeviceVulkan12Features() const { return m_Vulkan12Features; }
+		const VkPhysicalDeviceDescriptorIndexingProperties& GetDescriptorIndexingProperties() const { return m_DescriptorIndexingProperties; }
 
 		bool IsExtensionSupported(const std::string& extensionName) const;
+		// Checks the features of optimally tiled images of that format
+		bool IsFormatFeatureSupported(VkFormat format, VkFormatFeatureFlags features) const;
 		uint32_t FindMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags props) const;
 
 		VkFormat GetDepthFormat() const { return m_DepthFormat; }
@@ -48,6 +52,8 @@ namespace Iris {
 		VkPhysicalDevice m_PhysicalDevice = nullptr;
 		VkPhysicalDeviceProperties2 m_Properties;
 		VkPhysicalDeviceFeatures2 m_Features;
+		VkPhysicalDeviceVulkan12Features m_Vulkan12Features;
+		VkPhysicalDeviceDescriptorIndexingProperties m_DescriptorIndexingProperties;
 		VkPhysicalDeviceMemoryProperties2 m_MemoryProperties;
 
 		QueueFamilyIndices m_QueueFamilyIndices;
@@ -67,22 +73,9 @@ namespace Iris {
 	 * This is mainly for when we want to quickly allocate and then destroy a commandbuffer to submit a couple of small commands
 	 * This is an interface and VulkanDevice provides the direct API to use
 	 * 
-	 * TODO(IMPORTANT): `This is especially for Staging Buffers and handling them`
-	 *   The note mentioned above is actually very NOT optimal and NOT good since it calls a `vkQueueSubmit` on a small commandbuffer
-	 *	 And as for Staging Buffers we currently allocate a command buffer, record copy command and then `vkQueueSubmit` which, as mentioned,
-	 *	 is NOT that good of a thing concerning performance.
-	 *	 To fix that we can(should): Create a command buffer (beginning of application maybe?) that records copy commands for staging buffers
-	 *	 mainly (and maybe other stuff like that) and then at the next call for `vkQueueSubmit`, whether that is at the end of the frame or
-	 *   not (To be handled in case we have a `vkQueueSubmit` not at the of the frame) we submit that command buffer to the command buffer
-	 *   array of the `VkSubmitInfo` and we make sure to submit it as the first command buffer to execute so that the data is available for
-	 *   when the next command buffer is to be executed.
-	 * 
-	 *   As for deleting the Staging Buffer we could just do a `Renderer::SubmitReseourceFree` and it will delete the staging buffer at the
-	 *   beginning of the next frame that way nothing is using that buffer.
-	 * 
-	 *   Potential Obstacles: Copying attachments to host buffers...? We will have to queue the copying to host buffer to the next frame so that the data is available
-	 *
-	 *   Provide a flag that allows us to instantly submit that command buffer or queue it up until the next vkQueueSubmit
+	 * NOTE: Staging uploads do NOT go through here anymore, they are recorded into batches by the UploadManager (Renderer/Core/UploadManager.h)
+	 *   which get submitted right before the next `vkQueueSubmit` instead of a `vkQueueSubmit` and fence wait per upload.
+	 *   FlushCommandBuffer flushes those batches first since the command buffer could be using something that was just uploaded
 	 */
 	class VulkanCommandPool : public RefCountedObject
 	{
@@ -123,6 +116,9 @@ namespace Iris {
 
 		VkQueue GetGraphicsQueue() { return m_GraphicsQueue; }
 		VkQueue GetComputeQueue() { return m_ComputeQueue; }
+		// Same as the graphics queue if the device does not have a dedicated transfer queue. Only the UploadManager submits to it
+		VkQueue GetTransferQueue() { return m_TransferQueue; }
+		bool HasDedicatedTransferQueue() const { return m_TransferQueue != m_GraphicsQueue; }
 
 		VkCommandBuffer GetCommandBuffer(bool begin, bool compute = false);
 		void FlushCommandBuffer(VkCommandBuffer commandBuffer, bool compute = false);
@@ -131,6 +127,9 @@ namespace Iris {
 		const Ref<VulkanPhysicalDevice> GetPhysicalDevice() const { return m_PhysicalDevice; }
 		VkDevice GetVulkanDevice() const { return m_LogicalDevice; }
 
+		// Multi draw indirect with first instance and draw indirect count, needed by the GPU driven path of the SceneRenderer
+		bool IsIndirectDrawCountSupported() const { return m_IndirectDrawCountSupported; }
+
 	private:
 		Ref<VulkanCommandPool> GetThreadLocalCommandPool();
 		Ref<VulkanCommandPool> GetOrCreateThreadLocalCommandPool();
@@ -139,11 +138,14 @@ namespace Iris {
 		VkDevice m_LogicalDevice = nullptr;
 		Ref<VulkanPhysicalDevice> m_PhysicalDevice = nullptr;
 		VkPhysicalDeviceFeatures m_Features;
+		bool m_IndirectDrawCountSupported = false;
 
 		VkQueue m_GraphicsQueue;
 		VkQueue m_ComputeQueue;
+		VkQueue m_TransferQueue;
 
 		std::map<std::thread::id, Ref<VulkanCommandPool>> m_CommandPools;
+		std::mutex m_CommandPoolsMutex; // Asset workers create their own command pools while loading
 
 		std::mutex m_GraphicsQueueMutex;
 		std::mutex m_ComputeQueueMutex;
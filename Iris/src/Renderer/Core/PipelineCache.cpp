@@ -0,0 +1,272 @@
+#include "IrisPCH.h"
+#include "PipelineCache.h"
+
+#include "Project/Project.h"
+#include "Renderer/Core/RendererContext.h"
+#include "Renderer/Renderer.h"
+#include "Serialization/FileStream.h"
+#include "Utils/FileSystem.h"
+
+namespace Iris {
+
+	static constexpr uint32_t s_PipelineCacheVersion = 1;
+	static constexpr char s_PipelineCacheIdentifier[8] = { 'I', 'R', 'P', 'I', 'P', 'E', 'C', 'H' };
+
+	struct PipelineCacheHeader
+	{
+		char Identifier[8];
+		uint32_t Version;
+		uint32_t VendorID;
+		uint32_t DeviceID;
+		uint32_t DriverVersion;
+		uint8_t PipelineCacheUUID[VK_UUID_SIZE];
+		uint64_t DataSize; // Size of the VkPipelineCache data following the header
+		float ColdPipelineTime; // Average time in ms it took to create a pipeline in a run that started without a cache, 0 if not measured yet
+	};
+
+	struct PipelineCacheData
+	{
+		VkPipelineCache Cache = VK_NULL_HANDLE;
+		std::mutex Mutex;
+
+		// Compiles on the worker threads hold on to the cache they started with, Load can't destroy the previous one before they finish
+		std::unordered_map<VkPipelineCache, uint32_t> Users;
+		std::unordered_set<VkPipelineCache> Retired;
+
+		// Since the last Load
+		uint32_t PipelineCount = 0;
+		float PipelineCreationTime = 0.0f;
+
+		bool Warm = false; // Started from the data of a valid file
+		float ColdPipelineTime = 0.0f;
+	};
+
+	static PipelineCacheData* s_Data = nullptr;
+
+	namespace Utils {
+
+		static std::filesystem::path GetPipelineCachePath()
+		{
+			return Project::GetCacheDirectory() / "PipelineCache.bin";
+		}
+
+		static void FillPipelineCacheHeader(PipelineCacheHeader& header)
+		{
+			const VkPhysicalDeviceProperties& properties = RendererContext::GetCurrentDevice()->GetPhysicalDevice()->GetPhysicalDeviceProperties();
+
+			std::memcpy(header.Identifier, s_PipelineCacheIdentifier, sizeof(s_PipelineCacheIdentifier));
+			header.Version = s_PipelineCacheVersion;
+			header.VendorID = properties.vendorID;
+			header.DeviceID = properties.deviceID;
+			header.DriverVersion = properties.driverVersion;
+			std::memcpy(header.PipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+		}
+
+		static void DestroyPipelineCache(VkPipelineCache pipelineCache)
+		{
+			VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+			vkDestroyPipelineCache(device, pipelineCache, nullptr);
+		}
+
+	}
+
+	void PipelineCache::Init()
+	{
+		s_Data = new PipelineCacheData();
+
+		VkPipelineCacheCreateInfo pipelineCacheCI = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO
+		};
+
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		VK_CHECK_RESULT(vkCreatePipelineCache(device, &pipelineCacheCI, nullptr, &s_Data->Cache));
+	}
+
+	void PipelineCache::Shutdown()
+	{
+		IR_ASSERT(s_Data->Users.empty(), "Pipelines are still being compiled");
+
+		for (VkPipelineCache pipelineCache : s_Data->Retired)
+			Utils::DestroyPipelineCache(pipelineCache);
+		Utils::DestroyPipelineCache(s_Data->Cache);
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void PipelineCache::Save()
+	{
+		if (!s_Data || !Project::GetActive())
+			return;
+
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+
+		PipelineCacheHeader header = {};
+		Utils::FillPipelineCacheHeader(header);
+
+		Buffer cacheData;
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+			std::size_t dataSize = 0;
+			VK_CHECK_RESULT(vkGetPipelineCacheData(device, s_Data->Cache, &dataSize, nullptr));
+			cacheData.Allocate(dataSize);
+			VK_CHECK_RESULT(vkGetPipelineCacheData(device, s_Data->Cache, &dataSize, cacheData.Data));
+			cacheData.Size = dataSize;
+
+			// Only a run that started from nothing tells how long the pipelines take without the cache
+			header.ColdPipelineTime = s_Data->ColdPipelineTime;
+			if (!s_Data->Warm && s_Data->PipelineCount > 0)
+				header.ColdPipelineTime = s_Data->PipelineCreationTime / s_Data->PipelineCount;
+
+			if (s_Data->Warm && s_Data->ColdPipelineTime > 0.0f && s_Data->PipelineCount > 0)
+			{
+				const float coldTime = s_Data->ColdPipelineTime * s_Data->PipelineCount;
+				IR_CORE_INFO_TAG("Renderer", "Created {} pipelines in {:.2f}ms from the pipeline cache, saved about {:.2f}ms compared to a run without it",
+					s_Data->PipelineCount, s_Data->PipelineCreationTime, coldTime - s_Data->PipelineCreationTime);
+			}
+			else if (!s_Data->Warm && s_Data->PipelineCount > 0)
+			{
+				IR_CORE_INFO_TAG("Renderer", "Created {} pipelines in {:.2f}ms without a pipeline cache", s_Data->PipelineCount, s_Data->PipelineCreationTime);
+			}
+		}
+
+		header.DataSize = cacheData.Size;
+
+		const std::filesystem::path cachePath = Utils::GetPipelineCachePath();
+		std::filesystem::create_directories(cachePath.parent_path());
+
+		std::filesystem::path tempPath = cachePath;
+		tempPath += ".tmp";
+		{
+			FileStreamWriter stream(tempPath, true);
+			if (!stream)
+			{
+				IR_CORE_ERROR_TAG("Renderer", "Failed to save pipeline cache to {}", cachePath);
+				cacheData.Release();
+				return;
+			}
+
+			stream.WriteRaw<PipelineCacheHeader>(header);
+			stream.WriteData(cacheData.Data, cacheData.Size);
+		}
+
+		cacheData.Release();
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, cachePath, error);
+		if (error)
+		{
+			IR_CORE_ERROR_TAG("Renderer", "Failed to save pipeline cache to {}: {}", cachePath, error.message());
+			std::filesystem::remove(tempPath, error);
+			return;
+		}
+
+		IR_CORE_TRACE_TAG("Renderer", "Saved pipeline cache to {} ({} bytes)", cachePath, header.DataSize);
+	}
+
+	void PipelineCache::Load()
+	{
+		if (!s_Data || !Project::GetActive())
+			return;
+
+		Timer timer;
+
+		const std::filesystem::path cachePath = Utils::GetPipelineCachePath();
+		Buffer fileData;
+		if (FileSystem::Exists(cachePath))
+			fileData = FileSystem::ReadBytes(cachePath);
+
+		PipelineCacheHeader expectedHeader = {};
+		Utils::FillPipelineCacheHeader(expectedHeader);
+
+		const auto* header = reinterpret_cast<const PipelineCacheHeader*>(fileData.Data);
+		const bool validHeader = fileData.Size >= sizeof(PipelineCacheHeader)
+			&& std::memcmp(header->Identifier, s_PipelineCacheIdentifier, sizeof(s_PipelineCacheIdentifier)) == 0
+			&& header->Version == s_PipelineCacheVersion
+			&& header->VendorID == expectedHeader.VendorID && header->DeviceID == expectedHeader.DeviceID
+			&& header->DriverVersion == expectedHeader.DriverVersion
+			&& std::memcmp(header->PipelineCacheUUID, expectedHeader.PipelineCacheUUID, VK_UUID_SIZE) == 0
+			&& fileData.Size >= sizeof(PipelineCacheHeader) + header->DataSize;
+
+		if (fileData && !validHeader)
+			IR_CORE_WARN_TAG("Renderer", "Pipeline cache {} was written by a different device or driver or is corrupted, discarding it", cachePath);
+
+		VkPipelineCacheCreateInfo pipelineCacheCI = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+			.initialDataSize = validHeader ? header->DataSize : 0,
+			.pInitialData = validHeader ? fileData.Data + sizeof(PipelineCacheHeader) : nullptr
+		};
+
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+		VK_CHECK_RESULT(vkCreatePipelineCache(device, &pipelineCacheCI, nullptr, &pipelineCache));
+
+		const bool warm = validHeader && header->DataSize > 0;
+		const float coldPipelineTime = validHeader ? header->ColdPipelineTime : 0.0f;
+		fileData.Release();
+
+		VkPipelineCache previousCache = VK_NULL_HANDLE;
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+			// Keeps whatever got created before the project was opened (Renderer::Init) or by the previous project
+			VK_CHECK_RESULT(vkMergePipelineCaches(device, pipelineCache, 1, &s_Data->Cache));
+
+			previousCache = s_Data->Cache;
+			s_Data->Cache = pipelineCache;
+			s_Data->PipelineCount = 0;
+			s_Data->PipelineCreationTime = 0.0f;
+			s_Data->Warm = warm;
+			s_Data->ColdPipelineTime = coldPipelineTime;
+		}
+
+		// The render thread could still be creating a pipeline with the previous cache, and compiles that acquired it keep it alive until they release it
+		Renderer::SubmitReseourceFree([previousCache]()
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+			if (s_Data->Users.contains(previousCache))
+				s_Data->Retired.insert(previousCache);
+			else
+				Utils::DestroyPipelineCache(previousCache);
+		});
+
+		if (warm)
+			IR_CORE_INFO_TAG("Renderer", "Loaded pipeline cache {} in {:.2f}ms", cachePath, timer.ElapsedMillis());
+	}
+
+	VkPipelineCache PipelineCache::Get()
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		return s_Data->Cache;
+	}
+
+	VkPipelineCache PipelineCache::Acquire()
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		s_Data->Users[s_Data->Cache]++;
+		return s_Data->Cache;
+	}
+
+	void PipelineCache::Release(VkPipelineCache pipelineCache)
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		auto it = s_Data->Users.find(pipelineCache);
+		IR_VERIFY(it != s_Data->Users.end());
+		if (--it->second > 0)
+			return;
+
+		s_Data->Users.erase(it);
+		if (s_Data->Retired.erase(pipelineCache))
+			Utils::DestroyPipelineCache(pipelineCache);
+	}
+
+	void PipelineCache::AddPipelineCreationTime(float milliseconds)
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		s_Data->PipelineCount++;
+		s_Data->PipelineCreationTime += milliseconds;
+	}
+
+}
\ No newline at end of file
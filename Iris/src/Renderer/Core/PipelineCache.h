@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+/*
+ * One VkPipelineCache shared by every graphics and compute pipeline, persisted to Cache/PipelineCache.bin of the active project
+ * - The cache is created empty by Renderer::Init, pipelines created before a project is opened are merged into the project's cache once it loads
+ * - The file starts with our own header holding the vendor, device, driver version and pipelineCacheUUID of the device that wrote it,
+ *   files written by a different device or driver are thrown away instead of handing them to the driver
+ * - Saved when the project gets closed, written to a temporary file first and renamed over the old one
+ * - Pipeline creation is timed, the average of a run without a cache is kept in the file so that later runs can report the time they saved
+ */
+
+namespace Iris {
+
+	class PipelineCache
+	{
+	public:
+		static void Init();
+		static void Shutdown();
+
+		// Called by Project::SetActive, saves the cache of the previous project and loads the one of the active project
+		static void Save();
+		static void Load();
+
+		// Safe to call from any thread, the cache itself is internally synchronized
+		static VkPipelineCache Get();
+
+		// For work that runs outside of the render thread, keeps the returned cache alive across a Load until it is released
+		static VkPipelineCache Acquire();
+		static void Release(VkPipelineCache pipelineCache);
+
+		static void AddPipelineCreationTime(float milliseconds);
+	};
+
+}
\ No newline at end of file
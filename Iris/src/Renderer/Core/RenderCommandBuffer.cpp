@@ -1,6 +1,7 @@
 #include "IrisPCH.h"
 #include "RenderCommandBuffer.h"
 
+#include "Renderer/Core/UploadManager.h"
 #include "Renderer/Renderer.h"
 
 namespace Iris {
@@ -83,6 +84,8 @@ namespace Iris {
 			VK_CHECK_RESULT(vkCreateQueryPool(device, &queryPoolCI, nullptr, &pipelineStatisticsQueryPool));
 
 		m_PipelineStatisticsQueryResults.resize(commandBufferCount);
+
+		CreateTimestampQueryPools(commandBufferCount);
 	}
 
 	RenderCommandBuffer::RenderCommandBuffer(const std::string& debugName, bool swapchain)
@@ -112,11 +115,13 @@ namespace Iris {
 			VK_CHECK_RESULT(vkCreateQueryPool(device, &queryPoolCI, nullptr, &pipelineStatisticsQueryPool));
 
 		m_PipelineStatisticsQueryResults.resize(framesInFlight);
+
+		CreateTimestampQueryPools(framesInFlight);
 	}
 
 	RenderCommandBuffer::~RenderCommandBuffer()
 	{
-		Renderer::SubmitReseourceFree([ownedBySwapChain = m_OwnedBySwapChain, commandbuffers = m_CommandBuffers, fences = m_WaitFences, queryPools = m_PipelineStatisticsQueryPools]()
+		Renderer::SubmitReseourceFree([ownedBySwapChain = m_OwnedBySwapChain, commandbuffers = m_CommandBuffers, fences = m_WaitFences, queryPools = m_PipelineStatisticsQueryPools, timestampQueryPools = m_TimestampQueryPools]()
 		{
 			VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
 
@@ -131,17 +136,59 @@ namespace Iris {
 
 			for (const VkQueryPool& queryPool : queryPools)
 				vkDestroyQueryPool(device, queryPool, nullptr);
+
+			for (const VkQueryPool& queryPool : timestampQueryPools)
+				vkDestroyQueryPool(device, queryPool, nullptr);
 		});
 	}
 
+	void RenderCommandBuffer::CreateTimestampQueryPools(uint32_t count)
+	{
+		Ref<VulkanDevice> logicalDevice = RendererContext::GetCurrentDevice();
+		const VkPhysicalDeviceLimits& limits = logicalDevice->GetPhysicalDevice()->GetPhysicalDeviceLimits();
+		if (!limits.timestampComputeAndGraphics)
+		{
+			IR_CORE_WARN_TAG("Renderer", "Device does not support timestamps on the graphics queue, GPU timings of {} are disabled", m_DebugName);
+			return;
+		}
+
+		// The whole command buffer and enough pairs for every pass of the scene renderer
+		constexpr uint32_t maxTimestampQueries = 32;
+		m_TimestampQueryCount = 2 + 2 * maxTimestampQueries;
+		m_TimestampPeriod = limits.timestampPeriod;
+
+		VkQueryPoolCreateInfo queryPoolCI = {
+			.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+			.pNext = nullptr,
+			.queryType = VK_QUERY_TYPE_TIMESTAMP,
+			.queryCount = m_TimestampQueryCount
+		};
+		m_TimestampQueryPools.resize(count);
+		for (VkQueryPool& timestampQueryPool : m_TimestampQueryPools)
+			VK_CHECK_RESULT(vkCreateQueryPool(logicalDevice->GetVulkanDevice(), &queryPoolCI, nullptr, &timestampQueryPool));
+
+		m_TimestampQueryNames.resize(count);
+		m_TimestampQueriesWritten.resize(count, 0);
+	}
+
+	uint32_t RenderCommandBuffer::RT_GetCommandBufferIndex() const
+	{
+		uint32_t commandBufferIndex = Renderer::RT_GetCurrentFrameIndex();
+		if (!m_OwnedBySwapChain)
+			commandBufferIndex = commandBufferIndex % m_CommandBuffers.size();
+
+		return commandBufferIndex;
+	}
+
 	void RenderCommandBuffer::Begin()
 	{
+		m_TimestampNextAvailableQuery = 2;
+		m_OpenTimestampQueries.clear();
+
 		Ref<RenderCommandBuffer> instance = this;
 		Renderer::Submit([instance]() mutable
 		{
-			uint32_t commandBufferIndex = Renderer::RT_GetCurrentFrameIndex();
-			if (!(instance->m_OwnedBySwapChain))
-				commandBufferIndex = commandBufferIndex % instance->m_CommandBuffers.size();
+			uint32_t commandBufferIndex = instance->RT_GetCommandBufferIndex();
 			VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
 
 			if (instance->m_CommandBuffers.size())
@@ -159,22 +206,41 @@ namespace Iris {
 				instance->m_ActiveCommandBuffer = instance->m_CommandBuffers[commandBufferIndex].CommandBuffer;
 
 			VK_CHECK_RESULT(vkBeginCommandBuffer(instance->m_ActiveCommandBuffer, &beginInfo));
+			instance->m_BoundState.Reset();
 
 			// Pipeline Statistics
 			vkCmdResetQueryPool(instance->m_ActiveCommandBuffer, instance->m_PipelineStatisticsQueryPools[commandBufferIndex], 0, instance->m_PipelineQueryCount);
 			vkCmdBeginQuery(instance->m_ActiveCommandBuffer, instance->m_PipelineStatisticsQueryPools[commandBufferIndex], 0, 0);
+
+			// Timestamps
+			if (instance->m_TimestampQueryCount)
+			{
+				instance->RT_ReadTimestampQueryResults(commandBufferIndex);
+
+				VkQueryPool timestampQueryPool = instance->m_TimestampQueryPools[commandBufferIndex];
+				vkCmdResetQueryPool(instance->m_ActiveCommandBuffer, timestampQueryPool, 0, instance->m_TimestampQueryCount);
+				vkCmdWriteTimestamp(instance->m_ActiveCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampQueryPool, 0);
+				instance->m_TimestampQueryNames[commandBufferIndex].clear();
+			}
 		});
 	}
 
 	void RenderCommandBuffer::End()
 	{
+		IR_ASSERT(m_OpenTimestampQueries.empty(), "Every BeginTimestampQuery needs an EndTimestampQuery");
+
 		Ref<RenderCommandBuffer> instance = this;
 		Renderer::Submit([instance]() mutable
 		{
-			uint32_t commandBufferIndex = Renderer::RT_GetCurrentFrameIndex();
-			if (!(instance->m_OwnedBySwapChain))
-				commandBufferIndex = commandBufferIndex % instance->m_CommandBuffers.size();
+			uint32_t commandBufferIndex = instance->RT_GetCommandBufferIndex();
 			vkCmdEndQuery(instance->m_ActiveCommandBuffer, instance->m_PipelineStatisticsQueryPools[commandBufferIndex], 0);
+
+			if (instance->m_TimestampQueryCount)
+			{
+				vkCmdWriteTimestamp(instance->m_ActiveCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, instance->m_TimestampQueryPools[commandBufferIndex], 1);
+				instance->m_TimestampQueriesWritten[commandBufferIndex] = 2 + 2 * static_cast<uint32_t>(instance->m_TimestampQueryNames[commandBufferIndex].size());
+			}
+
 			VK_CHECK_RESULT(vkEndCommandBuffer(instance->m_ActiveCommandBuffer));
 
 			instance->m_ActiveCommandBuffer = nullptr;
@@ -203,6 +269,9 @@ namespace Iris {
 
 			// PG_CORE_TRACE_TAG("Renderer", "Submitting Render Command Buffer {}", m_DebugName);
 
+			// Uploads recorded since the last submit have to execute before this command buffer
+			UploadManager::Flush();
+
 			logicalDevice->LockQueue();
 			VK_CHECK_RESULT(vkQueueSubmit(logicalDevice->GetGraphicsQueue(), 1, &submitInfo, instance->m_WaitFences[commandBufferIndex]));
 			logicalDevice->UnlockQueue();
@@ -221,4 +290,97 @@ namespace Iris {
 		});
 	}
 
+	void RenderCommandBuffer::BeginTimestampQuery(const std::string& name)
+	{
+		// Queries that do not fit are dropped but still pushed so that EndTimestampQuery stays balanced
+		if (m_TimestampNextAvailableQuery + 2 > m_TimestampQueryCount)
+		{
+			m_OpenTimestampQueries.push_back(~0u);
+			return;
+		}
+
+		const uint32_t queryIndex = m_TimestampNextAvailableQuery;
+		m_TimestampNextAvailableQuery += 2;
+		m_OpenTimestampQueries.push_back(queryIndex);
+
+		Ref<RenderCommandBuffer> instance = this;
+		Renderer::Submit([instance, queryIndex, name]() mutable
+		{
+			uint32_t commandBufferIndex = instance->RT_GetCommandBufferIndex();
+			vkCmdWriteTimestamp(instance->m_ActiveCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, instance->m_TimestampQueryPools[commandBufferIndex], queryIndex);
+
+			// Queries are handed out in submission order so the name of a pair is at (queryIndex - 2) / 2
+			instance->m_TimestampQueryNames[commandBufferIndex].push_back(name);
+		});
+	}
+
+	void RenderCommandBuffer::EndTimestampQuery()
+	{
+		IR_ASSERT(!m_OpenTimestampQueries.empty());
+
+		const uint32_t queryIndex = m_OpenTimestampQueries.back();
+		m_OpenTimestampQueries.pop_back();
+		if (queryIndex == ~0u)
+			return;
+
+		Ref<RenderCommandBuffer> instance = this;
+		Renderer::Submit([instance, queryIndex]() mutable
+		{
+			uint32_t commandBufferIndex = instance->RT_GetCommandBufferIndex();
+			vkCmdWriteTimestamp(instance->m_ActiveCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, instance->m_TimestampQueryPools[commandBufferIndex], queryIndex + 1);
+		});
+	}
+
+	float RenderCommandBuffer::GetExecutionGPUTime() const
+	{
+		std::scoped_lock<std::mutex> lock(m_TimestampResultsMutex);
+		return m_ExecutionGPUTime;
+	}
+
+	float RenderCommandBuffer::GetTimestampQueryTime(const std::string& name) const
+	{
+		std::scoped_lock<std::mutex> lock(m_TimestampResultsMutex);
+		auto it = m_TimestampQueryResults.find(name);
+		return it != m_TimestampQueryResults.end() ? it->second : 0.0f;
+	}
+
+	void RenderCommandBuffer::RT_ReadTimestampQueryResults(uint32_t commandBufferIndex)
+	{
+		const uint32_t queryCount = m_TimestampQueriesWritten[commandBufferIndex];
+		if (queryCount == 0)
+			return;
+
+		m_TimestampQueriesWritten[commandBufferIndex] = 0;
+
+		// No wait bit, if the GPU is still busy with the last use of this pool its results are skipped and the previous ones stay
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		std::vector<uint64_t> timestamps(queryCount);
+		VkResult result = vkGetQueryPoolResults(
+			device,
+			m_TimestampQueryPools[commandBufferIndex],
+			0,
+			queryCount,
+			queryCount * sizeof(uint64_t),
+			timestamps.data(),
+			sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT
+		);
+		if (result != VK_SUCCESS)
+			return;
+
+		auto toMilliseconds = [period = m_TimestampPeriod](uint64_t begin, uint64_t end)
+		{
+			return end > begin ? static_cast<float>(static_cast<double>(end - begin) * period * 0.000001) : 0.0f;
+		};
+
+		std::unordered_map<std::string, float> results;
+		const std::vector<std::string>& names = m_TimestampQueryNames[commandBufferIndex];
+		for (uint32_t i = 0; i < names.size(); i++)
+			results[names[i]] += toMilliseconds(timestamps[2 + 2 * i], timestamps[3 + 2 * i]);
+
+		std::scoped_lock<std::mutex> lock(m_TimestampResultsMutex);
+		m_ExecutionGPUTime = toMilliseconds(timestamps[0], timestamps[1]);
+		m_TimestampQueryResults = std::move(results);
+	}
+
 }
\ No newline at end of file
@@ -7,7 +7,41 @@
 
 namespace Iris {
 
-	// TODO: Timestamps
+	// Graphics state that is bound in the active command buffer so the renderer can skip binds that would not change anything
+	// Only used on the render thread, reset when the command buffer begins and at the start of every render pass since anything that records
+	// outside of the renderer (ImGui) could have changed it in between
+	struct BoundGraphicsState
+	{
+		static constexpr uint32_t MaxDescriptorSets = 8;
+		static constexpr uint32_t MaxVertexBuffers = 2;
+
+		struct PushConstantRange
+		{
+			VkShaderStageFlags Stages = 0;
+			uint32_t Offset = 0;
+			std::vector<uint8_t> Data;
+		};
+
+		VkPipeline Pipeline = nullptr;
+		VkPipelineLayout PipelineLayout = nullptr; // Sets and push constants are only kept while the layout stays the same
+
+		std::array<VkDescriptorSet, MaxDescriptorSets> DescriptorSets = {};
+		std::array<VkBuffer, MaxVertexBuffers> VertexBuffers = {};
+		std::array<VkDeviceSize, MaxVertexBuffers> VertexBufferOffsets = {};
+		VkBuffer IndexBuffer = nullptr;
+		std::vector<PushConstantRange> PushConstants;
+
+		void Reset()
+		{
+			Pipeline = nullptr;
+			PipelineLayout = nullptr;
+			DescriptorSets = {};
+			VertexBuffers = {};
+			VertexBufferOffsets = {};
+			IndexBuffer = nullptr;
+			PushConstants.clear();
+		}
+	};
 
 	class RenderCommandBuffer : public RefCountedObject
 	{
@@ -29,6 +63,22 @@ namespace Iris {
 
 		const PipelineStatistics& GetPipelineStatistics(uint32_t frameIndex) const { return m_PipelineStatisticsQueryResults[frameIndex]; }
 
+		// Timestamps at the top of the pipe on begin and at the bottom on end, queries can nest and the times of every query with the same name
+		// are summed. Renderer::BeginRenderPass/BeginComputePass open one named after the pass
+		void BeginTimestampQuery(const std::string& name);
+		void EndTimestampQuery();
+
+		// In milliseconds. Read back when the command buffer begins again and only once the GPU is done with them so they lag a few frames behind
+		float GetExecutionGPUTime() const;
+		float GetTimestampQueryTime(const std::string& name) const;
+
+		BoundGraphicsState& RT_GetBoundState() { return m_BoundState; }
+
+	private:
+		void CreateTimestampQueryPools(uint32_t count);
+		uint32_t RT_GetCommandBufferIndex() const;
+		void RT_ReadTimestampQueryResults(uint32_t commandBufferIndex);
+
 	private:
 		std::string m_DebugName;
 
@@ -41,6 +91,7 @@ namespace Iris {
 		std::vector<PerPoolCommandBuffer> m_CommandBuffers;
 
 		VkCommandBuffer m_ActiveCommandBuffer = nullptr; // Only a ref
+		BoundGraphicsState m_BoundState;
 
 		std::vector<VkFence> m_WaitFences;
 
@@ -49,6 +100,21 @@ namespace Iris {
 		std::vector<VkQueryPool> m_PipelineStatisticsQueryPools;
 		uint32_t m_PipelineQueryCount = 0;
 		std::vector<PipelineStatistics> m_PipelineStatisticsQueryResults;		
+
+		// Queries 0 and 1 time the whole command buffer, every other pair is one BeginTimestampQuery/EndTimestampQuery
+		std::vector<VkQueryPool> m_TimestampQueryPools;
+		uint32_t m_TimestampQueryCount = 0; // 0 when the device can not write timestamps
+		uint32_t m_TimestampNextAvailableQuery = 2;
+		std::vector<uint32_t> m_OpenTimestampQueries;
+		float m_TimestampPeriod = 0.0f; // Nanoseconds per tick
+
+		// Render thread, per pool: the name of every pair in the order it was written and the number of queries that were written
+		std::vector<std::vector<std::string>> m_TimestampQueryNames;
+		std::vector<uint32_t> m_TimestampQueriesWritten;
+
+		mutable std::mutex m_TimestampResultsMutex;
+		float m_ExecutionGPUTime = 0.0f;
+		std::unordered_map<std::string, float> m_TimestampQueryResults;
 	};
 
 }
\ No newline at end of file
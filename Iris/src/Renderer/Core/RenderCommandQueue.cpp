@@ -86,6 +86,15 @@ namespace Iris {
 		m_CommandCount = 0;
 	}
 
+	void RenderCommandQueue::Swap(RenderCommandQueue& other)
+	{
+		std::swap(m_CommandBuffer, other.m_CommandBuffer);
+		std::swap(m_CommandBufferPtr, other.m_CommandBufferPtr);
+		std::swap(m_CommandCount, other.m_CommandCount);
+		std::swap(m_Capacity, other.m_Capacity);
+		std::swap(m_UsedBytes, other.m_UsedBytes);
+	}
+
 	void RenderCommandQueue::ReAlloc(std::size_t newCapacity, std::size_t ptrPosition)
 	{
 		uint8_t* newCommandBuffer = new uint8_t[newCapacity];
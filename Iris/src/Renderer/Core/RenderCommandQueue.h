@@ -15,6 +15,8 @@ namespace Iris {
 
 		void* Allocate(RenderCommandFn fn, uint32_t size);
 		void Execute();
+		// Exchanges the recorded commands and buffers of both queues
+		void Swap(RenderCommandQueue& other);
 
 	private:
 		void ReAlloc(std::size_t newCapacity, std::size_t ptrPosition);
@@ -284,8 +284,12 @@ namespace Iris {
         // Select and Create Physical Device
         m_PhysicalDevice = VulkanPhysicalDevice::Create();
 
+        // Multi draw indirect and first instance are only needed by the GPU driven path of the SceneRenderer which is optional
+        const VkPhysicalDeviceFeatures& supportedFeatures = m_PhysicalDevice->GetPhysicalDeviceFeatures();
         VkPhysicalDeviceFeatures enabledFeatures = {
             .independentBlend = true,
+            .multiDrawIndirect = supportedFeatures.multiDrawIndirect,
+            .drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance,
             .fillModeNonSolid = true,
             .wideLines = true,
             .samplerAnisotropy = true,
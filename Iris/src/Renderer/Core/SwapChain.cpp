@@ -1,6 +1,7 @@
 #include "IrisPCH.h"
 #include "SwapChain.h"
 
+#include "Renderer/Core/UploadManager.h"
 #include "Renderer/Core/Vulkan.h"
 #include "Renderer/Renderer.h"
 
@@ -457,6 +458,9 @@ namespace Iris {
 			.pSignalSemaphores = &m_RenderFinishedSemaphores[m_CurrentFrameIndex]
 		};
 
+		// Uploads recorded since the last submit have to execute before the swapchain command buffer
+		UploadManager::Flush();
+
 		m_Device->LockQueue();
 		VK_CHECK_RESULT(vkQueueSubmit(m_Device->GetGraphicsQueue(), 1, &submitInfo, m_WaitFences[m_CurrentFrameIndex]));
 
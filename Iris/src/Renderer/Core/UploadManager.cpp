@@ -0,0 +1,500 @@
+#include "IrisPCH.h"
+#include "UploadManager.h"
+
+#include "Renderer/Core/RendererContext.h"
+#include "Renderer/Core/Vulkan.h"
+#include "Renderer/Core/VulkanAllocator.h"
+#include "Renderer/Renderer.h"
+#include "Utils/StringUtils.h"
+
+#include <deque>
+#include <numeric>
+
+namespace Iris {
+
+	struct UploadBatch
+	{
+		VkCommandPool TransferCommandPool = VK_NULL_HANDLE;
+		VkCommandPool GraphicsCommandPool = VK_NULL_HANDLE; // Only created with a dedicated transfer queue
+		VkCommandBuffer TransferCommandBuffer = VK_NULL_HANDLE;
+		VkCommandBuffer GraphicsCommandBuffer = VK_NULL_HANDLE; // Same as TransferCommandBuffer without a dedicated transfer queue
+
+		VkSemaphore TransferSemaphore = VK_NULL_HANDLE; // Signaled by the transfer submit and waited on by the graphics submit
+		VkFence Fence = VK_NULL_HANDLE;
+
+		uint64_t RingEnd = 0; // Ring head at the time the batch was flushed, the ring tail moves here once the batch is retired
+		std::vector<std::pair<VkBuffer, VmaAllocation>> DedicatedStagingBuffers;
+
+		bool Retired = false;
+	};
+
+	struct StagingAllocation
+	{
+		VkBuffer Buffer = VK_NULL_HANDLE;
+		uint64_t Offset = 0;
+	};
+
+	struct UploadManagerData
+	{
+		bool DedicatedTransferQueue = false;
+		uint32_t TransferQueueFamily = 0;
+		uint32_t GraphicsQueueFamily = 0;
+
+		VkBuffer RingBuffer = VK_NULL_HANDLE;
+		VmaAllocation RingAllocation = nullptr;
+		uint8_t* RingData = nullptr; // Persistently mapped
+		uint64_t RingSize = 0;
+		uint64_t RingHead = 0;
+		uint64_t RingTail = 0;
+		bool RingAllocated = false; // Whether the current batch allocated anything from the ring
+
+		std::mutex Mutex;
+		UploadBatch* CurrentBatch = nullptr;
+		std::deque<UploadBatch*> InFlightBatches;
+		std::vector<UploadBatch*> FreeBatches;
+		std::vector<UploadBatch*> Batches;
+	};
+
+	static UploadManagerData* s_Data = nullptr;
+
+	// Keeps every staging offset aligned to optimalBufferCopyOffsetAlignment on all the hardware we care about
+	static constexpr uint64_t s_StagingAlignment = 16;
+
+	namespace Utils {
+
+		static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+		{
+			return ((value + alignment - 1) / alignment) * alignment;
+		}
+
+		static void InsertImageOwnershipBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, bool release, const VkImageSubresourceRange& subresourceRange)
+		{
+			// The release on the transfer queue and the acquire on the graphics queue have to specify the same layouts and queue families
+			VkImageMemoryBarrier2 imageMemBarrier = {
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+				.srcStageMask = release ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_NONE,
+				.srcAccessMask = release ? VK_ACCESS_2_TRANSFER_WRITE_BIT : VK_ACCESS_2_NONE,
+				.dstStageMask = release ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+				.dstAccessMask = release ? VK_ACCESS_2_NONE : VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+				.oldLayout = oldLayout,
+				.newLayout = newLayout,
+				.srcQueueFamilyIndex = s_Data->TransferQueueFamily,
+				.dstQueueFamilyIndex = s_Data->GraphicsQueueFamily,
+				.image = image,
+				.subresourceRange = subresourceRange
+			};
+
+			VkDependencyInfo info = {
+				.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+				.imageMemoryBarrierCount = 1,
+				.pImageMemoryBarriers = &imageMemBarrier
+			};
+
+			vkCmdPipelineBarrier2(commandBuffer, &info);
+		}
+
+		static void InsertBufferOwnershipBarrier(VkCommandBuffer commandBuffer, VkBuffer buffer, uint64_t offset, uint64_t size, bool release)
+		{
+			VkBufferMemoryBarrier2 bufferMemBarrier = {
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+				.srcStageMask = release ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_NONE,
+				.srcAccessMask = release ? VK_ACCESS_2_TRANSFER_WRITE_BIT : VK_ACCESS_2_NONE,
+				.dstStageMask = release ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+				.dstAccessMask = release ? VK_ACCESS_2_NONE : VK_ACCESS_2_MEMORY_READ_BIT,
+				.srcQueueFamilyIndex = s_Data->TransferQueueFamily,
+				.dstQueueFamilyIndex = s_Data->GraphicsQueueFamily,
+				.buffer = buffer,
+				.offset = offset,
+				.size = size
+			};
+
+			VkDependencyInfo info = {
+				.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+				.bufferMemoryBarrierCount = 1,
+				.pBufferMemoryBarriers = &bufferMemBarrier
+			};
+
+			vkCmdPipelineBarrier2(commandBuffer, &info);
+		}
+
+	}
+
+	static UploadBatch* CreateBatch()
+	{
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+
+		UploadBatch* batch = new UploadBatch();
+
+		VkCommandPoolCreateInfo commandPoolInfo = {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+			.queueFamilyIndex = s_Data->TransferQueueFamily
+		};
+		VK_CHECK_RESULT(vkCreateCommandPool(device, &commandPoolInfo, nullptr, &batch->TransferCommandPool));
+
+		VkCommandBufferAllocateInfo allocateInfo = {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+			.commandPool = batch->TransferCommandPool,
+			.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+			.commandBufferCount = 1
+		};
+		VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &allocateInfo, &batch->TransferCommandBuffer));
+		batch->GraphicsCommandBuffer = batch->TransferCommandBuffer;
+
+		if (s_Data->DedicatedTransferQueue)
+		{
+			commandPoolInfo.queueFamilyIndex = s_Data->GraphicsQueueFamily;
+			VK_CHECK_RESULT(vkCreateCommandPool(device, &commandPoolInfo, nullptr, &batch->GraphicsCommandPool));
+
+			allocateInfo.commandPool = batch->GraphicsCommandPool;
+			VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &allocateInfo, &batch->GraphicsCommandBuffer));
+
+			VkSemaphoreCreateInfo semaphoreInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+			VK_CHECK_RESULT(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &batch->TransferSemaphore));
+		}
+
+		VkFenceCreateInfo fenceInfo = { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+		VK_CHECK_RESULT(vkCreateFence(device, &fenceInfo, nullptr, &batch->Fence));
+
+		s_Data->Batches.push_back(batch);
+		return batch;
+	}
+
+	static void DestroyBatch(UploadBatch* batch)
+	{
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		VulkanAllocator allocator("UploadManager");
+
+		for (auto& [buffer, allocation] : batch->DedicatedStagingBuffers)
+			allocator.DestroyBuffer(allocation, buffer);
+
+		vkDestroyCommandPool(device, batch->TransferCommandPool, nullptr);
+		if (batch->GraphicsCommandPool)
+			vkDestroyCommandPool(device, batch->GraphicsCommandPool, nullptr);
+		if (batch->TransferSemaphore)
+			vkDestroySemaphore(device, batch->TransferSemaphore, nullptr);
+		vkDestroyFence(device, batch->Fence, nullptr);
+
+		delete batch;
+	}
+
+	// Expects the mutex to be locked
+	static UploadBatch* GetCurrentBatch()
+	{
+		if (s_Data->CurrentBatch)
+			return s_Data->CurrentBatch;
+
+		UploadBatch* batch = nullptr;
+		if (!s_Data->FreeBatches.empty())
+		{
+			batch = s_Data->FreeBatches.back();
+			s_Data->FreeBatches.pop_back();
+		}
+		else
+			batch = CreateBatch();
+
+		batch->Retired = false;
+
+		VkCommandBufferBeginInfo beginInfo = {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+		};
+		VK_CHECK_RESULT(vkBeginCommandBuffer(batch->TransferCommandBuffer, &beginInfo));
+		if (s_Data->DedicatedTransferQueue)
+			VK_CHECK_RESULT(vkBeginCommandBuffer(batch->GraphicsCommandBuffer, &beginInfo));
+
+		s_Data->CurrentBatch = batch;
+		return batch;
+	}
+
+	// Expects the mutex to be locked
+	static bool AllocateFromRing(uint64_t size, uint64_t alignment, uint64_t& outOffset)
+	{
+		// Nothing is using the ring so start from the beginning again instead of wrapping in the middle of it
+		if (s_Data->InFlightBatches.empty() && !s_Data->RingAllocated)
+		{
+			s_Data->RingHead = 0;
+			s_Data->RingTail = 0;
+		}
+
+		// The head never catches up to the tail so that head == tail always means the ring is empty
+		uint64_t offset = Utils::AlignUp(s_Data->RingHead, alignment);
+		if (s_Data->RingHead >= s_Data->RingTail)
+		{
+			if (offset + size > s_Data->RingSize)
+			{
+				if (size >= s_Data->RingTail)
+					return false;
+
+				// Wrap around, the end of the ring is skipped untill the tail passes it
+				offset = 0;
+			}
+		}
+		else if (offset + size >= s_Data->RingTail)
+			return false;
+
+		s_Data->RingHead = offset + size;
+		s_Data->RingAllocated = true;
+
+		outOffset = offset;
+		return true;
+	}
+
+	// Expects the mutex to be locked
+	static StagingAllocation AllocateStaging(UploadBatch* batch, const void* data, uint64_t size, uint64_t alignment)
+	{
+		StagingAllocation result;
+		if (AllocateFromRing(size, alignment, result.Offset))
+		{
+			result.Buffer = s_Data->RingBuffer;
+			std::memcpy(s_Data->RingData + result.Offset, data, size);
+			vmaFlushAllocation(VulkanAllocator::GetVmaAllocator(), s_Data->RingAllocation, result.Offset, size);
+
+			return result;
+		}
+
+		// Too big for what is left of the ring (ex. a huge texture while a lot of uploads are in flight) so it gets its own staging buffer
+		VulkanAllocator allocator("UploadManager");
+
+		VkBufferCreateInfo stagingBufferInfo = {
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.size = size,
+			.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE
+		};
+		VmaAllocation stagingBufferAllocation = allocator.AllocateBuffer(&stagingBufferInfo, VMA_MEMORY_USAGE_CPU_TO_GPU, &result.Buffer);
+
+		uint8_t* dstData = allocator.MapMemory<uint8_t>(stagingBufferAllocation);
+		std::memcpy(dstData, data, size);
+		allocator.UnmapMemory(stagingBufferAllocation);
+
+		batch->DedicatedStagingBuffers.emplace_back(result.Buffer, stagingBufferAllocation);
+		result.Offset = 0;
+
+		return result;
+	}
+
+	static void RetireBatch(UploadBatch* batch)
+	{
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		// Retired with the frame that submitted it so the fence should have been signaled a long time ago
+		VK_CHECK_RESULT(vkWaitForFences(device, 1, &batch->Fence, VK_TRUE, UINT64_MAX));
+		VK_CHECK_RESULT(vkResetFences(device, 1, &batch->Fence));
+
+		vkResetCommandPool(device, batch->TransferCommandPool, 0);
+		if (batch->GraphicsCommandPool)
+			vkResetCommandPool(device, batch->GraphicsCommandPool, 0);
+
+		VulkanAllocator allocator("UploadManager");
+		for (auto& [buffer, allocation] : batch->DedicatedStagingBuffers)
+			allocator.DestroyBuffer(allocation, buffer);
+		batch->DedicatedStagingBuffers.clear();
+
+		batch->Retired = true;
+
+		// Batches are not necessarily retired in the order they were flushed (render thread vs other threads) but the ring has to be freed in order
+		while (!s_Data->InFlightBatches.empty() && s_Data->InFlightBatches.front()->Retired)
+		{
+			UploadBatch* retiredBatch = s_Data->InFlightBatches.front();
+			s_Data->InFlightBatches.pop_front();
+
+			s_Data->RingTail = retiredBatch->RingEnd;
+			s_Data->FreeBatches.push_back(retiredBatch);
+		}
+	}
+
+	void UploadManager::Init()
+	{
+		s_Data = new UploadManagerData();
+
+		Ref<VulkanDevice> device = RendererContext::GetCurrentDevice();
+		const VulkanPhysicalDevice::QueueFamilyIndices& queueFamilyIndices = device->GetPhysicalDevice()->GetQueueFamilyIndices();
+
+		s_Data->DedicatedTransferQueue = device->HasDedicatedTransferQueue();
+		s_Data->GraphicsQueueFamily = static_cast<uint32_t>(queueFamilyIndices.Graphics);
+		s_Data->TransferQueueFamily = s_Data->DedicatedTransferQueue ? static_cast<uint32_t>(queueFamilyIndices.Transfer) : s_Data->GraphicsQueueFamily;
+
+		s_Data->RingSize = Renderer::GetConfig().StagingRingSize;
+
+		VulkanAllocator allocator("UploadManager");
+		VkBufferCreateInfo ringBufferInfo = {
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.size = s_Data->RingSize,
+			.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE
+		};
+		s_Data->RingAllocation = allocator.AllocateBuffer(&ringBufferInfo, VMA_MEMORY_USAGE_CPU_TO_GPU, &s_Data->RingBuffer);
+		s_Data->RingData = allocator.MapMemory<uint8_t>(s_Data->RingAllocation);
+		VKUtils::SetDebugUtilsObjectName(device->GetVulkanDevice(), VK_OBJECT_TYPE_BUFFER, "StagingRingBuffer", s_Data->RingBuffer);
+
+		IR_CORE_INFO_TAG("Renderer", "UploadManager: {} staging ring, {}", Utils::BytesToString(s_Data->RingSize), s_Data->DedicatedTransferQueue ? "dedicated transfer queue" : "graphics queue");
+	}
+
+	void UploadManager::Shutdown()
+	{
+		vkDeviceWaitIdle(RendererContext::GetCurrentDevice()->GetVulkanDevice());
+
+		// A batch that was never flushed still has its command buffers in the recording state which is fine since the pools get destroyed
+		for (UploadBatch* batch : s_Data->Batches)
+			DestroyBatch(batch);
+
+		VulkanAllocator allocator("UploadManager");
+		allocator.UnmapMemory(s_Data->RingAllocation);
+		allocator.DestroyBuffer(s_Data->RingAllocation, s_Data->RingBuffer);
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void UploadManager::UploadBuffer(VkBuffer dstBuffer, const void* data, uint64_t size, uint64_t dstOffset)
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		UploadBatch* batch = GetCurrentBatch();
+		StagingAllocation staging = AllocateStaging(batch, data, size, s_StagingAlignment);
+
+		VkBufferCopy copyRegion = {
+			.srcOffset = staging.Offset,
+			.dstOffset = dstOffset,
+			.size = size
+		};
+		vkCmdCopyBuffer(batch->TransferCommandBuffer, staging.Buffer, dstBuffer, 1, &copyRegion);
+
+		if (s_Data->DedicatedTransferQueue)
+		{
+			Utils::InsertBufferOwnershipBarrier(batch->TransferCommandBuffer, dstBuffer, dstOffset, size, true);
+			Utils::InsertBufferOwnershipBarrier(batch->GraphicsCommandBuffer, dstBuffer, dstOffset, size, false);
+		}
+	}
+
+	void UploadManager::UploadImage(const ImageUploadInfo& uploadInfo, const std::function<void(VkCommandBuffer)>& graphicsCommands)
+	{
+		IR_ASSERT(uploadInfo.Image && uploadInfo.Data && uploadInfo.RegionCount > 0);
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		UploadBatch* batch = GetCurrentBatch();
+		StagingAllocation staging = AllocateStaging(batch, uploadInfo.Data, uploadInfo.Size, std::lcm<uint64_t>(s_StagingAlignment, uploadInfo.TexelSize));
+
+		std::vector<VkBufferImageCopy> copyRegions(uploadInfo.Regions, uploadInfo.Regions + uploadInfo.RegionCount);
+		for (VkBufferImageCopy& copyRegion : copyRegions)
+			copyRegion.bufferOffset += staging.Offset;
+
+		Renderer::InsertImageMemoryBarrier(
+			batch->TransferCommandBuffer,
+			uploadInfo.Image,
+			0,
+			VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			uploadInfo.SubresourceRange
+		);
+
+		vkCmdCopyBufferToImage(batch->TransferCommandBuffer, staging.Buffer, uploadInfo.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+
+		if (s_Data->DedicatedTransferQueue)
+		{
+			// The layout transition happens as part of the queue family ownership transfer
+			Utils::InsertImageOwnershipBarrier(batch->TransferCommandBuffer, uploadInfo.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uploadInfo.FinalLayout, true, uploadInfo.SubresourceRange);
+			Utils::InsertImageOwnershipBarrier(batch->GraphicsCommandBuffer, uploadInfo.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uploadInfo.FinalLayout, false, uploadInfo.SubresourceRange);
+		}
+		else
+		{
+			Renderer::InsertImageMemoryBarrier(
+				batch->TransferCommandBuffer,
+				uploadInfo.Image,
+				VK_ACCESS_2_TRANSFER_WRITE_BIT,
+				VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				uploadInfo.FinalLayout,
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+				uploadInfo.SubresourceRange
+			);
+		}
+
+		if (graphicsCommands)
+			graphicsCommands(batch->GraphicsCommandBuffer);
+	}
+
+	void UploadManager::RecordGraphicsCommands(const std::function<void(VkCommandBuffer)>& graphicsCommands)
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		UploadBatch* batch = GetCurrentBatch();
+		graphicsCommands(batch->GraphicsCommandBuffer);
+	}
+
+	void UploadManager::Flush(bool wait)
+	{
+		Ref<VulkanDevice> device = RendererContext::GetCurrentDevice();
+
+		UploadBatch* batch = nullptr;
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+			if (!s_Data->CurrentBatch)
+				return;
+
+			batch = s_Data->CurrentBatch;
+			s_Data->CurrentBatch = nullptr;
+			s_Data->RingAllocated = false;
+			batch->RingEnd = s_Data->RingHead;
+
+			// Makes the uploads visible to everything that is submitted to the graphics queue after this batch
+			Renderer::InsertMemoryBarrier(
+				batch->GraphicsCommandBuffer,
+				VK_ACCESS_2_MEMORY_WRITE_BIT,
+				VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+				VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+			);
+
+			VK_CHECK_RESULT(vkEndCommandBuffer(batch->TransferCommandBuffer));
+			if (s_Data->DedicatedTransferQueue)
+			{
+				VK_CHECK_RESULT(vkEndCommandBuffer(batch->GraphicsCommandBuffer));
+
+				// Only the UploadManager submits to the transfer queue and that is always done under its mutex
+				VkSubmitInfo transferSubmitInfo = {
+					.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+					.commandBufferCount = 1,
+					.pCommandBuffers = &batch->TransferCommandBuffer,
+					.signalSemaphoreCount = 1,
+					.pSignalSemaphores = &batch->TransferSemaphore
+				};
+				VK_CHECK_RESULT(vkQueueSubmit(device->GetTransferQueue(), 1, &transferSubmitInfo, VK_NULL_HANDLE));
+			}
+
+			VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			VkSubmitInfo submitInfo = {
+				.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+				.waitSemaphoreCount = s_Data->DedicatedTransferQueue ? 1u : 0u,
+				.pWaitSemaphores = &batch->TransferSemaphore,
+				.pWaitDstStageMask = &waitStage,
+				.commandBufferCount = 1,
+				.pCommandBuffers = &batch->GraphicsCommandBuffer
+			};
+
+			device->LockQueue();
+			VK_CHECK_RESULT(vkQueueSubmit(device->GetGraphicsQueue(), 1, &submitInfo, batch->Fence));
+			device->UnlockQueue();
+
+			s_Data->InFlightBatches.push_back(batch);
+		}
+
+		// Consumers on other queues (ex. the compute queue) are not ordered after the graphics queue so they wait on the CPU
+		if (wait)
+			VK_CHECK_RESULT(vkWaitForFences(device->GetVulkanDevice(), 1, &batch->Fence, VK_TRUE, UINT64_MAX));
+
+		Renderer::SubmitReseourceFree([batch]()
+		{
+			RetireBatch(batch);
+		});
+	}
+
+}
\ No newline at end of file
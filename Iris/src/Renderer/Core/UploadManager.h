@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <functional>
+
+/*
+ * Batches the staging uploads of buffers and textures instead of giving each one its own one time command buffer, vkQueueSubmit and fence wait
+ * - Staging memory is suballocated from a persistently mapped ring buffer, uploads that do not fit into the ring get their own staging buffer
+ * - Copies are recorded into the current batch and the batch is submitted by Flush, which is called right before every vkQueueSubmit
+ *   (render command buffers, swapchain, compute pipelines and one time command buffers) so anything submitted after an upload sees its data
+ * - With a dedicated transfer queue the copies run on it and the resources are handed over to the graphics queue family, the work that needs
+ *   the graphics queue (layout transitions of the final image, mip generation) goes into a second command buffer that waits on the transfer
+ * - Submitted batches are retired through Renderer::SubmitReseourceFree which gives their command buffers and ring space back
+ * - Uploads can be recorded from any thread (render thread, asset workers, texture streamer)
+ */
+
+namespace Iris {
+
+	struct ImageUploadInfo
+	{
+		VkImage Image = VK_NULL_HANDLE;
+		VkImageSubresourceRange SubresourceRange = {}; // Transitioned from UNDEFINED to TRANSFER_DST before the copy and to FinalLayout after it
+		VkImageLayout FinalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		const void* Data = nullptr;
+		uint64_t Size = 0;
+		uint32_t TexelSize = 4; // Staging offsets have to be a multiple of the texel size
+
+		const VkBufferImageCopy* Regions = nullptr; // Buffer offsets are relative to Data
+		uint32_t RegionCount = 0;
+	};
+
+	class UploadManager
+	{
+	public:
+		static void Init();
+		static void Shutdown();
+
+		// Copies data into staging memory and records the copy into dstBuffer. The buffer can be used by anything that is submitted afterwards
+		static void UploadBuffer(VkBuffer dstBuffer, const void* data, uint64_t size, uint64_t dstOffset = 0);
+		// Same as UploadBuffer for images. graphicsCommands is recorded on the graphics queue once the image is in its final layout (ex. mip generation)
+		static void UploadImage(const ImageUploadInfo& uploadInfo, const std::function<void(VkCommandBuffer)>& graphicsCommands = {});
+		// Records commands on the graphics queue of the current batch without uploading anything (ex. GPU side copies between images)
+		static void RecordGraphicsCommands(const std::function<void(VkCommandBuffer)>& graphicsCommands);
+
+		// Submits the recorded uploads ahead of the next vkQueueSubmit. Consumers that are not on the graphics queue have to wait for them
+		static void Flush(bool wait = false);
+	};
+
+}
\ No newline at end of file
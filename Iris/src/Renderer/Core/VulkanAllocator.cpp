@@ -16,6 +16,8 @@ namespace Iris {
 		uint64_t TotalAllocatedBytes = 0;
 
 		uint64_t MemoryUsage = 0; // All GPU heaps
+
+		std::mutex AllocationMapMutex; // Resources are also created/destroyed from the asset workers
 	};
 
 	static AllocatorStaticData* s_Data;
@@ -87,6 +89,7 @@ namespace Iris {
 		IR_CORE_TRACE_TAG("VulkanAllocator", "{}: Allocating buffer with size: {}", m_Name, Utils::BytesToString(allocInfo.size));
 #endif
 
+		std::scoped_lock<std::mutex> lock(s_Data->AllocationMapMutex);
 		s_AllocationMap[allocation] = {
 			.AllocatedSize = allocInfo.size,
 			.Type = AllocationType::Buffer
@@ -112,6 +115,7 @@ namespace Iris {
 
 		vmaDestroyBuffer(s_Data->Allocator, buffer, allocation);
 
+		std::scoped_lock<std::mutex> lock(s_Data->AllocationMapMutex);
 		auto it = s_AllocationMap.find(allocation);
 		if (it != s_AllocationMap.end())
 		{
@@ -149,6 +153,7 @@ namespace Iris {
 		IR_CORE_TRACE_TAG("VulkanAllocator", "{}: Allocating image with size: {}", m_Name, Utils::BytesToString(allocInfo.size));
 #endif
 
+		std::scoped_lock<std::mutex> lock(s_Data->AllocationMapMutex);
 		s_AllocationMap[allocation] = {
 			.AllocatedSize = allocInfo.size,
 			.Type = AllocationType::Image
@@ -171,6 +176,7 @@ namespace Iris {
 
 		vmaDestroyImage(s_Data->Allocator, image, allocation);
 
+		std::scoped_lock<std::mutex> lock(s_Data->AllocationMapMutex);
 		auto it = s_AllocationMap.find(allocation);
 		if (it != s_AllocationMap.end())
 		{
@@ -215,6 +221,7 @@ namespace Iris {
 		for (VmaBudget& b : budgets)
 			budget += b.budget;
 
+		std::scoped_lock<std::mutex> lock(s_Data->AllocationMapMutex);
 		for (const auto& [alloc, info] : s_AllocationMap)
 		{
 			stats.BufferAllocationCount++;
@@ -8,8 +8,13 @@
 #include "Texture.h"
 #include "UniformBufferSet.h"
 
+#include <atomic>
+
 namespace Iris {
 
+	// Bumped whenever a resource that can be bound recreates its Vulkan handles
+	static std::atomic<uint64_t> s_ResourceGeneration = 0;
+
 	namespace Utils {
 
 		inline constexpr DescriptorResourceType GetDefaultResourceType(VkDescriptorType type, spv::Dim dimension = spv::Dim::DimMax)
@@ -35,6 +40,85 @@ namespace Iris {
 			return DescriptorResourceType::None;
 		}
 
+		// The handle that ends up in the descriptor for element `index` of the input, nullptr if the resource has not been created yet
+		static void* GetInputResourceHandle(const RenderPassInput& input, uint32_t index, uint32_t frameIndex)
+		{
+			const Ref<RefCountedObject>& resource = input.Input[index];
+			if (!resource)
+				return nullptr;
+
+			switch (input.Type)
+			{
+				case DescriptorResourceType::UniformBuffer:		return resource.As<UniformBuffer>()->GetDescriptorBufferInfo().buffer;
+				case DescriptorResourceType::UniformBufferSet:	return resource.As<UniformBufferSet>()->Get(frameIndex)->GetDescriptorBufferInfo().buffer;
+				case DescriptorResourceType::StorageBuffer:		return resource.As<StorageBuffer>()->GetDescriptorBufferInfo().buffer;
+				case DescriptorResourceType::StorageBufferSet:	return resource.As<StorageBufferSet>()->Get(frameIndex)->GetDescriptorBufferInfo().buffer;
+				case DescriptorResourceType::Texture2D:			return resource.As<Texture2D>()->GetDescriptorImageInfo().imageView;
+				case DescriptorResourceType::TextureCube:		return resource.As<TextureCube>()->GetDescriptorImageInfo().imageView;
+				case DescriptorResourceType::ImageView:			return resource.As<ImageView>()->GetDescriptorImageInfo().imageView;
+				case DescriptorResourceType::StorageImage:		return nullptr; // TODO:
+			}
+
+			return nullptr;
+		}
+
+		// Points the write descriptor at the current resources of the input and remembers their handles. Returns false if one of them has not
+		// been created yet, the descriptor is then written by the update that follows its creation
+		static bool FillWriteDescriptor(const RenderPassInput& input, uint32_t frameIndex, DescriptorSetManager::WriteDescriptor& storedWriteDescriptor, std::vector<std::vector<VkDescriptorImageInfo>>& imageInfoStorage)
+		{
+			for (uint32_t i = 0; i < input.Input.size(); i++)
+			{
+				storedWriteDescriptor.ResourceHandles[i] = GetInputResourceHandle(input, i, frameIndex);
+				if (storedWriteDescriptor.ResourceHandles[i] == nullptr)
+					return false;
+			}
+
+			VkWriteDescriptorSet& writeDescriptor = storedWriteDescriptor.WriteDescriptorSet;
+			switch (input.Type)
+			{
+				case DescriptorResourceType::UniformBuffer:
+					writeDescriptor.pBufferInfo = &input.Input[0].As<UniformBuffer>()->GetDescriptorBufferInfo();
+					break;
+				case DescriptorResourceType::UniformBufferSet:
+					writeDescriptor.pBufferInfo = &input.Input[0].As<UniformBufferSet>()->Get(frameIndex)->GetDescriptorBufferInfo();
+					break;
+				case DescriptorResourceType::StorageBuffer:
+					writeDescriptor.pBufferInfo = &input.Input[0].As<StorageBuffer>()->GetDescriptorBufferInfo();
+					break;
+				case DescriptorResourceType::StorageBufferSet:
+					writeDescriptor.pBufferInfo = &input.Input[0].As<StorageBufferSet>()->Get(frameIndex)->GetDescriptorBufferInfo();
+					break;
+				case DescriptorResourceType::Texture2D:
+				{
+					if (input.Input.size() > 1)
+					{
+						std::vector<VkDescriptorImageInfo>& imageInfos = imageInfoStorage.emplace_back(input.Input.size());
+						for (uint32_t i = 0; i < input.Input.size(); i++)
+							imageInfos[i] = input.Input[i].As<Texture2D>()->GetDescriptorImageInfo();
+
+						writeDescriptor.pImageInfo = imageInfos.data();
+					}
+					else
+					{
+						writeDescriptor.pImageInfo = &input.Input[0].As<Texture2D>()->GetDescriptorImageInfo();
+					}
+
+					break;
+				}
+				case DescriptorResourceType::TextureCube:
+					writeDescriptor.pImageInfo = &input.Input[0].As<TextureCube>()->GetDescriptorImageInfo();
+					break;
+				case DescriptorResourceType::ImageView:
+					writeDescriptor.pImageInfo = &input.Input[0].As<ImageView>()->GetDescriptorImageInfo();
+					break;
+				case DescriptorResourceType::StorageImage:
+					// TODO:
+					return false;
+			}
+
+			return true;
+		}
+
 	}
 
 	DescriptorSetManager::DescriptorSetManager(const DescriptorSetManagerSpecification& spec)
@@ -43,6 +127,7 @@ namespace Iris {
 		Init();
 		if (m_Specification.TriggerCopy)
 		{
+			IR_ASSERT(m_Specification.ExistingInputResources.size() == m_InputResources.size());
 			m_InputResources = m_Specification.ExistingInputResources;
 		}
 	}
@@ -66,26 +151,48 @@ namespace Iris {
 	{
 		const std::vector<ShaderResources::ShaderDescriptorSet>& shaderDescriptorSets = m_Specification.Shader->GetShaderDescriptorSets();
 		uint32_t framesInFlight = Renderer::GetConfig().FramesInFlight;
-		m_WriteDescriptorMap.resize(framesInFlight);
+		m_WriteDescriptors.resize(framesInFlight);
+		m_FrameGenerations.resize(framesInFlight);
 
 		for (uint32_t set = m_Specification.StartingSet; set <= m_Specification.EndingSet; set++)
 		{
 			// If the set does not exist in the shader...
 			if (set >= shaderDescriptorSets.size())
-				return;
+				break;
 
 			const ShaderResources::ShaderDescriptorSet& shaderDescriptorSet = shaderDescriptorSets[set];
-			for (auto& [name, writeDescriptor] : shaderDescriptorSet.WriteDescriptorSets)
+
+			// Flattened in the order of the bindings so that every manager of the same shader agrees on the indices
+			std::map<uint32_t, std::string_view> bindings;
+			for (const auto& [name, writeDescriptor] : shaderDescriptorSet.WriteDescriptorSets)
+				bindings[writeDescriptor.dstBinding] = name;
+
+			if (bindings.empty())
+				continue;
+
+			m_InputSets.push_back({
+				.Set = set,
+				.FirstInput = static_cast<uint32_t>(m_InputDeclarations.size()),
+				.InputCount = static_cast<uint32_t>(bindings.size())
+			});
+
+			for (const auto& [binding, name] : bindings)
 			{
-				uint32_t binding = writeDescriptor.dstBinding;
+				const VkWriteDescriptorSet& writeDescriptor = shaderDescriptorSet.WriteDescriptorSets.at(std::string(name));
+				const uint32_t index = static_cast<uint32_t>(m_InputDeclarations.size());
 
-				RenderPassInputDeclaration& inputDeclaration = m_InputDeclarations[name];
+				const uint32_t nameHash = Hash::GenerateFNVHash(name);
+				IR_VERIFY(!m_InputDeclarationIndices.contains(nameHash), "Hash of input {} collides with {}", name, m_InputDeclarations[m_InputDeclarationIndices.at(nameHash)].Name);
+				m_InputDeclarationIndices[nameHash] = index;
+
+				RenderPassInputDeclaration& inputDeclaration = m_InputDeclarations.emplace_back();
 				inputDeclaration.Name = name;
 				inputDeclaration.Type = Utils::GetRenderPassInputTypeFromVkDescriptorType(writeDescriptor.descriptorType);
 				inputDeclaration.Set = set;
 				inputDeclaration.Binding = binding;
 				// The number of elements in the array or 1 if no array exists in the shader for this descriptor
 				inputDeclaration.Count = writeDescriptor.descriptorCount;
+				inputDeclaration.Index = index;
 
 				spv::Dim currentDimension = spv::Dim::DimMax;
 				if (shaderDescriptorSet.ImageSamplers.contains(binding))
@@ -133,11 +240,12 @@ namespace Iris {
 					}
 				}
 
+				RenderPassInput& input = m_InputResources.emplace_back();
+				input.Input.resize(writeDescriptor.descriptorCount);
+
 				if (m_Specification.DefaultResources)
 				{
-					RenderPassInput& input = m_InputResources[set][binding];
 					input.Type = Utils::GetDefaultResourceType(writeDescriptor.descriptorType, currentDimension);
-					input.Input.resize(writeDescriptor.descriptorCount);
 
 					// Set default textures
 					if (inputDeclaration.Type == RenderPassInputType::ImageSampler2D)
@@ -166,58 +274,43 @@ namespace Iris {
 				}
 
 				for (uint32_t frameIndex = 0; frameIndex < framesInFlight; frameIndex++)
-					m_WriteDescriptorMap[frameIndex][set][binding] = {
+					m_WriteDescriptors[frameIndex].push_back({
 						.WriteDescriptorSet = writeDescriptor,
 						.ResourceHandles = std::vector<void*>(writeDescriptor.descriptorCount)
-					};
+					});
 			}
 		}
+
+		m_InputGenerations.resize(m_InputResources.size());
 	}
 
 	bool DescriptorSetManager::Validate()
 	{
-		const std::vector<ShaderResources::ShaderDescriptorSet>& shaderDescriptorSets = m_Specification.Shader->GetShaderDescriptorSets();
-
-
-		for (uint32_t set = m_Specification.StartingSet; set <= m_Specification.EndingSet; set++)
+		for (const InputSet& inputSet : m_InputSets)
 		{
-			if (set >= shaderDescriptorSets.size())
-				break;
-
-			// If no descriptors are in the current set
-			if (!shaderDescriptorSets.at(set))
-				continue;
-
-			// Check for set availablity
-			if (!m_InputResources.contains(set))
+			for (uint32_t i = inputSet.FirstInput; i < inputSet.FirstInput + inputSet.InputCount; i++)
 			{
-				IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] No input resources for set: {}", m_Specification.DebugName, set);
-				return false;
-			}
+				const RenderPassInputDeclaration& declaration = m_InputDeclarations[i];
+				const RenderPassInput& resource = m_InputResources[i];
+				const VkDescriptorType descriptorType = m_WriteDescriptors[0][i].WriteDescriptorSet.descriptorType;
 
-			const std::map<uint32_t, RenderPassInput>& setInputResources = m_InputResources.at(set);
-			const ShaderResources::ShaderDescriptorSet& shaderDescriptor = shaderDescriptorSets.at(set);
-			for (auto& [name, writeDescriptor] : shaderDescriptor.WriteDescriptorSets)
-			{
 				// Check for binding availability
-				uint32_t binding = writeDescriptor.dstBinding;
-				if (!setInputResources.contains(binding))
+				if (resource.Type == DescriptorResourceType::None)
 				{
-					IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] No input resources for set: {} at binding: {}", m_Specification.DebugName, set, binding);
-					IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] Required input resource is: {} ({})", m_Specification.DebugName, name, Utils::VkDescriptorTypeToString(writeDescriptor.descriptorType));
+					IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] No input resources for set: {} at binding: {}", m_Specification.DebugName, declaration.Set, declaration.Binding);
+					IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] Required input resource is: {} ({})", m_Specification.DebugName, declaration.Name, Utils::VkDescriptorTypeToString(descriptorType));
 					return false;
 				}
 
-				const RenderPassInput& resource = setInputResources.at(binding);
-				if (!Utils::IsCompatibleInput(resource.Type, writeDescriptor.descriptorType))
+				if (!Utils::IsCompatibleInput(resource.Type, descriptorType))
 				{
-					IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] Incompatible input resource type (Provided: {}, Needed: {})", m_Specification.DebugName, Utils::DescriptorResourceTypeToString(resource.Type), Utils::VkDescriptorTypeToString(writeDescriptor.descriptorType));
+					IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] Incompatible input resource type (Provided: {}, Needed: {})", m_Specification.DebugName, Utils::DescriptorResourceTypeToString(resource.Type), Utils::VkDescriptorTypeToString(descriptorType));
 					return false;
 				}
 
 				if (resource.Input[0] == nullptr)
 				{
-					IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] Input resource is null! (name: {} set: {} binding: {})", m_Specification.DebugName, name, set, binding);
+					IR_CORE_ERROR_TAG("Renderer", "[RenderPass: ({})::Validate] Input resource is null! (name: {} set: {} binding: {})", m_Specification.DebugName, declaration.Name, declaration.Set, declaration.Binding);
 					return false;
 				}
 			}
@@ -270,8 +363,8 @@ namespace Iris {
 		// - Allocate DescriptorSets
 		// - Complete the write descriptors that were partially created in the shader and then call vkUpdateDescriptorSets
 
-		// Returns the sets that contain a UniformBufferSet/StorageBufferSet resource
-		std::set<uint32_t> bufferSets = HasBufferSets();
+		// Read before any of the handles so that a resource created while baking is picked up by the next update
+		const uint64_t resourceGeneration = s_ResourceGeneration.load();
 
 		// Add the per-frame DescriptorSet vectors...
 		for (uint32_t i = 0; i < descriptorSetCount; i++)
@@ -281,12 +374,12 @@ namespace Iris {
 		for (std::vector<VkDescriptorSet>& descriptorSet : m_DescriptorSets)
 			descriptorSet.clear();
 
-		for (const auto& [set, setData] : m_InputResources)
+		for (const InputSet& inputSet : m_InputSets)
 		{
 			// NOTE: Need to duplicate all the sets to the number of frames in flight.
 			// NOTE: In the future we should add the option to specify what sets should not be duplicated since they are static resources that
 			// do not get updated throughout the lifetime of the application
-			VkDescriptorSetLayout dsl = m_Specification.Shader->GetDescriptorSetLayout(set);
+			VkDescriptorSetLayout dsl = m_Specification.Shader->GetDescriptorSetLayout(inputSet.Set);
 			for (uint32_t frameIndex = 0; frameIndex < descriptorSetCount; frameIndex++)
 			{
 				VkDescriptorSetAllocateInfo allocInfo = {
@@ -300,370 +393,70 @@ namespace Iris {
 				VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet));
 				m_DescriptorSets[frameIndex].emplace_back(descriptorSet); // Store the per-frame DescriptorSets
 
-				std::map<uint32_t, WriteDescriptor>& writeDescriptorMap = m_WriteDescriptorMap[frameIndex].at(set);
+				std::vector<VkWriteDescriptorSet> writeDescriptors;
 				std::vector<std::vector<VkDescriptorImageInfo>> imageInfoStorage;
-				uint32_t imageInfoStorageIndex = 0;
-
-				for (const auto& [binding, input] : setData)
+				for (uint32_t i = inputSet.FirstInput; i < inputSet.FirstInput + inputSet.InputCount; i++)
 				{
-					WriteDescriptor& storedWriteDescriptor = writeDescriptorMap.at(binding);
-
 					// The write descriptor in the shader where filled with: `dstBinding`, `descriptorCount`, `descriptorType`
-					VkWriteDescriptorSet& writeDescriptor = storedWriteDescriptor.WriteDescriptorSet;
-					writeDescriptor.dstSet = descriptorSet;
-					
-					switch (input.Type)
-					{
-						case DescriptorResourceType::UniformBuffer:
-						{
-							Ref<UniformBuffer> uniformBuffer = input.Input[0];
-							writeDescriptor.pBufferInfo = &uniformBuffer->GetDescriptorBufferInfo();
-							storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pBufferInfo->buffer;
-
-							// Defer the resource if it does not exist yet...
-							if (writeDescriptor.pBufferInfo->buffer == nullptr)
-								m_InvalidatedInputResources[set][binding] = input;
-
-							break;
-						}
-						case DescriptorResourceType::UniformBufferSet:
-						{
-							Ref<UniformBufferSet> uniformBufferSet = input.Input[0];
-							writeDescriptor.pBufferInfo = &uniformBufferSet->Get(frameIndex)->GetDescriptorBufferInfo();
-							storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pBufferInfo->buffer;
-
-							// Defer the resource if it does not exist yet...
-							if (writeDescriptor.pBufferInfo->buffer == nullptr)
-								m_InvalidatedInputResources[set][binding] = input;
+					WriteDescriptor& storedWriteDescriptor = m_WriteDescriptors[frameIndex][i];
+					storedWriteDescriptor.WriteDescriptorSet.dstSet = descriptorSet;
 
-							break;
-						}
-						case DescriptorResourceType::StorageBuffer:
-						{
-							Ref<StorageBuffer> storageBuffer = input.Input[0];
-							writeDescriptor.pBufferInfo = &storageBuffer->GetDescriptorBufferInfo();
-							storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pBufferInfo->buffer;
-
-							// Defer the resource if it does not exist yet...
-							if (writeDescriptor.pBufferInfo->buffer == nullptr)
-								m_InvalidatedInputResources[set][binding] = input;
-
-							break;
-						}
-						case DescriptorResourceType::StorageBufferSet:
-						{
-							Ref<StorageBufferSet> storageBufferSet = input.Input[0];
-							writeDescriptor.pBufferInfo = &storageBufferSet->Get(frameIndex)->GetDescriptorBufferInfo();
-							storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pBufferInfo->buffer;
-
-							// Defer the resource if it does not exist yet...
-							if (writeDescriptor.pBufferInfo->buffer == nullptr)
-								m_InvalidatedInputResources[set][binding] = input;
-
-							break;
-						}
-						case DescriptorResourceType::Texture2D:
-						{
-							if (input.Input.size() > 1)
-							{
-								imageInfoStorage.emplace_back(input.Input.size());
-								for (uint32_t i = 0; i < input.Input.size(); i++)
-								{
-									Ref<Texture2D> texture = input.Input[i];
-									imageInfoStorage[imageInfoStorageIndex][i] = texture->GetDescriptorImageInfo();
-								}
-								writeDescriptor.pImageInfo = imageInfoStorage[imageInfoStorageIndex].data();
-								++imageInfoStorageIndex;
-							}
-							else
-							{
-								Ref<Texture2D> texture = input.Input[0];
-								writeDescriptor.pImageInfo = &texture->GetDescriptorImageInfo();
-							}
-
-							storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pImageInfo->imageView;
-
-							// Defer the resource if it does not exist yet...
-							if (writeDescriptor.pImageInfo->imageView == nullptr)
-								m_InvalidatedInputResources[set][binding] = input;
-
-							break;
-						}
-						case DescriptorResourceType::TextureCube:
-						{
-							Ref<TextureCube> textureCube = input.Input[0];
-							writeDescriptor.pImageInfo = &textureCube->GetDescriptorImageInfo();
-							storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pImageInfo->imageView;
-
-							// Defer the resource if it does not exist...
-							if (writeDescriptor.pImageInfo->imageView == nullptr)
-								m_InvalidatedInputResources[set][binding] = input;
-
-							break;
-						}
-						case DescriptorResourceType::ImageView:
-						{
-							Ref<ImageView> imageView = input.Input[0].As<ImageView>();
-
-							// Defer the resource if it does not exist...
-							if (imageView == nullptr)
-							{
-								m_InvalidatedInputResources[set][binding] = input;
-								break;
-							}
-
-							writeDescriptor.pImageInfo = &imageView->GetDescriptorImageInfo();
-							storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pImageInfo->imageView;
-
-							// Defer the resource if it does not exist...
-							if (writeDescriptor.pImageInfo->imageView == nullptr)
-								m_InvalidatedInputResources[set][binding] = input;
-
-							break;
-						}
-						case DescriptorResourceType::StorageImage:
-						{
-							// TODO:
-							//Ref<StorageImage> storageImage = input.Input[0];
-							//if (storageImage == nullptr)
-							//{
-							//	// Defer the resource if it does not exist...
-							//	m_InvalidatedInputResources[set][binding] = input;
-							//	break;
-							//}
-
-							//writeDescriptor.pImageInfo = &storageImage->GetDescriptorImageInfo();
-							//storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pImageInfo->imageView;
-
-							//// Defer the resource if it does not exist...
-							//if (writeDescriptor.pImageInfo->imageView == nullptr)
-							//	m_InvalidatedInputResources[set][binding] = input;
-
-							break;
-						}
-					}
-				}
-
-				std::vector<VkWriteDescriptorSet> writeDescriptors;
-				for (const auto& [binding, writeDescriptor] : writeDescriptorMap)
-				{
 					// Include if valid otherwise we defer it (untill when we want to use that way the resources are created)
-					if (!IsInvalidated(set, binding))
-						writeDescriptors.emplace_back(writeDescriptor.WriteDescriptorSet);
+					if (Utils::FillWriteDescriptor(m_InputResources[i], frameIndex, storedWriteDescriptor, imageInfoStorage))
+						writeDescriptors.emplace_back(storedWriteDescriptor.WriteDescriptorSet);
 				}
 
 				if (!writeDescriptors.empty())
 				{
-					IR_CORE_INFO_TAG("Renderer", "[RenderPass ({})::Bake] update {} descriptors in set {}", m_Specification.DebugName, writeDescriptors.size(), set);
+					IR_CORE_INFO_TAG("Renderer", "[RenderPass ({})::Bake] update {} descriptors in set {}", m_Specification.DebugName, writeDescriptors.size(), inputSet.Set);
 					vkUpdateDescriptorSets(device, (uint32_t)writeDescriptors.size(), writeDescriptors.data(), 0, nullptr);
 				}
 			}
 		}
+
+		for (FrameGeneration& frameGeneration : m_FrameGenerations)
+			frameGeneration = { .Input = m_InputGeneration, .Resource = resourceGeneration };
 	}
 
 	void DescriptorSetManager::InvalidateAndUpdate()
 	{
-		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
 		uint32_t currentFrameIndex = Renderer::RT_GetCurrentFrameIndex();
+		FrameGeneration& frameGeneration = m_FrameGenerations[currentFrameIndex];
 
-		// Check for invalidated resources...
-		for (const auto& [set, inputs] : m_InputResources)
-		{
-			for (const auto& [binding, renderPassInput] : inputs)
-			{
-				switch (renderPassInput.Type)
-				{
-					case DescriptorResourceType::UniformBuffer:
-					{
-						Ref<UniformBuffer> uniformBuffer = renderPassInput.Input[0].As<UniformBuffer>();
-						const VkDescriptorBufferInfo& bufferInfo = uniformBuffer->GetDescriptorBufferInfo();
-						if (bufferInfo.buffer != m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding).ResourceHandles[0])
-							m_InvalidatedInputResources[set][binding] = renderPassInput;
-
-						break;
-					}
-					case DescriptorResourceType::UniformBufferSet:
-					{
-						Ref<UniformBufferSet> uniformBufferSet = renderPassInput.Input[0].As<UniformBufferSet>();
-						const VkDescriptorBufferInfo& bufferInfo = uniformBufferSet->Get(currentFrameIndex)->GetDescriptorBufferInfo();
-						if (bufferInfo.buffer != m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding).ResourceHandles[0])
-							m_InvalidatedInputResources[set][binding] = renderPassInput;
-
-						break;
-					}
-					case DescriptorResourceType::StorageBuffer:
-					{
-						Ref<StorageBuffer> storageBuffer = renderPassInput.Input[0].As<StorageBuffer>();
-						const VkDescriptorBufferInfo& bufferInfo = storageBuffer->GetDescriptorBufferInfo();
-						if (bufferInfo.buffer != m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding).ResourceHandles[0])
-							m_InvalidatedInputResources[set][binding] = renderPassInput;
-
-						break;
-					}
-					case DescriptorResourceType::StorageBufferSet:
-					{
-						Ref<StorageBufferSet> storageBufferSet = renderPassInput.Input[0].As<StorageBufferSet>();
-						const VkDescriptorBufferInfo& bufferInfo = storageBufferSet->Get(currentFrameIndex)->GetDescriptorBufferInfo();
-						if (bufferInfo.buffer != m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding).ResourceHandles[0])
-							m_InvalidatedInputResources[set][binding] = renderPassInput;
-
-						break;
-					}
-					case DescriptorResourceType::Texture2D:
-					{
-						for (std::size_t i = 0; i < renderPassInput.Input.size(); i++)
-						{
-							Ref<Texture2D> texture = renderPassInput.Input[i].As<Texture2D>();
-							const VkDescriptorImageInfo& imageInfo = texture->GetDescriptorImageInfo();
-							if (imageInfo.imageView != m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding).ResourceHandles[i])
-							{
-								m_InvalidatedInputResources[set][binding] = renderPassInput;
-								break;
-							}
-						}
-
-						break;
-					}
-					case DescriptorResourceType::TextureCube:
-					{
-						Ref<TextureCube> textureCube = renderPassInput.Input[0].As<TextureCube>();
-						const VkDescriptorImageInfo& imageInfo = textureCube->GetDescriptorImageInfo();
-						if (imageInfo.imageView != m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding).ResourceHandles[0])
-							m_InvalidatedInputResources[set][binding] = renderPassInput;
-
-						break;
-					}
-					case DescriptorResourceType::ImageView:
-					{
-						Ref<ImageView> imageView = renderPassInput.Input[0].As<ImageView>();
-						const VkDescriptorImageInfo& imageInfo = imageView->GetDescriptorImageInfo();
-						if (imageInfo.imageView != m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding).ResourceHandles[0])
-							m_InvalidatedInputResources[set][binding] = renderPassInput;
-
-						break;
-					}
-					case DescriptorResourceType::StorageImage:
-					{
-						// TODO:
-						//Ref<StorageImage> storageImage = renderPassInput.Input[0].As<StorageImage>();
-						//const VkDescriptorImageInfo& imageInfo = storageImage->GetDescriptorImageInfo();
-						//if (imageInfo.imageView != m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding).ResourceHandles[0])
-						//	m_InvalidatedInputResources[set][binding] = renderPassInput;
-
-						break;
-					}
-				}
-			}
-		}
-
-		// Nothing to do
-		if (m_InvalidatedInputResources.empty())
+		// Nothing was set and no resource got recreated since the sets of this frame were last written
+		const uint64_t resourceGeneration = s_ResourceGeneration.load();
+		if (frameGeneration.Input == m_InputGeneration && frameGeneration.Resource == resourceGeneration)
 			return;
 
-		// Returns the sets that contain a UniformBufferSet/StorageBufferSet resource
-		std::set<uint32_t> bufferSets = HasBufferSets();
+		// Only the inputs set since then need their handles compared, unless some resource got recreated which could be any of them
+		const bool resourcesInvalidated = frameGeneration.Resource != resourceGeneration;
 
-		for (const auto& [set, setData] : m_InvalidatedInputResources)
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		for (const InputSet& inputSet : m_InputSets)
 		{
 			std::vector<VkWriteDescriptorSet> writeDescriptorSetsToUpdate;
-			writeDescriptorSetsToUpdate.reserve(setData.size());
-
 			std::vector<std::vector<VkDescriptorImageInfo>> imageInfoStorage;
-			uint32_t imageInfoStorageIndex = 0;
-			for (const auto& [binding, input] : setData)
+			for (uint32_t i = inputSet.FirstInput; i < inputSet.FirstInput + inputSet.InputCount; i++)
 			{
-				WriteDescriptor& storedWriteDescriptor = m_WriteDescriptorMap[currentFrameIndex].at(set).at(binding);
+				if (!resourcesInvalidated && m_InputGenerations[i] <= frameGeneration.Input)
+					continue;
 
-				VkWriteDescriptorSet& writeDescriptor = storedWriteDescriptor.WriteDescriptorSet;
-				switch (input.Type)
-				{
-					case DescriptorResourceType::UniformBuffer:
-					{
-						Ref<UniformBuffer> uniformBuffer = input.Input[0].As<UniformBuffer>();
-						writeDescriptor.pBufferInfo = &uniformBuffer->GetDescriptorBufferInfo();
-						storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pBufferInfo->buffer;
-
-						break;
-					}
-					case DescriptorResourceType::UniformBufferSet:
-					{
-						Ref<UniformBufferSet> uniformBufferSet = input.Input[0].As<UniformBufferSet>();
-						writeDescriptor.pBufferInfo = &uniformBufferSet->Get(currentFrameIndex)->GetDescriptorBufferInfo();
-						storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pBufferInfo->buffer;
-
-						break;
-					}
-					case DescriptorResourceType::StorageBuffer:
-					{
-						Ref<StorageBuffer> storageBuffer = input.Input[0].As<StorageBuffer>();
-						writeDescriptor.pBufferInfo = &storageBuffer->GetDescriptorBufferInfo();
-						storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pBufferInfo->buffer;
+				const RenderPassInput& input = m_InputResources[i];
+				WriteDescriptor& storedWriteDescriptor = m_WriteDescriptors[currentFrameIndex][i];
 
-						break;
-					}
-					case DescriptorResourceType::StorageBufferSet:
-					{
-						Ref<StorageBufferSet> storageBufferSet = input.Input[0].As<StorageBufferSet>();
-						writeDescriptor.pBufferInfo = &storageBufferSet->Get(currentFrameIndex)->GetDescriptorBufferInfo();
-						storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pBufferInfo->buffer;
-
-						break;
-					}
-					case DescriptorResourceType::Texture2D:
-					{
-						if (input.Input.size() > 1)
-						{
-							imageInfoStorage.emplace_back(input.Input.size());
-							for (uint32_t i = 0; i < input.Input.size(); i++)
-							{
-								Ref<Texture2D> texture = input.Input[i].As<Texture2D>();
-								imageInfoStorage[imageInfoStorageIndex][i] = texture->GetDescriptorImageInfo();
-								storedWriteDescriptor.ResourceHandles[i] = imageInfoStorage[imageInfoStorageIndex][i].imageView;
-							}
-							writeDescriptor.pImageInfo = imageInfoStorage[imageInfoStorageIndex].data();
-							++imageInfoStorageIndex;
-						}
-						else
-						{
-							Ref<Texture2D> texture = input.Input[0].As<Texture2D>();
-							writeDescriptor.pImageInfo = &texture->GetDescriptorImageInfo();
-							storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pImageInfo->imageView;
-						}
-
-						break;
-					}
-					case DescriptorResourceType::TextureCube:
-					{
-						Ref<TextureCube> textureCube = input.Input[0].As<TextureCube>();
-						writeDescriptor.pImageInfo = &textureCube->GetDescriptorImageInfo();
-						storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pImageInfo->imageView;
+				bool invalidated = false;
+				for (uint32_t j = 0; j < input.Input.size(); j++)
+					invalidated |= Utils::GetInputResourceHandle(input, j, currentFrameIndex) != storedWriteDescriptor.ResourceHandles[j];
 
-						break;
-					}
-					case DescriptorResourceType::ImageView:
-					{
-						Ref<ImageView> imageView = input.Input[0].As<ImageView>();
-						writeDescriptor.pImageInfo = &imageView->GetDescriptorImageInfo();
-						IR_VERIFY(writeDescriptor.pImageInfo->imageView);
-						storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pImageInfo->imageView;
-
-						break;
-					}
-					case DescriptorResourceType::StorageImage:
-					{
-						// TODO:
-						//Ref<StorageImage> storageImage = input.Input[0];
-						//writeDescriptor.pImageInfo = &storageImage->GetDescriptorImageInfo();
-						//storedWriteDescriptor.ResourceHandles[0] = writeDescriptor.pImageInfo->imageView;
+				if (invalidated && Utils::FillWriteDescriptor(input, currentFrameIndex, storedWriteDescriptor, imageInfoStorage))
+					writeDescriptorSetsToUpdate.emplace_back(storedWriteDescriptor.WriteDescriptorSet);
+			}
 
-						break;
-					}
-				}
+			// Nothing to do
+			if (writeDescriptorSetsToUpdate.empty())
+				continue;
 
-				writeDescriptorSetsToUpdate.emplace_back(writeDescriptor);
-			}
-			
-			IR_CORE_INFO_TAG("Renderer", "[RenderPass ({})::InvalidateAndUpdate] updating {} descriptors in set {} (frameIndex = {})", m_Specification.DebugName, writeDescriptorSetsToUpdate.size(), set, currentFrameIndex);
+			IR_CORE_INFO_TAG("Renderer", "[RenderPass ({})::InvalidateAndUpdate] updating {} descriptors in set {} (frameIndex = {})", m_Specification.DebugName, writeDescriptorSetsToUpdate.size(), inputSet.Set, currentFrameIndex);
 			vkUpdateDescriptorSets(
 				device, 
 				static_cast<uint32_t>(writeDescriptorSetsToUpdate.size()),
@@ -672,110 +465,127 @@ namespace Iris {
 			);
 		}
 
-		m_InvalidatedInputResources.clear();
+		frameGeneration = { .Input = m_InputGeneration, .Resource = resourceGeneration };
+	}
+
+	void DescriptorSetManager::OnResourceInvalidated()
+	{
+		s_ResourceGeneration++;
+	}
+
+	uint64_t DescriptorSetManager::GetResourceGeneration()
+	{
+		return s_ResourceGeneration.load();
 	}
 
 	void DescriptorSetManager::SetInput(std::string_view name, Ref<UniformBuffer> uniformBuffer)
 	{
-		const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
+		const RenderPassInputDeclaration* decl = GetInputDeclaration(Hash::GenerateFNVHash(name));
 		if (decl)
-			m_InputResources.at(decl->Set).at(decl->Binding).Set(uniformBuffer);
+			SetInputResource(*decl, uniformBuffer);
 		else
 			IR_CORE_ERROR_TAG("Renderer", "[RenderPass ({})::SetInput] Input {} not found!", m_Specification.DebugName, name);
 	}
 
 	void DescriptorSetManager::SetInput(std::string_view name, Ref<UniformBufferSet> uniformBufferSet)
 	{
-		const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
+		const RenderPassInputDeclaration* decl = GetInputDeclaration(Hash::GenerateFNVHash(name));
 		if (decl)
-			m_InputResources.at(decl->Set).at(decl->Binding).Set(uniformBufferSet);
+			SetInputResource(*decl, uniformBufferSet);
 		else
 			IR_CORE_ERROR_TAG("Renderer", "[RenderPass ({})::SetInput] Input {} not found!", m_Specification.DebugName, name);
 	}
 
 	void DescriptorSetManager::SetInput(std::string_view name, Ref<StorageBuffer> storageBuffer)
 	{
-		const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
+		const RenderPassInputDeclaration* decl = GetInputDeclaration(Hash::GenerateFNVHash(name));
 		if (decl)
-			m_InputResources.at(decl->Set).at(decl->Binding).Set(storageBuffer);
+			SetInputResource(*decl, storageBuffer);
 		else
 			IR_CORE_ERROR_TAG("Renderer", "[RenderPass ({})::SetInput] Input {} not found!", m_Specification.DebugName, name);
 	}
 
 	void DescriptorSetManager::SetInput(std::string_view name, Ref<StorageBufferSet> storageBufferSet)
 	{
-		const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
+		const RenderPassInputDeclaration* decl = GetInputDeclaration(Hash::GenerateFNVHash(name));
 		if (decl)
-			m_InputResources.at(decl->Set).at(decl->Binding).Set(storageBufferSet);
+			SetInputResource(*decl, storageBufferSet);
 		else
 			IR_CORE_ERROR_TAG("Renderer", "[RenderPass ({})::SetInput] Input {} not found!", m_Specification.DebugName, name);
 	}
 
 	void DescriptorSetManager::SetInput(std::string_view name, Ref<Texture2D> texture, uint32_t index)
 	{
-		const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
-
-		IR_ASSERT(index < decl->Count);
-
-		if (decl)
-			m_InputResources.at(decl->Set).at(decl->Binding).Set(texture, index);
-		else
+		if (!SetInput(Hash::GenerateFNVHash(name), texture, index))
 			IR_CORE_ERROR_TAG("Renderer", "[RenderPass ({})::SetInput] Input {} not found!", m_Specification.DebugName, name);
 	}
 
 	void DescriptorSetManager::SetInput(std::string_view name, Ref<TextureCube> textureCube)
 	{
-		const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
-
-		if (decl)
-			m_InputResources.at(decl->Set).at(decl->Binding).Set(textureCube);
-		else
+		if (!SetInput(Hash::GenerateFNVHash(name), textureCube))
 			IR_CORE_ERROR_TAG("Renderer", "[RenderPass ({})::SetInput] Input {} not found!", m_Specification.DebugName, name);
 	}
 
 	void DescriptorSetManager::SetInput(std::string_view name, Ref<ImageView> imageView)
 	{
-		const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
-
-		if (decl)
-			m_InputResources.at(decl->Set).at(decl->Binding).Set(imageView);
-		else
+		if (!SetInput(Hash::GenerateFNVHash(name), imageView))
 			IR_CORE_ERROR_TAG("Renderer", "[RenderPass ({})::SetInput] Input {} not found!", m_Specification.DebugName, name);
 	}
 
+	bool DescriptorSetManager::SetInput(uint32_t nameHash, Ref<Texture2D> texture, uint32_t index)
+	{
+		const RenderPassInputDeclaration* decl = GetInputDeclaration(nameHash);
+		if (!decl)
+			return false;
+
+		IR_ASSERT(index < decl->Count);
+		SetInputResource(*decl, texture, index);
+		return true;
+	}
+
+	bool DescriptorSetManager::SetInput(uint32_t nameHash, Ref<TextureCube> textureCube)
+	{
+		const RenderPassInputDeclaration* decl = GetInputDeclaration(nameHash);
+		if (!decl)
+			return false;
+
+		SetInputResource(*decl, textureCube);
+		return true;
+	}
+
+	bool DescriptorSetManager::SetInput(uint32_t nameHash, Ref<ImageView> imageView)
+	{
+		const RenderPassInputDeclaration* decl = GetInputDeclaration(nameHash);
+		if (!decl)
+			return false;
+
+		SetInputResource(*decl, imageView);
+		return true;
+	}
+
 	// TODO:
 	//void DescriptorSetManager::SetInput(std::string_view name, Ref<StorageImage> storageImage, uint32_t index)
 	//{
-	//	const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
+	//	const RenderPassInputDeclaration* decl = GetInputDeclaration(Hash::GenerateFNVHash(name));
 
 	//	if (decl)
-	//		m_InputResources.at(decl->Set).at(decl->Binding).Set(storageImage, index);
+	//		SetInputResource(*decl, storageImage, index);
 	//	else
 	//		IR_CORE_ERROR_TAG("Renderer", "[RenderPass ({})::SetInput] Input {} not found!", m_Specification.DebugName, name);
 	//}
 
-	bool DescriptorSetManager::IsInvalidated(uint32_t set, uint32_t binding) const
-	{
-		if (m_InvalidatedInputResources.contains(set))
-		{
-			const auto& resource = m_InvalidatedInputResources.at(set);
-			return resource.contains(binding);
-		}
-
-		return false;
-	}
-
 	std::set<uint32_t> DescriptorSetManager::HasBufferSets() const
 	{
 		std::set<uint32_t> result;
 
-		for (auto& [set, data] : m_InputResources)
+		for (const InputSet& inputSet : m_InputSets)
 		{
-			for (auto& [binding, input] : data)
+			for (uint32_t i = inputSet.FirstInput; i < inputSet.FirstInput + inputSet.InputCount; i++)
 			{
+				const RenderPassInput& input = m_InputResources[i];
 				if (input.Type == DescriptorResourceType::UniformBufferSet || input.Type == DescriptorResourceType::StorageBufferSet)
 				{
-					result.insert(set);
+					result.insert(inputSet.Set);
 					break;
 				}
 			}
@@ -791,10 +601,10 @@ namespace Iris {
 
 	uint32_t DescriptorSetManager::GetFirstSetIndex() const
 	{
-		if (m_InputResources.empty())
+		if (m_InputSets.empty())
 			return UINT32_MAX;
 
-		return m_InputResources.begin()->first; // returning the first key which is the first set index
+		return m_InputSets.front().Set;
 	}
 
 	const std::vector<VkDescriptorSet>& DescriptorSetManager::GetDescriptorSets(uint32_t frameIndex) const
@@ -807,14 +617,12 @@ namespace Iris {
 		return m_DescriptorSets[frameIndex];
 	}
 
-	const RenderPassInputDeclaration* DescriptorSetManager::GetInputDeclaration(std::string_view name) const
+	const RenderPassInputDeclaration* DescriptorSetManager::GetInputDeclaration(uint32_t nameHash) const
 	{
-		std::string nameStr = std::string(name);
-
-		if (!m_InputDeclarations.contains(nameStr))
+		auto it = m_InputDeclarationIndices.find(nameHash);
+		if (it == m_InputDeclarationIndices.end())
 			return nullptr;
 
-		const RenderPassInputDeclaration* declaration = &(m_InputDeclarations.at(nameStr));
-		return declaration;
+		return &m_InputDeclarations[it->second];
 	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Core/Base.h"
+#include "Core/Hash.h"
 
 #include <vulkan/vulkan.h>
 
@@ -242,6 +243,7 @@ namespace Iris {
 		uint32_t Set = 0;
 		uint32_t Binding = 0;
 		uint32_t Count = 0;
+		uint32_t Index = 0; // Into the flattened inputs of the DescriptorSetManager
 	};
 
 	struct DescriptorSetManagerSpecification
@@ -261,10 +263,10 @@ namespace Iris {
 		uint32_t EndingSet = 3;
 
 		// TriggerCopy determines whether we copy the ExistingInputResources when creating the DescriptorSetManager
-		// We can not use whether the ExistingInputResources map is empty or not as a flag since an empty map is a valid state where the shader does not have any 
-		// input resources
+		// We can not use whether the ExistingInputResources vector is empty or not as a flag since an empty vector is a valid state where the shader does not have any 
+		// input resources. They have to come from a manager of the same shader (see GetInputResources)
 		bool TriggerCopy = false;
-		std::map<uint32_t, std::map<uint32_t, RenderPassInput>> ExistingInputResources;
+		std::vector<RenderPassInput> ExistingInputResources;
 	};
 
 	class DescriptorSetManager
@@ -277,6 +279,14 @@ namespace Iris {
 			std::vector<void*> ResourceHandles;
 		};
 
+		// The inputs of one of the managed sets, they sit next to each other in the flattened arrays
+		struct InputSet
+		{
+			uint32_t Set = 0;
+			uint32_t FirstInput = 0;
+			uint32_t InputCount = 0;
+		};
+
 	public:
 		DescriptorSetManager() = default;
 		DescriptorSetManager(const DescriptorSetManagerSpecification& spec);
@@ -284,8 +294,14 @@ namespace Iris {
 
 		bool Validate();
 		void Bake();
+		// Only writes the descriptors of the current frame whose inputs were set or whose resources got recreated since it last ran
 		void InvalidateAndUpdate();
 
+		// Has to be called whenever a resource that can be bound recreates its Vulkan handles (buffer, image view). Until then the managers
+		// take the handles they wrote as still valid
+		static void OnResourceInvalidated();
+		static uint64_t GetResourceGeneration();
+
 		void SetInput(std::string_view name, Ref<UniformBuffer> uniformBuffer);
 		void SetInput(std::string_view name, Ref<UniformBufferSet> uniformBufferSet);
 		void SetInput(std::string_view name, Ref<StorageBuffer> storageBuffer);
@@ -293,44 +309,59 @@ namespace Iris {
 		void SetInput(std::string_view name, Ref<Texture2D> texture, uint32_t index = 0);
 		void SetInput(std::string_view name, Ref<TextureCube> textureCube);
 		void SetInput(std::string_view name, Ref<ImageView> imageView);
+		// Same as above with the name already hashed (see MaterialParam), returns false if the shader has no such input
+		bool SetInput(uint32_t nameHash, Ref<Texture2D> texture, uint32_t index = 0);
+		bool SetInput(uint32_t nameHash, Ref<TextureCube> textureCube);
+		bool SetInput(uint32_t nameHash, Ref<ImageView> imageView);
 		// TODO: 
 		//void SetInput(std::string_view name, Ref<StorageImage> storageImage, uint32_t index = 0);
 
 		template<typename T>
 		Ref<T> GetInput(std::string_view name)
 		{
-			const RenderPassInputDeclaration* decl = GetInputDeclaration(name);
+			return GetInput<T>(Hash::GenerateFNVHash(name));
+		}
+
+		template<typename T>
+		Ref<T> GetInput(uint32_t nameHash)
+		{
+			const RenderPassInputDeclaration* decl = GetInputDeclaration(nameHash);
 			if (decl)
-			{
-				auto setIt = m_InputResources.find(decl->Set);
-				if (setIt != m_InputResources.end())
-				{
-					auto resourceIt = setIt->second.find(decl->Binding);
-					if (resourceIt != setIt->second.end())
-						return resourceIt->second.Input[0];
-				}
-			}
+				return m_InputResources[decl->Index].Input[0];
 
 			return nullptr;
 		}
 
-		bool IsInvalidated(uint32_t set, uint32_t binding) const;
-
 		// Finds descriptor sets that have a set of buffers (UniformBufferSet, ...) descriptors
 		std::set<uint32_t> HasBufferSets() const;
 		bool HasDescriptorSets() const;
 		uint32_t GetFirstSetIndex() const;
 		const std::vector<VkDescriptorSet>& GetDescriptorSets(uint32_t frameIndex) const;
-		const std::map<std::string, RenderPassInputDeclaration>& GetInputDeclarations() const { return m_InputDeclarations; }
+		const std::vector<RenderPassInputDeclaration>& GetInputDeclarations() const { return m_InputDeclarations; }
 
 		VkDescriptorPool GetDescriptorPool() const { return m_DescriptorPool; }
 
-		const std::map<uint32_t, std::map<uint32_t, RenderPassInput>>& GetInputResources() const { return m_InputResources; }
+		// Indexed by RenderPassInputDeclaration::Index
+		const std::vector<RenderPassInput>& GetInputResources() const { return m_InputResources; }
 
 	private:
 		void Init();
 		void Release();
-		const RenderPassInputDeclaration* GetInputDeclaration(std::string_view name) const;
+		const RenderPassInputDeclaration* GetInputDeclaration(uint32_t nameHash) const;
+
+		template<typename T>
+		void SetInputResource(const RenderPassInputDeclaration& decl, const Ref<T>& resource, uint32_t index = 0)
+		{
+			RenderPassInput& input = m_InputResources[decl.Index];
+			const bool unchanged = input.Type != DescriptorResourceType::None && input.Input[index].Raw() == resource.Raw();
+
+			const DescriptorResourceType previousType = input.Type;
+			input.Set(resource, index);
+			if (unchanged && input.Type == previousType)
+				return;
+
+			m_InputGenerations[decl.Index] = ++m_InputGeneration;
+		}
 
 	private:
 		DescriptorSetManagerSpecification m_Specification;
@@ -339,14 +370,26 @@ namespace Iris {
 		// Frame in flight -> set
 		std::vector<std::vector<VkDescriptorSet>> m_DescriptorSets;
 
-		// Input resources (Set -> Binding -> Resource)
-		std::map<uint32_t, std::map<uint32_t, RenderPassInput>> m_InputResources;
-		// This is to store whether any resources where invalidated during the frame and whether we need to update the write descriptors
-		std::map<uint32_t, std::map<uint32_t, RenderPassInput>> m_InvalidatedInputResources;
-		std::map<std::string, RenderPassInputDeclaration> m_InputDeclarations;
+		// Inputs are flattened in the order of the reflected sets and bindings, every array below is indexed by RenderPassInputDeclaration::Index
+		std::vector<InputSet> m_InputSets;
+		std::vector<RenderPassInputDeclaration> m_InputDeclarations;
+		std::vector<RenderPassInput> m_InputResources;
+		std::unordered_map<uint32_t, uint32_t> m_InputDeclarationIndices; // Hash of the name -> index
+
+		// Frame in flight -> input
+		std::vector<std::vector<WriteDescriptor>> m_WriteDescriptors;
+
+		// Bumped by every SetInput that changes an input, which then remembers the generation it was changed at
+		uint64_t m_InputGeneration = 0;
+		std::vector<uint64_t> m_InputGenerations;
 
-		// Frame in flight -> set -> binding -> WriteDescriptor
-		std::vector<std::map<uint32_t, std::map<uint32_t, WriteDescriptor>>> m_WriteDescriptorMap;
+		// The input generation and the global resource generation the sets of a frame in flight were last written at
+		struct FrameGeneration
+		{
+			uint64_t Input = 0;
+			uint64_t Resource = 0;
+		};
+		std::vector<FrameGeneration> m_FrameGenerations;
 
 		friend class RenderPass;
 		friend class ComputePass;
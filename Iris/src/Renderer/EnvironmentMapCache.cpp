@@ -0,0 +1,455 @@
+#include "IrisPCH.h"
+#include "EnvironmentMapCache.h"
+
+#include "Core/Hash.h"
+#include "Core/WorkerPool.h"
+#include "Project/Project.h"
+#include "Renderer/Core/RendererContext.h"
+#include "Renderer/Core/UploadManager.h"
+#include "Renderer/Core/Vulkan.h"
+#include "Renderer/Core/VulkanAllocator.h"
+#include "Renderer/Renderer.h"
+#include "Scene/SceneEnvironment.h"
+#include "Serialization/FileStream.h"
+#include "Utils/FileSystem.h"
+
+namespace Iris {
+
+	// Has to be bumped whenever the layout of the file or the way the maps are generated changes
+	static constexpr uint32_t s_EnvironmentMapCacheVersion = 3;
+	static constexpr char s_EnvironmentMapCacheIdentifier[8] = { 'I', 'R', 'E', 'N', 'V', 'M', 'A', 'P' };
+
+	struct EnvironmentMapCacheHeader
+	{
+		char Identifier[8];
+		uint32_t Version;
+		uint32_t ImageCount; // 1 when the irradiance is only stored as spherical harmonics
+		EnvironmentMapCacheKey Key;
+		SHCoefficients IrradianceSH;
+	};
+
+	// Same idea as the KTX2 header, one for each cubemap in the file
+	struct EnvironmentMapCacheImage
+	{
+		uint32_t Format; // ImageFormat
+		uint32_t PixelWidth;
+		uint32_t PixelHeight;
+		uint32_t FaceCount;
+		uint32_t LevelCount;
+		uint32_t FirstLevel; // Index of mip 0 in the level index
+	};
+
+	struct EnvironmentMapCacheLevel
+	{
+		uint64_t ByteOffset; // From the start of the file
+		uint64_t ByteLength; // All six faces
+	};
+
+	// Cubemaps that are being copied into a staging buffer, both maps go into the same one with the irradiance map after the radiance map
+	struct EnvironmentMapReadback
+	{
+		EnvironmentMapCacheKey Key;
+		Ref<Environment> TargetEnvironment;
+		std::filesystem::path CachePath; // Resolved when the read back is recorded so it ends up in that project's cache, empty if nothing gets written
+
+		VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+		VkFence Fence = VK_NULL_HANDLE;
+		VkBuffer StagingBuffer = VK_NULL_HANDLE;
+		VmaAllocation StagingAllocation = nullptr;
+
+		uint64_t RadianceSize = 0;
+		uint64_t IrradianceSize = 0; // 0 when the irradiance map is not stored
+	};
+
+	// Only touched by the render thread, and by Shutdown once it is gone
+	static VkCommandPool s_ReadbackCommandPool = VK_NULL_HANDLE;
+	static std::vector<EnvironmentMapReadback> s_PendingReadbacks;
+
+	namespace Utils {
+
+		static std::filesystem::path GetEnvironmentMapCachePath(const EnvironmentMapCacheKey& key)
+		{
+			return Project::GetCacheDirectory() / "EnvironmentMaps" / fmt::format("{:016x}_{}_{}.irenv", key.SourceHash, key.Resolution, key.IrradianceSamples);
+		}
+
+		// Holds the source hash of the file the path hash was created from
+		static std::filesystem::path GetSourceHashPath(const EnvironmentMapCacheKey& key)
+		{
+			return Project::GetCacheDirectory() / "EnvironmentMaps" / "Sources" / fmt::format("{:016x}", key.PathHash);
+		}
+
+		static uint64_t GetCubemapLevelSize(const Ref<TextureCube>& cubemap, uint32_t mip)
+		{
+			const glm::ivec2 size = cubemap->GetMipSize(mip);
+			return static_cast<uint64_t>(size.x) * size.y * GetImageFormatBPP(cubemap->GetFormat()) * 6;
+		}
+
+		static void WriteEntry(const std::filesystem::path& cachePath, const EnvironmentMapCacheHeader& header, const std::vector<EnvironmentMapCacheImage>& images,
+			const std::vector<EnvironmentMapCacheLevel>& levels, const Buffer& mipData)
+		{
+			std::filesystem::create_directories(cachePath.parent_path());
+
+			// Written to a temporary file first so that a crash halfway through never leaves a truncated entry behind
+			std::filesystem::path tempPath = cachePath;
+			tempPath += ".tmp";
+			{
+				FileStreamWriter stream(tempPath, true);
+				if (!stream)
+				{
+					IR_CORE_ERROR_TAG("Renderer", "Failed to cache environment map to {}", cachePath);
+					return;
+				}
+
+				stream.WriteRaw<EnvironmentMapCacheHeader>(header);
+				stream.WriteData(reinterpret_cast<const uint8_t*>(images.data()), images.size() * sizeof(EnvironmentMapCacheImage));
+				stream.WriteData(reinterpret_cast<const uint8_t*>(levels.data()), levels.size() * sizeof(EnvironmentMapCacheLevel));
+				stream.WriteData(mipData.Data, mipData.Size);
+			}
+
+			std::error_code error;
+			std::filesystem::rename(tempPath, cachePath, error);
+			if (error)
+			{
+				IR_CORE_ERROR_TAG("Renderer", "Failed to cache environment map to {}: {}", cachePath, error.message());
+				std::filesystem::remove(tempPath, error);
+				return;
+			}
+
+			IR_CORE_TRACE_TAG("Renderer", "Cached environment map to {}", cachePath);
+		}
+
+		// Expects the fence of the read back to be signaled
+		static void FinishReadback(EnvironmentMapReadback& readback)
+		{
+			VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+			VulkanAllocator allocator("EnvironmentMapCache");
+
+			// The maps are laid out in the staging buffer exactly like they are in the file
+			Buffer mipData;
+			mipData.Allocate(readback.RadianceSize + readback.IrradianceSize);
+			const uint8_t* stagingData = allocator.MapMemory<uint8_t>(readback.StagingAllocation);
+			std::memcpy(mipData.Data, stagingData, mipData.Size);
+			allocator.UnmapMemory(readback.StagingAllocation);
+
+			allocator.DestroyBuffer(readback.StagingAllocation, readback.StagingBuffer);
+			vkDestroyFence(device, readback.Fence, nullptr);
+			vkFreeCommandBuffers(device, s_ReadbackCommandPool, 1, &readback.CommandBuffer);
+
+			const EnvironmentMapCacheKey& key = readback.Key;
+			const Ref<Environment>& environment = readback.TargetEnvironment;
+			const bool storeIrradianceMap = key.IrradianceSamples != 0;
+			if (!storeIrradianceMap)
+			{
+				Timer timer;
+				environment->IrradianceSH = SphericalHarmonics::ProjectIrradiance(mipData.Data, environment->RadianceMap->GetWidth());
+				environment->HasIrradianceSH = true;
+				IR_CORE_TRACE_TAG("Renderer", "Projected environment irradiance to spherical harmonics in {:.2f}ms", timer.ElapsedMillis());
+			}
+
+			if (readback.CachePath.empty())
+			{
+				mipData.Release();
+				return;
+			}
+
+			const uint32_t imageCount = storeIrradianceMap ? 2 : 1;
+			const Ref<TextureCube> cubemaps[2] = { environment->RadianceMap, environment->IrradianceMap };
+
+			EnvironmentMapCacheHeader header = {
+				.Version = s_EnvironmentMapCacheVersion,
+				.ImageCount = imageCount,
+				.Key = key,
+				.IrradianceSH = environment->IrradianceSH
+			};
+			std::memcpy(header.Identifier, s_EnvironmentMapCacheIdentifier, sizeof(s_EnvironmentMapCacheIdentifier));
+
+			std::vector<EnvironmentMapCacheImage> images(imageCount);
+			std::vector<EnvironmentMapCacheLevel> levels;
+			for (uint32_t i = 0; i < imageCount; i++)
+			{
+				images[i] = {
+					.Format = static_cast<uint32_t>(cubemaps[i]->GetFormat()),
+					.PixelWidth = cubemaps[i]->GetWidth(),
+					.PixelHeight = cubemaps[i]->GetHeight(),
+					.FaceCount = 6,
+					.LevelCount = cubemaps[i]->GetMipLevelCount(),
+					.FirstLevel = static_cast<uint32_t>(levels.size())
+				};
+
+				for (uint32_t mip = 0; mip < images[i].LevelCount; mip++)
+					levels.push_back({ .ByteLength = GetCubemapLevelSize(cubemaps[i], mip) });
+			}
+
+			uint64_t dataOffset = sizeof(EnvironmentMapCacheHeader) + imageCount * sizeof(EnvironmentMapCacheImage) + levels.size() * sizeof(EnvironmentMapCacheLevel);
+			for (EnvironmentMapCacheLevel& level : levels)
+			{
+				level.ByteOffset = dataOffset;
+				dataOffset += level.ByteLength;
+			}
+
+			// Nothing left that needs the render thread, the file gets written on a worker
+			WorkerPool::Submit([cachePath = readback.CachePath, header, images = std::move(images), levels = std::move(levels), mipData]() mutable
+			{
+				WriteEntry(cachePath, header, images, levels, mipData);
+				mipData.Release();
+			});
+		}
+
+	}
+
+	EnvironmentMapCacheKey EnvironmentMapCache::CreateKey(const std::filesystem::path& sourcePath)
+	{
+		EnvironmentMapCacheKey key = {
+			.Resolution = Renderer::GetConfig().EnvironmentMapResolution,
+			.IrradianceSamples = Renderer::GetConfig().SphericalHarmonicsIrradiance ? 0 : Renderer::GetConfig().IrradianceMapComputeSamples
+		};
+
+		if (!Project::GetActive())
+			return key;
+
+		std::error_code error;
+		const uint64_t fileSize = std::filesystem::file_size(sourcePath, error);
+		if (error)
+			return key;
+
+		const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(sourcePath, error);
+		if (error)
+			return key;
+
+		const std::string fileIdentity = fmt::format("{}|{}|{}", std::filesystem::absolute(sourcePath).generic_string(), fileSize, lastWriteTime.time_since_epoch().count());
+		key.PathHash = Hash::GenerateFNVHash64(fileIdentity);
+
+		const std::filesystem::path sourceHashPath = Utils::GetSourceHashPath(key);
+		if (FileSystem::Exists(sourceHashPath))
+		{
+			Buffer sourceHash = FileSystem::ReadBytes(sourceHashPath);
+			if (sourceHash.Size == sizeof(uint64_t))
+				key.SourceHash = sourceHash.Read<uint64_t>();
+
+			sourceHash.Release();
+		}
+
+		return key;
+	}
+
+	bool EnvironmentMapCache::SetSourceData(EnvironmentMapCacheKey& key, const Buffer& sourceData)
+	{
+		if (key.PathHash == 0 || !sourceData)
+			return false;
+
+		const uint64_t sourceHash = Hash::GenerateFNVHash64(std::string_view(reinterpret_cast<const char*>(sourceData.Data), sourceData.Size));
+		if (sourceHash == key.SourceHash)
+			return false;
+
+		key.SourceHash = sourceHash;
+
+		const std::filesystem::path sourceHashPath = Utils::GetSourceHashPath(key);
+		std::filesystem::create_directories(sourceHashPath.parent_path());
+		if (!FileSystem::WriteBytes(sourceHashPath, Buffer(reinterpret_cast<const uint8_t*>(&key.SourceHash), sizeof(uint64_t))))
+			IR_CORE_WARN_TAG("Renderer", "Failed to write the environment map source hash to {}", sourceHashPath);
+
+		return true;
+	}
+
+	Ref<Environment> EnvironmentMapCache::TryLoad(const EnvironmentMapCacheKey& key)
+	{
+		if (key.SourceHash == 0)
+			return nullptr;
+
+		const std::filesystem::path cachePath = Utils::GetEnvironmentMapCachePath(key);
+		if (!FileSystem::Exists(cachePath))
+			return nullptr;
+
+		Timer timer;
+
+		Buffer fileData = FileSystem::ReadBytes(cachePath);
+
+		// Without an irradiance convolution the irradiance only lives in the spherical harmonics of the header
+		const uint32_t imageCount = key.IrradianceSamples == 0 ? 1 : 2;
+
+		const auto* header = reinterpret_cast<const EnvironmentMapCacheHeader*>(fileData.Data);
+		const bool validHeader = fileData.Size >= sizeof(EnvironmentMapCacheHeader)
+			&& std::memcmp(header->Identifier, s_EnvironmentMapCacheIdentifier, sizeof(s_EnvironmentMapCacheIdentifier)) == 0
+			&& header->Version == s_EnvironmentMapCacheVersion
+			&& header->ImageCount == imageCount
+			// The path hash is not compared, copies of the same image share an entry
+			&& header->Key.SourceHash == key.SourceHash && header->Key.Resolution == key.Resolution && header->Key.IrradianceSamples == key.IrradianceSamples
+			&& fileData.Size >= sizeof(EnvironmentMapCacheHeader) + imageCount * sizeof(EnvironmentMapCacheImage);
+
+		if (!validHeader)
+		{
+			IR_CORE_WARN_TAG("Renderer", "Environment map cache {} is out of date or corrupted, regenerating it", cachePath);
+			fileData.Release();
+			return nullptr;
+		}
+
+		const auto* images = reinterpret_cast<const EnvironmentMapCacheImage*>(fileData.Data + sizeof(EnvironmentMapCacheHeader));
+		const uint64_t levelIndexOffset = sizeof(EnvironmentMapCacheHeader) + imageCount * sizeof(EnvironmentMapCacheImage);
+		const auto* levels = reinterpret_cast<const EnvironmentMapCacheLevel*>(fileData.Data + levelIndexOffset);
+
+		const char* debugNames[2] = { "RadianceMap", "IrradianceMap" };
+		Ref<TextureCube> cubemaps[2];
+		for (uint32_t i = 0; i < imageCount; i++)
+		{
+			const EnvironmentMapCacheImage& image = images[i];
+			const uint64_t imageLevelsEnd = levelIndexOffset + static_cast<uint64_t>(image.FirstLevel + image.LevelCount) * sizeof(EnvironmentMapCacheLevel);
+			if (image.FaceCount != 6 || image.LevelCount == 0 || imageLevelsEnd > fileData.Size)
+				break;
+
+			TextureSpecification spec = {
+				.DebugName = debugNames[i],
+				.Width = image.PixelWidth,
+				.Height = image.PixelHeight,
+				.Format = static_cast<ImageFormat>(image.Format)
+			};
+			Ref<TextureCube> cubemap = TextureCube::Create(spec);
+			if (cubemap->GetMipLevelCount() != image.LevelCount)
+				break;
+
+			// The levels of an image are written one after the other so they can be uploaded in one go
+			const EnvironmentMapCacheLevel* imageLevels = levels + image.FirstLevel;
+			uint64_t dataSize = 0;
+			bool validLevels = true;
+			for (uint32_t mip = 0; mip < image.LevelCount; mip++)
+			{
+				validLevels &= imageLevels[mip].ByteOffset == imageLevels[0].ByteOffset + dataSize;
+				validLevels &= imageLevels[mip].ByteLength == Utils::GetCubemapLevelSize(cubemap, mip);
+				dataSize += imageLevels[mip].ByteLength;
+			}
+
+			if (!validLevels || imageLevels[0].ByteOffset + dataSize > fileData.Size)
+				break;
+
+			cubemap->CopyFromHostBufer(Buffer(fileData.Data + imageLevels[0].ByteOffset, dataSize), image.LevelCount);
+			cubemaps[i] = cubemap;
+		}
+
+		const SHCoefficients irradianceSH = header->IrradianceSH;
+		fileData.Release();
+
+		if (!cubemaps[0] || (imageCount == 2 && !cubemaps[1]))
+		{
+			IR_CORE_WARN_TAG("Renderer", "Environment map cache {} is corrupted, regenerating it", cachePath);
+			return nullptr;
+		}
+
+		Ref<Environment> environment = Environment::Create(cubemaps[0], imageCount == 2 ? cubemaps[1] : Renderer::GetBlackCubeTexture());
+		if (imageCount == 1)
+		{
+			environment->IrradianceSH = irradianceSH;
+			environment->HasIrradianceSH = true;
+		}
+
+		IR_CORE_INFO_TAG("Renderer", "Loaded environment map from cache {} in {:.2f}ms", cachePath, timer.ElapsedMillis());
+		return environment;
+	}
+
+	void EnvironmentMapCache::Shutdown()
+	{
+		// The device is idle by now so every read back is done, the entries still get written to the cache of the project they were stored for
+		for (EnvironmentMapReadback& readback : s_PendingReadbacks)
+			Utils::FinishReadback(readback);
+
+		s_PendingReadbacks.clear();
+
+		if (s_ReadbackCommandPool)
+		{
+			vkDestroyCommandPool(RendererContext::GetCurrentDevice()->GetVulkanDevice(), s_ReadbackCommandPool, nullptr);
+			s_ReadbackCommandPool = VK_NULL_HANDLE;
+		}
+	}
+
+	void EnvironmentMapCache::RT_Store(const EnvironmentMapCacheKey& key, const Ref<Environment>& environment)
+	{
+		const bool storeIrradianceMap = key.IrradianceSamples != 0;
+		if (key.SourceHash == 0 && storeIrradianceMap)
+			return;
+
+		Ref<VulkanDevice> device = RendererContext::GetCurrentDevice();
+		VkDevice vulkanDevice = device->GetVulkanDevice();
+
+		// The command buffers can stay in flight for longer than the per frame pools of the device live, so they get their own pool
+		if (!s_ReadbackCommandPool)
+		{
+			VkCommandPoolCreateInfo commandPoolInfo = {
+				.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+				.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+				.queueFamilyIndex = static_cast<uint32_t>(device->GetPhysicalDevice()->GetQueueFamilyIndices().Graphics)
+			};
+			VK_CHECK_RESULT(vkCreateCommandPool(vulkanDevice, &commandPoolInfo, nullptr, &s_ReadbackCommandPool));
+		}
+
+		// The spherical harmonics are projected from the same read back that gets cached, so this also happens when the source could not be hashed
+		EnvironmentMapReadback readback = {
+			.Key = key,
+			.TargetEnvironment = environment,
+			.CachePath = key.SourceHash != 0 && Project::GetActive() ? Utils::GetEnvironmentMapCachePath(key) : std::filesystem::path(),
+			.RadianceSize = environment->RadianceMap->GetMipChainSize(),
+			.IrradianceSize = storeIrradianceMap ? environment->IrradianceMap->GetMipChainSize() : 0
+		};
+
+		VulkanAllocator allocator("EnvironmentMapCache");
+		VkBufferCreateInfo stagingBufferCI = {
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.size = readback.RadianceSize + readback.IrradianceSize,
+			.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE
+		};
+		readback.StagingAllocation = allocator.AllocateBuffer(&stagingBufferCI, VMA_MEMORY_USAGE_GPU_TO_CPU, &readback.StagingBuffer);
+
+		VkCommandBufferAllocateInfo allocateInfo = {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+			.commandPool = s_ReadbackCommandPool,
+			.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+			.commandBufferCount = 1
+		};
+		VK_CHECK_RESULT(vkAllocateCommandBuffers(vulkanDevice, &allocateInfo, &readback.CommandBuffer));
+
+		VkCommandBufferBeginInfo beginInfo = {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+		};
+		VK_CHECK_RESULT(vkBeginCommandBuffer(readback.CommandBuffer, &beginInfo));
+		environment->RadianceMap->RecordCopyToBuffer(readback.CommandBuffer, readback.StagingBuffer);
+		if (storeIrradianceMap)
+			environment->IrradianceMap->RecordCopyToBuffer(readback.CommandBuffer, readback.StagingBuffer, readback.RadianceSize);
+		VK_CHECK_RESULT(vkEndCommandBuffer(readback.CommandBuffer));
+
+		VkFenceCreateInfo fenceInfo = { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+		VK_CHECK_RESULT(vkCreateFence(vulkanDevice, &fenceInfo, nullptr, &readback.Fence));
+
+		VkSubmitInfo submitInfo = {
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+			.commandBufferCount = 1,
+			.pCommandBuffers = &readback.CommandBuffer
+		};
+
+		UploadManager::Flush();
+
+		device->LockQueue();
+		VK_CHECK_RESULT(vkQueueSubmit(device->GetGraphicsQueue(), 1, &submitInfo, readback.Fence));
+		device->UnlockQueue();
+
+		s_PendingReadbacks.push_back(readback);
+	}
+
+	void EnvironmentMapCache::RT_Update()
+	{
+		if (s_PendingReadbacks.empty())
+			return;
+
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		for (auto it = s_PendingReadbacks.begin(); it != s_PendingReadbacks.end();)
+		{
+			if (vkGetFenceStatus(device, it->Fence) != VK_SUCCESS)
+			{
+				it++;
+				continue;
+			}
+
+			Utils::FinishReadback(*it);
+			it = s_PendingReadbacks.erase(it);
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Renderer/Texture.h"
+#include "Scene/SceneEnvironment.h"
+
+/*
+ * Keeps the radiance and irradiance cubemaps generated by Renderer::CreateEnvironmentMap in the project cache so that later loads of the same
+ * environment only have to upload them instead of running the conversion, prefiltering and convolution passes again
+ * - Entries are keyed by the hash of the source image and the settings the maps were generated with (EnvironmentMapResolution and IrradianceMapComputeSamples)
+ * - Hashing the contents means reading the whole image so the source hash of every file is remembered next to the entries under the file's path,
+ *   size and last write time. A lookup only touches the file's metadata, the contents are only hashed (from the data that gets loaded anyway)
+ *   when that misses, which also finds the entry of a file that was copied or touched without changing
+ * - The maps are read back without stalling, RT_Update writes the entry out once the copy's fence is signaled in a later frame
+ * - With SphericalHarmonicsIrradiance there is no irradiance cubemap, the projected coefficients are stored in the header instead
+ * - Each entry is one file laid out like a KTX2 container: a header, one descriptor per cubemap, a level index and then the mip data with
+ *   the six faces of every mip next to each other
+ */
+
+namespace Iris {
+
+	struct EnvironmentMapCacheKey
+	{
+		uint64_t PathHash = 0; // Path, size and last write time of the source, 0 if it does not exist
+		uint64_t SourceHash = 0; // Hash of the source contents, 0 until it is known and nothing gets cached without it
+		uint32_t Resolution = 0;
+		uint32_t IrradianceSamples = 0; // 0 when the irradiance is projected to spherical harmonics instead
+	};
+
+	class EnvironmentMapCache
+	{
+	public:
+		static void Shutdown();
+
+		// Only looks at the metadata of the source, the source hash is filled in if the same file was hashed before
+		static EnvironmentMapCacheKey CreateKey(const std::filesystem::path& sourcePath);
+		// Hashes the contents of the source that was read for the lookup that missed and remembers the hash for the key's path.
+		// Returns false if that is the source hash the key already had, so there is no point in trying to load it again
+		static bool SetSourceData(EnvironmentMapCacheKey& key, const Buffer& sourceData);
+
+		// Returns nullptr if there is no valid entry for the key
+		static Ref<Environment> TryLoad(const EnvironmentMapCacheKey& key);
+		// Records the read back of the cubemaps after they have been generated, the entry is written by RT_Update once it is done.
+		// Also projects the environment's spherical harmonics from the read back when the key asks for them
+		static void RT_Store(const EnvironmentMapCacheKey& key, const Ref<Environment>& environment);
+		// Called every frame, finishes the read backs whose fence got signaled
+		static void RT_Update();
+	};
+
+}
\ No newline at end of file
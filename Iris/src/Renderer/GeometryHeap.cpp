@@ -0,0 +1,417 @@
+#include "IrisPCH.h"
+#include "GeometryHeap.h"
+
+#include "Renderer/Core/UploadManager.h"
+#include "Renderer/Core/VulkanAllocator.h"
+#include "Renderer/Mesh/Mesh.h"
+#include "Renderer.h"
+
+#include <bit>
+
+namespace Iris {
+
+	static constexpr uint32_t s_InitialVertexCapacity = 1 << 18;
+	static constexpr uint32_t s_InitialIndexCapacity = 1 << 20;
+	static constexpr uint64_t s_DefragmentBudget = 4 * 1024 * 1024; // Bytes that get moved per frame at most
+
+	// Coalescing free list over a range of elements, best fit through a second map that is keyed by the size of the free ranges
+	class GeometryRangeAllocator
+	{
+	public:
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetFreeRangeCount() const { return static_cast<uint32_t>(m_FreeByOffset.size()); }
+
+		void Grow(uint32_t capacity)
+		{
+			IR_ASSERT(capacity > m_Capacity);
+			Free(m_Capacity, capacity - m_Capacity);
+			m_Capacity = capacity;
+		}
+
+		bool Allocate(uint32_t count, uint32_t& outOffset)
+		{
+			auto it = m_FreeBySize.lower_bound(count);
+			if (it == m_FreeBySize.end())
+				return false;
+
+			const auto [size, offset] = *it;
+			Take(offset, size, count);
+			outOffset = offset;
+			return true;
+		}
+
+		// Lowest free range that can hold count elements and starts before limit
+		bool AllocateBelow(uint32_t count, uint32_t limit, uint32_t& outOffset)
+		{
+			for (const auto [offset, size] : m_FreeByOffset)
+			{
+				if (offset >= limit)
+					return false;
+
+				if (size >= count)
+				{
+					Take(offset, size, count);
+					outOffset = offset;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void Free(uint32_t offset, uint32_t count)
+		{
+			auto next = m_FreeByOffset.lower_bound(offset);
+			if (next != m_FreeByOffset.end() && offset + count == next->first)
+			{
+				const auto [nextOffset, nextSize] = *next;
+				count += nextSize;
+				Remove(nextOffset, nextSize);
+			}
+
+			auto prev = m_FreeByOffset.lower_bound(offset);
+			if (prev != m_FreeByOffset.begin())
+			{
+				--prev;
+				const auto [prevOffset, prevSize] = *prev;
+				if (prevOffset + prevSize == offset)
+				{
+					offset = prevOffset;
+					count += prevSize;
+					Remove(prevOffset, prevSize);
+				}
+			}
+
+			Insert(offset, count);
+		}
+
+	private:
+		void Take(uint32_t offset, uint32_t size, uint32_t count)
+		{
+			Remove(offset, size);
+			if (size > count)
+				Insert(offset + count, size - count);
+		}
+
+		void Insert(uint32_t offset, uint32_t size)
+		{
+			m_FreeByOffset[offset] = size;
+			m_FreeBySize.emplace(size, offset);
+		}
+
+		void Remove(uint32_t offset, uint32_t size)
+		{
+			m_FreeByOffset.erase(offset);
+
+			auto [begin, end] = m_FreeBySize.equal_range(size);
+			for (auto it = begin; it != end; ++it)
+			{
+				if (it->second == offset)
+				{
+					m_FreeBySize.erase(it);
+					break;
+				}
+			}
+		}
+
+	private:
+		uint32_t m_Capacity = 0;
+
+		std::map<uint32_t, uint32_t> m_FreeByOffset;
+		std::multimap<uint32_t, uint32_t> m_FreeBySize;
+	};
+
+	struct GeometryRange
+	{
+		uint32_t Offset = 0;
+		uint32_t Count = 0;
+	};
+
+	struct ReleasedRange
+	{
+		GeometryRange Range;
+		uint64_t ReleasedFrame;
+	};
+
+	// The vertices and the indices each get one of these
+	struct GeometryPool
+	{
+		const char* Name = nullptr;
+		uint32_t Stride = 0;
+		VkBufferUsageFlags Usage = 0;
+
+		VkBuffer Buffer = nullptr;
+		VmaAllocation Allocation = nullptr;
+
+		GeometryRangeAllocator Allocator;
+		std::map<uint32_t, uint32_t> LiveRanges; // Offset -> handle, the last one is what gets moved first
+		std::vector<ReleasedRange> ReleasedRanges;
+	};
+
+	enum GeometryPoolType : uint32_t
+	{
+		VertexPool = 0,
+		IndexPool = 1,
+		PoolCount
+	};
+
+	struct GeometryEntry
+	{
+		GeometryRange Ranges[PoolCount];
+		const void* Data[PoolCount] = {};
+		bool Live = false;
+	};
+
+	struct GeometryHeapData
+	{
+		std::mutex Mutex;
+		uint64_t FrameNumber = 0;
+
+		GeometryPool Pools[PoolCount];
+
+		std::vector<GeometryEntry> Entries;
+		std::vector<uint32_t> FreeHandles;
+	};
+
+	static GeometryHeapData* s_Data = nullptr;
+
+	namespace Utils {
+
+		static void CreatePoolBuffer(GeometryPool& pool, uint32_t capacity)
+		{
+			VkBufferCreateInfo bufferCI = {
+				.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+				.size = static_cast<VkDeviceSize>(capacity) * pool.Stride,
+				.usage = pool.Usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				.sharingMode = VK_SHARING_MODE_EXCLUSIVE
+			};
+
+			VulkanAllocator allocator("GeometryHeap");
+			pool.Allocation = allocator.AllocateBuffer(&bufferCI, VMA_MEMORY_USAGE_GPU_ONLY, &pool.Buffer);
+		}
+
+		static void UploadRange(const GeometryPool& pool, const GeometryRange& range, const void* data)
+		{
+			UploadManager::UploadBuffer(pool.Buffer, data, static_cast<uint64_t>(range.Count) * pool.Stride, static_cast<uint64_t>(range.Offset) * pool.Stride);
+		}
+
+		// Has to be called with the mutex locked
+		static void GrowPool(GeometryPool& pool, uint32_t requiredCount)
+		{
+			const uint32_t capacity = pool.Allocator.GetCapacity();
+			const uint32_t newCapacity = std::bit_ceil(std::max(capacity * 2, capacity + requiredCount));
+
+			Renderer::SubmitReseourceFree([buffer = pool.Buffer, allocation = pool.Allocation]()
+			{
+				VulkanAllocator allocator("GeometryHeap");
+				allocator.DestroyBuffer(allocation, buffer);
+			});
+
+			CreatePoolBuffer(pool, newCapacity);
+			pool.Allocator.Grow(newCapacity);
+
+			// Live ranges keep their offsets. Released ranges are only read by frames that bound the old buffer, which stays alive until they are done
+			const uint32_t poolType = static_cast<uint32_t>(&pool - s_Data->Pools);
+			for (const auto [offset, handle] : pool.LiveRanges)
+			{
+				const GeometryEntry& entry = s_Data->Entries[handle];
+				UploadRange(pool, entry.Ranges[poolType], entry.Data[poolType]);
+			}
+
+			IR_CORE_INFO_TAG("Renderer", "Geometry heap: grew the {} buffer to {} MB", pool.Name, (static_cast<uint64_t>(newCapacity) * pool.Stride) / (1024 * 1024));
+		}
+
+		// Has to be called with the mutex locked
+		static GeometryRange AllocateRange(GeometryPool& pool, uint32_t count)
+		{
+			GeometryRange range = { .Count = count };
+			if (!pool.Allocator.Allocate(count, range.Offset))
+			{
+				GrowPool(pool, count);
+				bool allocated = pool.Allocator.Allocate(count, range.Offset);
+				IR_VERIFY(allocated);
+			}
+
+			return range;
+		}
+
+		static void RetireReleasedRanges(GeometryPool& pool)
+		{
+			// The render thread lags a frame behind and every frame in flight could still be drawing from the range
+			const uint64_t framesInFlight = Renderer::GetConfig().FramesInFlight;
+			std::erase_if(pool.ReleasedRanges, [&](const ReleasedRange& released)
+			{
+				if (s_Data->FrameNumber - released.ReleasedFrame <= framesInFlight)
+					return false;
+
+				pool.Allocator.Free(released.Range.Offset, released.Range.Count);
+				return true;
+			});
+		}
+
+		// Moves the allocations at the end of the pool down into the lowest hole they fit in, returns the bytes that were moved
+		static uint64_t DefragmentPool(GeometryPool& pool, uint32_t poolType, uint64_t budget)
+		{
+			uint64_t movedBytes = 0;
+
+			// With a single free range everything already sits at the start of the buffer
+			while (movedBytes < budget && pool.Allocator.GetFreeRangeCount() > 1 && !pool.LiveRanges.empty())
+			{
+				auto last = std::prev(pool.LiveRanges.end());
+				const auto [offset, handle] = *last;
+				GeometryEntry& entry = s_Data->Entries[handle];
+				GeometryRange& range = entry.Ranges[poolType];
+
+				uint32_t newOffset = 0;
+				if (!pool.Allocator.AllocateBelow(range.Count, offset, newOffset))
+					break;
+
+				pool.ReleasedRanges.push_back({ range, s_Data->FrameNumber });
+				pool.LiveRanges.erase(last);
+
+				range.Offset = newOffset;
+				pool.LiveRanges[newOffset] = handle;
+				UploadRange(pool, range, entry.Data[poolType]);
+
+				movedBytes += static_cast<uint64_t>(range.Count) * pool.Stride;
+			}
+
+			return movedBytes;
+		}
+
+	}
+
+	void GeometryHeap::Init()
+	{
+		s_Data = new GeometryHeapData();
+
+		GeometryPool& vertexPool = s_Data->Pools[VertexPool];
+		vertexPool.Name = "vertex";
+		vertexPool.Stride = sizeof(MeshUtils::Vertex);
+		vertexPool.Usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+		GeometryPool& indexPool = s_Data->Pools[IndexPool];
+		indexPool.Name = "index";
+		indexPool.Stride = sizeof(uint32_t);
+		indexPool.Usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+		Utils::CreatePoolBuffer(vertexPool, s_InitialVertexCapacity);
+		vertexPool.Allocator.Grow(s_InitialVertexCapacity);
+
+		Utils::CreatePoolBuffer(indexPool, s_InitialIndexCapacity);
+		indexPool.Allocator.Grow(s_InitialIndexCapacity);
+	}
+
+	void GeometryHeap::Shutdown()
+	{
+		VulkanAllocator allocator("GeometryHeap");
+		for (GeometryPool& pool : s_Data->Pools)
+			allocator.DestroyBuffer(pool.Allocation, pool.Buffer);
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void GeometryHeap::BeginFrame()
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		s_Data->FrameNumber++;
+
+		uint64_t budget = s_DefragmentBudget;
+		for (uint32_t poolType = 0; poolType < PoolCount; poolType++)
+		{
+			GeometryPool& pool = s_Data->Pools[poolType];
+			Utils::RetireReleasedRanges(pool);
+
+			const uint64_t movedBytes = Utils::DefragmentPool(pool, poolType, budget);
+			budget -= std::min(movedBytes, budget);
+		}
+	}
+
+	uint32_t GeometryHeap::Allocate(const void* vertexData, uint32_t vertexCount, const void* indexData, uint32_t indexCount)
+	{
+		IR_ASSERT(vertexData && vertexCount && indexData && indexCount);
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		uint32_t handle = 0;
+		if (!s_Data->FreeHandles.empty())
+		{
+			handle = s_Data->FreeHandles.back();
+			s_Data->FreeHandles.pop_back();
+		}
+		else
+		{
+			handle = static_cast<uint32_t>(s_Data->Entries.size());
+			s_Data->Entries.emplace_back();
+		}
+
+		GeometryEntry& entry = s_Data->Entries[handle];
+		entry.Data[VertexPool] = vertexData;
+		entry.Data[IndexPool] = indexData;
+		entry.Ranges[VertexPool] = Utils::AllocateRange(s_Data->Pools[VertexPool], vertexCount);
+		entry.Ranges[IndexPool] = Utils::AllocateRange(s_Data->Pools[IndexPool], indexCount);
+		entry.Live = true;
+
+		for (uint32_t poolType = 0; poolType < PoolCount; poolType++)
+		{
+			GeometryPool& pool = s_Data->Pools[poolType];
+			pool.LiveRanges[entry.Ranges[poolType].Offset] = handle;
+			Utils::UploadRange(pool, entry.Ranges[poolType], entry.Data[poolType]);
+		}
+
+		return handle;
+	}
+
+	void GeometryHeap::Free(uint32_t handle)
+	{
+		// Mesh sources that outlive the renderer
+		if (!s_Data || handle == InvalidHandle)
+			return;
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		GeometryEntry& entry = s_Data->Entries[handle];
+		IR_ASSERT(entry.Live);
+
+		for (uint32_t poolType = 0; poolType < PoolCount; poolType++)
+		{
+			GeometryPool& pool = s_Data->Pools[poolType];
+			pool.LiveRanges.erase(entry.Ranges[poolType].Offset);
+			pool.ReleasedRanges.push_back({ entry.Ranges[poolType], s_Data->FrameNumber });
+		}
+
+		entry = {};
+		s_Data->FreeHandles.push_back(handle);
+	}
+
+	GeometryAllocation GeometryHeap::GetAllocation(uint32_t handle)
+	{
+		if (handle == InvalidHandle)
+			return {};
+
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+
+		const GeometryEntry& entry = s_Data->Entries[handle];
+		return {
+			.VertexOffset = entry.Ranges[VertexPool].Offset,
+			.VertexCount = entry.Ranges[VertexPool].Count,
+			.IndexOffset = entry.Ranges[IndexPool].Offset,
+			.IndexCount = entry.Ranges[IndexPool].Count
+		};
+	}
+
+	VkBuffer GeometryHeap::GetVertexBuffer()
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		return s_Data->Pools[VertexPool].Buffer;
+	}
+
+	VkBuffer GeometryHeap::GetIndexBuffer()
+	{
+		std::scoped_lock<std::mutex> lock(s_Data->Mutex);
+		return s_Data->Pools[IndexPool].Buffer;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+/*
+ * One vertex buffer and one index buffer that hold the geometry of every MeshSource, each suballocated by a coalescing free list
+ * - Mesh sources only own an allocation handle, draws add the offsets of the allocation to the base vertex and base index of their submesh
+ *   so the buffers get bound once per pass instead of once per draw and submeshes of different meshes can share an indirect draw
+ * - The heap keeps pointers to the CPU side data of every allocation (MeshSource keeps its vertices and indices around) so it can upload it
+ *   again when a buffer has to grow or when an allocation gets moved, nothing is ever copied on the GPU
+ * - Freed and moved from ranges are only handed out again once no frame in flight can still be reading them
+ * - BeginFrame moves a few allocations from the end of the buffers down into holes every frame, offsets only change there (main thread)
+ * - Everything is guarded by a mutex since meshes get imported on the asset threads
+ */
+
+namespace Iris {
+
+	struct GeometryAllocation
+	{
+		uint32_t VertexOffset = 0; // In vertices
+		uint32_t VertexCount = 0;
+		uint32_t IndexOffset = 0; // In indices (uint32_t)
+		uint32_t IndexCount = 0;
+	};
+
+	class GeometryHeap
+	{
+	public:
+		static constexpr uint32_t InvalidHandle = ~0u;
+
+		static void Init();
+		static void Shutdown();
+
+		// Main thread, once per frame. Retires released ranges that are no longer in flight and compacts the buffers a bit
+		static void BeginFrame();
+
+		// The data has to stay alive and unchanged until the allocation gets freed
+		static uint32_t Allocate(const void* vertexData, uint32_t vertexCount, const void* indexData, uint32_t indexCount);
+		static void Free(uint32_t handle);
+
+		static GeometryAllocation GetAllocation(uint32_t handle);
+
+		// Resolved when the draw is submitted so the buffers always match the offsets of the allocations
+		static VkBuffer GetVertexBuffer();
+		static VkBuffer GetIndexBuffer();
+	};
+
+}
\ No newline at end of file
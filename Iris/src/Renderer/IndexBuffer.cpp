@@ -2,14 +2,11 @@
 #include "IndexBuffer.h"
 
 #include "Renderer/Core/RendererContext.h"
+#include "Renderer/Core/UploadManager.h"
 #include "Renderer/Renderer.h"
 
 namespace Iris {
 
-	/*
-	 * TODO: Look at the IMPORTANT NOTE written in Renderer/Core/Device.h about using StagingBuffers in a better more sophisticated way
-	 */
-
 	IndexBuffer::IndexBuffer(const void* data, uint32_t size)
 		: m_Size(size)
 	{
@@ -18,23 +15,8 @@ namespace Iris {
 		Ref<IndexBuffer> instance = this;
 		Renderer::Submit([instance]() mutable
 		{
-			Ref<VulkanDevice> device = RendererContext::GetCurrentDevice();
 			VulkanAllocator allocator("IndexBuffer");
 
-			VkBuffer stagingBuffer;
-			VkBufferCreateInfo stagingBufferInfo = {
-				.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-				.size = instance->m_Size,
-				.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				.sharingMode = VK_SHARING_MODE_EXCLUSIVE
-			};
-			VmaAllocation stagingBufferAllocation = allocator.AllocateBuffer(&stagingBufferInfo, VMA_MEMORY_USAGE_CPU_TO_GPU, &stagingBuffer);
-
-			uint8_t* dstData = allocator.MapMemory<uint8_t>(stagingBufferAllocation);
-			std::memcpy(dstData, instance->m_LocalData.Data, instance->m_LocalData.Size);
-			allocator.UnmapMemory(stagingBufferAllocation);
-
-			// We need to copy now
 			VkBufferCreateInfo indexBufferInfo = {
 				.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
 				.size = instance->m_Size,
@@ -43,22 +25,8 @@ namespace Iris {
 			};
 			instance->m_MemoryAllocation = allocator.AllocateBuffer(&indexBufferInfo, VMA_MEMORY_USAGE_GPU_ONLY, &(instance->m_VulkanBuffer));
 
-			// TODO: Refer to the note in Renderer/Core/Device.h since maybe we could just begin and return a pre-allocated buffer?
-			VkCommandBuffer commandBuffer = device->GetCommandBuffer(true);
-
-			VkBufferCopy copyRegion = {
-				.srcOffset = 0,
-				.dstOffset = 0,
-				.size = instance->m_Size
-			};
-			vkCmdCopyBuffer(commandBuffer, stagingBuffer, instance->m_VulkanBuffer, 1, &copyRegion);
-
-			// TODO: Refer to the note in Renderer/Core/Device.h since we do not want to do this really...
-			device->FlushCommandBuffer(commandBuffer);
-
-			// NOTE: If we implement the note written in Device.h we would defer this cleanup to the beginning of the next frame.
-			// Renderer::SubmitResourceFree
-			allocator.DestroyBuffer(stagingBufferAllocation, stagingBuffer);
+			// The copy is batched with the other uploads and submitted before the next command buffer that could use the buffer
+			UploadManager::UploadBuffer(instance->m_VulkanBuffer, instance->m_LocalData.Data, instance->m_Size);
 		});
 	}
 
@@ -23,6 +23,7 @@ namespace Iris {
 		: m_Shader(shader), m_Name(name)
 	{
 		Init(false, {});
+		UpdatePermutationKey();
 		Renderer::RegisterShaderDependency(shader, this);
 	}
 
@@ -36,6 +37,9 @@ namespace Iris {
 		// Renderer::RegisterShaderDependency(m_Shader, this); // Should not register this otherwise we get duplicate materials
 
 		m_UniformStorageBuffer = Buffer::Copy(other->m_UniformStorageBuffer.Data, other->m_UniformStorageBuffer.Size);
+
+		m_Permutations = other->m_Permutations;
+		UpdatePermutationKey();
 	}
 
 	Material::~Material()
@@ -51,169 +55,189 @@ namespace Iris {
 	void Material::OnShaderReloaded()
 	{
 		// Init();
+		UpdatePermutationKey();
+	}
+
+	void Material::SetPermutation(std::string_view name, bool value)
+	{
+		auto it = m_Permutations.find(name);
+		if (it != m_Permutations.end() && it->second == value)
+			return;
+
+		m_Permutations.insert_or_assign(std::string(name), value);
+		UpdatePermutationKey();
+	}
+
+	bool Material::GetPermutation(std::string_view name) const
+	{
+		if (auto it = m_Permutations.find(name); it != m_Permutations.end())
+			return it->second;
+
+		const int32_t index = m_Shader->GetPermutationIndex(name);
+		return index >= 0 && m_Shader->GetPermutations()[index].DefaultValue;
 	}
 
-	void Material::Set(std::string_view name, int value)
+	void Material::Set(const MaterialParam& param, int value)
 	{
-		Set<int>(name, value);
+		Set<int>(param, value);
 	}
 
-	void Material::Set(std::string_view name, uint32_t value)
+	void Material::Set(const MaterialParam& param, uint32_t value)
 	{
-		Set<uint32_t>(name, value);
+		Set<uint32_t>(param, value);
 	}
 
-	void Material::Set(std::string_view name, float value)
+	void Material::Set(const MaterialParam& param, float value)
 	{
-		Set<float>(name, value);
+		Set<float>(param, value);
 	}
 
-	void Material::Set(std::string_view name, bool value)
+	void Material::Set(const MaterialParam& param, bool value)
 	{
-		Set<int>(name, value); // Bools are 4 byte ints...
+		Set<int>(param, value); // Bools are 4 byte ints...
 	}
 
-	void Material::Set(std::string_view name, const glm::ivec2& value)
+	void Material::Set(const MaterialParam& param, const glm::ivec2& value)
 	{
-		Set<glm::ivec2>(name, value);
+		Set<glm::ivec2>(param, value);
 	}
 
-	void Material::Set(std::string_view name, const glm::ivec3& value)
+	void Material::Set(const MaterialParam& param, const glm::ivec3& value)
 	{
-		Set<glm::ivec3>(name, value);
+		Set<glm::ivec3>(param, value);
 	}
 
-	void Material::Set(std::string_view name, const glm::ivec4& value)
+	void Material::Set(const MaterialParam& param, const glm::ivec4& value)
 	{
-		Set<glm::ivec4>(name, value);
+		Set<glm::ivec4>(param, value);
 	}
 
-	void Material::Set(std::string_view name, const glm::vec2& value)
+	void Material::Set(const MaterialParam& param, const glm::vec2& value)
 	{
-		Set<glm::vec2>(name, value);
+		Set<glm::vec2>(param, value);
 	}
 
-	void Material::Set(std::string_view name, const glm::vec3& value)
+	void Material::Set(const MaterialParam& param, const glm::vec3& value)
 	{
-		Set<glm::vec3>(name, value);
+		Set<glm::vec3>(param, value);
 	}
 
-	void Material::Set(std::string_view name, const glm::vec4& value)
+	void Material::Set(const MaterialParam& param, const glm::vec4& value)
 	{
-		Set<glm::vec4>(name, value);
+		Set<glm::vec4>(param, value);
 	}
 
-	void Material::Set(std::string_view name, const glm::mat3& value)
+	void Material::Set(const MaterialParam& param, const glm::mat3& value)
 	{
-		Set<glm::mat3>(name, value);
+		Set<glm::mat3>(param, value);
 	}
 
-	void Material::Set(std::string_view name, const glm::mat4& value)
+	void Material::Set(const MaterialParam& param, const glm::mat4& value)
 	{
-		Set<glm::mat4>(name, value);
+		Set<glm::mat4>(param, value);
 	}
 
-	void Material::Set(std::string_view name, const Ref<Texture2D>& value)
+	void Material::Set(const MaterialParam& param, const Ref<Texture2D>& value)
 	{
-		SetVulkanDescriptor(name, value);
+		SetVulkanDescriptor(param, value);
 	}
 
-	void Material::Set(std::string_view name, const Ref<Texture2D>& value, uint32_t arrayIndex)
+	void Material::Set(const MaterialParam& param, const Ref<Texture2D>& value, uint32_t arrayIndex)
 	{
-		SetVulkanDescriptor(name, value, arrayIndex);
+		SetVulkanDescriptor(param, value, arrayIndex);
 	}
 
-	void Material::Set(std::string_view name, const Ref<TextureCube>& value)
+	void Material::Set(const MaterialParam& param, const Ref<TextureCube>& value)
 	{
-		SetVulkanDescriptor(name, value);
+		SetVulkanDescriptor(param, value);
 	}
 
-	void Material::Set(std::string_view name, const Ref<ImageView>& value)
+	void Material::Set(const MaterialParam& param, const Ref<ImageView>& value)
 	{
-		SetVulkanDescriptor(name, value);
+		SetVulkanDescriptor(param, value);
 	}
 
-	int& Material::GetInt(std::string_view name)
+	int& Material::GetInt(const MaterialParam& param)
 	{
-		return Get<int>(name);
+		return Get<int>(param);
 	}
 
-	uint32_t& Material::GetUInt(std::string_view name)
+	uint32_t& Material::GetUInt(const MaterialParam& param)
 	{
-		return Get<uint32_t>(name);
+		return Get<uint32_t>(param);
 	}
 
-	float& Material::GetFloat(std::string_view name)
+	float& Material::GetFloat(const MaterialParam& param)
 	{
-		return Get<float>(name);
+		return Get<float>(param);
 	}
 
-	bool& Material::GetBool(std::string_view name)
+	bool& Material::GetBool(const MaterialParam& param)
 	{
-		return Get<bool>(name);
+		return Get<bool>(param);
 	}
 
-	glm::ivec2& Material::GetIVector2(std::string_view name)
+	glm::ivec2& Material::GetIVector2(const MaterialParam& param)
 	{
-		return Get<glm::ivec2>(name);
+		return Get<glm::ivec2>(param);
 	}
 
-	glm::ivec3& Material::GetIVector3(std::string_view name)
+	glm::ivec3& Material::GetIVector3(const MaterialParam& param)
 	{
-		return Get<glm::ivec3>(name);
+		return Get<glm::ivec3>(param);
 	}
 
-	glm::ivec4& Material::GetIVector4(std::string_view name)
+	glm::ivec4& Material::GetIVector4(const MaterialParam& param)
 	{
-		return Get<glm::ivec4>(name);
+		return Get<glm::ivec4>(param);
 	}
 
-	glm::vec2& Material::GetVector2(std::string_view name)
+	glm::vec2& Material::GetVector2(const MaterialParam& param)
 	{
-		return Get<glm::vec2>(name);
+		return Get<glm::vec2>(param);
 	}
 
-	glm::vec3& Material::GetVector3(std::string_view name)
+	glm::vec3& Material::GetVector3(const MaterialParam& param)
 	{
-		return Get<glm::vec3>(name);
+		return Get<glm::vec3>(param);
 	}
 
-	glm::vec4& Material::GetVector4(std::string_view name)
+	glm::vec4& Material::GetVector4(const MaterialParam& param)
 	{
-		return Get<glm::vec4>(name);
+		return Get<glm::vec4>(param);
 	}
 
-	glm::mat3& Material::GetMatrix3(std::string_view name)
+	glm::mat3& Material::GetMatrix3(const MaterialParam& param)
 	{
-		return Get<glm::mat3>(name);
+		return Get<glm::mat3>(param);
 	}
 
-	glm::mat4& Material::GetMatrix4(std::string_view name)
+	glm::mat4& Material::GetMatrix4(const MaterialParam& param)
 	{
-		return Get<glm::mat4>(name);
+		return Get<glm::mat4>(param);
 	}
 
-	Ref<Texture2D> Material::GetTexture2D(std::string_view name)
+	Ref<Texture2D> Material::GetTexture2D(const MaterialParam& param)
 	{
-		return TryGetResource<Texture2D>(name);
+		return TryGetResource<Texture2D>(param);
 	}
 
-	Ref<Texture2D> Material::TryGetTexture2D(std::string_view name)
+	Ref<Texture2D> Material::TryGetTexture2D(const MaterialParam& param)
 	{
-		return TryGetResource<Texture2D>(name);
+		return TryGetResource<Texture2D>(param);
 	}
 
-	Ref<TextureCube> Material::GetTextureCube(std::string_view name)
+	Ref<TextureCube> Material::GetTextureCube(const MaterialParam& param)
 	{
-		return TryGetResource<TextureCube>(name);
+		return TryGetResource<TextureCube>(param);
 	}
 
-	Ref<TextureCube> Material::TryGetTextureCube(std::string_view name)
+	Ref<TextureCube> Material::TryGetTextureCube(const MaterialParam& param)
 	{
-		return TryGetResource<TextureCube>(name);
+		return TryGetResource<TextureCube>(param);
 	}
 
-	void Material::Init(bool triggerCopy, const std::map<uint32_t, std::map<uint32_t, RenderPassInput>>& inputResources)
+	void Material::Init(bool triggerCopy, const std::vector<RenderPassInput>& inputResources)
 	{
 		AllocateStorage();
 
@@ -236,10 +260,27 @@ namespace Iris {
 		m_DescriptorSetManager.Bake();
 	}
 
+	void Material::UpdatePermutationKey()
+	{
+		m_PermutationKey = m_Shader->GetDefaultPermutationKey();
+		for (const auto& [name, value] : m_Permutations)
+		{
+			const int32_t index = m_Shader->GetPermutationIndex(name);
+			if (index < 0)
+				continue;
+
+			if (value)
+				m_PermutationKey |= 1u << index;
+			else
+				m_PermutationKey &= ~(1u << index);
+		}
+	}
+
 	void Material::AllocateStorage()
 	{
 		const std::unordered_map<std::string, ShaderBuffer>& shaderBuffers = m_Shader->GetShaderBuffers();
-		
+		IR_ASSERT(shaderBuffers.size() <= 1, "Currently only ONE material buffer");
+
 		if (shaderBuffers.size() > 0)
 		{
 			uint32_t size = 0;
@@ -251,41 +292,28 @@ namespace Iris {
 		}
 	}
 
-	void Material::SetVulkanDescriptor(std::string_view name, const Ref<Texture2D>& texture)
+	void Material::SetVulkanDescriptor(const MaterialParam& param, const Ref<Texture2D>& texture)
 	{
-		m_DescriptorSetManager.SetInput(name, texture);
+		if (!m_DescriptorSetManager.SetInput(param.NameHash, texture))
+			IR_CORE_ERROR_TAG("Renderer", "[Material ({})::Set] Input {} not found!", m_Name, param.Name);
 	}
 
-	void Material::SetVulkanDescriptor(std::string_view name, const Ref<Texture2D>& texture, uint32_t arrayIndex)
+	void Material::SetVulkanDescriptor(const MaterialParam& param, const Ref<Texture2D>& texture, uint32_t arrayIndex)
 	{
-		m_DescriptorSetManager.SetInput(name, texture, arrayIndex);
+		if (!m_DescriptorSetManager.SetInput(param.NameHash, texture, arrayIndex))
+			IR_CORE_ERROR_TAG("Renderer", "[Material ({})::Set] Input {} not found!", m_Name, param.Name);
 	}
 
-	void Material::SetVulkanDescriptor(std::string_view name, const Ref<TextureCube>& texture)
+	void Material::SetVulkanDescriptor(const MaterialParam& param, const Ref<TextureCube>& texture)
 	{
-		m_DescriptorSetManager.SetInput(name, texture);
+		if (!m_DescriptorSetManager.SetInput(param.NameHash, texture))
+			IR_CORE_ERROR_TAG("Renderer", "[Material ({})::Set] Input {} not found!", m_Name, param.Name);
 	}
 
-	void Material::SetVulkanDescriptor(std::string_view name, const Ref<ImageView>& imageView)
+	void Material::SetVulkanDescriptor(const MaterialParam& param, const Ref<ImageView>& imageView)
 	{
-		m_DescriptorSetManager.SetInput(name, imageView);
-	}
-
-	const ShaderUniform* Material::FindUniformDeclaration(std::string_view name) const
-	{
-		const std::unordered_map<std::string, ShaderBuffer>& shaderBuffers = m_Shader->GetShaderBuffers();
-		IR_ASSERT(shaderBuffers.size() <= 1, "Currently only ONE material buffer");
-
-		if (shaderBuffers.size() > 0)
-		{
-			const ShaderBuffer& buffer = shaderBuffers.begin()->second;
-			if (!buffer.Uniforms.contains(std::string(name)))
-				return nullptr;
-
-			return &buffer.Uniforms.at(std::string(name));
-		}
-
-		return nullptr;
+		if (!m_DescriptorSetManager.SetInput(param.NameHash, imageView))
+			IR_CORE_ERROR_TAG("Renderer", "[Material ({})::Set] Input {} not found!", m_Name, param.Name);
 	}
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Core/Buffer.h"
+#include "Core/Hash.h"
 #include "Renderer/DescriptorSetManager.h"
 #include "Renderer/Shaders/Shader.h"
 #include "Renderer/Shaders/ShaderUniform.h"
@@ -11,6 +12,19 @@ namespace Iris {
 	 * This material object handles objects and any resource found in set = 3 in the shaders
 	 */
 
+	// Name of a uniform or resource hashed at compile time when declared constexpr, materials look it up by the hash in the tables built
+	// from the shader's reflection instead of building strings out of the name
+	struct MaterialParam
+	{
+		uint32_t NameHash = 0;
+		std::string_view Name;
+
+		constexpr explicit MaterialParam(std::string_view name)
+			: NameHash(Hash::GenerateFNVHash(name)), Name(name)
+		{
+		}
+	};
+
 	enum class MaterialFlag
 	{
 		None      = BIT(0), // 0b0001
@@ -32,28 +46,33 @@ namespace Iris {
 		void Prepare();
 		void OnShaderReloaded();
 
-		void Set(std::string_view name, int value);
-		void Set(std::string_view name, uint32_t value);
-		void Set(std::string_view name, float value);
-		void Set(std::string_view name, bool value);
-		void Set(std::string_view name, const glm::ivec2& value);
-		void Set(std::string_view name, const glm::ivec3& value);
-		void Set(std::string_view name, const glm::ivec4& value);
-		void Set(std::string_view name, const glm::vec2& value);
-		void Set(std::string_view name, const glm::vec3& value);
-		void Set(std::string_view name, const glm::vec4& value);
-		void Set(std::string_view name, const glm::mat3& value);
-		void Set(std::string_view name, const glm::mat4& value);
-
-		void Set(std::string_view name, const Ref<Texture2D>& value);
-		void Set(std::string_view name, const Ref<Texture2D>& value, uint32_t arrayIndex);
-		void Set(std::string_view name, const Ref<TextureCube>& value);
-		void Set(std::string_view name, const Ref<ImageView>& imageView);
+		void Set(const MaterialParam& param, int value);
+		void Set(const MaterialParam& param, uint32_t value);
+		void Set(const MaterialParam& param, float value);
+		void Set(const MaterialParam& param, bool value);
+		void Set(const MaterialParam& param, const glm::ivec2& value);
+		void Set(const MaterialParam& param, const glm::ivec3& value);
+		void Set(const MaterialParam& param, const glm::ivec4& value);
+		void Set(const MaterialParam& param, const glm::vec2& value);
+		void Set(const MaterialParam& param, const glm::vec3& value);
+		void Set(const MaterialParam& param, const glm::vec4& value);
+		void Set(const MaterialParam& param, const glm::mat3& value);
+		void Set(const MaterialParam& param, const glm::mat4& value);
+
+		void Set(const MaterialParam& param, const Ref<Texture2D>& value);
+		void Set(const MaterialParam& param, const Ref<Texture2D>& value, uint32_t arrayIndex);
+		void Set(const MaterialParam& param, const Ref<TextureCube>& value);
+		void Set(const MaterialParam& param, const Ref<ImageView>& imageView);
+
+		// The string versions hash the name on every call, prefer keeping a MaterialParam around for anything that gets set often
+		template<typename T>
+		void Set(std::string_view name, const T& value) { Set(MaterialParam(name), value); }
+		void Set(std::string_view name, const Ref<Texture2D>& value, uint32_t arrayIndex) { Set(MaterialParam(name), value, arrayIndex); }
 
 		template<typename T>
-		void Set(std::string_view name, const T& value)
+		void Set(const MaterialParam& param, const T& value)
 		{
-			const ShaderUniform* decl = FindUniformDeclaration(name);
+			const ShaderUniform* decl = FindUniformDeclaration(param);
 			IR_ASSERT(decl, "Could not find uniform!");
 			if (!decl)
 				return;
@@ -61,39 +80,64 @@ namespace Iris {
 			m_UniformStorageBuffer.Write(reinterpret_cast<const uint8_t*>(&value), decl->GetSize(), decl->GetOffset());
 		}
 
-		int& GetInt(std::string_view name);
-		uint32_t& GetUInt(std::string_view name);
-		float& GetFloat(std::string_view name);
-		bool& GetBool(std::string_view name);
-		glm::ivec2& GetIVector2(std::string_view name);
-		glm::ivec3& GetIVector3(std::string_view name);
-		glm::ivec4& GetIVector4(std::string_view name);
-		glm::vec2& GetVector2(std::string_view name);
-		glm::vec3& GetVector3(std::string_view name);
-		glm::vec4& GetVector4(std::string_view name);
-		glm::mat3& GetMatrix3(std::string_view name);
-		glm::mat4& GetMatrix4(std::string_view name);
-
-		Ref<Texture2D> GetTexture2D(std::string_view name);
-		Ref<Texture2D> TryGetTexture2D(std::string_view name);
-
-		Ref<TextureCube> GetTextureCube(std::string_view name);
-		Ref<TextureCube> TryGetTextureCube(std::string_view name);
+		int& GetInt(const MaterialParam& param);
+		uint32_t& GetUInt(const MaterialParam& param);
+		float& GetFloat(const MaterialParam& param);
+		bool& GetBool(const MaterialParam& param);
+		glm::ivec2& GetIVector2(const MaterialParam& param);
+		glm::ivec3& GetIVector3(const MaterialParam& param);
+		glm::ivec4& GetIVector4(const MaterialParam& param);
+		glm::vec2& GetVector2(const MaterialParam& param);
+		glm::vec3& GetVector3(const MaterialParam& param);
+		glm::vec4& GetVector4(const MaterialParam& param);
+		glm::mat3& GetMatrix3(const MaterialParam& param);
+		glm::mat4& GetMatrix4(const MaterialParam& param);
+
+		Ref<Texture2D> GetTexture2D(const MaterialParam& param);
+		Ref<Texture2D> TryGetTexture2D(const MaterialParam& param);
+
+		Ref<TextureCube> GetTextureCube(const MaterialParam& param);
+		Ref<TextureCube> TryGetTextureCube(const MaterialParam& param);
+
+		int& GetInt(std::string_view name) { return GetInt(MaterialParam(name)); }
+		uint32_t& GetUInt(std::string_view name) { return GetUInt(MaterialParam(name)); }
+		float& GetFloat(std::string_view name) { return GetFloat(MaterialParam(name)); }
+		bool& GetBool(std::string_view name) { return GetBool(MaterialParam(name)); }
+		glm::ivec2& GetIVector2(std::string_view name) { return GetIVector2(MaterialParam(name)); }
+		glm::ivec3& GetIVector3(std::string_view name) { return GetIVector3(MaterialParam(name)); }
+		glm::ivec4& GetIVector4(std::string_view name) { return GetIVector4(MaterialParam(name)); }
+		glm::vec2& GetVector2(std::string_view name) { return GetVector2(MaterialParam(name)); }
+		glm::vec3& GetVector3(std::string_view name) { return GetVector3(MaterialParam(name)); }
+		glm::vec4& GetVector4(std::string_view name) { return GetVector4(MaterialParam(name)); }
+		glm::mat3& GetMatrix3(std::string_view name) { return GetMatrix3(MaterialParam(name)); }
+		glm::mat4& GetMatrix4(std::string_view name) { return GetMatrix4(MaterialParam(name)); }
+
+		Ref<Texture2D> GetTexture2D(std::string_view name) { return GetTexture2D(MaterialParam(name)); }
+		Ref<Texture2D> TryGetTexture2D(std::string_view name) { return TryGetTexture2D(MaterialParam(name)); }
+
+		Ref<TextureCube> GetTextureCube(std::string_view name) { return GetTextureCube(MaterialParam(name)); }
+		Ref<TextureCube> TryGetTextureCube(std::string_view name) { return TryGetTextureCube(MaterialParam(name)); }
 
 		template<typename T>
-		T& Get(std::string_view name)
+		T& Get(const MaterialParam& param)
 		{
-			const ShaderUniform* decl = FindUniformDeclaration(name);
+			const ShaderUniform* decl = FindUniformDeclaration(param);
 			IR_ASSERT(decl, "Could not find uniform!");
 			return m_UniformStorageBuffer.Read<T>(decl->GetOffset());
 		}
 
 		template<typename T>
-		Ref<T> TryGetResource(std::string_view name)
+		T& Get(std::string_view name) { return Get<T>(MaterialParam(name)); }
+
+		template<typename T>
+		Ref<T> TryGetResource(const MaterialParam& param)
 		{
-			return m_DescriptorSetManager.GetInput<T>(name);
+			return m_DescriptorSetManager.GetInput<T>(param.NameHash);
 		}
 
+		template<typename T>
+		Ref<T> TryGetResource(std::string_view name) { return TryGetResource<T>(MaterialParam(name)); }
+
 		uint32_t GetMaterialFlags() const { return m_MaterialFlags; }
 		bool GetFlag(MaterialFlag flag) const { return static_cast<uint32_t>(flag) & m_MaterialFlags; }
 		void SetFlags(uint32_t flags) { m_MaterialFlags = flags; }
@@ -120,20 +164,28 @@ namespace Iris {
 
 		uint32_t GetFirstSetIndex() const { return m_DescriptorSetManager.GetFirstSetIndex(); }
 
+		// Switches a `#pragma permutation` of the shader, the renderer draws the material with the matching pipeline variant once it is compiled.
+		// Only switch off what the uniforms of the material already skip since the default variant is used until then
+		void SetPermutation(std::string_view name, bool value);
+		bool GetPermutation(std::string_view name) const;
+		uint32_t GetPermutationKey() const { return m_PermutationKey; }
+
 		Ref<Shader> GetShader() { return m_Shader; }
 		const std::string& GetName() const { return m_Name; }
 		Buffer GetUniformStorageBuffer() { return m_UniformStorageBuffer; }
 
 	private:
-		void Init(bool triggerCopy = false, const std::map<uint32_t, std::map<uint32_t, RenderPassInput>>& inputResources = std::map<uint32_t, std::map<uint32_t, RenderPassInput>>());
+		void Init(bool triggerCopy = false, const std::vector<RenderPassInput>& inputResources = {});
 		void AllocateStorage();
 
-		void SetVulkanDescriptor(std::string_view name, const Ref<Texture2D>& texture);
-		void SetVulkanDescriptor(std::string_view name, const Ref<Texture2D>& texture, uint32_t arrayIndex);
-		void SetVulkanDescriptor(std::string_view name, const Ref<TextureCube>& texture);
-		void SetVulkanDescriptor(std::string_view name, const Ref<ImageView>& imageView);
+		void SetVulkanDescriptor(const MaterialParam& param, const Ref<Texture2D>& texture);
+		void SetVulkanDescriptor(const MaterialParam& param, const Ref<Texture2D>& texture, uint32_t arrayIndex);
+		void SetVulkanDescriptor(const MaterialParam& param, const Ref<TextureCube>& texture);
+		void SetVulkanDescriptor(const MaterialParam& param, const Ref<ImageView>& imageView);
+
+		const ShaderUniform* FindUniformDeclaration(const MaterialParam& param) const { return m_Shader->FindUniform(param.NameHash); }
 
-		const ShaderUniform* FindUniformDeclaration(std::string_view name) const;
+		void UpdatePermutationKey();
 
 	private:
 		std::string m_Name;
@@ -143,6 +195,10 @@ namespace Iris {
 
 		uint32_t m_MaterialFlags = 0;
 
+		// Kept by name since the bits can move around when the shader gets reloaded
+		std::map<std::string, bool, std::less<>> m_Permutations;
+		uint32_t m_PermutationKey = 0;
+
 		Buffer m_UniformStorageBuffer;
 	};
 
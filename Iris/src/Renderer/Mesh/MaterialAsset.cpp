@@ -10,20 +10,25 @@
 
 namespace Iris {
 
-	constexpr static const char* s_AlbedoColorUniform = "u_MaterialUniforms.AlbedoColor";
-	constexpr static const char* s_RoughnessUniform = "u_MaterialUniforms.Roughness";
-	constexpr static const char* s_MetalnessUniform = "u_MaterialUniforms.Metalness";
-	constexpr static const char* s_EmissionUniform = "u_MaterialUniforms.Emission";
-	constexpr static const char* s_TilingUniform = "u_MaterialUniforms.Tiling";
-	constexpr static const char* s_EnvMapRotationUniform = "u_MaterialUniforms.EnvMapRotation";
-	constexpr static const char* s_UseNormalMapUniform = "u_MaterialUniforms.UseNormalMap";
-	constexpr static const char* s_TransparencyUniform = "u_MaterialUniforms.Transparency";
-	constexpr static const char* s_LitUniform = "u_MaterialUniforms.Lit";
-	
-	constexpr static const char* s_AlbedoMapUniform = "u_AlbedoTexture";
-	constexpr static const char* s_NormalMapUniform = "u_NormalTexture";
-	constexpr static const char* s_RoughnessMapUniform = "u_RoughnessTexture";
-	constexpr static const char* s_MetalnessMapUniform = "u_MetalnessTexture";
+	// Where materials of shaders that predate the material buffer keep their values, only used to take them over when wrapping such a material
+	constexpr static MaterialParam s_AlbedoColorUniform("u_MaterialUniforms.AlbedoColor");
+	constexpr static MaterialParam s_RoughnessUniform("u_MaterialUniforms.Roughness");
+	constexpr static MaterialParam s_MetalnessUniform("u_MaterialUniforms.Metalness");
+	constexpr static MaterialParam s_EmissionUniform("u_MaterialUniforms.Emission");
+	constexpr static MaterialParam s_TilingUniform("u_MaterialUniforms.Tiling");
+	constexpr static MaterialParam s_EnvMapRotationUniform("u_MaterialUniforms.EnvMapRotation");
+	constexpr static MaterialParam s_UseNormalMapUniform("u_MaterialUniforms.UseNormalMap");
+	constexpr static MaterialParam s_TransparencyUniform("u_MaterialUniforms.Transparency");
+	constexpr static MaterialParam s_LitUniform("u_MaterialUniforms.Lit");
+
+	constexpr static MaterialParam s_AlbedoMapUniform("u_AlbedoTexture");
+	constexpr static MaterialParam s_NormalMapUniform("u_NormalTexture");
+	constexpr static MaterialParam s_RoughnessMapUniform("u_RoughnessTexture");
+	constexpr static MaterialParam s_MetalnessMapUniform("u_MetalnessTexture");
+
+	// Permutations of IrisPBRStatic.glsl that mirror the material data
+	constexpr static const char* s_NormalMapPermutation = "IR_NORMAL_MAP";
+	constexpr static const char* s_LitPermutation = "IR_LIT";
 
 	Ref<MaterialAsset> MaterialAsset::Create(bool isTransparent)
 	{
@@ -45,6 +50,8 @@ namespace Iris {
 		else
 			m_Material = Material::Create(Renderer::GetShadersLibrary()->Get("IrisPBRStatic"));
 
+		m_BindlessIndex = BindlessTable::AllocateMaterial();
+
 		SetDefaults();
 	}
 
@@ -53,10 +60,15 @@ namespace Iris {
 		Handle = {};
 
 		m_Material = Material::Create(material);
+		m_Transparent = m_Material->GetShader()->GetName() == "PlaygroundStaticTransparent";
+		m_BindlessIndex = BindlessTable::AllocateMaterial();
+
+		CopyMaterialValues();
 	}
 
 	MaterialAsset::~MaterialAsset()
 	{
+		BindlessTable::FreeMaterial(m_BindlessIndex);
 	}
 
 	void MaterialAsset::OnDependencyUpdated(AssetHandle handle)
@@ -65,116 +77,181 @@ namespace Iris {
 		{
 			Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(handle);
 			IR_VERIFY(texture);
-			m_Material->Set(s_AlbedoMapUniform, texture);
+			SetMapTexture(m_MapTextures.AlbedoMap, m_Data.AlbedoTexture, texture);
 		}
 		else if (handle == m_Maps.NormalMap)
 		{
 			Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(handle);
 			IR_VERIFY(texture);
-			m_Material->Set(s_NormalMapUniform, texture);
+			SetMapTexture(m_MapTextures.NormalMap, m_Data.NormalTexture, texture);
 		}
 		else if (handle == m_Maps.RoughnessMap)
 		{
 			Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(handle);
 			IR_VERIFY(texture);
-			m_Material->Set(s_RoughnessMapUniform, texture);
+			SetMapTexture(m_MapTextures.RoughnessMap, m_Data.RoughnessTexture, texture);
 		}
 		else if(handle == m_Maps.MetalnessMap)
 		{
 			Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(handle);
 			IR_VERIFY(texture);
-			m_Material->Set(s_MetalnessMapUniform, texture);
+			SetMapTexture(m_MapTextures.MetalnessMap, m_Data.MetalnessTexture, texture);
+		}
+	}
+
+	uint32_t MaterialAsset::GetBindlessIndex()
+	{
+		if (std::memcmp(&m_Data, &m_UploadedData, sizeof(BindlessMaterialData)) != 0)
+		{
+			BindlessTable::SetMaterialData(m_BindlessIndex, m_Data);
+			m_UploadedData = m_Data;
 		}
+
+		return m_BindlessIndex;
+	}
+
+	void MaterialAsset::CopyMaterialValues()
+	{
+		Ref<Shader> shader = m_Material->GetShader();
+
+		// Whatever the shader does not declare keeps the default of BindlessMaterialData
+		auto copyUniform = [&]<typename T>(const MaterialParam& param, T& value)
+		{
+			if (shader->FindUniform(param.NameHash))
+				value = m_Material->Get<T>(param);
+		};
+
+		copyUniform(s_AlbedoColorUniform, m_Data.AlbedoColor);
+		copyUniform(s_RoughnessUniform, m_Data.Roughness);
+		copyUniform(s_MetalnessUniform, m_Data.Metalness);
+		copyUniform(s_EmissionUniform, m_Data.Emission);
+		copyUniform(s_TilingUniform, m_Data.Tiling);
+		copyUniform(s_EnvMapRotationUniform, m_Data.EnvMapRotation);
+		copyUniform(s_TransparencyUniform, m_Data.Transparency);
+
+		if (shader->FindUniform(s_UseNormalMapUniform.NameHash))
+			m_Data.UseNormalMap = m_Material->GetBool(s_UseNormalMapUniform);
+		if (shader->FindUniform(s_LitUniform.NameHash))
+			m_Data.Lit = m_Material->GetBool(s_LitUniform);
+
+		// The permutations are what the shader is actually drawn with so they win over the uniforms
+		if (shader->GetPermutationIndex(s_NormalMapPermutation) >= 0)
+			m_Data.UseNormalMap = m_Material->GetPermutation(s_NormalMapPermutation);
+		if (shader->GetPermutationIndex(s_LitPermutation) >= 0)
+			m_Data.Lit = m_Material->GetPermutation(s_LitPermutation);
+
+		auto copyMap = [&](const MaterialParam& param, Ref<Texture2D>& map, uint32_t& textureIndex, AssetHandle& mapHandle)
+		{
+			Ref<Texture2D> texture = m_Material->TryGetTexture2D(param);
+			SetMapTexture(map, textureIndex, texture);
+			if (texture && texture != Renderer::GetWhiteTexture())
+				mapHandle = texture->Handle;
+		};
+
+		copyMap(s_AlbedoMapUniform, m_MapTextures.AlbedoMap, m_Data.AlbedoTexture, m_Maps.AlbedoMap);
+		copyMap(s_NormalMapUniform, m_MapTextures.NormalMap, m_Data.NormalTexture, m_Maps.NormalMap);
+		copyMap(s_RoughnessMapUniform, m_MapTextures.RoughnessMap, m_Data.RoughnessTexture, m_Maps.RoughnessMap);
+		copyMap(s_MetalnessMapUniform, m_MapTextures.MetalnessMap, m_Data.MetalnessTexture, m_Maps.MetalnessMap);
+	}
+
+	void MaterialAsset::SetMapTexture(Ref<Texture2D>& map, uint32_t& textureIndex, const Ref<Texture2D>& texture)
+	{
+		// Could be nullptr if the map failed to load
+		map = texture ? texture : Renderer::GetWhiteTexture();
+		textureIndex = map->GetBindlessIndex();
 	}
 
 	glm::vec3& MaterialAsset::GetAlbedoColor()
 	{
-		return m_Material->GetVector3(s_AlbedoColorUniform);
+		return m_Data.AlbedoColor;
 	}
 
 	void MaterialAsset::SetAlbedoColor(const glm::vec3& color)
 	{
-		m_Material->Set(s_AlbedoColorUniform, color);
+		m_Data.AlbedoColor = color;
 	}
 
 	bool MaterialAsset::IsUsingNormalMap()
 	{
-		return m_Material->GetBool(s_UseNormalMapUniform);
+		return m_Data.UseNormalMap;
 	}
 
 	void MaterialAsset::SetUseNormalMap(bool value)
 	{
-		m_Material->Set(s_UseNormalMapUniform, value);
+		m_Data.UseNormalMap = value;
+		m_Material->SetPermutation(s_NormalMapPermutation, value);
 	}
 
 	float& MaterialAsset::GetRoughness()
 	{
-		return m_Material->GetFloat(s_RoughnessUniform);
+		return m_Data.Roughness;
 	}
 
 	void MaterialAsset::SetRoughness(float roughness)
 	{
-		m_Material->Set(s_RoughnessUniform, roughness);
+		m_Data.Roughness = roughness;
 	}
 
 	float& MaterialAsset::GetMetalness()
 	{
-		return m_Material->GetFloat(s_MetalnessUniform);
+		return m_Data.Metalness;
 	}
 
 	void MaterialAsset::SetMetalness(float metalness)
 	{
-		m_Material->Set(s_MetalnessUniform, metalness);
+		m_Data.Metalness = metalness;
 	}
 
 	float& MaterialAsset::GetEmission()
 	{
-		return m_Material->GetFloat(s_EmissionUniform);
+		return m_Data.Emission;
 	}
 
 	void MaterialAsset::SetEmission(float emission)
 	{
-		m_Material->Set(s_EmissionUniform, emission);
+		m_Data.Emission = emission;
 	}
 
 	float& MaterialAsset::GetTiling()
 	{
-		return m_Material->GetFloat(s_TilingUniform);
+		return m_Data.Tiling;
 	}
 
 	void MaterialAsset::SetTiling(float tiling)
 	{
-		m_Material->Set(s_TilingUniform, tiling);
+		m_Data.Tiling = tiling;
 	}
 
 	float& MaterialAsset::GetTransparency()
 	{
-		return m_Material->GetFloat(s_TransparencyUniform);
+		return m_Data.Transparency;
 	}
 
 	void MaterialAsset::SetTransparency(float transparency)
 	{
-		m_Material->Set(s_TransparencyUniform, transparency);
+		m_Data.Transparency = transparency;
 	}
 
 	bool MaterialAsset::IsLit()
 	{
-		return m_Material->GetBool(s_LitUniform);
+		return m_Data.Lit;
 	}
 
 	void MaterialAsset::SetLit()
 	{
-		m_Material->Set(s_LitUniform, true);
+		m_Data.Lit = true;
+		m_Material->SetPermutation(s_LitPermutation, true);
 	}
 
 	void MaterialAsset::SetUnlit()
 	{
-		m_Material->Set(s_LitUniform, false);
+		m_Data.Lit = false;
+		m_Material->SetPermutation(s_LitPermutation, false);
 	}
 
 	Ref<Texture2D> MaterialAsset::GetAlbedoMap()
 	{
-		return m_Material->GetTexture2D(s_AlbedoMapUniform);
+		return m_MapTextures.AlbedoMap;
 	}
 
 	void MaterialAsset::SetAlbedoMap(AssetHandle albedoMap, bool setImmediatly)
@@ -184,24 +261,9 @@ namespace Iris {
 		if (albedoMap)
 		{
 			if (setImmediatly)
-			{
-				Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(albedoMap);
-				m_Material->Set(s_AlbedoMapUniform, texture);
-			}
+				SetMapTexture(m_MapTextures.AlbedoMap, m_Data.AlbedoTexture, AssetManager::GetAsset<Texture2D>(albedoMap));
 			else
-			{
-				Project::GetEditorAssetManager()->AddPostSyncTask([this, albedoMap]() -> bool
-				{
-					AsyncAssetResult<Texture2D> result = AssetManager::GetAssetAsync<Texture2D>(albedoMap);
-					if (result.IsReady)
-					{
-						m_Material->Set(s_AlbedoMapUniform, result.Asset);
-						return true;
-					}
-
-					return false;
-				}, true);
-			}
+				SetAlbedoMapWhenLoaded(albedoMap);
 
 			AssetManager::RegisterDependency(albedoMap, Handle);
 		}
@@ -213,12 +275,24 @@ namespace Iris {
 
 	void MaterialAsset::ClearAlbedoMap()
 	{
-		m_Material->Set(s_AlbedoMapUniform, Renderer::GetWhiteTexture());
+		SetMapTexture(m_MapTextures.AlbedoMap, m_Data.AlbedoTexture, Renderer::GetWhiteTexture());
+	}
+
+	AssetTask MaterialAsset::SetAlbedoMapWhenLoaded(AssetHandle albedoMap)
+	{
+		// Keep the material alive while waiting
+		Ref<MaterialAsset> material = this;
+
+		Ref<Texture2D> texture = co_await AssetManager::LoadAsync<Texture2D>(albedoMap, AssetLoadPriority::Normal);
+
+		// The map could have been changed while waiting
+		if (texture && m_Maps.AlbedoMap == albedoMap)
+			SetMapTexture(m_MapTextures.AlbedoMap, m_Data.AlbedoTexture, texture);
 	}
 
 	Ref<Texture2D> MaterialAsset::GetNormalMap()
 	{
-		return m_Material->GetTexture2D(s_NormalMapUniform);
+		return m_MapTextures.NormalMap;
 	}
 
 	void MaterialAsset::SetNormalMap(AssetHandle normalMap, bool setImmediatly)
@@ -229,25 +303,13 @@ namespace Iris {
 		{
 			if (setImmediatly)
 			{
-				Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(normalMap);
-				m_Material->Set(s_NormalMapUniform, texture);
+				SetMapTexture(m_MapTextures.NormalMap, m_Data.NormalTexture, AssetManager::GetAsset<Texture2D>(normalMap));
 			}
 			else
 			{
-				Project::GetEditorAssetManager()->AddPostSyncTask([this, normalMap]() -> bool
-				{
-					AsyncAssetResult<Texture2D> result = AssetManager::GetAssetAsync<Texture2D>(normalMap);
-					if (result.IsReady)
-					{
-						m_Material->Set(s_NormalMapUniform, result.Asset);
-						SetUseNormalMap(true);
-						return true;
-					}
-
-					// Otherwise we set defaults until the map is loaded
-					SetUseNormalMap(false);
-					return false;
-				}, true);
+				// Otherwise we set defaults until the map is loaded
+				SetUseNormalMap(false);
+				SetNormalMapWhenLoaded(normalMap);
 			}
 
 			AssetManager::RegisterDependency(normalMap, Handle);
@@ -260,12 +322,27 @@ namespace Iris {
 
 	void MaterialAsset::ClearNormalMap()
 	{
-		m_Material->Set(s_NormalMapUniform, Renderer::GetWhiteTexture());
+		SetMapTexture(m_MapTextures.NormalMap, m_Data.NormalTexture, Renderer::GetWhiteTexture());
+	}
+
+	AssetTask MaterialAsset::SetNormalMapWhenLoaded(AssetHandle normalMap)
+	{
+		// Keep the material alive while waiting
+		Ref<MaterialAsset> material = this;
+
+		Ref<Texture2D> texture = co_await AssetManager::LoadAsync<Texture2D>(normalMap, AssetLoadPriority::Normal);
+
+		// The map could have been changed while waiting
+		if (texture && m_Maps.NormalMap == normalMap)
+		{
+			SetMapTexture(m_MapTextures.NormalMap, m_Data.NormalTexture, texture);
+			SetUseNormalMap(true);
+		}
 	}
 
 	Ref<Texture2D> MaterialAsset::GetRoughnessMap()
 	{
-		return m_Material->GetTexture2D(s_RoughnessMapUniform);
+		return m_MapTextures.RoughnessMap;
 	}
 
 	void MaterialAsset::SetRoughnessMap(AssetHandle roughnessMap, bool setImmediatly)
@@ -276,25 +353,13 @@ namespace Iris {
 		{
 			if (setImmediatly)
 			{
-				Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(roughnessMap);
-				m_Material->Set(s_RoughnessMapUniform, texture);
+				SetMapTexture(m_MapTextures.RoughnessMap, m_Data.RoughnessTexture, AssetManager::GetAsset<Texture2D>(roughnessMap));
 			}
 			else
 			{
-				Project::GetEditorAssetManager()->AddPostSyncTask([this, roughnessMap]() -> bool
-				{
-					AsyncAssetResult<Texture2D> result = AssetManager::GetAssetAsync<Texture2D>(roughnessMap);
-					if (result.IsReady)
-					{
-						m_Material->Set(s_RoughnessMapUniform, result.Asset);
-						SetRoughness(1.0f);
-						return true;
-					}
-
-					// Otherwise we set defaults until the map is loaded
-					SetRoughness(0.4f);
-					return false;
-				}, true);
+				// Otherwise we set defaults until the map is loaded
+				SetRoughness(0.4f);
+				SetRoughnessMapWhenLoaded(roughnessMap);
 			}
 
 			AssetManager::RegisterDependency(roughnessMap, Handle);
@@ -307,12 +372,27 @@ namespace Iris {
 
 	void MaterialAsset::ClearRoughnessMap()
 	{
-		m_Material->Set(s_RoughnessMapUniform, Renderer::GetWhiteTexture());
+		SetMapTexture(m_MapTextures.RoughnessMap, m_Data.RoughnessTexture, Renderer::GetWhiteTexture());
+	}
+
+	AssetTask MaterialAsset::SetRoughnessMapWhenLoaded(AssetHandle roughnessMap)
+	{
+		// Keep the material alive while waiting
+		Ref<MaterialAsset> material = this;
+
+		Ref<Texture2D> texture = co_await AssetManager::LoadAsync<Texture2D>(roughnessMap, AssetLoadPriority::Normal);
+
+		// The map could have been changed while waiting
+		if (texture && m_Maps.RoughnessMap == roughnessMap)
+		{
+			SetMapTexture(m_MapTextures.RoughnessMap, m_Data.RoughnessTexture, texture);
+			SetRoughness(1.0f);
+		}
 	}
 
 	Ref<Texture2D> MaterialAsset::GetMetalnessMap()
 	{
-		return m_Material->GetTexture2D(s_MetalnessMapUniform);
+		return m_MapTextures.MetalnessMap;
 	}
 
 	void MaterialAsset::SetMetalnessMap(AssetHandle metalnessMap, bool setImmediatly)
@@ -323,25 +403,13 @@ namespace Iris {
 		{
 			if (setImmediatly)
 			{
-				Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(metalnessMap);
-				m_Material->Set(s_MetalnessMapUniform, texture);
+				SetMapTexture(m_MapTextures.MetalnessMap, m_Data.MetalnessTexture, AssetManager::GetAsset<Texture2D>(metalnessMap));
 			}
 			else
 			{
-				Project::GetEditorAssetManager()->AddPostSyncTask([this, metalnessMap]() -> bool
-				{
-					AsyncAssetResult<Texture2D> result = AssetManager::GetAssetAsync<Texture2D>(metalnessMap);
-					if (result.IsReady)
-					{
-						m_Material->Set(s_MetalnessMapUniform, result.Asset);
-						SetMetalness(1.0f);
-						return true;
-					}
-
-					// Otherwise we set defaults until the map is loaded
-					SetMetalness(0.0f);
-					return false;
-				}, true);
+				// Otherwise we set defaults until the map is loaded
+				SetMetalness(0.0f);
+				SetMetalnessMapWhenLoaded(metalnessMap);
 			}
 
 			AssetManager::RegisterDependency(metalnessMap, Handle);
@@ -354,7 +422,22 @@ namespace Iris {
 
 	void MaterialAsset::ClearMetalnessMap()
 	{
-		m_Material->Set(s_MetalnessMapUniform, Renderer::GetWhiteTexture());
+		SetMapTexture(m_MapTextures.MetalnessMap, m_Data.MetalnessTexture, Renderer::GetWhiteTexture());
+	}
+
+	AssetTask MaterialAsset::SetMetalnessMapWhenLoaded(AssetHandle metalnessMap)
+	{
+		// Keep the material alive while waiting
+		Ref<MaterialAsset> material = this;
+
+		Ref<Texture2D> texture = co_await AssetManager::LoadAsync<Texture2D>(metalnessMap, AssetLoadPriority::Normal);
+
+		// The map could have been changed while waiting
+		if (texture && m_Maps.MetalnessMap == metalnessMap)
+		{
+			SetMapTexture(m_MapTextures.MetalnessMap, m_Data.MetalnessTexture, texture);
+			SetMetalness(1.0f);
+		}
 	}
 
 	void MaterialAsset::SetDefaults()
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "AssetManager/Asset/Asset.h"
+#include "AssetManager/Asset/AssetTask.h"
 #include "Core/Base.h"
 #include "Material.h"
+#include "Renderer/BindlessTable.h"
 
 namespace Iris {
 
@@ -10,6 +12,9 @@ namespace Iris {
 	 * This is basically a PBR material for loaded meshes to use for rendering...
 	 * The other material type is just a general material for general uses such as creating a custom renderpass for a custom shader and you need a material to
 	 * handle some material resources like textures... e.g. the renderer2D quad passes uses a quad material to set textures for quads...
+	 *
+	 * The parameters and the bindless slots of the maps live in a slot of the material buffer of the BindlessTable instead of the Material's uniforms,
+	 * the Material is still what holds the shader, the permutations and the flags
 	 */
 
 	class MaterialAsset : public Asset
@@ -24,6 +29,9 @@ namespace Iris {
 
 		virtual void OnDependencyUpdated(AssetHandle handle) override;
 
+		// Slot of the material in the material buffer of the BindlessTable, uploads the parameters if they changed since the last call. Main thread only
+		uint32_t GetBindlessIndex();
+
 		glm::vec3& GetAlbedoColor();
 		void SetAlbedoColor(const glm::vec3& color);
 
@@ -77,11 +85,33 @@ namespace Iris {
 
 	private:
 		void SetDefaults();
+		// Takes over the parameters, permutations and maps the wrapped material already holds
+		void CopyMaterialValues();
+		void SetMapTexture(Ref<Texture2D>& map, uint32_t& textureIndex, const Ref<Texture2D>& texture);
+
+	private:
+		// Set the maps once their textures are loaded, the defaults are used in the meantime
+		AssetTask SetAlbedoMapWhenLoaded(AssetHandle albedoMap);
+		AssetTask SetNormalMapWhenLoaded(AssetHandle normalMap);
+		AssetTask SetRoughnessMapWhenLoaded(AssetHandle roughnessMap);
+		AssetTask SetMetalnessMapWhenLoaded(AssetHandle metalnessMap);
 
 	private:
 		Ref<Material> m_Material;
 		bool m_Transparent = false;
 
+		BindlessMaterialData m_Data;
+		BindlessMaterialData m_UploadedData; // What is in the material buffer, the getters hand out references so changes are only found by comparing
+		uint32_t m_BindlessIndex = BindlessTable::InvalidIndex;
+
+		struct MapTextures
+		{
+			Ref<Texture2D> AlbedoMap;
+			Ref<Texture2D> NormalMap;
+			Ref<Texture2D> RoughnessMap;
+			Ref<Texture2D> MetalnessMap;
+		} m_MapTextures;
+
 		struct MapAssets
 		{
 			AssetHandle AlbedoMap = 0;
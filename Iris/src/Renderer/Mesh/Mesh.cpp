@@ -42,19 +42,41 @@ namespace Iris {
 		};
 		m_SubMeshes.push_back(subMesh);
 
-		m_VertexBuffer = VertexBuffer::Create(m_Vertices.data(), static_cast<uint32_t>(m_Vertices.size() * sizeof(MeshUtils::Vertex)));
-		m_IndexBuffer = IndexBuffer::Create(m_Indices.data(), static_cast<uint32_t>(m_Indices.size() * sizeof(MeshUtils::Index)));
+		AllocateGeometry();
 	}
 
 	MeshSource::MeshSource(const std::vector<MeshUtils::Vertex>& vertices, const std::vector<MeshUtils::Index>& indices, const std::vector<MeshUtils::SubMesh>& subMeshes)
 		: m_Vertices(vertices), m_Indices(indices), m_SubMeshes(subMeshes)
 	{
-		m_VertexBuffer = VertexBuffer::Create(m_Vertices.data(), static_cast<uint32_t>(m_Vertices.size() * sizeof(MeshUtils::Vertex)));
-		m_IndexBuffer = IndexBuffer::Create(m_Indices.data(), static_cast<uint32_t>(m_Indices.size() * sizeof(MeshUtils::Index)));
+		AllocateGeometry();
 	}
 
 	MeshSource::~MeshSource()
 	{
+		GeometryHeap::Free(m_GeometryHandle);
+	}
+
+	void MeshSource::AllocateGeometry()
+	{
+		if (m_Vertices.empty() || m_Indices.empty())
+			return;
+
+		m_GeometryHandle = GeometryHeap::Allocate(m_Vertices.data(), static_cast<uint32_t>(m_Vertices.size()), m_Indices.data(), static_cast<uint32_t>(m_Indices.size() * 3));
+	}
+
+	uint64_t MeshSource::GetCPUMemoryUsage() const
+	{
+		uint64_t size = m_Vertices.size() * sizeof(MeshUtils::Vertex) + m_Indices.size() * sizeof(MeshUtils::Index);
+		for (const auto& [subMeshIndex, triangles] : m_TriangleCache)
+			size += triangles.size() * sizeof(MeshUtils::Triangle);
+
+		return size;
+	}
+
+	uint64_t MeshSource::GetGPUMemoryUsage() const
+	{
+		const GeometryAllocation geometry = GetGeometry();
+		return static_cast<uint64_t>(geometry.VertexCount) * sizeof(MeshUtils::Vertex) + static_cast<uint64_t>(geometry.IndexCount) * sizeof(uint32_t);
 	}
 
 	void MeshSource::DumpVertexBuffer()
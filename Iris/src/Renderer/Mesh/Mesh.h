@@ -3,6 +3,7 @@
 #include "AssetManager/Asset/Asset.h"
 #include "Core/AABB.h"
 #include "MaterialAsset.h"
+#include "Renderer/GeometryHeap.h"
 #include "Renderer/IndexBuffer.h"
 #include "Renderer/VertexBuffer.h"
 
@@ -88,8 +89,8 @@ namespace Iris {
 		std::vector<MeshUtils::SubMesh>& GetSubMeshes() { return m_SubMeshes; }
 		const std::vector<MeshUtils::SubMesh>& GetSubMeshes() const { return m_SubMeshes; }
 
-		Ref<VertexBuffer> GetVertexBuffer() const { return m_VertexBuffer; }
-		Ref<IndexBuffer> GetIndexBuffer() const { return m_IndexBuffer; }
+		// Where the vertices and indices currently are in the geometry heap, the offsets can change between frames when the heap gets compacted
+		GeometryAllocation GetGeometry() const { return GeometryHeap::GetAllocation(m_GeometryHandle); }
 
 		const std::vector<MeshUtils::Vertex>& GetVertices() const { return m_Vertices; }
 		const std::vector<MeshUtils::Index>& GetIndices() const { return m_Indices; }
@@ -107,16 +108,22 @@ namespace Iris {
 		// For debugging
 		void DumpVertexBuffer();
 
+		virtual uint64_t GetCPUMemoryUsage() const override;
+		virtual uint64_t GetGPUMemoryUsage() const override;
+
 		static AssetType GetStaticType() { return AssetType::MeshSource; }
 		virtual AssetType GetAssetType() const override { return GetStaticType(); }
 
+	private:
+		// Has to be called once the vertices and indices are final since the heap keeps pointing at them
+		void AllocateGeometry();
+
 	private:
 		std::string m_AssetPath;
 
 		std::vector<MeshUtils::SubMesh> m_SubMeshes;
 
-		Ref<VertexBuffer> m_VertexBuffer;
-		Ref<IndexBuffer> m_IndexBuffer;
+		uint32_t m_GeometryHandle = GeometryHeap::InvalidHandle;
 
 		std::vector<MeshUtils::Vertex> m_Vertices;
 		std::vector<MeshUtils::Index> m_Indices;
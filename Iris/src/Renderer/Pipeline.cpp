@@ -1,11 +1,50 @@
 #include "IrisPCH.h"
 #include "Pipeline.h"
 
+#include "Core/Hash.h"
+#include "Core/WorkerPool.h"
 #include "Renderer.h"
+#include "Renderer/Core/PipelineCache.h"
 #include "Renderer/Core/RendererContext.h"
 
 namespace Iris {
 
+	// Everything vkCreateGraphicsPipelines reads through pointers, kept alive until the worker is done with it
+	struct PipelineCompileJob
+	{
+		std::vector<VkVertexInputBindingDescription> VertexInputBindings;
+		std::vector<VkVertexInputAttributeDescription> VertexInputAttributes;
+		std::vector<VkDynamicState> DynamicStates;
+		std::vector<VkPipelineColorBlendAttachmentState> BlendAttachmentStates;
+		std::vector<VkFormat> ColorAttachmentFormats;
+		std::vector<VkPipelineShaderStageCreateInfo> ShaderStages;
+		std::vector<VkSpecializationMapEntry> SpecializationEntries;
+		std::vector<VkBool32> SpecializationData;
+
+		VkPipelineVertexInputStateCreateInfo VertexInputState;
+		VkPipelineInputAssemblyStateCreateInfo InputAssemblyState;
+		VkPipelineViewportStateCreateInfo ViewportState;
+		VkPipelineDynamicStateCreateInfo DynamicState;
+		VkPipelineRasterizationStateCreateInfo RasterizationState;
+		VkPipelineMultisampleStateCreateInfo MultisampleState;
+		VkPipelineDepthStencilStateCreateInfo DepthStencilState;
+		VkPipelineColorBlendStateCreateInfo ColorBlendState;
+		VkPipelineRenderingCreateInfo RenderingInfo;
+		VkSpecializationInfo SpecializationInfo;
+		VkGraphicsPipelineCreateInfo PipelineInfo;
+
+		VkPipelineLayout Layout = VK_NULL_HANDLE; // Owned by the job unless it compiles a variant or the pipeline already uses it
+		uint64_t ResourceSignature = 0;
+
+		Ref<WorkerTask> Task;
+		VkPipeline Result = VK_NULL_HANDLE; // Only valid once the task is done
+	};
+
+	// Compiles per shader module, a module may only be destroyed once no worker is creating a pipeline from it anymore.
+	// Tasks that are done get dropped whenever a new compile of the same module is added
+	static std::mutex s_PendingCompilationsMutex;
+	static std::unordered_map<VkShaderModule, std::vector<Ref<WorkerTask>>> s_PendingCompilations;
+
 	namespace Utils {
 
 		inline constexpr VkPrimitiveTopology GetVulkanTopologyFromTopology(PrimitiveTopology topology)
@@ -64,6 +103,32 @@ namespace Iris {
 			return VK_FORMAT_UNDEFINED;
 		}
 
+		// Changes whenever the descriptor set or push constant layout of the shader changes, in which case the materials that already got
+		// reloaded can not be bound with the previous pipeline layout anymore
+		static uint64_t GetShaderResourceSignature(const Ref<Shader>& shader)
+		{
+			uint64_t signature = 0;
+
+			const std::vector<ShaderResources::ShaderDescriptorSet>& descriptorSets = shader->GetShaderDescriptorSets();
+			for (uint32_t set = 0; set < descriptorSets.size(); set++)
+			{
+				// Summed so that the iteration order of the map does not matter
+				for (const auto& [name, writeDescriptorSet] : descriptorSets[set].WriteDescriptorSets)
+				{
+					const uint32_t resource[4] = { set, writeDescriptorSet.dstBinding, static_cast<uint32_t>(writeDescriptorSet.descriptorType), writeDescriptorSet.descriptorCount };
+					signature += Hash::GenerateFNVHash64(std::string_view(reinterpret_cast<const char*>(resource), sizeof(resource)));
+				}
+			}
+
+			for (const ShaderResources::PushConstantRange& pushConstantRange : shader->GetPushConstantRanges())
+			{
+				const uint32_t range[3] = { static_cast<uint32_t>(pushConstantRange.ShaderStage), pushConstantRange.Offset, pushConstantRange.Size };
+				signature += Hash::GenerateFNVHash64(std::string_view(reinterpret_cast<const char*>(range), sizeof(range)));
+			}
+
+			return signature;
+		}
+
 	}
 
 	Ref<Pipeline> Pipeline::Create(const PipelineSpecification& spec)
@@ -85,6 +150,8 @@ namespace Iris {
 
 	Pipeline::~Pipeline()
 	{
+		RT_DiscardPendingCompile();
+		RT_ReleaseVariants();
 		Release();
 	}
 
@@ -93,226 +160,267 @@ namespace Iris {
 		Ref<Pipeline> instance = this;
 		Renderer::Submit([instance]() mutable
 		{
-			VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
 			IR_ASSERT(instance->m_Specification.Shader);
 
-			// Make sure past resources are cleared in case we are reloading shaders
-			instance->Release();
-
-			// Setting up the pipeline with the VkPipelineVertexInputStateCreateInfo struct to accept the vertex data that will be 
-			// passed to the vertex buffer
-
-			std::vector<VkVertexInputBindingDescription> vertexInputBindingDescriptions;
+			// The previous pipeline keeps being used until the new one is compiled, only a newer request replaces a pending one. Variants were
+			// created from the previous shader so they get compiled again once they are asked for
+			instance->RT_DiscardPendingCompile();
+			instance->RT_ReleaseVariants();
+			instance->m_PendingCompile = instance->RT_CreateCompileJob(instance->m_Specification.Shader->GetDefaultPermutationKey(), VK_NULL_HANDLE);
 
-			// Vertex attributes
-			VkVertexInputBindingDescription vertexInputBinding = {
-				.binding = 0,
-				.stride = instance->m_Specification.VertexLayout.GetStride(),
-				.inputRate = VK_VERTEX_INPUT_RATE_VERTEX
-			};
-			vertexInputBindingDescriptions.push_back(vertexInputBinding);
-
-			// Instance attributes
-			if (instance->m_Specification.InstanceLayout.GetElementCount())
+			// Materials get reloaded right away against the new descriptor set layouts, if those changed the previous pipeline can not be used with
+			// them anymore. Without a pipeline to fall back to the layout is used right away so that the sets can still be bound, the draws are
+			// skipped by the renderer until the compile is done
+			if (instance->m_VulkanPipeline && instance->m_PendingCompile->ResourceSignature != instance->m_ResourceSignature)
 			{
-				VkVertexInputBindingDescription instanceInputBinding = {
-					.binding = 1,
-					.stride = instance->m_Specification.InstanceLayout.GetStride(),
-					.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE
-				};
-				vertexInputBindingDescriptions.push_back(instanceInputBinding);
+				instance->Release();
+				instance->m_VulkanPipeline = nullptr;
 			}
 
-			// Description for shader input attributes and their memory layouts
-			std::vector<VkVertexInputAttributeDescription> vertexInputAttributesDescriptions(instance->m_Specification.VertexLayout.GetElementCount() + instance->m_Specification.InstanceLayout.GetElementCount());
-
-			uint32_t binding = 0;
-			uint32_t location = 0;
-			std::array<VertexInputLayout, 2> pipelineLayouts = { instance->m_Specification.VertexLayout, instance->m_Specification.InstanceLayout };
-			for (const auto& layout : pipelineLayouts)
+			if (!instance->m_VulkanPipeline)
 			{
-				for (const auto& element : layout)
-				{
-					vertexInputAttributesDescriptions[location].binding = binding;
-					vertexInputAttributesDescriptions[location].location = location;
-					vertexInputAttributesDescriptions[location].format = Utils::GetVulkanFormatFromShaderDataType(element.Type);
-					vertexInputAttributesDescriptions[location].offset = element.Offset;
-
-					location++;
-				}
-
-				binding++;
+				instance->m_PipelineLayout = instance->m_PendingCompile->Layout;
+				instance->m_ResourceSignature = instance->m_PendingCompile->ResourceSignature;
 			}
+		});
+	}
 
-			VkPipelineVertexInputStateCreateInfo vertexInputState = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-				.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexInputBindingDescriptions.size()),
-				.pVertexBindingDescriptions = vertexInputBindingDescriptions.data(),
-				.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributesDescriptions.size()),
-				.pVertexAttributeDescriptions = vertexInputAttributesDescriptions.data()
-			};
+	Scope<PipelineCompileJob> Pipeline::RT_CreateCompileJob(uint32_t permutationKey, VkPipelineLayout layout)
+	{
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
 
-			// Input assembly state describes how primitives are assembled
-			VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-				.topology = Utils::GetVulkanTopologyFromTopology(instance->m_Specification.Topology)
-			};
+		Scope<PipelineCompileJob> compileJob = CreateScope<PipelineCompileJob>();
+		PipelineCompileJob& job = *compileJob;
 
-			// VkViewport viewport = {
-			// 	.x = 0.0f,
-			// 	.y = 0.0f,
-			// 	.width = (float)m_Window->GetWidth(),
-			// 	.height = (float)m_Window->GetHeight(),
-			// 	.minDepth = 0.0f,
-			// 	.maxDepth = 1.0f
-			// };
-
-			// VkRect2D scissor = {
-			// 	.offset = {.x = 0, .y = 0 },
-			// 	.extent = {.width = 0, .height = 0 }
-			// };
-
-			// viewport state sets the number of viewport and scissor used in this pipeline however it is overidden by the dynamic state
-			VkPipelineViewportStateCreateInfo viewportStateInfo = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
-				.viewportCount = 1,
-				// .pViewports = &viewport, // If we want to statically bake the viewport state into the pipeline
-				.scissorCount = 1,
-				// .pScissors = &scissor // If we want to statically bake the scissor rectangle into the pipeline
-			};
+		// Setting up the pipeline with the VkPipelineVertexInputStateCreateInfo struct to accept the vertex data that will be 
+		// passed to the vertex buffer
 
-			// Enable dynamic states
-			// Most states are baked into the pipeline, but there are still a few dynamic states that can be changed within a command buffer
-			// To be able to change these we need do specify which dynamic states will be changed using this pipeline. Their actual states are set later on in the command buffer.
-			// For this example we will set the viewport and scissor using dynamic states
-			// NOTE: If we want to bake the `viewport` and `scissor` states statically into the pipeline: Check in the above struct the comments
-			std::vector<VkDynamicState> dynamicStateEnables = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-			if (instance->IsDynamicLineWidth())
-				dynamicStateEnables.push_back(VK_DYNAMIC_STATE_LINE_WIDTH);
-
-			VkPipelineDynamicStateCreateInfo dynamicState = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-				.dynamicStateCount = static_cast<uint32_t>(dynamicStateEnables.size()),
-				.pDynamicStates = dynamicStateEnables.data()
-			};
+		std::vector<VkVertexInputBindingDescription>& vertexInputBindingDescriptions = job.VertexInputBindings;
 
-			VkPipelineRasterizationStateCreateInfo rasterizationState = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
-				.depthClampEnable = VK_FALSE,
-				.rasterizerDiscardEnable = VK_FALSE,
-				.polygonMode = instance->m_Specification.WireFrame ? VK_POLYGON_MODE_LINE : VK_POLYGON_MODE_FILL,
-				.frontFace = VK_FRONT_FACE_CLOCKWISE, // default for vkPlayground
-				.depthBiasEnable = VK_FALSE,
-				.lineWidth = instance->m_Specification.LineWidth // Dynamic
-			};
-			rasterizationState.cullMode = instance->m_Specification.BackFaceCulling ? VK_CULL_MODE_BACK_BIT : VK_CULL_MODE_NONE; // Causes an error in aggregate init lol
+		// Vertex attributes
+		VkVertexInputBindingDescription vertexInputBinding = {
+			.binding = 0,
+			.stride = m_Specification.VertexLayout.GetStride(),
+			.inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+		};
+		vertexInputBindingDescriptions.push_back(vertexInputBinding);
 
-			VkPipelineMultisampleStateCreateInfo multiSampleState = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-				.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
-				.pSampleMask = nullptr,
+		// Instance attributes
+		if (m_Specification.InstanceLayout.GetElementCount())
+		{
+			VkVertexInputBindingDescription instanceInputBinding = {
+				.binding = 1,
+				.stride = m_Specification.InstanceLayout.GetStride(),
+				.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE
 			};
+			vertexInputBindingDescriptions.push_back(instanceInputBinding);
+		}
 
-			VkPipelineDepthStencilStateCreateInfo depthStencilState = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-				.depthTestEnable = instance->m_Specification.DepthTest ? VK_TRUE : VK_FALSE,
-				.depthWriteEnable = instance->m_Specification.DepthWrite ? VK_TRUE : VK_FALSE,
-				.depthCompareOp = Utils::GetVulkanCompareOpFromDepthComarator(instance->m_Specification.DepthOperator),
-				.depthBoundsTestEnable = VK_FALSE,
-				.stencilTestEnable = VK_FALSE,
-				.front = {
-					.failOp = VK_STENCIL_OP_KEEP,
-					.passOp = VK_STENCIL_OP_KEEP,
-					.compareOp = VK_COMPARE_OP_ALWAYS
-				},
-				.back = {
-					.failOp = VK_STENCIL_OP_KEEP,
-					.passOp = VK_STENCIL_OP_KEEP,
-					.compareOp = VK_COMPARE_OP_ALWAYS
-				}
-			};
+		// Description for shader input attributes and their memory layouts
+		std::vector<VkVertexInputAttributeDescription>& vertexInputAttributesDescriptions = job.VertexInputAttributes;
+		vertexInputAttributesDescriptions.resize(m_Specification.VertexLayout.GetElementCount() + m_Specification.InstanceLayout.GetElementCount());
 
-			// Color blend state describes how blend factors are calculated (if used)
-			// We need one blend attachment state per color attachment (even if blending is not used)
-			Ref<Framebuffer> framebuffer = instance->m_Specification.TargetFramebuffer;
-			std::size_t colorAttachmentCount = framebuffer->GetColorAttachmentCount();
-			std::vector<VkPipelineColorBlendAttachmentState> blendAttachmentStates(colorAttachmentCount);
-			if (framebuffer->GetSpecification().SwapchainTarget)
+		uint32_t binding = 0;
+		uint32_t location = 0;
+		std::array<VertexInputLayout, 2> pipelineLayouts = { m_Specification.VertexLayout, m_Specification.InstanceLayout };
+		for (const auto& layout : pipelineLayouts)
+		{
+			for (const auto& element : layout)
 			{
-				blendAttachmentStates[0] = {
-					.blendEnable = VK_TRUE,
-					.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
-					.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
-					.colorBlendOp = VK_BLEND_OP_ADD,
-					.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
-					.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
-					.alphaBlendOp = VK_BLEND_OP_ADD,
-					.colorWriteMask = 0xf  // VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
-				};
+				vertexInputAttributesDescriptions[location].binding = binding;
+				vertexInputAttributesDescriptions[location].location = location;
+				vertexInputAttributesDescriptions[location].format = Utils::GetVulkanFormatFromShaderDataType(element.Type);
+				vertexInputAttributesDescriptions[location].offset = element.Offset;
+
+				location++;
 			}
-			else
+
+			binding++;
+		}
+
+		VkPipelineVertexInputStateCreateInfo& vertexInputState = job.VertexInputState;
+		vertexInputState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+			.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexInputBindingDescriptions.size()),
+			.pVertexBindingDescriptions = vertexInputBindingDescriptions.data(),
+			.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributesDescriptions.size()),
+			.pVertexAttributeDescriptions = vertexInputAttributesDescriptions.data()
+		};
+
+		// Input assembly state describes how primitives are assembled
+		VkPipelineInputAssemblyStateCreateInfo& inputAssemblyState = job.InputAssemblyState;
+		inputAssemblyState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+			.topology = Utils::GetVulkanTopologyFromTopology(m_Specification.Topology)
+		};
+
+		// VkViewport viewport = {
+		// 	.x = 0.0f,
+		// 	.y = 0.0f,
+		// 	.width = (float)m_Window->GetWidth(),
+		// 	.height = (float)m_Window->GetHeight(),
+		// 	.minDepth = 0.0f,
+		// 	.maxDepth = 1.0f
+		// };
+
+		// VkRect2D scissor = {
+		// 	.offset = {.x = 0, .y = 0 },
+		// 	.extent = {.width = 0, .height = 0 }
+		// };
+
+		// viewport state sets the number of viewport and scissor used in this pipeline however it is overidden by the dynamic state
+		VkPipelineViewportStateCreateInfo& viewportStateInfo = job.ViewportState;
+		viewportStateInfo = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+			.viewportCount = 1,
+			// .pViewports = &viewport, // If we want to statically bake the viewport state into the pipeline
+			.scissorCount = 1,
+			// .pScissors = &scissor // If we want to statically bake the scissor rectangle into the pipeline
+		};
+
+		// Enable dynamic states
+		// Most states are baked into the pipeline, but there are still a few dynamic states that can be changed within a command buffer
+		// To be able to change these we need do specify which dynamic states will be changed using this pipeline. Their actual states are set later on in the command buffer.
+		// For this example we will set the viewport and scissor using dynamic states
+		// NOTE: If we want to bake the `viewport` and `scissor` states statically into the pipeline: Check in the above struct the comments
+		std::vector<VkDynamicState>& dynamicStateEnables = job.DynamicStates;
+		dynamicStateEnables = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		if (IsDynamicLineWidth())
+			dynamicStateEnables.push_back(VK_DYNAMIC_STATE_LINE_WIDTH);
+
+		VkPipelineDynamicStateCreateInfo& dynamicState = job.DynamicState;
+		dynamicState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+			.dynamicStateCount = static_cast<uint32_t>(dynamicStateEnables.size()),
+			.pDynamicStates = dynamicStateEnables.data()
+		};
+
+		VkPipelineRasterizationStateCreateInfo& rasterizationState = job.RasterizationState;
+		rasterizationState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+			.depthClampEnable = VK_FALSE,
+			.rasterizerDiscardEnable = VK_FALSE,
+			.polygonMode = m_Specification.WireFrame ? VK_POLYGON_MODE_LINE : VK_POLYGON_MODE_FILL,
+			.frontFace = VK_FRONT_FACE_CLOCKWISE, // default for vkPlayground
+			.depthBiasEnable = VK_FALSE,
+			.lineWidth = m_Specification.LineWidth // Dynamic
+		};
+		rasterizationState.cullMode = m_Specification.BackFaceCulling ? VK_CULL_MODE_BACK_BIT : VK_CULL_MODE_NONE; // Causes an error in aggregate init lol
+
+		VkPipelineMultisampleStateCreateInfo& multiSampleState = job.MultisampleState;
+		multiSampleState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+			.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+			.pSampleMask = nullptr,
+		};
+
+		VkPipelineDepthStencilStateCreateInfo& depthStencilState = job.DepthStencilState;
+		depthStencilState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+			.depthTestEnable = m_Specification.DepthTest ? VK_TRUE : VK_FALSE,
+			.depthWriteEnable = m_Specification.DepthWrite ? VK_TRUE : VK_FALSE,
+			.depthCompareOp = Utils::GetVulkanCompareOpFromDepthComarator(m_Specification.DepthOperator),
+			.depthBoundsTestEnable = VK_FALSE,
+			.stencilTestEnable = VK_FALSE,
+			.front = {
+				.failOp = VK_STENCIL_OP_KEEP,
+				.passOp = VK_STENCIL_OP_KEEP,
+				.compareOp = VK_COMPARE_OP_ALWAYS
+			},
+			.back = {
+				.failOp = VK_STENCIL_OP_KEEP,
+				.passOp = VK_STENCIL_OP_KEEP,
+				.compareOp = VK_COMPARE_OP_ALWAYS
+			}
+		};
+
+		// Color blend state describes how blend factors are calculated (if used)
+		// We need one blend attachment state per color attachment (even if blending is not used)
+		Ref<Framebuffer> framebuffer = m_Specification.TargetFramebuffer;
+		std::size_t colorAttachmentCount = framebuffer->GetColorAttachmentCount();
+		std::vector<VkPipelineColorBlendAttachmentState>& blendAttachmentStates = job.BlendAttachmentStates;
+		blendAttachmentStates.resize(colorAttachmentCount);
+		if (framebuffer->GetSpecification().SwapchainTarget)
+		{
+			blendAttachmentStates[0] = {
+				.blendEnable = VK_TRUE,
+				.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+				.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+				.colorBlendOp = VK_BLEND_OP_ADD,
+				.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+				.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+				.alphaBlendOp = VK_BLEND_OP_ADD,
+				.colorWriteMask = 0xf  // VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+			};
+		}
+		else
+		{
+			for (std::size_t i = 0; i < colorAttachmentCount; i++)
 			{
-				for (std::size_t i = 0; i < colorAttachmentCount; i++)
-				{
-					if (!framebuffer->GetSpecification().Blend)
-						break;
+				if (!framebuffer->GetSpecification().Blend)
+					break;
 
-					blendAttachmentStates[i].colorWriteMask = 0xf;
+				blendAttachmentStates[i].colorWriteMask = 0xf;
 
-					const FramebufferTextureSpecification& attachmentSpec = framebuffer->GetSpecification().Attachments.Attachments[i];
-					FramebufferBlendMode blendMode;
-					if (framebuffer->GetSpecification().BlendMode == FramebufferBlendMode::None)
-						blendMode = attachmentSpec.BlendMode;
-					else
-						blendMode = framebuffer->GetSpecification().BlendMode;
+				const FramebufferTextureSpecification& attachmentSpec = framebuffer->GetSpecification().Attachments.Attachments[i];
+				FramebufferBlendMode blendMode;
+				if (framebuffer->GetSpecification().BlendMode == FramebufferBlendMode::None)
+					blendMode = attachmentSpec.BlendMode;
+				else
+					blendMode = framebuffer->GetSpecification().BlendMode;
 
-					blendAttachmentStates[i].blendEnable = attachmentSpec.Blend ? VK_TRUE : VK_FALSE;
+				blendAttachmentStates[i].blendEnable = attachmentSpec.Blend ? VK_TRUE : VK_FALSE;
 
-					blendAttachmentStates[i].colorBlendOp = VK_BLEND_OP_ADD;
-					blendAttachmentStates[i].alphaBlendOp = VK_BLEND_OP_ADD;
-					blendAttachmentStates[i].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-					blendAttachmentStates[i].dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+				blendAttachmentStates[i].colorBlendOp = VK_BLEND_OP_ADD;
+				blendAttachmentStates[i].alphaBlendOp = VK_BLEND_OP_ADD;
+				blendAttachmentStates[i].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+				blendAttachmentStates[i].dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
 
-					switch (blendMode)
+				switch (blendMode)
+				{
+					case FramebufferBlendMode::OneZero:
 					{
-						case FramebufferBlendMode::OneZero:
-						{
-							blendAttachmentStates[i].srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
-							blendAttachmentStates[i].dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-
-							break;
-						}
-						case FramebufferBlendMode::SrcAlphaOneMinusSrcAlpha:
-						{
-							blendAttachmentStates[i].srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-							blendAttachmentStates[i].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-							blendAttachmentStates[i].srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-							blendAttachmentStates[i].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-
-							break;
-						}
-						case FramebufferBlendMode::ZeroSrcColor:
-						{
-							blendAttachmentStates[i].srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-							blendAttachmentStates[i].dstColorBlendFactor = VK_BLEND_FACTOR_SRC_COLOR;
-
-							break;
-						}
-						default:
-							IR_ASSERT(false);
+						blendAttachmentStates[i].srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+						blendAttachmentStates[i].dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+
+						break;
 					}
+					case FramebufferBlendMode::SrcAlphaOneMinusSrcAlpha:
+					{
+						blendAttachmentStates[i].srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+						blendAttachmentStates[i].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+						blendAttachmentStates[i].srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+						blendAttachmentStates[i].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+						break;
+					}
+					case FramebufferBlendMode::ZeroSrcColor:
+					{
+						blendAttachmentStates[i].srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+						blendAttachmentStates[i].dstColorBlendFactor = VK_BLEND_FACTOR_SRC_COLOR;
+
+						break;
+					}
+					default:
+						IR_ASSERT(false);
 				}
 			}
+		}
 
-			VkPipelineColorBlendStateCreateInfo colorBlendState = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-				.logicOpEnable = VK_FALSE,
-				.attachmentCount = static_cast<uint32_t>(blendAttachmentStates.size()),
-				.pAttachments = blendAttachmentStates.data()
-			};
+		VkPipelineColorBlendStateCreateInfo& colorBlendState = job.ColorBlendState;
+		colorBlendState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+			.logicOpEnable = VK_FALSE,
+			.attachmentCount = static_cast<uint32_t>(blendAttachmentStates.size()),
+			.pAttachments = blendAttachmentStates.data()
+		};
 
-			Ref<Shader> shader = instance->m_Specification.Shader;
+		Ref<Shader> shader = m_Specification.Shader;
 
+		// Variants share the layout of the pipeline so the descriptor sets and push constants stay valid when switching between them
+		job.Layout = layout;
+		if (!job.Layout)
+		{
 			const std::vector<ShaderResources::PushConstantRange>& pushConstantRanges = shader->GetPushConstantRanges();
 			std::vector<VkPushConstantRange> vulkanPushConstantRanges(pushConstantRanges.size());
 			for (uint32_t i = 0; i < pushConstantRanges.size(); i++)
@@ -335,42 +443,214 @@ namespace Iris {
 				.pPushConstantRanges = vulkanPushConstantRanges.data()
 			};
 
-			VK_CHECK_RESULT(vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &(instance->m_PipelineLayout)));
+			VK_CHECK_RESULT(vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &job.Layout));
+		}
+
+		job.ResourceSignature = Utils::GetShaderResourceSignature(shader);
 
-			const auto& shaderStages = shader->GetPipelineShaderStageCreateInfos();
+		const std::vector<VkPipelineShaderStageCreateInfo>& shaderStages = job.ShaderStages = shader->GetPipelineShaderStageCreateInfos();
 
-			VkPipelineRenderingCreateInfo pipelineRenderingInfo = {
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
-				.colorAttachmentCount = static_cast<uint32_t>(colorAttachmentCount),
-				.pColorAttachmentFormats = framebuffer->GetColorAttachmentImageFormats().data(),
-				.depthAttachmentFormat = framebuffer->HasDepthAttachment() ? framebuffer->GetDepthAttachmentImageFormat() : VK_FORMAT_UNDEFINED,
-				.stencilAttachmentFormat = framebuffer->HasDepthAttachment() ? framebuffer->GetDepthAttachmentImageFormat() : VK_FORMAT_UNDEFINED
+		// Every permutation is a boolean specialization constant, the bits of the key are their values
+		const std::vector<ShaderResources::ShaderPermutation>& permutations = shader->GetPermutations();
+		if (!permutations.empty())
+		{
+			for (uint32_t i = 0; i < permutations.size(); i++)
+			{
+				job.SpecializationEntries.push_back({ .constantID = i, .offset = i * static_cast<uint32_t>(sizeof(VkBool32)), .size = sizeof(VkBool32) });
+				job.SpecializationData.push_back((permutationKey >> i) & 1 ? VK_TRUE : VK_FALSE);
+			}
+
+			job.SpecializationInfo = {
+				.mapEntryCount = static_cast<uint32_t>(job.SpecializationEntries.size()),
+				.pMapEntries = job.SpecializationEntries.data(),
+				.dataSize = job.SpecializationData.size() * sizeof(VkBool32),
+				.pData = job.SpecializationData.data()
 			};
 
-			VkGraphicsPipelineCreateInfo pipelineInfo = {};
-			pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-			pipelineInfo.pNext = &pipelineRenderingInfo;
-			pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
-			pipelineInfo.pStages = shaderStages.data();
-			pipelineInfo.pVertexInputState = &vertexInputState;
-			pipelineInfo.pInputAssemblyState = &inputAssemblyState;
-			pipelineInfo.pViewportState = &viewportStateInfo;
-			pipelineInfo.pRasterizationState = &rasterizationState;
-			pipelineInfo.pMultisampleState = &multiSampleState;
-			pipelineInfo.pDepthStencilState = &depthStencilState;
-			pipelineInfo.pColorBlendState = &colorBlendState;
-			pipelineInfo.pDynamicState = &dynamicState;
-			pipelineInfo.layout = instance->m_PipelineLayout;
-			pipelineInfo.renderPass = VK_NULL_HANDLE;
-
-			VK_CHECK_RESULT(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &(instance->m_VulkanPipeline)));
-			VKUtils::SetDebugUtilsObjectName(device, VK_OBJECT_TYPE_PIPELINE, instance->m_Specification.DebugName, instance->m_VulkanPipeline);
-
-			if (instance->m_Specification.ReleaseShaderModules)
-				shader->ReleaseShaderModules();
+			for (VkPipelineShaderStageCreateInfo& shaderStage : job.ShaderStages)
+				shaderStage.pSpecializationInfo = &job.SpecializationInfo;
+		}
+
+		job.ColorAttachmentFormats = framebuffer->GetColorAttachmentImageFormats();
+
+		VkPipelineRenderingCreateInfo& pipelineRenderingInfo = job.RenderingInfo;
+		pipelineRenderingInfo = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+			.colorAttachmentCount = static_cast<uint32_t>(colorAttachmentCount),
+			.pColorAttachmentFormats = job.ColorAttachmentFormats.data(),
+			.depthAttachmentFormat = framebuffer->HasDepthAttachment() ? framebuffer->GetDepthAttachmentImageFormat() : VK_FORMAT_UNDEFINED,
+			.stencilAttachmentFormat = framebuffer->HasDepthAttachment() ? framebuffer->GetDepthAttachmentImageFormat() : VK_FORMAT_UNDEFINED
+		};
+
+		VkGraphicsPipelineCreateInfo& pipelineInfo = job.PipelineInfo;
+		pipelineInfo = {};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.pNext = &pipelineRenderingInfo;
+		pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+		pipelineInfo.pStages = shaderStages.data();
+		pipelineInfo.pVertexInputState = &vertexInputState;
+		pipelineInfo.pInputAssemblyState = &inputAssemblyState;
+		pipelineInfo.pViewportState = &viewportStateInfo;
+		pipelineInfo.pRasterizationState = &rasterizationState;
+		pipelineInfo.pMultisampleState = &multiSampleState;
+		pipelineInfo.pDepthStencilState = &depthStencilState;
+		pipelineInfo.pColorBlendState = &colorBlendState;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = job.Layout;
+		pipelineInfo.renderPass = VK_NULL_HANDLE;
+
+		// The driver compiles the shaders in here which is what takes long, the result is picked up by RT_GetVulkanPipeline
+		job.Task = WorkerPool::Submit([device, job = &job]()
+		{
+			Timer timer;
+			VkPipelineCache pipelineCache = PipelineCache::Acquire();
+			VK_CHECK_RESULT(vkCreateGraphicsPipelines(device, pipelineCache, 1, &job->PipelineInfo, nullptr, &job->Result));
+			PipelineCache::Release(pipelineCache);
+			PipelineCache::AddPipelineCreationTime(timer.ElapsedMillis());
+		});
+
+		{
+			std::scoped_lock<std::mutex> lock(s_PendingCompilationsMutex);
+			for (const VkPipelineShaderStageCreateInfo& shaderStage : job.ShaderStages)
+			{
+				std::vector<Ref<WorkerTask>>& compilations = s_PendingCompilations[shaderStage.module];
+				std::erase_if(compilations, [](const Ref<WorkerTask>& task) { return task->IsReady(); });
+				compilations.push_back(job.Task);
+			}
+		}
+
+		return compileJob;
+	}
+
+	VkPipeline Pipeline::RT_GetVulkanPipeline()
+	{
+		// Keep rendering with the previous pipeline until the new one is ready, that is null if there was none before
+		if (!m_PendingCompile || !m_PendingCompile->Task->IsReady())
+			return m_VulkanPipeline;
+
+		VkPipeline pipeline = m_PendingCompile->Result;
+
+		// Without a previous pipeline the layout of the job is already in use
+		if (m_PipelineLayout != m_PendingCompile->Layout)
+			Release();
+
+		m_VulkanPipeline = pipeline;
+		m_PipelineLayout = m_PendingCompile->Layout;
+		m_ResourceSignature = m_PendingCompile->ResourceSignature;
+		m_PendingCompile.reset();
+
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		VKUtils::SetDebugUtilsObjectName(device, VK_OBJECT_TYPE_PIPELINE, m_Specification.DebugName, m_VulkanPipeline);
+
+		// Variants are compiled from the shader modules whenever a material asks for one so those have to stay around
+		if (m_Specification.ReleaseShaderModules && m_Specification.Shader->GetPermutations().empty())
+			m_Specification.Shader->ReleaseShaderModules();
+
+		return m_VulkanPipeline;
+	}
+
+	VkPipeline Pipeline::RT_GetVulkanPipeline(uint32_t permutationKey)
+	{
+		VkPipeline pipeline = RT_GetVulkanPipeline();
+
+		// While a new pipeline is being compiled neither the shader modules nor the layout the variants would be created with are settled
+		const Ref<Shader>& shader = m_Specification.Shader;
+		if (permutationKey == shader->GetDefaultPermutationKey() || m_PendingCompile || shader->GetPipelineShaderStageCreateInfos().empty())
+			return pipeline;
+
+		auto it = m_Variants.find(permutationKey);
+		if (it == m_Variants.end())
+		{
+			// Permutations only strip code that the material's uniforms skip anyway, so the default variant renders the same thing in the meantime
+			m_Variants[permutationKey].PendingCompile = RT_CreateCompileJob(permutationKey, m_PipelineLayout);
+			return pipeline;
+		}
+
+		PipelineVariant& variant = it->second;
+		if (variant.PendingCompile)
+		{
+			if (!variant.PendingCompile->Task->IsReady())
+				return pipeline;
+
+			variant.VulkanPipeline = variant.PendingCompile->Result;
+			variant.PendingCompile.reset();
+
+			VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+			VKUtils::SetDebugUtilsObjectName(device, VK_OBJECT_TYPE_PIPELINE, fmt::format("{} (Permutations {:#x})", m_Specification.DebugName, permutationKey), variant.VulkanPipeline);
+		}
+
+		return variant.VulkanPipeline;
+	}
+
+	void Pipeline::WaitForCompilations(const std::vector<VkPipelineShaderStageCreateInfo>& shaderStages)
+	{
+		std::vector<Ref<WorkerTask>> compilations;
+		{
+			std::scoped_lock<std::mutex> lock(s_PendingCompilationsMutex);
+			for (const VkPipelineShaderStageCreateInfo& shaderStage : shaderStages)
+			{
+				auto it = s_PendingCompilations.find(shaderStage.module);
+				if (it == s_PendingCompilations.end())
+					continue;
+
+				compilations.insert(compilations.end(), it->second.begin(), it->second.end());
+				s_PendingCompilations.erase(it);
+			}
+		}
+
+		for (Ref<WorkerTask>& task : compilations)
+			task->Wait();
+	}
+
+	static void DestroyPipeline(VkPipeline pipeline, VkPipelineLayout layout = VK_NULL_HANDLE)
+	{
+		Renderer::SubmitReseourceFree([pipeline, layout]()
+		{
+			VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+			vkDestroyPipeline(device, pipeline, nullptr);
+			if (layout)
+				vkDestroyPipelineLayout(device, layout, nullptr);
 		});
 	}
 
+	void Pipeline::RT_DiscardPendingCompile()
+	{
+		if (!m_PendingCompile)
+			return;
+
+		// Nothing to wait for if no worker got to it yet, the result stays null then
+		if (!m_PendingCompile->Task->Cancel())
+			m_PendingCompile->Task->Wait();
+
+		DestroyPipeline(m_PendingCompile->Result, m_PendingCompile->Layout);
+
+		// Without a pipeline to fall back to the layout of the job was already in use
+		if (m_PendingCompile->Layout == m_PipelineLayout)
+			m_PipelineLayout = nullptr;
+
+		m_PendingCompile.reset();
+	}
+
+	void Pipeline::RT_ReleaseVariants()
+	{
+		// They use the layout of the pipeline so only the pipelines themselves are destroyed
+		for (auto& [permutationKey, variant] : m_Variants)
+		{
+			VkPipeline pipeline = variant.VulkanPipeline;
+			if (variant.PendingCompile)
+			{
+				if (!variant.PendingCompile->Task->Cancel())
+					variant.PendingCompile->Task->Wait();
+
+				pipeline = variant.PendingCompile->Result;
+			}
+
+			DestroyPipeline(pipeline);
+		}
+
+		m_Variants.clear();
+	}
+
 	void Pipeline::Release()
 	{
 		if (m_VulkanPipeline && m_PipelineLayout)
@@ -69,6 +69,8 @@ namespace Iris {
 		uint64_t ComputeShaderInvocations = 0;
 	};
 
+	struct PipelineCompileJob;
+
 	class Pipeline : public RefCountedObject
 	{
 	public:
@@ -77,6 +79,7 @@ namespace Iris {
 
 		[[nodiscard]] static Ref<Pipeline> Create(const PipelineSpecification& spec);
 
+		// Creates the pipeline on the worker pool, see RT_GetVulkanPipeline
 		void Invalidate();
 
 		PipelineSpecification& GetSpecification() { return m_Specification; }
@@ -84,18 +87,42 @@ namespace Iris {
 
 		Ref<Shader> GetShader() const { return m_Specification.Shader; }
 		VkPipeline GetVulkanPipeline() { return m_VulkanPipeline; }
+		// Swaps in the pipeline of the last Invalidate once its compilation finished. Until then the previous pipeline is returned, which is null
+		// right after creation (or a change of the resource layout) since there is nothing to fall back to. The layout is valid either way and
+		// the renderer skips the draws that have no pipeline
+		VkPipeline RT_GetVulkanPipeline();
+		// The variant of the shader with the given permutation values (see ShaderResources::ShaderPermutation). Variants are compiled on a
+		// worker the first time they are asked for, the pipeline with the default permutations is returned until they are ready
+		VkPipeline RT_GetVulkanPipeline(uint32_t permutationKey);
 		VkPipelineLayout GetVulkanPipelineLayout() { return m_PipelineLayout; }
 
 		inline bool IsDynamicLineWidth() const { return m_Specification.Topology == PrimitiveTopology::Lines || m_Specification.Topology == PrimitiveTopology::LineStrip || m_Specification.WireFrame; }
 
+		// Blocks until no pipeline is being compiled from these shader modules anymore, needed before destroying them
+		static void WaitForCompilations(const std::vector<VkPipelineShaderStageCreateInfo>& shaderStages);
+
 	private:
 		void Release();
+		void RT_DiscardPendingCompile();
+		void RT_ReleaseVariants();
+		// Passing a layout creates a variant that uses it instead of creating a new one
+		Scope<PipelineCompileJob> RT_CreateCompileJob(uint32_t permutationKey, VkPipelineLayout layout);
 
 	private:
 		PipelineSpecification m_Specification;
 
 		VkPipeline m_VulkanPipeline = nullptr;
 		VkPipelineLayout m_PipelineLayout = nullptr;
+		uint64_t m_ResourceSignature = 0;
+
+		Scope<PipelineCompileJob> m_PendingCompile;
+
+		struct PipelineVariant
+		{
+			VkPipeline VulkanPipeline = nullptr;
+			Scope<PipelineCompileJob> PendingCompile;
+		};
+		std::unordered_map<uint32_t, PipelineVariant> m_Variants; // Permutation key -> variant
 	};
 
 }
\ No newline at end of file
@@ -122,8 +122,7 @@ namespace Iris {
 
 	bool RenderPass::IsInputValid(std::string_view name) const
 	{
-		std::string nameStr = std::string(name);
-		return m_DescriptorSetManager.m_InputDeclarations.contains(nameStr);
+		return m_DescriptorSetManager.GetInputDeclaration(Hash::GenerateFNVHash(name)) != nullptr;
 	}
 
 }
\ No newline at end of file
@@ -2,29 +2,117 @@
 #include "Renderer.h"
 
 #include "AssetManager/AssetManager.h"
+#include "BindlessTable.h"
 #include "ComputePass.h"
+#include "EnvironmentMapCache.h"
+#include "GeometryHeap.h"
 #include "IndexBuffer.h"
 #include "IndexBuffer.h"
 #include "Mesh/Material.h"
 #include "Mesh/MaterialAsset.h"
 #include "Mesh/Mesh.h"
+#include "Renderer/Core/PipelineCache.h"
 #include "Renderer/Core/RenderCommandBuffer.h"
+#include "Renderer/Core/UploadManager.h"
 #include "RenderPass.h"
 #include "Scene/SceneEnvironment.h"
 #include "Shaders/Compiler/ShaderCompiler.h"
 #include "Shaders/Shader.h"
+#include "Shaders/ShaderRegistry.h"
 #include "StorageBufferSet.h"
 #include "Texture.h"
+#include "TextureStreamer.h"
 #include "UniformBufferSet.h"
 #include "VertexBuffer.h"
+#include "Utils/FileSystem.h"
 
 #include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <bit>
+
 namespace Iris {
 
 	namespace Utils {
 
+		static glm::vec3 GetPreethamSunDirection(float azimuth, float inclination)
+		{
+			return glm::normalize(glm::vec3(glm::sin(inclination) * glm::cos(azimuth), glm::cos(inclination), glm::sin(inclination) * glm::sin(azimuth)));
+		}
+
+		static uint32_t GetCubemapFace(const glm::vec3& direction)
+		{
+			const glm::vec3 absDirection = glm::abs(direction);
+			if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z)
+				return direction.x > 0.0f ? 0 : 1;
+			if (absDirection.y >= absDirection.z)
+				return direction.y > 0.0f ? 2 : 3;
+			return direction.z > 0.0f ? 4 : 5;
+		}
+
+		// Mask of the cubemap faces the sun disc of PreethamSky.glsl reaches. Only the sun depends on the sun size so these are the only faces that
+		// change when nothing else does
+		static uint32_t GetPreethamSunFaces(const glm::vec3& sunDirection, float sunSize)
+		{
+			// Past this distance (between directions) the two gaussians of the sun are below 1e-4
+			const float cutoffDistance = sunSize * 4.3f;
+			if (cutoffDistance >= glm::sqrt(2.0f)) // Covers more than 90 degrees
+				return 0b111111;
+
+			const float radius = 2.0f * glm::asin(cutoffDistance * 0.5f);
+
+			const glm::vec3 up = glm::abs(sunDirection.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+			const glm::vec3 tangent = glm::normalize(glm::cross(up, sunDirection));
+			const glm::vec3 bitangent = glm::cross(sunDirection, tangent);
+
+			// The disc is small compared to a face so sampling its center and two rings is enough to find every face it touches
+			uint32_t faces = 1u << GetCubemapFace(sunDirection);
+			for (float ringRadius : { radius * 0.5f, radius })
+			{
+				for (uint32_t i = 0; i < 32; i++)
+				{
+					const float angle = glm::two_pi<float>() * static_cast<float>(i) / 32.0f;
+					const glm::vec3 offset = tangent * glm::cos(angle) + bitangent * glm::sin(angle);
+					faces |= 1u << GetCubemapFace(sunDirection * glm::cos(ringRadius) + offset * glm::sin(ringRadius));
+				}
+			}
+
+			return faces;
+		}
+
+		static void RT_BeginComputePass(VkCommandBuffer commandBuffer, Ref<ComputePass> computePass)
+		{
+			const uint32_t frameIndex = Renderer::RT_GetCurrentFrameIndex();
+
+			VkDebugUtilsLabelEXT debugLabel = {
+				.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+				.pLabelName = computePass->GetSpecification().DebugName.c_str()
+			};
+			std::memcpy(&debugLabel.color, glm::value_ptr(computePass->GetSpecification().MarkerColor), 4 * sizeof(float));
+			fpCmdBeginDebugUtilsLabelEXT(commandBuffer, &debugLabel);
+
+			// Bind the pipeline
+			Ref<ComputePipeline> pipeline = computePass->GetPipeline();
+			pipeline->RT_Begin(commandBuffer);
+
+			computePass->Prepare();
+			if (computePass->HasDescriptorSets())
+			{
+				const auto& descriptorSets = computePass->GetDescriptorSets(frameIndex);
+				vkCmdBindDescriptorSets(
+					commandBuffer,
+					VK_PIPELINE_BIND_POINT_COMPUTE,
+					pipeline->GetPipelineLayout(),
+					computePass->GetFirstSetIndex(),
+					static_cast<uint32_t>(descriptorSets.size()),
+					descriptorSets.data(),
+					0,
+					0
+				);
+			}
+		}
+
 		constexpr static const char* VulkanVendorIDToString(uint32_t vendorID)
 		{
 			switch (vendorID)
@@ -40,6 +128,33 @@ namespace Iris {
 
 	}
 
+	struct PreethamSkyKey
+	{
+		int32_t Turbidity;
+		int32_t Azimuth;
+		int32_t Inclination;
+		int32_t SunSize;
+		uint32_t Resolution;
+
+		bool operator==(const PreethamSkyKey&) const = default;
+	};
+
+	struct PreethamSkyCacheEntry
+	{
+		PreethamSkyKey Key;
+		Ref<TextureCube> Cubemap;
+		uint64_t LastUsedFrame = 0; // Last frame it was handed out, for the LRU
+		uint64_t LastReferencedFrame = 0; // Last frame anything besides the cache held on to it, it can only be regenerated once the GPU is done with it
+	};
+
+	// Full resolution skies take ~64MB each with the default environment map size
+	static constexpr uint32_t s_PreethamSkyCacheSize = 4;
+
+	// Steps the sky parameters are rounded to, finer than what can be told apart in the sky
+	static constexpr float s_PreethamTurbidityStep = 0.01f;
+	static constexpr float s_PreethamAngleStep = 0.00436332f; // 0.25 degrees
+	static constexpr float s_PreethamSunSizeStep = 0.001f;
+
 	struct ShaderDependencies
 	{
 		std::vector<Ref<Pipeline>> Pipelines;
@@ -75,6 +190,9 @@ namespace Iris {
 
 		Ref<ComputePass> PreethamSkyPass;
 		Ref<Material> PreethamSkyMaterial;
+		std::vector<PreethamSkyCacheEntry> PreethamSkyCache;
+
+		uint64_t FrameNumber = 0;
 
 		std::vector<VkDescriptorPool> DescriptorPools;
 		std::vector<uint32_t> DescriptorPoolAllocationCount;
@@ -84,18 +202,168 @@ namespace Iris {
 		RenderCommandQueue CommandQueue[c_RenderCommandQueueCount];
 		std::atomic<uint32_t> RenderCommandQueueSubmissionIndex = 0;
 
+		// Commands submitted from worker threads, swapped together with the command queues and executed before them
+		RenderCommandQueue WorkerCommandQueue[c_RenderCommandQueueCount];
+		std::mutex WorkerCommandQueueMutex;
+		// The worker queue that is being submitted to gets swapped into this one by ExecuteAllRenderCommandQueues so that it executes without holding the mutex
+		RenderCommandQueue FlushedWorkerCommandQueue;
+
 		// Resource Release Queue
 		// We create 3 which is corresponding with the max number of frames in flight we might run... (3)
 		constexpr static uint32_t c_ResourceFreeQueueCount = 3;
 		RenderCommandQueue RendererResourceFreeQueue[c_ResourceFreeQueueCount];
 
 		uint32_t DrawCallCount = 0;
+		SkippedBindStatistics SkippedBinds;
 
 		RendererCapabilities RendererCaps;
 	};
 
 	static RendererConfiguration s_RendererConfig;
 	static RendererData* s_Data = nullptr;
+
+	namespace Utils {
+
+		// Every graphics bind of the renderer goes through these so the ones that match what the command buffer already has bound are skipped
+
+		static void RT_SetBoundPipelineLayout(BoundGraphicsState& state, VkPipelineLayout layout)
+		{
+			if (state.PipelineLayout == layout)
+				return;
+
+			// Sets and push constants are not guaranteed to survive a change of layout
+			state.PipelineLayout = layout;
+			state.DescriptorSets = {};
+			state.PushConstants.clear();
+		}
+
+		static void RT_BindGraphicsPipeline(Ref<RenderCommandBuffer> renderCommandBuffer, VkPipeline pipeline, VkPipelineLayout layout)
+		{
+			BoundGraphicsState& state = renderCommandBuffer->RT_GetBoundState();
+
+			// Still being compiled with nothing to fall back to, the sets can be bound against the layout but the draws are skipped (see RT_CanDraw)
+			if (!pipeline)
+			{
+				state.Pipeline = nullptr;
+				RT_SetBoundPipelineLayout(state, layout);
+				return;
+			}
+
+			if (state.Pipeline == pipeline)
+			{
+				s_Data->SkippedBinds.Pipelines++;
+				return;
+			}
+
+			vkCmdBindPipeline(renderCommandBuffer->GetActiveCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			state.Pipeline = pipeline;
+			RT_SetBoundPipelineLayout(state, layout);
+		}
+
+		static bool RT_CanDraw(Ref<RenderCommandBuffer> renderCommandBuffer)
+		{
+			return renderCommandBuffer->RT_GetBoundState().Pipeline != nullptr;
+		}
+
+		static void RT_BindDescriptorSets(Ref<RenderCommandBuffer> renderCommandBuffer, VkPipelineLayout layout, uint32_t firstSet, uint32_t setCount, const VkDescriptorSet* descriptorSets)
+		{
+			BoundGraphicsState& state = renderCommandBuffer->RT_GetBoundState();
+			IR_ASSERT(firstSet + setCount <= BoundGraphicsState::MaxDescriptorSets);
+
+			if (state.PipelineLayout == layout && std::equal(descriptorSets, descriptorSets + setCount, state.DescriptorSets.begin() + firstSet))
+			{
+				s_Data->SkippedBinds.DescriptorSets += setCount;
+				return;
+			}
+
+			vkCmdBindDescriptorSets(renderCommandBuffer->GetActiveCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, layout, firstSet, setCount, descriptorSets, 0, nullptr);
+			RT_SetBoundPipelineLayout(state, layout);
+			std::copy(descriptorSets, descriptorSets + setCount, state.DescriptorSets.begin() + firstSet);
+		}
+
+		static void RT_BindVertexBuffers(Ref<RenderCommandBuffer> renderCommandBuffer, uint32_t bufferCount, const VkBuffer* buffers, const VkDeviceSize* offsets)
+		{
+			BoundGraphicsState& state = renderCommandBuffer->RT_GetBoundState();
+			IR_ASSERT(bufferCount <= BoundGraphicsState::MaxVertexBuffers);
+
+			if (std::equal(buffers, buffers + bufferCount, state.VertexBuffers.begin()) && std::equal(offsets, offsets + bufferCount, state.VertexBufferOffsets.begin()))
+			{
+				s_Data->SkippedBinds.VertexBuffers += bufferCount;
+				return;
+			}
+
+			vkCmdBindVertexBuffers(renderCommandBuffer->GetActiveCommandBuffer(), 0, bufferCount, buffers, offsets);
+			std::copy(buffers, buffers + bufferCount, state.VertexBuffers.begin());
+			std::copy(offsets, offsets + bufferCount, state.VertexBufferOffsets.begin());
+		}
+
+		static void RT_BindIndexBuffer(Ref<RenderCommandBuffer> renderCommandBuffer, VkBuffer indexBuffer)
+		{
+			BoundGraphicsState& state = renderCommandBuffer->RT_GetBoundState();
+			if (state.IndexBuffer == indexBuffer)
+			{
+				s_Data->SkippedBinds.IndexBuffers++;
+				return;
+			}
+
+			vkCmdBindIndexBuffer(renderCommandBuffer->GetActiveCommandBuffer(), indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+			state.IndexBuffer = indexBuffer;
+		}
+
+		static void RT_PushConstants(Ref<RenderCommandBuffer> renderCommandBuffer, VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data)
+		{
+			BoundGraphicsState& state = renderCommandBuffer->RT_GetBoundState();
+			RT_SetBoundPipelineLayout(state, layout);
+
+			auto range = std::find_if(state.PushConstants.begin(), state.PushConstants.end(), [stages, offset](const BoundGraphicsState::PushConstantRange& pushed)
+			{
+				return pushed.Stages == stages && pushed.Offset == offset;
+			});
+
+			if (range != state.PushConstants.end() && range->Data.size() == size && std::memcmp(range->Data.data(), data, size) == 0)
+			{
+				s_Data->SkippedBinds.PushConstants++;
+				return;
+			}
+
+			vkCmdPushConstants(renderCommandBuffer->GetActiveCommandBuffer(), layout, stages, offset, size, data);
+
+			if (range == state.PushConstants.end())
+				range = state.PushConstants.insert(state.PushConstants.end(), { .Stages = stages, .Offset = offset });
+
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			range->Data.assign(bytes, bytes + size);
+		}
+
+		static void RT_BindStaticMeshGeometry(Ref<RenderCommandBuffer> renderCommandBuffer, VkBuffer vertexBuffer, VkBuffer indexBuffer, VkBuffer instanceBuffer)
+		{
+			// Draws pick their instances with the first instance so the instance buffer is always bound from the start
+			VkBuffer vertexBuffers[] = { vertexBuffer, instanceBuffer };
+			VkDeviceSize offsets[] = { 0, 0 };
+			RT_BindVertexBuffers(renderCommandBuffer, 2, vertexBuffers, offsets);
+			RT_BindIndexBuffer(renderCommandBuffer, indexBuffer);
+		}
+
+		// BeginRenderPass binds the variant with every permutation at its default, materials that switched some off are drawn with their own
+		// variant once it is compiled
+		static void RT_BindPipelineVariant(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, uint32_t permutationKey)
+		{
+			if (pipeline->GetShader()->GetPermutations().empty())
+				return;
+
+			RT_BindGraphicsPipeline(renderCommandBuffer, pipeline->RT_GetVulkanPipeline(permutationKey), pipeline->GetVulkanPipelineLayout());
+		}
+
+		static void RT_BindPipelineVariant(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<Material> material)
+		{
+			if (!material || material->GetShader() != pipeline->GetShader())
+				return;
+
+			RT_BindPipelineVariant(renderCommandBuffer, pipeline, material->GetPermutationKey());
+		}
+
+	}
+
 	
 	void Renderer::Init()
 	{
@@ -103,6 +371,11 @@ namespace Iris {
 		
 		s_RendererConfig.FramesInFlight = glm::min<uint32_t>(s_RendererConfig.FramesInFlight, Application::Get().GetWindow().GetSwapChain().GetImageCount());
 
+		UploadManager::Init();
+		PipelineCache::Init();
+		BindlessTable::Init();
+		GeometryHeap::Init();
+
 		{
 			Ref<VulkanPhysicalDevice> physicalDevice = RendererContext::GetCurrentDevice()->GetPhysicalDevice();
 			const VkPhysicalDeviceProperties& properties = physicalDevice->GetPhysicalDeviceProperties();
@@ -179,24 +452,29 @@ namespace Iris {
 		uint32_t indices[6] = { 0, 1, 2, 2, 3, 0 };
 		s_Data->QuadIndexBuffer = IndexBuffer::Create(indices, 6 * sizeof(uint32_t));
 
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/Compositing.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/EnvironmentIrradiance.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/EnvironmentMipChainFilter.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/EquirectangularToCubemap.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/Grid.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/IrisPBRStatic.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/JumpFloodComposite.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/JumpFloodInit.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/JumpFloodPass.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/PreDepth.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/PreethamSky.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/Renderer2D_Line.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/Renderer2D_Quad.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/Renderer2D_Text.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/SelectedGeometry.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/Skybox.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/TexturePass.glsl");
-		Renderer::GetShadersLibrary()->Load("Resources/Shaders/Src/WireFrame.glsl");
+		Renderer::GetShadersLibrary()->LoadAll({
+			"Resources/Shaders/Src/Compositing.glsl",
+			"Resources/Shaders/Src/EnvironmentIrradiance.glsl",
+			"Resources/Shaders/Src/EnvironmentMipChainFilter.glsl",
+			"Resources/Shaders/Src/EquirectangularToCubemap.glsl",
+			"Resources/Shaders/Src/GPUCulling.glsl",
+			"Resources/Shaders/Src/GPUDrawCompaction.glsl",
+			"Resources/Shaders/Src/Grid.glsl",
+			"Resources/Shaders/Src/HiZBuild.glsl",
+			"Resources/Shaders/Src/IrisPBRStatic.glsl",
+			"Resources/Shaders/Src/JumpFloodComposite.glsl",
+			"Resources/Shaders/Src/JumpFloodInit.glsl",
+			"Resources/Shaders/Src/JumpFloodPass.glsl",
+			"Resources/Shaders/Src/PreDepth.glsl",
+			"Resources/Shaders/Src/PreethamSky.glsl",
+			"Resources/Shaders/Src/Renderer2D_Line.glsl",
+			"Resources/Shaders/Src/Renderer2D_Quad.glsl",
+			"Resources/Shaders/Src/Renderer2D_Text.glsl",
+			"Resources/Shaders/Src/SelectedGeometry.glsl",
+			"Resources/Shaders/Src/Skybox.glsl",
+			"Resources/Shaders/Src/TexturePass.glsl",
+			"Resources/Shaders/Src/WireFrame.glsl"
+		});
 
 		constexpr uint32_t whiteTextureData = 0xffffffff;
 		TextureSpecification spec = {
@@ -206,6 +484,8 @@ namespace Iris {
 			.Format = ImageFormat::RGBA
 		};
 		s_Data->WhiteTexutre = Texture2D::Create(spec, Buffer(reinterpret_cast<const uint8_t*>(&whiteTextureData), sizeof(uint32_t)));
+		// Slot 0 of the bindless table, empty slots and materials without maps fall back to it
+		IR_VERIFY(s_Data->WhiteTexutre->GetBindlessIndex() == 0);
 
 		constexpr uint32_t blackTextureData = 0xff000000;
 		spec.DebugName = "BlackTexture";
@@ -273,15 +553,21 @@ namespace Iris {
 			
 			s_Data->PreethamSkyPass->Bake();
 		});
+
+		TextureStreamer::Init();
 	}
 
 	void Renderer::Shutdown()
 	{
+		TextureStreamer::Shutdown();
+
 		s_ShaderDependencies.clear();
 
 		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
 		vkDeviceWaitIdle(device);
 
+		EnvironmentMapCache::Shutdown();
+
 		// Release renderer owned data
 		s_Data->ShaderLibrary.Reset();
 		s_Data->WhiteTexutre.Reset();
@@ -299,6 +585,7 @@ namespace Iris {
 		s_Data->IrradianceMapMaterial.Reset();
 		s_Data->PreethamSkyPass.Reset();
 		s_Data->PreethamSkyMaterial.Reset();
+		s_Data->PreethamSkyCache.clear();
 
 		// Execute any remaining commands
 		Renderer::ExecuteAllRenderCommandQueues();
@@ -307,6 +594,7 @@ namespace Iris {
 			vkDestroyDescriptorPool(device, descriptorPool, nullptr);
 
 		ShaderCompiler::ClearUniformAndStorageBuffers();
+		ShaderRegistry::Flush();
 
 		// Execute any remaining resource freeing that could be done
 		for (uint32_t i = 0; i < RendererData::c_ResourceFreeQueueCount; i++)
@@ -315,6 +603,11 @@ namespace Iris {
 			resourceReleaseQueue.Execute();
 		}
 
+		GeometryHeap::Shutdown();
+		BindlessTable::Shutdown();
+		PipelineCache::Shutdown();
+		UploadManager::Shutdown();
+
 		delete s_Data;
 	}
 
@@ -347,6 +640,13 @@ namespace Iris {
 	{
 		for (uint32_t i = 0; i < RendererData::c_RenderCommandQueueCount; i++)
 		{
+			// Workers could still be submitting to it, and holding the mutex while executing would stall them or deadlock if a command waits on one of them
+			{
+				std::scoped_lock<std::mutex> lock(s_Data->WorkerCommandQueueMutex);
+				s_Data->WorkerCommandQueue[s_Data->RenderCommandQueueSubmissionIndex].Swap(s_Data->FlushedWorkerCommandQueue);
+			}
+			s_Data->FlushedWorkerCommandQueue.Execute();
+
 			RenderCommandQueue& renderCommandQueue = GetRenderCommandQueue();
 			renderCommandQueue.Execute();
 			SwapQueues();
@@ -355,6 +655,8 @@ namespace Iris {
 
 	void Renderer::SwapQueues()
 	{
+		// Only the workers need to be kept out while swapping, the main thread is the one swapping
+		std::scoped_lock<std::mutex> lock(s_Data->WorkerCommandQueueMutex);
 		s_Data->RenderCommandQueueSubmissionIndex = (s_Data->RenderCommandQueueSubmissionIndex + 1) % RendererData::c_RenderCommandQueueCount;
 	}
 
@@ -370,6 +672,8 @@ namespace Iris {
 
 		Timer workTimer;
 
+		// Worker commands first since the main thread may already use what they created (assets synced during the frame)
+		s_Data->WorkerCommandQueue[GetRenderQueueIndex()].Execute();
 		s_Data->CommandQueue[GetRenderQueueIndex()].Execute();
 		// Rendering complete, set state back to idle
 		renderThread->Set(ThreadState::Idle);
@@ -402,6 +706,17 @@ namespace Iris {
 
 	void Renderer::BeginFrame()
 	{
+		s_Data->FrameNumber++;
+		for (PreethamSkyCacheEntry& entry : s_Data->PreethamSkyCache)
+		{
+			if (entry.Cubemap->GetRefCount() > 1)
+				entry.LastReferencedFrame = s_Data->FrameNumber;
+		}
+
+		TextureStreamer::Update();
+		BindlessTable::BeginFrame();
+		GeometryHeap::BeginFrame();
+
 		Renderer::Submit([]()
 		{
 			Ref<VulkanDevice> logicalDevice = RendererContext::GetCurrentDevice();
@@ -414,7 +729,11 @@ namespace Iris {
 			vkResetDescriptorPool(device, s_Data->DescriptorPools[bufferIndex], 0);
 			std::memset(s_Data->DescriptorPoolAllocationCount.data(), 0, s_Data->DescriptorPoolAllocationCount.size() * sizeof(uint32_t));
 
+			BindlessTable::RT_BeginFrame();
+			EnvironmentMapCache::RT_Update();
+
 			s_Data->DrawCallCount = 0;
+			s_Data->SkippedBinds = {};
 		});
 	}
 
@@ -425,6 +744,8 @@ namespace Iris {
 
 	void Renderer::BeginRenderPass(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<RenderPass> renderPass, bool explicitClear)
 	{
+		renderCommandBuffer->BeginTimestampQuery(renderPass->GetSpecification().DebugName);
+
 		Renderer::Submit([renderCommandBuffer, renderPass, explicitClear]() mutable
 		{
 			// IR_CORE_TRACE_TAG("Renderer", "BeginRenderPass - {}", renderPass->GetSpecification().DebugName);
@@ -552,9 +873,11 @@ namespace Iris {
 			};
 			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
+			// Anything could have been recorded in between passes
+			renderCommandBuffer->RT_GetBoundState().Reset();
+
 			Ref<Pipeline> pipeline = renderPass->GetPipeline();
-			VkPipeline vulkanPipeline = pipeline->GetVulkanPipeline();
-			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkanPipeline);
+			Utils::RT_BindGraphicsPipeline(renderCommandBuffer, pipeline->RT_GetVulkanPipeline(), pipeline->GetVulkanPipelineLayout());
 
 			if (pipeline->IsDynamicLineWidth())
 				vkCmdSetLineWidth(commandBuffer, pipeline->GetSpecification().LineWidth);
@@ -563,16 +886,14 @@ namespace Iris {
 			if (renderPass->HasDescriptorSets())
 			{
 				const std::vector<VkDescriptorSet>& descriptorSets = renderPass->GetDescriptorSets(frameIndex);
+				Utils::RT_BindDescriptorSets(renderCommandBuffer, pipeline->GetVulkanPipelineLayout(), renderPass->GetFirstSetIndex(), static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data());
+			}
 
-				vkCmdBindDescriptorSets(
-					commandBuffer,
-					VK_PIPELINE_BIND_POINT_GRAPHICS,
-					pipeline->GetVulkanPipelineLayout(),
-					renderPass->GetFirstSetIndex(),
-					static_cast<uint32_t>(descriptorSets.size()),
-					descriptorSets.data(),
-					0, nullptr
-				);
+			// Stays bound for every draw of the pass since all pipelines share the same layout for it
+			if (pipeline->GetShader()->HasDescriptorSet(BindlessTable::DescriptorSet))
+			{
+				VkDescriptorSet bindlessSet = BindlessTable::RT_GetDescriptorSet();
+				Utils::RT_BindDescriptorSets(renderCommandBuffer, pipeline->GetVulkanPipelineLayout(), BindlessTable::DescriptorSet, 1, &bindlessSet);
 			}
 		});
 	}
@@ -587,6 +908,8 @@ namespace Iris {
 
 			fpCmdEndDebugUtilsLabelEXT(commandBuffer);
 		});
+
+		renderCommandBuffer->EndTimestampQuery();
 	}
 
 	void Renderer::SubmitFullScreenQuad(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<Material> material)
@@ -600,30 +923,27 @@ namespace Iris {
 
 			VkBuffer vbQuadBuffer = s_Data->QuadVertexBuffer->GetVulkanBuffer();
 			VkDeviceSize offsets[1] = { 0 };
-			vkCmdBindVertexBuffers(vkCommandBuffer, 0, 1, &vbQuadBuffer, offsets);
-
-			VkBuffer ibQuadBuffer = s_Data->QuadIndexBuffer->GetVulkanBuffer();
-			vkCmdBindIndexBuffer(vkCommandBuffer, ibQuadBuffer, 0, VK_INDEX_TYPE_UINT32);
+			Utils::RT_BindVertexBuffers(renderCommandBuffer, 1, &vbQuadBuffer, offsets);
+			Utils::RT_BindIndexBuffer(renderCommandBuffer, s_Data->QuadIndexBuffer->GetVulkanBuffer());
 
 			if (material)
 			{
+				Utils::RT_BindPipelineVariant(renderCommandBuffer, pipeline, material);
+
 				VkDescriptorSet descSet = material->GetDescriptorSet(frameIndex);
 				if (descSet)
-					vkCmdBindDescriptorSets(vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, material->GetFirstSetIndex(), 1, &descSet, 0, nullptr);
+					Utils::RT_BindDescriptorSets(renderCommandBuffer, layout, material->GetFirstSetIndex(), 1, &descSet);
 
 				Buffer uniformStorageBuffer = material->GetUniformStorageBuffer();
 				if (uniformStorageBuffer)
-					vkCmdPushConstants(
-						vkCommandBuffer,
-						layout,
-						VK_SHADER_STAGE_FRAGMENT_BIT,
-						0,
-						static_cast<uint32_t>(uniformStorageBuffer.Size),
-						uniformStorageBuffer.Data);
+					Utils::RT_PushConstants(renderCommandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, static_cast<uint32_t>(uniformStorageBuffer.Size), uniformStorageBuffer.Data);
 			}
 
-			vkCmdDrawIndexed(vkCommandBuffer, s_Data->QuadIndexBuffer->GetCount(), 1, 0, 0, 0);
-			s_Data->DrawCallCount++;
+			if (Utils::RT_CanDraw(renderCommandBuffer))
+			{
+				vkCmdDrawIndexed(vkCommandBuffer, s_Data->QuadIndexBuffer->GetCount(), 1, 0, 0, 0);
+				s_Data->DrawCallCount++;
+			}
 		});
 	}
 
@@ -652,121 +972,134 @@ namespace Iris {
 
 			VkBuffer vbQuadBuffer = s_Data->QuadVertexBuffer->GetVulkanBuffer();
 			VkDeviceSize offsets[1] = { 0 };
-			vkCmdBindVertexBuffers(vkCommandBuffer, 0, 1, &vbQuadBuffer, offsets);
-
-			VkBuffer ibQuadBuffer = s_Data->QuadIndexBuffer->GetVulkanBuffer();
-			vkCmdBindIndexBuffer(vkCommandBuffer, ibQuadBuffer, 0, VK_INDEX_TYPE_UINT32);
+			Utils::RT_BindVertexBuffers(renderCommandBuffer, 1, &vbQuadBuffer, offsets);
+			Utils::RT_BindIndexBuffer(renderCommandBuffer, s_Data->QuadIndexBuffer->GetVulkanBuffer());
 
 			if (material)
 			{
+				Utils::RT_BindPipelineVariant(renderCommandBuffer, pipeline, material);
+
 				VkDescriptorSet descSet = material->GetDescriptorSet(frameIndex);
 				if (descSet)
-					vkCmdBindDescriptorSets(vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, material->GetFirstSetIndex(), 1, &descSet, 0, nullptr);
+					Utils::RT_BindDescriptorSets(renderCommandBuffer, layout, material->GetFirstSetIndex(), 1, &descSet);
 
 				if (vertexPushConstantBuffer)
-					vkCmdPushConstants(vkCommandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, static_cast<uint32_t>(vertexPushConstantBuffer.Size), vertexPushConstantBuffer.Data);
+					Utils::RT_PushConstants(renderCommandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, static_cast<uint32_t>(vertexPushConstantBuffer.Size), vertexPushConstantBuffer.Data);
 
 				if (fragmentPushConstantBuffer)
-					vkCmdPushConstants(vkCommandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, static_cast<uint32_t>(vertexPushConstantBuffer.Size), static_cast<uint32_t>(fragmentPushConstantBuffer.Size), fragmentPushConstantBuffer.Data);
+					Utils::RT_PushConstants(renderCommandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, static_cast<uint32_t>(vertexPushConstantBuffer.Size), static_cast<uint32_t>(fragmentPushConstantBuffer.Size), fragmentPushConstantBuffer.Data);
 			}
 
-			vkCmdDrawIndexed(vkCommandBuffer, s_Data->QuadIndexBuffer->GetCount(), 1, 0, 0, 0);
-			s_Data->DrawCallCount++;
+			if (Utils::RT_CanDraw(renderCommandBuffer))
+			{
+				vkCmdDrawIndexed(vkCommandBuffer, s_Data->QuadIndexBuffer->GetCount(), 1, 0, 0, 0);
+				s_Data->DrawCallCount++;
+			}
 
 			vertexPushConstantBuffer.Release();
 			fragmentPushConstantBuffer.Release();
 		});
 	}
 
-	void Renderer::RenderStaticMesh(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, uint32_t subMeshIndex, Ref<MaterialTable> materialTable, Ref<VertexBuffer> transformBuffer, uint32_t transformOffset, uint32_t instanceCount, int viewMode)
+	void Renderer::BindStaticMeshGeometry(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<VertexBuffer> instanceBuffer)
 	{
-		IR_VERIFY(staticMesh);
-		IR_VERIFY(meshSource);
-		IR_VERIFY(materialTable);
-
-		Renderer::Submit([renderCommandBuffer, pipeline, staticMesh, meshSource, subMeshIndex, materialTable, transformBuffer, transformOffset, instanceCount, viewMode]() mutable
+		Renderer::Submit([renderCommandBuffer, instanceBuffer, vertexBuffer = GeometryHeap::GetVertexBuffer(), indexBuffer = GeometryHeap::GetIndexBuffer()]() mutable
 		{
-			uint32_t frameIndex = Renderer::RT_GetCurrentFrameIndex();
-			VkCommandBuffer commandBuffer = renderCommandBuffer->GetActiveCommandBuffer();
-
-			Ref<VertexBuffer> meshVB = meshSource->GetVertexBuffer();
-
-			VkBuffer vertexBuffers[] = { meshVB->GetVulkanBuffer(), transformBuffer->GetVulkanBuffer() };
-			VkDeviceSize offsets[] = { 0, transformOffset };
-			vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
-
-			Ref<IndexBuffer> meshIB = meshSource->GetIndexBuffer();
-			VkBuffer vulkanMeshIB = meshIB->GetVulkanBuffer();
-			vkCmdBindIndexBuffer(commandBuffer, vulkanMeshIB, 0, VK_INDEX_TYPE_UINT32);
-
-			const auto& subMeshes = meshSource->GetSubMeshes();
-			const MeshUtils::SubMesh& subMesh = subMeshes[subMeshIndex];
-			Ref<MaterialTable> meshMaterialTable = staticMesh->GetMaterials();
-			AssetHandle materialAssetHandle = materialTable->HasMaterial(subMesh.MaterialIndex) ?
-				materialTable->GetMaterial(subMesh.MaterialIndex) :
-				meshMaterialTable->GetMaterial(subMesh.MaterialIndex);
-
-			Ref<MaterialAsset> materialAsset = AssetManager::GetAsset<MaterialAsset>(materialAssetHandle);
+			Utils::RT_BindStaticMeshGeometry(renderCommandBuffer, vertexBuffer, indexBuffer, instanceBuffer->GetVulkanBuffer());
+		});
+	}
 
-			if (viewMode == 0)
-				materialAsset->SetLit();
-			else if (viewMode == 1 || viewMode == 2)
-				materialAsset->SetUnlit();
+	void Renderer::BindStaticMeshGeometry(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<StorageBuffer> instanceBuffer)
+	{
+		Renderer::Submit([renderCommandBuffer, instanceBuffer, vertexBuffer = GeometryHeap::GetVertexBuffer(), indexBuffer = GeometryHeap::GetIndexBuffer()]() mutable
+		{
+			Utils::RT_BindStaticMeshGeometry(renderCommandBuffer, vertexBuffer, indexBuffer, instanceBuffer->GetVulkanBuffer());
+		});
+	}
 
-			Ref<Material> vulkanMaterial = materialAsset->GetMaterial();
+	void Renderer::RenderStaticMesh(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<MeshSource> meshSource, uint32_t subMeshIndex, uint32_t permutationKey, uint32_t firstInstance, uint32_t instanceCount)
+	{
+		IR_VERIFY(meshSource);
 
-			VkPipelineLayout layout = pipeline->GetVulkanPipelineLayout();
+		// Resolved here since the heap only moves allocations between frames on the main thread
+		const GeometryAllocation geometry = meshSource->GetGeometry();
+		const MeshUtils::SubMesh& subMesh = meshSource->GetSubMeshes()[subMeshIndex];
+		const uint32_t indexCount = subMesh.IndexCount;
+		const uint32_t firstIndex = geometry.IndexOffset + subMesh.BaseIndex;
+		const int32_t vertexOffset = static_cast<int32_t>(geometry.VertexOffset + subMesh.BaseVertex);
 
-			VkDescriptorSet descriptorSet = vulkanMaterial->GetDescriptorSet(frameIndex);
-			if (descriptorSet)
-				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, vulkanMaterial->GetFirstSetIndex(), 1, &descriptorSet, 0, nullptr);
+		Renderer::Submit([renderCommandBuffer, pipeline, permutationKey, indexCount, firstIndex, vertexOffset, firstInstance, instanceCount]() mutable
+		{
+			VkCommandBuffer commandBuffer = renderCommandBuffer->GetActiveCommandBuffer();
 
-			Buffer uniformStorageBuffer = vulkanMaterial->GetUniformStorageBuffer();
-			vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, static_cast<uint32_t>(uniformStorageBuffer.Size), uniformStorageBuffer.Data);
+			Utils::RT_BindPipelineVariant(renderCommandBuffer, pipeline, permutationKey);
 
-			vkCmdDrawIndexed(commandBuffer, subMesh.IndexCount, instanceCount, subMesh.BaseIndex, subMesh.BaseVertex, 0);
-			s_Data->DrawCallCount++;
+			if (Utils::RT_CanDraw(renderCommandBuffer))
+			{
+				vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+				s_Data->DrawCallCount++;
+			}
 		});
 	}
 
-	void Renderer::RenderStaticMeshWithMaterial(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, uint32_t subMeshIndex, Ref<Material> material, Ref<VertexBuffer> transformBuffer, uint32_t transformOffset, uint32_t instanceCount)
+	void Renderer::RenderStaticMeshWithMaterial(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, uint32_t subMeshIndex, Ref<Material> material, uint32_t firstInstance, uint32_t instanceCount)
 	{
 		IR_VERIFY(staticMesh);
 		IR_VERIFY(meshSource);
 		IR_VERIFY(material);
 
-		Renderer::Submit([renderCommandBuffer, pipeline, staticMesh, meshSource, subMeshIndex, material, transformBuffer, transformOffset, instanceCount]() mutable
+		const GeometryAllocation geometry = meshSource->GetGeometry();
+		const MeshUtils::SubMesh& subMesh = meshSource->GetSubMeshes()[subMeshIndex];
+		const uint32_t indexCount = subMesh.IndexCount;
+		const uint32_t firstIndex = geometry.IndexOffset + subMesh.BaseIndex;
+		const int32_t vertexOffset = static_cast<int32_t>(geometry.VertexOffset + subMesh.BaseVertex);
+
+		Renderer::Submit([renderCommandBuffer, pipeline, material, indexCount, firstIndex, vertexOffset, firstInstance, instanceCount]() mutable
 		{
 			uint32_t frameIndex = Renderer::RT_GetCurrentFrameIndex();
 			VkCommandBuffer commandBuffer = renderCommandBuffer->GetActiveCommandBuffer();
 
-			Ref<VertexBuffer> meshVB = meshSource->GetVertexBuffer();
-
-			VkBuffer vertexBuffers[] = { meshVB->GetVulkanBuffer(), transformBuffer->GetVulkanBuffer() };
-			VkDeviceSize offsets[] = { 0, transformOffset };
-			vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
-
-			Ref<IndexBuffer> meshIB = meshSource->GetIndexBuffer();
-			VkBuffer vulkanMeshIB = meshIB->GetVulkanBuffer();
-			vkCmdBindIndexBuffer(commandBuffer, vulkanMeshIB, 0, VK_INDEX_TYPE_UINT32);
-
+			Utils::RT_BindPipelineVariant(renderCommandBuffer, pipeline, material);
 			VkPipelineLayout layout = pipeline->GetVulkanPipelineLayout();
 
 			VkDescriptorSet descriptorSet = material->GetDescriptorSet(frameIndex);
 			if (descriptorSet)
-				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, material->GetFirstSetIndex(), 1, &descriptorSet, 0, nullptr);
+				Utils::RT_BindDescriptorSets(renderCommandBuffer, layout, material->GetFirstSetIndex(), 1, &descriptorSet);
 
 			uint32_t pushConstantOffset = 0;
 			Buffer uniformStorageBuffer = material->GetUniformStorageBuffer();
 			if (uniformStorageBuffer)
 			{
-				vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, pushConstantOffset, static_cast<uint32_t>(uniformStorageBuffer.Size), uniformStorageBuffer.Data);
+				Utils::RT_PushConstants(renderCommandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, pushConstantOffset, static_cast<uint32_t>(uniformStorageBuffer.Size), uniformStorageBuffer.Data);
 			}
 
-			const auto& subMeshes = meshSource->GetSubMeshes();
-			const auto& subMesh = subMeshes[subMeshIndex];
+			if (Utils::RT_CanDraw(renderCommandBuffer))
+			{
+				vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+				s_Data->DrawCallCount++;
+			}
+		});
+	}
+
+	void Renderer::RenderStaticMeshIndirect(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, uint32_t permutationKey, Ref<StorageBuffer> drawCommandBuffer, uint32_t firstDrawCommand, Ref<StorageBuffer> drawCountBuffer, uint32_t drawCountIndex, uint32_t maxDrawCount)
+	{
+		Renderer::Submit([renderCommandBuffer, pipeline, permutationKey, drawCommandBuffer, firstDrawCommand, drawCountBuffer, drawCountIndex, maxDrawCount]() mutable
+		{
+			VkCommandBuffer commandBuffer = renderCommandBuffer->GetActiveCommandBuffer();
 
-			vkCmdDrawIndexed(commandBuffer, subMesh.IndexCount, instanceCount, subMesh.BaseIndex, subMesh.BaseVertex, 0);
+			Utils::RT_BindPipelineVariant(renderCommandBuffer, pipeline, permutationKey);
+			if (!Utils::RT_CanDraw(renderCommandBuffer))
+				return;
+
+			vkCmdDrawIndexedIndirectCount(
+				commandBuffer,
+				drawCommandBuffer->GetVulkanBuffer(),
+				firstDrawCommand * sizeof(VkDrawIndexedIndirectCommand),
+				drawCountBuffer->GetVulkanBuffer(),
+				drawCountIndex * sizeof(uint32_t),
+				maxDrawCount,
+				sizeof(VkDrawIndexedIndirectCommand)
+			);
 			s_Data->DrawCallCount++;
 		});
 	}
@@ -784,21 +1117,22 @@ namespace Iris {
 
 			VkBuffer vbBuffer = vertexBuffer->GetVulkanBuffer();
 			VkDeviceSize offset = 0;
-			vkCmdBindVertexBuffers(commandbuffer, 0, 1, &vbBuffer, &offset);
+			Utils::RT_BindVertexBuffers(renderCommandBuffer, 1, &vbBuffer, &offset);
+			Utils::RT_BindIndexBuffer(renderCommandBuffer, indexBuffer->GetVulkanBuffer());
 
-			VkBuffer ibBuffer = indexBuffer->GetVulkanBuffer();
-			vkCmdBindIndexBuffer(commandbuffer, ibBuffer, 0, VK_INDEX_TYPE_UINT32);
+			Utils::RT_BindPipelineVariant(renderCommandBuffer, pipeline, material);
 
 			VkDescriptorSet descSet = material->GetDescriptorSet(frameIndex);
 			if (descSet)
-				vkCmdBindDescriptorSets(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, material->GetFirstSetIndex(), 1, &descSet, 0, nullptr);
+				Utils::RT_BindDescriptorSets(renderCommandBuffer, layout, material->GetFirstSetIndex(), 1, &descSet);
 
-			vkCmdPushConstants(commandbuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &transform);
+			Utils::RT_PushConstants(renderCommandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &transform);
 			Buffer uniformStorageBuffer = material->GetUniformStorageBuffer();
 			if (uniformStorageBuffer)
-				vkCmdPushConstants(commandbuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(glm::mat4), static_cast<uint32_t>(uniformStorageBuffer.Size), uniformStorageBuffer.Data);
+				Utils::RT_PushConstants(renderCommandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(glm::mat4), static_cast<uint32_t>(uniformStorageBuffer.Size), uniformStorageBuffer.Data);
 
-			vkCmdDrawIndexed(commandbuffer, indexCount, 1, 0, 0, 0);
+			if (Utils::RT_CanDraw(renderCommandBuffer))
+				vkCmdDrawIndexed(commandbuffer, indexCount, 1, 0, 0, 0);
 			// NOTE: Here we do not increase the DrawCallCount since this is only called in the Renderer2D for now and that has its own draw call counter
 		});
 	}
@@ -809,34 +1143,7 @@ namespace Iris {
 	{
 		Renderer::Submit([commandBuffer, computePass]() mutable
 		{
-			const uint32_t frameIndex = Renderer::RT_GetCurrentFrameIndex();
-
-			VkDebugUtilsLabelEXT debugLabel = {
-				.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
-				.pLabelName = computePass->GetSpecification().DebugName.c_str()
-			};
-			std::memcpy(&debugLabel.color, glm::value_ptr(computePass->GetSpecification().MarkerColor), 4 * sizeof(float));
-			fpCmdBeginDebugUtilsLabelEXT(commandBuffer, &debugLabel);
-
-			// Bind the pipeline
-			Ref<ComputePipeline> pipeline = computePass->GetPipeline();
-			pipeline->RT_Begin(commandBuffer);
-
-			computePass->Prepare();
-			if (computePass->HasDescriptorSets())
-			{
-				const auto& descriptorSets = computePass->GetDescriptorSets(frameIndex);
-				vkCmdBindDescriptorSets(
-					commandBuffer,
-					VK_PIPELINE_BIND_POINT_COMPUTE,
-					pipeline->GetPipelineLayout(),
-					computePass->GetFirstSetIndex(),
-					static_cast<uint32_t>(descriptorSets.size()),
-					descriptorSets.data(),
-					0,
-					0
-				);
-			}
+			Utils::RT_BeginComputePass(commandBuffer, computePass);
 		});
 	}
 
@@ -887,35 +1194,87 @@ namespace Iris {
 		});
 	}
 
-	std::pair<Ref<TextureCube>, Ref<TextureCube>> Renderer::CreateEnvironmentMap(const std::string& filepath)
+	void Renderer::BeginComputePass(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<ComputePass> computePass)
+	{
+		renderCommandBuffer->BeginTimestampQuery(computePass->GetSpecification().DebugName);
+
+		Renderer::Submit([renderCommandBuffer, computePass]() mutable
+		{
+			Utils::RT_BeginComputePass(renderCommandBuffer->GetActiveCommandBuffer(), computePass);
+		});
+	}
+
+	void Renderer::EndComputePass(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<ComputePass> computePass)
+	{
+		Renderer::Submit([renderCommandBuffer, computePass]() mutable
+		{
+			computePass->GetPipeline()->End();
+			fpCmdEndDebugUtilsLabelEXT(renderCommandBuffer->GetActiveCommandBuffer());
+		});
+
+		renderCommandBuffer->EndTimestampQuery();
+	}
+
+	void Renderer::DispatchComputePass(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<ComputePass> computePass, Ref<Material> material, const glm::uvec3& workGroups, Buffer constants)
+	{
+		// The pipeline records into the command buffer that BeginComputePass made active
+		Renderer::DispatchComputePass(VkCommandBuffer(nullptr), computePass, material, workGroups, constants);
+	}
+
+	Ref<Environment> Renderer::CreateEnvironmentMap(const std::string& filepath)
 	{
 		if (!Renderer::GetConfig().ComputeEnvironmentMaps)
-			return { Renderer::GetBlackCubeTexture(), Renderer::GetBlackCubeTexture() };
+			return Environment::Create(Renderer::GetBlackCubeTexture(), Renderer::GetBlackCubeTexture());
 		
+		EnvironmentMapCacheKey cacheKey = EnvironmentMapCache::CreateKey(filepath);
+		if (Ref<Environment> cachedEnvironment = EnvironmentMapCache::TryLoad(cacheKey))
+			return cachedEnvironment;
+
+		// The image has to be read to generate the maps anyway, so its contents are hashed in case it only got copied or touched since it was cached
+		Buffer sourceData = FileSystem::Exists(filepath) ? FileSystem::ReadBytes(filepath) : Buffer();
+		if (EnvironmentMapCache::SetSourceData(cacheKey, sourceData))
+		{
+			if (Ref<Environment> cachedEnvironment = EnvironmentMapCache::TryLoad(cacheKey))
+			{
+				sourceData.Release();
+				return cachedEnvironment;
+			}
+		}
+
 		const uint32_t cubemapSize = Renderer::GetConfig().EnvironmentMapResolution;
 		constexpr uint32_t irradianceMapSize = 32;
 
+		// The spherical harmonics get projected from the radiance map on the CPU once it is done, so there is no irradiance map to convolve
+		const bool sphericalHarmonicsIrradiance = Renderer::GetConfig().SphericalHarmonicsIrradiance;
+
+		// The equirectangular image is only ever sampled so it can be in the smallest HDR format
 		TextureSpecification equiRect2DTextureSpec = {
 			.DebugName = "EquiRectangularTempTexture",
-			.GenerateMips = false
+			.GenerateMips = false,
+			.HDRFormat = ImageFormat::E5B9G9R9UF
 		};
-		Ref<Texture2D> envEquirect = Texture2D::Create(equiRect2DTextureSpec, filepath);
-		IR_VERIFY(envEquirect->GetFormat() == ImageFormat::RGBA32F, "Texture is not HDR!");
+		Ref<Texture2D> envEquirect = sourceData ? Texture2D::Create(equiRect2DTextureSpec, sourceData) : Texture2D::Create(equiRect2DTextureSpec, filepath);
+		sourceData.Release();
+		IR_VERIFY(envEquirect->GetFormat() == ImageFormat::E5B9G9R9UF, "Texture is not HDR!");
 		
 		VkCommandBuffer textureGenCommandBuffer = RendererContext::GetCurrentDevice()->GetCommandBuffer(true, true);
 		TextureSpecification cubemapSpec = {
 			.DebugName = "UnFilteredCubemap",
 			.Width = cubemapSize,
 			.Height = cubemapSize,
-			.Format = ImageFormat::RGBA32F
+			.Format = ImageFormat::RGBA16F
 		};
 		Ref<TextureCube> envUnfiltered = TextureCube::Create(cubemapSpec, {}, textureGenCommandBuffer);
 		cubemapSpec.DebugName = "RadianceMap";
 		Ref<TextureCube> envFiltered = TextureCube::Create(cubemapSpec, {}, textureGenCommandBuffer);
-		cubemapSpec.DebugName = "IrradianceMap";
-		cubemapSpec.Width = irradianceMapSize;
-		cubemapSpec.Height = irradianceMapSize;
-		Ref<TextureCube> irradianceMap = TextureCube::Create(cubemapSpec, {}, textureGenCommandBuffer);
+		Ref<TextureCube> irradianceMap = Renderer::GetBlackCubeTexture();
+		if (!sphericalHarmonicsIrradiance)
+		{
+			cubemapSpec.DebugName = "IrradianceMap";
+			cubemapSpec.Width = irradianceMapSize;
+			cubemapSpec.Height = irradianceMapSize;
+			irradianceMap = TextureCube::Create(cubemapSpec, {}, textureGenCommandBuffer);
+		}
 		RendererContext::GetCurrentDevice()->FlushCommandBuffer(textureGenCommandBuffer, true);
 
 		// Transfer image ownership to the compute queue
@@ -1043,6 +1402,7 @@ namespace Iris {
 		}
 
 		// 4. Generate Irradiance map
+		if (!sphericalHarmonicsIrradiance)
 		{
 			Renderer::Submit([irradianceMap, envFiltered]()
 			{
@@ -1063,52 +1423,137 @@ namespace Iris {
 					{ VK_IMAGE_ASPECT_COLOR_BIT, 0, irradianceMap->GetMipLevelCount(), 0, irradianceMap->GetNumLayers() });
 
 				irradianceMap->GenerateMips(true);
-
-				Renderer::TransferImageQueueOwnership(true, envFiltered->GetVulkanImage(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-					{ VK_IMAGE_ASPECT_COLOR_BIT, 0, envFiltered->GetMipLevelCount(), 0, envFiltered->GetNumLayers() });
 			});
 		}
 
-		Renderer::Submit([]()
+		Ref<Environment> environment = Environment::Create(envFiltered, irradianceMap);
+		Renderer::Submit([environment, cacheKey]()
 		{
+			Renderer::TransferImageQueueOwnership(true, environment->RadianceMap->GetVulkanImage(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+				{ VK_IMAGE_ASPECT_COLOR_BIT, 0, environment->RadianceMap->GetMipLevelCount(), 0, environment->RadianceMap->GetNumLayers() });
+
 			// Release the reference held by the DescriptorSetManager to the equirectangular image so that we can delete it
 			s_Data->EquirectToCubemapMaterial->Set("u_EquirectangularTexture", Renderer::GetWhiteTexture());
+
+			EnvironmentMapCache::RT_Store(cacheKey, environment);
 		});
 
-		return { envFiltered, irradianceMap };
+		return environment;
 	}
 
-	Ref<TextureCube> Renderer::CreatePreethamSky(float turbidity, float azimuth, float inclination, float sunSize)
+	Ref<TextureCube> Renderer::CreatePreethamSky(float turbidity, float azimuth, float inclination, float sunSize, bool preview)
 	{
-		const uint32_t cubemapSize = Renderer::GetConfig().EnvironmentMapResolution;
-		VkCommandBuffer commandBuffer = RendererContext::GetCurrentDevice()->GetCommandBuffer(true, true);
+		const uint32_t fullResolution = Renderer::GetConfig().EnvironmentMapResolution;
+		const PreethamSkyKey key = {
+			.Turbidity = static_cast<int32_t>(glm::round(turbidity / s_PreethamTurbidityStep)),
+			.Azimuth = static_cast<int32_t>(glm::round(glm::mod(azimuth, glm::two_pi<float>()) / s_PreethamAngleStep)),
+			.Inclination = static_cast<int32_t>(glm::round(inclination / s_PreethamAngleStep)),
+			.SunSize = static_cast<int32_t>(glm::round(sunSize / s_PreethamSunSizeStep)),
+			.Resolution = preview ? glm::max(fullResolution / 4, 32u) : fullResolution
+		};
 
-		TextureSpecification cubemapSpec = {
-			.DebugName = "PreethamSky",
-			.Width = cubemapSize,
-			.Height = cubemapSize,
-			.Format = ImageFormat::RGBA32F
+		std::vector<PreethamSkyCacheEntry>& cache = s_Data->PreethamSkyCache;
+		for (PreethamSkyCacheEntry& entry : cache)
+		{
+			if (entry.Key == key)
+			{
+				entry.LastUsedFrame = s_Data->FrameNumber;
+				return entry.Cubemap;
+			}
+		}
+
+		// Generated from the quantized parameters so that a cache hit looks exactly the same
+		const glm::vec4 params = {
+			key.Turbidity * s_PreethamTurbidityStep,
+			key.Azimuth * s_PreethamAngleStep,
+			key.Inclination * s_PreethamAngleStep,
+			key.SunSize * s_PreethamSunSizeStep
 		};
-		Ref<TextureCube> environmentMap = TextureCube::Create(cubemapSpec, {}, commandBuffer);
 
-		glm::vec4 params = { turbidity, azimuth, inclination, sunSize };
+		// When full, the least recently used sky makes room. Its cubemap is regenerated in place if it has the same size and nothing is
+		// using it anymore, otherwise a new one gets allocated
+		PreethamSkyCacheEntry* entry = nullptr;
+		uint32_t dirtyFaces = 0b111111;
+		if (cache.size() == s_PreethamSkyCacheSize)
+		{
+			entry = &*std::min_element(cache.begin(), cache.end(), [](const PreethamSkyCacheEntry& a, const PreethamSkyCacheEntry& b) { return a.LastUsedFrame < b.LastUsedFrame; });
+
+			const bool recyclable = entry->Key.Resolution == key.Resolution && entry->Cubemap->GetRefCount() == 1
+				&& s_Data->FrameNumber - entry->LastReferencedFrame > Renderer::GetConfig().FramesInFlight;
+			if (!recyclable)
+			{
+				entry->Cubemap = nullptr;
+			}
+			else if (entry->Key.Turbidity == key.Turbidity && entry->Key.Azimuth == key.Azimuth && entry->Key.Inclination == key.Inclination)
+			{
+				// Only the sun size changed (ex. dragging it) so only the faces with either of the two suns on them are different
+				const glm::vec3 sunDirection = Utils::GetPreethamSunDirection(params.y, params.z);
+				dirtyFaces = Utils::GetPreethamSunFaces(sunDirection, glm::max(params.w, entry->Key.SunSize * s_PreethamSunSizeStep));
+			}
+
+			entry->Key = key;
+		}
+		else
+		{
+			entry = &cache.emplace_back(PreethamSkyCacheEntry{ .Key = key });
+		}
+
+		entry->LastUsedFrame = s_Data->FrameNumber;
+
+		// The faces are regenerated as one contiguous range
+		const uint32_t firstFace = std::countr_zero(dirtyFaces);
+		const uint32_t faceCount = 32 - std::countl_zero(dirtyFaces) - firstFace;
+
+		// Everything runs on the graphics queue so that the cubemap never has to change queues, whether it is new or recycled
+		VkCommandBuffer commandBuffer = RendererContext::GetCurrentDevice()->GetCommandBuffer(true);
+
+		if (!entry->Cubemap)
+		{
+			TextureSpecification cubemapSpec = {
+				.DebugName = "PreethamSky",
+				.Width = key.Resolution,
+				.Height = key.Resolution,
+				.Format = ImageFormat::RGBA16F
+			};
+			entry->Cubemap = TextureCube::Create(cubemapSpec, {}, commandBuffer);
+		}
+		else
+		{
+			Renderer::Submit([commandBuffer, cubemap = entry->Cubemap, firstFace, faceCount]()
+			{
+				Renderer::InsertImageMemoryBarrier(
+					commandBuffer,
+					cubemap->GetVulkanImage(),
+					VK_ACCESS_2_SHADER_READ_BIT,
+					VK_ACCESS_2_SHADER_WRITE_BIT,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					VK_IMAGE_LAYOUT_GENERAL,
+					VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+					{ .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = cubemap->GetMipLevelCount(), .baseArrayLayer = firstFace, .layerCount = faceCount }
+				);
+			});
+		}
+
+		Ref<TextureCube> environmentMap = entry->Cubemap;
 		s_Data->PreethamSkyMaterial->Set("o_OutputCubeMap", environmentMap);
 
+		struct PreethamSkyConstants
+		{
+			glm::vec4 TurbidityAzimuthInclinationSunSize;
+			uint32_t FirstFace;
+		} constants = { params, firstFace };
+
 		Renderer::BeginComputePass(commandBuffer, s_Data->PreethamSkyPass);
-		Renderer::DispatchComputePass(commandBuffer, s_Data->PreethamSkyPass, s_Data->PreethamSkyMaterial, { cubemapSize / 32, cubemapSize / 32, 6 }, Buffer(reinterpret_cast<const uint8_t*>(&params), sizeof(glm::vec4)));
+		Renderer::DispatchComputePass(commandBuffer, s_Data->PreethamSkyPass, s_Data->PreethamSkyMaterial, { key.Resolution / 32, key.Resolution / 32, faceCount }, Buffer(reinterpret_cast<const uint8_t*>(&constants), sizeof(PreethamSkyConstants)));
 		Renderer::EndComputePass(commandBuffer, s_Data->PreethamSkyPass);
 
-		Renderer::Submit([commandBuffer, environmentMap]() mutable
+		Renderer::Submit([commandBuffer, environmentMap, firstFace, faceCount]() mutable
 		{
-			RendererContext::GetCurrentDevice()->FlushCommandBuffer(commandBuffer, true);
+			environmentMap->GenerateMips(true, commandBuffer, firstFace, faceCount);
 
-			// Transfer back to graphics queue in order to generate mips
-			Renderer::TransferImageQueueOwnership(true, environmentMap->GetVulkanImage(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-				{ VK_IMAGE_ASPECT_COLOR_BIT, 0, environmentMap->GetMipLevelCount(), 0, 6 });
-
-			environmentMap->GenerateMips(true);
+			RendererContext::GetCurrentDevice()->FlushCommandBuffer(commandBuffer);
 		});
 
 		return environmentMap;
@@ -1161,11 +1606,31 @@ namespace Iris {
 		return s_Data->DrawCallCount;
 	}
 
+	SkippedBindStatistics Renderer::GetSkippedBindStatistics()
+	{
+		return s_Data->SkippedBinds;
+	}
+
 	RenderCommandQueue& Renderer::GetRenderCommandQueue()
 	{
 		return s_Data->CommandQueue[s_Data->RenderCommandQueueSubmissionIndex];
 	}
 
+	RenderCommandQueue& Renderer::GetWorkerRenderCommandQueue()
+	{
+		return s_Data->WorkerCommandQueue[s_Data->RenderCommandQueueSubmissionIndex];
+	}
+
+	std::mutex& Renderer::GetWorkerRenderCommandQueueMutex()
+	{
+		return s_Data->WorkerCommandQueueMutex;
+	}
+
+	bool Renderer::IsWorkerThread()
+	{
+		return !Application::IsMainThread() && !RenderThread::IsCurrentThreadRT();
+	}
+
 	RenderCommandQueue& Renderer::GetRendererResourceReleaseQueue(uint32_t index)
 	{
 		return s_Data->RendererResourceFreeQueue[index];
@@ -23,14 +23,24 @@ namespace Iris {
 	class Pipeline;
 	class ComputePipeline;
 	class Material;
-	class MaterialTable;
 	class StaticMesh;
 	class MeshSource;
 	class RenderCommandBuffer;
 	class VertexBuffer;
 	class IndexBuffer;
+	class StorageBuffer;
 	class Environment;
 
+	// Binds the renderer did not record because the command buffer already had the same state bound
+	struct SkippedBindStatistics
+	{
+		uint32_t Pipelines = 0;
+		uint32_t DescriptorSets = 0;
+		uint32_t VertexBuffers = 0;
+		uint32_t IndexBuffers = 0;
+		uint32_t PushConstants = 0;
+	};
+
 	class Renderer
 	{
 	public:
@@ -59,7 +69,17 @@ namespace Iris {
 				pFunc->~FuncT();
 			};
 
-			void* storageBuffer = Renderer::GetRenderCommandQueue().Allocate(renderCmd, sizeof(func));
+			// The main thread records into the frame's queue without locking, worker threads (asset workers) share a queue of their own that the
+			// render thread executes right before the frame's queue
+			if (!IsWorkerThread())
+			{
+				void* storageBuffer = Renderer::GetRenderCommandQueue().Allocate(renderCmd, sizeof(func));
+				new(storageBuffer) FuncT(std::forward<FuncT>((FuncT&&)func));
+				return;
+			}
+
+			std::scoped_lock<std::mutex> lock(Renderer::GetWorkerRenderCommandQueueMutex());
+			void* storageBuffer = Renderer::GetWorkerRenderCommandQueue().Allocate(renderCmd, sizeof(func));
 			new(storageBuffer) FuncT(std::forward<FuncT>((FuncT&&)func));
 		}
 
@@ -115,17 +135,29 @@ namespace Iris {
 		// This is for shaders that have u_Renderer since they are ignored in the reflection
 		static void SubmitFullScreenQuadWithOverrides(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<Material> material, Buffer vertexShaderOverrides, Buffer fragmentShaderOverrides);
 
-		static void RenderStaticMesh(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, uint32_t subMeshIndex, Ref<MaterialTable> materialTable, Ref<VertexBuffer> transformBuffer, uint32_t transformOffset, uint32_t instanceCount, int viewMode);
-		static void RenderStaticMeshWithMaterial(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, uint32_t subMeshIndex, Ref<Material> material, Ref<VertexBuffer> transformBuffer, uint32_t transformOffset, uint32_t instanceCount);
+		// Binds the geometry heap and the per instance buffer, every static mesh draw of the pass after this uses them
+		static void BindStaticMeshGeometry(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<VertexBuffer> instanceBuffer);
+		static void BindStaticMeshGeometry(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<StorageBuffer> instanceBuffer);
+		// Materials come from the bindless table through the material index of every instance in the instance buffer
+		static void RenderStaticMesh(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<MeshSource> meshSource, uint32_t subMeshIndex, uint32_t permutationKey, uint32_t firstInstance, uint32_t instanceCount);
+		static void RenderStaticMeshWithMaterial(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, uint32_t subMeshIndex, Ref<Material> material, uint32_t firstInstance, uint32_t instanceCount);
+		// Draws up to maxDrawCount commands written by the GPU culling, the actual count is read from drawCountBuffer. The commands can be submeshes
+		// of any mesh source since they all live in the geometry heap
+		static void RenderStaticMeshIndirect(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, uint32_t permutationKey, Ref<StorageBuffer> drawCommandBuffer, uint32_t firstDrawCommand, Ref<StorageBuffer> drawCountBuffer, uint32_t drawCountIndex, uint32_t maxDrawCount);
 		static void RenderGeometry(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<Pipeline> pipeline, Ref<Material> material, Ref<VertexBuffer> vertexBuffer, Ref<IndexBuffer> indexBuffer, const glm::mat4& transform, uint32_t indexCount = 0);
 
 		// Compute passes
 		static void BeginComputePass(VkCommandBuffer commandBuffer, Ref<ComputePass> computePass);
 		static void EndComputePass(VkCommandBuffer commandBuffer, Ref<ComputePass> computePass);
 		static void DispatchComputePass(VkCommandBuffer commandBuffer, Ref<ComputePass> computePass, Ref<Material> material, const glm::uvec3& workGroups, Buffer constants = Buffer());
+		// For compute work that is recorded as part of a frame, the command buffer is only known once the render thread gets to it
+		static void BeginComputePass(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<ComputePass> computePass);
+		static void EndComputePass(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<ComputePass> computePass);
+		static void DispatchComputePass(Ref<RenderCommandBuffer> renderCommandBuffer, Ref<ComputePass> computePass, Ref<Material> material, const glm::uvec3& workGroups, Buffer constants = Buffer());
 
-		static std::pair<Ref<TextureCube>, Ref<TextureCube>> CreateEnvironmentMap(const std::string& filepath);
-		static Ref<TextureCube> CreatePreethamSky(float turbidity, float azimuth, float inclination, float sunSize);
+		static Ref<Environment> CreateEnvironmentMap(const std::string& filepath);
+		// Skies are cached by their quantized parameters. Previews are generated at a quarter of the resolution, meant for while the parameters are being dragged
+		static Ref<TextureCube> CreatePreethamSky(float turbidity, float azimuth, float inclination, float sunSize, bool preview = false);
 
 		static VkDescriptorSet RT_AllocateDescriptorSet(VkDescriptorSetAllocateInfo& allocInfo);
 
@@ -136,8 +168,13 @@ namespace Iris {
 		static Ref<TextureCube> GetBlackCubeTexture();
 		static Ref<Environment> GetEmptyEnvironment();
 		static uint32_t GetTotalDrawCallCount();
+		static SkippedBindStatistics GetSkippedBindStatistics();
 
 		static RenderCommandQueue& GetRenderCommandQueue();
+		static RenderCommandQueue& GetWorkerRenderCommandQueue();
+		static std::mutex& GetWorkerRenderCommandQueueMutex();
+		// Any thread that is neither the main thread nor the render thread
+		static bool IsWorkerThread();
 		static RenderCommandQueue& GetRendererResourceReleaseQueue(uint32_t index);
 
 		static void RegisterShaderDependency(Ref<Shader> shader, Ref<Pipeline> pipeline);
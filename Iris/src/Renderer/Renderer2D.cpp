@@ -107,10 +107,8 @@ namespace Iris {
 			delete[] quadIndices;
 		}
 
-		m_WhiteTexture = Renderer::GetWhiteTexture();
-
-		// First Texture slot is always the white texture...
-		m_TextureSlots[0] = m_WhiteTexture;
+		// Untextured quads use slot 0 of the bindless table which is always the white texture
+		m_FrameTextures.resize(framesInFlight);
 
 		m_QuadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
 		m_QuadVertexPositions[1] = { -0.5f,  0.5f, 0.0f, 1.0f };
@@ -282,16 +280,11 @@ namespace Iris {
 		for (uint32_t i = 0; i < m_TextVertexBufferPtr.size(); i++)
 			m_TextVertexBufferPtr[i] = m_TextVertexBufferBases[i][frameIndex];
 
-		m_TextureSlotIndex = 1;
-		m_FontTextureSlotIndex = 0;
 		m_TextBufferWriteIndex = 0;
 
-		// Set all other texture slots to null and keep only the first slot for the white texture
-		for (uint32_t i = 1; i < m_TextureSlots.size(); i++)
-			m_TextureSlots[i] = nullptr;
-
-		for (uint32_t i = 0; i < m_TextureSlots.size(); i++)
-			m_FontTextureSlots[i] = nullptr;
+		// The frame that used these last is no longer in flight
+		m_FrameTextures[frameIndex].clear();
+		m_TextureIndices.clear();
 	}
 
 	void Renderer2D::EndScene(bool prepareForRendering)
@@ -312,14 +305,6 @@ namespace Iris {
 				uint32_t indexCount = i == m_QuadBufferWriteIndex ? m_QuadIndexCount - (c_MaxIndices * i) : c_MaxIndices;
 				m_QuadVertexBuffers[i][frameIndex]->SetData(m_QuadVertexBufferBases[i][frameIndex], dataSize);
 
-				for (uint32_t j = 0; j < m_TextureSlots.size(); j++)
-				{
-					if (m_TextureSlots[j])
-						m_QuadMaterial->Set("u_Textures", m_TextureSlots[j], j);
-					else
-						m_QuadMaterial->Set("u_Textures", m_WhiteTexture, j);
-				}
-
 				Renderer::BeginRenderPass(m_RenderCommandBuffer, m_QuadPass);
 				Renderer::RenderGeometry(m_RenderCommandBuffer, m_QuadPass->GetPipeline(), m_QuadMaterial, m_QuadVertexBuffers[i][frameIndex], m_QuadIndexBuffer, glm::mat4(1.0f), indexCount);
 				Renderer::EndRenderPass(m_RenderCommandBuffer);
@@ -338,14 +323,6 @@ namespace Iris {
 				uint32_t indexCount = i == m_TextBufferWriteIndex ? m_TextIndexCount - (c_MaxIndices * i) : c_MaxIndices;
 				m_TextVertexBuffers[i][frameIndex]->SetData(m_TextVertexBufferBases[i][frameIndex], dataSize);
 
-				for (uint32_t j = 0; j < m_FontTextureSlots.size(); j++)
-				{
-					if (m_FontTextureSlots[j])
-						m_TextMaterial->Set("u_FontAtlases", m_FontTextureSlots[j], j);
-					else
-						m_TextMaterial->Set("u_FontAtlases", m_WhiteTexture, j);
-				}
-
 				Renderer::BeginRenderPass(m_RenderCommandBuffer, m_TextPass);
 				Renderer::RenderGeometry(m_RenderCommandBuffer, m_TextPass->GetPipeline(), m_TextMaterial, m_TextVertexBuffers[i][frameIndex], m_TextIndexBuffer, glm::mat4(1.0f), indexCount);
 				Renderer::EndRenderPass(m_RenderCommandBuffer);
@@ -551,6 +528,18 @@ namespace Iris {
 		return m_TextVertexBufferPtr[m_TextBufferWriteIndex];
 	}
 
+	float Renderer2D::GetTextureIndex(const Ref<Texture2D>& texture)
+	{
+		auto [it, inserted] = m_TextureIndices.try_emplace(texture.Raw(), 0.0f);
+		if (inserted)
+		{
+			it->second = static_cast<float>(texture->GetBindlessIndex());
+			m_FrameTextures[Renderer::GetCurrentFrameIndex()].push_back(texture);
+		}
+
+		return it->second;
+	}
+
 	void Renderer2D::DrawQuad(const glm::mat4& transform, const glm::vec4& color)
 	{
 		uint32_t frameIndex = Renderer::GetCurrentFrameIndex();
@@ -589,22 +578,7 @@ namespace Iris {
 		constexpr size_t quadVertexCount = 4;
 		glm::vec2 textureCoords[] = { uv0, { uv1.x, uv0.y }, uv1, { uv0.x, uv1.y } };
 
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < m_TextureSlotIndex; i++)
-		{
-			if (m_TextureSlots[i]->GetHash() == texture->GetHash())
-			{
-				textureIndex = static_cast<float>(i);
-				break;
-			}
-		}
-
-		if (textureIndex == 0.0f)
-		{
-			textureIndex = static_cast<float>(m_TextureSlotIndex);
-			m_TextureSlots[m_TextureSlotIndex] = texture;
-			m_TextureSlotIndex++;
-		}
+		const float textureIndex = GetTextureIndex(texture);
 
 		auto& bufferPtr = m_QuadVertexBufferPtr[m_QuadBufferWriteIndex];
 		for (size_t i = 0; i < quadVertexCount; i++)
@@ -676,22 +650,7 @@ namespace Iris {
 
 	void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, glm::vec2 uv0, glm::vec2 uv1)
 	{
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < m_TextureSlotIndex; i++)
-		{
-			if (m_TextureSlots[i]->GetHash() == texture->GetHash())
-			{
-				textureIndex = static_cast<float>(i);
-				break;
-			}
-		}
-
-		if (textureIndex == 0.0f)
-		{
-			textureIndex = static_cast<float>(m_TextureSlotIndex);
-			m_TextureSlots[m_TextureSlotIndex] = texture;
-			m_TextureSlotIndex++;
-		}
+		const float textureIndex = GetTextureIndex(texture);
 
 		glm::vec2 textureCoords[] = { uv0, { uv1.x, uv0.y }, uv1, { uv0.x, uv1.y } };
 
@@ -776,22 +735,7 @@ namespace Iris {
 
 	void Renderer2D::DrawQuadBillboard(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
 	{
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < m_TextureSlotIndex; i++)
-		{
-			if (m_TextureSlots[i]->GetHash() == texture->GetHash())
-			{
-				textureIndex = static_cast<float>(i);
-				break;
-			}
-		}
-
-		if (textureIndex == 0.0f)
-		{
-			textureIndex = static_cast<float>(m_TextureSlotIndex);
-			m_TextureSlots[m_TextureSlotIndex] = texture;
-			m_TextureSlotIndex++;
-		}
+		const float textureIndex = GetTextureIndex(texture);
 
 		glm::vec3 camRightWS = { m_CameraView[0][0], m_CameraView[1][0], m_CameraView[2][0] };
 		glm::vec3 camUpWS = { m_CameraView[0][1], m_CameraView[1][1], m_CameraView[2][1] };
@@ -885,22 +829,7 @@ namespace Iris {
 
 	void Renderer2D::DrawRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
 	{
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < m_TextureSlotIndex; i++)
-		{
-			if (m_TextureSlots[i]->GetHash() == texture->GetHash())
-			{
-				textureIndex = static_cast<float>(i);
-				break;
-			}
-		}
-
-		if (textureIndex == 0.0f)
-		{
-			textureIndex = static_cast<float>(m_TextureSlotIndex);
-			m_TextureSlots[m_TextureSlotIndex] = texture;
-			m_TextureSlotIndex++;
-		}
+		const float textureIndex = GetTextureIndex(texture);
 
 		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
 			* glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })
@@ -1067,23 +996,7 @@ namespace Iris {
 		Ref<Texture2D> fontAtlas = font->GetFontAtlas();
 		IR_ASSERT(fontAtlas);
 
-		float textureIndex = 0.0f;
-		for (uint32_t i = 0; i < m_FontTextureSlotIndex; i++)
-		{
-			//if (*m_FontTextureSlots[i].Raw() == *fontAtlas.Raw())
-			if (m_FontTextureSlots[i]->GetHash() == fontAtlas->GetHash())
-			{
-				textureIndex = static_cast<float>(i);
-				break;
-			}
-		}
-
-		if (textureIndex == 0.0f)
-		{
-			textureIndex = static_cast<float>(m_FontTextureSlotIndex);
-			m_FontTextureSlots[m_FontTextureSlotIndex] = fontAtlas;
-			m_FontTextureSlotIndex++;
-		}
+		const float textureIndex = GetTextureIndex(fontAtlas);
 
 		const msdf_atlas::FontGeometry& fontGeometry = font->GetMSDFData()->FontGeometry;
 		const msdfgen::FontMetrics& metrics = fontGeometry.getMetrics();
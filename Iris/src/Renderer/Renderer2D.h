@@ -108,6 +108,7 @@ namespace Iris {
 		MemoryStatistics GetMemoryStats();
 
 		const Renderer2DSpecification& GetSpecification() const { return m_Specification; }
+		Ref<RenderCommandBuffer> GetRenderCommandBuffer() const { return m_RenderCommandBuffer; }
 
 	private:
 		void PrepareImagesForRendering();
@@ -142,20 +143,23 @@ namespace Iris {
 		QuadVertex*& GetWriteableQuadBuffer();
 		LineVertex*& GetWriteableLineBuffer();
 		TextVertex*& GetWriteableTextBuffer();
+
+		// Slot of the texture in the bindless table, also keeps the texture alive until the frame is no longer in flight
+		float GetTextureIndex(const Ref<Texture2D>& texture);
 		
 	private:
 		Renderer2DSpecification m_Specification;
 		Ref<RenderCommandBuffer> m_RenderCommandBuffer;
 
-		static const uint32_t MaxTextureSlots = 32; // NOTE: Better to derive from RenderCaps
-
 		const uint32_t c_MaxVertices;
 		const uint32_t c_MaxIndices;
 
 		const uint32_t c_MaxLineVertices;
 		const uint32_t c_MaxLineIndices;
 
-		Ref<Texture2D> m_WhiteTexture;
+		// Textures and font atlases drawn with during each frame in flight
+		std::vector<std::vector<Ref<Texture2D>>> m_FrameTextures;
+		std::unordered_map<Texture2D*, float> m_TextureIndices; // Of the current frame
 
 		// Per-frame -> and in case we need more we create another one
 		using VertexBufferPerFrame = std::vector<Ref<VertexBuffer>>;
@@ -172,9 +176,6 @@ namespace Iris {
 		std::vector<QuadVertex*> m_QuadVertexBufferPtr;
 		uint32_t m_QuadBufferWriteIndex = 0;
 
-		std::array<Ref<Texture2D>, MaxTextureSlots> m_TextureSlots;
-		uint32_t m_TextureSlotIndex = 1; // 0 = white texture
-
 		glm::vec4 m_QuadVertexPositions[4];
 
 		// Lines TODO: Lines on top pass? (no depth testing)
@@ -194,8 +195,6 @@ namespace Iris {
 		std::vector<VertexBufferPerFrame> m_TextVertexBuffers;
 		Ref<IndexBuffer> m_TextIndexBuffer;
 		Ref<Material> m_TextMaterial;
-		std::array<Ref<Texture2D>, MaxTextureSlots> m_FontTextureSlots;
-		uint32_t m_FontTextureSlotIndex = 0;
 
 		uint32_t m_TextIndexCount = 0;
 		using TextVertexBasePerFrame = std::vector<TextVertex*>;
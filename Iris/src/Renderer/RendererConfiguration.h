@@ -14,6 +14,16 @@ namespace Iris {
 
 		uint32_t EnvironmentMapResolution = 1024;
 		uint32_t IrradianceMapComputeSamples = 512;
+		// Diffuse IBL uses L2 spherical harmonics projected on the CPU instead of generating and sampling a 32x32 irradiance cubemap
+		bool SphericalHarmonicsIrradiance = false;
+
+		// Textures loaded from files only upload their lowest mips and the TextureStreamer pages in the rest depending on their size on screen
+		bool TextureStreaming = true;
+		// VRAM that streamed textures are allowed to take up
+		uint64_t TextureStreamingBudget = 512ull * 1024 * 1024;
+
+		// Size of the ring buffer that staging uploads are suballocated from, bigger uploads get their own staging buffer
+		uint64_t StagingRingSize = 64ull * 1024 * 1024;
 	};
 
 }
\ No newline at end of file
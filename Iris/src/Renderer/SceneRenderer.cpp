@@ -8,10 +8,56 @@
 #include "Shaders/Shader.h"
 #include "StorageBufferSet.h"
 #include "Texture.h"
+#include "TextureStreamer.h"
 #include "UniformBufferSet.h"
 
+#include <bit>
+
 namespace Iris {
 
+	// Parameters that get set every frame
+	constexpr static MaterialParam s_GridScaleParam("u_Uniforms.Scale");
+	constexpr static MaterialParam s_SkyboxTextureLodParam("u_Uniforms.TextureLod");
+	constexpr static MaterialParam s_SkyboxIntensityParam("u_Uniforms.Intensity");
+	constexpr static MaterialParam s_SkyboxTextureParam("u_Texture");
+	constexpr static MaterialParam s_CompositeExposureParam("u_Uniforms.Exposure");
+	constexpr static MaterialParam s_CompositeOpacityParam("u_Uniforms.Opacity");
+	constexpr static MaterialParam s_CompositeTimeParam("u_Uniforms.Time");
+
+	// Draw index of the free slots in the GPU instance buffer, GPUCulling.glsl skips those
+	constexpr static uint32_t s_InvalidGPUDrawIndex = ~0u;
+
+	namespace Utils {
+
+		// Planes point inwards, Vulkan clip space (0 <= z <= w)
+		static void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4* planes)
+		{
+			const glm::mat4 rows = glm::transpose(viewProjection);
+			planes[0] = rows[3] + rows[0]; // Left
+			planes[1] = rows[3] - rows[0]; // Right
+			planes[2] = rows[3] + rows[1]; // Bottom
+			planes[3] = rows[3] - rows[1]; // Top
+			planes[4] = rows[2];           // z >= 0
+			planes[5] = rows[3] - rows[2]; // z <= w
+
+			for (uint32_t i = 0; i < 6; i++)
+			{
+				// The plane at infinity of an infinite projection has no normal and is always passed
+				const float length = glm::length(glm::vec3(planes[i]));
+				if (length > 0.0f)
+					planes[i] /= length;
+			}
+		}
+
+		// The old buffers are only freed once no frame in flight uses them
+		static void ResizeStorageBufferSet(const Ref<StorageBufferSet>& storageBufferSet, uint32_t size)
+		{
+			for (uint32_t frame = 0; frame < Renderer::GetConfig().FramesInFlight; frame++)
+				storageBufferSet->Get(frame)->Resize(size);
+		}
+
+	}
+
 	Ref<SceneRenderer> SceneRenderer::Create(Ref<Scene> scene, const SceneRendererSpecification& spec)
 	{
 		return CreateRef<SceneRenderer>(scene, spec);
@@ -57,7 +103,8 @@ namespace Iris {
 		VertexInputLayout instanceLayout = {
 			{ ShaderDataType::Float4, "a_MatrixRow0" },
 			{ ShaderDataType::Float4, "a_MatrixRow1" },
-			{ ShaderDataType::Float4, "a_MatrixRow2" }
+			{ ShaderDataType::Float4, "a_MatrixRow2" },
+			{ ShaderDataType::UInt,   "a_MaterialIndex" }
 		};
 
 		// Pre-Depth
@@ -347,7 +394,7 @@ namespace Iris {
 			};
 			m_GridPass = RenderPass::Create(gridPassSpec);
 			m_GridMaterial = Material::Create(gridPipelineSpec.Shader, "GridMaterial");
-			m_GridMaterial->Set("u_Uniforms.Scale", m_TranslationSnapValue);
+			m_GridMaterial->Set(s_GridScaleParam, m_TranslationSnapValue);
 		
 			m_GridPass->SetInput("Camera", m_UBSCamera);
 			m_GridPass->Bake();
@@ -538,12 +585,142 @@ namespace Iris {
 			m_MeshTransformBuffers[i].Data = new TransformVertexData[TransformBufferCount];
 		}
 
+		// GPU driven rendering
+		if (m_Specification.GPUDrivenRendering && !RendererContext::GetCurrentDevice()->IsIndirectDrawCountSupported())
+		{
+			IR_CORE_WARN_TAG("Renderer", "Device does not support indirect count draws, falling back to CPU draws for scene: {0}", m_Scene->GetName());
+			m_Specification.GPUDrivenRendering = false;
+		}
+
+		if (m_Specification.GPUDrivenRendering)
+			CreateGPUDrivenResources();
+
 		m_Renderer2D = Renderer2D::Create({ .TargetFramebuffer = m_CompositingFramebuffer });
 
 		Ref<SceneRenderer> instance = this;
 		Renderer::Submit([instance]() mutable { instance->m_ResourcesCreatedGPU = true; });
 	}
 
+	void SceneRenderer::SetGPUDrivenRendering(bool enabled)
+	{
+		IR_VERIFY(!m_Active, "Not able to switch the draw path while the scene is being rendered");
+
+		if (m_Specification.GPUDrivenRendering == enabled)
+			return;
+
+		if (enabled && !RendererContext::GetCurrentDevice()->IsIndirectDrawCountSupported())
+		{
+			IR_CORE_WARN_TAG("Renderer", "Device does not support indirect count draws, keeping CPU draws for scene: {0}", m_Scene->GetName());
+			return;
+		}
+
+		m_Specification.GPUDrivenRendering = enabled;
+
+		if (enabled)
+		{
+			CreateGPUDrivenResources();
+
+			// Otherwise the pyramid is created along with the framebuffers in the next BeginScene
+			if (m_ViewportWidth > 0 && m_ViewportHeight > 0 && !m_NeedsResize)
+				CreateHiZResources();
+		}
+		else
+		{
+			ReleaseGPUDrivenResources();
+		}
+	}
+
+	void SceneRenderer::CreateGPUDrivenResources()
+	{
+		// The culled instances are read back as the instance vertex buffer so they have to keep its layout
+		static_assert(sizeof(TransformVertexData) == 13 * sizeof(uint32_t));
+
+		m_GPUInstanceCapacity = 10 * 1024; // Grows with the scene, see BuildIndirectDrawGroups
+		m_GPUDrawCapacity = 1024;
+		m_GPUDrawGroupCapacity = 256;
+
+		m_UBSCulling = UniformBufferSet::Create(sizeof(UBCulling));
+
+		m_SBSInstanceInput = StorageBufferSet::Create(false, sizeof(GPUInstanceData) * m_GPUInstanceCapacity);
+		m_SBSDrawInput = StorageBufferSet::Create(false, sizeof(GPUDrawData) * m_GPUDrawCapacity);
+		m_SBSDrawGroups = StorageBufferSet::Create(false, sizeof(GPUDrawGroupData) * m_GPUDrawGroupCapacity);
+		m_SBSCulledInstances = StorageBufferSet::Create(true, sizeof(TransformVertexData) * m_GPUInstanceCapacity, 0, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+		m_SBSDrawCounters = StorageBufferSet::Create(true, sizeof(uint32_t) * m_GPUDrawCapacity);
+		m_SBSDrawCommands = StorageBufferSet::Create(true, sizeof(VkDrawIndexedIndirectCommand) * m_GPUDrawCapacity, 0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+		m_SBSGroupCounts = StorageBufferSet::Create(true, sizeof(uint32_t) * m_GPUDrawGroupCapacity, 0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+		Ref<Shader> cullingShader = Renderer::GetShadersLibrary()->Get("GPUCulling");
+		ComputePassSpecification cullingPassSpec = {
+			.DebugName = "GPUCullingPass",
+			.Pipeline = ComputePipeline::Create(cullingShader, "GPUCullingPipeline"),
+			.MarkerColor = { 0.9f, 0.5f, 0.1f, 1.0f }
+		};
+		m_GPUCullingPass = ComputePass::Create(cullingPassSpec);
+		m_GPUCullingPass->SetInput("CullingData", m_UBSCulling);
+		m_GPUCullingPass->SetInput("u_HiZTexture", Renderer::GetWhiteTexture()); // Replaced by the depth pyramid once the viewport has a size
+		m_GPUCullingPass->SetInput("InstanceInput", m_SBSInstanceInput);
+		m_GPUCullingPass->SetInput("DrawInput", m_SBSDrawInput);
+		m_GPUCullingPass->SetInput("CulledInstances", m_SBSCulledInstances);
+		m_GPUCullingPass->SetInput("DrawCounters", m_SBSDrawCounters);
+		m_GPUCullingPass->Bake();
+
+		Ref<Shader> drawCompactionShader = Renderer::GetShadersLibrary()->Get("GPUDrawCompaction");
+		ComputePassSpecification drawCompactionPassSpec = {
+			.DebugName = "DrawCompactionPass",
+			.Pipeline = ComputePipeline::Create(drawCompactionShader, "DrawCompactionPipeline"),
+			.MarkerColor = { 0.9f, 0.6f, 0.2f, 1.0f }
+		};
+		m_DrawCompactionPass = ComputePass::Create(drawCompactionPassSpec);
+		m_DrawCompactionPass->SetInput("CullingData", m_UBSCulling);
+		m_DrawCompactionPass->SetInput("DrawInput", m_SBSDrawInput);
+		m_DrawCompactionPass->SetInput("DrawCounters", m_SBSDrawCounters);
+		m_DrawCompactionPass->SetInput("DrawCommands", m_SBSDrawCommands);
+		m_DrawCompactionPass->SetInput("DrawGroups", m_SBSDrawGroups);
+		m_DrawCompactionPass->SetInput("GroupCounts", m_SBSGroupCounts);
+		m_DrawCompactionPass->Bake();
+
+		Ref<Shader> hiZShader = Renderer::GetShadersLibrary()->Get("HiZBuild");
+		ComputePassSpecification hiZPassSpec = {
+			.DebugName = "HiZPass",
+			.Pipeline = ComputePipeline::Create(hiZShader, "HiZPipeline"),
+			.MarkerColor = { 0.6f, 0.6f, 0.6f, 1.0f }
+		};
+		m_HiZPass = ComputePass::Create(hiZPassSpec);
+		m_HiZPass->Bake();
+
+		ResetGPUScene();
+	}
+
+	void SceneRenderer::ReleaseGPUDrivenResources()
+	{
+		// Frames in flight keep what they recorded alive, the Vulkan objects are only freed once they are done
+		m_GPUCullingPass = nullptr;
+		m_DrawCompactionPass = nullptr;
+		m_HiZPass = nullptr;
+
+		m_UBSCulling = nullptr;
+		m_SBSInstanceInput = nullptr;
+		m_SBSDrawInput = nullptr;
+		m_SBSDrawGroups = nullptr;
+		m_SBSCulledInstances = nullptr;
+		m_SBSDrawCounters = nullptr;
+		m_SBSDrawCommands = nullptr;
+		m_SBSGroupCounts = nullptr;
+
+		m_HiZTexture = nullptr;
+		m_HiZValid = false;
+
+		// The views are created on the render thread
+		Ref<SceneRenderer> instance = this;
+		Renderer::Submit([instance]() mutable
+		{
+			instance->m_HiZMipViews.clear();
+			instance->m_HiZDepthView = nullptr;
+		});
+
+		ResetGPUScene();
+	}
+
 	void SceneRenderer::Shutdown()
 	{
 		for (auto& transformBuffer : m_MeshTransformBuffers)
@@ -626,6 +803,9 @@ namespace Iris {
 		 
 		 	if (m_JumpFloodCompositePass)
 		 		m_JumpFloodCompositePass->GetTargetFramebuffer()->Resize(m_ViewportWidth, m_ViewportHeight);
+
+			if (m_Specification.GPUDrivenRendering)
+				CreateHiZResources();
 		}
 
 		// Update uniform buffers data for the starting frame
@@ -656,6 +836,10 @@ namespace Iris {
 
 			cameraData.DepthUnpackConsts = { depthLinearMul, depthLinearizeAdd };
 
+			// Orthographic projections have no perspective divide so the size on screen does not depend on the distance
+			m_TextureStreamingPerspective = cameraData.ProjectionMatrix[2][3] != 0.0f;
+			m_TextureStreamingProjectionScale = glm::abs(cameraData.ProjectionMatrix[1][1]) * 0.5f * static_cast<float>(m_ViewportHeight);
+
 			Ref<SceneRenderer> instance = this;
 			Renderer::Submit([instance, cameraData]() mutable
 			{
@@ -690,9 +874,12 @@ namespace Iris {
 			sceneData.CameraPosition = m_CameraDataUB.InverseViewMatrix[3];
 			sceneData.EnvironmentMapIntensity = m_SceneInfo.SceneEnvironmentIntensity; // Mirrors the value that is sent to the Skybox shader
 
+			// The spherical harmonics of an environment that was not loaded from the cache are only projected on the render thread
 			Ref<SceneRenderer> instance = this;
-			Renderer::Submit([instance, sceneData]() mutable
+			Renderer::Submit([instance, sceneData, environment = m_SceneInfo.SceneEnvironment]() mutable
 			{
+				sceneData.IrradianceSH = environment->IrradianceSH;
+				sceneData.UseIrradianceSH = environment->HasIrradianceSH ? 1 : 0;
 				instance->m_UBSSceneData->RT_Get()->RT_SetData(&sceneData, sizeof(UBScene));
 			});
 		}
@@ -702,12 +889,13 @@ namespace Iris {
 	{
 		IR_VERIFY(m_Active);
 
+		RequestStreamedTextureMips();
 		FlushDrawList();
 
 		m_Active = false;
 	}
 
-	void SceneRenderer::SubmitStaticMesh(Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, Ref<MaterialTable> materialTable, const glm::mat4& transform, Ref<Material> overrideMaterial)
+	void SceneRenderer::SubmitStaticMesh(UUID entityID, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, Ref<MaterialTable> materialTable, const glm::mat4& transform, Ref<Material> overrideMaterial)
 	{
 		const std::vector<MeshUtils::SubMesh>& subMeshData = meshSource->GetSubMeshes();
 		for (uint32_t subMeshIndex : staticMesh->GetSubMeshes())
@@ -722,31 +910,37 @@ namespace Iris {
 			IR_VERIFY(materialAssetHandle);
 			Ref<MaterialAsset> materialAsset = AssetManager::GetAsset<MaterialAsset>(materialAssetHandle);
 
-			MeshKey meshKey = { staticMesh->Handle, materialAssetHandle, subMeshIndex, false };
+			if (!overrideMaterial)
+				AccumulateTextureStreamingSize(materialAsset, subMesh.BoundingBox, subMeshTransform);
+
+			const bool isDoubleSided = materialAsset->IsDoubleSided();
+			MeshKey meshKey = { staticMesh->Handle, subMeshIndex, materialAsset->GetMaterial()->GetPermutationKey(), isDoubleSided, false };
 			TransformVertexData& transformStorage = m_MeshTransformMap[meshKey].Transforms.emplace_back();
 
 			// glm::mat4 [column][row]
 			transformStorage.MatrixRow[0] = { subMeshTransform[0][0],  subMeshTransform[1][0], subMeshTransform[2][0] , subMeshTransform[3][0] };
 			transformStorage.MatrixRow[1] = { subMeshTransform[0][1],  subMeshTransform[1][1], subMeshTransform[2][1] , subMeshTransform[3][1] };
 			transformStorage.MatrixRow[2] = { subMeshTransform[0][2],  subMeshTransform[1][2], subMeshTransform[2][2] , subMeshTransform[3][2] };
+			transformStorage.MaterialIndex = materialAsset->GetBindlessIndex();
+
+			if (m_Specification.GPUDrivenRendering)
+				UpdateGPUSceneInstance(entityID, meshKey, meshSource, transformStorage);
 
 			// For main geometry drawlist
 			// TODO: Check if transparent for transparent materials
 			{
-				bool isDoubleSided = materialAsset->IsDoubleSided();
 				auto& destDrawList = isDoubleSided == true ? m_DoubleSidedStaticMeshDrawList : m_StaticMeshDrawList;
 				auto& dc = destDrawList[meshKey];
 				dc.StaticMesh = staticMesh;
 				dc.MeshSource = meshSource;
 				dc.SubMeshIndex = subMeshIndex;
-				dc.MaterialTable = materialTable;
 				dc.OverrideMaterial = overrideMaterial;
 				dc.InstanceCount++;
 			}
 		}
 	}
 
-	void SceneRenderer::SubmitSelectedStaticMesh(Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, Ref<MaterialTable> materialTable, const glm::mat4& transform, Ref<Material> overrideMaterial)
+	void SceneRenderer::SubmitSelectedStaticMesh(UUID entityID, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, Ref<MaterialTable> materialTable, const glm::mat4& transform, Ref<Material> overrideMaterial)
 	{
 		const std::vector<MeshUtils::SubMesh>& subMeshData = meshSource->GetSubMeshes();
 		for (uint32_t subMeshIndex : staticMesh->GetSubMeshes())
@@ -761,36 +955,40 @@ namespace Iris {
 			IR_VERIFY(materialAssetHandle);
 			Ref<MaterialAsset> materialAsset = AssetManager::GetAsset<MaterialAsset>(materialAssetHandle);
 
-			MeshKey meshKey = { staticMesh->Handle, materialAssetHandle, subMeshIndex, true };
+			if (!overrideMaterial)
+				AccumulateTextureStreamingSize(materialAsset, subMesh.BoundingBox, subMeshTransform);
+
+			const bool isDoubleSided = materialAsset->IsDoubleSided();
+			MeshKey meshKey = { staticMesh->Handle, subMeshIndex, materialAsset->GetMaterial()->GetPermutationKey(), isDoubleSided, true };
 			TransformVertexData& transformStorage = m_MeshTransformMap[meshKey].Transforms.emplace_back();
 
 			// glm::mat4 [column][row]
 			transformStorage.MatrixRow[0] = { subMeshTransform[0][0],  subMeshTransform[1][0], subMeshTransform[2][0] , subMeshTransform[3][0] };
 			transformStorage.MatrixRow[1] = { subMeshTransform[0][1],  subMeshTransform[1][1], subMeshTransform[2][1] , subMeshTransform[3][1] };
 			transformStorage.MatrixRow[2] = { subMeshTransform[0][2],  subMeshTransform[1][2], subMeshTransform[2][2] , subMeshTransform[3][2] };
+			transformStorage.MaterialIndex = materialAsset->GetBindlessIndex();
+
+			if (m_Specification.GPUDrivenRendering)
+				UpdateGPUSceneInstance(entityID, meshKey, meshSource, transformStorage);
 
 			// For main geometry drawlist
 			// TODO: Check if transparent for transparent materials
 			{
-				bool isDoubleSided = materialAsset->IsDoubleSided();
 				auto& destDrawList =  isDoubleSided == true ? m_DoubleSidedStaticMeshDrawList : m_StaticMeshDrawList;
 				auto& dc = destDrawList[meshKey];
 				dc.StaticMesh = staticMesh;
 				dc.MeshSource = meshSource;
 				dc.SubMeshIndex = subMeshIndex;
-				dc.MaterialTable = materialTable;
 				dc.OverrideMaterial = overrideMaterial;
 				dc.InstanceCount++;
 			}
 
 			// For selected mesh drawlist
 			{
-				bool isDoubleSided = materialAsset->IsDoubleSided();
 				auto& dc = isDoubleSided == true ? m_DoubleSidedSelectedStaticMeshDrawList[meshKey] : m_SelectedStaticMeshDrawList[meshKey];
 				dc.StaticMesh = staticMesh;
 				dc.MeshSource = meshSource;
 				dc.SubMeshIndex = subMeshIndex;
-				dc.MaterialTable = materialTable;
 				dc.OverrideMaterial = overrideMaterial;
 				dc.InstanceCount++;
 			}
@@ -907,10 +1105,17 @@ namespace Iris {
 			m_CommandBuffer->Begin();
 
 			ResetImageLayouts();
+
+			if (m_Specification.GPUDrivenRendering)
+				GPUCullingPass();
+
 			PreDepthPass();
 			SkyboxPass();
 			GeometryPass();
 
+			if (m_Specification.GPUDrivenRendering)
+				HiZPass();
+
 			if (m_Specification.JumpFloodPass)
 				JumpFloodPass();
 
@@ -933,6 +1138,10 @@ namespace Iris {
 
 		UpdateStatistics();
 
+		// The depth pyramid of this frame gets tested with the camera it was rendered with
+		m_PreviousViewProjection = m_CameraDataUB.ViewProjectionMatrix;
+		m_GPUSceneFrame++;
+
 		m_StaticMeshDrawList.clear();
 		m_DoubleSidedStaticMeshDrawList.clear();
 		m_SelectedStaticMeshDrawList.clear();
@@ -953,7 +1162,7 @@ namespace Iris {
 		uint32_t offset = 0;
 		for (auto& [meshKey, transformData] : m_MeshTransformMap)
 		{
-			transformData.TransformOffset = offset * sizeof(TransformVertexData);
+			transformData.FirstInstance = offset;
 			for (const auto& transform : transformData.Transforms)
 			{
 				*(m_MeshTransformBuffers[frameIndex].Data + offset) = transform;
@@ -963,6 +1172,405 @@ namespace Iris {
 		}
 
 		m_MeshTransformBuffers[frameIndex].VertexBuffer->SetData(m_MeshTransformBuffers[frameIndex].Data, offset * sizeof(TransformVertexData));
+
+		if (m_Specification.GPUDrivenRendering)
+			BuildIndirectDrawGroups();
+	}
+
+	void SceneRenderer::UpdateGPUSceneInstance(UUID entityID, const MeshKey& meshKey, const Ref<MeshSource>& meshSource, const TransformVertexData& transform)
+	{
+		// Selecting an entity does not change how the main passes draw it
+		MeshKey drawKey = meshKey;
+		drawKey.IsSelected = false;
+
+		auto [drawIt, newDraw] = m_GPUSceneDraws.try_emplace(drawKey);
+		GPUSceneDraw& draw = drawIt->second;
+		if (newDraw)
+		{
+			if (m_FreeGPUDrawSlots.empty())
+			{
+				draw.Index = static_cast<uint32_t>(m_GPUDraws.size());
+				m_GPUDraws.emplace_back();
+			}
+			else
+			{
+				draw.Index = m_FreeGPUDrawSlots.back();
+				m_FreeGPUDrawSlots.pop_back();
+			}
+
+			draw.SubMeshIndex = meshKey.SubMeshIndex;
+			m_GPUDrawLayoutDirty = true;
+		}
+
+		// A reloaded mesh source is a new object, BuildIndirectDrawGroups picks up where its geometry went
+		if (draw.MeshSource != meshSource)
+			draw.MeshSource = meshSource;
+
+		const GPUSceneInstanceKey instanceKey = { entityID, meshKey.SubMeshIndex };
+		auto instanceIt = m_GPUSceneInstances.find(instanceKey);
+		if (instanceIt == m_GPUSceneInstances.end())
+		{
+			uint32_t slot = 0;
+			if (m_FreeGPUInstanceSlots.empty())
+			{
+				slot = static_cast<uint32_t>(m_GPUInstances.size());
+				m_GPUInstances.emplace_back();
+				m_GPUInstanceDirtyFrames.push_back(0);
+			}
+			else
+			{
+				slot = m_FreeGPUInstanceSlots.back();
+				m_FreeGPUInstanceSlots.pop_back();
+			}
+
+			instanceIt = m_GPUSceneInstances.emplace(instanceKey, GPUSceneInstance{ .Slot = slot, .DrawKey = drawKey, .LastSubmittedFrame = m_GPUSceneFrame }).first;
+			draw.InstanceCount++;
+			m_GPUDrawLayoutDirty = true;
+		}
+		else
+		{
+			GPUSceneInstance& instance = instanceIt->second;
+			instance.LastSubmittedFrame = m_GPUSceneFrame;
+
+			if (instance.DrawKey < drawKey || drawKey < instance.DrawKey)
+			{
+				// The material switched to another pipeline variant or the mesh of the entity changed
+				ReleaseGPUSceneDrawInstance(instance.DrawKey);
+				instance.DrawKey = drawKey;
+				draw.InstanceCount++;
+			}
+			else
+			{
+				const GPUInstanceData& current = m_GPUInstances[instance.Slot];
+				if (std::memcmp(current.MatrixRow, transform.MatrixRow, sizeof(transform.MatrixRow)) == 0 && current.MaterialIndex == transform.MaterialIndex)
+					return;
+			}
+		}
+
+		const uint32_t slot = instanceIt->second.Slot;
+		m_GPUInstances[slot] = {
+			.MatrixRow = { transform.MatrixRow[0], transform.MatrixRow[1], transform.MatrixRow[2] },
+			.MaterialIndex = transform.MaterialIndex,
+			.DrawIndex = draw.Index
+		};
+		MarkGPUInstanceDirty(slot);
+	}
+
+	void SceneRenderer::ReleaseGPUSceneDrawInstance(const MeshKey& drawKey)
+	{
+		auto it = m_GPUSceneDraws.find(drawKey);
+		IR_ASSERT(it != m_GPUSceneDraws.end());
+
+		// Nothing references the slot of an empty draw anymore so it can be handed out again as it is
+		if (--it->second.InstanceCount == 0)
+		{
+			m_FreeGPUDrawSlots.push_back(it->second.Index);
+			m_GPUSceneDraws.erase(it);
+		}
+
+		m_GPUDrawLayoutDirty = true;
+	}
+
+	void SceneRenderer::MarkGPUInstanceDirty(uint32_t slot)
+	{
+		uint32_t& dirtyFrames = m_GPUInstanceDirtyFrames[slot];
+		for (uint32_t frame = 0; frame < static_cast<uint32_t>(m_GPUSceneUploads.size()); frame++)
+		{
+			if (dirtyFrames & (1u << frame))
+				continue;
+
+			dirtyFrames |= 1u << frame;
+			m_GPUSceneUploads[frame].DirtyInstances.push_back(slot);
+		}
+	}
+
+	void SceneRenderer::ResetGPUScene()
+	{
+		m_GPUSceneInstances.clear();
+		m_GPUSceneDraws.clear();
+		m_GPUInstances.clear();
+		m_GPUDraws.clear();
+		m_GPUDrawGroups.clear();
+		m_GPUInstanceDirtyFrames.clear();
+		m_FreeGPUInstanceSlots.clear();
+		m_FreeGPUDrawSlots.clear();
+		m_IndirectDrawGroups.clear();
+		m_DoubleSidedIndirectDrawGroups.clear();
+
+		// The buffers were just created so every frame uploads everything once
+		m_GPUSceneUploads.assign(Renderer::GetConfig().FramesInFlight, {});
+
+		m_GPUInstanceCount = 0;
+		m_GPUDrawCount = 0;
+		m_GPUDrawGroupCount = 0;
+		m_GPUDrawLayoutDirty = true;
+	}
+
+	void SceneRenderer::BuildIndirectDrawGroups()
+	{
+		// Entities that were not submitted this frame were removed or hidden
+		for (auto it = m_GPUSceneInstances.begin(); it != m_GPUSceneInstances.end();)
+		{
+			if (it->second.LastSubmittedFrame == m_GPUSceneFrame)
+			{
+				++it;
+				continue;
+			}
+
+			const uint32_t slot = it->second.Slot;
+			m_GPUInstances[slot] = { .DrawIndex = s_InvalidGPUDrawIndex };
+			MarkGPUInstanceDirty(slot);
+			m_FreeGPUInstanceSlots.push_back(slot);
+
+			ReleaseGPUSceneDrawInstance(it->second.DrawKey);
+			it = m_GPUSceneInstances.erase(it);
+		}
+
+		// New draws and the draws of reloaded mesh sources get their geometry from the geometry heap
+		for (const auto& [drawKey, draw] : m_GPUSceneDraws)
+		{
+			const MeshUtils::SubMesh& subMesh = draw.MeshSource->GetSubMeshes()[draw.SubMeshIndex];
+			const GeometryAllocation geometry = draw.MeshSource->GetGeometry();
+
+			GPUDrawData& drawData = m_GPUDraws[draw.Index];
+			const GPUDrawData geometryData = {
+				.IndexCount = subMesh.IndexCount,
+				.FirstIndex = geometry.IndexOffset + subMesh.BaseIndex,
+				.VertexOffset = static_cast<int32_t>(geometry.VertexOffset + subMesh.BaseVertex),
+				.FirstInstance = drawData.FirstInstance,
+				.Group = drawData.Group,
+				.BoundsMin = glm::vec4(subMesh.BoundingBox.Min, 0.0f),
+				.BoundsMax = glm::vec4(subMesh.BoundingBox.Max, 0.0f)
+			};
+
+			if (std::memcmp(&drawData, &geometryData, sizeof(GPUDrawData)) != 0)
+			{
+				drawData = geometryData;
+				m_GPUDrawLayoutDirty = true;
+			}
+		}
+
+		if (m_GPUDrawLayoutDirty)
+		{
+			m_GPUDrawLayoutDirty = false;
+
+			m_IndirectDrawGroups.clear();
+			m_DoubleSidedIndirectDrawGroups.clear();
+			m_GPUDrawGroups.clear();
+
+			// Every mesh source lives in the geometry heap so only the pipeline variant splits the draws into groups
+			std::map<std::pair<bool, uint32_t>, std::vector<const GPUSceneDraw*>> groupedDraws;
+			for (const auto& [drawKey, draw] : m_GPUSceneDraws)
+				groupedDraws[{ drawKey.IsDoubleSided, drawKey.PermutationKey }].push_back(&draw);
+
+			// Each draw gets as many slots in the culled instance buffer as it has instances, and each group as many commands as it has draws
+			uint32_t firstInstance = 0;
+			uint32_t firstCommand = 0;
+			for (const auto& [groupKey, draws] : groupedDraws)
+			{
+				const auto& [isDoubleSided, permutationKey] = groupKey;
+
+				IndirectDrawGroup& group = (isDoubleSided ? m_DoubleSidedIndirectDrawGroups : m_IndirectDrawGroups).emplace_back();
+				group.PermutationKey = permutationKey;
+				group.GroupIndex = static_cast<uint32_t>(m_GPUDrawGroups.size());
+				group.FirstCommand = firstCommand;
+				group.DrawCount = static_cast<uint32_t>(draws.size());
+				m_GPUDrawGroups.push_back({ .FirstCommand = group.FirstCommand, .DrawCount = group.DrawCount });
+				firstCommand += group.DrawCount;
+
+				for (const GPUSceneDraw* draw : draws)
+				{
+					GPUDrawData& drawData = m_GPUDraws[draw->Index];
+					drawData.FirstInstance = firstInstance;
+					drawData.Group = group.GroupIndex;
+					firstInstance += draw->InstanceCount;
+				}
+			}
+
+			for (GPUSceneUploads& uploads : m_GPUSceneUploads)
+				uploads.Draws = true;
+		}
+
+		m_GPUInstanceCount = static_cast<uint32_t>(m_GPUInstances.size());
+		m_GPUDrawCount = m_GPUSceneDraws.empty() ? 0 : static_cast<uint32_t>(m_GPUDraws.size());
+		m_GPUDrawGroupCount = static_cast<uint32_t>(m_GPUDrawGroups.size());
+
+		// Resized buffers come back empty
+		if (m_GPUInstanceCount > m_GPUInstanceCapacity)
+		{
+			m_GPUInstanceCapacity = std::bit_ceil(m_GPUInstanceCount);
+			Utils::ResizeStorageBufferSet(m_SBSInstanceInput, sizeof(GPUInstanceData) * m_GPUInstanceCapacity);
+			Utils::ResizeStorageBufferSet(m_SBSCulledInstances, sizeof(TransformVertexData) * m_GPUInstanceCapacity);
+
+			for (GPUSceneUploads& uploads : m_GPUSceneUploads)
+				uploads.AllInstances = true;
+		}
+
+		if (m_GPUDrawCount > m_GPUDrawCapacity)
+		{
+			m_GPUDrawCapacity = std::bit_ceil(m_GPUDrawCount);
+			Utils::ResizeStorageBufferSet(m_SBSDrawInput, sizeof(GPUDrawData) * m_GPUDrawCapacity);
+			Utils::ResizeStorageBufferSet(m_SBSDrawCounters, sizeof(uint32_t) * m_GPUDrawCapacity);
+			Utils::ResizeStorageBufferSet(m_SBSDrawCommands, sizeof(VkDrawIndexedIndirectCommand) * m_GPUDrawCapacity);
+
+			for (GPUSceneUploads& uploads : m_GPUSceneUploads)
+				uploads.Draws = true;
+		}
+
+		if (m_GPUDrawGroupCount > m_GPUDrawGroupCapacity)
+		{
+			m_GPUDrawGroupCapacity = std::bit_ceil(m_GPUDrawGroupCount);
+			Utils::ResizeStorageBufferSet(m_SBSDrawGroups, sizeof(GPUDrawGroupData) * m_GPUDrawGroupCapacity);
+			Utils::ResizeStorageBufferSet(m_SBSGroupCounts, sizeof(uint32_t) * m_GPUDrawGroupCapacity);
+
+			for (GPUSceneUploads& uploads : m_GPUSceneUploads)
+				uploads.Draws = true;
+		}
+
+		// Each frame in flight has its own copy of the input buffers, so this one gets what changed since it was last used
+		const uint32_t frameIndex = Renderer::GetCurrentFrameIndex();
+		const uint32_t frameBit = 1u << frameIndex;
+		GPUSceneUploads& uploads = m_GPUSceneUploads[frameIndex];
+
+		std::vector<GPUInstanceData> instanceData;
+		std::vector<std::pair<uint32_t, uint32_t>> instanceRuns; // First slot and slot count of every copy
+		if (uploads.AllInstances)
+		{
+			if (m_GPUInstanceCount)
+			{
+				instanceData = m_GPUInstances;
+				instanceRuns.emplace_back(0, m_GPUInstanceCount);
+			}
+
+			for (uint32_t& dirtyFrames : m_GPUInstanceDirtyFrames)
+				dirtyFrames &= ~frameBit;
+		}
+		else
+		{
+			// Slots next to each other go out in one copy
+			std::sort(uploads.DirtyInstances.begin(), uploads.DirtyInstances.end());
+			instanceData.reserve(uploads.DirtyInstances.size());
+			for (uint32_t slot : uploads.DirtyInstances)
+			{
+				if (!instanceRuns.empty() && instanceRuns.back().first + instanceRuns.back().second == slot)
+					instanceRuns.back().second++;
+				else
+					instanceRuns.emplace_back(slot, 1);
+
+				instanceData.push_back(m_GPUInstances[slot]);
+				m_GPUInstanceDirtyFrames[slot] &= ~frameBit;
+			}
+		}
+
+		uploads.DirtyInstances.clear();
+		uploads.AllInstances = false;
+
+		std::vector<GPUDrawData> draws;
+		std::vector<GPUDrawGroupData> groups;
+		if (uploads.Draws)
+		{
+			draws = m_GPUDraws;
+			groups = m_GPUDrawGroups;
+			uploads.Draws = false;
+		}
+
+		if (instanceRuns.empty() && draws.empty() && groups.empty())
+			return;
+
+		Renderer::Submit([instanceInput = m_SBSInstanceInput->Get(frameIndex), drawInput = m_SBSDrawInput->Get(frameIndex), drawGroups = m_SBSDrawGroups->Get(frameIndex),
+			instanceData = std::move(instanceData), instanceRuns = std::move(instanceRuns), draws = std::move(draws), groups = std::move(groups)]()
+		{
+			const GPUInstanceData* data = instanceData.data();
+			for (const auto& [firstSlot, slotCount] : instanceRuns)
+			{
+				instanceInput->RT_SetData(data, slotCount * sizeof(GPUInstanceData), firstSlot * sizeof(GPUInstanceData));
+				data += slotCount;
+			}
+
+			if (!draws.empty())
+				drawInput->RT_SetData(draws.data(), draws.size() * sizeof(GPUDrawData));
+
+			if (!groups.empty())
+				drawGroups->RT_SetData(groups.data(), groups.size() * sizeof(GPUDrawGroupData));
+		});
+	}
+
+	void SceneRenderer::GPUCullingPass()
+	{
+		if (m_GPUDrawCount == 0)
+			return;
+
+		UBCulling cullingData = {
+			.ViewProjection = m_CameraDataUB.ViewProjectionMatrix,
+			.PreviousViewProjection = m_PreviousViewProjection,
+			.HiZSize = { m_ViewportWidth, m_ViewportHeight },
+			.HiZMipCount = m_HiZTexture ? m_HiZTexture->GetMipLevelCount() : 1,
+			.InstanceCount = m_GPUInstanceCount,
+			.DrawCount = m_GPUDrawCount,
+			.HiZValid = m_HiZValid ? 1u : 0u
+		};
+		Utils::ExtractFrustumPlanes(cullingData.ViewProjection, cullingData.FrustumPlanes);
+
+		Renderer::Submit([cmdBuffer = m_CommandBuffer, cullingUB = m_UBSCulling, drawCounters = m_SBSDrawCounters, groupCounts = m_SBSGroupCounts, cullingData, groupCount = m_GPUDrawGroupCount]()
+		{
+			cullingUB->RT_Get()->RT_SetData(&cullingData, sizeof(UBCulling));
+
+			VkCommandBuffer commandBuffer = cmdBuffer->GetActiveCommandBuffer();
+			vkCmdFillBuffer(commandBuffer, drawCounters->RT_Get()->GetVulkanBuffer(), 0, cullingData.DrawCount * sizeof(uint32_t), 0);
+			vkCmdFillBuffer(commandBuffer, groupCounts->RT_Get()->GetVulkanBuffer(), 0, groupCount * sizeof(uint32_t), 0);
+
+			// Also makes the depth pyramid that the last frame built visible to the culling
+			Renderer::InsertMemoryBarrier(
+				commandBuffer,
+				VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+			);
+		});
+
+		// One invocation per instance, visible instances are appended to the range of their draw
+		Renderer::BeginComputePass(m_CommandBuffer, m_GPUCullingPass);
+		Renderer::DispatchComputePass(m_CommandBuffer, m_GPUCullingPass, nullptr, { (m_GPUInstanceCount + 63) / 64, 1, 1 });
+		Renderer::EndComputePass(m_CommandBuffer, m_GPUCullingPass);
+
+		Renderer::Submit([cmdBuffer = m_CommandBuffer]()
+		{
+			Renderer::InsertMemoryBarrier(
+				cmdBuffer->GetActiveCommandBuffer(),
+				VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+			);
+		});
+
+		// One invocation per draw, writes the indirect commands and the draw count of every group
+		Renderer::BeginComputePass(m_CommandBuffer, m_DrawCompactionPass);
+		Renderer::DispatchComputePass(m_CommandBuffer, m_DrawCompactionPass, nullptr, { (m_GPUDrawCount + 63) / 64, 1, 1 });
+		Renderer::EndComputePass(m_CommandBuffer, m_DrawCompactionPass);
+
+		Renderer::Submit([cmdBuffer = m_CommandBuffer]()
+		{
+			Renderer::InsertMemoryBarrier(
+				cmdBuffer->GetActiveCommandBuffer(),
+				VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+				VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT
+			);
+		});
+	}
+
+	void SceneRenderer::RenderIndirectDrawGroups(Ref<Pipeline> pipeline, const std::vector<IndirectDrawGroup>& groups, uint32_t permutationMask)
+	{
+		uint32_t frameIndex = Renderer::GetCurrentFrameIndex();
+
+		for (const IndirectDrawGroup& group : groups)
+		{
+			Renderer::RenderStaticMeshIndirect(m_CommandBuffer, pipeline, group.PermutationKey & permutationMask, m_SBSDrawCommands->Get(frameIndex), group.FirstCommand,
+				m_SBSGroupCounts->Get(frameIndex), group.GroupIndex, group.DrawCount);
+		}
 	}
 
 	void SceneRenderer::PreDepthPass()
@@ -982,11 +1590,21 @@ namespace Iris {
 
 			Renderer::BeginRenderPass(m_CommandBuffer, renderPassToUse);
 
-			for (const auto& [mk, dc] : m_StaticMeshDrawList)
+			if (m_Specification.GPUDrivenRendering)
 			{
-				const auto& transformData = m_MeshTransformMap.at(mk);
-				glm::mat4 transform = dc.MeshSource->GetSubMeshes()[dc.SubMeshIndex].Transform;
-				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, renderPassToUse->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_PreDepthMaterial, m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset, dc.InstanceCount);
+				Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_SBSCulledInstances->Get(frameIndex));
+				RenderIndirectDrawGroups(renderPassToUse->GetPipeline(), m_IndirectDrawGroups);
+			}
+			else
+			{
+				Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
+
+				for (const auto& [mk, dc] : m_StaticMeshDrawList)
+				{
+					const auto& transformData = m_MeshTransformMap.at(mk);
+					glm::mat4 transform = dc.MeshSource->GetSubMeshes()[dc.SubMeshIndex].Transform;
+					Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, renderPassToUse->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_PreDepthMaterial, transformData.FirstInstance, dc.InstanceCount);
+				}
 			}
 
 			Renderer::EndRenderPass(m_CommandBuffer);
@@ -1001,11 +1619,21 @@ namespace Iris {
 			{
 				Renderer::BeginRenderPass(m_CommandBuffer, renderPassToUse);
 			
-				for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
+				if (m_Specification.GPUDrivenRendering)
 				{
-					const auto& transformData = m_MeshTransformMap.at(mk);
-					glm::mat4 transform = dc.MeshSource->GetSubMeshes()[dc.SubMeshIndex].Transform;
-					Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, renderPassToUse->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_PreDepthMaterial, m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset, dc.InstanceCount);
+					Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_SBSCulledInstances->Get(frameIndex));
+					RenderIndirectDrawGroups(renderPassToUse->GetPipeline(), m_DoubleSidedIndirectDrawGroups);
+				}
+				else
+				{
+					Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
+
+					for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
+					{
+						const auto& transformData = m_MeshTransformMap.at(mk);
+						glm::mat4 transform = dc.MeshSource->GetSubMeshes()[dc.SubMeshIndex].Transform;
+						Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, renderPassToUse->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_PreDepthMaterial, transformData.FirstInstance, dc.InstanceCount);
+					}
 				}
 			
 				Renderer::EndRenderPass(m_CommandBuffer);
@@ -1015,18 +1643,29 @@ namespace Iris {
 		{
 			Renderer::BeginRenderPass(m_CommandBuffer, m_WireframeViewPreDepthPass);
 			
-			for (const auto& [mk, dc] : m_StaticMeshDrawList)
+			if (m_Specification.GPUDrivenRendering)
 			{
-				const auto& transformData = m_MeshTransformMap.at(mk);
-				glm::mat4 transform = dc.MeshSource->GetSubMeshes()[dc.SubMeshIndex].Transform;
-				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_WireframeViewPreDepthPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_PreDepthMaterial, m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset, dc.InstanceCount);
+				Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_SBSCulledInstances->Get(frameIndex));
+				RenderIndirectDrawGroups(m_WireframeViewPreDepthPass->GetPipeline(), m_IndirectDrawGroups);
+				RenderIndirectDrawGroups(m_WireframeViewPreDepthPass->GetPipeline(), m_DoubleSidedIndirectDrawGroups);
 			}
-			
-			for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
+			else
 			{
-				const auto& transformData = m_MeshTransformMap.at(mk);
-				glm::mat4 transform = dc.MeshSource->GetSubMeshes()[dc.SubMeshIndex].Transform;
-				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_WireframeViewPreDepthPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_PreDepthMaterial, m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset, dc.InstanceCount);
+				Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
+
+				for (const auto& [mk, dc] : m_StaticMeshDrawList)
+				{
+					const auto& transformData = m_MeshTransformMap.at(mk);
+					glm::mat4 transform = dc.MeshSource->GetSubMeshes()[dc.SubMeshIndex].Transform;
+					Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_WireframeViewPreDepthPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_PreDepthMaterial, transformData.FirstInstance, dc.InstanceCount);
+				}
+			
+				for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
+				{
+					const auto& transformData = m_MeshTransformMap.at(mk);
+					glm::mat4 transform = dc.MeshSource->GetSubMeshes()[dc.SubMeshIndex].Transform;
+					Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_WireframeViewPreDepthPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_PreDepthMaterial, transformData.FirstInstance, dc.InstanceCount);
+				}
 			}
 			
 			Renderer::EndRenderPass(m_CommandBuffer);
@@ -1035,11 +1674,11 @@ namespace Iris {
 
 	void SceneRenderer::SkyboxPass()
 	{
-		m_SkyboxMaterial->Set("u_Uniforms.TextureLod", m_SceneInfo.SkyboxLod);
-		m_SkyboxMaterial->Set("u_Uniforms.Intensity", m_SceneInfo.SceneEnvironmentIntensity);
+		m_SkyboxMaterial->Set(s_SkyboxTextureLodParam, m_SceneInfo.SkyboxLod);
+		m_SkyboxMaterial->Set(s_SkyboxIntensityParam, m_SceneInfo.SceneEnvironmentIntensity);
 		
 		const Ref<TextureCube> radianceMap = m_SceneInfo.SceneEnvironment ? m_SceneInfo.SceneEnvironment->RadianceMap : Renderer::GetBlackCubeTexture();
-		m_SkyboxMaterial->Set("u_Texture", radianceMap);
+		m_SkyboxMaterial->Set(s_SkyboxTextureParam, radianceMap);
 		
 		Renderer::BeginRenderPass(m_CommandBuffer, m_SkyboxPass);
 		Renderer::SubmitFullScreenQuad(m_CommandBuffer, m_SkyboxPass->GetPipeline(), m_SkyboxMaterial);
@@ -1054,26 +1693,32 @@ namespace Iris {
 		if (m_Specification.JumpFloodPass)
 		{
 			Renderer::BeginRenderPass(m_CommandBuffer, m_SelectedGeometryPass);
+			Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
 		
 			for (auto& [mk, dc] : m_SelectedStaticMeshDrawList)
 			{
 				const auto& transformData = m_MeshTransformMap.at(mk);
-				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_SelectedGeometryPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_SelectedGeometryMaterial, m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset + dc.InstanceOffset * sizeof(TransformVertexData), dc.InstanceCount);
+				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_SelectedGeometryPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_SelectedGeometryMaterial, transformData.FirstInstance + dc.InstanceOffset, dc.InstanceCount);
 			}
 		
 			Renderer::EndRenderPass(m_CommandBuffer);
 		
 			Renderer::BeginRenderPass(m_CommandBuffer, m_DoubleSidedSelectedGeometryPass);
+			Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
 		
 			for (auto& [mk, dc] : m_DoubleSidedSelectedStaticMeshDrawList)
 			{
 				const auto& transformData = m_MeshTransformMap.at(mk);
-				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_DoubleSidedSelectedGeometryPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_SelectedGeometryMaterial, m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset + dc.InstanceOffset * sizeof(TransformVertexData), dc.InstanceCount);
+				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_DoubleSidedSelectedGeometryPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_SelectedGeometryMaterial, transformData.FirstInstance + dc.InstanceOffset, dc.InstanceCount);
 			}
 		
 			Renderer::EndRenderPass(m_CommandBuffer);
 		}
 
+		// The unlit and wireframe views draw every material with its lit permutation off
+		const int32_t litPermutation = m_GeometryPass->GetPipeline()->GetShader()->GetPermutationIndex("IR_LIT");
+		const uint32_t permutationMask = m_ViewMode != ViewMode::Lit && litPermutation >= 0 ? ~(1u << litPermutation) : ~0u;
+
 		// Lit and Unlit
 		if (m_ViewMode == ViewMode::Lit || m_ViewMode == ViewMode::Unlit)
 		{
@@ -1086,10 +1731,20 @@ namespace Iris {
 
 			Renderer::BeginRenderPass(m_CommandBuffer, renderPassToUse);
 
-			for (const auto& [mk, dc] : m_StaticMeshDrawList)
+			if (m_Specification.GPUDrivenRendering)
 			{
-				const auto& transformData = m_MeshTransformMap.at(mk);
-				Renderer::RenderStaticMesh(m_CommandBuffer, renderPassToUse->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, dc.MaterialTable ? dc.MaterialTable : dc.StaticMesh->GetMaterials(), m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset, dc.InstanceCount, static_cast<int>(m_ViewMode));
+				Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_SBSCulledInstances->Get(frameIndex));
+				RenderIndirectDrawGroups(renderPassToUse->GetPipeline(), m_IndirectDrawGroups, permutationMask);
+			}
+			else
+			{
+				Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
+
+				for (const auto& [mk, dc] : m_StaticMeshDrawList)
+				{
+					const auto& transformData = m_MeshTransformMap.at(mk);
+					Renderer::RenderStaticMesh(m_CommandBuffer, renderPassToUse->GetPipeline(), dc.MeshSource, dc.SubMeshIndex, mk.PermutationKey & permutationMask, transformData.FirstInstance, dc.InstanceCount);
+				}
 			}
 
 			Renderer::EndRenderPass(m_CommandBuffer);
@@ -1104,10 +1759,20 @@ namespace Iris {
 			{
 				Renderer::BeginRenderPass(m_CommandBuffer, renderPassToUse);
 			
-				for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
+				if (m_Specification.GPUDrivenRendering)
 				{
-					const auto& transformData = m_MeshTransformMap.at(mk);
-					Renderer::RenderStaticMesh(m_CommandBuffer, renderPassToUse->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, dc.MaterialTable ? dc.MaterialTable : dc.StaticMesh->GetMaterials(), m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset, dc.InstanceCount, static_cast<int>(m_ViewMode));
+					Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_SBSCulledInstances->Get(frameIndex));
+					RenderIndirectDrawGroups(renderPassToUse->GetPipeline(), m_DoubleSidedIndirectDrawGroups, permutationMask);
+				}
+				else
+				{
+					Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
+
+					for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
+					{
+						const auto& transformData = m_MeshTransformMap.at(mk);
+						Renderer::RenderStaticMesh(m_CommandBuffer, renderPassToUse->GetPipeline(), dc.MeshSource, dc.SubMeshIndex, mk.PermutationKey & permutationMask, transformData.FirstInstance, dc.InstanceCount);
+					}
 				}
 			
 				Renderer::EndRenderPass(m_CommandBuffer);
@@ -1118,22 +1783,154 @@ namespace Iris {
 		{
 			Renderer::BeginRenderPass(m_CommandBuffer, m_WireframeViewGeometryPass);
 			
-			for (const auto& [mk, dc] : m_StaticMeshDrawList)
+			if (m_Specification.GPUDrivenRendering)
 			{
-				const auto& transformData = m_MeshTransformMap.at(mk);
-				Renderer::RenderStaticMesh(m_CommandBuffer, m_WireframeViewGeometryPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, dc.MaterialTable ? dc.MaterialTable : dc.StaticMesh->GetMaterials(), m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset, dc.InstanceCount, static_cast<int>(m_ViewMode));
+				Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_SBSCulledInstances->Get(frameIndex));
+				RenderIndirectDrawGroups(m_WireframeViewGeometryPass->GetPipeline(), m_IndirectDrawGroups, permutationMask);
+				RenderIndirectDrawGroups(m_WireframeViewGeometryPass->GetPipeline(), m_DoubleSidedIndirectDrawGroups, permutationMask);
 			}
-			
-			for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
+			else
 			{
-				const auto& transformData = m_MeshTransformMap.at(mk);
-				Renderer::RenderStaticMesh(m_CommandBuffer, m_WireframeViewGeometryPass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, dc.MaterialTable ? dc.MaterialTable : dc.StaticMesh->GetMaterials(), m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset, dc.InstanceCount, static_cast<int>(m_ViewMode));
+				Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
+
+				for (const auto& [mk, dc] : m_StaticMeshDrawList)
+				{
+					const auto& transformData = m_MeshTransformMap.at(mk);
+					Renderer::RenderStaticMesh(m_CommandBuffer, m_WireframeViewGeometryPass->GetPipeline(), dc.MeshSource, dc.SubMeshIndex, mk.PermutationKey & permutationMask, transformData.FirstInstance, dc.InstanceCount);
+				}
+			
+				for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
+				{
+					const auto& transformData = m_MeshTransformMap.at(mk);
+					Renderer::RenderStaticMesh(m_CommandBuffer, m_WireframeViewGeometryPass->GetPipeline(), dc.MeshSource, dc.SubMeshIndex, mk.PermutationKey & permutationMask, transformData.FirstInstance, dc.InstanceCount);
+				}
 			}
 			
 			Renderer::EndRenderPass(m_CommandBuffer);
 		}
 	}
 
+	void SceneRenderer::HiZPass()
+	{
+		Renderer::Submit([cmdBuffer = m_CommandBuffer, preDepthPass = m_PreDepthPass]()
+		{
+			VkCommandBuffer commandBuffer = cmdBuffer->GetActiveCommandBuffer();
+
+			Renderer::InsertImageMemoryBarrier(
+				commandBuffer,
+				preDepthPass->GetDepthOutput()->GetVulkanImage(),
+				VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_ACCESS_2_SHADER_READ_BIT,
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+				VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+				{ .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
+			);
+
+			// The culling at the start of the frame is still reading the pyramid of the last frame
+			Renderer::InsertMemoryBarrier(commandBuffer, VK_ACCESS_2_SHADER_READ_BIT, VK_ACCESS_2_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+		});
+
+		Renderer::BeginComputePass(m_CommandBuffer, m_HiZPass);
+
+		const uint32_t mipCount = m_HiZTexture->GetMipLevelCount();
+		for (uint32_t mip = 0; mip < mipCount; mip++)
+		{
+			// Mip 0 is read from the depth buffer and every other mip from the one above it
+			Ref<SceneRenderer> instance = this;
+			Renderer::Submit([instance, mip]() mutable
+			{
+				Ref<ComputePipeline> pipeline = instance->m_HiZPass->GetPipeline();
+				Ref<Shader> shader = pipeline->GetShader();
+
+				std::vector<VkDescriptorSetLayout> descriptorSetLayouts = shader->GetAllDescriptorSetLayouts();
+				VkDescriptorSetAllocateInfo allocInfo = {
+					.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+					.descriptorSetCount = 1,
+					.pSetLayouts = &descriptorSetLayouts[3]
+				};
+				VkDescriptorSet descriptorSet = Renderer::RT_AllocateDescriptorSet(allocInfo);
+
+				const Ref<ImageView>& inputView = mip == 0 ? instance->m_HiZDepthView : instance->m_HiZMipViews[mip - 1];
+
+				std::array<VkWriteDescriptorSet, 2> writeDescriptors;
+				writeDescriptors[0] = *shader->GetDescriptorSet("o_HiZ", 3);
+				writeDescriptors[0].dstSet = descriptorSet;
+				writeDescriptors[0].pImageInfo = &instance->m_HiZMipViews[mip]->GetDescriptorImageInfo();
+
+				writeDescriptors[1] = *shader->GetDescriptorSet("u_InputDepth", 3);
+				writeDescriptors[1].dstSet = descriptorSet;
+				writeDescriptors[1].pImageInfo = &inputView->GetDescriptorImageInfo();
+
+				vkUpdateDescriptorSets(RendererContext::GetCurrentDevice()->GetVulkanDevice(), static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0, nullptr);
+
+				VkCommandBuffer commandBuffer = instance->m_CommandBuffer->GetActiveCommandBuffer();
+				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetPipelineLayout(), 3, 1, &descriptorSet, 0, nullptr);
+			});
+
+			const uint32_t mipWidth = glm::max(m_ViewportWidth >> mip, 1u);
+			const uint32_t mipHeight = glm::max(m_ViewportHeight >> mip, 1u);
+			Renderer::DispatchComputePass(m_CommandBuffer, m_HiZPass, nullptr, { (mipWidth + 7) / 8, (mipHeight + 7) / 8, 1 });
+
+			Renderer::Submit([cmdBuffer = m_CommandBuffer]()
+			{
+				Renderer::InsertMemoryBarrier(cmdBuffer->GetActiveCommandBuffer(), VK_ACCESS_2_SHADER_WRITE_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+			});
+		}
+
+		Renderer::EndComputePass(m_CommandBuffer, m_HiZPass);
+
+		// The grid and the 2D renderer keep depth testing against it
+		Renderer::Submit([cmdBuffer = m_CommandBuffer, preDepthPass = m_PreDepthPass]()
+		{
+			Renderer::InsertImageMemoryBarrier(
+				cmdBuffer->GetActiveCommandBuffer(),
+				preDepthPass->GetDepthOutput()->GetVulkanImage(),
+				VK_ACCESS_2_SHADER_READ_BIT,
+				VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+				VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+				{ .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
+			);
+		});
+
+		m_HiZValid = true;
+	}
+
+	void SceneRenderer::CreateHiZResources()
+	{
+		TextureSpecification hiZSpec = {
+			.DebugName = "HiZ",
+			.Width = m_ViewportWidth,
+			.Height = m_ViewportHeight,
+			.Format = ImageFormat::R32F,
+			.Usage = ImageUsage::Storage,
+			.WrapMode = TextureWrap::Clamp,
+			.FilterMode = TextureFilter::Nearest,
+			.GenerateMips = true
+		};
+		m_HiZTexture = Texture2D::Create(hiZSpec);
+		m_GPUCullingPass->SetInput("u_HiZTexture", m_HiZTexture);
+
+		// Until a pyramid has been built at the new size
+		m_HiZValid = false;
+
+		// Single mip views are created on the render thread after the texture and the resized depth buffer
+		Ref<SceneRenderer> instance = this;
+		Renderer::Submit([instance, hiZTexture = m_HiZTexture]() mutable
+		{
+			instance->m_HiZMipViews.resize(hiZTexture->GetMipLevelCount());
+			for (uint32_t mip = 0; mip < hiZTexture->GetMipLevelCount(); mip++)
+				instance->m_HiZMipViews[mip] = hiZTexture->CreateImageViewSingleMip(mip);
+
+			// Sampled through its depth aspect
+			instance->m_HiZDepthView = instance->m_PreDepthPass->GetDepthOutput()->CreateImageViewSingleMip(0);
+		});
+	}
+
 	void SceneRenderer::JumpFloodPass()
 	{
 		// Init pass
@@ -1249,9 +2046,9 @@ namespace Iris {
 
 		float exposure = m_SceneInfo.Camera.Camera.GetExposure();
 
-		m_CompositeMaterial->Set("u_Uniforms.Exposure", exposure);
-		m_CompositeMaterial->Set("u_Uniforms.Opacity", m_Opacity);
-		m_CompositeMaterial->Set("u_Uniforms.Time", Application::Get().GetTime());
+		m_CompositeMaterial->Set(s_CompositeExposureParam, exposure);
+		m_CompositeMaterial->Set(s_CompositeOpacityParam, m_Opacity);
+		m_CompositeMaterial->Set(s_CompositeTimeParam, Application::Get().GetTime());
 
 		Renderer::BeginRenderPass(m_CommandBuffer, m_CompositePass);
 		Renderer::SubmitFullScreenQuad(m_CommandBuffer, m_CompositePass->GetPipeline(), m_CompositeMaterial);
@@ -1259,7 +2056,7 @@ namespace Iris {
 
 		if (m_Options.ShowGrid)
 		{
-			m_GridMaterial->Set("u_Uniforms.Scale", m_TranslationSnapValue);
+			m_GridMaterial->Set(s_GridScaleParam, m_TranslationSnapValue);
 			Renderer::BeginRenderPass(m_CommandBuffer, m_GridPass);
 			Renderer::SubmitFullScreenQuad(m_CommandBuffer, m_GridPass->GetPipeline(), m_GridMaterial);
 			Renderer::EndRenderPass(m_CommandBuffer);
@@ -1292,17 +2089,18 @@ namespace Iris {
 		if (m_Options.ShowSelectedInWireFrame)
 		{
 			Renderer::BeginRenderPass(m_CommandBuffer, m_GeometryWireFramePass);
+			Renderer::BindStaticMeshGeometry(m_CommandBuffer, m_MeshTransformBuffers[frameIndex].VertexBuffer);
 		
 			for (const auto& [mk, dc] : m_SelectedStaticMeshDrawList)
 			{
 				const auto& transformData = m_MeshTransformMap.at(mk);
-				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_GeometryWireFramePass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_WireFrameMaterial, m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset + dc.InstanceOffset * sizeof(TransformVertexData), dc.InstanceCount);
+				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_GeometryWireFramePass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_WireFrameMaterial, transformData.FirstInstance + dc.InstanceOffset, dc.InstanceCount);
 			}
 		
 			for (const auto& [mk, dc] : m_DoubleSidedSelectedStaticMeshDrawList)
 			{
 				const auto& transformData = m_MeshTransformMap.at(mk);
-				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_GeometryWireFramePass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_WireFrameMaterial, m_MeshTransformBuffers[frameIndex].VertexBuffer, transformData.TransformOffset + dc.InstanceOffset * sizeof(TransformVertexData), dc.InstanceCount);
+				Renderer::RenderStaticMeshWithMaterial(m_CommandBuffer, m_GeometryWireFramePass->GetPipeline(), dc.StaticMesh, dc.MeshSource, dc.SubMeshIndex, m_WireFrameMaterial, transformData.FirstInstance + dc.InstanceOffset, dc.InstanceCount);
 			}
 		
 			Renderer::EndRenderPass(m_CommandBuffer);
@@ -1370,22 +2168,87 @@ namespace Iris {
 			m_Statistics.Meshes += 1;
 		}
 
+		// With GPU driven rendering every group is one indirect draw, no matter how many of its draws survive the culling
+		const bool gpuDriven = m_Specification.GPUDrivenRendering;
 		for (const auto& [mk, dc] : m_StaticMeshDrawList)
 		{
 			m_Statistics.Instances += dc.InstanceCount;
-			m_Statistics.ColorPassDrawCalls += 1;
+			m_Statistics.ColorPassDrawCalls += gpuDriven ? 0 : 1;
 			m_Statistics.Meshes += 1;
 		}
 
 		for (const auto& [mk, dc] : m_DoubleSidedStaticMeshDrawList)
 		{
 			m_Statistics.Instances += dc.InstanceCount;
-			m_Statistics.ColorPassDrawCalls += 1;
+			m_Statistics.ColorPassDrawCalls += gpuDriven ? 0 : 1;
 			m_Statistics.Meshes += 1;
 		}
 
+		if (gpuDriven)
+			m_Statistics.ColorPassDrawCalls += static_cast<uint32_t>(m_IndirectDrawGroups.size() + m_DoubleSidedIndirectDrawGroups.size());
+
 		m_Statistics.TotalDrawCalls = Renderer::GetTotalDrawCallCount();
+		m_Statistics.SkippedBinds = Renderer::GetSkippedBindStatistics();
 		m_Statistics.ColorPassSavedDraws = m_Statistics.Instances - m_Statistics.ColorPassDrawCalls;
+
+		// Renderer::BeginRenderPass times every pass under its debug name
+		auto passTime = [this](std::initializer_list<Ref<RenderPass>> passes)
+		{
+			float time = 0.0f;
+			for (const Ref<RenderPass>& pass : passes)
+			{
+				if (pass)
+					time += m_CommandBuffer->GetTimestampQueryTime(pass->GetSpecification().DebugName);
+			}
+
+			return time;
+		};
+
+		m_Statistics.GPUTime.PreDepth = passTime({ m_PreDepthPass, m_DoubleSidedPreDepthPass, m_WireframeViewPreDepthPass });
+		m_Statistics.GPUTime.Geometry = passTime({ m_SelectedGeometryPass, m_DoubleSidedSelectedGeometryPass, m_SkyboxPass, m_GeometryPass, m_DoubleSidedGeometryPass, m_WireframeViewGeometryPass });
+		m_Statistics.GPUTime.JumpFlood = passTime({ m_JumpFloodInitPass, m_JumpFloodPass[0], m_JumpFloodPass[1], m_JumpFloodCompositePass });
+		m_Statistics.GPUTime.Composite = passTime({ m_CompositePass, m_GridPass, m_GeometryWireFramePass });
+		m_Statistics.GPUTime.Renderer2D = m_Renderer2D->GetRenderCommandBuffer()->GetExecutionGPUTime();
+	}
+
+	void SceneRenderer::AccumulateTextureStreamingSize(const Ref<MaterialAsset>& materialAsset, const AABB& boundingBox, const glm::mat4& transform)
+	{
+		// BeginScene did not get to set up the camera
+		if (m_TextureStreamingProjectionScale <= 0.0f)
+			return;
+
+		// Bounding sphere of the submesh in world space, the material's textures are assumed to cover it once
+		const glm::vec3 center = transform * glm::vec4((boundingBox.Min + boundingBox.Max) * 0.5f, 1.0f);
+		const float maxScale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+		const float radius = glm::length(boundingBox.Max - boundingBox.Min) * 0.5f * maxScale;
+
+		float screenSize = 2.0f * radius * m_TextureStreamingProjectionScale;
+		if (m_TextureStreamingPerspective)
+		{
+			const glm::vec3 cameraPosition = m_CameraDataUB.InverseViewMatrix[3];
+			screenSize /= glm::max(glm::distance(center, cameraPosition) - radius, m_SceneInfo.Camera.Near);
+		}
+
+		TextureStreamingRequest& request = m_TextureStreamingRequests[materialAsset->Handle];
+		if (!request.Material)
+			request.Material = materialAsset;
+
+		request.ScreenSize = glm::max(request.ScreenSize, screenSize);
+	}
+
+	void SceneRenderer::RequestStreamedTextureMips()
+	{
+		for (auto& [handle, request] : m_TextureStreamingRequests)
+		{
+			const Ref<MaterialAsset>& materialAsset = request.Material;
+			for (const Ref<Texture2D>& texture : { materialAsset->GetAlbedoMap(), materialAsset->GetNormalMap(), materialAsset->GetRoughnessMap(), materialAsset->GetMetalnessMap() })
+			{
+				if (texture && texture->IsStreaming())
+					TextureStreamer::RequestMip(texture, TextureStreamer::CalculateRequiredMip(texture, request.ScreenSize));
+			}
+		}
+
+		m_TextureStreamingRequests.clear();
 	}
 
 }
\ No newline at end of file
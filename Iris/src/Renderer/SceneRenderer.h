@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Renderer/ComputePass.h"
 #include "Renderer/Mesh/Mesh.h"
+#include "Renderer/Renderer.h"
 #include "Renderer/Renderer2D.h"
 #include "Renderer/RenderPass.h"
 #include "Scene/Scene.h"
@@ -36,6 +38,9 @@ namespace Iris {
 	{
 		float RendererScale = 1.0f;
 		bool JumpFloodPass = true;
+		// Culls the static meshes on the GPU (frustum and the depth of the previous frame) and draws them with indirect count draws. Falls back
+		// to CPU draws if the device does not support indirect count draws
+		bool GPUDrivenRendering = false;
 
 		// Means application window size
 		uint32_t ViewportWidth = 0;
@@ -53,6 +58,18 @@ namespace Iris {
 			uint32_t Meshes = 0;
 			uint32_t Instances = 0;
 			uint32_t ColorPassSavedDraws = 0;
+
+			SkippedBindStatistics SkippedBinds;
+
+			// GPU milliseconds of each stage, read back from timestamps so they lag a few frames behind
+			struct
+			{
+				float PreDepth = 0.0f;
+				float Geometry = 0.0f;
+				float JumpFlood = 0.0f;
+				float Composite = 0.0f;
+				float Renderer2D = 0.0f;
+			} GPUTime;
 		};
 
 		enum class ViewMode
@@ -76,8 +93,9 @@ namespace Iris {
 		void BeginScene(const SceneRendererCamera& camera);
 		void EndScene();
 
-		void SubmitStaticMesh(Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, Ref<MaterialTable> materialTable, const glm::mat4& transform = glm::mat4(1.0f), Ref<Material> overrideMaterial = nullptr);
-		void SubmitSelectedStaticMesh(Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, Ref<MaterialTable> materialTable, const glm::mat4& transform = glm::mat4(1.0f), Ref<Material> overrideMaterial = nullptr);
+		// GPU driven rendering keeps the submeshes of an entity in the same instance slots from one frame to the next by its ID
+		void SubmitStaticMesh(UUID entityID, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, Ref<MaterialTable> materialTable, const glm::mat4& transform = glm::mat4(1.0f), Ref<Material> overrideMaterial = nullptr);
+		void SubmitSelectedStaticMesh(UUID entityID, Ref<StaticMesh> staticMesh, Ref<MeshSource> meshSource, Ref<MaterialTable> materialTable, const glm::mat4& transform = glm::mat4(1.0f), Ref<Material> overrideMaterial = nullptr);
 
 		Ref<Texture2D> GetFinalPassImage();
 
@@ -87,6 +105,9 @@ namespace Iris {
 
 		void SetViewMode(ViewMode mode) { m_ViewMode = mode; }
 
+		// Creates or releases the culling passes and their buffers, stays off if the device does not support indirect count draws
+		void SetGPUDrivenRendering(bool enabled);
+
 		void SetLineWidth(float lineWidth);
 		float GetLineWidth() const { return m_LineWidth; }
 
@@ -108,15 +129,17 @@ namespace Iris {
 		const PipelineStatistics& GetPipelineStatistics() const;
 
 	private:
+		// Instances of a submesh only need separate draws when they need a different pipeline, their materials are read from the bindless table
 		struct MeshKey
 		{
 			AssetHandle MeshHandle;
-			AssetHandle MaterialHandle;
 			uint32_t SubMeshIndex;
+			uint32_t PermutationKey;
+			bool IsDoubleSided;
 			bool IsSelected;
 
-			MeshKey(AssetHandle meshHandle, AssetHandle materialAsset, uint32_t subMeshIndex, bool isSelected)
-				: MeshHandle(meshHandle), MaterialHandle(materialAsset), SubMeshIndex(subMeshIndex), IsSelected(isSelected)
+			MeshKey(AssetHandle meshHandle, uint32_t subMeshIndex, uint32_t permutationKey, bool isDoubleSided, bool isSelected)
+				: MeshHandle(meshHandle), SubMeshIndex(subMeshIndex), PermutationKey(permutationKey), IsDoubleSided(isDoubleSided), IsSelected(isSelected)
 			{
 			}
 
@@ -134,16 +157,30 @@ namespace Iris {
 				if (SubMeshIndex > other.SubMeshIndex)
 					return false;
 
-				if (MaterialHandle < other.MaterialHandle)
+				if (PermutationKey < other.PermutationKey)
 					return true;
 
-				if (MaterialHandle > other.MaterialHandle)
+				if (PermutationKey > other.PermutationKey)
 					return false;
 
+				if (IsDoubleSided != other.IsDoubleSided)
+					return IsDoubleSided < other.IsDoubleSided;
+
 				return IsSelected < other.IsSelected;
 			}
 		};
 
+		struct TransformVertexData;
+
+		// Draws in a group share the pipeline variant so they go out in a single indirect count draw, their geometry is all in the geometry heap
+		struct IndirectDrawGroup
+		{
+			uint32_t PermutationKey;
+			uint32_t GroupIndex;
+			uint32_t FirstCommand;
+			uint32_t DrawCount;
+		};
+
 	private:
 		void ResetImageLayouts();
 		void FlushDrawList();
@@ -152,6 +189,19 @@ namespace Iris {
 		void PreRender();
 		void ClearPass();
 
+		// GPU driven rendering
+		void CreateGPUDrivenResources();
+		void ReleaseGPUDrivenResources();
+		void UpdateGPUSceneInstance(UUID entityID, const MeshKey& meshKey, const Ref<MeshSource>& meshSource, const TransformVertexData& transform);
+		void ReleaseGPUSceneDrawInstance(const MeshKey& drawKey);
+		void MarkGPUInstanceDirty(uint32_t slot);
+		void ResetGPUScene();
+		void BuildIndirectDrawGroups();
+		void GPUCullingPass();
+		void HiZPass();
+		void CreateHiZResources();
+		void RenderIndirectDrawGroups(Ref<Pipeline> pipeline, const std::vector<IndirectDrawGroup>& groups, uint32_t permutationMask = ~0u);
+
 		void PreDepthPass();
 		void SkyboxPass();
 		void GeometryPass();
@@ -160,6 +210,10 @@ namespace Iris {
 
 		void UpdateStatistics();
 
+		// Texture streaming
+		void AccumulateTextureStreamingSize(const Ref<MaterialAsset>& materialAsset, const AABB& boundingBox, const glm::mat4& transform);
+		void RequestStreamedTextureMips();
+
 	private:
 		// Shader structs
 		struct DirLight
@@ -214,6 +268,8 @@ namespace Iris {
 			DirLight Light;
 			glm::vec3 CameraPosition;
 			float EnvironmentMapIntensity = 1.0f;
+			SHCoefficients IrradianceSH = {};
+			uint32_t UseIrradianceSH = 0;
 		} m_SceneDataUB;
 		Ref<UniformBufferSet> m_UBSSceneData;
 
@@ -267,6 +323,7 @@ namespace Iris {
 		struct TransformVertexData
 		{
 			glm::vec4 MatrixRow[3];
+			uint32_t MaterialIndex; // Slot of the material in the bindless table
 		};
 
 		struct TransformBuffer
@@ -283,7 +340,7 @@ namespace Iris {
 		struct TransformMapData
 		{
 			std::vector<TransformVertexData> Transforms;
-			uint32_t TransformOffset = 0;
+			uint32_t FirstInstance = 0; // Index of the first transform in the transform buffer
 		};
 		std::map<MeshKey, TransformMapData> m_MeshTransformMap;
 
@@ -292,7 +349,6 @@ namespace Iris {
 			Ref<StaticMesh> StaticMesh;
 			Ref<MeshSource> MeshSource;
 			uint32_t SubMeshIndex;
-			Ref<MaterialTable> MaterialTable;
 			Ref<Material> OverrideMaterial;
 
 			uint32_t InstanceCount = 0;
@@ -304,6 +360,139 @@ namespace Iris {
 		std::map<MeshKey, StaticDrawCommand> m_SelectedStaticMeshDrawList;
 		std::map<MeshKey, StaticDrawCommand> m_DoubleSidedSelectedStaticMeshDrawList;
 
+		// GPU driven rendering. Every submesh of the main draw lists is a draw whose instances get culled on the GPU, the draws that keep instances
+		// are compacted into the indirect command range of their group
+		struct GPUInstanceData
+		{
+			glm::vec4 MatrixRow[3];
+			uint32_t MaterialIndex;
+			uint32_t DrawIndex;
+			uint32_t Padding[2];
+		};
+
+		struct GPUDrawData
+		{
+			uint32_t IndexCount;
+			uint32_t FirstIndex;
+			int32_t VertexOffset;
+			uint32_t FirstInstance; // First slot of the draw in the culled instance buffer
+			uint32_t Group;
+			uint32_t Padding[3];
+			glm::vec4 BoundsMin;
+			glm::vec4 BoundsMax;
+		};
+
+		struct GPUDrawGroupData
+		{
+			uint32_t FirstCommand;
+			uint32_t DrawCount;
+		};
+
+		// The instances and draws keep their slots in the input buffers across frames. Only the slots of instances that were added, removed or
+		// moved are uploaded, the draws and groups only when the set of draws or their instance counts changed
+		struct GPUSceneInstanceKey
+		{
+			UUID EntityID;
+			uint32_t SubMeshIndex;
+
+			bool operator<(const GPUSceneInstanceKey& other) const
+			{
+				if (EntityID != other.EntityID)
+					return EntityID < other.EntityID;
+
+				return SubMeshIndex < other.SubMeshIndex;
+			}
+		};
+
+		struct GPUSceneInstance
+		{
+			uint32_t Slot;
+			MeshKey DrawKey;
+			uint64_t LastSubmittedFrame;
+		};
+
+		struct GPUSceneDraw
+		{
+			uint32_t Index = 0;
+			uint32_t InstanceCount = 0;
+			Ref<MeshSource> MeshSource;
+			uint32_t SubMeshIndex = 0;
+		};
+
+		// What the copy of the input buffers of a frame in flight is still missing
+		struct GPUSceneUploads
+		{
+			std::vector<uint32_t> DirtyInstances;
+			bool AllInstances = true;
+			bool Draws = true;
+		};
+
+		std::map<GPUSceneInstanceKey, GPUSceneInstance> m_GPUSceneInstances;
+		std::map<MeshKey, GPUSceneDraw> m_GPUSceneDraws;
+		std::vector<GPUInstanceData> m_GPUInstances; // Mirrors of the input buffers, indexed by slot
+		std::vector<GPUDrawData> m_GPUDraws;
+		std::vector<GPUDrawGroupData> m_GPUDrawGroups;
+		std::vector<uint32_t> m_GPUInstanceDirtyFrames; // Bit per frame in flight that has yet to upload the slot
+		std::vector<uint32_t> m_FreeGPUInstanceSlots;
+		std::vector<uint32_t> m_FreeGPUDrawSlots;
+		std::vector<GPUSceneUploads> m_GPUSceneUploads;
+		uint64_t m_GPUSceneFrame = 0;
+		bool m_GPUDrawLayoutDirty = false;
+
+		std::vector<IndirectDrawGroup> m_IndirectDrawGroups;
+		std::vector<IndirectDrawGroup> m_DoubleSidedIndirectDrawGroups;
+		uint32_t m_GPUInstanceCount = 0;
+		uint32_t m_GPUDrawCount = 0;
+		uint32_t m_GPUDrawGroupCount = 0;
+
+		struct UBCulling // (set = 1, binding = 3)
+		{
+			glm::mat4 ViewProjection;
+			glm::mat4 PreviousViewProjection;
+			glm::vec4 FrustumPlanes[6];
+			glm::vec2 HiZSize;
+			uint32_t HiZMipCount;
+			uint32_t InstanceCount;
+			uint32_t DrawCount;
+			uint32_t HiZValid;
+		};
+		Ref<UniformBufferSet> m_UBSCulling;
+
+		// Written by the CPU, only where something changed
+		Ref<StorageBufferSet> m_SBSInstanceInput;
+		Ref<StorageBufferSet> m_SBSDrawInput;
+		Ref<StorageBufferSet> m_SBSDrawGroups;
+		// Written by the culling passes
+		Ref<StorageBufferSet> m_SBSCulledInstances;
+		Ref<StorageBufferSet> m_SBSDrawCounters;
+		Ref<StorageBufferSet> m_SBSDrawCommands;
+		Ref<StorageBufferSet> m_SBSGroupCounts;
+		uint32_t m_GPUInstanceCapacity = 0;
+		uint32_t m_GPUDrawCapacity = 0;
+		uint32_t m_GPUDrawGroupCapacity = 0;
+
+		Ref<ComputePass> m_GPUCullingPass;
+		Ref<ComputePass> m_DrawCompactionPass;
+
+		// Hierarchical depth buffer, built from the depth of the frame and tested against by the culling of the next frame
+		Ref<ComputePass> m_HiZPass;
+		Ref<Texture2D> m_HiZTexture;
+		std::vector<Ref<ImageView>> m_HiZMipViews;
+		Ref<ImageView> m_HiZDepthView;
+		glm::mat4 m_PreviousViewProjection = glm::mat4(1.0f);
+		bool m_HiZValid = false;
+
+		// Biggest size on screen (in pixels across) of any submesh drawn with the material this frame. Decides which mips of the material's
+		// textures the TextureStreamer pages in
+		struct TextureStreamingRequest
+		{
+			Ref<MaterialAsset> Material;
+			float ScreenSize = 0.0f;
+		};
+		std::unordered_map<AssetHandle, TextureStreamingRequest> m_TextureStreamingRequests;
+		float m_TextureStreamingProjectionScale = 0.0f; // Pixels across the viewport per unit at a distance of one unit
+		bool m_TextureStreamingPerspective = true;
+
 		uint32_t m_ViewportWidth = 0;
 		uint32_t m_ViewportHeight = 0;
 
@@ -15,13 +15,29 @@
 
 namespace Iris {
 
+	// Has to be bumped whenever the shaderc dependency is updated, binaries of an older compiler could be different
+	static constexpr uint32_t s_SPIRVCacheVersion = 1;
+	static constexpr char s_SPIRVCacheIdentifier[4] = { 'I', 'R', 'S', 'V' };
+	static constexpr uint64_t s_SPIRVCacheSizeLimit = 128ull * 1024 * 1024;
+	static constexpr shaderc_env_version s_TargetEnvironmentVersion = shaderc_env_version_vulkan_1_3;
+
+	struct SPIRVCacheEntryHeader
+	{
+		char Identifier[4];
+		uint32_t SourceSize;
+		uint32_t SourceHash; // 32 bit FNV of the preprocessed source, a second check on top of the key
+		uint32_t WordCount;
+	};
+
 	namespace Utils {
 
 		inline static std::string CreateCacheDirIfNeeded()
 		{
 			std::string cacheDir = "Resources/Shaders/Cache";
-			if (!std::filesystem::exists(cacheDir))
-				std::filesystem::create_directories(cacheDir);
+			if (!std::filesystem::exists(cacheDir + "/SPIRV"))
+				std::filesystem::create_directories(cacheDir + "/SPIRV");
+			if (!std::filesystem::exists(cacheDir + "/Links"))
+				std::filesystem::create_directories(cacheDir + "/Links");
 
 			return cacheDir;
 		}
@@ -65,6 +81,51 @@ namespace Iris {
 			return result;
 		}
 
+		static std::filesystem::path GetBinaryCachePath(const std::string& cacheDirectory, uint64_t binaryKey)
+		{
+			return std::filesystem::path(cacheDirectory) / "SPIRV" / fmt::format("{:016x}.spv", binaryKey);
+		}
+
+		// Everything the binary depends on: the preprocessed source with its includes resolved and defines applied, the stage, the options
+		// and the compiler that produced it
+		static uint64_t GetBinaryCacheKey(std::string_view source, VkShaderStageFlagBits stage, bool generateDebugInfo, bool optimize)
+		{
+			uint32_t spirvVersion = 0;
+			uint32_t spirvRevision = 0;
+			shaderc_get_spv_version(&spirvVersion, &spirvRevision);
+
+			std::string key = fmt::format("{}:{}:{}:{}:{}:{}:{}:", s_SPIRVCacheVersion, spirvVersion, spirvRevision, static_cast<uint32_t>(s_TargetEnvironmentVersion),
+				static_cast<uint32_t>(stage), generateDebugInfo, optimize);
+			key += source;
+
+			return Hash::GenerateFNVHash64(key);
+		}
+
+		// One link per file and variant, the full path tells apart files with the same name and the declared permutations the variants of a
+		// file. The extension already holds the stage and whether it is the debug binary
+		static std::filesystem::path GetLastCompiledLinkPath(const std::string& cacheDirectory, const std::string& filePath, const std::vector<ShaderResources::ShaderPermutation>& permutations, std::string_view extension)
+		{
+			std::error_code error;
+			std::string key = std::filesystem::absolute(filePath, error).lexically_normal().generic_string();
+			for (const ShaderResources::ShaderPermutation& permutation : permutations)
+				key += fmt::format(":{}={}", permutation.Name, permutation.DefaultValue);
+
+			return std::filesystem::path(cacheDirectory) / "Links" / fmt::format("{:016x}{}", Hash::GenerateFNVHash64(key), extension);
+		}
+
+		// Returns 0 if there is no link yet
+		static uint64_t ReadLastCompiledLink(const std::filesystem::path& linkPath)
+		{
+			std::error_code error;
+			if (std::filesystem::file_size(linkPath, error) != sizeof(uint64_t))
+				return 0;
+
+			uint64_t binaryKey = 0;
+			FileStreamReader linkStream(linkPath);
+			linkStream.ReadRaw<uint64_t>(binaryKey);
+			return binaryKey;
+		}
+
 		static ShaderUniformType SPIRTypeToShaderUniformType(spirv_cross::SPIRType type)
 		{
 			switch (type.basetype)
@@ -96,6 +157,8 @@ namespace Iris {
 	// set -> binding point -> buffer
 	static std::unordered_map<uint32_t, std::unordered_map<uint32_t, ShaderResources::UniformBuffer>> s_UniformBuffers;
 	static std::unordered_map<uint32_t, std::unordered_map<uint32_t, ShaderResources::StorageBuffer>> s_StorageBuffers;
+	// Shaders are reflected on several threads when the library is loaded in parallel
+	static std::mutex s_SharedBuffersMutex;
 
 	ShaderCompiler::ShaderCompiler(const std::string& filePath, bool disableOptimization)
 		: m_FilePath(filePath), m_DisableOptimizations(disableOptimization)
@@ -109,7 +172,9 @@ namespace Iris {
 
 	bool ShaderCompiler::Reload(bool forceCompile)
 	{
+		m_CompiledStages = false;
 		m_ShaderSource.clear();
+		m_Permutations.clear();
 		m_StagesMetadata.clear();
 		m_SPIRVData.clear();
 
@@ -123,14 +188,15 @@ namespace Iris {
 		const VkShaderStageFlagBits stagesChanged = ShaderRegistry::HasChanged(this);
 		
 		std::map<VkShaderStageFlagBits, std::vector<uint32_t>> spirvDebugData;
-		bool compileSucceeded = CompileOrGetVulkanBinaries(spirvDebugData, m_SPIRVData, stagesChanged, forceCompile);
+		bool compileSucceeded = CompileOrGetVulkanBinaries(spirvDebugData, m_SPIRVData, forceCompile);
 		if (!compileSucceeded)
 		{
 			IR_ASSERT(false);
 			return false;
 		}
 
-		if (forceCompile || stagesChanged || !TryReadCachedReflectionData())
+		// A change in an included file only shows up in the preprocessed source, so anything that had to be compiled is reflected again
+		if (forceCompile || stagesChanged || m_CompiledStages || !TryReadCachedReflectionData())
 		{
 			ReflectAllShaderStages(spirvDebugData);
 			SerializeReflectinoData();
@@ -141,11 +207,20 @@ namespace Iris {
 
 	void ShaderCompiler::ClearUniformAndStorageBuffers()
 	{
+		std::scoped_lock<std::mutex> lock(s_SharedBuffersMutex);
 		s_UniformBuffers.clear();
 		s_StorageBuffers.clear();
 	}
 
 	Ref<Shader> ShaderCompiler::Compile(const std::string& filePath, bool forceCompile, bool disableOptimizations)
+	{
+		Ref<Shader> shader = CompileModules(filePath, forceCompile, disableOptimizations);
+		RegisterDescriptorLayouts(shader);
+
+		return shader;
+	}
+
+	Ref<Shader> ShaderCompiler::CompileModules(const std::string& filePath, bool forceCompile, bool disableOptimizations)
 	{
 		// Set name for the shader
 		std::size_t lastSlash = filePath.find_last_of("/\\");
@@ -165,11 +240,16 @@ namespace Iris {
 
 		shader->LoadAndCreateShaders(compiler->GetSPIRVData());
 		shader->SetReflectionData(compiler->m_ReflectionData);
+		shader->SetPermutations(compiler->m_Permutations);
+
+		return shader;
+	}
+
+	void ShaderCompiler::RegisterDescriptorLayouts(Ref<Shader> shader)
+	{
 		shader->BuildWriteDescriptors();
 
 		Renderer::OnShaderReloaded(shader->GetHash());
-
-		return shader;
 	}
 
 	bool ShaderCompiler::TryRecompile(Ref<Shader> shader)
@@ -183,6 +263,7 @@ namespace Iris {
 
 		shader->LoadAndCreateShaders(compiler->GetSPIRVData());
 		shader->SetReflectionData(compiler->m_ReflectionData);
+		shader->SetPermutations(compiler->m_Permutations);
 		shader->BuildWriteDescriptors();
 
 		Renderer::OnShaderReloaded(shader->GetHash());
@@ -193,9 +274,9 @@ namespace Iris {
 	std::map<VkShaderStageFlagBits, std::string> ShaderCompiler::PreProcess(const std::string& source)
 	{
 		ShaderPreProcessor preprocessor;
-		std::map<VkShaderStageFlagBits, std::string> shaderSources = preprocessor.PreprocessShader(source);
+		std::map<VkShaderStageFlagBits, std::string> shaderSources = preprocessor.PreprocessShader(source, m_Permutations);
 
-		static shaderc::Compiler compiler;
+		thread_local shaderc::Compiler compiler;
 		for (auto& [stage, shaderSource] : shaderSources)
 		{
 			shaderc::CompileOptions options;
@@ -219,9 +300,9 @@ namespace Iris {
 	{
 		const std::string& source = m_ShaderSource.at(stage);
 
-		static shaderc::Compiler compiler;
+		thread_local shaderc::Compiler compiler;
 		shaderc::CompileOptions shadercOptions;
-		shadercOptions.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+		shadercOptions.SetTargetEnvironment(shaderc_target_env_vulkan, s_TargetEnvironmentVersion);
 		shadercOptions.SetWarningsAsErrors();
 		if (options.GenerateDebugInfo)
 			shadercOptions.SetGenerateDebugInfo();
@@ -239,56 +320,57 @@ namespace Iris {
 		return {};
 	}
 
-	bool ShaderCompiler::CompileOrGetVulkanBinaries(std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputDebugBin, std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputBin, VkShaderStageFlagBits stagesChanged, bool forceCompile)
+	bool ShaderCompiler::CompileOrGetVulkanBinaries(std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputDebugBin, std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputBin, bool forceCompile)
 	{
 		for (auto& [stage, source] : m_ShaderSource)
 		{
 			// Debug
-			if (!CompileOrGetVulkanBinary(stage, outputDebugBin[stage], true, stagesChanged, forceCompile))
+			if (!CompileOrGetVulkanBinary(stage, outputDebugBin[stage], true, forceCompile))
 				return false;
 			// Release
-			if (!CompileOrGetVulkanBinary(stage, outputBin[stage], false, stagesChanged, forceCompile))
+			if (!CompileOrGetVulkanBinary(stage, outputBin[stage], false, forceCompile))
 				return false;
 		}
 
 		return true;
 	}
 
-	bool ShaderCompiler::CompileOrGetVulkanBinary(VkShaderStageFlagBits stage, std::vector<uint32_t>& outputBin, bool debug, VkShaderStageFlagBits stagesChanged, bool forceCompile)
+	bool ShaderCompiler::CompileOrGetVulkanBinary(VkShaderStageFlagBits stage, std::vector<uint32_t>& outputBin, bool debug, bool forceCompile)
 	{
 		std::string cacheDirectory = Utils::CreateCacheDirIfNeeded();
 
-		// Check if we have a cached version if we dont need to force compile
-		const char* extension = ShaderUtils::ShaderStageCachedFileExtension(stage, debug);
-		if (!forceCompile && stage & ~stagesChanged) // Per-stage cache is found and not changed
+		CompilationOptions options;
+		if (debug)
+		{
+			options.GenerateDebugInfo = true;
+			options.Optimize = false;
+		}
+		else
 		{
-			TryGetVulkanCachedBinary(cacheDirectory, extension, outputBin);
+			options.GenerateDebugInfo = false;
+			// NOTE: Shaderc internal error with optimizing compute shaders...
+			// options.Optimize = !m_DisableOptimizations && stage != VK_SHADER_STAGE_COMPUTE_BIT;
+			options.Optimize = true;
 		}
 
+		const std::string& source = m_ShaderSource.at(stage);
+		const uint64_t binaryKey = Utils::GetBinaryCacheKey(source, stage, options.GenerateDebugInfo, options.Optimize);
+		const char* extension = ShaderUtils::ShaderStageCachedFileExtension(stage, debug);
+
+		// Same preprocessed source compiled with the same options and compiler gives the same binary, no matter which file or variant it came from
+		if (!forceCompile)
+			TryGetVulkanCachedBinary(cacheDirectory, binaryKey, source, outputBin);
+
 		// Couldnt get it from cache now we compile
 		if (outputBin.empty())
 		{
 			// IR_CORE_DEBUG_TAG("ShaderCompiler", "Shader cache not found! Compiling: {}, stage {}", m_FilePath.string(), ShaderUtils::VkShaderStageToString(stage));
-			CompilationOptions options;
-			if (debug)
-			{
-				options.GenerateDebugInfo = true;
-				options.Optimize = false;
-			}
-			else
-			{
-				options.GenerateDebugInfo = false;
-				// NOTE: Shaderc internal error with optimizing compute shaders...
-				// options.Optimize = !m_DisableOptimizations && stage != VK_SHADER_STAGE_COMPUTE_BIT;
-				options.Optimize = true;
-			}
-
 			std::string error = Compile(outputBin, stage, options);
 			if (error.size())
 			{
 				IR_CORE_ERROR_TAG("ShaderCompiler", "Error compiling shader: {} stage: {}.\nError: {}", m_FilePath, ShaderUtils::VkShaderStageToString(stage), error);
 				// Fallback to still run on the old shader
-				TryGetVulkanCachedBinary(cacheDirectory, extension, outputBin);
+				TryGetLastCompiledBinary(cacheDirectory, extension, outputBin);
 				if (outputBin.empty())
 				{
 					IR_CORE_FATAL_TAG("ShaderCompiler", "Couldnt compile shader and did not find a cached version!");
@@ -300,45 +382,139 @@ namespace Iris {
 
 				return false;
 			}
-			else
-			{
-				const std::filesystem::path filePathPath = m_FilePath;
-				const std::filesystem::path path = std::filesystem::path(cacheDirectory) / (filePathPath.filename().string() + extension);
-				const std::string cachedFilePath = path.string();
 
-				FILE* f = fopen(cachedFilePath.c_str(), "wb");
-				if (f)
-				{
-					fwrite(outputBin.data(), sizeof(uint32_t), outputBin.size(), f);
-					fclose(f);
-				}
-				else
-				{
-					IR_CORE_ERROR_TAG("ShaderCompiler", "Failed to cache shader: {}, stage: {} binary", m_FilePath, ShaderUtils::VkShaderStageToString(stage));
-					return false;
-				}
+			m_CompiledStages = true;
+
+			if (!CacheVulkanBinary(cacheDirectory, binaryKey, source, outputBin))
+			{
+				IR_CORE_ERROR_TAG("ShaderCompiler", "Failed to cache shader: {}, stage: {} binary", m_FilePath, ShaderUtils::VkShaderStageToString(stage));
+				return false;
 			}
 		}
 
+		// Remembers which binary the file compiled to last so that it can still be loaded if the next edit fails to compile, most loads hit
+		// the same binary as before so the link is only rewritten when that changed
+		const std::filesystem::path linkPath = Utils::GetLastCompiledLinkPath(cacheDirectory, m_FilePath, m_Permutations, extension);
+		if (Utils::ReadLastCompiledLink(linkPath) != binaryKey)
+		{
+			FileStreamWriter linkStream(linkPath, true);
+			if (linkStream)
+				linkStream.WriteRaw<uint64_t>(binaryKey);
+		}
+
 		return true;
 	}
 
-	void ShaderCompiler::TryGetVulkanCachedBinary(const std::string& cacheDirectory, const std::string& extension, std::vector<uint32_t>& outputBinary) const
+	void ShaderCompiler::TryGetVulkanCachedBinary(const std::string& cacheDirectory, uint64_t binaryKey, std::string_view source, std::vector<uint32_t>& outputBinary) const
 	{
-		const std::filesystem::path filePathPath = m_FilePath;
-		const std::filesystem::path path = std::filesystem::path(cacheDirectory) / (filePathPath.filename().string() + extension);
-		const std::string cachedFilePath = path.string();
+		const std::filesystem::path path = Utils::GetBinaryCachePath(cacheDirectory, binaryKey);
+
+		FileStreamReader stream(path);
+		if (!stream)
+			return;
+
+		SPIRVCacheEntryHeader header;
+		stream.ReadRaw(header);
+
+		// The source length and a second hash of it have to match as well, a collision of the 64 bit key alone is not enough to load the wrong binary
+		const uint64_t fileSize = std::filesystem::file_size(path);
+		const bool validEntry = std::memcmp(header.Identifier, s_SPIRVCacheIdentifier, sizeof(s_SPIRVCacheIdentifier)) == 0
+			&& header.SourceSize == source.size()
+			&& header.SourceHash == Hash::GenerateFNVHash(source)
+			&& fileSize == sizeof(SPIRVCacheEntryHeader) + static_cast<uint64_t>(header.WordCount) * sizeof(uint32_t);
+		if (!validEntry)
+			return;
 
-		FILE* f = fopen(cachedFilePath.c_str(), "rb");
-		if (!f)
+		outputBinary.resize(header.WordCount);
+		stream.ReadData(reinterpret_cast<uint8_t*>(outputBinary.data()), outputBinary.size() * sizeof(uint32_t));
+
+		// Marks the entry as recently used for TrimBinaryCache
+		std::error_code error;
+		std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+	}
+
+	void ShaderCompiler::TryGetLastCompiledBinary(const std::string& cacheDirectory, const std::string& extension, std::vector<uint32_t>& outputBinary) const
+	{
+		const uint64_t binaryKey = Utils::ReadLastCompiledLink(Utils::GetLastCompiledLinkPath(cacheDirectory, m_FilePath, m_Permutations, extension));
+		if (binaryKey == 0)
+			return;
+
+		FileStreamReader stream(Utils::GetBinaryCachePath(cacheDirectory, binaryKey));
+		if (!stream)
 			return;
 
-		fseek(f, 0, SEEK_END);
-		uint64_t size = ftell(f);
-		fseek(f, 0, SEEK_SET);
-		outputBinary = std::vector<uint32_t>(size / sizeof(uint32_t));
-		fread(outputBinary.data(), sizeof(uint32_t), outputBinary.size(), f);
-		fclose(f);
+		SPIRVCacheEntryHeader header;
+		stream.ReadRaw(header);
+		if (std::memcmp(header.Identifier, s_SPIRVCacheIdentifier, sizeof(s_SPIRVCacheIdentifier)) != 0)
+			return;
+
+		outputBinary.resize(header.WordCount);
+		stream.ReadData(reinterpret_cast<uint8_t*>(outputBinary.data()), outputBinary.size() * sizeof(uint32_t));
+	}
+
+	bool ShaderCompiler::CacheVulkanBinary(const std::string& cacheDirectory, uint64_t binaryKey, std::string_view source, const std::vector<uint32_t>& binary) const
+	{
+		SPIRVCacheEntryHeader header = {
+			.SourceSize = static_cast<uint32_t>(source.size()),
+			.SourceHash = Hash::GenerateFNVHash(source),
+			.WordCount = static_cast<uint32_t>(binary.size())
+		};
+		std::memcpy(header.Identifier, s_SPIRVCacheIdentifier, sizeof(s_SPIRVCacheIdentifier));
+
+		// A truncated entry fails the size check when it is read, so it is written in place
+		FileStreamWriter stream(Utils::GetBinaryCachePath(cacheDirectory, binaryKey), true);
+		if (!stream)
+			return false;
+
+		stream.WriteRaw(header);
+		stream.WriteData(reinterpret_cast<const uint8_t*>(binary.data()), binary.size() * sizeof(uint32_t));
+		return true;
+	}
+
+	void ShaderCompiler::TrimBinaryCache()
+	{
+		const std::filesystem::path binaryDirectory = std::filesystem::path(Utils::CreateCacheDirIfNeeded()) / "SPIRV";
+
+		struct CacheEntry
+		{
+			std::filesystem::path Path;
+			std::filesystem::file_time_type LastUsed;
+			uint64_t Size;
+		};
+
+		std::error_code error;
+		std::vector<CacheEntry> entries;
+		uint64_t totalSize = 0;
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(binaryDirectory, error))
+		{
+			if (!entry.is_regular_file())
+				continue;
+
+			CacheEntry& cacheEntry = entries.emplace_back(entry.path(), entry.last_write_time(), entry.file_size());
+			totalSize += cacheEntry.Size;
+		}
+
+		if (totalSize <= s_SPIRVCacheSizeLimit)
+			return;
+
+		// Least recently used first
+		std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) { return a.LastUsed < b.LastUsed; });
+
+		uint32_t removedCount = 0;
+		const uint64_t previousSize = totalSize;
+		for (const CacheEntry& entry : entries)
+		{
+			if (totalSize <= s_SPIRVCacheSizeLimit)
+				break;
+
+			if (std::filesystem::remove(entry.Path, error))
+			{
+				totalSize -= entry.Size;
+				removedCount++;
+			}
+		}
+
+		IR_CORE_INFO_TAG("ShaderCompiler", "Evicted {} binaries from the SPIR-V cache ({} KB -> {} KB)", removedCount, previousSize / 1024, totalSize / 1024);
 	}
 
 	void ShaderCompiler::ClearReflectionData()
@@ -443,6 +619,9 @@ namespace Iris {
 		IR_CORE_TRACE_TAG("ShaderCompiler", "\t{0} Sampled Images", resources.sampled_images.size());
 		IR_CORE_TRACE_TAG("ShaderCompiler", "\t{0} Storage Images", resources.storage_images.size());
 
+		// The uniform and storage buffers are shared between all shaders
+		std::unique_lock<std::mutex> sharedBuffersLock(s_SharedBuffersMutex);
+
 		IR_CORE_TRACE_TAG("ShaderCompiler", "============================");
 		IR_CORE_WARN_TAG("ShaderCompiler", "Uniform Buffers:");
 		for (const spirv_cross::Resource& res : resources.uniform_buffers)
@@ -538,6 +717,8 @@ namespace Iris {
 			}
 		}
 
+		sharedBuffersLock.unlock();
+
 		IR_CORE_TRACE_TAG("ShaderCompiler", "============================");
 		IR_CORE_WARN_TAG("ShaderCompiler", "Push Constant Buffers:");
 		for (const spirv_cross::Resource& res : resources.push_constant_buffers)
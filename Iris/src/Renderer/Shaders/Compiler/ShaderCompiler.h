@@ -31,8 +31,17 @@ namespace Iris {
 		static void ClearUniformAndStorageBuffers();
 
 		static Ref<Shader> Compile(const std::string& filepath, bool forceCompile = false, bool disableOptimizations = false);
+		// Compile is split in two for ShadersLibrary::LoadAll, CompileModules does the preprocessing, compilation, reflection and shader module
+		// creation and can run on any thread. RegisterDescriptorLayouts creates the descriptor set layouts and notifies the renderer, it is
+		// kept on the calling thread
+		static Ref<Shader> CompileModules(const std::string& filepath, bool forceCompile = false, bool disableOptimizations = false);
+		static void RegisterDescriptorLayouts(Ref<Shader> shader);
 		static bool TryRecompile(Ref<Shader> shader);
 
+		// Binaries are cached by the hash of everything they depend on (see CompileOrGetVulkanBinary), this removes the least recently used
+		// ones once the cache grows over its size limit
+		static void TrimBinaryCache();
+
 	private:
 		struct CompilationOptions
 		{
@@ -43,9 +52,11 @@ namespace Iris {
 		std::map<VkShaderStageFlagBits, std::string> PreProcess(const std::string& source);
 
 		std::string Compile(std::vector<uint32_t>& outputBin, VkShaderStageFlagBits stage, CompilationOptions options) const;
-		bool CompileOrGetVulkanBinaries(std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputDebugBin, std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputBin, VkShaderStageFlagBits stagesChanged, bool forceCompile);
-		bool CompileOrGetVulkanBinary(VkShaderStageFlagBits stage, std::vector<uint32_t>& outputBin, bool debug, VkShaderStageFlagBits stagesChanged, bool forceCompile);
-		void TryGetVulkanCachedBinary(const std::string& cacheDirectory, const std::string& extension, std::vector<uint32_t>& outputBinary) const;
+		bool CompileOrGetVulkanBinaries(std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputDebugBin, std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputBin, bool forceCompile);
+		bool CompileOrGetVulkanBinary(VkShaderStageFlagBits stage, std::vector<uint32_t>& outputBin, bool debug, bool forceCompile);
+		void TryGetVulkanCachedBinary(const std::string& cacheDirectory, uint64_t binaryKey, std::string_view source, std::vector<uint32_t>& outputBinary) const;
+		void TryGetLastCompiledBinary(const std::string& cacheDirectory, const std::string& extension, std::vector<uint32_t>& outputBinary) const;
+		bool CacheVulkanBinary(const std::string& cacheDirectory, uint64_t binaryKey, std::string_view source, const std::vector<uint32_t>& binary) const;
 
 		void ClearReflectionData();
 
@@ -61,10 +72,12 @@ namespace Iris {
 
 		std::map<VkShaderStageFlagBits, std::string> m_ShaderSource;
 		std::map<VkShaderStageFlagBits, std::vector<uint32_t>> m_SPIRVData;
+		std::vector<ShaderResources::ShaderPermutation> m_Permutations;
 
 		Shader::ReflectionData m_ReflectionData;
 
 		std::map<VkShaderStageFlagBits, StageData> m_StagesMetadata;
+		bool m_CompiledStages = false; // At least one stage was not found in the binary cache during the last Reload
 
 		friend class ShaderRegistry;
 	};
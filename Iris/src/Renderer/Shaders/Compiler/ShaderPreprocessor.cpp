@@ -6,7 +6,7 @@
 
 namespace Iris {
 
-	std::map<VkShaderStageFlagBits, std::string> ShaderPreProcessor::PreprocessShader(const std::string& source) const
+	std::map<VkShaderStageFlagBits, std::string> ShaderPreProcessor::PreprocessShader(const std::string& source, std::vector<ShaderResources::ShaderPermutation>& outPermutations) const
 	{
 		std::string shaderSource;
 		{
@@ -45,6 +45,30 @@ namespace Iris {
 
 				stagePositions.emplace_back(std::pair{ vkStage, startOfStage });
 				shaderSource.erase(pos, eol - pos);
+
+				// The line after the stage now starts at pos and might be a directive as well
+				pos = shaderSource.find('#', pos);
+				continue;
+			}
+			// Parse a permutation. Example: #pragma permutation IR_NORMAL_MAP 1
+			else if (tokens[index] == "pragma" && tokens.size() > index + 2 && tokens[index + 1] == "permutation")
+			{
+				index += 2;
+				const std::string& name = tokens[index];
+				const bool defaultValue = tokens.size() <= index + 1 || tokens[index + 1] != "0";
+
+				// Every stage declares the permutations it uses, the same name has to end up as the same constant in all of them
+				auto it = std::find_if(outPermutations.begin(), outPermutations.end(), [&name](const ShaderResources::ShaderPermutation& permutation) { return permutation.Name == name; });
+				if (it == outPermutations.end())
+				{
+					IR_VERIFY(outPermutations.size() < 32, "A shader can not have more than 32 permutations!");
+					it = outPermutations.insert(outPermutations.end(), ShaderResources::ShaderPermutation{ name, defaultValue });
+				}
+				IR_VERIFY(it->DefaultValue == defaultValue, "Permutation declared with a different default value in another stage!");
+
+				// Keep the line ending so that the line numbers in the compiler errors stay correct
+				const uint32_t constantID = static_cast<uint32_t>(std::distance(outPermutations.begin(), it));
+				shaderSource.replace(pos, eol - 1 - pos, fmt::format("layout(constant_id = {}) const bool {} = {};", constantID, name, defaultValue ? "true" : "false"));
 			}
 
 			// NOTE: If we want to add more stuff to handle such as #if defined() we can do that here:
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Renderer/Shaders/ShaderResources.h"
+
 #include <vulkan/vulkan.h>
 
 #include <map>
@@ -13,7 +15,8 @@ namespace Iris {
 	public:
 		ShaderPreProcessor() = default;
 
-		std::map<VkShaderStageFlagBits, std::string> PreprocessShader(const std::string& source) const;
+		// `#pragma permutation NAME [0|1]` lines are replaced by boolean specialization constants and appended to outPermutations
+		std::map<VkShaderStageFlagBits, std::string> PreprocessShader(const std::string& source, std::vector<ShaderResources::ShaderPermutation>& outPermutations) const;
 
 		template<typename InputIt, typename OutputIt>
 		void CopyWithoutComments(InputIt first, InputIt last, OutputIt out) const;
@@ -3,9 +3,13 @@
 
 #include "Compiler/ShaderCompiler.h"
 #include "Core/Hash.h"
+#include "Core/WorkerPool.h"
+#include "Renderer/BindlessTable.h"
 #include "Renderer/Core/RendererContext.h"
 #include "Renderer/Core/Vulkan.h"
+#include "Renderer/Pipeline.h"
 #include "Renderer/Renderer.h"
+#include "ShaderRegistry.h"
 #include "ShaderUtils.h"
 
 #include <shaderc/shaderc.hpp>
@@ -47,6 +51,9 @@ namespace Iris {
 		{
 			const VkDevice device = RendererContext::Get()->GetDevice()->GetVulkanDevice();
 
+			// A pipeline that is still being compiled on a worker could be using the modules
+			Pipeline::WaitForCompilations(pipelineCIs);
+
 			for (const auto& pipelineShaderStageCI : pipelineCIs)
 			{
 				if (pipelineShaderStageCI.module)
@@ -90,6 +97,9 @@ namespace Iris {
 		{
 			const VkDevice device = RendererContext::Get()->GetDevice()->GetVulkanDevice();
 
+			// A pipeline that is still being compiled on a worker could be using the modules
+			Pipeline::WaitForCompilations(pipelineCIs);
+
 			for (const auto& pipelineShaderStageCI : pipelineCIs)
 			{
 				if (pipelineShaderStageCI.module)
@@ -119,6 +129,9 @@ namespace Iris {
 		{
 			const VkDevice device = RendererContext::Get()->GetDevice()->GetVulkanDevice();
 
+			// A pipeline that is still being compiled on a worker could be using the modules
+			Pipeline::WaitForCompilations(pipelineCIs);
+
 			for (const auto& pipelineShaderStageCI : pipelineCIs)
 			{
 				if (pipelineShaderStageCI.module)
@@ -137,6 +150,56 @@ namespace Iris {
 		return Hash::GenerateFNVHash(m_FilePath);
 	}
 
+	void Shader::SetReflectionData(const ReflectionData& reflectionData)
+	{
+		m_ReflectionData = reflectionData;
+		BuildUniformLookup();
+	}
+
+	void Shader::BuildUniformLookup()
+	{
+		// Resolved once here so that materials never have to build strings out of the names they set
+		m_UniformsByNameHash.clear();
+		for (const auto& [bufferName, buffer] : m_ReflectionData.ConstantBuffers)
+		{
+			for (const auto& [name, uniform] : buffer.Uniforms)
+			{
+				const uint32_t nameHash = Hash::GenerateFNVHash(name);
+				IR_VERIFY(!m_UniformsByNameHash.contains(nameHash), "Hash of uniform {} collides with {}", name, m_UniformsByNameHash.at(nameHash)->GetName());
+				m_UniformsByNameHash[nameHash] = &uniform;
+			}
+		}
+	}
+
+	const ShaderUniform* Shader::FindUniform(uint32_t nameHash) const
+	{
+		auto it = m_UniformsByNameHash.find(nameHash);
+		return it != m_UniformsByNameHash.end() ? it->second : nullptr;
+	}
+
+	void Shader::SetPermutations(const std::vector<ShaderResources::ShaderPermutation>& permutations)
+	{
+		m_Permutations = permutations;
+
+		m_DefaultPermutationKey = 0;
+		for (uint32_t i = 0; i < m_Permutations.size(); i++)
+		{
+			if (m_Permutations[i].DefaultValue)
+				m_DefaultPermutationKey |= 1u << i;
+		}
+	}
+
+	int32_t Shader::GetPermutationIndex(std::string_view name) const
+	{
+		for (uint32_t i = 0; i < m_Permutations.size(); i++)
+		{
+			if (m_Permutations[i].Name == name)
+				return static_cast<int32_t>(i);
+		}
+
+		return -1;
+	}
+
 	bool Shader::TryReadReflectionData(StreamReader* reader)
 	{
 		uint32_t shaderDescriptorSetCount;
@@ -154,6 +217,7 @@ namespace Iris {
 		
 		reader->ReadMap(m_ReflectionData.ConstantBuffers);
 		reader->ReadArray(m_ReflectionData.PushConstantRanges);
+		BuildUniformLookup();
 
 		return true;
 	}
@@ -182,6 +246,10 @@ namespace Iris {
 		for (VkDescriptorSetLayout& layout : m_DescriptorSetLayouts)
 			result.emplace_back(layout);
 
+		// The bindless set is shared by every shader, its layout belongs to the table
+		if (result.size() > BindlessTable::DescriptorSet)
+			result[BindlessTable::DescriptorSet] = BindlessTable::GetDescriptorSetLayout();
+
 		return result;
 	}
 
@@ -259,6 +327,13 @@ namespace Iris {
 		{
 			auto& shaderDescriptorSet = m_ReflectionData.ShaderDescriptorSets[set];
 
+			// Allocated and written by the BindlessTable, so no layout or pool sizes of our own
+			if (set == BindlessTable::DescriptorSet)
+			{
+				m_ExistingSets.insert(set);
+				continue;
+			}
+
 			// Add to the global VkDescriptorPoolSize for the global descriptor pool in the DescriptorSetManager
 			if (shaderDescriptorSet.UniformBuffers.size())
 			{
@@ -408,6 +483,49 @@ namespace Iris {
 		m_Library[name] = shader;
 	}
 
+	void ShadersLibrary::LoadAll(const std::vector<std::string>& filePaths, bool forceCompile)
+	{
+		if (filePaths.empty())
+			return;
+
+		Timer timer;
+
+		std::vector<Ref<Shader>> shaders(filePaths.size());
+		std::vector<float> compileTimes(filePaths.size());
+
+		// Compiled on the worker pool and the calling thread, every thread keeps its own shaderc compiler
+		WorkerPool::ParallelFor(static_cast<uint32_t>(filePaths.size()), [&](uint32_t i)
+		{
+			Timer shaderTimer;
+			shaders[i] = ShaderCompiler::CompileModules(filePaths[i], forceCompile);
+			compileTimes[i] = shaderTimer.ElapsedMillis();
+		});
+
+		const uint32_t threadCount = glm::min(static_cast<uint32_t>(filePaths.size()), WorkerPool::GetWorkerCount() + 1);
+
+		const float compileTime = timer.ElapsedMillis();
+		ShaderRegistry::Flush();
+		ShaderCompiler::TrimBinaryCache();
+
+		// Added in the order of the list so that startup does not depend on which worker finished first
+		for (const Ref<Shader>& shader : shaders)
+		{
+			ShaderCompiler::RegisterDescriptorLayouts(shader);
+			Add(shader);
+		}
+
+		IR_CORE_INFO_TAG("Shader", "Loaded {} shaders in {:.2f}ms on {} threads ({:.2f}ms compiling, {:.2f}ms creating descriptor set layouts)",
+			shaders.size(), timer.ElapsedMillis(), threadCount, compileTime, timer.ElapsedMillis() - compileTime);
+
+		std::vector<uint32_t> order(shaders.size());
+		for (uint32_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&compileTimes](uint32_t a, uint32_t b) { return compileTimes[a] > compileTimes[b]; });
+
+		for (uint32_t i : order)
+			IR_CORE_INFO_TAG("Shader", "\t{}: {:.2f}ms{}", shaders[i]->GetName(), compileTimes[i], shaders[i]->GetCompilationStatus() ? "" : " (failed)");
+	}
+
 	void ShadersLibrary::Load(std::string_view name, std::string_view filePath)
 	{
 		IR_ASSERT(!m_Library.contains(std::string(name)), "Shader already loaded!");
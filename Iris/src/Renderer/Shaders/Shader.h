@@ -44,7 +44,14 @@ namespace Iris {
 
 		bool TryReadReflectionData(StreamReader* reader);
 		void SerializeReflectionData(StreamWriter* serializer);
-		void SetReflectionData(const ReflectionData& reflectionData) { m_ReflectionData = reflectionData; }
+		void SetReflectionData(const ReflectionData& reflectionData);
+
+		const std::vector<ShaderResources::ShaderPermutation>& GetPermutations() const { return m_Permutations; }
+		void SetPermutations(const std::vector<ShaderResources::ShaderPermutation>& permutations);
+		// The key of the variant every permutation is at its default value in, this is the variant pipelines are created with
+		uint32_t GetDefaultPermutationKey() const { return m_DefaultPermutationKey; }
+		// Returns -1 if the shader does not declare the permutation
+		int32_t GetPermutationIndex(std::string_view name) const;
 
 		// NOTE: To be used in the pipeline creation
 		const std::vector<VkPipelineShaderStageCreateInfo>& GetPipelineShaderStageCreateInfos() const { return m_PipelineShaderStageCreateInfos; }
@@ -58,6 +65,8 @@ namespace Iris {
 		const std::vector<ShaderResources::ShaderDescriptorSet>& GetShaderDescriptorSets() const { return m_ReflectionData.ShaderDescriptorSets; }
 		bool HasDescriptorSet(uint32_t set) const { return m_ExistingSets.contains(set); }
 		const std::unordered_map<std::string, ShaderBuffer>& GetShaderBuffers() const { return m_ReflectionData.ConstantBuffers; }
+		// Looks up a uniform of the constant buffers by the hash of its name (see MaterialParam), nullptr if there is none
+		const ShaderUniform* FindUniform(uint32_t nameHash) const;
 		const std::vector<ShaderResources::PushConstantRange>& GetPushConstantRanges() const { return m_ReflectionData.PushConstantRanges; }
 
 		const std::unordered_map<VkDescriptorType, uint32_t>& GetDescriptorPoolSizes() const { return m_DescriptorPoolTypeCounts; }
@@ -70,6 +79,7 @@ namespace Iris {
 	private:
 		void LoadAndCreateShaders(const std::map<VkShaderStageFlagBits, std::vector<uint32_t>>& shaderData);
 		void BuildWriteDescriptors();
+		void BuildUniformLookup();
 
 	private:
 		std::string m_Name;
@@ -81,6 +91,10 @@ namespace Iris {
 		std::vector<VkPipelineShaderStageCreateInfo> m_PipelineShaderStageCreateInfos;
 
 		ReflectionData m_ReflectionData;
+		std::unordered_map<uint32_t, const ShaderUniform*> m_UniformsByNameHash; // Points into m_ReflectionData.ConstantBuffers
+
+		std::vector<ShaderResources::ShaderPermutation> m_Permutations;
+		uint32_t m_DefaultPermutationKey = 0;
 
 		std::vector<VkDescriptorSetLayout> m_DescriptorSetLayouts;
 		std::set<uint32_t> m_ExistingSets;
@@ -102,6 +116,8 @@ namespace Iris {
 		void Add(Ref<Shader> shader);
 		void Load(std::string_view filePath, bool forceCompile = false, bool disableOptimizations = false);
 		void Load(std::string_view name, std::string_view filePath);
+		// Compiles the shaders on worker threads, only the descriptor set layouts are created one after the other on the calling thread
+		void LoadAll(const std::vector<std::string>& filePaths, bool forceCompile = false);
 		const Ref<Shader> Get(const std::string& name) const;
 
 		std::size_t GetSize() const noexcept { return m_Library.size(); }
@@ -1,107 +1,137 @@
 #include "IrisPCH.h"
 #include "ShaderRegistry.h"
 
-#include "ShaderUtils.h"
-
-#include <yaml-cpp/yaml.h>
+#include "Serialization/FileStream.h"
 
 namespace Iris {
 
 	constexpr static const char* s_ShaderRegistryPath = "Resources/Shaders/ShaderRegistry.cache";
+	// Has to be bumped whenever the layout of the file changes
+	constexpr static uint32_t s_ShaderRegistryVersion = 1;
+	constexpr static char s_ShaderRegistryIdentifier[4] = { 'I', 'R', 'S', 'G' };
+
+	struct ShaderRegistryData
+	{
+		std::map<std::string, std::map<VkShaderStageFlagBits, StageData>> Shaders;
+		bool Loaded = false;
+		bool Dirty = false;
+		std::mutex Mutex;
+	};
+
+	static ShaderRegistryData s_Data;
 
 	VkShaderStageFlagBits ShaderRegistry::HasChanged(Ref<ShaderCompiler> shaderCompiler)
 	{
-		std::map<std::string, std::map<VkShaderStageFlagBits, StageData>> shaderCache;
+		std::scoped_lock<std::mutex> lock(s_Data.Mutex);
 
-		Deserialize(shaderCache);
+		if (!s_Data.Loaded)
+		{
+			Deserialize(s_Data.Shaders);
+			s_Data.Loaded = true;
+		}
 
-		VkShaderStageFlagBits changedState = {};
-		const bool shaderNotCached = !shaderCache.contains(shaderCompiler->m_FilePath);
+		std::map<VkShaderStageFlagBits, StageData>& stages = s_Data.Shaders[shaderCompiler->m_FilePath];
 
+		VkShaderStageFlagBits changedState = {};
 		for (const auto& [stage, source] : shaderCompiler->m_ShaderSource)
 		{
-			// We use the std::map's `[]` operator so it inserts if it is not there...
-			if (shaderNotCached || shaderCompiler->m_StagesMetadata.at(stage) != shaderCache[shaderCompiler->m_FilePath][stage])
-			{
-				shaderCache[shaderCompiler->m_FilePath][stage] = shaderCompiler->m_StagesMetadata.at(stage);
+			auto it = stages.find(stage);
+			if (it == stages.end() || shaderCompiler->m_StagesMetadata.at(stage) != it->second)
 				*(int*)&changedState |= stage;
-			}
 		}
 
-		// Update cache in case we added a stage but didn't remove the deleted (in file) stages
-		shaderCache.at(shaderCompiler->m_FilePath) = shaderCompiler->m_StagesMetadata;
-
-		if (changedState)
+		// Also drops the stages that were removed from the file
+		if (changedState || stages.size() != shaderCompiler->m_StagesMetadata.size())
 		{
-			Serialize(shaderCache);
+			stages = shaderCompiler->m_StagesMetadata;
+			s_Data.Dirty = true;
 		}
 
 		return changedState;
 	}
 
-	void ShaderRegistry::Serialize(const std::map<std::string, std::map<VkShaderStageFlagBits, StageData>>& shaderCache)
+	void ShaderRegistry::Flush()
 	{
-		YAML::Emitter out;
-
-		out << YAML::BeginMap;
+		std::scoped_lock<std::mutex> lock(s_Data.Mutex);
 
-		out << YAML::Key << "ShaderRegistry" << YAML::BeginSeq;
-		for (const auto&[filePath, stages] : shaderCache)
-		{
-			out << YAML::BeginMap;
+		if (!s_Data.Dirty)
+			return;
 
-			out << YAML::Key << "Filepath" << YAML::Value << filePath;
+		Serialize(s_Data.Shaders);
+		s_Data.Dirty = false;
+	}
 
-			out << YAML::Key << "Stages" << YAML::BeginSeq;
-			for (const auto&[stage, data] : stages)
+	void ShaderRegistry::Serialize(const std::map<std::string, std::map<VkShaderStageFlagBits, StageData>>& shaderCache)
+	{
+		// Written to a temporary file first so that a crash halfway through never leaves a truncated registry behind
+		const std::filesystem::path registryPath = s_ShaderRegistryPath;
+		std::filesystem::path tempPath = registryPath;
+		tempPath += ".tmp";
+		{
+			FileStreamWriter stream(tempPath, true);
+			if (!stream)
 			{
-				out << YAML::BeginMap;
-
-				out << YAML::Key << "Stage" << YAML::Value << ShaderUtils::VkShaderStageToString(stage);
-				out << YAML::Key << "Hash" << YAML::Value << data.Hash;
-
-				out << YAML::EndMap;
+				IR_CORE_ERROR_TAG("ShaderCompiler", "Failed to write ShaderRegistry to {}", registryPath);
+				return;
 			}
-			out << YAML::EndSeq;
 
-			out << YAML::EndMap;
+			stream.WriteRaw(s_ShaderRegistryIdentifier);
+			stream.WriteRaw<uint32_t>(s_ShaderRegistryVersion);
+			stream.WriteRaw<uint32_t>(static_cast<uint32_t>(shaderCache.size()));
+			for (const auto& [filePath, stages] : shaderCache)
+			{
+				stream.WriteString(filePath);
+				stream.WriteRaw<uint32_t>(static_cast<uint32_t>(stages.size()));
+				for (const auto& [stage, data] : stages)
+				{
+					stream.WriteRaw<uint32_t>(static_cast<uint32_t>(stage));
+					stream.WriteRaw<uint32_t>(data.Hash);
+				}
+			}
 		}
-		out << YAML::EndSeq;
-
-		out << YAML::EndMap;
 
-		std::ofstream fout(s_ShaderRegistryPath);
-		fout << out.c_str();
+		std::error_code error;
+		std::filesystem::rename(tempPath, registryPath, error);
+		if (error)
+		{
+			IR_CORE_ERROR_TAG("ShaderCompiler", "Failed to write ShaderRegistry to {}: {}", registryPath, error.message());
+			std::filesystem::remove(tempPath, error);
+		}
 	}
 
 	void ShaderRegistry::Deserialize(std::map<std::string, std::map<VkShaderStageFlagBits, StageData>>& shaderCache)
 	{
-		std::ifstream fin(s_ShaderRegistryPath);
-		if (!fin.good())
+		FileStreamReader stream(s_ShaderRegistryPath);
+		if (!stream)
 			return;
 
-		std::stringstream sstr;
-		sstr << fin.rdbuf();
+		char identifier[4] = {};
+		uint32_t version = 0;
+		uint32_t shaderCount = 0;
+		stream.ReadRaw(identifier);
+		stream.ReadRaw<uint32_t>(version);
+		stream.ReadRaw<uint32_t>(shaderCount);
 
-		YAML::Node data = YAML::Load(sstr.str());
-		YAML::Node handles = data["ShaderRegistry"];
-		if (handles.IsNull())
+		// Registries written by an older version (including the old YAML one) are dropped, every shader is then recompiled once
+		if (std::memcmp(identifier, s_ShaderRegistryIdentifier, sizeof(identifier)) != 0 || version != s_ShaderRegistryVersion)
 		{
-			IR_CORE_ERROR_TAG("ShaderCompiler", "ShaderRegistry is invalid!");
+			IR_CORE_WARN_TAG("ShaderCompiler", "ShaderRegistry is invalid or out of date, all shaders will be recompiled!");
 			return;
 		}
 
-		for (auto shader : handles)
+		for (uint32_t i = 0; i < shaderCount && stream; i++)
 		{
-			std::string path = shader["Filepath"].as<std::string>("");
+			std::string path;
+			uint32_t stageCount = 0;
+			stream.ReadString(path);
+			stream.ReadRaw<uint32_t>(stageCount);
 
-			for (auto stage : shader["Stages"])
+			std::map<VkShaderStageFlagBits, StageData>& stages = shaderCache[path];
+			for (uint32_t j = 0; j < stageCount; j++)
 			{
-				std::string stageType = stage["Stage"].as<std::string>();
-				uint32_t stageHash = stage["Hash"].as<uint32_t>(0);
-
-				StageData& stageCache = shaderCache[path][ShaderUtils::VkShaderStageFromString(stageType)];
-				stageCache.Hash = stageHash;
+				uint32_t stage = 0;
+				stream.ReadRaw<uint32_t>(stage);
+				stream.ReadRaw<uint32_t>(stages[static_cast<VkShaderStageFlagBits>(stage)].Hash);
 			}
 		}
 	}
@@ -5,12 +5,22 @@
 #include <map>
 #include <unordered_set>
 
+/*
+ * Keeps the hash of every shader stage that was compiled last so that ShaderCompiler knows which stages have to be recompiled
+ * - Read from Resources/Shaders/ShaderRegistry.cache the first time it is queried and only updated in memory after that, so it can be
+ *   queried by several compiler threads at once
+ * - Flush writes it back in a small binary format if anything changed, through a temporary file that is renamed over the old one
+ */
+
 namespace Iris {
 
 	class ShaderRegistry 
 	{
 	public:
 		static VkShaderStageFlagBits HasChanged(Ref<ShaderCompiler> shaderCompiler);
+
+		// Called once the shader library is loaded and on shutdown
+		static void Flush();
 	private:
 		// Shader filepath -> Stage(s)
 		static void Serialize(const std::map<std::string, std::map<VkShaderStageFlagBits, StageData>>& shaderCache);
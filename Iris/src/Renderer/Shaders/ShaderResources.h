@@ -103,6 +103,14 @@ namespace Iris::ShaderResources {
 		static void Deserialize(StreamReader* stream, PushConstantRange& instance) { stream->ReadRaw(instance); }
 	};
 
+	// Declared with `#pragma permutation NAME [0|1]`, compiled as a boolean specialization constant whose constant_id is its index in the shader's
+	// permutation list. Bit i of a permutation key holds the value of permutation i
+	struct ShaderPermutation
+	{
+		std::string Name;
+		bool DefaultValue = true;
+	};
+
 	struct ShaderDescriptorSet
 	{
 		std::unordered_map<uint32_t, UniformBuffer> UniformBuffers; // binding -> uniform buffer
@@ -0,0 +1,224 @@
+#include "IrisPCH.h"
+#include "SphericalHarmonics.h"
+
+#include "Core/WorkerPool.h"
+
+#include <glm/gtc/packing.hpp>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#endif
+
+namespace Iris {
+
+	// Constant factors of the real SH basis functions. The polynomial terms in the same order are:
+	// 1, y, z, x, xy, yz, 3z^2 - 1, xz, x^2 - y^2
+	static constexpr float s_SHBasisConstants[9] = { 0.282095f, 0.488603f, 0.488603f, 0.488603f, 1.092548f, 1.092548f, 0.315392f, 1.092548f, 0.546274f };
+
+	// Cosine lobe convolution of each band (PI, 2PI/3, PI/4) divided by PI
+	static constexpr float s_SHCosineLobe[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+
+	// Weighted sum of the radiance times each polynomial term, plus the sum of the weights in the last entry
+	using SHAccumulator = std::array<double, 9 * 3 + 1>;
+
+	struct CubemapFaceBasis
+	{
+		// Unnormalized direction of a texel is U * u + V * v + C with u, v in [-1, 1]. Matches GetCubeMapTexCoord in the environment compute shaders
+		glm::vec3 U, V, C;
+	};
+
+	static constexpr CubemapFaceBasis s_CubemapFaces[6] = {
+		{ {  0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f } },
+		{ {  0.0f, 0.0f,  1.0f }, { 0.0f, 1.0f,  0.0f }, { -1.0f,  0.0f,  0.0f } },
+		{ {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, -1.0f }, {  0.0f,  1.0f,  0.0f } },
+		{ {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f,  1.0f }, {  0.0f, -1.0f,  0.0f } },
+		{ {  1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f }, {  0.0f,  0.0f,  1.0f } },
+		{ { -1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f }, {  0.0f,  0.0f, -1.0f } }
+	};
+
+	namespace Utils {
+
+		// The weight is the solid angle of the texel up to a constant factor, which gets normalized away at the end
+		static void AccumulateSHTexel(SHAccumulator& rowSum, const glm::vec3& direction, float weight, const glm::vec3& radiance)
+		{
+			const glm::vec3 n = direction;
+			const float terms[9] = { 1.0f, n.y, n.z, n.x, n.x * n.y, n.y * n.z, 3.0f * n.z * n.z - 1.0f, n.x * n.z, n.x * n.x - n.y * n.y };
+
+			const glm::vec3 weightedRadiance = radiance * weight;
+			for (uint32_t i = 0; i < 9; i++)
+			{
+				rowSum[i * 3 + 0] += terms[i] * weightedRadiance.r;
+				rowSum[i * 3 + 1] += terms[i] * weightedRadiance.g;
+				rowSum[i * 3 + 2] += terms[i] * weightedRadiance.b;
+			}
+
+			rowSum[27] += weight;
+		}
+
+		static void ProjectFaceScalar(const uint16_t* face, uint32_t faceSize, const CubemapFaceBasis& basis, uint32_t firstTexel, SHAccumulator& outSum)
+		{
+			const float invSize = 1.0f / static_cast<float>(faceSize);
+			for (uint32_t y = 0; y < faceSize; y++)
+			{
+				const float v = 1.0f - (2.0f * y + 1.0f) * invSize;
+				const uint16_t* row = face + static_cast<uint64_t>(y) * faceSize * 4;
+
+				SHAccumulator rowSum = {};
+				for (uint32_t x = firstTexel; x < faceSize; x++)
+				{
+					const float u = (2.0f * x + 1.0f) * invSize - 1.0f;
+					const float invLength = 1.0f / glm::sqrt(1.0f + u * u + v * v);
+
+					const glm::vec3 direction = (basis.U * u + basis.V * v + basis.C) * invLength;
+					const glm::vec3 radiance = { glm::unpackHalf1x16(row[x * 4 + 0]), glm::unpackHalf1x16(row[x * 4 + 1]), glm::unpackHalf1x16(row[x * 4 + 2]) };
+					AccumulateSHTexel(rowSum, direction, invLength * invLength * invLength, radiance);
+				}
+
+				for (uint32_t i = 0; i < rowSum.size(); i++)
+					outSum[i] += rowSum[i];
+			}
+		}
+
+#if defined(__AVX2__)
+		static double HorizontalSum(__m256 value)
+		{
+			const __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+			const __m128 sum2 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+			return static_cast<double>(_mm_cvtss_f32(_mm_add_ss(sum2, _mm_movehdup_ps(sum2))));
+		}
+
+		// Handles 8 texels of a row at a time and returns the index of the first texel it did not get to
+		static uint32_t ProjectFaceSIMD(const uint16_t* face, uint32_t faceSize, const CubemapFaceBasis& basis, SHAccumulator& outSum)
+		{
+			const uint32_t simdTexels = faceSize & ~7u;
+			if (simdTexels == 0)
+				return 0;
+
+			const float invSize = 1.0f / static_cast<float>(faceSize);
+
+			// Transposing the RGBA texels into separate channels leaves them in this order within the registers
+			const __m256 laneOffsets = _mm256_setr_ps(0.0f, 2.0f, 4.0f, 6.0f, 1.0f, 3.0f, 5.0f, 7.0f);
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 three = _mm256_set1_ps(3.0f);
+			const __m256 twoInvSize = _mm256_set1_ps(2.0f * invSize);
+			const __m256 uOffset = _mm256_set1_ps(invSize - 1.0f);
+
+			for (uint32_t y = 0; y < faceSize; y++)
+			{
+				const float v = 1.0f - (2.0f * y + 1.0f) * invSize;
+				const __m256 vv = _mm256_set1_ps(v * v);
+				const __m256 directionX = _mm256_set1_ps(basis.V.x * v + basis.C.x), directionY = _mm256_set1_ps(basis.V.y * v + basis.C.y), directionZ = _mm256_set1_ps(basis.V.z * v + basis.C.z);
+				const __m256 ux = _mm256_set1_ps(basis.U.x), uy = _mm256_set1_ps(basis.U.y), uz = _mm256_set1_ps(basis.U.z);
+
+				const uint16_t* row = face + static_cast<uint64_t>(y) * faceSize * 4;
+
+				__m256 sums[28];
+				for (__m256& sum : sums)
+					sum = _mm256_setzero_ps();
+
+				for (uint32_t x = 0; x < simdTexels; x += 8)
+				{
+					// Two RGBA texels per register
+					const __m256 t01 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4 + 0)));
+					const __m256 t23 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4 + 8)));
+					const __m256 t45 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4 + 16)));
+					const __m256 t67 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4 + 24)));
+
+					const __m256 rg0 = _mm256_unpacklo_ps(t01, t23);
+					const __m256 ba0 = _mm256_unpackhi_ps(t01, t23);
+					const __m256 rg1 = _mm256_unpacklo_ps(t45, t67);
+					const __m256 ba1 = _mm256_unpackhi_ps(t45, t67);
+
+					const __m256 r = _mm256_shuffle_ps(rg0, rg1, _MM_SHUFFLE(1, 0, 1, 0));
+					const __m256 g = _mm256_shuffle_ps(rg0, rg1, _MM_SHUFFLE(3, 2, 3, 2));
+					const __m256 b = _mm256_shuffle_ps(ba0, ba1, _MM_SHUFFLE(1, 0, 1, 0));
+
+					const __m256 u = _mm256_fmadd_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets), twoInvSize, uOffset);
+					const __m256 invLength = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_add_ps(_mm256_fmadd_ps(u, u, vv), one)));
+					const __m256 weight = _mm256_mul_ps(_mm256_mul_ps(invLength, invLength), invLength);
+
+					const __m256 nx = _mm256_mul_ps(_mm256_fmadd_ps(ux, u, directionX), invLength);
+					const __m256 ny = _mm256_mul_ps(_mm256_fmadd_ps(uy, u, directionY), invLength);
+					const __m256 nz = _mm256_mul_ps(_mm256_fmadd_ps(uz, u, directionZ), invLength);
+
+					const __m256 terms[9] = {
+						one,
+						ny,
+						nz,
+						nx,
+						_mm256_mul_ps(nx, ny),
+						_mm256_mul_ps(ny, nz),
+						_mm256_fmsub_ps(_mm256_mul_ps(three, nz), nz, one),
+						_mm256_mul_ps(nx, nz),
+						_mm256_fmsub_ps(nx, nx, _mm256_mul_ps(ny, ny))
+					};
+
+					const __m256 wr = _mm256_mul_ps(r, weight);
+					const __m256 wg = _mm256_mul_ps(g, weight);
+					const __m256 wb = _mm256_mul_ps(b, weight);
+					for (uint32_t i = 0; i < 9; i++)
+					{
+						sums[i * 3 + 0] = _mm256_fmadd_ps(terms[i], wr, sums[i * 3 + 0]);
+						sums[i * 3 + 1] = _mm256_fmadd_ps(terms[i], wg, sums[i * 3 + 1]);
+						sums[i * 3 + 2] = _mm256_fmadd_ps(terms[i], wb, sums[i * 3 + 2]);
+					}
+
+					sums[27] = _mm256_add_ps(sums[27], weight);
+				}
+
+				for (uint32_t i = 0; i < 28; i++)
+					outSum[i] += HorizontalSum(sums[i]);
+			}
+
+			return simdTexels;
+		}
+#endif
+
+		static void ProjectFace(const uint16_t* face, uint32_t faceSize, const CubemapFaceBasis& basis, SHAccumulator& outSum)
+		{
+			uint32_t firstTexel = 0;
+#if defined(__AVX2__)
+			firstTexel = ProjectFaceSIMD(face, faceSize, basis, outSum);
+			if (firstTexel == faceSize)
+				return;
+#endif
+
+			ProjectFaceScalar(face, faceSize, basis, firstTexel, outSum);
+		}
+
+	}
+
+	SHCoefficients SphericalHarmonics::ProjectIrradiance(const uint8_t* faceData, uint32_t faceSize)
+	{
+		const uint16_t* texels = reinterpret_cast<const uint16_t*>(faceData);
+		const uint64_t faceTexelCount = static_cast<uint64_t>(faceSize) * faceSize;
+
+		// Every face gets its own sums so that nothing has to be synchronized between the workers
+		std::array<SHAccumulator, 6> faceSums = {};
+		WorkerPool::ParallelFor(6, [texels, faceTexelCount, faceSize, &faceSums](uint32_t face)
+		{
+			Utils::ProjectFace(texels + face * faceTexelCount * 4, faceSize, s_CubemapFaces[face], faceSums[face]);
+		});
+
+		SHAccumulator total = {};
+		for (const SHAccumulator& faceSum : faceSums)
+		{
+			for (uint32_t i = 0; i < total.size(); i++)
+				total[i] += faceSum[i];
+		}
+
+		// The weights over the whole sphere have to add up to 4PI
+		const double solidAngleScale = total[27] > 0.0 ? 4.0 * glm::pi<double>() / total[27] : 0.0;
+
+		SHCoefficients result = {};
+		for (uint32_t i = 0; i < 9; i++)
+		{
+			// One basis constant comes from the projection and one from evaluating the coefficient later on
+			const double scale = solidAngleScale * s_SHBasisConstants[i] * s_SHBasisConstants[i] * s_SHCosineLobe[i];
+			result[i] = glm::vec4(total[i * 3 + 0] * scale, total[i * 3 + 1] * scale, total[i * 3 + 2] * scale, 0.0f);
+		}
+
+		return result;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+/*
+ * L2 spherical harmonics representation of an environment's diffuse irradiance, used instead of the 32x32 irradiance cubemap when
+ * RendererConfiguration::SphericalHarmonicsIrradiance is on
+ * - The projection runs on the CPU over mip 0 of the radiance cubemap, one thread per face and 8 texels at a time when the build enables AVX2
+ * - The coefficients are already convolved with the cosine lobe and divided by PI so that they encode the same exitant radiance as the
+ *   EnvironmentIrradiance compute shader. The basis constants are folded in as well, so evaluating them only takes the polynomial terms
+ *   (see EvaluateIrradianceSH in IrisPBRStatic.glsl)
+ */
+
+namespace Iris {
+
+	// rgb hold the coefficient, w is padding so that the array can be copied into a std140 uniform buffer as is
+	using SHCoefficients = std::array<glm::vec4, 9>;
+
+	class SphericalHarmonics
+	{
+	public:
+		// faceData holds the six RGBA16F faces of a cubemap mip next to each other
+		static SHCoefficients ProjectIrradiance(const uint8_t* faceData, uint32_t faceSize);
+	};
+
+}
\ No newline at end of file
@@ -8,29 +8,33 @@ namespace Iris {
 	class StorageBuffer : public RefCountedObject
 	{
 	public:
-		StorageBuffer(size_t size, bool deviceLocal = true);
+		// additionalUsage is for buffers that are also consumed outside of shaders, e.g. as indirect draw arguments or as vertex buffers
+		StorageBuffer(size_t size, bool deviceLocal = true, VkBufferUsageFlags additionalUsage = 0);
 		~StorageBuffer();
 
-		[[nodiscard]] static Ref<StorageBuffer> Create(size_t size, bool deviceLocal = true);
+		[[nodiscard]] static Ref<StorageBuffer> Create(size_t size, bool deviceLocal = true, VkBufferUsageFlags additionalUsage = 0);
 
 		void Resize(uint32_t newSize);
+		// Writes `size` bytes of data at `offset` into the buffer, the rest of the buffer is left as it was
 		void SetData(const void* data, size_t size, size_t offset = 0);
 		void RT_SetData(const void* data, size_t size, size_t offset = 0);
 
 		VkDescriptorBufferInfo& GetDescriptorBufferInfo() { return m_DescriptorInfo; }
+		VkBuffer GetVulkanBuffer() const { return m_StorageBuffer; }
+		size_t GetSize() const { return m_Size; }
 
-		bool IsDeviceLocal() const { return m_StagingBuffer != nullptr; }
+		bool IsDeviceLocal() const { return m_DeviceLocal; }
 
 	private:
 		size_t m_Size = 0;
+		VkBufferUsageFlags m_AdditionalUsage = 0;
+		bool m_DeviceLocal = true; // Device local buffers are written through the UploadManager, the others are mapped directly
 		Buffer m_LocalData;
 
 		VkBuffer m_StorageBuffer = nullptr;
-		VkBuffer m_StagingBuffer = nullptr; // We store the pointer for the staging buffer so that we dont have to create it and destroy on each invalidation
 		VkDescriptorBufferInfo m_DescriptorInfo = {};
 
 		VmaAllocation m_StorageBufferAllocation = nullptr;
-		VmaAllocation m_StagingBufferAllocation = nullptr;
 	};
 
 }
\ No newline at end of file
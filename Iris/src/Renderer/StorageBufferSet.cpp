@@ -5,13 +5,13 @@
 
 namespace Iris {
 
-	StorageBufferSet::StorageBufferSet(bool deviceLocal, uint32_t size, uint32_t framesInFlight)
+	StorageBufferSet::StorageBufferSet(bool deviceLocal, uint32_t size, uint32_t framesInFlight, VkBufferUsageFlags additionalUsage)
 	{
 		if (framesInFlight == 0)
 			framesInFlight = Renderer::GetConfig().FramesInFlight;
 
 		for (uint32_t frame = 0; frame < framesInFlight; frame++)
-			m_StorageBuffers[frame] = StorageBuffer::Create(size, deviceLocal);
+			m_StorageBuffers[frame] = StorageBuffer::Create(size, deviceLocal, additionalUsage);
 	}
 
 	Ref<StorageBuffer> StorageBufferSet::Get()
@@ -9,12 +9,12 @@ namespace Iris {
 	class StorageBufferSet : public RefCountedObject
 	{
 	public:
-		StorageBufferSet(bool deviceLocal, uint32_t size, uint32_t framesInFlight);
+		StorageBufferSet(bool deviceLocal, uint32_t size, uint32_t framesInFlight, VkBufferUsageFlags additionalUsage = 0);
 		~StorageBufferSet() = default;
 
-		[[nodiscard]] inline static Ref<StorageBufferSet> Create(bool deviceLocal, uint32_t size, uint32_t framesInFlight = 0)
+		[[nodiscard]] inline static Ref<StorageBufferSet> Create(bool deviceLocal, uint32_t size, uint32_t framesInFlight = 0, VkBufferUsageFlags additionalUsage = 0)
 		{
-			return CreateRef<StorageBufferSet>(deviceLocal, size, framesInFlight);
+			return CreateRef<StorageBufferSet>(deviceLocal, size, framesInFlight, additionalUsage);
 		}
 
 		Ref<StorageBuffer> Get();
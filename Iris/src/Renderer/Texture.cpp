@@ -1,7 +1,11 @@
 #include "IrisPCH.h"
 #include "Texture.h"
 
+#include "Core/Timer.h"
 #include "Renderer.h"
+#include "Renderer/BindlessTable.h"
+#include "Renderer/Core/UploadManager.h"
+#include "Renderer/DescriptorSetManager.h"
 #include "Renderer/Core/Vulkan.h"
 #include "Utils/TextureImporter.h"
 
@@ -49,8 +53,10 @@ namespace Iris {
                 case ImageFormat::RG16F:                    return width * height * 2 * sizeof(uint16_t);
                 case ImageFormat::RG32F:                    return width * height * 2 * sizeof(float);
                 case ImageFormat::RGBA:                     return width * height * 4;
+                case ImageFormat::RGBA16F:                  return width * height * 4 * sizeof(uint16_t);
                 case ImageFormat::RGBA32F:                  return width * height * 4 * sizeof(float);
                 case ImageFormat::B10R11G11UF:              return width * height * sizeof(float);
+                case ImageFormat::E5B9G9R9UF:               return width * height * sizeof(uint32_t);
                 case ImageFormat::SRGB:                     return width * height * 3;
                 case ImageFormat::SRGBA:                    return width * height * 4;
             }
@@ -59,6 +65,134 @@ namespace Iris {
             return 0;
         }
 
+        static VkSampler CreateTextureSampler(const TextureSpecification& spec, uint32_t mipCount)
+        {
+            Ref<VulkanPhysicalDevice> physicalDevice = RendererContext::GetCurrentDevice()->GetPhysicalDevice();
+            bool enableAnisotropy = physicalDevice->GetPhysicalDeviceFeatures().samplerAnisotropy;
+            float samplerAnisotorpy = enableAnisotropy ? physicalDevice->GetPhysicalDeviceProperties().limits.maxSamplerAnisotropy : 1.0f;
+
+            VkSamplerCreateInfo samplerCI = {
+                .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+                .magFilter = GetVulkanSamplerFilter(spec.FilterMode),
+                .minFilter = GetVulkanSamplerFilter(spec.FilterMode),
+                .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+                .addressModeU = GetVulkanSamplerWrap(spec.WrapMode),
+                .addressModeV = GetVulkanSamplerWrap(spec.WrapMode),
+                .addressModeW = GetVulkanSamplerWrap(spec.WrapMode),
+                .mipLodBias = 0.0f,
+                .anisotropyEnable = enableAnisotropy,
+                .maxAnisotropy = samplerAnisotorpy,
+                .compareEnable = VK_FALSE,
+                .compareOp = VK_COMPARE_OP_NEVER,
+                .minLod = 0.0f,
+                .maxLod = static_cast<float>(mipCount),
+                .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
+                // Use coordinate system [0, 1) in order to access texels in the texture instead of [0, textureWidth)
+                .unnormalizedCoordinates = VK_FALSE
+            };
+
+            VkSampler sampler = nullptr;
+            VK_CHECK_RESULT(vkCreateSampler(RendererContext::GetCurrentDevice()->GetVulkanDevice(), &samplerCI, nullptr, &sampler));
+            return sampler;
+        }
+
+        // Textures smaller than this are never streamed, and streaming textures always keep the mips from this size downwards resident
+        static constexpr uint32_t s_StreamingTailSize = 128;
+
+        static float SRGBToLinear(uint8_t value)
+        {
+            static const std::array<float, 256> s_Table = []()
+            {
+                std::array<float, 256> table;
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    const float srgb = static_cast<float>(i) / 255.0f;
+                    table[i] = srgb <= 0.04045f ? srgb / 12.92f : glm::pow((srgb + 0.055f) / 1.055f, 2.4f);
+                }
+                return table;
+            }();
+
+            return s_Table[value];
+        }
+
+        static uint8_t LinearToSRGB(float value)
+        {
+            const float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * glm::pow(value, 1.0f / 2.4f) - 0.055f;
+            return static_cast<uint8_t>(glm::clamp(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+
+        // Box filters the whole mip chain on the CPU. The mips are written one after the other right after mip 0 which has to be in data already
+        // sRGB color channels are averaged in linear space, otherwise the mips come out darker than the texture
+        template<typename T>
+        static void GenerateMipChain(T* data, uint32_t width, uint32_t height, uint32_t mipCount, bool srgb = false)
+        {
+            constexpr uint32_t channels = 4;
+
+            T* src = data;
+            for (uint32_t mip = 1; mip < mipCount; mip++)
+            {
+                const uint32_t srcWidth = width >> (mip - 1);
+                const uint32_t srcHeight = height >> (mip - 1);
+                const uint32_t dstWidth = width >> mip;
+                const uint32_t dstHeight = height >> mip;
+
+                T* dst = src + static_cast<std::size_t>(srcWidth) * srcHeight * channels;
+                for (uint32_t y = 0; y < dstHeight; y++)
+                {
+                    // Odd sizes just clamp the last row/column
+                    const T* row0 = src + static_cast<std::size_t>(glm::min(y * 2, srcHeight - 1)) * srcWidth * channels;
+                    const T* row1 = src + static_cast<std::size_t>(glm::min(y * 2 + 1, srcHeight - 1)) * srcWidth * channels;
+
+                    for (uint32_t x = 0; x < dstWidth; x++)
+                    {
+                        const uint32_t x0 = glm::min(x * 2, srcWidth - 1) * channels;
+                        const uint32_t x1 = glm::min(x * 2 + 1, srcWidth - 1) * channels;
+
+                        T* texel = dst + (static_cast<std::size_t>(y) * dstWidth + x) * channels;
+                        for (uint32_t c = 0; c < channels; c++)
+                        {
+                            if constexpr (std::is_floating_point_v<T>)
+                                texel[c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+                            else if (srgb && c < 3)
+                                texel[c] = LinearToSRGB((SRGBToLinear(row0[x0 + c]) + SRGBToLinear(row0[x1 + c]) + SRGBToLinear(row1[x0 + c]) + SRGBToLinear(row1[x1 + c])) * 0.25f);
+                            else
+                                texel[c] = static_cast<T>((static_cast<uint32_t>(row0[x0 + c]) + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+                        }
+                    }
+                }
+
+                src = dst;
+            }
+        }
+
+        // Copies the image into a buffer big enough for the whole chain and generates the mips. format is RGBA, SRGBA or RGBA32F
+        static Buffer BuildMipChain(const Buffer& image, ImageFormat format, uint32_t width, uint32_t height, uint32_t mipCount)
+        {
+            const uint64_t texelSize = format == ImageFormat::RGBA32F ? 4 * sizeof(float) : 4;
+
+            uint64_t size = 0;
+            for (uint32_t mip = 0; mip < mipCount; mip++)
+                size += static_cast<uint64_t>(width >> mip) * (height >> mip) * texelSize;
+
+            Buffer mipChain;
+            mipChain.Allocate(size);
+            std::memcpy(mipChain.Data, image.Data, image.Size);
+
+            if (format == ImageFormat::RGBA32F)
+                GenerateMipChain(reinterpret_cast<float*>(mipChain.Data), width, height, mipCount);
+            else
+                GenerateMipChain(mipChain.Data, width, height, mipCount, format == ImageFormat::SRGBA);
+
+            return mipChain;
+        }
+
+        // The TextureImporter reports every 8 bit image as RGBA, textures that asked for sRGB keep it
+        static void KeepSRGBFormat(ImageFormat requestedFormat, ImageFormat& format)
+        {
+            if (requestedFormat == ImageFormat::SRGBA && format == ImageFormat::RGBA)
+                format = ImageFormat::SRGBA;
+        }
+
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -98,16 +232,24 @@ namespace Iris {
         Utils::ValidateSpecification(m_Specification);
 
         // Load image from file
+        const ImageFormat requestedFormat = m_Specification.Format;
         m_ImageData = Utils::TextureImporter::LoadImageFromFile(m_AssetPath, m_Specification.Format, m_Specification.Width, m_Specification.Height);
         if (!m_ImageData)
         {
             m_ImageData = Utils::TextureImporter::LoadImageFromFile("assets/textures/cap.jpg", m_Specification.Format, m_Specification.Width, m_Specification.Height);
+
+            // The fallback image can not stand in for the file when the mips are decoded again
+            m_Specification.Streaming = false;
         }
+        Utils::KeepSRGBFormat(requestedFormat, m_Specification.Format);
 
         // If the image is an attachment then we do not want any mips
         m_Specification.GenerateMips = m_Specification.Usage == ImageUsage::Attachment ? false : m_Specification.GenerateMips;
         m_Specification.Mips = m_Specification.GenerateMips ? GetMipLevelCount() : 1;
 
+        InitializeStreaming(true);
+        ConvertHDRImageData();
+
         IR_VERIFY(m_Specification.Format != ImageFormat::None);
 
         Invalidate(commandBuffer);
@@ -119,24 +261,34 @@ namespace Iris {
         // Load image from memory
         if (m_Specification.Height == 0)
         {
+            const ImageFormat requestedFormat = m_Specification.Format;
             m_ImageData = Utils::TextureImporter::LoadImageFromMemory(imageData, m_Specification.Format, m_Specification.Width, m_Specification.Height);
             if (!m_ImageData)
             {
                 constexpr uint32_t errorTextureData = 0xff0000ff;
                 m_ImageData = Buffer((uint8_t*)&errorTextureData, sizeof(uint32_t));
             }
+            Utils::KeepSRGBFormat(requestedFormat, m_Specification.Format);
 
             Utils::ValidateSpecification(m_Specification);
+            InitializeStreaming(true);
+            ConvertHDRImageData();
+
+            // Kept encoded so that dropped mips can be decoded again, a lot smaller than keeping the decoded mips around
+            if (m_Specification.Streaming)
+                m_StreamingSource = Buffer::Copy(imageData);
         }
         else if (imageData)
         {
             Utils::ValidateSpecification(m_Specification);
             uint32_t size = static_cast<uint32_t>(Utils::GetMemorySize(m_Specification.Format, m_Specification.Width, m_Specification.Height));
             m_ImageData = Buffer::Copy(imageData);
+            InitializeStreaming(false);
         }
         else // Fallback
         {
-            if (m_Specification.Usage != ImageUsage::Attachment)
+            // Storage images get written by compute shaders so there is nothing to upload
+            if (m_Specification.Usage != ImageUsage::Attachment && m_Specification.Usage != ImageUsage::Storage)
             {
                 Utils::ValidateSpecification(m_Specification);
                 uint32_t size = static_cast<uint32_t>(Utils::GetMemorySize(m_Specification.Format, m_Specification.Width, m_Specification.Height));
@@ -154,7 +306,100 @@ namespace Iris {
 
     Texture2D::~Texture2D()
     {
+        BindlessTable::ReleaseTexture(this);
         Release();
+
+        // Streaming textures keep the mips that are not resident around to page them in from
+        if (m_Specification.Streaming)
+        {
+            m_ImageData.Release();
+            for (Buffer& mip : m_StreamingMips)
+                mip.Release();
+            m_StreamingSource.Release();
+        }
+    }
+
+    void Texture2D::InitializeStreaming(bool decodedImage)
+    {
+        if (!m_Specification.Streaming)
+            return;
+
+        // Only the formats the TextureImporter decodes to can have their mips built on the CPU, and small textures are not worth streaming
+        const char* optOutReason = nullptr;
+        if (!m_ImageData)
+            optOutReason = "no image data";
+        else if (m_Specification.Format != ImageFormat::RGBA && m_Specification.Format != ImageFormat::SRGBA && m_Specification.Format != ImageFormat::RGBA32F)
+            optOutReason = "unsupported format";
+        else if (!m_Specification.GenerateMips || m_Specification.Usage != ImageUsage::Texture)
+            optOutReason = "not a mipmapped texture";
+        else if (glm::max(m_Specification.Width, m_Specification.Height) <= Utils::s_StreamingTailSize)
+            optOutReason = "smaller than the streaming tail";
+
+        if (optOutReason)
+        {
+            IR_CORE_WARN_TAG("Renderer", "Texture '{}' ({}x{}, format {}) is not streamed: {}", m_Specification.DebugName, m_Specification.Width, m_Specification.Height,
+                static_cast<int>(m_Specification.Format), optOutReason);
+            m_Specification.Streaming = false;
+            return;
+        }
+
+        m_StreamingSourceFormat = m_Specification.Format;
+        Buffer mipChain = Utils::BuildMipChain(m_ImageData, m_Specification.Format, m_Specification.Width, m_Specification.Height, GetMipLevelCount());
+
+        if (decodedImage)
+            Utils::TextureImporter::FreeImageMemory(m_ImageData.Data);
+        else
+            m_ImageData.Release();
+        m_ImageData = mipChain;
+    }
+
+    void Texture2D::ConvertHDRImageData()
+    {
+        if (m_Specification.Format != ImageFormat::RGBA32F || m_Specification.HDRFormat == ImageFormat::RGBA32F || !m_ImageData)
+            return;
+
+        // Streaming textures already have their mip chain built on the CPU, otherwise the mips are blitted which shared exponent images do not support
+        // and the packed float formats only might (blitting to them is optional), RGBA16F has to support it so that is what those fall back to
+        ImageFormat format = m_Specification.HDRFormat;
+        if (m_Specification.GenerateMips && !m_Specification.Streaming)
+        {
+            if (format == ImageFormat::E5B9G9R9UF)
+                format = ImageFormat::B10R11G11UF;
+
+            VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+            if (m_Specification.FilterMode == TextureFilter::Linear)
+                blitFeatures |= VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+            Ref<VulkanPhysicalDevice> physicalDevice = RendererContext::GetCurrentDevice()->GetPhysicalDevice();
+            if (!physicalDevice->IsFormatFeatureSupported(Utils::GetVulkanImageFormat(format), blitFeatures))
+            {
+                IR_CORE_WARN_TAG("Renderer", "HDR texture '{}': mips can not be blitted in format {}, falling back to RGBA16F", m_Specification.DebugName, static_cast<int>(format));
+                format = ImageFormat::RGBA16F;
+            }
+        }
+
+        const uint64_t sourceSize = m_ImageData.Size;
+
+#ifdef IR_CONFIG_DEBUG
+        Timer conversionTimer;
+        Utils::HDRConversionError conversionError;
+        m_ImageData = Utils::TextureImporter::ConvertHDRImage(m_ImageData, format, &conversionError);
+        IR_CORE_TRACE_TAG("Renderer", "Converted HDR texture '{}' to {} in {:.2f}ms: {} -> {} bytes, mean relative error {:.4f}%, max relative error {:.4f}%", m_Specification.DebugName,
+            static_cast<int>(format), conversionTimer.ElapsedMillis(), sourceSize, m_ImageData.Size, conversionError.MeanRelativeError * 100.0f, conversionError.MaxRelativeError * 100.0f);
+        IR_ASSERT(conversionError.MaxRelativeError <= Utils::TextureImporter::GetHDRConversionErrorBound(format), "HDR conversion is less precise than the format allows!");
+#else
+        m_ImageData = Utils::TextureImporter::ConvertHDRImage(m_ImageData, format);
+#endif
+
+        m_Specification.Format = format;
+
+        // The streamed mip chain stays around for as long as the texture does so it gets shrunk down, the others are released after their upload
+        if (m_Specification.Streaming)
+        {
+            Buffer converted = Buffer::Copy(m_ImageData);
+            m_ImageData.Release();
+            m_ImageData = converted;
+        }
     }
 
     void Texture2D::Invalidate(VkCommandBuffer commandBuffer)
@@ -166,7 +411,37 @@ namespace Iris {
 
         uint32_t mipCount = m_Specification.GenerateMips ? GetMipLevelCount() : 1;
 
-        Ref<VulkanDevice> logicalDevice = RendererContext::GetCurrentDevice();
+        if (m_Specification.Streaming)
+        {
+            if (m_ImageData)
+            {
+                std::scoped_lock<std::mutex> lock(m_StreamingMutex);
+                m_StreamingMips.resize(mipCount);
+                StoreStreamingMips(m_ImageData, mipCount);
+                m_ImageData.Release();
+            }
+
+            // Only the tail of the mip chain is uploaded here, the TextureStreamer pages in the rest once the texture shows up on screen
+            StreamedImage image = CreateStreamedImage(GetStreamingTailMip());
+            m_Image = image.Image;
+            m_ImageView = image.ImageView;
+            m_MemoryAllocation = image.MemoryAllocation;
+            m_GPUMemorySize = image.GPUMemorySize;
+            m_ResidentMip = image.FirstMip;
+
+            if (m_Specification.CreateSampler)
+                m_Sampler = Utils::CreateTextureSampler(m_Specification, mipCount);
+
+            m_DescriptorInfo = VkDescriptorImageInfo{
+                .sampler = m_Sampler,
+                .imageView = m_ImageView,
+                .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            };
+            DescriptorSetManager::OnResourceInvalidated();
+
+            return;
+        }
+
         VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
         VulkanAllocator allocator("Texture2D");
 
@@ -184,11 +459,10 @@ namespace Iris {
         {
             usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
         }
-        // TODO: Storage Images will be their own thing
-        // if (m_Specification.Usage == ImageUsage::Storage)
-        // {
-        //     usage |= VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        // }
+        if (m_Specification.Usage == ImageUsage::Storage)
+        {
+            usage |= VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
 
         VkImageAspectFlags aspectMask = Utils::IsDepthFormat(m_Specification.Format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
         if (m_Specification.Format == ImageFormat::DEPTH32FSTENCIL8UINT || m_Specification.Format == ImageFormat::DEPTH24STENCIL8)
@@ -213,77 +487,17 @@ namespace Iris {
         VkDeviceSize gpuAllocationSize = 0;
         constexpr VmaMemoryUsage memUsage = VMA_MEMORY_USAGE_GPU_ONLY;
         m_MemoryAllocation = allocator.AllocateImage(&imageCI, memUsage, &m_Image, &gpuAllocationSize);
+        m_GPUMemorySize = gpuAllocationSize;
         VKUtils::SetDebugUtilsObjectName(device, VK_OBJECT_TYPE_IMAGE, m_Specification.DebugName, m_Image);
 
+        bool mipsRecorded = false;
         if (m_ImageData && m_Specification.Usage != ImageUsage::Attachment)
         {
-            VkBuffer stagingBuffer;
-            VkBufferCreateInfo stagingBufferCI = {
-                .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-                .size = m_ImageData.Size,
-                .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                .sharingMode = VK_SHARING_MODE_EXCLUSIVE
-            };
-            VmaAllocation stagingBufferAlloc = allocator.AllocateBuffer(&stagingBufferCI, VMA_MEMORY_USAGE_CPU_TO_GPU, &stagingBuffer);
-
-            uint8_t* dstData = allocator.MapMemory<uint8_t>(stagingBufferAlloc);
-            std::memcpy(dstData, m_ImageData.Data, m_ImageData.Size);
-            allocator.UnmapMemory(stagingBufferAlloc);
-
-            // At this point the image data is on the gpu in the staging buffer so we dont need it on the cpu side anymore so we release
-            Utils::TextureImporter::FreeImageMemory(m_ImageData.Data);
-            m_ImageData.Size = 0;
-
-            /*
-             * Layout Transitions and data copy
-             * Transition image layout from IMAGE_LAYOUT_UNDEFINED -> IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL -> IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-             * First Transition to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-             * Pipeline Barriers are used to synchronize access to resources... 
-             * They ensure that a resource finished doing something before doing something else
-             * *** Certain edge cases to handle with src/dstAccessMask ***
-             * if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-             * {
-             *      barrier.srcAccessMask = 0;
-             *      barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-             *      sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-             *      destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-             * }
-             * else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-             * {
-             *      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-             *      barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-             *      sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-             *      destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-             * }
-             */
-
-            bool manualCommandBuffer = false;
-            if (!commandBuffer)
-            {
-                commandBuffer = logicalDevice->GetCommandBuffer(true);
-                manualCommandBuffer = true;
-            }
-
-            // https://themaister.net/blog/2019/08/14/yet-another-blog-explaining-vulkan-synchronization/ (ImageMemoryBarriers)
-            // https://gpuopen.com/learn/vulkan-barriers-explained/ (TOP_OF_PIPE and BOTTOM_OF_PIPE)
-
-            Renderer::InsertImageMemoryBarrier(
-                commandBuffer,
-                m_Image,
-                0,
-                VK_ACCESS_2_TRANSFER_WRITE_BIT,
-                VK_IMAGE_LAYOUT_UNDEFINED,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, // Wait for nothing
-                VK_PIPELINE_STAGE_2_TRANSFER_BIT, // Unblock transfer operations after this transition is done
-                { 
-                    .aspectMask = aspectMask, 
-                    .baseMipLevel = 0,
-                    .levelCount = 1, // Transition only the original image to TRANSFER_DST_OPTIMAL. We should not touch the mips here...
-                    .baseArrayLayer = 0,
-                    .layerCount = 1
-                }
-            );
+            VkImageLayout finalImageLayout;
+            if (m_Specification.Format == ImageFormat::DEPTH24STENCIL8 || m_Specification.Format == ImageFormat::DEPTH32FSTENCIL8UINT)
+                finalImageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            else
+                finalImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
             // Copy image
             VkBufferImageCopy copyRegion = {
@@ -300,54 +514,133 @@ namespace Iris {
                 .imageExtent = { .width = m_Specification.Width, .height = m_Specification.Height, .depth = 1u }
             };
 
-            vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
-
-            VkImageLayout finalImageLayout;
-            if (m_Specification.Format == ImageFormat::DEPTH24STENCIL8 || m_Specification.Format == ImageFormat::DEPTH32FSTENCIL8UINT)
-                finalImageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            if (!commandBuffer)
+            {
+                // Batched with the other uploads and submitted ahead of the next vkQueueSubmit instead of flushing a one time command buffer
+                // The mips are generated in the same batch so the original image is left as a transfer src for the blits
+                ImageUploadInfo uploadInfo = {
+                    .Image = m_Image,
+                    .SubresourceRange = { .aspectMask = aspectMask, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 },
+                    .FinalLayout = mipCount > 1 ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : finalImageLayout,
+                    .Data = m_ImageData.Data,
+                    .Size = m_ImageData.Size,
+                    .TexelSize = Utils::GetImageFormatBPP(m_Specification.Format),
+                    .Regions = &copyRegion,
+                    .RegionCount = 1
+                };
+
+                std::function<void(VkCommandBuffer)> generateMips;
+                if (mipCount > 1)
+                    generateMips = [this](VkCommandBuffer uploadCommandBuffer) { GenerateMips(uploadCommandBuffer); };
+
+                UploadManager::UploadImage(uploadInfo, generateMips);
+                mipsRecorded = true;
+            }
             else
-                finalImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-            // Conditionally transtition if we have mips or not
-            if (mipCount > 1)
             {
+                VkBuffer stagingBuffer;
+                VkBufferCreateInfo stagingBufferCI = {
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                    .size = m_ImageData.Size,
+                    .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+                };
+                VmaAllocation stagingBufferAlloc = allocator.AllocateBuffer(&stagingBufferCI, VMA_MEMORY_USAGE_CPU_TO_GPU, &stagingBuffer);
+
+                uint8_t* dstData = allocator.MapMemory<uint8_t>(stagingBufferAlloc);
+                std::memcpy(dstData, m_ImageData.Data, m_ImageData.Size);
+                allocator.UnmapMemory(stagingBufferAlloc);
+
+                /*
+                 * Layout Transitions and data copy
+                 * Transition image layout from IMAGE_LAYOUT_UNDEFINED -> IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL -> IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                 * First Transition to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                 * Pipeline Barriers are used to synchronize access to resources... 
+                 * They ensure that a resource finished doing something before doing something else
+                 * *** Certain edge cases to handle with src/dstAccessMask ***
+                 * if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+                 * {
+                 *      barrier.srcAccessMask = 0;
+                 *      barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                 *      sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                 *      destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                 * }
+                 * else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+                 * {
+                 *      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                 *      barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                 *      sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                 *      destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                 * }
+                 */
+
+                // https://themaister.net/blog/2019/08/14/yet-another-blog-explaining-vulkan-synchronization/ (ImageMemoryBarriers)
+                // https://gpuopen.com/learn/vulkan-barriers-explained/ (TOP_OF_PIPE and BOTTOM_OF_PIPE)
+
                 Renderer::InsertImageMemoryBarrier(
                     commandBuffer,
                     m_Image,
+                    0,
                     VK_ACCESS_2_TRANSFER_WRITE_BIT,
-                    VK_ACCESS_2_TRANSFER_READ_BIT,
-                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                    VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-                    VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-                    // Here we transition only the original image to a transfer src since the generate mips starts from the first mip
-                    // All the other mips (which yet do not exist) are still in IMAGE_LAYOUT_UNDEFINED untill now...
-                    { .aspectMask = aspectMask, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
-                );
-            }
-            else
-            {
-                // Second Layout Transition
-                Renderer::InsertImageMemoryBarrier(
-                    commandBuffer, 
-                    m_Image, 
-                    VK_ACCESS_2_TRANSFER_WRITE_BIT, 
-                    VK_ACCESS_2_SHADER_READ_BIT, 
+                    VK_IMAGE_LAYOUT_UNDEFINED,
                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    finalImageLayout,
-                    VK_PIPELINE_STAGE_2_TRANSFER_BIT, // Wait for transfer opration to finish
-                    manualCommandBuffer ? VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, // Unblock all fragment shader operations after this transfer is done
-                    { .aspectMask = aspectMask, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
+                    VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, // Wait for nothing
+                    VK_PIPELINE_STAGE_2_TRANSFER_BIT, // Unblock transfer operations after this transition is done
+                    { 
+                        .aspectMask = aspectMask, 
+                        .baseMipLevel = 0,
+                        .levelCount = 1, // Transition only the original image to TRANSFER_DST_OPTIMAL. We should not touch the mips here...
+                        .baseArrayLayer = 0,
+                        .layerCount = 1
+                    }
                 );
-            }
 
-            if (manualCommandBuffer)
-            {
-                logicalDevice->FlushCommandBuffer(commandBuffer);
-                commandBuffer = nullptr;
+                vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+                // Conditionally transtition if we have mips or not
+                if (mipCount > 1)
+                {
+                    Renderer::InsertImageMemoryBarrier(
+                        commandBuffer,
+                        m_Image,
+                        VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                        VK_ACCESS_2_TRANSFER_READ_BIT,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                        VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                        // Here we transition only the original image to a transfer src since the generate mips starts from the first mip
+                        // All the other mips (which yet do not exist) are still in IMAGE_LAYOUT_UNDEFINED untill now...
+                        { .aspectMask = aspectMask, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
+                    );
+                }
+                else
+                {
+                    // Second Layout Transition
+                    Renderer::InsertImageMemoryBarrier(
+                        commandBuffer, 
+                        m_Image, 
+                        VK_ACCESS_2_TRANSFER_WRITE_BIT, 
+                        VK_ACCESS_2_SHADER_READ_BIT, 
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        finalImageLayout,
+                        VK_PIPELINE_STAGE_2_TRANSFER_BIT, // Wait for transfer opration to finish
+                        VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, // Unblock all shader reads after this transfer is done
+                        { .aspectMask = aspectMask, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
+                    );
+                }
+
+                // The caller submits the command buffer later so the staging buffer has to live untill that frame is done
+                Renderer::SubmitReseourceFree([stagingBuffer, stagingBufferAlloc]()
+                {
+                    VulkanAllocator allocator("Texture2D");
+                    allocator.DestroyBuffer(stagingBufferAlloc, stagingBuffer);
+                });
             }
 
-            allocator.DestroyBuffer(stagingBufferAlloc, stagingBuffer);
+            // At this point the image data is in staging memory so we dont need it on the cpu side anymore so we release
+            Utils::TextureImporter::FreeImageMemory(m_ImageData.Data);
+            m_ImageData.Size = 0;
         }
         // else
         // {
@@ -380,34 +673,8 @@ namespace Iris {
         // images however in playground each texture could own its own sampler
         // Attachment images will have samplers which allows the user to sample from them in another pass if they want
         if (m_Specification.CreateSampler)
-        {
-            Ref<VulkanPhysicalDevice> physicalDevice = RendererContext::GetCurrentDevice()->GetPhysicalDevice();
-            bool enableAnisotropy = physicalDevice->GetPhysicalDeviceFeatures().samplerAnisotropy;
-            float samplerAnisotorpy = enableAnisotropy ? physicalDevice->GetPhysicalDeviceProperties().limits.maxSamplerAnisotropy : 1.0f;
+            m_Sampler = Utils::CreateTextureSampler(m_Specification, mipCount);
 
-            VkSamplerCreateInfo samplerCI = {
-                .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-                .magFilter = Utils::GetVulkanSamplerFilter(m_Specification.FilterMode),
-                .minFilter = Utils::GetVulkanSamplerFilter(m_Specification.FilterMode),
-                .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
-                .addressModeU = Utils::GetVulkanSamplerWrap(m_Specification.WrapMode),
-                .addressModeV = Utils::GetVulkanSamplerWrap(m_Specification.WrapMode),
-                .addressModeW = Utils::GetVulkanSamplerWrap(m_Specification.WrapMode),
-                .mipLodBias = 0.0f,
-                .anisotropyEnable = enableAnisotropy,
-                .maxAnisotropy = samplerAnisotorpy,
-                .compareEnable = VK_FALSE,
-                .compareOp = VK_COMPARE_OP_NEVER,
-                .minLod = 0.0f,
-                .maxLod = static_cast<float>(mipCount),
-                .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
-                // Use coordinate system [0, 1) in order to access texels in the texture instead of [0, textureWidth)
-                .unnormalizedCoordinates = VK_FALSE
-            };
-
-            VK_CHECK_RESULT(vkCreateSampler(device, &samplerCI, nullptr, &m_Sampler));
-        }
-        
         // Update image descriptor info
         VkImageLayout finalImageLayout;
         if (m_Specification.Format == ImageFormat::DEPTH24STENCIL8 || m_Specification.Format == ImageFormat::DEPTH32FSTENCIL8UINT)
@@ -415,13 +682,36 @@ namespace Iris {
         else
             finalImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
+        // Storage images never leave the general layout so that compute shaders can write some mips while sampling others
+        if (m_Specification.Usage == ImageUsage::Storage)
+        {
+            finalImageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            VkCommandBuffer transitionCommandBuffer = commandBuffer ? commandBuffer : RendererContext::GetCurrentDevice()->GetCommandBuffer(true);
+            Renderer::InsertImageMemoryBarrier(
+                transitionCommandBuffer,
+                m_Image,
+                0,
+                VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+                VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                { .aspectMask = aspectMask, .baseMipLevel = 0, .levelCount = mipCount, .baseArrayLayer = 0, .layerCount = 1 }
+            );
+
+            if (!commandBuffer)
+                RendererContext::GetCurrentDevice()->FlushCommandBuffer(transitionCommandBuffer);
+        }
+
         m_DescriptorInfo = VkDescriptorImageInfo{
             .sampler = m_Sampler,
             .imageView = m_ImageView,
             .imageLayout = finalImageLayout
         };
+        DescriptorSetManager::OnResourceInvalidated();
 
-        if (m_Specification.GenerateMips && mipCount > 1)
+        if (m_Specification.GenerateMips && mipCount > 1 && !mipsRecorded && m_Specification.Usage != ImageUsage::Storage)
             GenerateMips(commandBuffer);
     }
 
@@ -466,7 +756,7 @@ namespace Iris {
                 VK_ACCESS_2_TRANSFER_WRITE_BIT, // Before the blit we will write and after the blit we will read
                 VK_IMAGE_LAYOUT_UNDEFINED, // Here it is UNDEFINED since when we copy the 
                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                manualCommandBuffer ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
                 VK_PIPELINE_STAGE_2_TRANSFER_BIT,
                 mipSubResourceRange
             );
@@ -522,7 +812,7 @@ namespace Iris {
             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
             VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-            manualCommandBuffer ? VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
             { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .levelCount = mipCount, .layerCount = 1 }
         );
 
@@ -555,7 +845,30 @@ namespace Iris {
         if (m_Specification.CreateSampler)
             m_Sampler = nullptr;
         m_MemoryAllocation = nullptr;
+        m_GPUMemorySize = 0;
+        m_ResidentMip = 0;
         m_DescriptorInfo = {};
+        DescriptorSetManager::OnResourceInvalidated();
+
+        if (m_Specification.Streaming)
+        {
+            std::scoped_lock<std::mutex> lock(m_StreamingMutex);
+            m_LatestStreamedImage = {};
+        }
+    }
+
+    Ref<ImageView> Texture2D::CreateImageViewSingleMip(uint32_t mip)
+    {
+        IR_ASSERT(mip < GetMipLevelCount());
+
+        ImageViewSpecification imageViewSpec = {
+            .DebugName = fmt::format("{}{}{}", m_Specification.DebugName, "imageViewMip", mip),
+            .Image = this,
+            .Mip = mip
+        };
+        Ref<ImageView> result = ImageView::Create(imageViewSpec, false);
+
+        return result;
     }
 
     void Texture2D::CopyToHostBuffer(Buffer& buffer, bool writeMips, VkCommandBuffer commandBuffer) const
@@ -695,6 +1008,11 @@ namespace Iris {
         allocator.DestroyBuffer(stagingBufferAllocation, stagingBuffer);
     }
 
+    uint32_t Texture2D::GetBindlessIndex()
+    {
+        return BindlessTable::RegisterTexture(this);
+    }
+
     uint32_t Texture2D::GetMipLevelCount() const
     {
         return m_Specification.GenerateMips ? Utils::CalculateMipCount(m_Specification.Width, m_Specification.Height) : 1;
@@ -715,6 +1033,278 @@ namespace Iris {
         return { width, height };
     }
 
+    uint32_t Texture2D::GetStreamingTailMip() const
+    {
+        const uint32_t mipCount = GetMipLevelCount();
+
+        uint32_t tailMip = 0;
+        while (tailMip + 1 < mipCount && glm::max(m_Specification.Width >> tailMip, m_Specification.Height >> tailMip) > Utils::s_StreamingTailSize)
+            ++tailMip;
+
+        return tailMip;
+    }
+
+    uint64_t Texture2D::GetMipChainMemorySize(uint32_t firstMip) const
+    {
+        uint64_t size = 0;
+        for (uint32_t mip = firstMip; mip < GetMipLevelCount(); mip++)
+        {
+            const glm::ivec2 mipSize = GetMipSize(mip);
+            size += static_cast<uint64_t>(mipSize.x) * mipSize.y * Utils::GetImageFormatBPP(m_Specification.Format);
+        }
+
+        return size;
+    }
+
+    Texture2D::StreamedImage Texture2D::CreateStreamedImage(uint32_t firstMip)
+    {
+        IR_ASSERT(m_Specification.Streaming);
+
+        std::scoped_lock<std::mutex> lock(m_StreamingMutex);
+
+        Ref<VulkanDevice> logicalDevice = RendererContext::GetCurrentDevice();
+        VkDevice device = logicalDevice->GetVulkanDevice();
+        VulkanAllocator allocator("Texture2D");
+
+        const uint32_t mipLevelCount = GetMipLevelCount();
+
+        // Everything the newest image already holds is copied over on the GPU, only the mips above that come from the CPU
+        const StreamedImage sourceImage = m_LatestStreamedImage;
+        const uint32_t gpuFirstMip = sourceImage.Image ? glm::max(firstMip, sourceImage.FirstMip) : mipLevelCount;
+
+        bool cpuMipsAvailable = true;
+        for (uint32_t mip = firstMip; mip < gpuFirstMip; mip++)
+            cpuMipsAvailable = cpuMipsAvailable && m_StreamingMips[mip];
+
+        if (!cpuMipsAvailable && !ReloadStreamingMips(gpuFirstMip))
+        {
+            IR_CORE_ERROR_TAG("Renderer", "Could not decode '{}' again, mip {} stays unavailable", m_Specification.DebugName, firstMip);
+            IR_VERIFY(sourceImage.Image);
+            firstMip = gpuFirstMip;
+        }
+
+        const uint32_t mipCount = mipLevelCount - firstMip;
+        const uint32_t cpuMipCount = gpuFirstMip - firstMip;
+        const glm::ivec2 size = GetMipSize(firstMip);
+        const VkFormat format = Utils::GetVulkanImageFormat(m_Specification.Format);
+
+        StreamedImage result = { .FirstMip = firstMip };
+
+        VkImageCreateInfo imageCI = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .flags = 0,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = format,
+            .extent = { .width = static_cast<uint32_t>(size.x), .height = static_cast<uint32_t>(size.y), .depth = 1u },
+            .mipLevels = mipCount,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        VkDeviceSize gpuAllocationSize = 0;
+        result.MemoryAllocation = allocator.AllocateImage(&imageCI, VMA_MEMORY_USAGE_GPU_ONLY, &result.Image, &gpuAllocationSize);
+        result.GPUMemorySize = gpuAllocationSize;
+        VKUtils::SetDebugUtilsObjectName(device, VK_OBJECT_TYPE_IMAGE, fmt::format("{} (Mip {})", m_Specification.DebugName, firstMip), result.Image);
+
+        // The resident mips are copied after the upload on the graphics queue, that is also where the source image is being sampled
+        std::function<void(VkCommandBuffer)> copyResidentMips;
+        if (cpuMipCount < mipCount)
+        {
+            std::vector<VkImageCopy> imageCopies;
+            for (uint32_t mip = gpuFirstMip; mip < mipLevelCount; mip++)
+            {
+                const glm::ivec2 mipSize = GetMipSize(mip);
+                imageCopies.push_back({
+                    .srcSubresource = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = mip - sourceImage.FirstMip, .baseArrayLayer = 0, .layerCount = 1 },
+                    .srcOffset = { 0, 0, 0 },
+                    .dstSubresource = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = mip - firstMip, .baseArrayLayer = 0, .layerCount = 1 },
+                    .dstOffset = { 0, 0, 0 },
+                    .extent = { static_cast<uint32_t>(mipSize.x), static_cast<uint32_t>(mipSize.y), 1u }
+                });
+            }
+
+            const VkImageSubresourceRange srcRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = gpuFirstMip - sourceImage.FirstMip, .levelCount = mipCount - cpuMipCount, .baseArrayLayer = 0, .layerCount = 1 };
+            const VkImageSubresourceRange dstRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = cpuMipCount, .levelCount = mipCount - cpuMipCount, .baseArrayLayer = 0, .layerCount = 1 };
+
+            copyResidentMips = [srcImage = sourceImage.Image, dstImage = result.Image, srcRange, dstRange, imageCopies](VkCommandBuffer commandBuffer)
+            {
+                Renderer::InsertImageMemoryBarrier(commandBuffer, srcImage, VK_ACCESS_2_SHADER_READ_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT, srcRange);
+                Renderer::InsertImageMemoryBarrier(commandBuffer, dstImage, 0, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT, dstRange);
+
+                vkCmdCopyImage(commandBuffer, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    static_cast<uint32_t>(imageCopies.size()), imageCopies.data());
+
+                Renderer::InsertImageMemoryBarrier(commandBuffer, srcImage, VK_ACCESS_2_TRANSFER_READ_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, srcRange);
+                Renderer::InsertImageMemoryBarrier(commandBuffer, dstImage, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, dstRange);
+            };
+        }
+
+        // No need to wait for the upload here, the image is only swapped in by a later render command which flushes the uploads before it is submitted
+        if (cpuMipCount > 0)
+        {
+            // The mips are kept in separate buffers so the ones that get uploaded are packed together for the staging copy
+            Buffer uploadData;
+            uploadData.Allocate(GetMipChainMemorySize(firstMip) - GetMipChainMemorySize(gpuFirstMip));
+
+            std::vector<VkBufferImageCopy> copyRegions(cpuMipCount);
+            uint64_t mipDataOffset = 0;
+            for (uint32_t mip = 0; mip < cpuMipCount; mip++)
+            {
+                const glm::ivec2 mipSize = GetMipSize(firstMip + mip);
+                const Buffer& mipData = m_StreamingMips[firstMip + mip];
+
+                copyRegions[mip] = {
+                    .bufferOffset = mipDataOffset,
+                    .bufferRowLength = 0,
+                    .bufferImageHeight = 0,
+                    .imageSubresource = {
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .mipLevel = mip,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1
+                    },
+                    .imageOffset = { .x = 0, .y = 0, .z = 0 },
+                    .imageExtent = { .width = static_cast<uint32_t>(mipSize.x), .height = static_cast<uint32_t>(mipSize.y), .depth = 1u }
+                };
+
+                std::memcpy(uploadData.Data + mipDataOffset, mipData.Data, mipData.Size);
+                mipDataOffset += mipData.Size;
+            }
+
+            UploadManager::UploadImage({
+                .Image = result.Image,
+                .SubresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = cpuMipCount, .baseArrayLayer = 0, .layerCount = 1 },
+                .FinalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                .Data = uploadData.Data,
+                .Size = uploadData.Size,
+                .TexelSize = Utils::GetImageFormatBPP(m_Specification.Format),
+                .Regions = copyRegions.data(),
+                .RegionCount = static_cast<uint32_t>(copyRegions.size())
+            }, copyResidentMips);
+
+            uploadData.Release();
+        }
+        else
+        {
+            UploadManager::RecordGraphicsCommands(copyResidentMips);
+        }
+
+        // From here on the mips are in the new image. Dropped mips are decoded again if a later image needs them after they got streamed out
+        if (CanReloadStreamingMips())
+        {
+            for (uint32_t mip = firstMip; mip < mipLevelCount; mip++)
+                m_StreamingMips[mip].Release();
+        }
+
+        uint64_t cpuMemorySize = m_StreamingSource.Size;
+        for (const Buffer& mip : m_StreamingMips)
+            cpuMemorySize += mip.Size;
+        m_StreamingCPUMemorySize = cpuMemorySize;
+
+        VkImageViewCreateInfo imageViewCI = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = result.Image,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = format,
+            .components = { .r = VK_COMPONENT_SWIZZLE_R, .g = VK_COMPONENT_SWIZZLE_G, .b = VK_COMPONENT_SWIZZLE_B, .a = VK_COMPONENT_SWIZZLE_A },
+            .subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = mipCount, .baseArrayLayer = 0, .layerCount = 1 }
+        };
+
+        VK_CHECK_RESULT(vkCreateImageView(device, &imageViewCI, nullptr, &result.ImageView));
+        VKUtils::SetDebugUtilsObjectName(device, VK_OBJECT_TYPE_IMAGE_VIEW, fmt::format("{} Image View (Mip {})", m_Specification.DebugName, firstMip), result.ImageView);
+
+        m_LatestStreamedImage = result;
+
+        return result;
+    }
+
+    void Texture2D::StoreStreamingMips(const Buffer& mipChain, uint32_t endMip)
+    {
+        uint64_t offset = 0;
+        for (uint32_t mip = 0; mip < endMip; mip++)
+        {
+            const glm::ivec2 mipSize = GetMipSize(mip);
+            const uint64_t mipDataSize = static_cast<uint64_t>(mipSize.x) * mipSize.y * Utils::GetImageFormatBPP(m_Specification.Format);
+
+            if (!m_StreamingMips[mip])
+                m_StreamingMips[mip] = Buffer::Copy(mipChain.Data + offset, mipDataSize);
+
+            offset += mipDataSize;
+        }
+    }
+
+    bool Texture2D::ReloadStreamingMips(uint32_t endMip)
+    {
+        if (!CanReloadStreamingMips())
+            return false;
+
+        Timer timer;
+
+        ImageFormat format = ImageFormat::None;
+        uint32_t width = 0, height = 0;
+        Buffer image = m_StreamingSource ? Utils::TextureImporter::LoadImageFromMemory(m_StreamingSource, format, width, height)
+                                         : Utils::TextureImporter::LoadImageFromFile(m_AssetPath, format, width, height);
+        if (!image)
+            return false;
+
+        // The file could have been changed on disk since, the asset gets reloaded for that so until then the mips just stay where they are
+        Utils::KeepSRGBFormat(m_StreamingSourceFormat, format);
+        if (width != m_Specification.Width || height != m_Specification.Height || format != m_StreamingSourceFormat)
+        {
+            Utils::TextureImporter::FreeImageMemory(image.Data);
+            return false;
+        }
+
+        Buffer mipChain = Utils::BuildMipChain(image, format, width, height, GetMipLevelCount());
+        Utils::TextureImporter::FreeImageMemory(image.Data);
+
+        if (m_Specification.Format != m_StreamingSourceFormat)
+            mipChain = Utils::TextureImporter::ConvertHDRImage(mipChain, m_Specification.Format);
+
+        StoreStreamingMips(mipChain, endMip);
+        mipChain.Release();
+
+        IR_CORE_TRACE_TAG("Renderer", "Decoded '{}' again for mips 0-{} in {:.2f}ms", m_Specification.DebugName, endMip - 1, timer.ElapsedMillis());
+        return true;
+    }
+
+    uint64_t Texture2D::GetCPUMemoryUsage() const
+    {
+        return m_Specification.Streaming ? m_StreamingCPUMemorySize.load() : m_ImageData.Size;
+    }
+
+    void Texture2D::RT_SetStreamedImage(const StreamedImage& image)
+    {
+        // The sampler stays the same, only the image and its view are replaced. Descriptor sets pick the new view up after being told that
+        // a resource changed since they compare the image views they wrote against the current ones then
+        if (m_Image)
+        {
+            Renderer::SubmitReseourceFree([image = m_Image, imageView = m_ImageView, allocation = m_MemoryAllocation, name = m_Specification.DebugName]()
+            {
+                VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+                VulkanAllocator allocator("Texture2D");
+                vkDestroyImageView(device, imageView, nullptr);
+                allocator.DestroyImage(allocation, image, name);
+            });
+        }
+
+        m_Image = image.Image;
+        m_ImageView = image.ImageView;
+        m_MemoryAllocation = image.MemoryAllocation;
+        m_GPUMemorySize = image.GPUMemorySize;
+        m_ResidentMip = image.FirstMip;
+        m_DescriptorInfo.imageView = m_ImageView;
+        DescriptorSetManager::OnResourceInvalidated();
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// TextureCube
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -770,6 +1360,7 @@ namespace Iris {
         VkDeviceSize gpuAllocationSize = 0;
         constexpr VmaMemoryUsage memUsage = VMA_MEMORY_USAGE_GPU_ONLY;
         m_MemoryAllocation = allocator.AllocateImage(&imageCI, memUsage, &m_Image, &gpuAllocationSize);
+        m_GPUMemorySize = gpuAllocationSize;
         VKUtils::SetDebugUtilsObjectName(device, VK_OBJECT_TYPE_IMAGE, m_Specification.DebugName, m_Image);
 
         bool manualCommandBuffer = false;
@@ -903,11 +1494,12 @@ namespace Iris {
             .imageView = m_ImageView,
             .imageLayout = VK_IMAGE_LAYOUT_GENERAL
         };
+        DescriptorSetManager::OnResourceInvalidated();
 
         m_ImageData.Release();
     }
 
-    void TextureCube::GenerateMips(bool readonly, VkCommandBuffer commandBuffer)
+    void TextureCube::GenerateMips(bool readonly, VkCommandBuffer commandBuffer, uint32_t firstFace, uint32_t faceCount)
     {
         Ref<VulkanDevice> logicalDevice = RendererContext::GetCurrentDevice();
 
@@ -928,7 +1520,7 @@ namespace Iris {
             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
             manualCommandBuffer ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
             VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-            { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 6 }
+            { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = firstFace, .layerCount = faceCount }
         );
 
         // Start from the the second mip in the chain and blit from previous mip into current mip
@@ -940,8 +1532,8 @@ namespace Iris {
                 .srcSubresource = {
                     .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
                     .mipLevel = i - 1,
-                    .baseArrayLayer = 0,
-                    .layerCount = 6
+                    .baseArrayLayer = firstFace,
+                    .layerCount = faceCount
                 },
                 // Right shifting is basically division by 2
                 .srcOffsets = { { 0, 0, 0 }, { static_cast<int32_t>(m_Specification.Width >> (i - 1)), static_cast<int32_t>(m_Specification.Height >> (i - 1)), 1 } },
@@ -950,8 +1542,8 @@ namespace Iris {
                 .dstSubresource = {
                     .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
                     .mipLevel = i,
-                    .baseArrayLayer = 0,
-                    .layerCount = 6
+                    .baseArrayLayer = firstFace,
+                    .layerCount = faceCount
                 },
                 .dstOffsets = { { 0, 0, 0 }, { static_cast<int32_t>(m_Specification.Width >> i), static_cast<int32_t>(m_Specification.Height >> i), 1 } },
             };
@@ -966,7 +1558,7 @@ namespace Iris {
                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                 manualCommandBuffer ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
                 VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-                { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = i, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 6 }
+                { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = i, .levelCount = 1, .baseArrayLayer = firstFace, .layerCount = faceCount }
             );
 
             vkCmdBlitImage(
@@ -989,7 +1581,7 @@ namespace Iris {
                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                 VK_PIPELINE_STAGE_2_TRANSFER_BIT,
                 VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-                { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = i, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 6 }
+                { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = i, .levelCount = 1, .baseArrayLayer = firstFace, .layerCount = faceCount }
             );
         }
 
@@ -1003,7 +1595,7 @@ namespace Iris {
             readonly ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL,
             VK_PIPELINE_STAGE_2_TRANSFER_BIT,
             manualCommandBuffer ? VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-            { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = mipCount, .baseArrayLayer = 0, .layerCount = 6 }
+            { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = mipCount, .baseArrayLayer = firstFace, .layerCount = faceCount }
         );
 
         if (manualCommandBuffer)
@@ -1035,7 +1627,9 @@ namespace Iris {
         if (m_Specification.CreateSampler)
             m_Sampler = nullptr;
         m_MemoryAllocation = nullptr;
+        m_GPUMemorySize = 0;
         m_DescriptorInfo = {};
+        DescriptorSetManager::OnResourceInvalidated();
     }
 
     Ref<ImageView> TextureCube::CreateImageViewSingleMip(uint32_t mip)
@@ -1058,19 +1652,7 @@ namespace Iris {
 
         VulkanAllocator allocator("TextureCube");
 
-        uint32_t mipCount = GetMipLevelCount();
-
-        constexpr uint32_t faces = 6;
-        constexpr uint32_t bpp = sizeof(float) * 4;
-        uint64_t bufferSize = 0;
-        uint32_t width = m_Specification.Width, height = m_Specification.Height;
-
-        for (uint32_t i = 0; i < mipCount; i++)
-        {
-            bufferSize += width * height * bpp * faces;
-            width /= 2;
-            height /= 2;
-        }
+        const uint64_t bufferSize = GetMipChainSize();
 
         // Staging buffer
         VkBuffer stagingBuffer;
@@ -1084,8 +1666,6 @@ namespace Iris {
         };
         VmaAllocation stagingBufferAllocation = allocator.AllocateBuffer(&stagingBufferCI, VMA_MEMORY_USAGE_GPU_TO_CPU, &stagingBuffer);
 
-        uint32_t mipWidth = m_Specification.Width, mipHeight = m_Specification.Height;
-
         bool manualCommandBuffer = false;
         if (!commandBuffer)
         {
@@ -1093,6 +1673,31 @@ namespace Iris {
             manualCommandBuffer = true;
         }
 
+        RecordCopyToBuffer(commandBuffer, stagingBuffer);
+
+        if (manualCommandBuffer)
+        {
+            logicalDevice->FlushCommandBuffer(commandBuffer);
+            commandBuffer = nullptr;
+        }
+
+        uint8_t* srcData = allocator.MapMemory<uint8_t>(stagingBufferAllocation);
+        buffer.Allocate(bufferSize);
+        std::memcpy(buffer.Data, reinterpret_cast<const void*>(srcData), bufferSize);
+        allocator.UnmapMemory(stagingBufferAllocation);
+
+        allocator.DestroyBuffer(stagingBufferAllocation, stagingBuffer);
+    }
+
+    void TextureCube::RecordCopyToBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, uint64_t bufferOffset) const
+    {
+        const uint32_t mipCount = GetMipLevelCount();
+
+        constexpr uint32_t faces = 6;
+        const uint32_t bpp = Utils::GetImageFormatBPP(m_Specification.Format);
+
+        uint32_t mipWidth = m_Specification.Width, mipHeight = m_Specification.Height;
+
         Renderer::InsertImageMemoryBarrier(
             commandBuffer,
             m_Image,
@@ -1105,7 +1710,7 @@ namespace Iris {
             { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = mipCount, .baseArrayLayer = 0, .layerCount = faces }
         );
 
-        uint64_t mipDataOffset = 0;
+        uint64_t mipDataOffset = bufferOffset;
         for (uint32_t mip = 0; mip < mipCount; mip++)
         {
             VkBufferImageCopy bufferCopyRegion = {
@@ -1123,9 +1728,9 @@ namespace Iris {
                 }
             };
 
-            vkCmdCopyImageToBuffer(commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stagingBuffer, 1, &bufferCopyRegion);
+            vkCmdCopyImageToBuffer(commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &bufferCopyRegion);
 
-            mipDataOffset += mipWidth * mipHeight * bpp * faces;
+            mipDataOffset += static_cast<uint64_t>(mipWidth) * mipHeight * bpp * faces;
             mipWidth /= 2;
             mipHeight /= 2;
         }
@@ -1141,19 +1746,23 @@ namespace Iris {
             VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, // Let all subsequent stages wait
             { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = mipCount, .baseArrayLayer = 0, .layerCount = faces }
         );
+    }
 
-        if (manualCommandBuffer)
+    uint64_t TextureCube::GetMipChainSize() const
+    {
+        const uint32_t mipCount = GetMipLevelCount();
+        const uint32_t bpp = Utils::GetImageFormatBPP(m_Specification.Format);
+
+        uint64_t size = 0;
+        uint32_t width = m_Specification.Width, height = m_Specification.Height;
+        for (uint32_t i = 0; i < mipCount; i++)
         {
-            logicalDevice->FlushCommandBuffer(commandBuffer);
-            commandBuffer = nullptr;
+            size += static_cast<uint64_t>(width) * height * bpp * 6;
+            width /= 2;
+            height /= 2;
         }
 
-        uint8_t* srcData = allocator.MapMemory<uint8_t>(stagingBufferAllocation);
-        buffer.Allocate(bufferSize);
-        std::memcpy(buffer.Data, reinterpret_cast<const void*>(srcData), bufferSize);
-        allocator.UnmapMemory(stagingBufferAllocation);
-
-        allocator.DestroyBuffer(stagingBufferAllocation, stagingBuffer);
+        return size;
     }
 
     void TextureCube::CopyFromHostBufer(const Buffer& buffer, uint32_t mips, VkCommandBuffer commandBuffer)
@@ -1163,7 +1772,7 @@ namespace Iris {
         VulkanAllocator allocator("TextureCube");
 
         constexpr uint32_t faces = 6;
-        constexpr uint32_t bpp = sizeof(float) * 4;
+        const uint32_t bpp = Utils::GetImageFormatBPP(m_Specification.Format);
 
         // Staging buffer
         VkBuffer stagingBuffer;
@@ -1315,9 +1924,8 @@ namespace Iris {
         if (m_Specificaton.CubeImage)
             imageSpec = m_Specificaton.CubeImage->GetTextureSpecification();
 
+        // Views end up in descriptors which can only see one aspect, so depth stencil images are viewed through their depth
         VkImageAspectFlags aspectMask = Utils::IsDepthFormat(imageSpec.Format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
-        if (imageSpec.Format == ImageFormat::DEPTH24STENCIL8 || imageSpec.Format == ImageFormat::DEPTH32FSTENCIL8UINT)
-            aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
 
         VkImageViewCreateInfo imageViewCI = {
             .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -1359,6 +1967,8 @@ namespace Iris {
             m_DescriptorInfo = m_Specificaton.CubeImage->GetDescriptorImageInfo();
             m_DescriptorInfo.imageView = m_ImageView;
         }
+
+        DescriptorSetManager::OnResourceInvalidated();
     }
 
 }
\ No newline at end of file
@@ -31,6 +31,7 @@ namespace Iris {
 		RGBA32F, // FLOAT
 
 		B10R11G11UF, // UFLOAT
+		E5B9G9R9UF, // UFLOAT shared exponent, can only be sampled from
 
 		SRGB,
 		SRGBA,
@@ -59,6 +60,7 @@ namespace Iris {
 		None = 0,
 		Texture, // Defualt: Loaded via a filepath or image data
 		Attachment, // For Framebuffers
+		Storage, // Written by compute shaders and sampled afterwards, stays in the general layout and its mips are never generated
 	};
 
 	struct TextureSpecification
@@ -93,6 +95,14 @@ namespace Iris {
 		// DO NOT SET THIS. This will be determined up on invalidation and is there for debugging purposes.
 		uint32_t Mips = 0;
 
+		// Set by user. Format HDR images (decoded as RGBA32F) are converted to when the texture is loaded from a file or memory, RGBA32F keeps them as is.
+		// E5B9G9R9UF can not be blitted to so it falls back to B10R11G11UF when the mips have to be generated on the GPU
+		ImageFormat HDRFormat = ImageFormat::RGBA16F;
+
+		// Set by user. Only the tail of the mip chain is uploaded when the texture is created and the higher mips are paged in by the
+		// TextureStreamer depending on how big the texture gets on screen. Ignored unless the texture is decoded from a file or memory
+		bool Streaming = false;
+
 		// TODO: We could store a cache map for per-layer image views and another for per-mip image views and to create them we just loop
 		// TODO: on the mipCount and the loop on Layers and just change the subResourceRange for VkImageViewCreateInfo
 		// Set by user. Texture might an array useful for shadow mapping
@@ -124,6 +134,7 @@ namespace Iris {
 		void Resize(uint32_t width, uint32_t height, VkCommandBuffer commandBuffer = nullptr);
 		void GenerateMips(VkCommandBuffer commandBuffer = nullptr);
 		void Release();
+		Ref<ImageView> CreateImageViewSingleMip(uint32_t mip);
 
 		uint64_t GetHash() const { return reinterpret_cast<uint64_t>(m_ImageView); }
 
@@ -142,6 +153,8 @@ namespace Iris {
 		const VmaAllocation GetMemoryAllocation() const { return m_MemoryAllocation; }
 
 		const VkDescriptorImageInfo& GetDescriptorImageInfo() const { return m_DescriptorInfo; }
+		// Slot of the texture in the bindless table (Renderer/BindlessTable.h), registers it on first use. Can be called from any thread
+		uint32_t GetBindlessIndex();
 
 		TextureSpecification& GetTextureSpecification() { return m_Specification; }
 		const TextureSpecification& GetTextureSpecification() const { return m_Specification; }
@@ -150,9 +163,48 @@ namespace Iris {
 		uint32_t GetNumLayers() const { return m_Specification.Layers; }
 		glm::ivec2 GetMipSize(uint32_t mip) const;
 
+		// Streaming
+		bool IsStreaming() const { return m_Specification.Streaming; }
+		// The first mip of the full chain that is in the GPU image, the image view always starts at that mip
+		uint32_t GetResidentMip() const { return m_ResidentMip; }
+		// The coarsest mip the texture streams down to, everything from this one onwards is always resident
+		uint32_t GetStreamingTailMip() const;
+		// GPU size of the mip chain starting at firstMip
+		uint64_t GetMipChainMemorySize(uint32_t firstMip) const;
+
+		struct StreamedImage
+		{
+			VkImage Image = nullptr;
+			VkImageView ImageView = nullptr;
+			VmaAllocation MemoryAllocation = nullptr;
+			uint64_t GPUMemorySize = 0;
+			uint32_t FirstMip = 0;
+		};
+
+		// Creates a new image holding the mips from firstMip onwards. Mips the newest image already has are copied over on the GPU and only the
+		// missing ones are uploaded from the CPU, decoding the source again if they were dropped. Can be called from any thread
+		StreamedImage CreateStreamedImage(uint32_t firstMip);
+		// Replaces the current image with the streamed one and releases the old image once it is no longer in flight
+		void RT_SetStreamedImage(const StreamedImage& image);
+
+		virtual uint64_t GetCPUMemoryUsage() const override;
+		virtual uint64_t GetGPUMemoryUsage() const override { return m_GPUMemorySize; }
+
 		static AssetType GetStaticType() { return AssetType::Texture; }
 		virtual AssetType GetAssetType() const override { return GetStaticType(); }
 
+	private:
+		// decodedImage is set when m_ImageData comes from the TextureImporter (freed with FreeImageMemory)
+		void InitializeStreaming(bool decodedImage);
+		void ConvertHDRImageData();
+
+		// Copies the mips before endMip that are not on the CPU out of the mip chain. Expects the streaming mutex to be locked
+		void StoreStreamingMips(const Buffer& mipChain, uint32_t endMip);
+		// Decodes the source image again for mips that were dropped from the CPU once they became resident and got streamed out since
+		bool ReloadStreamingMips(uint32_t endMip);
+		// Textures made from raw texels have nothing to decode again so they keep all of their mips on the CPU
+		bool CanReloadStreamingMips() const { return !m_AssetPath.empty() || m_StreamingSource; }
+
 	private:
 		std::string m_AssetPath;
 		TextureSpecification m_Specification;
@@ -162,10 +214,27 @@ namespace Iris {
 		VkImageView m_ImageView = nullptr;
 		VkSampler m_Sampler = nullptr;
 		VmaAllocation m_MemoryAllocation = nullptr;
+		uint64_t m_GPUMemorySize = 0;
 
-		Buffer m_ImageData; // Local storage of the image
+		// Local storage of the image. For streaming textures this holds the whole mip chain (mip 0 first) untill it is split into m_StreamingMips
+		Buffer m_ImageData;
+
+		uint32_t m_ResidentMip = 0;
+
+		// CPU copies of the mips that are not resident, mips are dropped once an image holding them is created
+		std::vector<Buffer> m_StreamingMips;
+		Buffer m_StreamingSource; // Encoded image of textures decoded from memory
+		ImageFormat m_StreamingSourceFormat = ImageFormat::None; // Format the mip chain is built in, before the HDR conversion
+		StreamedImage m_LatestStreamedImage; // Newest image created, not necessarily swapped in yet
+		std::atomic<uint64_t> m_StreamingCPUMemorySize = 0; // Read without the mutex since decoding mips again holds it for a while
+		std::mutex m_StreamingMutex;
 
 		VkDescriptorImageInfo m_DescriptorInfo = {};
+
+		// Owned by the BindlessTable
+		uint32_t m_BindlessIndex = ~0u;
+
+		friend class BindlessTable;
 	};
 
 	class ImageView;
@@ -182,7 +251,8 @@ namespace Iris {
 		}
 
 		void Invalidate(VkCommandBuffer commandBuffer = nullptr);
-		void GenerateMips(bool readonly = false, VkCommandBuffer commandBuffer = nullptr);
+		// firstFace and faceCount restrict the mips that get regenerated to a range of the faces, the rest of the faces are left untouched
+		void GenerateMips(bool readonly = false, VkCommandBuffer commandBuffer = nullptr, uint32_t firstFace = 0, uint32_t faceCount = 6);
 		void Release();
 		Ref<ImageView> CreateImageViewSingleMip(uint32_t mip);
 
@@ -190,6 +260,10 @@ namespace Iris {
 
 		// Always writes mips if any
 		void CopyToHostBuffer(Buffer& buffer, VkCommandBuffer commandBuffer = nullptr) const;
+		// Records the copy of every mip into buffer (laid out like CopyToHostBuffer) without waiting on it, the caller makes sure the buffer outlives the copy
+		void RecordCopyToBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, uint64_t bufferOffset = 0) const;
+		// Size of all the mips of all six faces
+		uint64_t GetMipChainSize() const;
 		void CopyFromHostBufer(const Buffer& buffer, uint32_t mips, VkCommandBuffer commandBuffer = nullptr);
 
 		const std::string& GetAssetPath() const noexcept { return m_AssetPath; }
@@ -213,6 +287,9 @@ namespace Iris {
 		uint32_t GetNumLayers() const { return m_Specification.Layers; }
 		glm::ivec2 GetMipSize(uint32_t mip) const;
 
+		virtual uint64_t GetCPUMemoryUsage() const override { return m_ImageData.Size; }
+		virtual uint64_t GetGPUMemoryUsage() const override { return m_GPUMemorySize; }
+
 		static AssetType GetStaticType() { return AssetType::EnvironmentMap; }
 		virtual AssetType GetAssetType() const override { return GetStaticType(); }
 
@@ -225,6 +302,7 @@ namespace Iris {
 		VkImageView m_ImageView = nullptr;
 		VkSampler m_Sampler = nullptr;
 		VmaAllocation m_MemoryAllocation = nullptr;
+		uint64_t m_GPUMemorySize = 0;
 
 		Buffer m_ImageData; // Local storage of the image
 
@@ -292,6 +370,7 @@ namespace Iris {
 				case ImageFormat::RGBA16F:		return 2 * 4;
 				case ImageFormat::RGBA32F:		return 4 * 4;
 				case ImageFormat::B10R11G11UF:	return 4;
+				case ImageFormat::E5B9G9R9UF:	return 4;
 				case ImageFormat::SRGB:			return 3;
 				case ImageFormat::SRGBA:		return 4;
 			}
@@ -319,6 +398,7 @@ namespace Iris {
 				case ImageFormat::RGBA16F:
 				case ImageFormat::RGBA32F:
 				case ImageFormat::B10R11G11UF:
+				case ImageFormat::E5B9G9R9UF:
 				case ImageFormat::SRGB:
 				case ImageFormat::SRGBA:
 				case ImageFormat::DEPTH24STENCIL8:
@@ -364,6 +444,7 @@ namespace Iris {
 				case ImageFormat::RGBA16F:				return VK_FORMAT_R16G16B16A16_SFLOAT;
 				case ImageFormat::RGBA32F:				return VK_FORMAT_R32G32B32A32_SFLOAT;
 				case ImageFormat::B10R11G11UF:			return VK_FORMAT_B10G11R11_UFLOAT_PACK32;
+				case ImageFormat::E5B9G9R9UF:			return VK_FORMAT_E5B9G9R9_UFLOAT_PACK32;
 				case ImageFormat::SRGB:					return VK_FORMAT_R8G8B8_SRGB;
 				case ImageFormat::SRGBA:				return VK_FORMAT_R8G8B8A8_SRGB;
 				case ImageFormat::DEPTH32FSTENCIL8UINT: return VK_FORMAT_D32_SFLOAT_S8_UINT;
@@ -0,0 +1,306 @@
+#include "IrisPCH.h"
+#include "TextureStreamer.h"
+
+#include "Core/Thread.h"
+#include "Renderer/Core/UploadManager.h"
+#include "Renderer.h"
+
+#include <condition_variable>
+#include <deque>
+
+namespace Iris {
+
+	struct StreamingTexture
+	{
+		// Keeps the texture alive while it has mips paged in or an upload in flight
+		Ref<Texture2D> Texture;
+
+		uint32_t TailMip = 0;
+		uint32_t ResidentMip = 0;
+		uint32_t TargetMip = 0;
+
+		uint32_t FrameRequestedMip = UINT32_MAX; // Finest mip requested since the last update
+		uint32_t RequestedMip = 0;
+		uint64_t LastRequestedFrame = 0;
+
+		bool UploadPending = false;
+	};
+
+	struct StreamingUpload
+	{
+		Ref<Texture2D> Texture;
+		uint32_t FirstMip = 0;
+		Texture2D::StreamedImage Image;
+	};
+
+	struct TextureStreamerData
+	{
+		// Only textures that are streamed above their tail mips have an entry
+		std::unordered_map<Texture2D*, StreamingTexture> Textures;
+
+		Thread StreamingThread = Thread("Texture Streamer", 0);
+		bool Running = false;
+
+		std::mutex UploadMutex;
+		std::condition_variable UploadCondition;
+		std::deque<StreamingUpload> QueuedUploads;
+		std::vector<StreamingUpload> CompletedUploads;
+
+		uint64_t CurrentFrame = 0;
+		TextureStreamingStats Stats;
+	};
+
+	static TextureStreamerData* s_Data = nullptr;
+
+	// Textures that have not been requested for this many frames drop back to their tail mips
+	static constexpr uint64_t s_StreamOutFrames = 120;
+	// Limits the mip data handed to the streaming thread per frame so that a camera cut does not queue up everything at once
+	static constexpr uint64_t s_MaxUploadSizePerFrame = 64ull * 1024 * 1024;
+	// UVs rarely cover a submesh exactly once (tiling, oblique angles), so we ask for one mip more than the screen size alone needs
+	static constexpr float s_StreamingMipBias = 1.0f;
+
+	static void StreamingThreadFunc()
+	{
+		while (true)
+		{
+			StreamingUpload upload;
+			{
+				std::unique_lock<std::mutex> lock(s_Data->UploadMutex);
+				s_Data->UploadCondition.wait(lock, []() { return !s_Data->Running || !s_Data->QueuedUploads.empty(); });
+
+				if (!s_Data->Running)
+					break;
+
+				upload = std::move(s_Data->QueuedUploads.front());
+				s_Data->QueuedUploads.pop_front();
+			}
+
+			upload.Image = upload.Texture->CreateStreamedImage(upload.FirstMip);
+
+			std::scoped_lock<std::mutex> lock(s_Data->UploadMutex);
+			s_Data->CompletedUploads.push_back(std::move(upload));
+		}
+	}
+
+	void TextureStreamer::Init()
+	{
+		s_Data = new TextureStreamerData();
+
+		s_Data->Running = true;
+		s_Data->StreamingThread.Dispatch(StreamingThreadFunc);
+	}
+
+	void TextureStreamer::Shutdown()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->UploadMutex);
+			s_Data->Running = false;
+			s_Data->UploadCondition.notify_all();
+		}
+
+		s_Data->StreamingThread.Join();
+
+		// Uploads that finished but never got swapped in were never used for rendering, so they can go as soon as their copies are done
+		UploadManager::Flush(true);
+
+		VkDevice device = RendererContext::GetCurrentDevice()->GetVulkanDevice();
+		VulkanAllocator allocator("TextureStreamer");
+		for (StreamingUpload& upload : s_Data->CompletedUploads)
+		{
+			vkDestroyImageView(device, upload.Image.ImageView, nullptr);
+			allocator.DestroyImage(upload.Image.MemoryAllocation, upload.Image.Image);
+		}
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void TextureStreamer::Update()
+	{
+		s_Data->CurrentFrame++;
+
+		// Swap in whatever finished uploading since the last update
+		std::vector<StreamingUpload> completedUploads;
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->UploadMutex);
+			completedUploads.swap(s_Data->CompletedUploads);
+		}
+
+		for (StreamingUpload& upload : completedUploads)
+		{
+			StreamingTexture& streamingTexture = s_Data->Textures.at(upload.Texture.Raw());
+			// The image can hold less than asked for if the dropped mips could not be decoded again
+			streamingTexture.ResidentMip = upload.Image.FirstMip;
+			streamingTexture.UploadPending = false;
+
+			Renderer::Submit([texture = upload.Texture, image = upload.Image]() mutable
+			{
+				texture->RT_SetStreamedImage(image);
+			});
+		}
+
+		// Work out which mip every texture should have resident
+		std::vector<StreamingTexture*> budgetHeap;
+		budgetHeap.reserve(s_Data->Textures.size());
+
+		uint64_t totalMemory = 0;
+		for (auto it = s_Data->Textures.begin(); it != s_Data->Textures.end();)
+		{
+			StreamingTexture& streamingTexture = it->second;
+
+			// Nobody else holds on to the texture anymore (ex. evicted or reloaded asset) so there is no point in keeping it around
+			if (!streamingTexture.UploadPending && streamingTexture.Texture->GetRefCount() == 1)
+			{
+				it = s_Data->Textures.erase(it);
+				continue;
+			}
+
+			if (streamingTexture.FrameRequestedMip != UINT32_MAX)
+			{
+				streamingTexture.RequestedMip = streamingTexture.FrameRequestedMip;
+				streamingTexture.LastRequestedFrame = s_Data->CurrentFrame;
+				streamingTexture.FrameRequestedMip = UINT32_MAX;
+			}
+
+			// While the texture is still in use it does not give up mips just because it got a bit smaller on screen, only the budget takes them away
+			if (s_Data->CurrentFrame - streamingTexture.LastRequestedFrame <= s_StreamOutFrames)
+				streamingTexture.TargetMip = glm::min(streamingTexture.RequestedMip, streamingTexture.ResidentMip);
+			else
+				streamingTexture.TargetMip = streamingTexture.TailMip;
+
+			totalMemory += streamingTexture.Texture->GetMipChainMemorySize(streamingTexture.TargetMip);
+			budgetHeap.push_back(&streamingTexture);
+
+			++it;
+		}
+
+		// Over budget: keep taking the top mip away from whichever texture currently takes up the most memory
+		const uint64_t budget = Renderer::GetConfig().TextureStreamingBudget;
+		if (totalMemory > budget)
+		{
+			auto compareMemory = [](const StreamingTexture* a, const StreamingTexture* b)
+			{
+				return a->Texture->GetMipChainMemorySize(a->TargetMip) < b->Texture->GetMipChainMemorySize(b->TargetMip);
+			};
+
+			std::make_heap(budgetHeap.begin(), budgetHeap.end(), compareMemory);
+			while (totalMemory > budget && !budgetHeap.empty())
+			{
+				std::pop_heap(budgetHeap.begin(), budgetHeap.end(), compareMemory);
+				StreamingTexture* streamingTexture = budgetHeap.back();
+				if (streamingTexture->TargetMip >= streamingTexture->TailMip)
+				{
+					budgetHeap.pop_back();
+					continue;
+				}
+
+				const uint64_t currentSize = streamingTexture->Texture->GetMipChainMemorySize(streamingTexture->TargetMip);
+				streamingTexture->TargetMip++;
+				totalMemory -= currentSize - streamingTexture->Texture->GetMipChainMemorySize(streamingTexture->TargetMip);
+
+				std::push_heap(budgetHeap.begin(), budgetHeap.end(), compareMemory);
+			}
+		}
+
+		std::vector<StreamingTexture*> uploads;
+		for (auto it = s_Data->Textures.begin(); it != s_Data->Textures.end();)
+		{
+			StreamingTexture& streamingTexture = it->second;
+			if (streamingTexture.UploadPending || streamingTexture.TargetMip == streamingTexture.ResidentMip)
+			{
+				// Back to its tail mips and not needed anymore, so the texture no longer has to be kept alive
+				if (!streamingTexture.UploadPending && streamingTexture.ResidentMip == streamingTexture.TailMip)
+				{
+					it = s_Data->Textures.erase(it);
+					continue;
+				}
+
+				++it;
+				continue;
+			}
+
+			uploads.push_back(&streamingTexture);
+			++it;
+		}
+
+		// Dropping mips frees memory so those go first, then the textures that are missing the most mips
+		std::sort(uploads.begin(), uploads.end(), [](const StreamingTexture* a, const StreamingTexture* b)
+		{
+			const bool aDropsMips = a->TargetMip > a->ResidentMip;
+			const bool bDropsMips = b->TargetMip > b->ResidentMip;
+			if (aDropsMips || bDropsMips)
+				return aDropsMips && !bDropsMips;
+
+			return a->ResidentMip - a->TargetMip > b->ResidentMip - b->TargetMip;
+		});
+
+		if (!uploads.empty())
+		{
+			std::scoped_lock<std::mutex> lock(s_Data->UploadMutex);
+
+			uint64_t uploadSize = 0;
+			for (StreamingTexture* streamingTexture : uploads)
+			{
+				const uint64_t size = streamingTexture->Texture->GetMipChainMemorySize(streamingTexture->TargetMip);
+				if (uploadSize > 0 && uploadSize + size > s_MaxUploadSizePerFrame)
+					break;
+
+				uploadSize += size;
+				streamingTexture->UploadPending = true;
+				s_Data->QueuedUploads.push_back({ .Texture = streamingTexture->Texture, .FirstMip = streamingTexture->TargetMip });
+			}
+
+			s_Data->UploadCondition.notify_one();
+		}
+
+		TextureStreamingStats& stats = s_Data->Stats;
+		stats = { .Budget = budget };
+		for (const auto& [texture, streamingTexture] : s_Data->Textures)
+		{
+			stats.StreamedTextures++;
+			stats.PendingUploads += streamingTexture.UploadPending ? 1 : 0;
+			stats.StreamedMemory += texture->GetMipChainMemorySize(streamingTexture.ResidentMip);
+		}
+	}
+
+	void TextureStreamer::RequestMip(const Ref<Texture2D>& texture, uint32_t mip)
+	{
+		if (!texture || !texture->IsStreaming())
+			return;
+
+		auto it = s_Data->Textures.find(texture.Raw());
+		if (it == s_Data->Textures.end())
+		{
+			// The tail is always resident so there is nothing to stream
+			const uint32_t tailMip = texture->GetStreamingTailMip();
+			if (mip >= tailMip)
+				return;
+
+			StreamingTexture streamingTexture = {
+				.Texture = texture,
+				.TailMip = tailMip,
+				.ResidentMip = texture->GetResidentMip(),
+				.TargetMip = tailMip,
+				.RequestedMip = tailMip,
+				.LastRequestedFrame = s_Data->CurrentFrame
+			};
+			it = s_Data->Textures.emplace(texture.Raw(), streamingTexture).first;
+		}
+
+		it->second.FrameRequestedMip = glm::min(it->second.FrameRequestedMip, mip);
+	}
+
+	uint32_t TextureStreamer::CalculateRequiredMip(const Ref<Texture2D>& texture, float screenSize)
+	{
+		const float textureSize = static_cast<float>(glm::max(texture->GetWidth(), texture->GetHeight()));
+		const float mip = glm::log2(textureSize / glm::max(screenSize, 1.0f)) - s_StreamingMipBias;
+
+		return static_cast<uint32_t>(glm::clamp(glm::floor(mip), 0.0f, static_cast<float>(texture->GetMipLevelCount() - 1)));
+	}
+
+	TextureStreamingStats TextureStreamer::GetStats()
+	{
+		return s_Data->Stats;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Renderer/Texture.h"
+
+/*
+ * Pages the higher mips of streaming textures (TextureSpecification::Streaming) in and out of VRAM
+ * - Streaming textures are created with only the tail of their mip chain resident (see Texture2D::GetStreamingTailMip) so they can be bound right away
+ * - Every frame the scene renderers request the mip each texture needs, derived from how many pixels the submeshes using it cover on screen
+ * - Once per frame the requests of the last frame are resolved against RendererConfiguration::TextureStreamingBudget, when over budget the
+ *   textures taking up the most memory give up their top mip first
+ * - The new images are created and uploaded on the streaming thread and swapped in on the render thread, the old image stays bound untill then
+ * - Textures that have not been requested for a while drop back to their tail mips
+ */
+
+namespace Iris {
+
+	struct TextureStreamingStats
+	{
+		uint32_t StreamedTextures = 0; // Textures that have more than their tail mips resident or on the way
+		uint32_t PendingUploads = 0;
+		uint64_t StreamedMemory = 0; // Size of the resident mips of the streamed textures
+		uint64_t Budget = 0;
+	};
+
+	class TextureStreamer
+	{
+	public:
+		static void Init();
+		static void Shutdown();
+
+		// Called once per frame from the main thread, swaps in finished uploads and resolves the requests of the last frame
+		static void Update();
+
+		// Finest mip the texture needs this frame, textures that are not streaming are ignored. Main thread only
+		static void RequestMip(const Ref<Texture2D>& texture, uint32_t mip);
+		// Mip that gives roughly one texel per pixel for a texture that covers screenSize pixels across
+		static uint32_t CalculateRequiredMip(const Ref<Texture2D>& texture, float screenSize);
+
+		static TextureStreamingStats GetStats();
+	};
+
+}
\ No newline at end of file
@@ -2,14 +2,11 @@
 #include "VertexBuffer.h"
 
 #include "Renderer/Core/RendererContext.h"
+#include "Renderer/Core/UploadManager.h"
 #include "Renderer/Renderer.h"
 
 namespace Iris {
 
-	/*
-	 * TODO: Look at the IMPORTANT NOTE written in Renderer/Core/Device.h about using StagingBuffers in a better more sophisticated way
-	 */
-
 	VertexBuffer::VertexBuffer(const void* data, uint32_t size, VertexBufferUsage usage)
 		: m_Size(size)
 	{
@@ -19,24 +16,8 @@ namespace Iris {
 		Ref<VertexBuffer> instance = this;
 		Renderer::Submit([instance]() mutable
 		{
-			Ref<VulkanDevice> device = RendererContext::GetCurrentDevice();
 			VulkanAllocator allocator("VertexBuffer");
 
-			VkBuffer stagingBuffer;
-			VkBufferCreateInfo stagingInfo = {
-				.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-				.size = instance->m_Size,
-				.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				.sharingMode = VK_SHARING_MODE_EXCLUSIVE
-			};
-
-			VmaAllocation stagingBufferAlloc = allocator.AllocateBuffer(&stagingInfo, VMA_MEMORY_USAGE_CPU_TO_GPU, &stagingBuffer);
-
-			uint8_t* dstdata = allocator.MapMemory<uint8_t>(stagingBufferAlloc);
-			std::memcpy(dstdata, instance->m_LocalData.Data, instance->m_LocalData.Size);
-			allocator.UnmapMemory(stagingBufferAlloc);
-
-			// We need to copy now
 			VkBufferCreateInfo vertexBufferInfo = {
 				.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
 				.size = instance->m_Size,
@@ -46,23 +27,8 @@ namespace Iris {
 
 			instance->m_MemoryAllocation = allocator.AllocateBuffer(&vertexBufferInfo, VMA_MEMORY_USAGE_GPU_ONLY, &(instance->m_VulkanBuffer));
 
-			// TODO: Refer to the note in Renderer/Core/Device.h since maybe we could just begin and return a pre-allocated buffer?
-			VkCommandBuffer commandBuffer = device->GetCommandBuffer(true);
-
-			VkBufferCopy copyRegion = {
-				.srcOffset = 0,
-				.dstOffset = 0,
-				.size = instance->m_Size
-			};
-
-			vkCmdCopyBuffer(commandBuffer, stagingBuffer, instance->m_VulkanBuffer, 1, &copyRegion);
-
-			// TODO: Refer to the note in Renderer/Core/Device.h since we do not want to do this really...
-			device->FlushCommandBuffer(commandBuffer);
-
-			// NOTE: If we implement the note written in Device.h we would defer this cleanup to the beginning of the next frame.
-			// Renderer::SubmitResourceFree
-			allocator.DestroyBuffer(stagingBufferAlloc, stagingBuffer);
+			// The copy is batched with the other uploads and submitted before the next command buffer that could use the buffer
+			UploadManager::UploadBuffer(instance->m_VulkanBuffer, instance->m_LocalData.Data, instance->m_Size);
 		});
 	}
 
@@ -12,6 +12,10 @@
 
 namespace Iris {
 
+	// Used to find out which assets are still referenced by any scene (editor, runtime, material previews...)
+	static std::unordered_set<Scene*> s_LiveScenes;
+	static std::mutex s_LiveScenesMutex;
+
 	Ref<Scene> Scene::Create(const std::string& name, bool isEditorScene)
 	{
 		return CreateRef<Scene>(name, isEditorScene);
@@ -25,10 +29,17 @@ namespace Iris {
 	Scene::Scene(const std::string& name, bool isEditorScene)
 		: m_Name(name), m_IsEditorScene(isEditorScene)
 	{
+		std::scoped_lock<std::mutex> lock(s_LiveScenesMutex);
+		s_LiveScenes.insert(this);
 	}
 
 	Scene::~Scene()
 	{
+		{
+			std::scoped_lock<std::mutex> lock(s_LiveScenesMutex);
+			s_LiveScenes.erase(this);
+		}
+
 		m_Registry.clear();
 	}
 
@@ -48,6 +59,23 @@ namespace Iris {
 		// NOTE: Should update some state for physics/scripting/animations but for now nothing...
 	}
 
+	// Assets of entities in front of the camera are loaded first, then the ones close to it
+	static AssetLoadPriority GetAssetLoadPriority(const EditorCamera& camera, float cosViewConeAngle, const glm::vec3& position)
+	{
+		glm::vec3 toEntity = position - camera.GetPosition();
+		float distance = glm::length(toEntity);
+		if (distance < 0.001f)
+			return AssetLoadPriority::Visible;
+
+		if (distance <= camera.GetFarClip() && glm::dot(toEntity / distance, camera.GetForwardDirection()) >= cosViewConeAngle)
+			return AssetLoadPriority::Visible;
+
+		if (distance <= 0.1f * camera.GetFarClip())
+			return AssetLoadPriority::NearCamera;
+
+		return AssetLoadPriority::Normal;
+	}
+
 	void Scene::OnRenderEditor(Ref<SceneRenderer> renderer, TimeStep ts, const EditorCamera& camera)
 	{
 		// Render the scene
@@ -152,6 +180,10 @@ namespace Iris {
 			renderer->SetScene(this);
 			renderer->BeginScene({ camera, camera.GetViewMatrix(), camera.GetNearClip(), camera.GetFarClip(), camera.GetFOV() });
 
+			// Cone around the view direction that encloses the view frustum (half of the diagonal field of view)
+			const float tanHalfFOV = glm::tan(camera.GetFOV() * 0.5f);
+			const float cosViewConeAngle = glm::cos(glm::atan(tanHalfFOV * glm::sqrt(1.0f + camera.GetAspectRatio() * camera.GetAspectRatio())));
+
 			// Render static meshes
 			auto entities = GetAllEntitiesWith<StaticMeshComponent>();
 			for (auto entity : entities)
@@ -160,22 +192,23 @@ namespace Iris {
 				if (!staticMeshComponenet.Visible)
 					continue;
 
-				AsyncAssetResult<StaticMesh> staticMeshResult = AssetManager::GetAssetAsync<StaticMesh>(staticMeshComponenet.StaticMesh);
+				Entity e = { entity, this };
+				glm::mat4 transform = GetWorldSpaceTransformMatrix(e);
+				AssetLoadPriority loadPriority = GetAssetLoadPriority(camera, cosViewConeAngle, glm::vec3(transform[3]));
+
+				AsyncAssetResult<StaticMesh> staticMeshResult = AssetManager::GetAssetAsync<StaticMesh>(staticMeshComponenet.StaticMesh, loadPriority);
 				if (staticMeshResult.IsReady)
 				{
 					Ref<StaticMesh> staticMesh = staticMeshResult;
-					AsyncAssetResult<MeshSource> meshSourceResult = AssetManager::GetAssetAsync<MeshSource>(staticMesh->GetMeshSource());
+					AsyncAssetResult<MeshSource> meshSourceResult = AssetManager::GetAssetAsync<MeshSource>(staticMesh->GetMeshSource(), loadPriority);
 					if (meshSourceResult.IsReady)
 					{
 						Ref<MeshSource> meshSource = meshSourceResult;
 
-						Entity e = { entity, this };
-						glm::mat4 transform = GetWorldSpaceTransformMatrix(e);
-
 						if (SelectionManager::IsEntityOrAncestorSelected(e))
-							renderer->SubmitSelectedStaticMesh(staticMesh, meshSource, staticMeshComponenet.MaterialTable, transform);
+							renderer->SubmitSelectedStaticMesh(e.GetUUID(), staticMesh, meshSource, staticMeshComponenet.MaterialTable, transform);
 						else
-							renderer->SubmitStaticMesh(staticMesh, meshSource, staticMeshComponenet.MaterialTable, transform);
+							renderer->SubmitStaticMesh(e.GetUUID(), staticMesh, meshSource, staticMeshComponenet.MaterialTable, transform);
 					}
 				}
 			}
@@ -201,7 +234,7 @@ namespace Iris {
 						{
 							if (AssetManager::IsAssetHandleValid(spriteRendererComponent.Texture))
 							{
-								Ref<Texture2D> texture = AssetManager::GetAssetAsync<Texture2D>(spriteRendererComponent.Texture);
+								Ref<Texture2D> texture = AssetManager::GetAssetAsync<Texture2D>(spriteRendererComponent.Texture, AssetLoadPriority::Visible);
 								renderer2D->DrawQuad(
 									GetWorldSpaceTransformMatrix(e),
 									texture,
@@ -424,7 +457,7 @@ namespace Iris {
 
 	Entity Scene::InstantiateStaticMesh(Ref<StaticMesh> staticMesh)
 	{
-		AssetMetaData& assetMetaData = Project::GetEditorAssetManager()->GetMetaData(staticMesh->Handle);
+		AssetMetaData assetMetaData = Project::GetEditorAssetManager()->GetMetaData(staticMesh->Handle);
 		Entity rootEntity = CreateEntity(assetMetaData.FilePath.stem().string());
 		Ref<MeshSource> meshSource = AssetManager::GetAssetAsync<MeshSource>(staticMesh->GetMeshSource());
 		if (meshSource)
@@ -433,6 +466,32 @@ namespace Iris {
 		return rootEntity;
 	}
 
+	AssetTask Scene::InstantiateStaticMeshAsync(AssetHandle staticMeshHandle, std::function<void(Entity)> onInstantiated)
+	{
+		// Keep the scene alive while waiting
+		Ref<Scene> scene = this;
+
+		Ref<StaticMesh> staticMesh = co_await AssetManager::LoadAsync<StaticMesh>(staticMeshHandle);
+		if (!staticMesh)
+			co_return;
+
+		Ref<MeshSource> meshSource = co_await AssetManager::LoadAsync<MeshSource>(staticMesh->GetMeshSource());
+		if (!meshSource)
+			co_return;
+
+		// Copy the handles since the material table could change while waiting
+		std::vector<AssetHandle> materials;
+		for (const auto& [index, materialHandle] : staticMesh->GetMaterials()->GetMaterials())
+			materials.push_back(materialHandle);
+
+		for (AssetHandle materialHandle : materials)
+			co_await AssetManager::LoadAsync<MaterialAsset>(materialHandle);
+
+		Entity rootEntity = InstantiateStaticMesh(staticMesh);
+		if (onInstantiated)
+			onInstantiated(rootEntity);
+	}
+
 	void Scene::ConvertToLocalSpace(Entity entity)
 	{
 		Entity parent = TryGetEntityWithUUID(entity.GetParentUUID());
@@ -613,4 +672,41 @@ namespace Iris {
 			BuildMeshEntityHierarchy(nodeEntity, staticMesh, nodes[child]);
 	}
 
+	void Scene::GetAssetUsageCounts(std::unordered_map<AssetHandle, uint32_t>& outUsageCounts)
+	{
+		auto addReference = [&outUsageCounts](AssetHandle handle)
+		{
+			if (handle)
+				outUsageCounts[handle]++;
+		};
+
+		std::scoped_lock<std::mutex> lock(s_LiveScenesMutex);
+		for (Scene* scene : s_LiveScenes)
+		{
+			auto staticMeshes = scene->m_Registry.view<StaticMeshComponent>();
+			for (auto entity : staticMeshes)
+			{
+				const StaticMeshComponent& staticMeshComponent = staticMeshes.get<StaticMeshComponent>(entity);
+				addReference(staticMeshComponent.StaticMesh);
+				if (staticMeshComponent.MaterialTable)
+				{
+					for (const auto& [index, materialHandle] : staticMeshComponent.MaterialTable->GetMaterials())
+						addReference(materialHandle);
+				}
+			}
+
+			auto sprites = scene->m_Registry.view<SpriteRendererComponent>();
+			for (auto entity : sprites)
+				addReference(sprites.get<SpriteRendererComponent>(entity).Texture);
+
+			auto texts = scene->m_Registry.view<TextComponent>();
+			for (auto entity : texts)
+				addReference(texts.get<TextComponent>(entity).Font);
+
+			auto skyLights = scene->m_Registry.view<SkyLightComponent>();
+			for (auto entity : skyLights)
+				addReference(skyLights.get<SkyLightComponent>(entity).SceneEnvironment);
+		}
+	}
+
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Entity.h"
 
+#include "AssetManager/Asset/AssetTask.h"
 #include "Core/TimeStep.h"
 #include "Core/UUID.h"
 #include "Editor/EditorCamera.h"
@@ -70,6 +71,8 @@ namespace Iris {
 		Entity DuplicateEntity(Entity entity);
 
 		Entity InstantiateStaticMesh(Ref<StaticMesh> staticMesh);
+		// Waits for the static mesh, its mesh source and materials to be loaded before building the entity hierarchy, onInstantiated gets the root entity
+		AssetTask InstantiateStaticMeshAsync(AssetHandle staticMeshHandle, std::function<void(Entity)> onInstantiated = {});
 
 		template<typename... Componenets>
 		auto GetAllEntitiesWith()
@@ -127,6 +130,9 @@ namespace Iris {
 			srcScene->CopyComponentIfExists<TComponent>((entt::entity)dst, dstScene->m_Registry, (entt::entity)src);
 		}
 
+		// Adds up how many components of all the live scenes reference each asset, the asset manager never evicts referenced assets
+		static void GetAssetUsageCounts(std::unordered_map<AssetHandle, uint32_t>& outUsageCounts);
+
 		static AssetType GetStaticType() { return AssetType::Scene; }
 		virtual AssetType GetAssetType() const override { return GetStaticType(); }
 
@@ -2,6 +2,8 @@
 
 #include "AssetManager/Asset/Asset.h"
 #include "Renderer/Renderer.h"
+#include "Renderer/SphericalHarmonics.h"
+#include "Renderer/Texture.h"
 
 namespace Iris {
 
@@ -11,6 +13,10 @@ namespace Iris {
 		Ref<TextureCube> RadianceMap;
 		Ref<TextureCube> IrradianceMap;
 
+		// Only used with RendererConfiguration::SphericalHarmonicsIrradiance, IrradianceMap is then left black. Written and read on the render thread
+		SHCoefficients IrradianceSH = {};
+		bool HasIrradianceSH = false;
+
 		Environment() = default;
 		Environment(const Ref<TextureCube>& radianceMap, const Ref<TextureCube>& irradianceMap)
 			: RadianceMap(radianceMap), IrradianceMap(irradianceMap) {}
@@ -20,6 +26,16 @@ namespace Iris {
 			return CreateRef<Environment>(radianceMap, irradianceMap);
 		}
 
+		virtual uint64_t GetCPUMemoryUsage() const override
+		{
+			return (RadianceMap ? RadianceMap->GetCPUMemoryUsage() : 0) + (IrradianceMap ? IrradianceMap->GetCPUMemoryUsage() : 0);
+		}
+
+		virtual uint64_t GetGPUMemoryUsage() const override
+		{
+			return (RadianceMap ? RadianceMap->GetGPUMemoryUsage() : 0) + (IrradianceMap ? IrradianceMap->GetGPUMemoryUsage() : 0);
+		}
+
 		static AssetType GetStaticType() { return AssetType::EnvironmentMap; }
 		virtual AssetType GetAssetType() const override { return GetStaticType(); }
 	};
@@ -0,0 +1,271 @@
+#include "IrisPCH.h"
+#include "FileWatcher.h"
+
+namespace Iris {
+
+	/*
+	 * Currently this only works on windows since we use ReadDirectoryChangesW
+	 */
+
+	namespace Utils {
+
+		// Merges a new change into the pending one for the same path, returns false if both cancel each other out
+		static bool CoalesceFileSystemChange(FileSystemChange& pending, const FileSystemChange& incoming)
+		{
+			switch (pending.Action)
+			{
+				case FileSystemAction::Added:
+				{
+					// Nobody knows about the path yet so it stays an addition untill it is gone again
+					if (incoming.Action == FileSystemAction::Removed)
+						return false;
+
+					pending.IsDirectory = incoming.IsDirectory;
+					return true;
+				}
+				case FileSystemAction::Removed:
+				{
+					// Deleted and written again (or another file moved on top of it) is just a modification for whoever knew the old file
+					pending = incoming;
+					if (incoming.Action != FileSystemAction::Removed)
+					{
+						pending.Action = FileSystemAction::Modified;
+						pending.OldFilePath.clear();
+					}
+					return true;
+				}
+				case FileSystemAction::Modified:
+				{
+					if (incoming.Action == FileSystemAction::Removed)
+						pending.Action = FileSystemAction::Removed;
+
+					return true;
+				}
+				case FileSystemAction::Renamed:
+				{
+					// Whoever knew the file only knows it by its old name
+					if (incoming.Action == FileSystemAction::Removed)
+					{
+						pending.Action = FileSystemAction::Removed;
+						pending.FilePath = pending.OldFilePath;
+						pending.OldFilePath.clear();
+					}
+
+					return true;
+				}
+			}
+
+			pending = incoming;
+			return true;
+		}
+
+	}
+
+	Ref<FileWatcher> FileWatcher::Create(const std::filesystem::path& directory, float debounceTime)
+	{
+		return CreateRef<FileWatcher>(directory, debounceTime);
+	}
+
+	FileWatcher::FileWatcher(const std::filesystem::path& directory, float debounceTime)
+		: m_Directory(directory), m_DebounceTime(debounceTime), m_Thread("File Watcher", 0)
+	{
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		Stop();
+	}
+
+	void FileWatcher::Start()
+	{
+		if (m_Running)
+			return;
+
+		HANDLE directoryHandle = CreateFileW(
+			m_Directory.c_str(),
+			FILE_LIST_DIRECTORY,
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+			nullptr
+		);
+
+		if (directoryHandle == INVALID_HANDLE_VALUE)
+		{
+			IR_CORE_ERROR_TAG("FileWatcher", "Failed to open directory {} for watching (error: {})", m_Directory.string(), GetLastError());
+			return;
+		}
+
+		m_DirectoryHandle = directoryHandle;
+		m_StopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		m_Running = true;
+
+		m_Thread.Dispatch([this]() { WatcherThreadFunc(); });
+	}
+
+	void FileWatcher::Stop()
+	{
+		if (!m_Running)
+			return;
+
+		SetEvent(m_StopEvent);
+		m_Thread.Join();
+
+		CloseHandle(m_DirectoryHandle);
+		CloseHandle(m_StopEvent);
+		m_DirectoryHandle = nullptr;
+		m_StopEvent = nullptr;
+		m_Running = false;
+
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		m_PendingChanges.clear();
+	}
+
+	bool FileWatcher::RetrieveChanges(std::vector<FileSystemChange>& outChanges)
+	{
+		outChanges.clear();
+
+		Clock::time_point now = Clock::now();
+		std::chrono::duration<float> debounceTime(m_DebounceTime);
+
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			for (auto it = m_PendingChanges.begin(); it != m_PendingChanges.end();)
+			{
+				if (now - it->second.LastEventTime < debounceTime)
+				{
+					++it;
+					continue;
+				}
+
+				outChanges.push_back(std::move(it->second.Change));
+				it = m_PendingChanges.erase(it);
+			}
+		}
+
+		// So that directories always come before their content
+		std::sort(outChanges.begin(), outChanges.end(), [](const FileSystemChange& a, const FileSystemChange& b) { return a.FilePath < b.FilePath; });
+
+		return !outChanges.empty();
+	}
+
+	void FileWatcher::WatcherThreadFunc()
+	{
+		constexpr DWORD notifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+		// ReadDirectoryChangesW needs a DWORD aligned buffer, 64KB is the limit for network drives
+		alignas(DWORD) static thread_local uint8_t buffer[64 * 1024];
+
+		OVERLAPPED overlapped = {};
+		overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+		HANDLE waitHandles[] = { overlapped.hEvent, m_StopEvent };
+
+		std::filesystem::path renamedFromPath;
+		while (true)
+		{
+			ResetEvent(overlapped.hEvent);
+			if (!ReadDirectoryChangesW(m_DirectoryHandle, buffer, sizeof(buffer), TRUE, notifyFilter, nullptr, &overlapped, nullptr))
+			{
+				IR_CORE_ERROR_TAG("FileWatcher", "Failed to watch directory {} (error: {})", m_Directory.string(), GetLastError());
+				break;
+			}
+
+			DWORD bytesTransferred = 0;
+			if (WaitForMultipleObjects(2, waitHandles, FALSE, INFINITE) != WAIT_OBJECT_0)
+			{
+				// Stop requested, the pending read has to finish before the buffer goes away
+				CancelIoEx(m_DirectoryHandle, &overlapped);
+				GetOverlappedResult(m_DirectoryHandle, &overlapped, &bytesTransferred, TRUE);
+				break;
+			}
+
+			if (!GetOverlappedResult(m_DirectoryHandle, &overlapped, &bytesTransferred, FALSE))
+				break;
+
+			// The OS could not fit all the notifications into our buffer so we do not know what changed
+			if (bytesTransferred == 0)
+			{
+				IR_CORE_WARN_TAG("FileWatcher", "Notification buffer overflowed, {} will be rescanned", m_Directory.string());
+				PushChange(FileSystemAction::Modified, m_Directory);
+				continue;
+			}
+
+			std::size_t offset = 0;
+			while (true)
+			{
+				const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer + offset);
+				std::filesystem::path filePath = m_Directory / std::wstring_view(info->FileName, info->FileNameLength / sizeof(WCHAR));
+
+				switch (info->Action)
+				{
+					case FILE_ACTION_ADDED:				PushChange(FileSystemAction::Added, filePath); break;
+					case FILE_ACTION_REMOVED:			PushChange(FileSystemAction::Removed, filePath); break;
+					case FILE_ACTION_MODIFIED:			PushChange(FileSystemAction::Modified, filePath); break;
+					case FILE_ACTION_RENAMED_OLD_NAME:	renamedFromPath = filePath; break;
+					case FILE_ACTION_RENAMED_NEW_NAME:	PushChange(FileSystemAction::Renamed, filePath, renamedFromPath); break;
+				}
+
+				if (info->NextEntryOffset == 0)
+					break;
+
+				offset += info->NextEntryOffset;
+			}
+		}
+
+		CloseHandle(overlapped.hEvent);
+	}
+
+	void FileWatcher::PushChange(FileSystemAction action, const std::filesystem::path& filePath, const std::filesystem::path& oldFilePath)
+	{
+		std::error_code ec;
+		bool isDirectory = action != FileSystemAction::Removed && std::filesystem::is_directory(filePath, ec);
+
+		// Directories get modified whenever something inside of them changes, which we already get notified about
+		if (action == FileSystemAction::Modified && isDirectory && filePath != m_Directory)
+			return;
+
+		FileSystemChange change = { .Action = action, .FilePath = filePath, .OldFilePath = oldFilePath, .IsDirectory = isDirectory };
+
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		if (action == FileSystemAction::Renamed)
+		{
+			auto oldIt = m_PendingChanges.find(oldFilePath.generic_string());
+			if (oldIt != m_PendingChanges.end())
+			{
+				const FileSystemChange& oldChange = oldIt->second.Change;
+				if (oldChange.Action == FileSystemAction::Added)
+				{
+					// Nobody has seen the old name yet (ex. temporary files that get renamed on save)
+					change.Action = FileSystemAction::Added;
+					change.OldFilePath.clear();
+				}
+				else if (oldChange.Action == FileSystemAction::Renamed)
+				{
+					change.OldFilePath = oldChange.OldFilePath;
+				}
+
+				m_PendingChanges.erase(oldIt);
+			}
+		}
+
+		std::string key = filePath.generic_string();
+		auto it = m_PendingChanges.find(key);
+		if (it == m_PendingChanges.end())
+		{
+			m_PendingChanges[key] = { change, Clock::now() };
+			return;
+		}
+
+		if (!Utils::CoalesceFileSystemChange(it->second.Change, change))
+		{
+			m_PendingChanges.erase(it);
+			return;
+		}
+
+		it->second.LastEventTime = Clock::now();
+	}
+
+}
\ No newline at end of file
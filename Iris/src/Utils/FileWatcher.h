@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Core/Base.h"
+#include "Core/Thread.h"
+
+#include <filesystem>
+
+/*
+ * Watches a directory tree for changes on a background thread using ReadDirectoryChangesW
+ * - Bursts of notifications for the same path are coalesced into one change (ex. an editor saving a file usually triggers several modifications)
+ * - Changes are only handed out once the path has been quiet for the debounce time so that we do not pick up half written files
+ * - In case the OS notification buffer overflows, a Modified change for the watched directory itself is reported which means that everything has to be rescanned
+ */
+
+namespace Iris {
+
+	enum class FileSystemAction : uint8_t
+	{
+		None = 0,
+		Added,
+		Removed,
+		Modified,
+		Renamed
+	};
+
+	struct FileSystemChange
+	{
+		FileSystemAction Action = FileSystemAction::None;
+		std::filesystem::path FilePath; // Watched directory / path relative to it
+		std::filesystem::path OldFilePath; // Only set for renames
+		bool IsDirectory = false;
+	};
+
+	class FileWatcher : public RefCountedObject
+	{
+	public:
+		FileWatcher(const std::filesystem::path& directory, float debounceTime = 0.2f);
+		~FileWatcher();
+
+		[[nodiscard]] static Ref<FileWatcher> Create(const std::filesystem::path& directory, float debounceTime = 0.2f);
+
+		void Start();
+		void Stop();
+
+		bool IsRunning() const { return m_Running; }
+		const std::filesystem::path& GetDirectory() const { return m_Directory; }
+
+		// Returns false if there are no changes that settled yet
+		bool RetrieveChanges(std::vector<FileSystemChange>& outChanges);
+
+	private:
+		void WatcherThreadFunc();
+		void PushChange(FileSystemAction action, const std::filesystem::path& filePath, const std::filesystem::path& oldFilePath = {});
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct PendingChange
+		{
+			FileSystemChange Change;
+			Clock::time_point LastEventTime;
+		};
+
+		std::filesystem::path m_Directory;
+		float m_DebounceTime = 0.2f;
+
+		Thread m_Thread;
+		bool m_Running = false;
+		void* m_DirectoryHandle = nullptr;
+		void* m_StopEvent = nullptr;
+
+		std::mutex m_Mutex;
+		// Keyed by the generic string of the path, renames are keyed by their new path
+		std::unordered_map<std::string, PendingChange> m_PendingChanges;
+
+	};
+
+}
\ No newline at end of file
@@ -3,8 +3,216 @@
 
 #include <stb_image/stb_image.h>
 
+#include <bit>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
 namespace Iris::Utils {
 
+    // Largest values the formats can hold, anything above gets clamped instead of turning into infinity
+    static constexpr float s_MaxHalf = 65504.0f;
+    static constexpr float s_MaxFloat11 = 65024.0f;
+    static constexpr float s_MaxFloat10 = 64512.0f;
+    static constexpr float s_MaxSharedExponent = 65408.0f;
+
+    // Channels darker than this are compared in absolute terms since the relative error of near black values does not mean much
+    static constexpr float s_RelativeErrorFloor = 1.0f / 1024.0f;
+
+    // The small float formats share the exponent bias of halfs (15) and only differ in their mantissa bits
+    static uint32_t PackUnsignedSmallFloat(float value, float maxValue, uint32_t mantissaBits)
+    {
+        if (!(value > 0.0f))
+            return 0;
+
+        value = glm::min(value, maxValue);
+
+        // Below 2^-14 the value is a denormal in the small format which is just the value in units of the smallest denormal
+        if (value < 0x1.0p-14f)
+            return static_cast<uint32_t>(std::nearbyint(std::ldexp(value, 14 + mantissaBits)));
+
+        // Rebias the exponent from 127 to 15 and shift the mantissa down with round to nearest even
+        const uint32_t shift = 23 - mantissaBits;
+        const uint32_t bits = std::bit_cast<uint32_t>(value) - (112u << 23);
+        return (bits + (1u << (shift - 1)) - 1 + ((bits >> shift) & 1)) >> shift;
+    }
+
+    static float UnpackUnsignedSmallFloat(uint32_t value, uint32_t mantissaBits)
+    {
+        if ((value >> mantissaBits) == 0)
+            return std::ldexp(static_cast<float>(value), -14 - static_cast<int>(mantissaBits));
+
+        return std::bit_cast<float>((value << (23 - mantissaBits)) + (112u << 23));
+    }
+
+    static uint16_t FloatToHalf(float value)
+    {
+        if (value != value)
+            return 0;
+
+        const uint32_t sign = (std::bit_cast<uint32_t>(value) >> 16) & 0x8000;
+        return static_cast<uint16_t>(sign | PackUnsignedSmallFloat(glm::abs(value), s_MaxHalf, 10));
+    }
+
+    static float HalfToFloat(uint16_t value)
+    {
+        const float result = UnpackUnsignedSmallFloat(value & 0x7fff, 10);
+        return (value & 0x8000) ? -result : result;
+    }
+
+    static uint32_t PackB10G11R11(const float* rgb)
+    {
+        return PackUnsignedSmallFloat(rgb[0], s_MaxFloat11, 6) | (PackUnsignedSmallFloat(rgb[1], s_MaxFloat11, 6) << 11) | (PackUnsignedSmallFloat(rgb[2], s_MaxFloat10, 5) << 22);
+    }
+
+    static void UnpackB10G11R11(uint32_t value, float* rgb)
+    {
+        rgb[0] = UnpackUnsignedSmallFloat(value & 0x7ff, 6);
+        rgb[1] = UnpackUnsignedSmallFloat((value >> 11) & 0x7ff, 6);
+        rgb[2] = UnpackUnsignedSmallFloat(value >> 22, 5);
+    }
+
+    // Follows the shared exponent conversion in the Vulkan spec (N = 9 mantissa bits, B = 15 exponent bias)
+    static uint32_t PackE5B9G9R9(const float* rgb)
+    {
+        float channels[3];
+        for (uint32_t c = 0; c < 3; c++)
+            channels[c] = rgb[c] > 0.0f ? glm::min(rgb[c], s_MaxSharedExponent) : 0.0f;
+
+        const float maxChannel = glm::max(channels[0], glm::max(channels[1], channels[2]));
+
+        // max(-B - 1, floor(log2(maxChannel))) + 1 + B, the floor(log2) is read straight from the exponent bits
+        uint32_t exponent = glm::max(std::bit_cast<uint32_t>(maxChannel) >> 23, 111u) - 111;
+        // 2^-(exponent - B - N)
+        float scale = std::bit_cast<float>((151 - exponent) << 23);
+        if (static_cast<uint32_t>(maxChannel * scale + 0.5f) == 512)
+        {
+            exponent++;
+            scale *= 0.5f;
+        }
+
+        uint32_t result = exponent << 27;
+        for (uint32_t c = 0; c < 3; c++)
+            result |= static_cast<uint32_t>(channels[c] * scale + 0.5f) << (c * 9);
+
+        return result;
+    }
+
+    static void UnpackE5B9G9R9(uint32_t value, float* rgb)
+    {
+        const float scale = std::bit_cast<float>(((value >> 27) + 103) << 23);
+        for (uint32_t c = 0; c < 3; c++)
+            rgb[c] = static_cast<float>((value >> (c * 9)) & 0x1ff) * scale;
+    }
+
+#if defined(__AVX2__)
+    // Same as PackUnsignedSmallFloat for 4 values
+    template<int MantissaBits>
+    static __m128i PackUnsignedSmallFloat4(__m128 value, __m128 maxValue)
+    {
+        constexpr int shift = 23 - MantissaBits;
+
+        // max with the value as the first operand turns NaNs into 0
+        value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), maxValue);
+
+        const __m128i bits = _mm_sub_epi32(_mm_castps_si128(value), _mm_set1_epi32(112 << 23));
+        const __m128i lsb = _mm_and_si128(_mm_srli_epi32(bits, shift), _mm_set1_epi32(1));
+        const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32((1 << (shift - 1)) - 1)), lsb), shift);
+        const __m128i denormal = _mm_cvtps_epi32(_mm_mul_ps(value, _mm_set1_ps(static_cast<float>(1 << (14 + MantissaBits)))));
+
+        return _mm_blendv_epi8(normal, denormal, _mm_castps_si128(_mm_cmplt_ps(value, _mm_set1_ps(0x1.0p-14f))));
+    }
+
+    // Converts as many texels as it can in groups and returns how many it converted, the rest is left for the scalar path.
+    // Every group is read before anything is written and the destination never runs ahead of the source, so this works in place
+    static uint64_t ConvertHDRImageSIMD(uint8_t* data, uint64_t texelCount, ImageFormat format)
+    {
+        const float* src = reinterpret_cast<const float*>(data);
+        uint64_t texel = 0;
+
+        switch (format)
+        {
+            case ImageFormat::RGBA16F:
+            {
+                const __m256 maxHalf = _mm256_set1_ps(s_MaxHalf);
+                const __m256 minHalf = _mm256_set1_ps(-s_MaxHalf);
+                for (; texel + 2 <= texelCount; texel += 2)
+                {
+                    __m256 value = _mm256_loadu_ps(src + texel * 4);
+                    value = _mm256_and_ps(value, _mm256_cmp_ps(value, value, _CMP_ORD_Q));
+                    value = _mm256_min_ps(_mm256_max_ps(value, minHalf), maxHalf);
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + texel * 8), _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+                }
+
+                break;
+            }
+            case ImageFormat::B10R11G11UF:
+            {
+                const __m128 maxFloat11 = _mm_set1_ps(s_MaxFloat11);
+                const __m128 maxFloat10 = _mm_set1_ps(s_MaxFloat10);
+                for (; texel + 4 <= texelCount; texel += 4)
+                {
+                    __m128 r = _mm_loadu_ps(src + texel * 4 + 0);
+                    __m128 g = _mm_loadu_ps(src + texel * 4 + 4);
+                    __m128 b = _mm_loadu_ps(src + texel * 4 + 8);
+                    __m128 a = _mm_loadu_ps(src + texel * 4 + 12);
+                    _MM_TRANSPOSE4_PS(r, g, b, a);
+
+                    __m128i packed = PackUnsignedSmallFloat4<6>(r, maxFloat11);
+                    packed = _mm_or_si128(packed, _mm_slli_epi32(PackUnsignedSmallFloat4<6>(g, maxFloat11), 11));
+                    packed = _mm_or_si128(packed, _mm_slli_epi32(PackUnsignedSmallFloat4<5>(b, maxFloat10), 22));
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + texel * 4), packed);
+                }
+
+                break;
+            }
+            case ImageFormat::E5B9G9R9UF:
+            {
+                const __m128 maxValue = _mm_set1_ps(s_MaxSharedExponent);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 half = _mm_set1_ps(0.5f);
+                const __m128i minExponent = _mm_set1_epi32(111);
+                const __m128i scaleBias = _mm_set1_epi32(151);
+                for (; texel + 4 <= texelCount; texel += 4)
+                {
+                    __m128 r = _mm_loadu_ps(src + texel * 4 + 0);
+                    __m128 g = _mm_loadu_ps(src + texel * 4 + 4);
+                    __m128 b = _mm_loadu_ps(src + texel * 4 + 8);
+                    __m128 a = _mm_loadu_ps(src + texel * 4 + 12);
+                    _MM_TRANSPOSE4_PS(r, g, b, a);
+
+                    r = _mm_min_ps(_mm_max_ps(r, zero), maxValue);
+                    g = _mm_min_ps(_mm_max_ps(g, zero), maxValue);
+                    b = _mm_min_ps(_mm_max_ps(b, zero), maxValue);
+                    const __m128 maxChannel = _mm_max_ps(r, _mm_max_ps(g, b));
+
+                    // Same steps as PackE5B9G9R9
+                    __m128i exponent = _mm_sub_epi32(_mm_max_epi32(_mm_srli_epi32(_mm_castps_si128(maxChannel), 23), minExponent), minExponent);
+                    __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(scaleBias, exponent), 23));
+
+                    const __m128i maxScaled = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(maxChannel, scale), half));
+                    exponent = _mm_sub_epi32(exponent, _mm_cmpeq_epi32(maxScaled, _mm_set1_epi32(512)));
+                    scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(scaleBias, exponent), 23));
+
+                    __m128i packed = _mm_slli_epi32(exponent, 27);
+                    packed = _mm_or_si128(packed, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(r, scale), half)));
+                    packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g, scale), half)), 9));
+                    packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(b, scale), half)), 18));
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + texel * 4), packed);
+                }
+
+                break;
+            }
+        }
+
+        return texel;
+    }
+#endif
+
     Buffer TextureImporter::LoadImageFromFile(const std::string& filename, ImageFormat& outFormat, uint32_t& imageWidth, uint32_t& imageHeight)
 	{
 		Buffer result;
@@ -58,6 +266,103 @@ namespace Iris::Utils {
         return result;
 	}
 
+    Buffer TextureImporter::ConvertHDRImage(Buffer imageData, ImageFormat format, HDRConversionError* outError)
+    {
+        IR_ASSERT(format == ImageFormat::RGBA16F || format == ImageFormat::B10R11G11UF || format == ImageFormat::E5B9G9R9UF);
+
+        const uint64_t texelCount = imageData.Size / (4 * sizeof(float));
+        uint64_t texel = 0;
+
+#if defined(__AVX2__)
+        // Measuring the error needs the source texels next to the converted ones so that goes through the scalar path
+        if (!outError)
+            texel = ConvertHDRImageSIMD(imageData.Data, texelCount, format);
+#endif
+
+        double errorSum = 0.0;
+        float maxError = 0.0f;
+        const float maxValue = format == ImageFormat::RGBA16F ? s_MaxHalf : format == ImageFormat::B10R11G11UF ? s_MaxFloat10 : s_MaxSharedExponent;
+        for (; texel < texelCount; texel++)
+        {
+            float source[4];
+            std::memcpy(source, imageData.Data + texel * sizeof(source), sizeof(source));
+
+            float decoded[4];
+            switch (format)
+            {
+                case ImageFormat::RGBA16F:
+                {
+                    uint16_t halfs[4];
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        halfs[c] = FloatToHalf(source[c]);
+                        decoded[c] = HalfToFloat(halfs[c]);
+                    }
+
+                    std::memcpy(imageData.Data + texel * sizeof(halfs), halfs, sizeof(halfs));
+                    break;
+                }
+                case ImageFormat::B10R11G11UF:
+                {
+                    const uint32_t packed = PackB10G11R11(source);
+                    UnpackB10G11R11(packed, decoded);
+
+                    std::memcpy(imageData.Data + texel * sizeof(packed), &packed, sizeof(packed));
+                    break;
+                }
+                case ImageFormat::E5B9G9R9UF:
+                {
+                    const uint32_t packed = PackE5B9G9R9(source);
+                    UnpackE5B9G9R9(packed, decoded);
+
+                    std::memcpy(imageData.Data + texel * sizeof(packed), &packed, sizeof(packed));
+                    break;
+                }
+            }
+
+            if (outError)
+            {
+                // Shared exponent channels are quantized in steps of the brightest channel so that is what their error is relative to
+                const float sharedReference = glm::max(source[0], glm::max(source[1], source[2]));
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    // Clamping is intended, it is not a precision loss of the format
+                    if (glm::abs(source[c]) > maxValue)
+                        continue;
+
+                    const float reference = format == ImageFormat::E5B9G9R9UF ? sharedReference : glm::abs(source[c]);
+                    const float error = glm::abs(decoded[c] - source[c]) / glm::max(reference, s_RelativeErrorFloor);
+                    errorSum += error;
+                    maxError = glm::max(maxError, error);
+                }
+            }
+        }
+
+        if (outError && texelCount > 0)
+        {
+            outError->MeanRelativeError = static_cast<float>(errorSum / static_cast<double>(texelCount * 3));
+            outError->MaxRelativeError = maxError;
+        }
+
+        return Buffer(imageData.Data, texelCount * GetImageFormatBPP(format));
+    }
+
+    float TextureImporter::GetHDRConversionErrorBound(ImageFormat format)
+    {
+        // Rounding to nearest is off by at most half a step of the mantissa, the shared exponent keeps the brightest channel at 8 bits or more.
+        // The small slack covers the float math of the error measurement itself
+        constexpr float slack = 1.01f;
+        switch (format)
+        {
+            case ImageFormat::RGBA16F:      return 0x1.0p-11f * slack;
+            case ImageFormat::B10R11G11UF:  return 0x1.0p-6f * slack; // Blue only has 5 mantissa bits
+            case ImageFormat::E5B9G9R9UF:   return 0x1.0p-9f * slack;
+        }
+
+        IR_ASSERT(false);
+        return 0.0f;
+    }
+
     void TextureImporter::FreeImageMemory(const uint8_t* data)
     {
         stbi_image_free((void*)data);
@@ -5,12 +5,25 @@
 
 namespace Iris::Utils {
 
+	struct HDRConversionError
+	{
+		// Per channel error relative to the source value (in absolute terms for near black values), alpha is not included
+		float MeanRelativeError = 0.0f;
+		float MaxRelativeError = 0.0f;
+	};
+
 	class TextureImporter
 	{
 	public:
 		static Buffer LoadImageFromFile(const std::string& filename, ImageFormat& outFormat, uint32_t& imageWidth, uint32_t& imageHeight);
 		static Buffer LoadImageFromMemory(Buffer buffer, ImageFormat& outFormat, uint32_t& imageWidth, uint32_t& imageHeight);
 
+		// Converts RGBA32F texels in place to RGBA16F, B10R11G11UF or E5B9G9R9UF (the packed formats drop alpha). The returned buffer points to the
+		// same memory with the size of the converted data, so it is still released the same way as imageData. Uses AVX2 when the build enables it
+		static Buffer ConvertHDRImage(Buffer imageData, ImageFormat format, HDRConversionError* outError = nullptr);
+		// Largest MaxRelativeError ConvertHDRImage can report for a format, values above the range of the format are clamped and not counted
+		static float GetHDRConversionErrorBound(ImageFormat format);
+
 		// NOTE: This exists since we load the images with stb which uses malloc and our Buffer class uses delete[] to clear memory.
 		// this malloc/delete mismatch could lead to UB
 		static void FreeImageMemory(const uint8_t* data);
@@ -13,7 +13,7 @@ const float Epsilon = 0.00001;
 const uint Samples = 1024;
 const float InvNumSamples = 1.0f / float(Samples);
 
-layout(set = 3, binding = 0, rgba32f) restrict writeonly uniform imageCube o_OutputCubeMap;
+layout(set = 3, binding = 0, rgba16f) restrict writeonly uniform imageCube o_OutputCubeMap;
 layout(set = 3, binding = 1) uniform samplerCube u_InputCubeMap;
 
 layout(push_constant) uniform Uniforms
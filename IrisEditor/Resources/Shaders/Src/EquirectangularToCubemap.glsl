@@ -7,7 +7,7 @@
 const float PI = 3.14159265358979323846f;
 const float TwoPI = 2 * PI;
 
-layout(set = 3, binding = 0, rgba32f) restrict writeonly uniform imageCube o_OutputCubeMap;
+layout(set = 3, binding = 0, rgba16f) restrict writeonly uniform imageCube o_OutputCubeMap;
 layout(set = 3, binding = 1) uniform sampler2D u_EquirectangularTexture;
 
 // So we get a 3D vector that points to a pixel inside on one of the cubemap faces based on the GlobalInvocationID inside
@@ -0,0 +1,170 @@
+#version 450 core
+#stage compute
+
+// Culls every static mesh instance of the scene against the view frustum and against the hierarchical depth buffer of the previous frame
+// Visible instances are appended to the instance range of their draw, GPUDrawCompaction.glsl then turns the per draw counts into indirect
+// draw commands
+
+struct InstanceData
+{
+	vec4 MatrixRow[3];
+	uint MaterialIndex;
+	uint DrawIndex;
+	uint Padding0;
+	uint Padding1;
+};
+
+struct DrawData
+{
+	uint IndexCount;
+	uint FirstIndex;
+	int VertexOffset;
+	uint FirstInstance; // Where the visible instances of the draw start in the culled instance buffer
+	uint Group;
+	uint Padding0;
+	uint Padding1;
+	uint Padding2;
+	vec4 BoundsMin; // Submesh bounding box in mesh space
+	vec4 BoundsMax;
+};
+
+layout(std140, set = 1, binding = 3) uniform CullingData
+{
+	mat4 ViewProjection;
+	mat4 PreviousViewProjection; // The hierarchical depth buffer was built with this
+	vec4 FrustumPlanes[6];
+	vec2 HiZSize;
+	uint HiZMipCount;
+	uint InstanceCount;
+	uint DrawCount;
+	uint HiZValid;
+} u_CullingData;
+
+layout(set = 2, binding = 0) uniform sampler2D u_HiZTexture;
+
+layout(std430, set = 2, binding = 2) readonly buffer InstanceInput
+{
+	InstanceData Instances[];
+} s_InstanceInput;
+
+layout(std430, set = 2, binding = 3) readonly buffer DrawInput
+{
+	DrawData Draws[];
+} s_DrawInput;
+
+// Same layout as the instance vertex buffer (3 matrix rows and the material index, 13 words per instance)
+layout(std430, set = 2, binding = 4) writeonly buffer CulledInstances
+{
+	uint Words[];
+} s_CulledInstances;
+
+layout(std430, set = 2, binding = 5) buffer DrawCounters
+{
+	uint VisibleCount[];
+} s_DrawCounters;
+
+const uint InstanceWordCount = 13;
+const uint InvalidDrawIndex = 0xFFFFFFFF; // Free slot, the instance that was in it got removed
+
+bool IsInsideFrustum(vec3 center, vec3 extents)
+{
+	for (int i = 0; i < 6; i++)
+	{
+		vec4 plane = u_CullingData.FrustumPlanes[i];
+		float distance = dot(plane.xyz, center) + plane.w;
+		float radius = dot(abs(plane.xyz), extents);
+		if (distance + radius < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+bool IsOccluded(vec3 boundsMin, vec3 boundsMax)
+{
+	vec2 uvMin = vec2(1.0f);
+	vec2 uvMax = vec2(0.0f);
+	float nearestDepth = 0.0f;
+
+	for (int i = 0; i < 8; i++)
+	{
+		vec3 corner = vec3((i & 1) != 0 ? boundsMax.x : boundsMin.x, (i & 2) != 0 ? boundsMax.y : boundsMin.y, (i & 4) != 0 ? boundsMax.z : boundsMin.z);
+		vec4 clip = u_CullingData.PreviousViewProjection * vec4(corner, 1.0f);
+
+		// Crosses the near plane of the previous frame, nothing sensible to test against
+		if (clip.w <= 0.0f)
+			return false;
+
+		vec3 ndc = clip.xyz / clip.w;
+		vec2 uv = ndc.xy * 0.5f + 0.5f;
+		uvMin = min(uvMin, uv);
+		uvMax = max(uvMax, uv);
+
+		// Reversed depth, the nearest point has the biggest depth
+		nearestDepth = max(nearestDepth, ndc.z);
+	}
+
+	uvMin = clamp(uvMin, vec2(0.0f), vec2(1.0f));
+	uvMax = clamp(uvMax, vec2(0.0f), vec2(1.0f));
+
+	// Pick the mip where the rectangle covers at most 2x2 texels
+	vec2 size = (uvMax - uvMin) * u_CullingData.HiZSize;
+	float mip = ceil(log2(max(max(size.x, size.y), 1.0f)));
+	int level = int(clamp(mip, 0.0f, float(u_CullingData.HiZMipCount - 1)));
+
+	ivec2 levelSize = textureSize(u_HiZTexture, level);
+	ivec2 minTexel = clamp(ivec2(uvMin * vec2(levelSize)), ivec2(0), levelSize - 1);
+	ivec2 maxTexel = clamp(ivec2(uvMax * vec2(levelSize)), ivec2(0), levelSize - 1);
+
+	float farthestOccluder = texelFetch(u_HiZTexture, minTexel, level).r;
+	farthestOccluder = min(farthestOccluder, texelFetch(u_HiZTexture, ivec2(maxTexel.x, minTexel.y), level).r);
+	farthestOccluder = min(farthestOccluder, texelFetch(u_HiZTexture, ivec2(minTexel.x, maxTexel.y), level).r);
+	farthestOccluder = min(farthestOccluder, texelFetch(u_HiZTexture, maxTexel, level).r);
+
+	return nearestDepth < farthestOccluder;
+}
+
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+void main()
+{
+	uint instanceIndex = gl_GlobalInvocationID.x;
+	if (instanceIndex >= u_CullingData.InstanceCount)
+		return;
+
+	InstanceData instance = s_InstanceInput.Instances[instanceIndex];
+	if (instance.DrawIndex == InvalidDrawIndex)
+		return;
+
+	DrawData draw = s_DrawInput.Draws[instance.DrawIndex];
+
+	mat4 transform = mat4(
+		vec4(instance.MatrixRow[0].x, instance.MatrixRow[1].x, instance.MatrixRow[2].x, 0.0f),
+		vec4(instance.MatrixRow[0].y, instance.MatrixRow[1].y, instance.MatrixRow[2].y, 0.0f),
+		vec4(instance.MatrixRow[0].z, instance.MatrixRow[1].z, instance.MatrixRow[2].z, 0.0f),
+		vec4(instance.MatrixRow[0].w, instance.MatrixRow[1].w, instance.MatrixRow[2].w, 1.0f)
+	);
+
+	// World space bounding box of the instance
+	vec3 localCenter = (draw.BoundsMin.xyz + draw.BoundsMax.xyz) * 0.5f;
+	vec3 localExtents = (draw.BoundsMax.xyz - draw.BoundsMin.xyz) * 0.5f;
+	vec3 center = (transform * vec4(localCenter, 1.0f)).xyz;
+	vec3 extents = abs(mat3(transform)) * localExtents;
+
+	if (!IsInsideFrustum(center, extents))
+		return;
+
+	if (u_CullingData.HiZValid != 0 && IsOccluded(center - extents, center + extents))
+		return;
+
+	uint slot = atomicAdd(s_DrawCounters.VisibleCount[instance.DrawIndex], 1);
+	uint firstWord = (draw.FirstInstance + slot) * InstanceWordCount;
+	for (int row = 0; row < 3; row++)
+	{
+		s_CulledInstances.Words[firstWord + row * 4 + 0] = floatBitsToUint(instance.MatrixRow[row].x);
+		s_CulledInstances.Words[firstWord + row * 4 + 1] = floatBitsToUint(instance.MatrixRow[row].y);
+		s_CulledInstances.Words[firstWord + row * 4 + 2] = floatBitsToUint(instance.MatrixRow[row].z);
+		s_CulledInstances.Words[firstWord + row * 4 + 3] = floatBitsToUint(instance.MatrixRow[row].w);
+	}
+	s_CulledInstances.Words[firstWord + 12] = instance.MaterialIndex;
+}
\ No newline at end of file
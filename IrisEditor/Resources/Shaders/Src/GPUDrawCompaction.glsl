@@ -0,0 +1,96 @@
+#version 450 core
+#stage compute
+
+// Runs after GPUCulling.glsl, one invocation per draw. Draws that kept at least one instance get an indirect command in the range of their
+// group, the group's count buffer entry ends up being the count that vkCmdDrawIndexedIndirectCount reads
+
+struct DrawData
+{
+	uint IndexCount;
+	uint FirstIndex;
+	int VertexOffset;
+	uint FirstInstance;
+	uint Group;
+	uint Padding0;
+	uint Padding1;
+	uint Padding2;
+	vec4 BoundsMin;
+	vec4 BoundsMax;
+};
+
+// Same layout as VkDrawIndexedIndirectCommand
+struct DrawCommand
+{
+	uint IndexCount;
+	uint InstanceCount;
+	uint FirstIndex;
+	int VertexOffset;
+	uint FirstInstance;
+};
+
+struct GroupData
+{
+	uint FirstCommand;
+	uint DrawCount;
+};
+
+layout(std140, set = 1, binding = 3) uniform CullingData
+{
+	mat4 ViewProjection;
+	mat4 PreviousViewProjection;
+	vec4 FrustumPlanes[6];
+	vec2 HiZSize;
+	uint HiZMipCount;
+	uint InstanceCount;
+	uint DrawCount;
+	uint HiZValid;
+} u_CullingData;
+
+layout(std430, set = 2, binding = 3) readonly buffer DrawInput
+{
+	DrawData Draws[];
+} s_DrawInput;
+
+layout(std430, set = 2, binding = 5) readonly buffer DrawCounters
+{
+	uint VisibleCount[];
+} s_DrawCounters;
+
+layout(std430, set = 2, binding = 6) writeonly buffer DrawCommands
+{
+	DrawCommand Commands[];
+} s_DrawCommands;
+
+layout(std430, set = 2, binding = 7) readonly buffer DrawGroups
+{
+	GroupData Groups[];
+} s_DrawGroups;
+
+layout(std430, set = 2, binding = 8) buffer GroupCounts
+{
+	uint DrawCount[];
+} s_GroupCounts;
+
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+void main()
+{
+	uint drawIndex = gl_GlobalInvocationID.x;
+	if (drawIndex >= u_CullingData.DrawCount)
+		return;
+
+	uint visibleCount = s_DrawCounters.VisibleCount[drawIndex];
+	if (visibleCount == 0)
+		return;
+
+	DrawData draw = s_DrawInput.Draws[drawIndex];
+	uint commandIndex = atomicAdd(s_GroupCounts.DrawCount[draw.Group], 1);
+
+	DrawCommand command;
+	command.IndexCount = draw.IndexCount;
+	command.InstanceCount = visibleCount;
+	command.FirstIndex = draw.FirstIndex;
+	command.VertexOffset = draw.VertexOffset;
+	command.FirstInstance = draw.FirstInstance;
+	s_DrawCommands.Commands[s_DrawGroups.Groups[draw.Group].FirstCommand + commandIndex] = command;
+}
\ No newline at end of file
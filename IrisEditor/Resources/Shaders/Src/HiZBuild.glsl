@@ -0,0 +1,52 @@
+#version 450 core
+#stage compute
+
+// Builds one mip of the hierarchical depth buffer that GPUCulling.glsl tests against
+// Mip 0 is a copy of the depth buffer, every other mip keeps the farthest depth of the texels it covers in the mip above. Since the depth
+// buffer is reversed the farthest depth is the smallest value
+
+layout(set = 3, binding = 0, r32f) restrict writeonly uniform image2D o_HiZ;
+layout(set = 3, binding = 1) uniform sampler2D u_InputDepth;
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+void main()
+{
+	ivec2 outputSize = imageSize(o_HiZ);
+	ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+	if (coord.x >= outputSize.x || coord.y >= outputSize.y)
+		return;
+
+	ivec2 inputSize = textureSize(u_InputDepth, 0);
+	if (inputSize == outputSize)
+	{
+		imageStore(o_HiZ, coord, vec4(texelFetch(u_InputDepth, coord, 0).r));
+		return;
+	}
+
+	ivec2 inputCoord = coord * 2;
+	ivec2 maxCoord = inputSize - 1;
+
+	float depth = texelFetch(u_InputDepth, min(inputCoord, maxCoord), 0).r;
+	depth = min(depth, texelFetch(u_InputDepth, min(inputCoord + ivec2(1, 0), maxCoord), 0).r);
+	depth = min(depth, texelFetch(u_InputDepth, min(inputCoord + ivec2(0, 1), maxCoord), 0).r);
+	depth = min(depth, texelFetch(u_InputDepth, min(inputCoord + ivec2(1, 1), maxCoord), 0).r);
+
+	// With an odd size the last column and row of the output also cover the texels the 2x2 footprint leaves out
+	bool extraColumn = (inputSize.x & 1) != 0 && coord.x == outputSize.x - 1;
+	bool extraRow = (inputSize.y & 1) != 0 && coord.y == outputSize.y - 1;
+	if (extraColumn)
+	{
+		depth = min(depth, texelFetch(u_InputDepth, min(inputCoord + ivec2(2, 0), maxCoord), 0).r);
+		depth = min(depth, texelFetch(u_InputDepth, min(inputCoord + ivec2(2, 1), maxCoord), 0).r);
+	}
+	if (extraRow)
+	{
+		depth = min(depth, texelFetch(u_InputDepth, min(inputCoord + ivec2(0, 2), maxCoord), 0).r);
+		depth = min(depth, texelFetch(u_InputDepth, min(inputCoord + ivec2(1, 2), maxCoord), 0).r);
+	}
+	if (extraColumn && extraRow)
+		depth = min(depth, texelFetch(u_InputDepth, min(inputCoord + ivec2(2, 2), maxCoord), 0).r);
+
+	imageStore(o_HiZ, coord, vec4(depth));
+}
\ No newline at end of file
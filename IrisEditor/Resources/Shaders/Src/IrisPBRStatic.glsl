@@ -13,6 +13,7 @@ layout(location = 4) in vec2 a_TexCoord;
 layout(location = 5) in vec4 a_MatrixRow0;
 layout(location = 6) in vec4 a_MatrixRow1;
 layout(location = 7) in vec4 a_MatrixRow2;
+layout(location = 8) in uint a_MaterialIndex; // Index into the material buffer of the bindless table
 
 layout(std140, set = 1, binding = 0) uniform Camera
 {
@@ -39,6 +40,7 @@ struct VertexOutput
 };
 
 layout(location = 0) out VertexOutput Output;
+layout(location = 14) out flat uint MaterialIndex; // VertexOutput takes up locations 0 to 13
 
 // Make sure both the PreDdepth shader and the PBR shader compute the exact same result
 invariant gl_Position;
@@ -64,12 +66,20 @@ void main()
     Output.CameraView = mat3(u_Camera.ViewMatrix);
     Output.ViewPosition = vec3(u_Camera.ViewMatrix * vec4(Output.WorldPosition, 1.0f));
 
+    MaterialIndex = a_MaterialIndex;
+
     gl_Position = u_Camera.ViewProjectionMatrix * worldPosition;
 }
 
 #version 450 core
 #stage fragment
 
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Materials switch these off together with the matching uniforms so that their pipeline variant does not carry the code
+#pragma permutation IR_NORMAL_MAP 1
+#pragma permutation IR_LIT 1
+
 layout(location = 0) out vec4 o_Color;
 layout(location = 1) out vec4 o_ViewNormalsLuminance;
 layout(location = 2) out vec4 o_MetalnessRoughness;
@@ -88,16 +98,40 @@ struct VertexOutput
 };
 
 layout(location = 0) in VertexOutput Input;
+layout(location = 14) in flat uint MaterialIndex;
 
 layout(set = 0, binding = 0) uniform sampler2D u_BRDFLutTexture;
 
 layout(set = 2, binding = 0) uniform samplerCube u_RadianceMap;
 layout(set = 2, binding = 1) uniform samplerCube u_IrradianceMap;
 
-layout(set = 3, binding = 0) uniform sampler2D u_AlbedoTexture;
-layout(set = 3, binding = 1) uniform sampler2D u_NormalTexture;
-layout(set = 3, binding = 2) uniform sampler2D u_RoughnessTexture;
-layout(set = 3, binding = 3) uniform sampler2D u_MetalnessTexture;
+// Set = 4 is the global bindless table (see BindlessTable.h)
+struct MaterialData
+{
+	vec3 AlbedoColor;
+	float Roughness;
+	float Metalness;
+	float Emission;
+	float Tiling;
+	float Transparency;
+
+	uint UseNormalMap;
+	uint Lit;
+	uint AlbedoTexture;
+	uint NormalTexture;
+
+	uint RoughnessTexture;
+	uint MetalnessTexture;
+	float EnvMapRotation;
+	uint Padding;
+};
+
+layout(set = 4, binding = 0) uniform sampler2D u_BindlessTextures[];
+
+layout(std430, set = 4, binding = 1) readonly buffer Materials
+{
+	MaterialData Data[];
+} u_Materials;
 
 // Set = 1 has uniform buffers
 struct DirectionalLight
@@ -111,22 +145,10 @@ layout(std140, set = 1, binding = 2) uniform SceneData
 	DirectionalLight DirLight;
 	vec3 CameraPosition; // Offset 32
 	float EnvironmentMapIntensity; // This is used in the PBR shader and it mirrors the intensity that is used in the Skybox shader
+	vec4 IrradianceSH[9]; // Offset 48, L2 spherical harmonics of the diffuse irradiance (rgb), replaces u_IrradianceMap when UseIrradianceSH is set
+	uint UseIrradianceSH;
 } u_Scene;
 
-layout(push_constant) uniform Materials
-{
-    vec3 AlbedoColor;
-    float Roughness;
-    float Metalness;
-    float Emission;
-	float Tiling;
-
-	float EnvMapRotation;
-
-    bool UseNormalMap;
-	bool Lit;
-} u_MaterialUniforms;
-
 struct PBRParameters
 {
 	vec3 Albedo;
@@ -138,6 +160,8 @@ struct PBRParameters
 	float NdotV;
 } m_Params;
 
+MaterialData m_Material;
+
 const float PI = 3.14159265358979323846f;
 const float Epsilon = 0.00001;
 // Constant normal incidence Fresnel factor for all dielectrics.
@@ -183,15 +207,32 @@ vec3 FresnelSchlickRoughness(vec3 F0, float cosTheta, float roughness)
 	return F0 + (max(vec3(1.0f - roughness), F0) - F0) * pow(1.0f - cosTheta, 5.0f);
 }
 
+// The coefficients already include the basis constants and the cosine lobe convolution (see SphericalHarmonics.h)
+vec3 EvaluateIrradianceSH(vec3 n)
+{
+	vec3 result = u_Scene.IrradianceSH[0].rgb;
+	result += u_Scene.IrradianceSH[1].rgb * n.y;
+	result += u_Scene.IrradianceSH[2].rgb * n.z;
+	result += u_Scene.IrradianceSH[3].rgb * n.x;
+	result += u_Scene.IrradianceSH[4].rgb * (n.x * n.y);
+	result += u_Scene.IrradianceSH[5].rgb * (n.y * n.z);
+	result += u_Scene.IrradianceSH[6].rgb * (3.0f * n.z * n.z - 1.0f);
+	result += u_Scene.IrradianceSH[7].rgb * (n.x * n.z);
+	result += u_Scene.IrradianceSH[8].rgb * (n.x * n.x - n.y * n.y);
+
+	// L2 ringing can push it slightly below zero opposite of very bright lights
+	return max(result, vec3(0.0f));
+}
+
 vec3 IBL(vec3 F0, vec3 Lr)
 {
-	vec3 irradiance = texture(u_IrradianceMap, m_Params.Normal).rgb;
+	vec3 irradiance = u_Scene.UseIrradianceSH != 0 ? EvaluateIrradianceSH(m_Params.Normal) : texture(u_IrradianceMap, m_Params.Normal).rgb;
 	vec3 F = FresnelSchlickRoughness(F0, m_Params.NdotV, m_Params.Roughness);
 	vec3 kd = (1.0f - F) * (1.0f - m_Params.Metalness);
 	vec3 diffuseIBL = m_Params.Albedo * irradiance;
 
 	int envRadianceTexLevels = textureQueryLevels(u_RadianceMap);
-	vec3 specularIrradiance = textureLod(u_RadianceMap, RotateVectorAboutY(u_MaterialUniforms.EnvMapRotation, Lr), m_Params.Roughness * envRadianceTexLevels).rgb;
+	vec3 specularIrradiance = textureLod(u_RadianceMap, RotateVectorAboutY(m_Material.EnvMapRotation, Lr), m_Params.Roughness * envRadianceTexLevels).rgb;
 
 	vec2 specularBRDF = texture(u_BRDFLutTexture, vec2(m_Params.NdotV, m_Params.Roughness)).rg;
 	vec3 specularIBL = specularIrradiance * (F0 * specularBRDF.r + specularBRDF.g);
@@ -239,28 +280,36 @@ vec4 ToLinear(vec4 sRGB)
 	return mix(higher, lower, cutoff);
 }
 
+// Instances of one draw can use different materials so the index is not uniform
+vec4 SampleMaterialTexture(uint textureIndex)
+{
+	return texture(u_BindlessTextures[nonuniformEXT(textureIndex)], Input.TexCoord * m_Material.Tiling);
+}
+
 void main()
 {
-	if (u_MaterialUniforms.Lit)
+	m_Material = u_Materials.Data[MaterialIndex];
+
+	if (IR_LIT && m_Material.Lit != 0u)
 	{
-		vec4 albedoTexColor = texture(u_AlbedoTexture, Input.TexCoord * u_MaterialUniforms.Tiling);
-		m_Params.Albedo = albedoTexColor.rgb * ToLinear(vec4(u_MaterialUniforms.AlbedoColor, 1.0f)).rgb; // u_MaterialUniforms.AlbedoColor is perceptual, must be converted to linear
+		vec4 albedoTexColor = SampleMaterialTexture(m_Material.AlbedoTexture);
+		m_Params.Albedo = albedoTexColor.rgb * ToLinear(vec4(m_Material.AlbedoColor, 1.0f)).rgb; // AlbedoColor is perceptual, must be converted to linear
 
 		// note: Metalness and roughness could be in the same texture.
 		//       Per GLTF spec, we read metalness from the B channel and roughness from the G channel
 		//       This will still work if metalness and roughness are independent greyscale textures,
 		//       but it will not work if metalness and roughness are independent textures containing only R channel.
-		m_Params.Metalness = texture(u_MetalnessTexture, Input.TexCoord * u_MaterialUniforms.Tiling).b * u_MaterialUniforms.Metalness;
-		m_Params.Roughness = texture(u_RoughnessTexture, Input.TexCoord * u_MaterialUniforms.Tiling).g * u_MaterialUniforms.Roughness;
+		m_Params.Metalness = SampleMaterialTexture(m_Material.MetalnessTexture).b * m_Material.Metalness;
+		m_Params.Roughness = SampleMaterialTexture(m_Material.RoughnessTexture).g * m_Material.Roughness;
 		// Write final metalness roughness values
 		o_MetalnessRoughness = vec4(m_Params.Metalness, m_Params.Roughness, 0.0f, 1.0f);
 		m_Params.Roughness = max(m_Params.Roughness, 0.05f); // Min roughness value above 0 so we keep specular highlights
 
 		// Normals... Either from vertex data or from normal map
 		m_Params.Normal = normalize(Input.Normal);
-		if (u_MaterialUniforms.UseNormalMap)
+		if (IR_NORMAL_MAP && m_Material.UseNormalMap != 0u)
 		{
-			m_Params.Normal = normalize(texture(u_NormalTexture, Input.TexCoord * u_MaterialUniforms.Tiling).rgb * 2.0f - 1.0f);
+			m_Params.Normal = normalize(SampleMaterialTexture(m_Material.NormalTexture).rgb * 2.0f - 1.0f);
 			m_Params.Normal = normalize(Input.WorldNormals * m_Params.Normal);
 		}
 
@@ -281,7 +330,7 @@ void main()
 
 		// Direct Lighting
 		vec3 directLightingContrib = CalculateDirectionalLight(F0);
-		directLightingContrib += m_Params.Albedo * u_MaterialUniforms.Emission; // For bloom filtering pass
+		directLightingContrib += m_Params.Albedo * m_Material.Emission; // For bloom filtering pass
 
 		// Write final color
 		o_Color = vec4(iblContribution + directLightingContrib, 1.0f);
@@ -297,10 +346,10 @@ void main()
 	else
 	{
 		// Applies a bit of dimming in all the channels for the unlit version otherwise its too bright
-		o_Color =  vec4(vec3(0.6f), 1.0f) * texture(u_AlbedoTexture, Input.TexCoord * u_MaterialUniforms.Tiling) * vec4(u_MaterialUniforms.AlbedoColor, 1.0f);
+		o_Color =  vec4(vec3(0.6f), 1.0f) * SampleMaterialTexture(m_Material.AlbedoTexture) * vec4(m_Material.AlbedoColor, 1.0f);
 		o_ViewNormalsLuminance = vec4(Input.CameraView * normalize(Input.Normal), 1.0f);
-		float metalness = texture(u_MetalnessTexture, Input.TexCoord * u_MaterialUniforms.Tiling).b * u_MaterialUniforms.Metalness;
-		float roughness = texture(u_RoughnessTexture, Input.TexCoord * u_MaterialUniforms.Tiling).g * u_MaterialUniforms.Roughness;
+		float metalness = SampleMaterialTexture(m_Material.MetalnessTexture).b * m_Material.Metalness;
+		float roughness = SampleMaterialTexture(m_Material.RoughnessTexture).g * m_Material.Roughness;
 		o_MetalnessRoughness = vec4(metalness, roughness, 0.0f, 1.0f);
 	}
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ layout(set = 3, binding = 0, rgba16f) restrict writeonly uniform imageCube o_Out
 layout(push_constant) uniform Uniforms
 {
 	vec4 TurbidityAzimuthInclinationSunSize;
+	uint FirstFace; // Only a range of the faces gets dispatched when the rest did not change
 } u_Uniforms;
 
 // So we get a 3D vector that points to a pixel inside on one of the cubemap faces based on the GlobalInvocationID inside
@@ -20,18 +21,18 @@ layout(push_constant) uniform Uniforms
 // This is essentially "inverse-sampling": we reconstruct what the sampling vector would be if we wanted it to "hit"
 // this particular fragment in a cubemap.
 // See: OpenGL core profile specs, section 8.13.
-vec3 GetCubeMapTexCoord(vec2 outputImageSize)
+vec3 GetCubeMapTexCoord(vec2 outputImageSize, uint face)
 {
     vec2 st = gl_GlobalInvocationID.xy / outputImageSize;
     vec2 uv = 2.0f * vec2(st.x, 1.0f - st.y) - vec2(1.0f);
 
     vec3 ret;
-    if (gl_GlobalInvocationID.z == 0u)      ret = vec3( 1.0f,  uv.y, -uv.x);
-    else if (gl_GlobalInvocationID.z == 1u) ret = vec3(-1.0f,  uv.y,  uv.x);
-    else if (gl_GlobalInvocationID.z == 2u) ret = vec3( uv.x,  1.0f, -uv.y);
-    else if (gl_GlobalInvocationID.z == 3u) ret = vec3( uv.x, -1.0f,  uv.y);
-    else if (gl_GlobalInvocationID.z == 4u) ret = vec3( uv.x,  uv.y,  1.0f);
-    else if (gl_GlobalInvocationID.z == 5u) ret = vec3(-uv.x,  uv.y, -1.0f);
+    if (face == 0u)      ret = vec3( 1.0f,  uv.y, -uv.x);
+    else if (face == 1u) ret = vec3(-1.0f,  uv.y,  uv.x);
+    else if (face == 2u) ret = vec3( uv.x,  1.0f, -uv.y);
+    else if (face == 3u) ret = vec3( uv.x, -1.0f,  uv.y);
+    else if (face == 4u) ret = vec3( uv.x,  uv.y,  1.0f);
+    else if (face == 5u) ret = vec3(-uv.x,  uv.y, -1.0f);
 
     return normalize(ret);
 }
@@ -196,7 +197,8 @@ float CalculateClouds(vec3 dir)
 layout(local_size_x = 32, local_size_y = 32, local_size_z = 1) in;
 void main()
 {
-	vec3 cubeTC = GetCubeMapTexCoord(vec2(imageSize(o_OutputCubeMap)));
+	uint face = gl_GlobalInvocationID.z + u_Uniforms.FirstFace;
+	vec3 cubeTC = GetCubeMapTexCoord(vec2(imageSize(o_OutputCubeMap)), face);
 
 	float turbidity     = u_Uniforms.TurbidityAzimuthInclinationSunSize.x;
     float azimuth       = u_Uniforms.TurbidityAzimuthInclinationSunSize.y;
@@ -219,5 +221,5 @@ void main()
 
     vec4 color = vec4(skyLuminance * 0.05f + sunContribution, 1.0f);
 //    vec4 color = vec4(skyLuminance * 0.05f + sunContribution + cloudColor * 0.05f, 1.0f);
-	imageStore(o_OutputCubeMap, ivec3(gl_GlobalInvocationID), color);
+	imageStore(o_OutputCubeMap, ivec3(gl_GlobalInvocationID.xy, face), color);
 }
\ No newline at end of file
@@ -41,6 +41,8 @@ void main()
 #version 450 core
 #stage fragment
 
+#extension GL_EXT_nonuniform_qualifier : require
+
 layout(location = 0) out vec4 o_Color;
 
 struct VertexOutput
@@ -53,11 +55,12 @@ struct VertexOutput
 layout (location = 0) in VertexOutput Input;
 layout (location = 3) in flat float TexIndex;
 
-layout (set = 3, binding = 0) uniform sampler2D u_Textures[32];
+// TexIndex is the slot of the texture in the bindless table
+layout (set = 4, binding = 0) uniform sampler2D u_BindlessTextures[];
 
 void main()
 {
-	o_Color = texture(u_Textures[int(TexIndex)], Input.TexCoord * Input.TilingFactor) * Input.Color;
+	o_Color = texture(u_BindlessTextures[nonuniformEXT(int(TexIndex))], Input.TexCoord * Input.TilingFactor) * Input.Color;
 
 	// Discard to avoid depth write
 	if (o_Color.a == 0.0)
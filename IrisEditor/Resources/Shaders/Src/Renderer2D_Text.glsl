@@ -38,6 +38,8 @@ void main()
 #version 450 core
 #stage fragment
 
+#extension GL_EXT_nonuniform_qualifier : require
+
 layout(location = 0) out vec4 o_Color;
 
 struct VertexOutput
@@ -49,7 +51,8 @@ struct VertexOutput
 layout (location = 0) in VertexOutput Input;
 layout (location = 2) in flat float TexIndex;
 
-layout (set = 3, binding = 0) uniform sampler2D u_FontAtlases[32];
+// TexIndex is the slot of the font atlas in the bindless table
+layout (set = 4, binding = 0) uniform sampler2D u_BindlessTextures[];
 
 float Median(float r, float g, float b)
 {
@@ -59,7 +62,7 @@ float Median(float r, float g, float b)
 float ScreenPxRange()
 {
 	const float pxRange = 2.0f;
-    vec2 unitRange = vec2(pxRange) / vec2(textureSize(u_FontAtlases[int(TexIndex)], 0));
+    vec2 unitRange = vec2(pxRange) / vec2(textureSize(u_BindlessTextures[nonuniformEXT(int(TexIndex))], 0));
     vec2 screenTexSize = vec2(1.0f) / fwidth(Input.TexCoord);
     return max(0.5f * dot(unitRange, screenTexSize), 1.0f);
 }
@@ -69,7 +72,7 @@ void main()
 	vec4 bgColor = vec4(Input.Color.rgb, 0.0f);
 	vec4 fgColor = Input.Color;
 
-	vec3 msd = texture(u_FontAtlases[int(TexIndex)], Input.TexCoord).rgb;
+	vec3 msd = texture(u_BindlessTextures[nonuniformEXT(int(TexIndex))], Input.TexCoord).rgb;
 	float sd = Median(msd.r, msd.g, msd.b);
 	float screenPxDistance = ScreenPxRange() * (sd - 0.5f);
 	float opacity = clamp(screenPxDistance + 0.5f, 0.0f, 1.0f);
@@ -6,9 +6,20 @@
 #include "Renderer/UniformBufferSet.h"
 
 #include "ImGui/ImGuiUtils.h"
+#include "Utils/FileSystem.h"
 
 namespace Iris {
 
+	namespace Utils {
+
+		static bool IsPathInDirectory(const std::filesystem::path& path, const std::filesystem::path& directory)
+		{
+			std::filesystem::path relativePath = path.lexically_relative(directory);
+			return !relativePath.empty() && *relativePath.begin() != "..";
+		}
+
+	}
+
 	ContentBrowserPanel::ContentBrowserPanel()
 		: m_Project(nullptr), m_BaseDirectory(Project::GetAssetDirectory()), m_CurrentDirectory(m_BaseDirectory)
 	{
@@ -45,20 +56,18 @@ namespace Iris {
 
 			ImGui::Columns(columnCount, 0, false);
 
-			for (auto& directoryEntry : std::filesystem::directory_iterator(m_CurrentDirectory))
+			// Changing the directory is deferred so that the cached directory we are iterating stays alive
+			std::filesystem::path nextDirectory;
+			for (const DirectoryItem& item : GetDirectory(m_CurrentDirectory).Items)
 			{
-				const auto& path = directoryEntry.path();
-				std::string filenameString = path.filename().string();
-
-				ImGui::PushID(filenameString.c_str());
-				Ref<Texture2D> icon = directoryEntry.is_directory() ? EditorResources::DirectoryIcon : EditorResources::FileIcon;
+				ImGui::PushID(item.Filename.c_str());
+				Ref<Texture2D> icon = item.IsDirectory ? EditorResources::DirectoryIcon : EditorResources::FileIcon;
 				ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
 				ImGui::ImageButton("##content_browser_button_directory", UI::GetTextureID(icon), { thumbnailSize, thumbnailSize });
 
 				if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_SourceAllowNullID))
 				{
-					std::filesystem::path relativePath(path);
-					AssetHandle handle = Project::GetEditorAssetManager()->GetAssetHandleFromFilePath(path);
+					AssetHandle handle = Project::GetEditorAssetManager()->GetAssetHandleFromFilePath(item.FilePath);
 					ImGui::SetDragDropPayload("asset_payload", &handle, 1 * sizeof(AssetHandle));
 					ImGui::EndDragDropSource();
 				}
@@ -66,16 +75,19 @@ namespace Iris {
 				ImGui::PopStyleColor();
 				if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
 				{
-					if (directoryEntry.is_directory())
-						m_CurrentDirectory /= path.filename();
+					if (item.IsDirectory)
+						nextDirectory = item.FilePath;
 
 				}
-				ImGui::TextWrapped(filenameString.c_str());
+				ImGui::TextWrapped(item.Filename.c_str());
 
 				ImGui::NextColumn();
 
 				ImGui::PopID();
 			}
+
+			if (!nextDirectory.empty())
+				m_CurrentDirectory = nextDirectory;
 		}
 
 		ImGui::End();
@@ -86,10 +98,15 @@ namespace Iris {
 		Events::EventDispatcher dispatcher(e);
 		dispatcher.Dispatch<Events::KeyPressedEvent>([this](Events::KeyPressedEvent& event) { return OnKeyPressed(event); });
 		dispatcher.Dispatch<Events::MouseButtonPressedEvent>([this](Events::MouseButtonPressedEvent& event) { return OnMouseButtonPressed(event); });
+		dispatcher.Dispatch<Events::FileSystemChangedEvent>([this](Events::FileSystemChangedEvent& event) { return OnFileSystemChanged(event); });
 	}
 
 	void ContentBrowserPanel::OnProjectChanged(const Ref<Project>& project)
 	{
+		m_Project = project;
+		m_BaseDirectory = Project::GetAssetDirectory();
+		m_CurrentDirectory = m_BaseDirectory;
+		m_DirectoryCache.clear();
 	}
 
 	bool ContentBrowserPanel::OnKeyPressed(Events::KeyPressedEvent& e)
@@ -104,4 +121,113 @@ namespace Iris {
 		return false;
 	}
 
+	bool ContentBrowserPanel::OnFileSystemChanged(Events::FileSystemChangedEvent& e)
+	{
+		for (const FileSystemChange& change : e.GetChanges())
+		{
+			switch (change.Action)
+			{
+				case FileSystemAction::Added:
+				{
+					AddDirectoryItem(change.FilePath, change.IsDirectory);
+					break;
+				}
+				case FileSystemAction::Removed:
+				{
+					RemoveDirectoryItem(change.FilePath);
+					InvalidateDirectoryTree(change.FilePath);
+					break;
+				}
+				case FileSystemAction::Modified:
+				{
+					// The file watcher lost track of the changes so everything has to be listed again
+					if (change.FilePath == m_BaseDirectory)
+						m_DirectoryCache.clear();
+
+					break;
+				}
+				case FileSystemAction::Renamed:
+				{
+					RemoveDirectoryItem(change.OldFilePath);
+					InvalidateDirectoryTree(change.OldFilePath);
+					AddDirectoryItem(change.FilePath, change.IsDirectory);
+
+					if (m_CurrentDirectory == change.OldFilePath || Utils::IsPathInDirectory(m_CurrentDirectory, change.OldFilePath))
+						m_CurrentDirectory = change.FilePath / m_CurrentDirectory.lexically_relative(change.OldFilePath);
+
+					break;
+				}
+			}
+		}
+
+		if (!FileSystem::Exists(m_CurrentDirectory))
+			m_CurrentDirectory = m_BaseDirectory;
+
+		// Other panels may be interested as well
+		return false;
+	}
+
+	const ContentBrowserPanel::CachedDirectory& ContentBrowserPanel::GetDirectory(const std::filesystem::path& directory)
+	{
+		auto [it, inserted] = m_DirectoryCache.try_emplace(directory.generic_string());
+		if (!inserted)
+			return it->second;
+
+		std::vector<DirectoryItem>& items = it->second.Items;
+		for (const auto& directoryEntry : std::filesystem::directory_iterator(directory))
+			items.push_back({ directoryEntry.path(), directoryEntry.path().filename().string(), directoryEntry.is_directory() });
+
+		std::sort(items.begin(), items.end(), [](const DirectoryItem& a, const DirectoryItem& b)
+		{
+			if (a.IsDirectory != b.IsDirectory)
+				return a.IsDirectory;
+
+			return a.Filename < b.Filename;
+		});
+
+		return it->second;
+	}
+
+	void ContentBrowserPanel::AddDirectoryItem(const std::filesystem::path& filePath, bool isDirectory)
+	{
+		// Directories that were never browsed are listed when they are opened
+		auto it = m_DirectoryCache.find(filePath.parent_path().generic_string());
+		if (it == m_DirectoryCache.end())
+			return;
+
+		DirectoryItem item = { filePath, filePath.filename().string(), isDirectory };
+
+		std::vector<DirectoryItem>& items = it->second.Items;
+		auto position = std::find_if(items.begin(), items.end(), [&item](const DirectoryItem& other)
+		{
+			if (item.IsDirectory != other.IsDirectory)
+				return item.IsDirectory;
+
+			return item.Filename <= other.Filename;
+		});
+
+		if (position != items.end() && position->FilePath == filePath)
+			return;
+
+		items.insert(position, std::move(item));
+	}
+
+	void ContentBrowserPanel::RemoveDirectoryItem(const std::filesystem::path& filePath)
+	{
+		auto it = m_DirectoryCache.find(filePath.parent_path().generic_string());
+		if (it == m_DirectoryCache.end())
+			return;
+
+		std::erase_if(it->second.Items, [&filePath](const DirectoryItem& item) { return item.FilePath == filePath; });
+	}
+
+	void ContentBrowserPanel::InvalidateDirectoryTree(const std::filesystem::path& directory)
+	{
+		std::erase_if(m_DirectoryCache, [&directory](const auto& pair)
+		{
+			std::filesystem::path cachedDirectory = pair.first;
+			return cachedDirectory == directory || Utils::IsPathInDirectory(cachedDirectory, directory);
+		});
+	}
+
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Core/Events/AppEvents.h"
 #include "Core/Events/KeyEvents.h"
 #include "Core/Events/MouseEvents.h"
 #include "Scene/Scene.h"
@@ -31,8 +32,27 @@ namespace Iris {
 		virtual void SetSceneContext(const Ref<Scene>& context) override { m_SceneContext = context; }
 
 	private:
+		// Directories are only listed the first time they are browsed, after that they are kept up to date from the file watcher changes
+		struct DirectoryItem
+		{
+			std::filesystem::path FilePath;
+			std::string Filename;
+			bool IsDirectory = false;
+		};
+
+		struct CachedDirectory
+		{
+			std::vector<DirectoryItem> Items; // Directories first, then sorted by name
+		};
+
 		bool OnKeyPressed(Events::KeyPressedEvent& e);
 		bool OnMouseButtonPressed(Events::MouseButtonPressedEvent& e);
+		bool OnFileSystemChanged(Events::FileSystemChangedEvent& e);
+
+		const CachedDirectory& GetDirectory(const std::filesystem::path& directory);
+		void AddDirectoryItem(const std::filesystem::path& filePath, bool isDirectory);
+		void RemoveDirectoryItem(const std::filesystem::path& filePath);
+		void InvalidateDirectoryTree(const std::filesystem::path& directory);
 
 	private:
 		Ref<Project> m_Project;
@@ -41,6 +61,9 @@ namespace Iris {
 		std::filesystem::path m_BaseDirectory;
 		std::filesystem::path m_CurrentDirectory;
 
+		// Keyed by the generic string of the directory path
+		std::unordered_map<std::string, CachedDirectory> m_DirectoryCache;
+
 		bool m_IsContentBrowserHovered = false;
 		bool m_IsContentBrowserFocused = false;
 
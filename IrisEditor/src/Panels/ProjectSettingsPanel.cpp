@@ -59,6 +59,14 @@ namespace Iris {
 						}
 					}
 
+					bool budgetChanged = UI::Property("Asset CPU memory budget (MB)", m_Context->m_Config.AssetCPUMemoryBudget, 64, 256, 65536, "Least recently used assets that nothing references are evicted once the loaded assets go over this");
+					budgetChanged |= UI::Property("Asset GPU memory budget (MB)", m_Context->m_Config.AssetGPUMemoryBudget, 64, 0, 65536, "0 uses 80% of the device memory");
+					if (budgetChanged)
+					{
+						Project::ApplyAssetMemoryBudget();
+						serializeProject = true;
+					}
+
 					UI::EndPropertyGrid();
 					ImGui::TreePop(); // For the property grid header
 				}
@@ -89,6 +97,8 @@ namespace Iris {
 					if (UI::PropertyDropdown("Irradiance Map Compute Samples", mapSize, 6, &currentIrradianceMapSamples))
 						rendererConfig.IrradianceMapComputeSamples = static_cast<uint32_t>(glm::pow(2, currentEnvMapSize + 7));
 
+					UI::Property("Spherical Harmonics Irradiance", rendererConfig.SphericalHarmonicsIrradiance, "Diffuse lighting from environment maps uses spherical harmonics instead of an irradiance map.\nOnly affects environment maps loaded after changing it");
+
 					UI::EndPropertyGrid();
 					ImGui::TreePop();
 				}